@@ -82,7 +82,8 @@ namespace RN
 
 	void D3D12GPUBuffer::FlushRange(const Range &range)
 	{
-		_resource->Flush();
+		//The copy is recorded when unmapping, so several ranges can be flushed from the same upload buffer
+		_resource->AddFlushRange(range);
 	}
 
 	size_t D3D12GPUBuffer::GetLength() const
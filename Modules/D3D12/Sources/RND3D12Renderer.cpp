@@ -830,6 +830,7 @@ namespace RN
 			case PrimitiveType::Int32:
 			case PrimitiveType::Float:
 			case PrimitiveType::HalfVector2:
+			case PrimitiveType::Color8:
 				return 4;
 
 			case PrimitiveType::Vector2:
@@ -869,6 +870,7 @@ namespace RN
 			case PrimitiveType::Int32:
 			case PrimitiveType::Float:
 			case PrimitiveType::HalfVector2:
+			case PrimitiveType::Color8:
 				return 4;
 
 			case PrimitiveType::Vector2:
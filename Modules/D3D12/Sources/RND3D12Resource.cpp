@@ -98,12 +98,24 @@ namespace RN
 		}
 	}
 
+	void D3D12Resource::AddFlushRange(const Range &range)
+	{
+		if(_resourceType == ResourceType::Uniform)
+			return;
+
+		_flushRanges.push_back(range);
+	}
+
 	void D3D12Resource::Flush()
 	{
 		if(_resourceType == ResourceType::Uniform)
 			return;
 
-		if (!_transferAllocation) return;
+		if (!_transferAllocation)
+		{
+			_flushRanges.clear();
+			return;
+		}
 
 		_transferAllocation->GetResource()->Unmap(0, nullptr);
 		_isRecording = false;
@@ -123,7 +135,18 @@ namespace RN
 			SetResourceState(commandList, D3D12_RESOURCE_STATE_COPY_DEST);
 		}
 
-		commandList->GetCommandList()->CopyResource(_allocation->GetResource(), transferAllocation->GetResource());
+		//The upload buffer is new for every recording, so only the flushed ranges hold valid data
+		if(_flushRanges.empty())
+		{
+			commandList->GetCommandList()->CopyResource(_allocation->GetResource(), transferAllocation->GetResource());
+		}
+		else
+		{
+			for(const Range &range : _flushRanges)
+				commandList->GetCommandList()->CopyBufferRegion(_allocation->GetResource(), range.origin, transferAllocation->GetResource(), range.origin, range.length);
+
+			_flushRanges.clear();
+		}
 
 		if(!(_resourceState & originalResourceState))
 		{
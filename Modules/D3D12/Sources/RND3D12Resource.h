@@ -33,7 +33,8 @@ namespace RN
 		~D3D12Resource() override;
 
 		void *GetUploadBuffer();
-		void Flush();
+		void AddFlushRange(const Range &range);
+		void Flush(); // Copies the ranges added since the last flush, or everything if there are none
 
 		ID3D12Resource *GetD3D12Resource() const;
 
@@ -55,6 +56,7 @@ namespace RN
 		D3D12_RESOURCE_STATES _resourceState;
 		bool _isRecording;
 		void *_transferPointer;
+		std::vector<Range> _flushRanges;
 
 		CD3DX12_RESOURCE_DESC _resourceDescription;
 
@@ -69,7 +69,8 @@ namespace RN
 		DXGI_FORMAT_R32G32B32A32_FLOAT,
 
 		DXGI_FORMAT_R32G32B32A32_FLOAT,
-		DXGI_FORMAT_R32G32B32A32_FLOAT
+		DXGI_FORMAT_R32G32B32A32_FLOAT,
+		DXGI_FORMAT_R8G8B8A8_UNORM
 	};
 
 	const char* _vertexFeatureLookup[]
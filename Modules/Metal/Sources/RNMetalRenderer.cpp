@@ -648,6 +648,7 @@ namespace RN
 			case PrimitiveType::Int32:
 			case PrimitiveType::Float:
 			case PrimitiveType::HalfVector2:
+			case PrimitiveType::Color8:
 				return 4;
 
 			case PrimitiveType::Vector2:
@@ -683,6 +684,7 @@ namespace RN
 			case PrimitiveType::Int32:
 			case PrimitiveType::Float:
 			case PrimitiveType::HalfVector2:
+			case PrimitiveType::Color8:
 				return 4;
 
 			case PrimitiveType::Vector2:
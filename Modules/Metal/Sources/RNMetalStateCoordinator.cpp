@@ -40,7 +40,8 @@ namespace RN
 		MTLVertexFormatFloat4,
 		
 		MTLVertexFormatFloat4,
-		MTLVertexFormatFloat4
+		MTLVertexFormatFloat4,
+		MTLVertexFormatUChar4Normalized
 	};
 
 	MTLCompareFunction CompareFunctionLookup[] =
@@ -163,9 +163,12 @@ namespace RN
 		for(size_t i = 0; i < mesh->GetIndicesCount() / 3; i++)
 		{
 			if(i > 0) vertexIterator++;
-			const Vector3 &vertex1 = *(vertexIterator++) * scale;
-			const Vector3 &vertex2 = *(vertexIterator++) * scale;
-			const Vector3 &vertex3 = *(vertexIterator)* scale;
+			const Vector3 &position1 = *(vertexIterator++);
+			const Vector3 &position2 = *(vertexIterator++);
+			const Vector3 &position3 = *(vertexIterator);
+			const Vector3 vertex1 = position1 * scale;
+			const Vector3 vertex2 = position2 * scale;
+			const Vector3 vertex3 = position3 * scale;
 
 			float face[9] = { vertex1.x, vertex1.y, vertex1.z, vertex2.x, vertex2.y, vertex2.z, vertex3.x, vertex3.y, vertex3.z };
 			NewtonTreeCollisionAddFace(_shape, 3, face, 3 * sizeof(float), 0);
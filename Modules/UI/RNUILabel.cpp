@@ -269,13 +269,14 @@ namespace RN
 				return result;
 			}
 			
-			Array *spacings = (new Array(_attributedText->GetLength()))->Autorelease();
+			FrameVector<float> spacings;
+			spacings.reserve(_attributedText->GetLength());
 			
-			std::vector<int64> linebreaks;
-			std::vector<float> linewidth;
-			std::vector<float> lineascent;
-			std::vector<float> linedescent;
-			std::vector<float> lineoffset;
+			FrameVector<int64> linebreaks;
+			FrameVector<float> linewidth;
+			FrameVector<float> lineascent;
+			FrameVector<float> linedescent;
+			FrameVector<float> lineoffset;
 			
 			float currentWidth = 0.0f;
 			float lastWordWidth = 0.0f;
@@ -381,8 +382,8 @@ namespace RN
 						
 						if(lastWhiteSpaceIndex != i)
 						{
-							currentWidth -= spacings->GetObjectAtIndex<RN::Number>(lastWhiteSpaceIndex)->GetFloatValue();
-							spacings->ReplaceObjectAtIndex(lastWhiteSpaceIndex, RN::Number::WithFloat(0.0f));
+							currentWidth -= spacings[lastWhiteSpaceIndex];
+							spacings[lastWhiteSpaceIndex] = 0.0f;
 						}
 						else
 						{
@@ -407,7 +408,7 @@ namespace RN
 				}
 				
 				currentWidth += offset;
-				spacings->AddObject(RN::Number::WithFloat(offset));
+				spacings.push_back(offset);
 			}
 			
 			totalHeight += maxAscent;// + maxDescent;
@@ -443,7 +444,7 @@ namespace RN
 			
 			for(int index = 0; index <= characterCounter; index++)
 			{
-				if(index > 0) characterPositionX += spacings->GetObjectAtIndex<RN::Number>(index-1)->GetFloatValue();
+				if(index > 0) characterPositionX += spacings[index-1];
 				
 				const TextAttributes *currentAttributes = _attributedText->GetAttributesAtIndex(index);
 				if(!currentAttributes) currentAttributes = &_defaultAttributes;
@@ -487,13 +488,14 @@ namespace RN
 			realPosition.x = position.x;
 			realPosition.y = /*GetBounds().height +*/ -position.y;
 			
-			Array *spacings = (new Array(_attributedText->GetLength()))->Autorelease();
+			FrameVector<float> spacings;
+			spacings.reserve(_attributedText->GetLength());
 			
-			std::vector<int64> linebreaks;
-			std::vector<float> linewidth;
-			std::vector<float> lineascent;
-			std::vector<float> linedescent;
-			std::vector<float> lineoffset;
+			FrameVector<int64> linebreaks;
+			FrameVector<float> linewidth;
+			FrameVector<float> lineascent;
+			FrameVector<float> linedescent;
+			FrameVector<float> lineoffset;
 			
 			float currentWidth = 0.0f;
 			float lastWordWidth = 0.0f;
@@ -599,8 +601,8 @@ namespace RN
 						
 						if(lastWhiteSpaceIndex != i)
 						{
-							currentWidth -= spacings->GetObjectAtIndex<RN::Number>(lastWhiteSpaceIndex)->GetFloatValue();
-							spacings->ReplaceObjectAtIndex(lastWhiteSpaceIndex, RN::Number::WithFloat(0.0f));
+							currentWidth -= spacings[lastWhiteSpaceIndex];
+							spacings[lastWhiteSpaceIndex] = 0.0f;
 						}
 						else
 						{
@@ -625,7 +627,7 @@ namespace RN
 				}
 				
 				currentWidth += offset;
-				spacings->AddObject(RN::Number::WithFloat(offset));
+				spacings.push_back(offset);
 			}
 			
 			totalHeight += maxAscent;// + maxDescent;
@@ -664,7 +666,7 @@ namespace RN
 			
 			for(int index = 0; index <= characterCounter; index++)
 			{
-				if(index > 0) characterPositionX += spacings->GetObjectAtIndex<RN::Number>(index-1)->GetFloatValue();
+				if(index > 0) characterPositionX += spacings[index-1];
 				
 				const TextAttributes *currentAttributes = _attributedText->GetAttributesAtIndex(index);
 				if(!currentAttributes) currentAttributes = &_defaultAttributes;
@@ -706,12 +708,13 @@ namespace RN
 				return Vector2();
 			}
 			
-			Array *spacings = (new Array(_attributedText->GetLength()))->Autorelease();
+			FrameVector<float> spacings;
+			spacings.reserve(_attributedText->GetLength());
 			
-			std::vector<int> linebreaks;
-			std::vector<float> lineascent;
-			std::vector<float> linedescent;
-			std::vector<float> lineoffset;
+			FrameVector<int> linebreaks;
+			FrameVector<float> lineascent;
+			FrameVector<float> linedescent;
+			FrameVector<float> lineoffset;
 			
 			float currentWidth = 0.0f;
 			float lastWordWidth = 0.0f;
@@ -815,8 +818,8 @@ namespace RN
 						
 						if(lastWhiteSpaceIndex != i)
 						{
-							currentWidth -= spacings->GetObjectAtIndex<RN::Number>(lastWhiteSpaceIndex)->GetFloatValue();
-							spacings->ReplaceObjectAtIndex(lastWhiteSpaceIndex, RN::Number::WithFloat(0.0f));
+							currentWidth -= spacings[lastWhiteSpaceIndex];
+							spacings[lastWhiteSpaceIndex] = 0.0f;
 						}
 						else
 						{
@@ -841,7 +844,7 @@ namespace RN
 				}
 				
 				currentWidth += offset;
-				spacings->AddObject(RN::Number::WithFloat(offset));
+				spacings.push_back(offset);
 			}
 			
 			totalHeight += maxAscent;// + maxDescent;
@@ -879,14 +882,16 @@ namespace RN
 			uint32 numberOfVertices = 0;
 			uint32 numberOfIndices = 0;
 			
-			Array *characters = (new Array(_attributedText->GetLength()))->Autorelease();
-			Array *spacings = (new Array(_attributedText->GetLength()))->Autorelease();
+			FrameVector<Mesh *> characters;
+			characters.reserve(_attributedText->GetLength());
+			FrameVector<float> spacings;
+			spacings.reserve(_attributedText->GetLength());
 			
-			std::vector<int> linebreaks;
-			std::vector<float> linewidth;
-			std::vector<float> lineascent;
-			std::vector<float> linedescent;
-			std::vector<float> lineoffset;
+			FrameVector<int> linebreaks;
+			FrameVector<float> linewidth;
+			FrameVector<float> lineascent;
+			FrameVector<float> linedescent;
+			FrameVector<float> lineoffset;
 			
 			float currentWidth = 0.0f;
 			float lastWordWidth = 0.0f;
@@ -969,14 +974,14 @@ namespace RN
 				Mesh *mesh = currentFont->GetMeshForCharacter(currentCodepoint);
 				if(mesh)
 				{
-					characters->AddObject(mesh);
+					characters.push_back(mesh);
 					
 					numberOfVertices += mesh->GetVerticesCount();
 					numberOfIndices += mesh->GetIndicesCount();
 				}
 				else
 				{
-					characters->AddObject(RN::Null::GetNull());
+					characters.push_back(nullptr);
 				}
 				
 				if(GetBounds().width > 0.0f && currentWidth + offset > GetBounds().width && currentAttributes->GetWrapMode() != TextWrapModeNone)
@@ -1001,8 +1006,8 @@ namespace RN
 						
 						if(lastWhiteSpaceIndex != i)
 						{
-							currentWidth -= spacings->GetObjectAtIndex<RN::Number>(lastWhiteSpaceIndex)->GetFloatValue();
-							spacings->ReplaceObjectAtIndex(lastWhiteSpaceIndex, RN::Number::WithFloat(0.0f));
+							currentWidth -= spacings[lastWhiteSpaceIndex];
+							spacings[lastWhiteSpaceIndex] = 0.0f;
 						}
 						else
 						{
@@ -1027,7 +1032,7 @@ namespace RN
 				}
 				
 				currentWidth += offset;
-				spacings->AddObject(RN::Number::WithFloat(offset));
+				spacings.push_back(offset);
 			}
 			
 			if(numberOfIndices < 3)
@@ -1050,11 +1055,13 @@ namespace RN
 			linedescent.push_back(maxDescent);
 			lineoffset.push_back(maxLineOffset + _additionalLineHeight);
 
-			float *vertexPositionBuffer = new float[numberOfVertices * 2];
-			float *vertexUVBuffer = new float[numberOfVertices * (isUsingSDF? 2 : 3)];
-			float *vertexColorBuffer = new float[numberOfVertices * 4];
+			// Only staging data, the mesh copies it
+			FrameAllocator *frameAllocator = FrameAllocator::GetSharedInstance();
+			float *vertexPositionBuffer = frameAllocator->AllocateArray<float>(numberOfVertices * 2);
+			float *vertexUVBuffer = frameAllocator->AllocateArray<float>(numberOfVertices * (isUsingSDF? 2 : 3));
+			float *vertexColorBuffer = frameAllocator->AllocateArray<float>(numberOfVertices * 4);
 			
-			RN::uint32 *indexBuffer = new RN::uint32[numberOfIndices];
+			RN::uint32 *indexBuffer = frameAllocator->AllocateArray<RN::uint32>(numberOfIndices);
 			
 			RN::uint32 vertexOffset = 0;
 			RN::uint32 indexIndexOffset = 0;
@@ -1085,8 +1092,11 @@ namespace RN
 			else if(initialAttributes->GetAlignment() == TextAlignmentCenter)
 				characterPositionX = (GetBounds().width - linewidth[linebreakIndex]) * 0.5f;
 			
-			characters->Enumerate<RN::Mesh>([&](RN::Mesh *mesh, size_t index, bool &stop){
-				if(index > 0) characterPositionX += spacings->GetObjectAtIndex<RN::Number>(index-1)->GetFloatValue();
+			for(size_t index = 0; index < characters.size(); index ++)
+			{
+				RN::Mesh *mesh = characters[index];
+
+				if(index > 0) characterPositionX += spacings[index-1];
 				
 				const TextAttributes *currentAttributes = _attributedText->GetAttributesAtIndex(index);
 				if(!currentAttributes) currentAttributes = &_defaultAttributes;
@@ -1105,12 +1115,12 @@ namespace RN
 					else if(currentAttributes->GetAlignment() == TextAlignmentCenter)
 						characterPositionX = (GetBounds().width - linewidth[linebreakIndex]) * 0.5f;
 					
-					return;
+					continue;
 				}
 				
-				if(!mesh->IsKindOfClass(RN::Mesh::GetMetaClass()))
+				if(!mesh)
 				{
-					return;
+					continue;
 				}
 				
 				RN::Mesh::Chunk chunk = mesh->GetChunk();
@@ -1150,16 +1160,23 @@ namespace RN
 				vertexOffset += mesh->GetVerticesCount();
 				indexOffset += mesh->GetVerticesCount();
 				indexIndexOffset += mesh->GetIndicesCount();
-			});
-			
-			std::vector<RN::Mesh::VertexAttribute> meshVertexAttributes;
-			meshVertexAttributes.emplace_back(RN::Mesh::VertexAttribute::Feature::Vertices, RN::PrimitiveType::Vector2);
-			if(isUsingSDF) meshVertexAttributes.emplace_back(RN::Mesh::VertexAttribute::Feature::UVCoords0, RN::PrimitiveType::Vector2);
-			else meshVertexAttributes.emplace_back(RN::Mesh::VertexAttribute::Feature::UVCoords1, RN::PrimitiveType::Vector3);
-			meshVertexAttributes.emplace_back(RN::Mesh::VertexAttribute::Feature::Color0, RN::PrimitiveType::Vector4);
-			meshVertexAttributes.emplace_back(RN::Mesh::VertexAttribute::Feature::Indices, RN::PrimitiveType::Uint32);
+			}
 			
-			RN::Mesh *textMesh = new RN::Mesh(meshVertexAttributes, numberOfVertices, numberOfIndices);
+			// The layouts never change, so they are only built once instead of on every update
+			static const std::vector<RN::Mesh::VertexAttribute> sdfVertexAttributes = {
+				RN::Mesh::VertexAttribute(RN::Mesh::VertexAttribute::Feature::Vertices, RN::PrimitiveType::Vector2),
+				RN::Mesh::VertexAttribute(RN::Mesh::VertexAttribute::Feature::UVCoords0, RN::PrimitiveType::Vector2),
+				RN::Mesh::VertexAttribute(RN::Mesh::VertexAttribute::Feature::Color0, RN::PrimitiveType::Vector4),
+				RN::Mesh::VertexAttribute(RN::Mesh::VertexAttribute::Feature::Indices, RN::PrimitiveType::Uint32)
+			};
+			static const std::vector<RN::Mesh::VertexAttribute> bitmapVertexAttributes = {
+				RN::Mesh::VertexAttribute(RN::Mesh::VertexAttribute::Feature::Vertices, RN::PrimitiveType::Vector2),
+				RN::Mesh::VertexAttribute(RN::Mesh::VertexAttribute::Feature::UVCoords1, RN::PrimitiveType::Vector3),
+				RN::Mesh::VertexAttribute(RN::Mesh::VertexAttribute::Feature::Color0, RN::PrimitiveType::Vector4),
+				RN::Mesh::VertexAttribute(RN::Mesh::VertexAttribute::Feature::Indices, RN::PrimitiveType::Uint32)
+			};
+			
+			RN::Mesh *textMesh = new RN::Mesh(isUsingSDF? sdfVertexAttributes : bitmapVertexAttributes, numberOfVertices, numberOfIndices);
 			textMesh->BeginChanges();
 			
 			textMesh->SetElementData(RN::Mesh::VertexAttribute::Feature::Vertices, vertexPositionBuffer);
@@ -1169,11 +1186,6 @@ namespace RN
 			textMesh->SetElementData(RN::Mesh::VertexAttribute::Feature::Indices, indexBuffer);
 			
 			textMesh->EndChanges();
-
-			delete[] vertexPositionBuffer;
-			delete[] vertexUVBuffer;
-			delete[] vertexColorBuffer;
-			delete[] indexBuffer;
 			
 			RN::Model *model = GetModel();
 			if(model->GetLODStage(0)->GetCount() == 1)
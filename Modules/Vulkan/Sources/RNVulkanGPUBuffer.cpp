@@ -172,10 +172,11 @@ namespace RN
 
 		VulkanCommandBuffer *commandBuffer = _renderer->StartResourcesCommandBuffer();
 
+		//The staging buffer is new for every mapping, so only the flushed range holds valid data
 		VkBufferCopy copyRegion;
-		copyRegion.srcOffset = 0;
-		copyRegion.dstOffset = 0;
-		copyRegion.size = _length;
+		copyRegion.srcOffset = range.origin;
+		copyRegion.dstOffset = range.origin;
+		copyRegion.size = range.length;
 		vk::CmdCopyBuffer(commandBuffer->GetCommandBuffer(), _stagingBuffer, _buffer, 1, &copyRegion);
 
 		Unlock();
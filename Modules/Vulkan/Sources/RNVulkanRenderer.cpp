@@ -285,7 +285,7 @@ namespace RN
         VkSemaphore resourceUploadsSemaphore = VK_NULL_HANDLE;
 		if(_submittedCommandBuffers->GetCount() > 0)
 		{
-			std::vector<VkCommandBuffer> buffers;
+			FrameVector<VkCommandBuffer> buffers;
 
 			buffers.reserve(_submittedCommandBuffers->GetCount());
 			_submittedCommandBuffers->Enumerate<VulkanCommandBuffer>([&](VulkanCommandBuffer *buffer, int i, bool &stop){
@@ -311,9 +311,8 @@ namespace RN
             submitInfo.signalSemaphoreCount = 1;
             submitInfo.pSignalSemaphores = &resourceUploadsSemaphore;
 
-			std::vector<VkPipelineStageFlags> pipelineStageFlags;
-			pipelineStageFlags.push_back(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
-			submitInfo.pWaitDstStageMask = pipelineStageFlags.data();
+			VkPipelineStageFlags pipelineStageFlags = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+			submitInfo.pWaitDstStageMask = &pipelineStageFlags;
 
 			RNVulkanValidate(vk::QueueSubmit(_workQueue, 1, &submitInfo, VK_NULL_HANDLE));
 
@@ -453,8 +452,10 @@ namespace RN
 		_dynamicBufferPool->FlushAllBuffers();
 
 		//Prepare command buffer submission
-		std::vector<VkSemaphore> presentSemaphores;
-		std::vector<VkSemaphore> renderSemaphores;
+		FrameVector<VkSemaphore> presentSemaphores;
+		FrameVector<VkSemaphore> renderSemaphores;
+		presentSemaphores.reserve(_internals->swapChains.size() + 1);
+		renderSemaphores.reserve(_internals->swapChains.size());
 
         if(resourceUploadsSemaphore) presentSemaphores.push_back(resourceUploadsSemaphore); //Wait until all resources are available
 
@@ -470,7 +471,7 @@ namespace RN
 		SubmitCommandBuffer(_currentCommandBuffer);
 		_currentCommandBuffer = nullptr;
 
-		std::vector<VkCommandBuffer> buffers;
+		FrameVector<VkCommandBuffer> buffers;
 		_lock.Lock();
 		if(_submittedCommandBuffers->GetCount() == 0)
 		{
@@ -497,7 +498,8 @@ namespace RN
 		submitInfo.signalSemaphoreCount = renderSemaphores.size();
 		submitInfo.pSignalSemaphores = renderSemaphores.data();
 
-		std::vector<VkPipelineStageFlags> pipelineStageFlags;
+		FrameVector<VkPipelineStageFlags> pipelineStageFlags;
+		pipelineStageFlags.reserve(presentSemaphores.size());
 		for(int i = 0; i < presentSemaphores.size(); i++)
 		{
 			pipelineStageFlags.push_back(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
@@ -882,6 +884,7 @@ namespace RN
 			case PrimitiveType::Int32:
 			case PrimitiveType::Float:
 			case PrimitiveType::HalfVector2:
+			case PrimitiveType::Color8:
 				return 4;
 
 			case PrimitiveType::Vector2:
@@ -916,6 +919,7 @@ namespace RN
 			case PrimitiveType::Int32:
 			case PrimitiveType::Float:
 			case PrimitiveType::HalfVector2:
+			case PrimitiveType::Color8:
 				return 4;
 
 			case PrimitiveType::Vector2:
@@ -1821,11 +1825,11 @@ namespace RN
 			_internals->currentRenderPassIndex += 1;
 		}
 
-		std::vector<VkWriteDescriptorSet> writeDescriptorSets;
+		FrameVector<VkWriteDescriptorSet> writeDescriptorSets;
 		writeDescriptorSets.reserve(totalConstantBufferCount + totalTextureCount);
-		std::vector<VkDescriptorBufferInfo> constantBufferDescriptorInfoArray;
+		FrameVector<VkDescriptorBufferInfo> constantBufferDescriptorInfoArray;
 		constantBufferDescriptorInfoArray.reserve(totalConstantBufferCount);
-		std::vector<VkDescriptorImageInfo> imageBufferDescriptorInfoArray;
+		FrameVector<VkDescriptorImageInfo> imageBufferDescriptorInfoArray;
 		imageBufferDescriptorInfoArray.reserve(totalTextureCount);
 
 		_internals->currentRenderPassIndex = 0;
@@ -42,7 +42,8 @@ namespace RN
 			VK_FORMAT_R32G32B32A32_SFLOAT,
 
 			VK_FORMAT_R32G32B32A32_SFLOAT,
-			VK_FORMAT_R32G32B32A32_SFLOAT
+			VK_FORMAT_R32G32B32A32_SFLOAT,
+			VK_FORMAT_R8G8B8A8_UNORM
 		};
 
 	VkBlendFactor _blendFactorLookup[] =
@@ -9,6 +9,7 @@
 #include "../Objects/RNAutoreleasePool.h"
 #include "../Threads/RNWorkQueue.h"
 #include "../Debug/RNLogger.h"
+#include "../Debug/RNProfiler.h"
 #include "RNAssetLoader.h"
 #include "RNAssetManager.h"
 
@@ -52,8 +53,18 @@ namespace RN
 		throw NotImplementedException("Load(const String *, const LoadOptions &) not implemented");
 	}
 
+	static const char *GetProfilerDetail(Object *fileOrName)
+	{
+		if(fileOrName->IsKindOfClass(File::GetMetaClass()))
+			return static_cast<File *>(fileOrName)->GetPath()->GetUTF8String();
+
+		return static_cast<String *>(fileOrName)->GetUTF8String();
+	}
+
 	Expected<Asset *> AssetLoader::__Load(Object *fileOrName, const LoadOptions &options) RN_NOEXCEPT
 	{
+		RN_PROFILE_ZONE_DETAIL("Asset load", GetProfilerDetail(fileOrName));
+
 		try
 		{
 			if(fileOrName->IsKindOfClass(File::GetMetaClass()))
@@ -85,6 +96,8 @@ namespace RN
 			{
 				AutoreleasePool::PerformBlock([&] {
 
+					RN_PROFILE_ZONE_DETAIL("Asset load", GetProfilerDetail(fileOrName));
+
 					if(fileOrName->IsKindOfClass(File::GetMetaClass()))
 					{
 						File *file = static_cast<File *>(fileOrName);
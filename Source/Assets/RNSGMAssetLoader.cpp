@@ -20,6 +20,11 @@ namespace RN
 
 	static SGMAssetLoader *__assetLoader;
 
+	static size_t AlignOffset(size_t offset)
+	{
+		return (offset + (kRNSGMSectionAlignment - 1)) & ~static_cast<size_t>(kRNSGMSectionAlignment - 1);
+	}
+
 	void SGMAssetLoader::Register()
 	{
 		uint8 magic[] = { 0x90, 0x22, 0x5, 0x15 };
@@ -137,7 +142,7 @@ namespace RN
 			model->SetShadowVolume(shadowVolume->Autorelease());
 		}
 
-		model->CalculateBoundingVolumes();
+		model->CalculateBoundingVolumes(false); // Every mesh is loaded with its bounds, no matter which version its stage file has
 		return model->Autorelease();
 	}
 
@@ -293,184 +298,7 @@ namespace RN
 
 			auto &materialPair = materials[file->ReadUint8()];
 
-			uint32 verticesCount = (version == 1)?file->ReadUint16() : file->ReadUint32(); //Only difference to version 1 with magic number... makes index size support further down kinda useless :D
-			uint8 uvCount   = file->ReadUint8();
-			uint8 dataCount = file->ReadUint8();
-			bool hasTangent = file->ReadUint8();
-			bool hasBones   = file->ReadUint8();
-
-			std::vector<Mesh::VertexAttribute> attributes;
-			
-			//TODO: Also add an options for bones data
-			//TODO: Add an option for 16bit int uv coords? but they require shader changes I think....
-			//TODO: Add an option for 8bit colors?
-			//TODO: Add an option for 8bit normals?
-			bool use16bitPositions = false;
-			bool use16bitNormalsAndTangents = false;
-			bool use16bitColors = false;
-			if(options.settings->GetObjectForKey(RNCSTR("use16BitPositions")))
-			{
-				Number *number = options.settings->GetObjectForKey<Number>(RNCSTR("use16BitPositions"));
-				use16bitPositions = number->GetBoolValue();
-			}
-			if(options.settings->GetObjectForKey(RNCSTR("use16bitNormalsAndTangents")))
-			{
-				Number *number = options.settings->GetObjectForKey<Number>(RNCSTR("use16bitNormalsAndTangents"));
-				use16bitNormalsAndTangents = number->GetBoolValue();
-			}
-			if(options.settings->GetObjectForKey(RNCSTR("use8bitColors")))
-			{
-				Number *number = options.settings->GetObjectForKey<Number>(RNCSTR("use16bitColors"));
-				use16bitColors = number->GetBoolValue();
-			}
-
-			attributes.emplace_back(Mesh::VertexAttribute::Feature::Vertices, use16bitPositions? PrimitiveType::HalfVector3 : PrimitiveType::Vector3);
-			attributes.emplace_back(Mesh::VertexAttribute::Feature::Normals, use16bitNormalsAndTangents? PrimitiveType::HalfVector3 : PrimitiveType::Vector3);
-
-			size_t originalVertexSize = 2 * sizeof(Vector3);
-			size_t size = use16bitPositions? sizeof(uint16) * 3 : sizeof(Vector3);
-			size += use16bitNormalsAndTangents? sizeof(uint16) * 3 : sizeof(Vector3);
-
-			size_t uv0Offset = 0;
-			size_t uv1Offset = 0;
-			size_t tangentOffset = 0;
-			size_t colorOffset = 0;
-			size_t boneWeightOffset = 0;
-			size_t boneIndicesOffset = 0;
-
-			if(uvCount > 0)
-			{
-				attributes.emplace_back(Mesh::VertexAttribute::Feature::UVCoords0, PrimitiveType::Vector2);
-				uv0Offset = originalVertexSize;
-				size += sizeof(Vector2);
-				originalVertexSize += sizeof(Vector2);
-			}
-			
-			if(uvCount > 1)
-			{
-				attributes.emplace_back(Mesh::VertexAttribute::Feature::UVCoords1, PrimitiveType::Vector2);
-				uv1Offset = originalVertexSize;
-				size += sizeof(Vector2);
-				originalVertexSize += sizeof(Vector2);
-			}
-
-			if(dataCount == 4)
-			{
-				attributes.emplace_back(Mesh::VertexAttribute::Feature::Color0, use16bitColors? PrimitiveType::HalfVector4 : PrimitiveType::Color);
-				colorOffset = originalVertexSize;
-				size += use16bitColors? sizeof(uint16) * 4 : sizeof(Color);
-				originalVertexSize += sizeof(Color);
-			}
-			
-			if(hasTangent)
-			{
-				attributes.emplace_back(Mesh::VertexAttribute::Feature::Tangents, use16bitNormalsAndTangents? PrimitiveType::HalfVector4 : PrimitiveType::Vector4);
-				tangentOffset = originalVertexSize;
-				size += use16bitNormalsAndTangents? sizeof(uint16) * 4 : sizeof(Vector4);
-				originalVertexSize += sizeof(Vector4);
-			}
-
-			if(hasBones)
-			{
-				attributes.emplace_back(Mesh::VertexAttribute::Feature::BoneWeights, PrimitiveType::Vector4);
-				boneWeightOffset = originalVertexSize;
-				size += sizeof(Vector4);
-				originalVertexSize += sizeof(Vector4);
-				
-				attributes.emplace_back(Mesh::VertexAttribute::Feature::BoneIndices, PrimitiveType::Vector4);
-				boneIndicesOffset = originalVertexSize;
-				size += sizeof(Vector4);
-				originalVertexSize += sizeof(Vector4);
-			}
-
-			size_t originalVerticesSize = originalVertexSize * verticesCount;
-
-			//Read vertex data from file into buffer to insert into mesh further down
-			uint8 *buffer = new uint8[originalVerticesSize];
-			file->Read(buffer, originalVerticesSize);
-
-			uint32 indicesCount = file->ReadUint32();
-			uint8 indicesSize = file->ReadUint8();
-			attributes.emplace_back(Mesh::VertexAttribute::Feature::Indices, indicesSize < 4? PrimitiveType::Uint16 : PrimitiveType::Uint32);
-
-
-			// Create the mesh
-			Mesh *mesh = new Mesh(attributes, verticesCount, indicesCount);
-			mesh->BeginChanges();
-
-			// Tear the mesh apart
-			uint8 *buildBuffer = new uint8[verticesCount * sizeof(Vector4)];
-
-#define CopyVertexData(elementSize, offset, feature) \
-			do { \
-				uint8 *tempBuffer = buffer; \
-				uint8 *tempBuildBuffer = buildBuffer; \
-	            for(size_t i = 0; i < verticesCount; i ++) \
-    	        { \
-					std::copy(tempBuffer + offset, tempBuffer + offset + elementSize, tempBuildBuffer); \
-	                tempBuildBuffer += elementSize; \
-					tempBuffer += originalVertexSize; \
-            	} \
-				mesh->SetElementData(feature, buildBuffer); \
-            } while(0)
-			
-#define CopyVertexDataCompressed(floatCount, originalOffset, feature) \
-			do { \
-				float *tempBuffer = reinterpret_cast<float*>(buffer + originalOffset); \
-				uint16 *tempBuildBuffer = reinterpret_cast<uint16*>(buildBuffer); \
-				for(size_t i = 0; i < verticesCount; i ++) \
-				{ \
-					for(uint8 f = 0; f < floatCount; f++) \
-					{ \
-						uint16 compressed = Math::ConvertFloatToHalf(*tempBuffer); \
-						std::copy(&compressed, &compressed + 1, tempBuildBuffer); \
-						tempBuffer += 1; \
-						tempBuildBuffer += 1; \
-					} \
-					tempBuffer += std::max((originalVertexSize / 4 - floatCount), static_cast<size_t>(0)); \
-				} \
-				mesh->SetElementData(feature, buildBuffer); \
-			} while(0)
-
-			if(use16bitPositions) CopyVertexDataCompressed(3, 0, Mesh::VertexAttribute::Feature::Vertices);
-			else CopyVertexData(sizeof(Vector3), 0, Mesh::VertexAttribute::Feature::Vertices);
-			if(use16bitNormalsAndTangents) CopyVertexDataCompressed(3, sizeof(Vector3), Mesh::VertexAttribute::Feature::Normals);
-			else CopyVertexData(sizeof(Vector3), sizeof(Vector3), Mesh::VertexAttribute::Feature::Normals);
-
-			if(uvCount > 0)
-			{
-				CopyVertexData(sizeof(Vector2), uv0Offset, Mesh::VertexAttribute::Feature::UVCoords0);
-			}
-			if(uvCount > 1)
-			{
-				CopyVertexData(sizeof(Vector2), uv1Offset, Mesh::VertexAttribute::Feature::UVCoords1);
-			}
-			if(dataCount == 4)
-			{
-				if(use16bitNormalsAndTangents) CopyVertexDataCompressed(4, colorOffset, Mesh::VertexAttribute::Feature::Color0);
-				else CopyVertexData(sizeof(Color), colorOffset, Mesh::VertexAttribute::Feature::Color0);
-			}
-			if(hasTangent)
-			{
-				if(use16bitNormalsAndTangents) CopyVertexDataCompressed(4, tangentOffset, Mesh::VertexAttribute::Feature::Tangents);
-				else CopyVertexData(sizeof(Vector4), tangentOffset, Mesh::VertexAttribute::Feature::Tangents);
-			}
-			if(hasBones)
-			{
-				CopyVertexData(sizeof(Vector4), boneWeightOffset, Mesh::VertexAttribute::Feature::BoneWeights);
-				CopyVertexData(sizeof(Vector4), boneIndicesOffset, Mesh::VertexAttribute::Feature::BoneIndices);
-			}
-
-			delete[] buildBuffer;
-			delete[] buffer;
-
-			//Read index buffer from file
-			uint8 *indicesBuffer = new uint8[indicesCount * indicesSize];
-			file->Read(indicesBuffer, indicesCount * indicesSize);
-			mesh->SetElementData(Mesh::VertexAttribute::Feature::Indices, indicesBuffer);
-			delete[] indicesBuffer;
-
-			mesh->EndChanges();
+			Mesh *mesh = (version > 3)? LoadPackedMesh(file) : LoadInterleavedMesh(file, version, options);
 
 			// Load the material
 			bool wantsDiscard = materialPair.first;
@@ -529,11 +357,309 @@ namespace RN
 		}
 	}
 
+	Mesh *SGMAssetLoader::LoadInterleavedMesh(File *file, uint32 version, const LoadOptions &options)
+	{
+		uint32 verticesCount = (version == 1)?file->ReadUint16() : file->ReadUint32(); //Only difference to version 1 with magic number... makes index size support further down kinda useless :D
+		uint8 uvCount   = file->ReadUint8();
+		uint8 dataCount = file->ReadUint8();
+		bool hasTangent = file->ReadUint8();
+		bool hasBones   = file->ReadUint8();
+
+		std::vector<Mesh::VertexAttribute> attributes;
+		
+		//TODO: Also add an options for bones data
+		//TODO: Add an option for 16bit int uv coords? but they require shader changes I think....
+		//TODO: Add an option for 8bit colors?
+		//TODO: Add an option for 8bit normals?
+		bool use16bitPositions = false;
+		bool use16bitNormalsAndTangents = false;
+		bool use16bitColors = false;
+		if(options.settings->GetObjectForKey(RNCSTR("use16BitPositions")))
+		{
+			Number *number = options.settings->GetObjectForKey<Number>(RNCSTR("use16BitPositions"));
+			use16bitPositions = number->GetBoolValue();
+		}
+		if(options.settings->GetObjectForKey(RNCSTR("use16bitNormalsAndTangents")))
+		{
+			Number *number = options.settings->GetObjectForKey<Number>(RNCSTR("use16bitNormalsAndTangents"));
+			use16bitNormalsAndTangents = number->GetBoolValue();
+		}
+		if(options.settings->GetObjectForKey(RNCSTR("use8bitColors")))
+		{
+			Number *number = options.settings->GetObjectForKey<Number>(RNCSTR("use16bitColors"));
+			use16bitColors = number->GetBoolValue();
+		}
+
+		attributes.emplace_back(Mesh::VertexAttribute::Feature::Vertices, use16bitPositions? PrimitiveType::HalfVector3 : PrimitiveType::Vector3);
+		attributes.emplace_back(Mesh::VertexAttribute::Feature::Normals, use16bitNormalsAndTangents? PrimitiveType::HalfVector3 : PrimitiveType::Vector3);
+
+		size_t originalVertexSize = 2 * sizeof(Vector3);
+		size_t size = use16bitPositions? sizeof(uint16) * 3 : sizeof(Vector3);
+		size += use16bitNormalsAndTangents? sizeof(uint16) * 3 : sizeof(Vector3);
+
+		size_t uv0Offset = 0;
+		size_t uv1Offset = 0;
+		size_t tangentOffset = 0;
+		size_t colorOffset = 0;
+		size_t boneWeightOffset = 0;
+		size_t boneIndicesOffset = 0;
+
+		if(uvCount > 0)
+		{
+			attributes.emplace_back(Mesh::VertexAttribute::Feature::UVCoords0, PrimitiveType::Vector2);
+			uv0Offset = originalVertexSize;
+			size += sizeof(Vector2);
+			originalVertexSize += sizeof(Vector2);
+		}
+		
+		if(uvCount > 1)
+		{
+			attributes.emplace_back(Mesh::VertexAttribute::Feature::UVCoords1, PrimitiveType::Vector2);
+			uv1Offset = originalVertexSize;
+			size += sizeof(Vector2);
+			originalVertexSize += sizeof(Vector2);
+		}
+
+		if(dataCount == 4)
+		{
+			attributes.emplace_back(Mesh::VertexAttribute::Feature::Color0, use16bitColors? PrimitiveType::HalfVector4 : PrimitiveType::Color);
+			colorOffset = originalVertexSize;
+			size += use16bitColors? sizeof(uint16) * 4 : sizeof(Color);
+			originalVertexSize += sizeof(Color);
+		}
+		
+		if(hasTangent)
+		{
+			attributes.emplace_back(Mesh::VertexAttribute::Feature::Tangents, use16bitNormalsAndTangents? PrimitiveType::HalfVector4 : PrimitiveType::Vector4);
+			tangentOffset = originalVertexSize;
+			size += use16bitNormalsAndTangents? sizeof(uint16) * 4 : sizeof(Vector4);
+			originalVertexSize += sizeof(Vector4);
+		}
+
+		if(hasBones)
+		{
+			attributes.emplace_back(Mesh::VertexAttribute::Feature::BoneWeights, PrimitiveType::Vector4);
+			boneWeightOffset = originalVertexSize;
+			size += sizeof(Vector4);
+			originalVertexSize += sizeof(Vector4);
+			
+			attributes.emplace_back(Mesh::VertexAttribute::Feature::BoneIndices, PrimitiveType::Vector4);
+			boneIndicesOffset = originalVertexSize;
+			size += sizeof(Vector4);
+			originalVertexSize += sizeof(Vector4);
+		}
+
+		size_t originalVerticesSize = originalVertexSize * verticesCount;
+
+		//Read vertex data from file into buffer to insert into mesh further down
+		uint8 *buffer = new uint8[originalVerticesSize];
+		file->Read(buffer, originalVerticesSize);
+
+		uint32 indicesCount = file->ReadUint32();
+		uint8 indicesSize = file->ReadUint8();
+		attributes.emplace_back(Mesh::VertexAttribute::Feature::Indices, indicesSize < 4? PrimitiveType::Uint16 : PrimitiveType::Uint32);
+
+
+		// Create the mesh
+		Mesh *mesh = new Mesh(attributes, verticesCount, indicesCount);
+		mesh->BeginChanges();
+
+		// Tear the mesh apart
+		uint8 *buildBuffer = new uint8[verticesCount * sizeof(Vector4)];
+
+#define CopyVertexData(elementSize, offset, feature) \
+		do { \
+			uint8 *tempBuffer = buffer; \
+			uint8 *tempBuildBuffer = buildBuffer; \
+            for(size_t i = 0; i < verticesCount; i ++) \
+    	        { \
+				std::copy(tempBuffer + offset, tempBuffer + offset + elementSize, tempBuildBuffer); \
+                tempBuildBuffer += elementSize; \
+				tempBuffer += originalVertexSize; \
+            	} \
+			mesh->SetElementData(feature, buildBuffer); \
+            } while(0)
+		
+#define CopyVertexDataCompressed(floatCount, originalOffset, feature) \
+		do { \
+			float *tempBuffer = reinterpret_cast<float*>(buffer + originalOffset); \
+			uint16 *tempBuildBuffer = reinterpret_cast<uint16*>(buildBuffer); \
+			for(size_t i = 0; i < verticesCount; i ++) \
+			{ \
+				for(uint8 f = 0; f < floatCount; f++) \
+				{ \
+					uint16 compressed = Math::ConvertFloatToHalf(*tempBuffer); \
+					std::copy(&compressed, &compressed + 1, tempBuildBuffer); \
+					tempBuffer += 1; \
+					tempBuildBuffer += 1; \
+				} \
+				tempBuffer += std::max((originalVertexSize / 4 - floatCount), static_cast<size_t>(0)); \
+			} \
+			mesh->SetElementData(feature, buildBuffer); \
+		} while(0)
+
+		if(use16bitPositions) CopyVertexDataCompressed(3, 0, Mesh::VertexAttribute::Feature::Vertices);
+		else CopyVertexData(sizeof(Vector3), 0, Mesh::VertexAttribute::Feature::Vertices);
+		if(use16bitNormalsAndTangents) CopyVertexDataCompressed(3, sizeof(Vector3), Mesh::VertexAttribute::Feature::Normals);
+		else CopyVertexData(sizeof(Vector3), sizeof(Vector3), Mesh::VertexAttribute::Feature::Normals);
+
+		if(uvCount > 0)
+		{
+			CopyVertexData(sizeof(Vector2), uv0Offset, Mesh::VertexAttribute::Feature::UVCoords0);
+		}
+		if(uvCount > 1)
+		{
+			CopyVertexData(sizeof(Vector2), uv1Offset, Mesh::VertexAttribute::Feature::UVCoords1);
+		}
+		if(dataCount == 4)
+		{
+			if(use16bitNormalsAndTangents) CopyVertexDataCompressed(4, colorOffset, Mesh::VertexAttribute::Feature::Color0);
+			else CopyVertexData(sizeof(Color), colorOffset, Mesh::VertexAttribute::Feature::Color0);
+		}
+		if(hasTangent)
+		{
+			if(use16bitNormalsAndTangents) CopyVertexDataCompressed(4, tangentOffset, Mesh::VertexAttribute::Feature::Tangents);
+			else CopyVertexData(sizeof(Vector4), tangentOffset, Mesh::VertexAttribute::Feature::Tangents);
+		}
+		if(hasBones)
+		{
+			CopyVertexData(sizeof(Vector4), boneWeightOffset, Mesh::VertexAttribute::Feature::BoneWeights);
+			CopyVertexData(sizeof(Vector4), boneIndicesOffset, Mesh::VertexAttribute::Feature::BoneIndices);
+		}
+
+		delete[] buildBuffer;
+		delete[] buffer;
+
+		//Read index buffer from file
+		uint8 *indicesBuffer = new uint8[indicesCount * indicesSize];
+		file->Read(indicesBuffer, indicesCount * indicesSize);
+		mesh->SetElementData(Mesh::VertexAttribute::Feature::Indices, indicesBuffer);
+		delete[] indicesBuffer;
+
+		// Versions before 4 don't store bounds
+		mesh->CalculateBoundingVolumes();
+		mesh->EndChanges();
+
+		return mesh;
+	}
+
+	// Version 4 stores each mesh in the layout Mesh uses on the GPU, so the vertices and indices end up in the
+	// mesh buffers with one read each. The attribute types can be quantized (half positions, normals and uvs, 8 bit colors),
+	// and the bounds are precomputed. Both sections start at a multiple of kRNSGMSectionAlignment from the beginning of the file.
+	//
+	//	number of vertices - uint32
+	//	number of indices - uint32
+	//	index size - uint8, 2 or 4 bytes
+	//	number of attributes - uint8
+	//		feature - uint8, Mesh::VertexAttribute::Feature
+	//		type - uint8, PrimitiveType
+	//		offset - uint32
+	//	stride - uint32
+	//	size of the separated positions - uint32, 0 if positions are interleaved with everything else
+	//	stride of the separated positions - uint32
+	//	size of the vertex data - uint32
+	//	bounding box min and max - float32*6
+	//	bounding sphere center and radius - float32*4
+	//	padding, vertex data
+	//	padding, indices
+	Mesh *SGMAssetLoader::LoadPackedMesh(File *file)
+	{
+		uint32 verticesCount = file->ReadUint32();
+		uint32 indicesCount = file->ReadUint32();
+		uint8 indicesSize = file->ReadUint8();
+		uint8 attributeCount = file->ReadUint8();
+
+		if(indicesSize != 2 && indicesSize != 4)
+			throw InconsistencyException(RNSTR("Invalid index size " << indicesSize << " in " << file->GetPath()));
+
+		std::vector<Mesh::VertexAttribute> attributes;
+		std::vector<uint32> offsets;
+
+		for(uint8 i = 0; i < attributeCount; i ++)
+		{
+			uint8 feature = file->ReadUint8();
+			uint8 type = file->ReadUint8();
+
+			if(feature >= static_cast<uint8>(Mesh::VertexAttribute::Feature::Custom) || feature == static_cast<uint8>(Mesh::VertexAttribute::Feature::Indices) || type == static_cast<uint8>(PrimitiveType::Invalid) || type > static_cast<uint8>(PrimitiveType::Color8))
+				throw InconsistencyException(RNSTR("Invalid vertex attribute in " << file->GetPath()));
+
+			attributes.emplace_back(static_cast<Mesh::VertexAttribute::Feature>(feature), static_cast<PrimitiveType>(type));
+			offsets.push_back(file->ReadUint32());
+		}
+
+		attributes.emplace_back(Mesh::VertexAttribute::Feature::Indices, indicesSize == 2? PrimitiveType::Uint16 : PrimitiveType::Uint32);
+
+		uint32 stride = file->ReadUint32();
+		uint32 positionsSize = file->ReadUint32();
+		uint32 positionsStride = file->ReadUint32();
+		uint32 verticesSize = file->ReadUint32();
+
+		Vector3 boundsMin, boundsMax, sphereCenter;
+		file->Read(&boundsMin.x, sizeof(float) * 3);
+		file->Read(&boundsMax.x, sizeof(float) * 3);
+		file->Read(&sphereCenter.x, sizeof(float) * 3);
+		float sphereRadius = file->ReadFloat();
+
+		Mesh *mesh = new Mesh(attributes, verticesCount, indicesCount);
+		mesh->BeginChanges();
+
+		// The layout depends on the renderer, so the file only matches if it was written for the same size and alignment rules
+		bool sameLayout = (mesh->GetStride() == stride && mesh->GetVertexPositionsSeparatedSize() == positionsSize && mesh->GetVertexPositionsSeparatedStride() == positionsStride);
+		sameLayout = sameLayout && (mesh->GetStride() * verticesCount + positionsSize == verticesSize);
+
+		for(size_t i = 0; i < offsets.size() && sameLayout; i ++)
+			sameLayout = (mesh->GetVertexAttributes()[i].GetOffset() == offsets[i]);
+
+		file->Seek(AlignOffset(file->GetOffset()));
+
+		if(sameLayout)
+		{
+			if(file->Read(mesh->GetCPUVertexBuffer(), verticesSize) != verticesSize)
+				throw InconsistencyException(RNSTR("Unexpected end of file in " << file->GetPath()));
+		}
+		else
+		{
+			// Fall back to copying attribute by attribute, ie. for the headless renderer which packs everything tightly
+			std::vector<uint8> buffer(verticesSize);
+
+			if(file->Read(buffer.data(), verticesSize) != verticesSize)
+				throw InconsistencyException(RNSTR("Unexpected end of file in " << file->GetPath()));
+
+			for(size_t i = 0; i < offsets.size(); i ++)
+			{
+				const Mesh::VertexAttribute &attribute = attributes[i];
+				const bool separated = (attribute.GetFeature() == Mesh::VertexAttribute::Feature::Vertices && positionsSize > 0);
+
+				const size_t base = (separated? 0 : positionsSize) + offsets[i];
+				const size_t elementStride = separated? positionsStride : stride;
+
+				if(verticesCount > 0 && base + elementStride * (verticesCount - 1) + mesh->GetAttribute(attribute.GetFeature())->GetSize() > verticesSize)
+					throw InconsistencyException(RNSTR("Invalid vertex layout in " << file->GetPath()));
+
+				mesh->SetElementData(attribute.GetFeature(), buffer.data() + base, elementStride);
+			}
+		}
+
+		file->Seek(AlignOffset(file->GetOffset()));
+
+		const size_t indicesDataSize = static_cast<size_t>(indicesCount) * indicesSize;
+		if(file->Read(mesh->GetCPUIndicesBuffer(), indicesDataSize) != indicesDataSize)
+			throw InconsistencyException(RNSTR("Unexpected end of file in " << file->GetPath()));
+
+		mesh->changedVertices = true;
+		mesh->changedIndices = true;
+
+		mesh->SetBoundingVolumes(AABB(boundsMin, boundsMax), Sphere(sphereCenter, sphereRadius));
+		mesh->EndChanges();
+
+		return mesh;
+	}
+
 	bool SGMAssetLoader::SupportsLoadingFile(File *file) const
 	{
 		file->Seek(4); // Skip the magic bytes, they've already been checked
 		uint32 version = file->ReadUint8();
 
-		return (version == 3 || version == 2 || version == 1);
+		return (version == 4 || version == 3 || version == 2 || version == 1);
 	}
 }
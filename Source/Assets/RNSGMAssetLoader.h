@@ -13,6 +13,8 @@
 #include "../Rendering/RNModel.h"
 #include "RNAssetLoader.h"
 
+#define kRNSGMSectionAlignment 16
+
 namespace RN
 {
 	class SGMAssetLoader : public AssetLoader
@@ -27,6 +29,8 @@ namespace RN
 		SGMAssetLoader(const Config &config);
 
 		void LoadLODStage(File *file, Model::LODStage *stage, const LoadOptions &options);
+		Mesh *LoadInterleavedMesh(File *file, uint32 version, const LoadOptions &options);
+		Mesh *LoadPackedMesh(File *file);
 
 		__RNDeclareMetaInternal(SGMAssetLoader)
 	};
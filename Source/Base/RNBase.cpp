@@ -158,7 +158,6 @@ class AndroidBuffer : public std::streambuf
 
 namespace RN
 {
-	static MemoryPool *__functionPool;
 #if RN_ENABLE_VTUNE
 	__itt_domain *VTuneDomain;
 #endif
@@ -168,8 +167,6 @@ namespace RN
 	public:
 		static Kernel *BootstrapKernel(Application *app, const ArgumentParser &arguments, void *object)
 		{
-			__functionPool = new MemoryPool();
-
 #if RN_PLATFORM_WINDOWS
 			if(!arguments.HasArgument("no-locale", '\0'))
 			{
@@ -250,9 +247,6 @@ namespace RN
 #else
 			kernel->TearDown();
 #endif
-
-			delete __functionPool;
-			__functionPool = nullptr;
 		}
 	};
 
@@ -260,11 +254,6 @@ namespace RN
 	RNAPI void __TearDownKernel(Kernel *kernel);
 
 
-	MemoryPool *__GetFunctionPool()
-	{
-		return __functionPool;
-	}
-
 	Kernel *__BootstrapKernel(Application *app, const ArgumentParser &arguments, void *object)
 	{
 		Kernel *result = __KernelBootstrapHelper::BootstrapKernel(app, arguments, object);
@@ -0,0 +1,274 @@
+//
+//  RNFrameAllocator.cpp
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "RNFrameAllocator.h"
+#include "RNMemory.h"
+
+namespace RN
+{
+	/**
+	 * Chunks are linked into the list of the frame slot they were handed out in and move back into the free lists
+	 * as a whole once that slot comes around again. Allocations that don't fit into a regular chunk get a chunk
+	 * of their own, which is kept in a separate free list so small allocations can't take them away from the big ones.
+	 * To give memory back after spikes, only as many regular chunks are kept around as the busiest frame of the last
+	 * trim interval used, and dedicated chunks are released if they weren't picked up again during a whole frame.
+	 **/
+
+	struct alignas(64) __FrameAllocatorChunk
+	{
+		uint8 *GetData() { return reinterpret_cast<uint8 *>(this + 1); }
+
+		__FrameAllocatorChunk *next;
+		size_t size; // Usable bytes after the header
+	};
+
+	struct __FrameAllocatorThreadState
+	{
+		uint64 id;
+		uint64 frame;
+		uintptr_t cursor;
+		uintptr_t end;
+	};
+
+	static constexpr size_t kFrameAllocatorChunkDataSize = kRNFrameAllocatorChunkSize - sizeof(__FrameAllocatorChunk);
+	static constexpr uint64 kFrameAllocatorTrimInterval = 300;
+
+	static std::atomic<uint64> __frameAllocatorNextID(0);
+	static thread_local __FrameAllocatorThreadState __frameAllocatorThreadState = { 0, 0, 0, 0 };
+
+
+	FrameAllocator::FrameAllocator() :
+		_id(__frameAllocatorNextID.fetch_add(1, std::memory_order_relaxed) + 1),
+		_frame(0),
+		_freeChunks(nullptr),
+		_freeLargeChunks(nullptr),
+		_freeChunkCount(0),
+		_chunkPeak(0),
+		_chunkKeepCount(0),
+		_chunkAllocations(0),
+		_chunkCount(0),
+		_reservedBytes(0),
+		_frameStartHeapAllocations(Memory::GetAllocationCount()),
+		_lastFrameHeapAllocations(0)
+	{
+		for(size_t i = 0; i < kRNFrameAllocatorFrames; i ++)
+		{
+			_frameChunks[i] = nullptr;
+			_frameChunkCounts[i] = 0;
+			_frameBytes[i] = 0;
+		}
+	}
+	FrameAllocator::~FrameAllocator()
+	{
+		for(size_t i = 0; i < kRNFrameAllocatorFrames; i ++)
+			ReleaseChunks(_frameChunks[i]);
+
+		ReleaseChunks(_freeChunks);
+		ReleaseChunks(_freeLargeChunks);
+	}
+
+	FrameAllocator *FrameAllocator::GetSharedInstance()
+	{
+		static FrameAllocator *allocator = new FrameAllocator();
+		return allocator;
+	}
+
+
+	void *FrameAllocator::Allocate(size_t size, size_t alignment)
+	{
+		__FrameAllocatorThreadState &state = __frameAllocatorThreadState;
+
+		if(RN_EXPECT_TRUE(state.id == _id && state.frame == _frame.load(std::memory_order_acquire)))
+		{
+			uintptr_t address = (state.cursor + alignment - 1) & ~(alignment - 1);
+
+			if(RN_EXPECT_TRUE(address + size <= state.end))
+			{
+				state.cursor = address + size;
+				return reinterpret_cast<void *>(address);
+			}
+		}
+
+		return AllocateSlow(size, alignment);
+	}
+
+	void *FrameAllocator::AllocateSlow(size_t size, size_t alignment)
+	{
+		RN_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two");
+
+		const size_t required = size + alignment - 1;
+
+		LockGuard<Lockable> lock(_lock);
+
+		const uint64 frame = _frame.load(std::memory_order_relaxed);
+		const size_t slot = frame % kRNFrameAllocatorFrames;
+
+		__FrameAllocatorChunk *chunk = AcquireChunk(required);
+		chunk->next = _frameChunks[slot];
+
+		_frameChunks[slot] = chunk;
+		_frameBytes[slot] += chunk->size;
+
+		if(chunk->size == kFrameAllocatorChunkDataSize)
+			_frameChunkCounts[slot] ++;
+
+		const uintptr_t begin = reinterpret_cast<uintptr_t>(chunk->GetData());
+		const uintptr_t address = (begin + alignment - 1) & ~(alignment - 1);
+
+		// Dedicated chunks are used up by this allocation, the thread keeps bumping through its current chunk
+		if(required <= kFrameAllocatorChunkDataSize)
+		{
+			__FrameAllocatorThreadState &state = __frameAllocatorThreadState;
+
+			state.id = _id;
+			state.frame = frame;
+			state.cursor = address + size;
+			state.end = begin + chunk->size;
+		}
+
+		return reinterpret_cast<void *>(address);
+	}
+
+	__FrameAllocatorChunk *FrameAllocator::AcquireChunk(size_t size)
+	{
+		if(size <= kFrameAllocatorChunkDataSize)
+		{
+			if(_freeChunks)
+			{
+				__FrameAllocatorChunk *chunk = _freeChunks;
+				_freeChunks = chunk->next;
+				_freeChunkCount --;
+
+				return chunk;
+			}
+
+			size = kFrameAllocatorChunkDataSize;
+		}
+		else
+		{
+			__FrameAllocatorChunk **link = &_freeLargeChunks;
+
+			while(*link)
+			{
+				__FrameAllocatorChunk *chunk = *link;
+
+				if(chunk->size >= size)
+				{
+					*link = chunk->next;
+					return chunk;
+				}
+
+				link = &chunk->next;
+			}
+		}
+
+		void *memory = Memory::AllocateAligned(sizeof(__FrameAllocatorChunk) + size, alignof(__FrameAllocatorChunk));
+		if(!memory)
+			throw std::bad_alloc();
+
+		__FrameAllocatorChunk *chunk = new(memory) __FrameAllocatorChunk();
+		chunk->next = nullptr;
+		chunk->size = size;
+
+		_chunkAllocations ++;
+		_chunkCount ++;
+		_reservedBytes += sizeof(__FrameAllocatorChunk) + size;
+
+		return chunk;
+	}
+
+	void FrameAllocator::BeginFrame()
+	{
+		LockGuard<Lockable> lock(_lock);
+
+		const size_t heapAllocations = Memory::GetAllocationCount();
+
+		_lastFrameHeapAllocations = heapAllocations - _frameStartHeapAllocations;
+		_frameStartHeapAllocations = heapAllocations;
+
+		const uint64 frame = _frame.load(std::memory_order_relaxed) + 1;
+		const size_t slot = frame % kRNFrameAllocatorFrames;
+
+		_chunkPeak = std::max(_chunkPeak, _frameChunkCounts[slot]);
+
+		if((frame % kFrameAllocatorTrimInterval) == 0)
+		{
+			_chunkKeepCount = _chunkPeak;
+			_chunkPeak = 0;
+		}
+
+		const size_t keepCount = std::max(_chunkKeepCount, _chunkPeak);
+
+		// Dedicated chunks that are still in the free list went unused for a frame
+		ReleaseChunks(_freeLargeChunks);
+		_freeLargeChunks = nullptr;
+
+		__FrameAllocatorChunk *chunk = _frameChunks[slot];
+
+		while(chunk)
+		{
+			__FrameAllocatorChunk *next = chunk->next;
+
+			if(chunk->size > kFrameAllocatorChunkDataSize)
+			{
+				chunk->next = _freeLargeChunks;
+				_freeLargeChunks = chunk;
+			}
+			else if(_freeChunkCount < keepCount)
+			{
+				chunk->next = _freeChunks;
+				_freeChunks = chunk;
+				_freeChunkCount ++;
+			}
+			else
+			{
+				chunk->next = nullptr;
+				ReleaseChunks(chunk);
+			}
+
+			chunk = next;
+		}
+
+		_frameChunks[slot] = nullptr;
+		_frameChunkCounts[slot] = 0;
+		_frameBytes[slot] = 0;
+
+		// Threads notice the new frame on their next allocation and pick up a fresh chunk
+		_frame.store(frame, std::memory_order_release);
+	}
+
+	void FrameAllocator::ReleaseChunks(__FrameAllocatorChunk *chunk)
+	{
+		while(chunk)
+		{
+			__FrameAllocatorChunk *next = chunk->next;
+
+			_chunkCount --;
+			_reservedBytes -= sizeof(__FrameAllocatorChunk) + chunk->size;
+
+			Memory::FreeAligned(chunk);
+			chunk = next;
+		}
+	}
+
+	FrameAllocator::Statistics FrameAllocator::GetStatistics() const
+	{
+		LockGuard<Lockable> lock(_lock);
+
+		const uint64 frame = _frame.load(std::memory_order_relaxed);
+
+		Statistics statistics;
+		statistics.chunkAllocations = _chunkAllocations;
+		statistics.chunkCount = _chunkCount;
+		statistics.reservedBytes = _reservedBytes;
+		statistics.lastFrameBytes = (frame > 0) ? _frameBytes[(frame - 1) % kRNFrameAllocatorFrames] : 0;
+		statistics.lastFrameHeapAllocations = _lastFrameHeapAllocations;
+
+		return statistics;
+	}
+}
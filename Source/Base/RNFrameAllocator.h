@@ -0,0 +1,122 @@
+//
+//  RNFrameAllocator.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_FRAMEALLOCATOR_H_
+#define __RAYNE_FRAMEALLOCATOR_H_
+
+#include "RNBase.h"
+#include "../Threads/RNLockable.h"
+#include <vector>
+
+#define kRNFrameAllocatorFrames 3 // Memory handed out in a frame stays valid until that many new frames have begun
+#define kRNFrameAllocatorChunkSize (64 * 1024)
+
+namespace RN
+{
+	struct __FrameAllocatorChunk;
+
+	// Linear allocator for data that only lives for the current frame. Every thread bumps through a chunk of its own, so
+	// allocating doesn't need any synchronization, and nothing is ever freed individually. Instead all chunks used in a
+	// frame are recycled at once, kRNFrameAllocatorFrames frames later, which leaves enough time for the renderer to consume
+	// whatever was submitted. Once the chunk pool has warmed up, a frame doesn't touch the heap at all.
+	class FrameAllocator
+	{
+	public:
+		struct Statistics
+		{
+			size_t chunkAllocations; // Chunks that had to be allocated since the allocator was created, stays flat once warmed up
+			size_t chunkCount;
+			size_t reservedBytes;
+			size_t lastFrameBytes; // Size of the chunks the previous frame used
+			size_t lastFrameHeapAllocations; // All heap allocations of the process during the previous frame, needs RN_ENABLE_ALLOCATION_COUNTER
+		};
+
+		RNAPI FrameAllocator();
+		RNAPI ~FrameAllocator();
+
+		// The allocator driven by the Kernel
+		RNAPI static FrameAllocator *GetSharedInstance();
+
+		RNAPI void *Allocate(size_t size, size_t alignment = 16);
+
+		template<class T>
+		T *AllocateArray(size_t count)
+		{
+			return static_cast<T *>(Allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		// Starts a new frame and recycles the memory of the frame that began kRNFrameAllocatorFrames frames ago
+		RNAPI void BeginFrame();
+
+		uint64 GetFrame() const { return _frame.load(std::memory_order_relaxed); }
+		RNAPI Statistics GetStatistics() const;
+
+	private:
+		void *AllocateSlow(size_t size, size_t alignment);
+		__FrameAllocatorChunk *AcquireChunk(size_t size);
+		void ReleaseChunks(__FrameAllocatorChunk *chunk);
+
+		uint64 _id;
+		std::atomic<uint64> _frame;
+
+		mutable Lockable _lock;
+		__FrameAllocatorChunk *_frameChunks[kRNFrameAllocatorFrames];
+		__FrameAllocatorChunk *_freeChunks;
+		__FrameAllocatorChunk *_freeLargeChunks;
+		size_t _freeChunkCount;
+		size_t _chunkPeak;
+		size_t _chunkKeepCount;
+
+		size_t _chunkAllocations;
+		size_t _chunkCount;
+		size_t _reservedBytes;
+		size_t _frameChunkCounts[kRNFrameAllocatorFrames];
+		size_t _frameBytes[kRNFrameAllocatorFrames];
+
+		size_t _frameStartHeapAllocations;
+		size_t _lastFrameHeapAllocations;
+	};
+
+	// STL allocator that places containers in the frame allocator. Deallocating is a no-op, so only use it for
+	// containers that don't outlive the frame they were created in
+	template<class T>
+	class FrameAllocatorAdapter
+	{
+	public:
+		typedef T value_type;
+
+		FrameAllocatorAdapter() RN_NOEXCEPT :
+			_allocator(FrameAllocator::GetSharedInstance())
+		{}
+		FrameAllocatorAdapter(FrameAllocator *allocator) RN_NOEXCEPT :
+			_allocator(allocator)
+		{}
+		template<class U>
+		FrameAllocatorAdapter(const FrameAllocatorAdapter<U> &other) RN_NOEXCEPT :
+			_allocator(other.GetAllocator())
+		{}
+
+		T *allocate(size_t count) { return _allocator->AllocateArray<T>(count); }
+		void deallocate(T *ptr, size_t count) RN_NOEXCEPT {}
+
+		FrameAllocator *GetAllocator() const { return _allocator; }
+
+		template<class U>
+		bool operator ==(const FrameAllocatorAdapter<U> &other) const { return _allocator == other.GetAllocator(); }
+		template<class U>
+		bool operator !=(const FrameAllocatorAdapter<U> &other) const { return _allocator != other.GetAllocator(); }
+
+	private:
+		FrameAllocator *_allocator;
+	};
+
+	template<class T>
+	using FrameVector = std::vector<T, FrameAllocatorAdapter<T>>;
+}
+
+#endif /* __RAYNE_FRAMEALLOCATOR_H_ */
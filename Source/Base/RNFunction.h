@@ -11,62 +11,145 @@
 
 #include "RNBase.h"
 #include "RNMemoryPool.h"
+#include <cstddef>
+
+// Size of the inline storage of a Function, including the vtable pointer. Callables that fit are stored without allocating
+#ifndef kRNFunctionInlineSize
+	#define kRNFunctionInlineSize (sizeof(void *) * 6)
+#endif
 
 namespace RN
 {
-	RNAPI MemoryPool *__GetFunctionPool();
-
 	class Function
 	{
 	public:
-		Function() = default;
-		
-		template<typename F>
-		Function(F &&f) :
-			_implementation(new ImplementationType<F>(std::move(f)))
+		Function() :
+			_implementation(nullptr)
 		{}
-		
+
+		template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, Function>::value>::type>
+		Function(F &&f)
+		{
+			typedef ImplementationType<typename std::decay<F>::type> Type;
+
+			if constexpr(IsStoredInline<Type>())
+				_implementation = new(&_storage) Type(std::forward<F>(f));
+			else
+				_implementation = new(MemoryPool::GetSharedPool()->Allocate(sizeof(Type))) Type(std::forward<F>(f));
+		}
+
 		Function(Function &&other) RN_NOEXCEPT :
-			_implementation(std::move(other._implementation))
-		{}
-		
+			_implementation(nullptr)
+		{
+			MoveFrom(other);
+		}
+
+		~Function()
+		{
+			Reset();
+		}
+
 		Function &operator=(Function &&other) RN_NOEXCEPT
 		{
-			_implementation = std::move(other._implementation);
+			if(this != &other)
+			{
+				Reset();
+				MoveFrom(other);
+			}
+
 			return *this;
 		}
-		
+
 		Function(const Function&) = delete;
 		Function &operator= (const Function&) = delete;
-		
+
 		void operator() () { _implementation->Call(); }
-		
+
 	private:
 		struct Base
 		{
 			virtual void Call() = 0;
-			virtual ~Base() {}
+			virtual Base *MoveTo(void *storage) = 0;
+			virtual void Destroy() = 0;
+		protected:
+			~Base() {}
 		};
-		
+
 		template<typename F>
 		struct ImplementationType : Base
 		{
-			ImplementationType(F &&f) :
-				function(std::move(f))
+			template<typename T>
+			ImplementationType(T &&f) :
+				function(std::forward<T>(f))
 			{}
-			
-			void Call()
+
+			void Call() final
 			{
 				function();
 			}
 
-			RN_INLINE void *operator new(size_t size) { return __GetFunctionPool()->Allocate(size); }
-			RN_INLINE void operator delete(void *ptr) { if(ptr) __GetFunctionPool()->Free(ptr); }
+			Base *MoveTo(void *storage) final
+			{
+				// Only inline callables are moved, the others are handed over by pointer
+				if constexpr(IsStoredInline<ImplementationType>())
+				{
+					Base *result = new(storage) ImplementationType(std::move(function));
+					this->~ImplementationType();
+
+					return result;
+				}
+				else
+				{
+					return this;
+				}
+			}
+
+			void Destroy() final
+			{
+				this->~ImplementationType();
+
+				if constexpr(!IsStoredInline<ImplementationType>())
+					MemoryPool::GetSharedPool()->Free(this);
+			}
 
 			F function;
 		};
 
-		std::unique_ptr<Base> _implementation;
+		typedef typename std::aligned_storage<kRNFunctionInlineSize, alignof(std::max_align_t)>::type Storage;
+
+		template<typename Type>
+		static constexpr bool IsStoredInline()
+		{
+			// Moving a Function moves inline callables, so they have to be nothrow movable
+			return (sizeof(Type) <= sizeof(Storage) && alignof(Type) <= alignof(Storage) && std::is_nothrow_move_constructible<Type>::value);
+		}
+
+		bool IsInline() const { return (_implementation == reinterpret_cast<const Base *>(&_storage)); }
+
+		void MoveFrom(Function &other)
+		{
+			if(!other._implementation)
+				return;
+
+			if(other.IsInline())
+				_implementation = other._implementation->MoveTo(&_storage);
+			else
+				_implementation = other._implementation;
+
+			other._implementation = nullptr;
+		}
+
+		void Reset()
+		{
+			if(_implementation)
+			{
+				_implementation->Destroy();
+				_implementation = nullptr;
+			}
+		}
+
+		Base *_implementation;
+		Storage _storage;
 	};
 
 	template<class Functor>
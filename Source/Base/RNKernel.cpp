@@ -13,6 +13,7 @@
 #include "../Objects/RNJSONSerialization.h"
 #include "../Rendering/RNRendererDescriptor.h"
 #include "../Debug/RNLoggingEngine.h"
+#include "../Debug/RNProfiler.h"
 
 namespace RN
 {
@@ -37,6 +38,7 @@ namespace RN
 	Kernel::Kernel(Application *application, const ArgumentParser &arguments) :
 		_arguments(arguments),
 		_application(application),
+		_profilerOutput(nullptr),
 		_exit(false),
 		_isActive(true),
 		_wantsToExit(false)
@@ -67,6 +69,13 @@ namespace RN
 											std::bind(&Kernel::HandleObserver, this, std::placeholders::_1,
 													  std::placeholders::_2));
 			_mainThread = new Thread();
+			Profiler::GetSharedInstance()->SetThreadName("Main");
+
+			if(_arguments.HasArgumentAndValue("profile", '\0'))
+			{
+				_profilerOutput = _arguments.ParseArgument("profile", '\0').GetValue()->Retain();
+				Profiler::GetSharedInstance()->SetEnabled(true);
+			}
 			
 			RN_UNUSED ScopeAllocator rootAllocator(BumpAllocator::GetThreadAllocator());
 
@@ -104,6 +113,7 @@ namespace RN
 			__ExtensionPointBase::InitializeExtensionPoints();
 			_firstFrame = true;
 			_frames = 0;
+			_frameAllocator = FrameAllocator::GetSharedInstance();
 
 			_delta = 0;
 			_time = 0;
@@ -238,6 +248,14 @@ namespace RN
 		Screen::TeardownScreens();
 		WorkQueue::TearDownQueues();
 
+		if(_profilerOutput)
+		{
+			if(!Profiler::GetSharedInstance()->WriteChromeTrace(_profilerOutput))
+				RNError("Failed to write profiler trace to " << _profilerOutput);
+
+			_profilerOutput->Release();
+		}
+
 #if RN_PLATFORM_LINUX
 		if(_connection) xcb_disconnect(_connection);
 #endif
@@ -342,6 +360,9 @@ namespace RN
 #endif
 
 		AutoreleasePool pool;
+		RN_PROFILE_FRAME();
+
+		_frameAllocator->BeginFrame();
 
 		Clock::time_point now = Clock::now();
 
@@ -371,6 +392,8 @@ namespace RN
 
 		// Perform work submitted to the main queue
 		{
+			RN_PROFILE_ZONE("Main queue");
+
 			volatile bool finishWork;
 			_mainQueue->Perform([&]{
 				finishWork = true;
@@ -383,21 +406,34 @@ namespace RN
 			} while(!finishWork);
 		}
 
-		START_TASK(__inputTask);
-		// System event handling
-		HandleSystemEvents();
+		{
+			RN_PROFILE_ZONE("Input");
 
-		// Update input and then run scene updates
-		if(_isActive)
-			_inputManager->Update(static_cast<float>(_delta));
-		END_TASK();
+			START_TASK(__inputTask);
+			// System event handling
+			HandleSystemEvents();
+
+			// Update input and then run scene updates
+			if(_isActive)
+				_inputManager->Update(static_cast<float>(_delta));
+			END_TASK();
+		}
+
+		{
+			RN_PROFILE_ZONE("Update");
 
-		START_TASK(__updateTask);
-		_sceneManager->Update(static_cast<float>(_delta));
-		END_TASK();
+			START_TASK(__updateTask);
+			_sceneManager->Update(static_cast<float>(_delta));
+			END_TASK();
+
+			// Observers of coalescing properties see the net change of the whole update
+			ObservableProperty::FlushCoalescedChanges();
+		}
 
 		if(_renderer)
 		{
+			RN_PROFILE_ZONE("Render");
+
 			_renderer->Render([&] {
 
 				START_TASK(__renderingTask);
@@ -420,6 +456,8 @@ namespace RN
 			
 			if(_minDelta > delta)
 			{
+				RN_PROFILE_ZONE("FPS cap");
+
 				uint32 sleepTime = static_cast<uint32>((_minDelta - delta) * 1000000);
 				if(sleepTime > 1000)
 					std::this_thread::sleep_for(std::chrono::microseconds(sleepTime));
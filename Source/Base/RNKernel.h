@@ -13,6 +13,7 @@
 #include "RNApplication.h"
 #include "RNSettings.h"
 #include "RNArgumentParser.h"
+#include "RNFrameAllocator.h"
 #include "RNNotificationManager.h"
 #include "../Debug/RNLogger.h"
 #include "../Objects/RNDictionary.h"
@@ -29,6 +30,7 @@
 
 #define kRNManifestApplicationKey RNCSTR("RNApplication")
 #define kRNManifestSearchPathsKey RNCSTR("RNSearchPaths")
+#define kRNManifestPackFilesKey RNCSTR("RNPackFiles")
 #define kRNManifestPreferredTextureFileExtensionKey RNCSTR("RNPreferredTextureFileExtension")
 
 namespace RN
@@ -54,6 +56,7 @@ namespace RN
 
 		Application *GetApplication() const { return _application; }
 		Settings *GetSettings() const { return _settings; }
+		FrameAllocator *GetFrameAllocator() const { return _frameAllocator; }
 		const ArgumentParser &GetArguments() const { return _arguments; }
 
 		template<class T>
@@ -123,6 +126,9 @@ namespace RN
 		ModuleManager *_moduleManager;
 		InputManager *_inputManager;
 		NotificationManager *_notificationManager;
+		FrameAllocator *_frameAllocator;
+
+		String *_profilerOutput;
 
 		Thread *_mainThread;
 		RunLoop *_runLoop;
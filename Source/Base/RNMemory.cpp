@@ -13,8 +13,31 @@ namespace RN
 {
 	namespace Memory
 	{
+#if RN_ENABLE_ALLOCATION_COUNTER
+		static std::atomic<size_t> __allocationCount(0);
+
+		static RN_INLINE void CountAllocation()
+		{
+			__allocationCount.fetch_add(1, std::memory_order_relaxed);
+		}
+#else
+		static RN_INLINE void CountAllocation()
+		{}
+#endif
+
+		size_t GetAllocationCount()
+		{
+#if RN_ENABLE_ALLOCATION_COUNTER
+			return __allocationCount.load(std::memory_order_relaxed);
+#else
+			return 0;
+#endif
+		}
+
 		void *AllocateAligned(size_t size, size_t alignment)
 		{
+			CountAllocation();
+
 #if RN_PLATFORM_POSIX
 			if(alignment < sizeof(void *))
 				alignment = sizeof(void *);
@@ -40,18 +63,22 @@ namespace RN
 		
 		void *Allocate(size_t size)
 		{
+			CountAllocation();
 			return malloc(size);
 		}
 		void *AllocateArray(size_t size)
 		{
+			CountAllocation();
 			return malloc(size);
 		}
 		void *Allocate(size_t size, const std::nothrow_t &n) RN_NOEXCEPT
 		{
+			CountAllocation();
 			return malloc(size);
 		}
 		void *AllocateArray(size_t size, const std::nothrow_t &n) RN_NOEXCEPT
 		{
+			CountAllocation();
 			return malloc(size);
 		}
 		
@@ -239,23 +266,42 @@ namespace RN
 	};
 }
 
-//Overwrite new and delete here to use custom memory allocator for everything, but default ones are pretty good already.
-/*
+#if RN_ENABLE_ALLOCATION_COUNTER
 void *operator new(size_t size)
 {
-	return RN::Memory::Allocate(size);
+	void *ptr = RN::Memory::Allocate(size ? size : 1);
+	if(!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
 }
 void *operator new[](size_t size)
 {
-	return RN::Memory::AllocateArray(size);
+	void *ptr = RN::Memory::AllocateArray(size ? size : 1);
+	if(!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
 }
 void *operator new(size_t size, const std::nothrow_t &n) RN_NOEXCEPT
 {
-	return RN::Memory::Allocate(size, n);
+	return RN::Memory::Allocate(size ? size : 1, n);
 }
 void *operator new[](size_t size, const std::nothrow_t &n) RN_NOEXCEPT
 {
-	return RN::Memory::AllocateArray(size, n);
+	return RN::Memory::AllocateArray(size ? size : 1, n);
+}
+void *operator new(size_t size, std::align_val_t alignment)
+{
+	void *ptr = RN::Memory::AllocateAligned(size ? size : 1, static_cast<size_t>(alignment));
+	if(!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
 }
 
 
@@ -275,4 +321,28 @@ void operator delete[](void *ptr, const std::nothrow_t &n) RN_NOEXCEPT
 {
 	return RN::Memory::FreeArray(ptr, n);
 }
-*/
+void operator delete(void *ptr, size_t size) RN_NOEXCEPT
+{
+	return RN::Memory::Free(ptr);
+}
+void operator delete[](void *ptr, size_t size) RN_NOEXCEPT
+{
+	return RN::Memory::FreeArray(ptr);
+}
+void operator delete(void *ptr, std::align_val_t alignment) RN_NOEXCEPT
+{
+	return RN::Memory::FreeAligned(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t alignment) RN_NOEXCEPT
+{
+	return RN::Memory::FreeAligned(ptr);
+}
+void operator delete(void *ptr, size_t size, std::align_val_t alignment) RN_NOEXCEPT
+{
+	return RN::Memory::FreeAligned(ptr);
+}
+void operator delete[](void *ptr, size_t size, std::align_val_t alignment) RN_NOEXCEPT
+{
+	return RN::Memory::FreeAligned(ptr);
+}
+#endif
@@ -33,6 +33,10 @@ namespace RN
 		RNAPI void Free(void *ptr, const std::nothrow_t &n) RN_NOEXCEPT;
 		RNAPI void FreeArray(void *ptr, const std::nothrow_t &n) RN_NOEXCEPT;
 		
+		// Number of heap allocations made so far, including everything that goes through operator new.
+		// Only counted with RN_ENABLE_ALLOCATION_COUNTER, always 0 otherwise
+		RNAPI size_t GetAllocationCount();
+		
 		class PoolAllocator;
 		class Pool
 		{
@@ -51,17 +55,7 @@ namespace RN
 	};
 }
 
-//Overwrite new and delete here to use custom memory allocator for everything, but default ones are pretty good already.
-/*
-void *operator new(size_t size);
-void *operator new[](size_t size);
-void *operator new(size_t size, const std::nothrow_t &n) RN_NOEXCEPT;
-void *operator new[](size_t size, const std::nothrow_t &n) RN_NOEXCEPT;
-
-void operator delete(void *ptr) RN_NOEXCEPT;
-void operator delete[](void *ptr) RN_NOEXCEPT;
-void operator delete(void *ptr, const std::nothrow_t &n) RN_NOEXCEPT;
-void operator delete[](void *ptr, const std::nothrow_t &n) RN_NOEXCEPT;
-*/
+// With RN_ENABLE_ALLOCATION_COUNTER, new and delete are overwritten to go through RN::Memory, so every allocation is counted.
+// Otherwise the default ones are used, they are pretty good already.
 
 #endif /* __RAYNE_MEMORY_H__ */
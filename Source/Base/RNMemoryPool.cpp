@@ -7,149 +7,683 @@
 //
 
 #include "RNMemoryPool.h"
+#include "RNBase.h"
 #include "../Math/RNAlgorithm.h"
 
 namespace RN
 {
 	/**
-	 * Each MemoryPool has a collection of  SizePool objects, one for each power of two
-	 * in the range of [8, 512] (8, 16, 32, 64, 128, 256, 512). Each SizePool then further contains
-	 * a list of Node objects which contain 128 slots each. A Node keeps track of allocations using a bitmap
-	 * of all free memory regions.
+	 * Every thread gets its own cache per pool, which owns a list of slabs for each size class.
+	 * The first slab in the available list is the one the thread allocates from, slabs that run out of
+	 * blocks are marked as full and unlinked. Freeing a block of a full slab relinks it: locally directly,
+	 * remotely by pushing the slab onto the reclaimed list of its cache, whichever side clears the full bit first.
+	 * Caches of exited threads stay with the pool, so late frees always find their slab, and are adopted by new threads.
+	 *
+	 * Slabs are aligned to their size, so the slab of any block is found by masking its address.
 	 **/
 
-	MemoryPool::MemoryPool()
+	static const size_t __sizeClasses[kRNMemoryPoolSizeClasses] = {
+		16, 32, 48, 64, 80, 96, 112, 128,
+		160, 192, 224, 256,
+		320, 384, 448, 512,
+		640, 768, 896, 1024
+	};
+
+	#define kRNMemoryPoolLargeClass kRNMemoryPoolSizeClasses
+	#define kRNMemoryPoolSlabHeaderSize 128
+	#define kRNMemoryPoolSlabFull static_cast<uintptr_t>(1)
+
+	struct __MemoryPoolBlock
+	{
+		__MemoryPoolBlock *next;
+	};
+
+	struct __MemoryPoolSlab
+	{
+		__MemoryPoolThreadCache *owner;
+		size_t sizeClass;
+		size_t blockSize;
+		size_t used;
+
+		uint8 *bump;
+		uint8 *end;
+		__MemoryPoolBlock *freeList;
+
+		// Intrusive lists of the owning cache, all slabs of the size class and the slabs with free blocks
+		__MemoryPoolSlab *previous;
+		__MemoryPoolSlab *next;
+		__MemoryPoolSlab *previousAvailable;
+		__MemoryPoolSlab *nextAvailable;
+		__MemoryPoolSlab *nextReclaimed;
+
+		bool available;
+
+		// Blocks freed by other threads, the lowest bit marks a slab that its owner found full
+		std::atomic<uintptr_t> remoteFrees;
+	};
+
+	static_assert(sizeof(__MemoryPoolSlab) <= kRNMemoryPoolSlabHeaderSize, "Slab header doesn't fit");
+
+	struct __MemoryPoolThreadCache
 	{
-		// Create the size pools
-		_pools.emplace_back(8);
-		_pools.emplace_back(16);
-		_pools.emplace_back(32);
-		_pools.emplace_back(64);
-		_pools.emplace_back(128);
-		_pools.emplace_back(256);
-		_pools.emplace_back(512);
+		__MemoryPoolThreadCache(MemoryPool *tpool) :
+			pool(tpool),
+			inUse(false),
+			reclaimed(nullptr)
+		{
+			for(size_t i = 0; i < kRNMemoryPoolSizeClasses; i ++)
+			{
+				slabs[i] = nullptr;
+				available[i] = nullptr;
+
+				allocations[i].store(0, std::memory_order_relaxed);
+				frees[i].store(0, std::memory_order_relaxed);
+				hits[i].store(0, std::memory_order_relaxed);
+				misses[i].store(0, std::memory_order_relaxed);
+				slabCount[i].store(0, std::memory_order_relaxed);
+			}
+		}
+
+		MemoryPool *pool;
+		bool inUse;
+
+		__MemoryPoolSlab *slabs[kRNMemoryPoolSizeClasses];
+		__MemoryPoolSlab *available[kRNMemoryPoolSizeClasses];
+
+		std::atomic<__MemoryPoolSlab *> reclaimed;
+
+		// Only written by the owning thread
+		std::atomic<size_t> allocations[kRNMemoryPoolSizeClasses];
+		std::atomic<size_t> frees[kRNMemoryPoolSizeClasses];
+		std::atomic<size_t> hits[kRNMemoryPoolSizeClasses];
+		std::atomic<size_t> misses[kRNMemoryPoolSizeClasses];
+		std::atomic<size_t> slabCount[kRNMemoryPoolSizeClasses];
+	};
+
+	static RN_INLINE void __Increment(std::atomic<size_t> &counter, size_t value = 1)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
 	}
 
-	void *MemoryPool::Allocate(size_t size)
+	static RN_INLINE size_t __GetSizeClass(size_t size)
+	{
+		if(size <= 128)
+			return (size > 0) ? (size - 1) / 16 : 0;
+		if(size <= 256)
+			return 8 + (size - 129) / 32;
+		if(size <= 512)
+			return 12 + (size - 257) / 64;
+
+		return 16 + (size - 513) / 128;
+	}
+
+
+	// Pools are looked up by id, so threads never touch the caches of a pool that has been destroyed
+	struct __MemoryPoolRegistry
+	{
+		Lockable lock;
+		std::vector<MemoryPool *> pools;
+		std::atomic<uint64> nextID;
+	};
+
+	static __MemoryPoolRegistry &__GetRegistry()
 	{
-		size = NextPowerOfTwo(static_cast<uint64>(size + sizeof(void *)));
-		size = std::max(size, static_cast<size_t>(8));
+		static __MemoryPoolRegistry *registry = new __MemoryPoolRegistry();
+		return *registry;
+	}
+
+	struct __MemoryPoolThreadEntry
+	{
+		uint64 id;
+		MemoryPool *pool;
+		__MemoryPoolThreadCache *cache;
+	};
+
+	// The entries are trivial, so accessing them doesn't go through the lazy initialization of thread locals.
+	// The state only exists to release the caches when the thread exits
+	static thread_local __MemoryPoolThreadEntry __threadEntries[kRNMemoryPoolThreadCacheSlots];
+	static thread_local bool __threadExited;
 
-		RN_ASSERT(size <= 512, "MemoryPool serves a maximum of 512 bytes!");
+	struct __MemoryPoolThreadState
+	{
+		__MemoryPoolThreadState() :
+			registered(false)
+		{}
 
-		for(SizePool &pool : _pools)
+		~__MemoryPoolThreadState()
 		{
-			if(pool.GetSize() == size)
-				return pool.Allocate();
+			for(__MemoryPoolThreadEntry &entry : __threadEntries)
+				Release(entry);
+
+			__threadExited = true;
 		}
 
-		abort(); // WTF?!
+		static void Release(__MemoryPoolThreadEntry &entry)
+		{
+			if(entry.id == 0)
+				return;
+
+			__MemoryPoolRegistry &registry = __GetRegistry();
+			LockGuard<Lockable> lock(registry.lock);
+
+			auto iterator = std::find(registry.pools.begin(), registry.pools.end(), entry.pool);
+			if(iterator != registry.pools.end() && (*iterator)->_id == entry.id)
+				entry.pool->ReleaseThreadCache(entry.cache);
+
+			entry.id = 0;
+			entry.pool = nullptr;
+			entry.cache = nullptr;
+		}
+
+		bool registered;
+	};
+
+	static thread_local __MemoryPoolThreadState __threadState;
+
+
+	MemoryPool::MemoryPool() :
+		_sharedCache(new __MemoryPoolThreadCache(this)),
+		_largeAllocations(0),
+		_largeBytes(0),
+		_largeTotal(0)
+	{
+		__MemoryPoolRegistry &registry = __GetRegistry();
+		LockGuard<Lockable> lock(registry.lock);
+
+		_id = registry.nextID.fetch_add(1, std::memory_order_relaxed) + 1;
+		registry.pools.push_back(this);
+
+		_sharedCache->inUse = true;
 	}
 
-	void MemoryPool::Free(void *ptr)
+	MemoryPool::~MemoryPool()
 	{
-		uintptr_t *value = reinterpret_cast<uintptr_t *>(ptr) - 1;
-		Node *node = reinterpret_cast<Node *>(*value);
+		{
+			__MemoryPoolRegistry &registry = __GetRegistry();
+			LockGuard<Lockable> lock(registry.lock);
+
+			registry.pools.erase(std::find(registry.pools.begin(), registry.pools.end(), this));
+		}
+
+		_caches.push_back(_sharedCache);
 
-		SizePool *pool = node->GetOwner();
-		pool->Free(node, value);
+		for(__MemoryPoolThreadCache *cache : _caches)
+		{
+			for(size_t i = 0; i < kRNMemoryPoolSizeClasses; i ++)
+			{
+				while(cache->slabs[i])
+					DestroySlab(cache, cache->slabs[i]);
+			}
+
+			delete cache;
+		}
 	}
 
+	MemoryPool *MemoryPool::GetSharedPool()
+	{
+		static MemoryPool *pool = new MemoryPool();
+		return pool;
+	}
 
-	MemoryPool::SizePool::SizePool(size_t size) :
-		_size(size)
-	{}
 
-	size_t MemoryPool::SizePool::GetSize() const
+	__MemoryPoolThreadCache *MemoryPool::GetThreadCache()
 	{
-		return _size;
+		__MemoryPoolThreadEntry &entry = __threadEntries[_id % kRNMemoryPoolThreadCacheSlots];
+
+		if(RN_EXPECT_TRUE(entry.id == _id))
+			return entry.cache;
+
+		return AcquireThreadCache();
 	}
 
-	void *MemoryPool::SizePool::Allocate()
+	__MemoryPoolThreadCache *MemoryPool::AcquireThreadCache()
 	{
-		for(Node &node : _nodes)
+		if(__threadExited)
+			return nullptr;
+
+		__threadState.registered = true;
+
+		__MemoryPoolThreadEntry &entry = __threadEntries[_id % kRNMemoryPoolThreadCacheSlots];
+		__MemoryPoolThreadState::Release(entry);
+
+		__MemoryPoolThreadCache *cache = nullptr;
+
 		{
-			if(node.TryLock())
+			LockGuard<Lockable> lock(_lock);
+
+			for(__MemoryPoolThreadCache *candidate : _caches)
 			{
-				if(!node.IsFull())
+				if(!candidate->inUse)
 				{
-					uintptr_t *result = reinterpret_cast<uintptr_t *>(node.Allocate());
-					node.Unlock();
-
-					*result = reinterpret_cast<uintptr_t>(&node);
-					return result + 1;
+					cache = candidate;
+					break;
 				}
+			}
 
-				node.Unlock();
+			if(!cache)
+			{
+				cache = new __MemoryPoolThreadCache(this);
+				_caches.push_back(cache);
 			}
+
+			cache->inUse = true;
 		}
 
-		_nodes.emplace_back(_size, this);
-		return Allocate();
+		entry.id = _id;
+		entry.pool = this;
+		entry.cache = cache;
+
+		return cache;
 	}
 
-	void MemoryPool::SizePool::Free(Node *node, void *ptr)
+
+
+	__MemoryPoolSlab *MemoryPool::CreateSlab(__MemoryPoolThreadCache *cache, size_t sizeClass)
 	{
-		size_t slot = reinterpret_cast<size_t>(ptr);
-		slot -= reinterpret_cast<size_t>(node->_data);
-		slot /= _size;
+		uint8 *memory = static_cast<uint8 *>(Memory::AllocateAligned(kRNMemoryPoolSlabSize, kRNMemoryPoolSlabSize));
+		if(RN_EXPECT_FALSE(!memory))
+			throw std::bad_alloc();
+
+		__MemoryPoolSlab *slab = new(memory) __MemoryPoolSlab();
+		slab->owner = cache;
+		slab->sizeClass = sizeClass;
+		slab->blockSize = __sizeClasses[sizeClass];
+		slab->used = 0;
+		slab->bump = memory + kRNMemoryPoolSlabHeaderSize;
+		slab->end = memory + kRNMemoryPoolSlabHeaderSize + ((kRNMemoryPoolSlabSize - kRNMemoryPoolSlabHeaderSize) / slab->blockSize) * slab->blockSize;
+		slab->freeList = nullptr;
+		slab->previousAvailable = nullptr;
+		slab->nextAvailable = nullptr;
+		slab->nextReclaimed = nullptr;
+		slab->available = false;
+		slab->remoteFrees.store(0, std::memory_order_relaxed);
 
-		node->Lock();
-		node->_usage.reset(slot);
-		node->Unlock();
+		slab->previous = nullptr;
+		slab->next = cache->slabs[sizeClass];
+
+		if(slab->next)
+			slab->next->previous = slab;
+
+		cache->slabs[sizeClass] = slab;
+		__Increment(cache->slabCount[sizeClass]);
+
+		return slab;
 	}
 
+	void MemoryPool::DestroySlab(__MemoryPoolThreadCache *cache, __MemoryPoolSlab *slab)
+	{
+		const size_t sizeClass = slab->sizeClass;
+
+		if(slab->previous)
+			slab->previous->next = slab->next;
+		else
+			cache->slabs[sizeClass] = slab->next;
 
+		if(slab->next)
+			slab->next->previous = slab->previous;
 
+		cache->slabCount[sizeClass].store(cache->slabCount[sizeClass].load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
 
-	MemoryPool::Node::Node(size_t size, SizePool *pool) :
-		_owner(pool),
-		_data(new uint8[size * 128]),
-		_size(size)
-	{}
+		slab->~__MemoryPoolSlab();
+		Memory::FreeAligned(slab);
+	}
 
-	MemoryPool::Node::~Node()
+
+	static RN_INLINE void __LinkAvailable(__MemoryPoolSlab **list, __MemoryPoolSlab *slab, bool front)
 	{
-		delete[] _data;
+		slab->available = true;
+
+		if(front || !*list)
+		{
+			slab->previousAvailable = nullptr;
+			slab->nextAvailable = *list;
+
+			if(*list)
+				(*list)->previousAvailable = slab;
+
+			*list = slab;
+		}
+		else
+		{
+			// Keep the slab that is being allocated from in front
+			__MemoryPoolSlab *head = *list;
+
+			slab->previousAvailable = head;
+			slab->nextAvailable = head->nextAvailable;
+
+			if(head->nextAvailable)
+				head->nextAvailable->previousAvailable = slab;
+
+			head->nextAvailable = slab;
+		}
 	}
 
+	static RN_INLINE void __UnlinkAvailable(__MemoryPoolSlab **list, __MemoryPoolSlab *slab)
+	{
+		if(slab->previousAvailable)
+			slab->previousAvailable->nextAvailable = slab->nextAvailable;
+		else
+			*list = slab->nextAvailable;
+
+		if(slab->nextAvailable)
+			slab->nextAvailable->previousAvailable = slab->previousAvailable;
 
-	bool MemoryPool::Node::IsFull() const
+		slab->previousAvailable = nullptr;
+		slab->nextAvailable = nullptr;
+		slab->available = false;
+	}
+
+	// Moves the blocks freed by other threads into the local free list, returns the number of blocks
+	static size_t __CollectRemoteFrees(__MemoryPoolSlab *slab)
 	{
-		return (_usage.all());
+		if(slab->remoteFrees.load(std::memory_order_relaxed) == 0)
+			return 0;
+
+		__MemoryPoolBlock *head = reinterpret_cast<__MemoryPoolBlock *>(slab->remoteFrees.exchange(0, std::memory_order_acquire));
+		if(!head)
+			return 0;
+
+		__MemoryPoolBlock *tail = head;
+		size_t count = 1;
+
+		while(tail->next)
+		{
+			tail = tail->next;
+			count ++;
+		}
+
+		tail->next = slab->freeList;
+		slab->freeList = head;
+		slab->used -= count;
+
+		return count;
 	}
 
-	bool MemoryPool::Node::TryLock()
+	// Picks up slabs that have been freed into while they were full
+	static void __ReclaimSlabs(__MemoryPoolThreadCache *cache)
 	{
-		return _lock.TryLock();
+		__MemoryPoolSlab *reclaimed = cache->reclaimed.exchange(nullptr, std::memory_order_acquire);
+
+		while(reclaimed)
+		{
+			__MemoryPoolSlab *next = reclaimed->nextReclaimed;
+			__LinkAvailable(&cache->available[reclaimed->sizeClass], reclaimed, false);
+
+			reclaimed = next;
+		}
 	}
 
-	void MemoryPool::Node::Lock()
+	static RN_INLINE void *__PopBlock(__MemoryPoolSlab *slab)
 	{
-		_lock.Lock();
+		if(slab->freeList)
+		{
+			__MemoryPoolBlock *block = slab->freeList;
+			slab->freeList = block->next;
+			slab->used ++;
+
+			return block;
+		}
+
+		if(slab->bump < slab->end)
+		{
+			void *block = slab->bump;
+			slab->bump += slab->blockSize;
+			slab->used ++;
+
+			return block;
+		}
+
+		return nullptr;
 	}
 
-	void MemoryPool::Node::Unlock()
+
+	void MemoryPool::TrimThreadCache(__MemoryPoolThreadCache *cache)
 	{
-		_lock.Unlock();
+		__ReclaimSlabs(cache);
+
+		for(size_t i = 0; i < kRNMemoryPoolSizeClasses; i ++)
+		{
+			__MemoryPoolSlab *slab = cache->available[i];
+
+			while(slab)
+			{
+				__MemoryPoolSlab *next = slab->nextAvailable;
+				__Increment(cache->frees[i], __CollectRemoteFrees(slab));
+
+				if(slab->used == 0)
+				{
+					__UnlinkAvailable(&cache->available[i], slab);
+					DestroySlab(cache, slab);
+				}
+
+				slab = next;
+			}
+		}
 	}
 
-	MemoryPool::SizePool *MemoryPool::Node::GetOwner() const
+	void MemoryPool::ReleaseThreadCache(__MemoryPoolThreadCache *cache)
 	{
-		return _owner;
+		LockGuard<Lockable> lock(_lock);
+
+		// Idle caches are owned by whoever holds the lock, so this is the chance to give back
+		// the slabs that have been emptied by other threads since their thread exited
+		cache->inUse = false;
+
+		for(__MemoryPoolThreadCache *idle : _caches)
+		{
+			if(!idle->inUse)
+				TrimThreadCache(idle);
+		}
 	}
 
-	void *MemoryPool::Node::Allocate()
+	void *MemoryPool::Allocate(size_t size)
 	{
-		for(size_t i = 0; i < 128; i ++)
+		if(RN_EXPECT_FALSE(size > kRNMemoryPoolMaxBlockSize))
+			return AllocateLarge(size);
+
+		const size_t sizeClass = __GetSizeClass(size);
+		__MemoryPoolThreadCache *cache = GetThreadCache();
+
+		if(RN_EXPECT_FALSE(!cache))
 		{
-			if(!_usage.test(i))
+			LockGuard<Lockable> lock(_lock);
+			return AllocateFromCache(_sharedCache, sizeClass);
+		}
+
+		return AllocateFromCache(cache, sizeClass);
+	}
+
+	void *MemoryPool::AllocateFromCache(__MemoryPoolThreadCache *cache, size_t sizeClass)
+	{
+		__MemoryPoolSlab *slab = cache->available[sizeClass];
+
+		if(RN_EXPECT_TRUE(slab != nullptr))
+		{
+			void *block = __PopBlock(slab);
+			if(RN_EXPECT_TRUE(block != nullptr))
+			{
+				__Increment(cache->allocations[sizeClass]);
+				__Increment(cache->hits[sizeClass]);
+
+				return block;
+			}
+		}
+
+		return AllocateSlow(cache, sizeClass);
+	}
+
+	void *MemoryPool::AllocateSlow(__MemoryPoolThreadCache *cache, size_t sizeClass)
+	{
+		__ReclaimSlabs(cache);
+
+		bool hit = true;
+
+		while(__MemoryPoolSlab *slab = cache->available[sizeClass])
+		{
+			__Increment(cache->frees[sizeClass], __CollectRemoteFrees(slab));
+
+			if(void *block = __PopBlock(slab))
 			{
-				_usage.set(i);
-				return reinterpret_cast<void *>(_data + (i * _size));
+				__Increment(cache->allocations[sizeClass]);
+				__Increment(hit ? cache->hits[sizeClass] : cache->misses[sizeClass]);
+
+				return block;
 			}
+
+			// Only mark the slab as full if no remote free came in since collecting them
+			uintptr_t expected = 0;
+			if(slab->remoteFrees.compare_exchange_strong(expected, kRNMemoryPoolSlabFull, std::memory_order_acq_rel, std::memory_order_relaxed))
+			{
+				__UnlinkAvailable(&cache->available[sizeClass], slab);
+				hit = false;
+			}
+		}
+
+		__MemoryPoolSlab *slab = CreateSlab(cache, sizeClass);
+		__LinkAvailable(&cache->available[sizeClass], slab, true);
+
+		__Increment(cache->allocations[sizeClass]);
+		__Increment(cache->misses[sizeClass]);
+
+		return __PopBlock(slab);
+	}
+
+	void *MemoryPool::AllocateLarge(size_t size)
+	{
+		uint8 *memory = static_cast<uint8 *>(Memory::AllocateAligned(kRNMemoryPoolSlabHeaderSize + size, kRNMemoryPoolSlabSize));
+		if(RN_EXPECT_FALSE(!memory))
+			throw std::bad_alloc();
+
+		__MemoryPoolSlab *slab = new(memory) __MemoryPoolSlab();
+		slab->owner = nullptr;
+		slab->sizeClass = kRNMemoryPoolLargeClass;
+		slab->blockSize = size;
+
+		_largeAllocations.fetch_add(1, std::memory_order_relaxed);
+		_largeBytes.fetch_add(size, std::memory_order_relaxed);
+		_largeTotal.fetch_add(1, std::memory_order_relaxed);
+
+		return memory + kRNMemoryPoolSlabHeaderSize;
+	}
+
+
+	void MemoryPool::Free(void *ptr)
+	{
+		if(!ptr)
+			return;
+
+		__MemoryPoolSlab *slab = reinterpret_cast<__MemoryPoolSlab *>(reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(kRNMemoryPoolSlabSize - 1));
+		__MemoryPoolBlock *block = static_cast<__MemoryPoolBlock *>(ptr);
+
+		if(RN_EXPECT_FALSE(slab->sizeClass == kRNMemoryPoolLargeClass))
+		{
+			_largeAllocations.fetch_sub(1, std::memory_order_relaxed);
+			_largeBytes.fetch_sub(slab->blockSize, std::memory_order_relaxed);
+
+			slab->~__MemoryPoolSlab();
+			Memory::FreeAligned(slab);
+			return;
+		}
+
+		__MemoryPoolThreadCache *owner = slab->owner;
+		RN_ASSERT(owner->pool == this, "Memory must be freed through the pool that allocated it");
+
+		const __MemoryPoolThreadEntry &entry = __threadEntries[_id % kRNMemoryPoolThreadCacheSlots];
+
+		if(RN_EXPECT_TRUE(entry.cache == owner && entry.id == _id))
+			FreeLocal(owner, slab, block);
+		else
+			FreeRemote(slab, block);
+	}
+
+	void MemoryPool::FreeLocal(__MemoryPoolThreadCache *cache, __MemoryPoolSlab *slab, __MemoryPoolBlock *block)
+	{
+		const size_t sizeClass = slab->sizeClass;
+
+		block->next = slab->freeList;
+		slab->freeList = block;
+		slab->used --;
+
+		__Increment(cache->frees[sizeClass]);
+
+		if(RN_EXPECT_FALSE(!slab->available))
+		{
+			// Either full, or a remote free already cleared the flag and queued it up on the reclaimed list
+			uintptr_t expected = kRNMemoryPoolSlabFull;
+			if(slab->remoteFrees.compare_exchange_strong(expected, 0, std::memory_order_acq_rel, std::memory_order_relaxed))
+				__LinkAvailable(&cache->available[sizeClass], slab, false);
+
+			return;
 		}
 
-		abort();
+		// Give empty slabs back, except for the one that is being allocated from. Blocks that are still on the
+		// remote list count as used, so no other thread can touch the slab anymore
+		if(RN_EXPECT_FALSE(slab->used == 0) && cache->available[sizeClass] != slab)
+		{
+			__UnlinkAvailable(&cache->available[sizeClass], slab);
+			DestroySlab(cache, slab);
+		}
+	}
+
+	void MemoryPool::FreeRemote(__MemoryPoolSlab *slab, __MemoryPoolBlock *block)
+	{
+		uintptr_t head = slab->remoteFrees.load(std::memory_order_relaxed);
+
+		do {
+			block->next = reinterpret_cast<__MemoryPoolBlock *>(head & ~kRNMemoryPoolSlabFull);
+		} while(!slab->remoteFrees.compare_exchange_weak(head, reinterpret_cast<uintptr_t>(block), std::memory_order_acq_rel, std::memory_order_relaxed));
+
+		if(head & kRNMemoryPoolSlabFull)
+		{
+			// The slab has been unlinked by its owner, which can't free it until it has been handed back
+			__MemoryPoolThreadCache *cache = slab->owner;
+			__MemoryPoolSlab *reclaimed = cache->reclaimed.load(std::memory_order_relaxed);
+
+			do {
+				slab->nextReclaimed = reclaimed;
+			} while(!cache->reclaimed.compare_exchange_weak(reclaimed, slab, std::memory_order_release, std::memory_order_relaxed));
+		}
+	}
+
+
+	std::vector<MemoryPool::Statistics> MemoryPool::GetStatistics() const
+	{
+		std::vector<Statistics> result(kRNMemoryPoolSizeClasses + 1);
+
+		LockGuard<Lockable> lock(_lock);
+
+		for(size_t i = 0; i < kRNMemoryPoolSizeClasses; i ++)
+		{
+			Statistics &statistics = result[i];
+			statistics.size = __sizeClasses[i];
+
+			size_t allocations = 0;
+			size_t frees = 0;
+
+			auto accumulate = [&](const __MemoryPoolThreadCache *cache) {
+				allocations += cache->allocations[i].load(std::memory_order_relaxed);
+				frees += cache->frees[i].load(std::memory_order_relaxed);
+
+				statistics.hits += cache->hits[i].load(std::memory_order_relaxed);
+				statistics.misses += cache->misses[i].load(std::memory_order_relaxed);
+				statistics.slabCount += cache->slabCount[i].load(std::memory_order_relaxed);
+			};
+
+			for(const __MemoryPoolThreadCache *cache : _caches)
+				accumulate(cache);
+
+			accumulate(_sharedCache);
+
+			statistics.liveAllocations = (allocations > frees) ? allocations - frees : 0;
+			statistics.liveBytes = statistics.liveAllocations * statistics.size;
+		}
+
+		Statistics &large = result[kRNMemoryPoolSizeClasses];
+		large.liveAllocations = _largeAllocations.load(std::memory_order_relaxed);
+		large.liveBytes = _largeBytes.load(std::memory_order_relaxed);
+		large.slabCount = large.liveAllocations;
+		large.misses = _largeTotal.load(std::memory_order_relaxed);
+
+		return result;
 	}
 }
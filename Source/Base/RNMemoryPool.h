@@ -11,78 +11,85 @@
 
 #include "../Threads/RNLockable.h"
 #include <vector>
-#include <list>
-#include <bitset>
+
+#define kRNMemoryPoolSlabSize (16 * 1024) // The page size on Apple silicon, four pages everywhere else
+#define kRNMemoryPoolMaxBlockSize 1024
+#define kRNMemoryPoolSizeClasses 20
+#define kRNMemoryPoolThreadCacheSlots 4
 
 namespace RN
 {
+	struct __MemoryPoolBlock;
+	struct __MemoryPoolSlab;
+	struct __MemoryPoolThreadCache;
+	struct __MemoryPoolThreadState;
+
+	// Thread caching allocator for small objects. Memory is carved out of slabs, which serve a single size class and are owned
+	// by a single thread cache, so the owning thread allocates and frees without any synchronization. Blocks freed on other
+	// threads are pushed onto a lock free list of their slab and are picked up by the owner once it runs out of local blocks.
+	// Allocations bigger than kRNMemoryPoolMaxBlockSize get a slab of their own.
 	class MemoryPool
 	{
 	public:
-		RNAPI MemoryPool();
-
-		RNAPI void *Allocate(size_t size);
-		RNAPI void Free(void *ptr);
-
-	private:
-		class SizePool;
-		class Node
+		struct Statistics
 		{
-		public:
-			friend class SizePool;
-
-			Node(size_t size, SizePool *pool);
-			~Node();
-
-			bool TryLock();
+			size_t size; // Block size of the size class, 0 for allocations bigger than kRNMemoryPoolMaxBlockSize
+			size_t liveBytes;
+			size_t liveAllocations;
+			size_t slabCount;
+			size_t hits; // Allocations served by the slab the thread was already allocating from
+			size_t misses; // Allocations that had to switch to another or a new slab
+
+			double GetHitRate() const { return (hits + misses) > 0 ? static_cast<double>(hits) / (hits + misses) : 1.0; }
+		};
 
-			void Lock();
-			void Unlock();
+		RNAPI MemoryPool();
+		RNAPI ~MemoryPool();
 
-			bool IsFull() const;
-			SizePool *GetOwner() const;
+		RNAPI static MemoryPool *GetSharedPool();
 
-			void *Allocate();
+		RNAPI void *Allocate(size_t size);
+		RNAPI void Free(void *ptr);
 
-		private:
-			SizePool *_owner;
-			std::bitset<128> _usage;
-			Lockable _lock;
-			uint8_t *_data;
-			size_t _size;
-		};
+		// One entry per size class followed by the one for big allocations. Blocks freed on other threads are
+		// only accounted for once their owner picks them up
+		RNAPI std::vector<Statistics> GetStatistics() const;
 
-		class SizePool
-		{
-		public:
-			SizePool(size_t size);
+	private:
+		friend struct __MemoryPoolThreadState;
 
-			SizePool(SizePool &&other) :
-				_size(other._size),
-				_nodes(std::move(other._nodes))
-			{}
+		__MemoryPoolThreadCache *GetThreadCache();
+		__MemoryPoolThreadCache *AcquireThreadCache();
+		void ReleaseThreadCache(__MemoryPoolThreadCache *cache);
+		void TrimThreadCache(__MemoryPoolThreadCache *cache);
 
-			SizePool &operator =(SizePool &&other)
-			{
-				_size = other._size;
-				_nodes = std::move(other._nodes);
+		void *AllocateFromCache(__MemoryPoolThreadCache *cache, size_t sizeClass);
+		void *AllocateSlow(__MemoryPoolThreadCache *cache, size_t sizeClass);
+		void *AllocateLarge(size_t size);
 
-				return *this;
-			}
+		void FreeLocal(__MemoryPoolThreadCache *cache, __MemoryPoolSlab *slab, __MemoryPoolBlock *block);
+		void FreeRemote(__MemoryPoolSlab *slab, __MemoryPoolBlock *block);
 
-			void *Allocate();
-			void Free(Node *node, void *ptr);
+		__MemoryPoolSlab *CreateSlab(__MemoryPoolThreadCache *cache, size_t sizeClass);
+		void DestroySlab(__MemoryPoolThreadCache *cache, __MemoryPoolSlab *slab);
 
-			size_t GetSize() const;
+		uint64 _id;
 
-		private:
-			size_t _size;
-			std::list<Node> _nodes;
-		};
+		mutable Lockable _lock;
+		std::vector<__MemoryPoolThreadCache *> _caches;
+		__MemoryPoolThreadCache *_sharedCache; // Used under the lock by threads that are already exiting
 
-		std::vector<SizePool> _pools;
+		std::atomic<size_t> _largeAllocations;
+		std::atomic<size_t> _largeBytes;
+		std::atomic<size_t> _largeTotal;
 	};
 }
 
+// Routes all allocations of a class and its subclasses through the shared MemoryPool
+#define RNDeclarePooledAllocation() \
+	public: \
+		static void *operator new(size_t size) { return RN::MemoryPool::GetSharedPool()->Allocate(size); } \
+		static void operator delete(void *ptr) { RN::MemoryPool::GetSharedPool()->Free(ptr); } \
+	private:
 
 #endif /* __RAYNE_MEMORYPOOL_H_ */
@@ -84,7 +84,12 @@ namespace RN
 			_tags(0)
 		{}
 		
-		virtual ~Signal(){}
+		virtual ~Signal()
+		{
+			// Slots disconnect their connections when destroyed, which would remove them from _slots while it's being torn down
+			std::vector<Slot> slots;
+			std::swap(slots, _slots);
+		}
 		
 		template <typename... SigCompatible>
 		void Emit(SigCompatible&&... args)
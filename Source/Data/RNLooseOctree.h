@@ -0,0 +1,443 @@
+//
+//  RNLooseOctree.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_LOOSEOCTREE_H__
+#define __RAYNE_LOOSEOCTREE_H__
+
+#include "../Base/RNBase.h"
+#include "../Math/RNVector.h"
+#include "../Math/RNAABB.h"
+
+namespace RN
+{
+	// Octree for values with a position and a radius. Every node's bounds are loosened to twice its size, so a value is stored
+	// in the deepest node whose cell contains its position and whose size is at least its radius, without ever straddling nodes.
+	// Values outside of the root cell are kept in the root. Nodes and values live in flat arrays, nodes are never freed before Clear().
+	template<class T>
+	class LooseOctree
+	{
+	public:
+		typedef uint32 Handle;
+		static constexpr Handle kInvalidHandle = static_cast<Handle>(-1);
+
+		LooseOctree(const Vector3 &center, float halfSize, uint32 maxDepth = 8) :
+			_center(center),
+			_halfSize(halfSize),
+			_maxDepth(maxDepth)
+		{
+			Clear();
+		}
+
+		Handle Insert(const Vector3 &position, float radius, const T &value)
+		{
+			Handle handle = _freeObjects;
+
+			if(handle == kInvalidHandle)
+			{
+				handle = static_cast<Handle>(_objects.size());
+				_objects.emplace_back();
+			}
+			else
+			{
+				_freeObjects = _objects[handle].next;
+			}
+
+			Object &object = _objects[handle];
+			object.position = position;
+			object.radius = radius;
+			object.value = value;
+			object.used = true;
+
+			Link(handle, FindNode(position, radius));
+			_count ++;
+
+			return handle;
+		}
+
+		Handle Insert(const Vector3 &position, const T &value)
+		{
+			return Insert(position, 0.0f, value);
+		}
+
+		void Erase(Handle handle)
+		{
+			RN_ASSERT(handle < _objects.size() && _objects[handle].used, "Erase() must be called with a valid handle");
+
+			Unlink(handle);
+
+			Object &object = _objects[handle];
+			object.value = T();
+			object.used = false;
+			object.next = _freeObjects;
+
+			_freeObjects = handle;
+			_count --;
+		}
+
+		// Erases the first value stored at position
+		bool Erase(const Vector3 &position, const T &value)
+		{
+			// Values at this position can only be in the nodes along the path to it
+			uint32 node = 0;
+
+			while(node != kInvalidNode)
+			{
+				for(Handle handle = _nodes[node].objects; handle != kInvalidHandle; handle = _objects[handle].next)
+				{
+					const Object &object = _objects[handle];
+					if(object.position == position && object.value == value)
+					{
+						Erase(handle);
+						return true;
+					}
+				}
+
+				if(node == 0 && !IsInsideRoot(position))
+					break;
+
+				node = (_nodes[node].children != kInvalidNode) ? _nodes[node].children + GetOctant(_nodes[node], position) : kInvalidNode;
+			}
+
+			return false;
+		}
+
+		void Move(Handle handle, const Vector3 &position, float radius)
+		{
+			const uint32 node = FindNode(position, radius);
+			Object &object = _objects[handle];
+
+			object.position = position;
+			object.radius = radius;
+
+			if(node != object.node)
+			{
+				Unlink(handle);
+				Link(handle, node);
+			}
+		}
+
+		void Move(Handle handle, const Vector3 &position)
+		{
+			Move(handle, position, _objects[handle].radius);
+		}
+
+		const T &Get(Handle handle) const { return _objects[handle].value; }
+		const Vector3 &GetPosition(Handle handle) const { return _objects[handle].position; }
+		float GetRadius(Handle handle) const { return _objects[handle].radius; }
+
+		// All queries append to the result. Box and radius queries return values whose sphere touches the query volume
+		void Query(const AABB &aabb, std::vector<T> &result) const
+		{
+			const Vector3 min = aabb.position + aabb.minExtend;
+			const Vector3 max = aabb.position + aabb.maxExtend;
+
+			ForEachNode([&](const Node &node) {
+				return GetSquaredDistance(node.center - Vector3(node.halfSize * 2.0f), node.center + Vector3(node.halfSize * 2.0f), min, max) <= 0.0f;
+			}, [&](const Object &object) {
+				if(GetSquaredDistance(min, max, object.position) <= object.radius * object.radius)
+					result.push_back(object.value);
+			});
+		}
+
+		void QueryRadius(const Vector3 &center, float radius, std::vector<T> &result) const
+		{
+			ForEachNode([&](const Node &node) {
+				return GetSquaredDistance(node.center - Vector3(node.halfSize * 2.0f), node.center + Vector3(node.halfSize * 2.0f), center) <= radius * radius;
+			}, [&](const Object &object) {
+				const float distance = radius + object.radius;
+				if(object.position.GetSquaredDistance(center) <= distance * distance)
+					result.push_back(object.value);
+			});
+		}
+
+		// One radius query per center, the results of center i are result[offsets[i]] up to result[offsets[i + 1]]
+		void QueryRadius(const Vector3 *centers, size_t count, float radius, std::vector<T> &result, std::vector<size_t> &offsets) const
+		{
+			offsets.resize(count + 1);
+
+			for(size_t i = 0; i < count; i ++)
+			{
+				offsets[i] = result.size();
+				QueryRadius(centers[i], radius, result);
+			}
+
+			offsets[count] = result.size();
+		}
+
+		// Appends up to count values whose positions are closest to position, nearest first
+		void QueryNearest(const Vector3 &position, size_t count, std::vector<T> &result, float maxDistance = std::numeric_limits<float>::max()) const
+		{
+			if(count == 0 || _count == 0)
+				return;
+
+			static thread_local std::vector<std::pair<float, Handle>> heap;
+			static thread_local std::vector<std::pair<float, uint32>> nodes;
+
+			heap.clear();
+			nodes.clear();
+
+			const float maxDistanceSquared = (maxDistance < std::numeric_limits<float>::max()) ? maxDistance * maxDistance : std::numeric_limits<float>::infinity();
+
+			// Best first, nodes are visited by the distance to their cell, which bounds the distance to every position below them
+			const auto closer = [](const std::pair<float, uint32> &a, const std::pair<float, uint32> &b) { return a.first > b.first; };
+
+			nodes.emplace_back(0.0f, 0);
+
+			while(!nodes.empty())
+			{
+				std::pop_heap(nodes.begin(), nodes.end(), closer);
+				const std::pair<float, uint32> entry = nodes.back();
+				nodes.pop_back();
+
+				if(entry.first > maxDistanceSquared || (heap.size() == count && entry.first >= heap.front().first))
+					break;
+
+				const Node &node = _nodes[entry.second];
+
+				for(Handle handle = node.objects; handle != kInvalidHandle; handle = _objects[handle].next)
+				{
+					const float distance = _objects[handle].position.GetSquaredDistance(position);
+					if(distance > maxDistanceSquared)
+						continue;
+
+					if(heap.size() < count)
+					{
+						heap.emplace_back(distance, handle);
+						std::push_heap(heap.begin(), heap.end());
+					}
+					else if(distance < heap.front().first)
+					{
+						std::pop_heap(heap.begin(), heap.end());
+						heap.back() = std::make_pair(distance, handle);
+						std::push_heap(heap.begin(), heap.end());
+					}
+				}
+
+				if(node.children == kInvalidNode)
+					continue;
+
+				for(uint32 i = 0; i < 8; i ++)
+				{
+					const uint32 child = node.children + i;
+					if(_nodes[child].count == 0)
+						continue;
+
+					const Node &childNode = _nodes[child];
+					const float distance = GetSquaredDistance(childNode.center - Vector3(childNode.halfSize), childNode.center + Vector3(childNode.halfSize), position);
+
+					nodes.emplace_back(distance, child);
+					std::push_heap(nodes.begin(), nodes.end(), closer);
+				}
+			}
+
+			std::sort_heap(heap.begin(), heap.end());
+
+			for(const std::pair<float, Handle> &entry : heap)
+				result.push_back(_objects[entry.second].value);
+		}
+
+		void Clear()
+		{
+			_objects.clear();
+			_freeObjects = kInvalidHandle;
+			_count = 0;
+
+			_nodes.clear();
+			_nodes.emplace_back();
+
+			Node &root = _nodes.back();
+			root.center = _center;
+			root.halfSize = _halfSize;
+			root.parent = kInvalidNode;
+		}
+
+		size_t GetCount() const { return _count; }
+
+	private:
+		static constexpr uint32 kInvalidNode = static_cast<uint32>(-1);
+
+		struct Node
+		{
+			Node() : parent(kInvalidNode), children(kInvalidNode), objects(kInvalidHandle), count(0) {}
+
+			Vector3 center;
+			float halfSize;
+			uint32 parent;
+			uint32 children; // Index of the first of the 8 children
+			Handle objects;
+			uint32 count; // Values in this node and all of its children
+		};
+
+		struct Object
+		{
+			Vector3 position;
+			float radius;
+			T value;
+			uint32 node;
+			Handle next; // Next free object while unused
+			Handle previous;
+			bool used;
+		};
+
+		static uint32 GetOctant(const Node &node, const Vector3 &position)
+		{
+			return ((position.x >= node.center.x) ? 1 : 0) | ((position.y >= node.center.y) ? 2 : 0) | ((position.z >= node.center.z) ? 4 : 0);
+		}
+
+		static float GetSquaredDistance(const Vector3 &min, const Vector3 &max, const Vector3 &point)
+		{
+			const float x = std::max(std::max(min.x - point.x, point.x - max.x), 0.0f);
+			const float y = std::max(std::max(min.y - point.y, point.y - max.y), 0.0f);
+			const float z = std::max(std::max(min.z - point.z, point.z - max.z), 0.0f);
+			return x * x + y * y + z * z;
+		}
+
+		// Zero if the boxes overlap
+		static float GetSquaredDistance(const Vector3 &min0, const Vector3 &max0, const Vector3 &min1, const Vector3 &max1)
+		{
+			const float x = std::max(std::max(min0.x - max1.x, min1.x - max0.x), 0.0f);
+			const float y = std::max(std::max(min0.y - max1.y, min1.y - max0.y), 0.0f);
+			const float z = std::max(std::max(min0.z - max1.z, min1.z - max0.z), 0.0f);
+			return x * x + y * y + z * z;
+		}
+
+		bool IsInsideRoot(const Vector3 &position) const
+		{
+			const Vector3 delta = position - _center;
+			return (std::abs(delta.x) <= _halfSize && std::abs(delta.y) <= _halfSize && std::abs(delta.z) <= _halfSize);
+		}
+
+		uint32 FindNode(const Vector3 &position, float radius)
+		{
+			if(!IsInsideRoot(position))
+				return 0;
+
+			uint32 node = 0;
+
+			for(uint32 depth = 0; depth < _maxDepth; depth ++)
+			{
+				const float childHalfSize = _nodes[node].halfSize * 0.5f;
+				if(radius > childHalfSize)
+					break;
+
+				if(_nodes[node].children == kInvalidNode)
+				{
+					const uint32 children = static_cast<uint32>(_nodes.size());
+					const Vector3 center = _nodes[node].center;
+
+					_nodes.resize(_nodes.size() + 8);
+					_nodes[node].children = children;
+
+					for(uint32 i = 0; i < 8; i ++)
+					{
+						Node &child = _nodes[children + i];
+						child.center = center + Vector3((i & 1) ? childHalfSize : -childHalfSize, (i & 2) ? childHalfSize : -childHalfSize, (i & 4) ? childHalfSize : -childHalfSize);
+						child.halfSize = childHalfSize;
+						child.parent = node;
+					}
+				}
+
+				node = _nodes[node].children + GetOctant(_nodes[node], position);
+			}
+
+			return node;
+		}
+
+		// Calls objectCallback for all objects in nodes for which nodeCallback returns true, the root is always visited
+		template<class NodeCallback, class ObjectCallback>
+		void ForEachNode(NodeCallback &&nodeCallback, ObjectCallback &&objectCallback) const
+		{
+			if(_count == 0)
+				return;
+
+			uint32 stack[64];
+			std::vector<uint32> overflow;
+			size_t stackCount = 0;
+
+			stack[stackCount ++] = 0;
+
+			while(stackCount > 0 || !overflow.empty())
+			{
+				uint32 index;
+
+				if(!overflow.empty())
+				{
+					index = overflow.back();
+					overflow.pop_back();
+				}
+				else
+				{
+					index = stack[-- stackCount];
+				}
+
+				const Node &node = _nodes[index];
+
+				if(node.count == 0 || (index != 0 && !nodeCallback(node)))
+					continue;
+
+				for(Handle handle = node.objects; handle != kInvalidHandle; handle = _objects[handle].next)
+					objectCallback(_objects[handle]);
+
+				if(node.children == kInvalidNode)
+					continue;
+
+				for(uint32 i = 0; i < 8; i ++)
+				{
+					if(stackCount < 64)
+						stack[stackCount ++] = node.children + i;
+					else
+						overflow.push_back(node.children + i);
+				}
+			}
+		}
+
+		void Link(Handle handle, uint32 node)
+		{
+			Object &object = _objects[handle];
+
+			object.node = node;
+			object.previous = kInvalidHandle;
+			object.next = _nodes[node].objects;
+
+			if(object.next != kInvalidHandle)
+				_objects[object.next].previous = handle;
+
+			_nodes[node].objects = handle;
+
+			for(uint32 index = node; index != kInvalidNode; index = _nodes[index].parent)
+				_nodes[index].count ++;
+		}
+
+		void Unlink(Handle handle)
+		{
+			const Object &object = _objects[handle];
+
+			if(object.next != kInvalidHandle)
+				_objects[object.next].previous = object.previous;
+
+			if(object.previous != kInvalidHandle)
+				_objects[object.previous].next = object.next;
+			else
+				_nodes[object.node].objects = object.next;
+
+			for(uint32 index = object.node; index != kInvalidNode; index = _nodes[index].parent)
+				_nodes[index].count --;
+		}
+
+		Vector3 _center;
+		float _halfSize;
+		uint32 _maxDepth;
+
+		std::vector<Node> _nodes;
+		std::vector<Object> _objects;
+		Handle _freeObjects;
+		size_t _count;
+	};
+}
+
+#endif /* __RAYNE_LOOSEOCTREE_H__ */
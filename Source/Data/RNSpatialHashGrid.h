@@ -0,0 +1,517 @@
+//
+//  RNSpatialHashGrid.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_SPATIALHASHGRID_H__
+#define __RAYNE_SPATIALHASHGRID_H__
+
+#include "../Base/RNBase.h"
+#include "../Math/RNVector.h"
+#include "../Math/RNAABB.h"
+
+namespace RN
+{
+	// Integer cell coordinates of the spatial containers, packed with 21 bits per axis.
+	// Coordinates further out than +-2^20 cells alias, which only costs some extra position tests.
+	struct SpatialCell
+	{
+		static uint64 Pack(int32 x, int32 y, int32 z)
+		{
+			return ((static_cast<uint64>(x) & 0x1fffff) << 42) | ((static_cast<uint64>(y) & 0x1fffff) << 21) | (static_cast<uint64>(z) & 0x1fffff);
+		}
+
+		static size_t Hash(uint64 key)
+		{
+			key ^= key >> 33;
+			key *= 0xff51afd7ed558ccdULL;
+			key ^= key >> 33;
+			key *= 0xc4ceb9fe1a85ec53ULL;
+			key ^= key >> 33;
+
+			return static_cast<size_t>(key);
+		}
+	};
+
+	// Uniform grid storing any number of values per cell. Cells live in an open addressing table keyed by their integer
+	// coordinates, values in one flat array linked per cell, so inserts, moves and erases don't allocate once warmed up.
+	// With useY set to false all values are projected onto the xz plane.
+	template<class T>
+	class SpatialHashGrid
+	{
+	public:
+		typedef uint32 Handle;
+		static constexpr Handle kInvalidHandle = static_cast<Handle>(-1);
+
+		SpatialHashGrid(float cellSize, bool useY = true) :
+			_cellSize(cellSize),
+			_inverseCellSize(1.0f / cellSize),
+			_useY(useY)
+		{
+			Clear();
+		}
+
+		Handle Insert(const Vector3 &position, const T &value)
+		{
+			Handle handle = _freeEntries;
+
+			if(handle == kInvalidHandle)
+			{
+				handle = static_cast<Handle>(_entries.size());
+				_entries.emplace_back();
+			}
+			else
+			{
+				_freeEntries = _entries[handle].next;
+			}
+
+			Entry &entry = _entries[handle];
+			entry.position = position;
+			entry.value = value;
+			entry.used = true;
+
+			Link(handle);
+			_count ++;
+
+			return handle;
+		}
+
+		void Erase(Handle handle)
+		{
+			RN_ASSERT(handle < _entries.size() && _entries[handle].used, "Erase() must be called with a valid handle");
+
+			Unlink(handle);
+
+			Entry &entry = _entries[handle];
+			entry.value = T();
+			entry.used = false;
+			entry.next = _freeEntries;
+
+			_freeEntries = handle;
+			_count --;
+		}
+
+		// Erases the first entry in the cell of position that holds value
+		bool Erase(const Vector3 &position, const T &value)
+		{
+			const size_t cell = FindCell(GetCellKey(position));
+			if(cell == kRNNotFound)
+				return false;
+
+			for(Handle handle = _cells[cell].head; handle != kInvalidHandle; handle = _entries[handle].next)
+			{
+				if(_entries[handle].value == value)
+				{
+					Erase(handle);
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void Move(Handle handle, const Vector3 &position)
+		{
+			Entry &entry = _entries[handle];
+
+			if(GetCellKey(position) == entry.cell)
+			{
+				entry.position = position;
+				return;
+			}
+
+			Unlink(handle);
+			_entries[handle].position = position;
+			Link(handle);
+		}
+
+		const T &Get(Handle handle) const { return _entries[handle].value; }
+		const Vector3 &GetPosition(Handle handle) const { return _entries[handle].position; }
+
+		// All queries append to the result
+		void Query(const AABB &aabb, std::vector<T> &result) const
+		{
+			const Vector3 min = aabb.position + aabb.minExtend;
+			const Vector3 max = aabb.position + aabb.maxExtend;
+
+			ForEachInBox(min, max, [&](const Entry &entry) {
+
+				const Vector3 &position = entry.position;
+				if(position.x >= min.x && position.x <= max.x && position.z >= min.z && position.z <= max.z && (!_useY || (position.y >= min.y && position.y <= max.y)))
+					result.push_back(entry.value);
+
+			});
+		}
+
+		void QueryRadius(const Vector3 &center, float radius, std::vector<T> &result) const
+		{
+			const float radiusSquared = radius * radius;
+
+			ForEachInBox(center - Vector3(radius), center + Vector3(radius), [&](const Entry &entry) {
+
+				if(GetSquaredDistance(entry.position, center) <= radiusSquared)
+					result.push_back(entry.value);
+
+			});
+		}
+
+		// One radius query per center, the results of center i are result[offsets[i]] up to result[offsets[i + 1]]
+		void QueryRadius(const Vector3 *centers, size_t count, float radius, std::vector<T> &result, std::vector<size_t> &offsets) const
+		{
+			offsets.resize(count + 1);
+
+			for(size_t i = 0; i < count; i ++)
+			{
+				offsets[i] = result.size();
+				QueryRadius(centers[i], radius, result);
+			}
+
+			offsets[count] = result.size();
+		}
+
+		// Appends up to count values closest to position, nearest first
+		void QueryNearest(const Vector3 &position, size_t count, std::vector<T> &result, float maxDistance = std::numeric_limits<float>::max()) const
+		{
+			if(count == 0 || _count == 0)
+				return;
+
+			static thread_local std::vector<std::pair<float, Handle>> heap;
+			heap.clear();
+
+			const float maxDistanceSquared = (maxDistance < std::numeric_limits<float>::max()) ? maxDistance * maxDistance : std::numeric_limits<float>::infinity();
+
+			auto consider = [&](const Entry &entry, Handle handle) {
+
+				const float distance = GetSquaredDistance(entry.position, position);
+				if(distance > maxDistanceSquared)
+					return;
+
+				if(heap.size() < count)
+				{
+					heap.emplace_back(distance, handle);
+					std::push_heap(heap.begin(), heap.end());
+				}
+				else if(distance < heap.front().first)
+				{
+					std::pop_heap(heap.begin(), heap.end());
+					heap.back() = std::make_pair(distance, handle);
+					std::push_heap(heap.begin(), heap.end());
+				}
+			};
+
+			const int32 centerX = GetCellCoordinate(position.x);
+			const int32 centerY = _useY ? GetCellCoordinate(position.y) : 0;
+			const int32 centerZ = GetCellCoordinate(position.z);
+
+			// Rings of cells around the center, until no closer value can be in the next ring
+			const int32 lastRing = std::max(std::max(std::max(centerX - _minCell[0], _maxCell[0] - centerX), std::max(centerY - _minCell[1], _maxCell[1] - centerY)), std::max(centerZ - _minCell[2], _maxCell[2] - centerZ));
+
+			for(int32 ring = 0; ring <= lastRing; ring ++)
+			{
+				const uint64 outer = 2 * static_cast<uint64>(ring) + 1;
+				const uint64 inner = outer - 2;
+				const uint64 ringCells = _useY ? (outer * outer * outer - inner * inner * inner) : (outer * outer - inner * inner);
+
+				if(ring > 0 && ringCells > _cellCount)
+				{
+					// Cheaper to look at everything than at the empty cells of the ring
+					heap.clear();
+
+					for(const Cell &cell : _cells)
+					{
+						if(cell.key == kEmptyCell)
+							continue;
+
+						for(Handle handle = cell.head; handle != kInvalidHandle; handle = _entries[handle].next)
+							consider(_entries[handle], handle);
+					}
+
+					break;
+				}
+
+				const int32 yRange = _useY ? ring : 0;
+
+				for(int32 x = -ring; x <= ring; x ++)
+				{
+					for(int32 y = -yRange; y <= yRange; y ++)
+					{
+						const bool onShell = (std::abs(x) == ring || (_useY && std::abs(y) == ring));
+						const int32 zStep = (onShell || ring == 0) ? 1 : 2 * ring;
+
+						for(int32 z = -ring; z <= ring; z += zStep)
+						{
+							const size_t cell = FindCell(SpatialCell::Pack(centerX + x, centerY + y, centerZ + z));
+							if(cell == kRNNotFound)
+								continue;
+
+							for(Handle handle = _cells[cell].head; handle != kInvalidHandle; handle = _entries[handle].next)
+								consider(_entries[handle], handle);
+						}
+					}
+				}
+
+				const float bound = ring * _cellSize;
+				if(bound * bound > maxDistanceSquared || (heap.size() == count && heap.front().first <= bound * bound))
+					break;
+			}
+
+			std::sort_heap(heap.begin(), heap.end());
+
+			for(const std::pair<float, Handle> &entry : heap)
+				result.push_back(_entries[entry.second].value);
+		}
+
+		void Clear()
+		{
+			_entries.clear();
+			_freeEntries = kInvalidHandle;
+			_count = 0;
+
+			_cells.assign(16, Cell());
+			_cellCount = 0;
+
+			_minCell[0] = _minCell[1] = _minCell[2] = std::numeric_limits<int32>::max();
+			_maxCell[0] = _maxCell[1] = _maxCell[2] = std::numeric_limits<int32>::min();
+		}
+
+		size_t GetCount() const { return _count; }
+		float GetCellSize() const { return _cellSize; }
+
+	private:
+		static constexpr uint64 kEmptyCell = static_cast<uint64>(-1);
+
+		struct Entry
+		{
+			Vector3 position;
+			T value;
+			uint64 cell;
+			Handle next; // Next free entry while unused
+			Handle previous;
+			bool used;
+		};
+
+		struct Cell
+		{
+			Cell() : key(kEmptyCell), head(kInvalidHandle) {}
+
+			uint64 key;
+			Handle head;
+		};
+
+		int32 GetCellCoordinate(float value) const
+		{
+			return static_cast<int32>(std::floor(value * _inverseCellSize));
+		}
+
+		uint64 GetCellKey(const Vector3 &position) const
+		{
+			return SpatialCell::Pack(GetCellCoordinate(position.x), _useY ? GetCellCoordinate(position.y) : 0, GetCellCoordinate(position.z));
+		}
+
+		float GetSquaredDistance(const Vector3 &a, const Vector3 &b) const
+		{
+			const Vector3 delta = a - b;
+			return delta.x * delta.x + (_useY ? delta.y * delta.y : 0.0f) + delta.z * delta.z;
+		}
+
+		template<class F>
+		void ForEachInBox(const Vector3 &min, const Vector3 &max, F &&callback) const
+		{
+			if(_count == 0)
+				return;
+
+			const int32 minX = std::max(GetCellCoordinate(min.x), _minCell[0]);
+			const int32 maxX = std::min(GetCellCoordinate(max.x), _maxCell[0]);
+			const int32 minY = _useY ? std::max(GetCellCoordinate(min.y), _minCell[1]) : 0;
+			const int32 maxY = _useY ? std::min(GetCellCoordinate(max.y), _maxCell[1]) : 0;
+			const int32 minZ = std::max(GetCellCoordinate(min.z), _minCell[2]);
+			const int32 maxZ = std::min(GetCellCoordinate(max.z), _maxCell[2]);
+
+			if(minX > maxX || minY > maxY || minZ > maxZ)
+				return;
+
+			const uint64 cells = static_cast<uint64>(maxX - minX + 1) * static_cast<uint64>(maxY - minY + 1) * static_cast<uint64>(maxZ - minZ + 1);
+
+			// Big boxes walk the occupied cells instead of the whole range
+			if(cells > _cellCount)
+			{
+				for(const Cell &cell : _cells)
+				{
+					if(cell.key == kEmptyCell)
+						continue;
+
+					for(Handle handle = cell.head; handle != kInvalidHandle; handle = _entries[handle].next)
+						callback(_entries[handle]);
+				}
+
+				return;
+			}
+
+			for(int32 x = minX; x <= maxX; x ++)
+			{
+				for(int32 y = minY; y <= maxY; y ++)
+				{
+					for(int32 z = minZ; z <= maxZ; z ++)
+					{
+						const size_t cell = FindCell(SpatialCell::Pack(x, y, z));
+						if(cell == kRNNotFound)
+							continue;
+
+						for(Handle handle = _cells[cell].head; handle != kInvalidHandle; handle = _entries[handle].next)
+							callback(_entries[handle]);
+					}
+				}
+			}
+		}
+
+		void Link(Handle handle)
+		{
+			Entry &entry = _entries[handle];
+
+			const int32 x = GetCellCoordinate(entry.position.x);
+			const int32 y = _useY ? GetCellCoordinate(entry.position.y) : 0;
+			const int32 z = GetCellCoordinate(entry.position.z);
+
+			_minCell[0] = std::min(_minCell[0], x);
+			_minCell[1] = std::min(_minCell[1], y);
+			_minCell[2] = std::min(_minCell[2], z);
+			_maxCell[0] = std::max(_maxCell[0], x);
+			_maxCell[1] = std::max(_maxCell[1], y);
+			_maxCell[2] = std::max(_maxCell[2], z);
+
+			entry.cell = SpatialCell::Pack(x, y, z);
+
+			Cell &cell = _cells[InsertCell(entry.cell)];
+
+			entry.previous = kInvalidHandle;
+			entry.next = cell.head;
+
+			if(cell.head != kInvalidHandle)
+				_entries[cell.head].previous = handle;
+
+			cell.head = handle;
+		}
+
+		void Unlink(Handle handle)
+		{
+			Entry &entry = _entries[handle];
+
+			if(entry.next != kInvalidHandle)
+				_entries[entry.next].previous = entry.previous;
+
+			if(entry.previous != kInvalidHandle)
+			{
+				_entries[entry.previous].next = entry.next;
+				return;
+			}
+
+			const size_t cell = FindCell(entry.cell);
+			_cells[cell].head = entry.next;
+
+			if(entry.next == kInvalidHandle)
+				RemoveCell(cell);
+		}
+
+		size_t FindCell(uint64 key) const
+		{
+			const size_t mask = _cells.size() - 1;
+
+			for(size_t index = SpatialCell::Hash(key) & mask; ; index = (index + 1) & mask)
+			{
+				if(_cells[index].key == key)
+					return index;
+
+				if(_cells[index].key == kEmptyCell)
+					return kRNNotFound;
+			}
+		}
+
+		size_t InsertCell(uint64 key)
+		{
+			size_t mask = _cells.size() - 1;
+
+			for(size_t index = SpatialCell::Hash(key) & mask; ; index = (index + 1) & mask)
+			{
+				if(_cells[index].key == key)
+					return index;
+
+				if(_cells[index].key == kEmptyCell)
+					break;
+			}
+
+			// Keep the table at most half full
+			if((_cellCount + 1) * 2 > _cells.size())
+			{
+				std::vector<Cell> cells(_cells.size() * 2);
+				std::swap(cells, _cells);
+
+				mask = _cells.size() - 1;
+
+				for(const Cell &cell : cells)
+				{
+					if(cell.key == kEmptyCell)
+						continue;
+
+					size_t index = SpatialCell::Hash(cell.key) & mask;
+					while(_cells[index].key != kEmptyCell)
+						index = (index + 1) & mask;
+
+					_cells[index] = cell;
+				}
+			}
+
+			size_t index = SpatialCell::Hash(key) & mask;
+			while(_cells[index].key != kEmptyCell)
+				index = (index + 1) & mask;
+
+			_cells[index].key = key;
+			_cells[index].head = kInvalidHandle;
+			_cellCount ++;
+
+			return index;
+		}
+
+		// Backward shift deletion, so the table never needs tombstones
+		void RemoveCell(size_t index)
+		{
+			const size_t mask = _cells.size() - 1;
+			size_t next = (index + 1) & mask;
+
+			while(_cells[next].key != kEmptyCell)
+			{
+				const size_t ideal = SpatialCell::Hash(_cells[next].key) & mask;
+
+				// Only move entries whose probe sequence passes the hole
+				if(((next - ideal) & mask) >= ((next - index) & mask))
+				{
+					_cells[index] = _cells[next];
+					index = next;
+				}
+
+				next = (next + 1) & mask;
+			}
+
+			_cells[index] = Cell();
+			_cellCount --;
+		}
+
+		float _cellSize;
+		float _inverseCellSize;
+		bool _useY;
+
+		std::vector<Entry> _entries;
+		Handle _freeEntries;
+		size_t _count;
+
+		std::vector<Cell> _cells;
+		size_t _cellCount;
+
+		int32 _minCell[3];
+		int32 _maxCell[3];
+	};
+}
+
+#endif /* __RAYNE_SPATIALHASHGRID_H__ */
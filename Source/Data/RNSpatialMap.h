@@ -13,31 +13,16 @@
 #include "../Math/RNVector.h"
 #include "../Math/RNMath.h"
 #include "../Math/RNAABB.h"
-
-#define P1 1149851
-#define P2 1860498
-#define P3 87403803
-#define P4 1568397607
-#define P5 3010349
-#define P6 83492791
-#define P7 73856093
+#include "RNSpatialHashGrid.h"
 
 namespace RN
 {
 	struct SpatialHasher
 	{
+		// Keys are already rounded to whole cells
 		size_t operator ()(const Vector3 &vector) const
 		{
-			int32 x = static_cast<int32>(vector.x);
-			int32 y = static_cast<int32>(vector.y);
-			int32 z = static_cast<int32>(vector.z);
-			size_t h = (x * y * z) + P5;
-
-			h ^= (x < 0) ? x * P1 : x * P2;
-			h ^= (z < 0) ? z * P3 : z * P4;
-			h ^= (y < 0) ? y * P6 : y * P7;
-
-			return h;
+			return SpatialCell::Hash(SpatialCell::Pack(static_cast<int32>(vector.x), static_cast<int32>(vector.y), static_cast<int32>(vector.z)));
 		}
 	};
 
@@ -87,26 +72,19 @@ namespace RN
 			extents /= Vector3(_spacing, _spacingY ? _spacing : 1.0, _spacing);
 			extents *= 0.5f;
 
-			extents.x = ceilf(extents.x);
-			extents.y = ceilf(extents.y);
-			extents.z = ceilf(extents.z);
+			const int32 extentsX = static_cast<int32>(ceilf(extents.x));
+			const int32 extentsY = _spacingY ? static_cast<int32>(ceilf(extents.y)) : 0;
+			const int32 extentsZ = static_cast<int32>(ceilf(extents.z));
 
-			for(float x = -extents.x; x <= extents.x; x++)
+			for(int32 x = -extentsX; x <= extentsX; x++)
 			{
-				for(float z = -extents.z; z <= extents.z; z++)
+				for(int32 z = -extentsZ; z <= extentsZ; z++)
 				{
-					if(_spacingY)
+					for(int32 y = -extentsY; y <= extentsY; y++)
 					{
-						for(float y = -extents.y; y <= extents.z; y++)
-						{
-							if(RawContains(position + Vector3(x, y, z)))
-								result.push_back(_entries[position + Vector3(x, y, z)]);
-						}
-					}
-					else
-					{
-						if(RawContains(position + Vector3(x, 0.0f, z)))
-							result.push_back(_entries[position + Vector3(x, 0.0f, z)]);
+						auto iterator = _entries.find(position + Vector3(x, y, z));
+						if(iterator != _entries.end())
+							result.push_back(iterator->second);
 					}
 				}
 			}
@@ -157,12 +135,4 @@ namespace RN
 	};
 }
 
-#undef P1
-#undef P2
-#undef P3
-#undef P4
-#undef P5
-#undef P6
-#undef P7
-
 #endif /* __RAYNE_SPATIALMAP_H__ */
\ No newline at end of file
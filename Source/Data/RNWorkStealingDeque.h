@@ -0,0 +1,112 @@
+//
+//  RNWorkStealingDeque.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_WORKSTEALINGDEQUE_H__
+#define __RAYNE_WORKSTEALINGDEQUE_H__
+
+#include "../Base/RNBase.h"
+
+namespace RN
+{
+	// Bounded Chase-Lev deque. The owning thread pushes and pops at the bottom (LIFO),
+	// any other thread may steal from the top (FIFO). Size must be a power of two.
+	template<class T, size_t Size>
+	class WorkStealingDeque
+	{
+	public:
+		static_assert((Size & (Size - 1)) == 0, "Size must be a power of two");
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+		WorkStealingDeque() :
+			_top(0),
+			_bottom(0)
+		{}
+
+		// Owner only
+		bool Push(T value)
+		{
+			int64 bottom = _bottom.load(std::memory_order_relaxed);
+			int64 top = _top.load(std::memory_order_acquire);
+
+			if(bottom - top >= static_cast<int64>(Size))
+				return false;
+
+			_buffer[bottom & kMask].store(value, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+
+			return true;
+		}
+
+		// Owner only
+		bool Pop(T &value)
+		{
+			int64 bottom = _bottom.load(std::memory_order_relaxed) - 1;
+			_bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 top = _top.load(std::memory_order_relaxed);
+
+			if(top > bottom)
+			{
+				_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			value = _buffer[bottom & kMask].load(std::memory_order_relaxed);
+
+			if(top == bottom)
+			{
+				// Last element, race against thieves for it
+				bool won = _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				_bottom.store(bottom + 1, std::memory_order_relaxed);
+
+				return won;
+			}
+
+			return true;
+		}
+
+		// Any thread
+		bool Steal(T &value)
+		{
+			int64 top = _top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 bottom = _bottom.load(std::memory_order_acquire);
+
+			if(top >= bottom)
+				return false;
+
+			value = _buffer[top & kMask].load(std::memory_order_relaxed);
+			return _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		}
+
+		bool WasEmpty() const
+		{
+			return (_bottom.load(std::memory_order_acquire) <= _top.load(std::memory_order_acquire));
+		}
+
+		// Exact upper bound when called by the owner, since thieves can only shrink the deque
+		size_t GetSize() const
+		{
+			int64 size = _bottom.load(std::memory_order_acquire) - _top.load(std::memory_order_acquire);
+			return static_cast<size_t>(std::max(size, static_cast<int64>(0)));
+		}
+
+		static RN_CONSTEXPR size_t GetCapacity() { return Size; }
+
+	private:
+		static RN_CONSTEXPR int64 kMask = static_cast<int64>(Size - 1);
+
+		RN_ALIGNAS(64) std::atomic<int64> _top;
+		RN_ALIGNAS(64) std::atomic<int64> _bottom;
+
+		std::array<std::atomic<T>, Size> _buffer;
+	};
+}
+
+#endif /* __RAYNE_WORKSTEALINGDEQUE_H__ */
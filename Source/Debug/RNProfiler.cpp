@@ -0,0 +1,244 @@
+//
+//  RNProfiler.cpp
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "RNProfiler.h"
+#include "../Objects/RNString.h"
+
+namespace RN
+{
+	struct Profiler::Event
+	{
+		const char *name;
+		uint64 start;
+		uint64 end;
+		uint32 frame;
+		char detail[kRNProfilerDetailLength];
+	};
+
+	struct Profiler::ThreadBuffer
+	{
+		ThreadBuffer(uint32 tid) :
+			id(tid),
+			head(0),
+			tail(0)
+		{
+			name[0] = '\0';
+		}
+
+		uint32 id;
+		char name[64];
+
+		// Only the owning thread writes events and advances the head, readers copy events and then
+		// check that the head didn't lap them in the meantime
+		std::atomic<uint64> head;
+		std::atomic<uint64> tail;
+		Event events[kRNProfilerEventsPerThread];
+	};
+
+	static thread_local char __threadName[64];
+
+	static const std::chrono::steady_clock::time_point __profilerEpoch = std::chrono::steady_clock::now();
+
+	Profiler::Profiler() :
+		_enabled(false),
+		_frame(0)
+	{}
+
+	Profiler *Profiler::GetSharedInstance()
+	{
+		static Profiler *profiler = new Profiler();
+		return profiler;
+	}
+
+	uint64 Profiler::GetTimestamp()
+	{
+		// Never 0, which marks a zone that started while the profiler was disabled
+		return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - __profilerEpoch).count()) + 1;
+	}
+
+	void Profiler::SetEnabled(bool enabled)
+	{
+		_enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	void Profiler::BeginFrame()
+	{
+		_frame.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	Profiler::ThreadBuffer *Profiler::GetThreadBuffer(bool create)
+	{
+		static thread_local ThreadBuffer *threadBuffer = nullptr;
+
+		if(RN_EXPECT_TRUE(threadBuffer != nullptr) || !create)
+			return threadBuffer;
+
+		// Buffers are only created once a thread records something, as they are quite large
+		LockGuard<Lockable> lock(_lock);
+
+		ThreadBuffer *buffer = new ThreadBuffer(static_cast<uint32>(_buffers.size() + 1));
+		strcpy(buffer->name, __threadName);
+
+		_buffers.push_back(buffer);
+
+		threadBuffer = buffer;
+		return buffer;
+	}
+
+	void Profiler::SetThreadName(const char *name)
+	{
+		strncpy(__threadName, name, sizeof(__threadName) - 1);
+		__threadName[sizeof(__threadName) - 1] = '\0';
+
+		ThreadBuffer *buffer = GetThreadBuffer(false);
+		if(buffer)
+		{
+			LockGuard<Lockable> lock(_lock);
+			strcpy(buffer->name, __threadName);
+		}
+	}
+
+	void Profiler::RecordEvent(const char *name, const char *detail, uint64 start, uint64 end)
+	{
+		ThreadBuffer *buffer = GetThreadBuffer(true);
+
+		const uint64 head = buffer->head.load(std::memory_order_relaxed);
+		Event &event = buffer->events[head % kRNProfilerEventsPerThread];
+
+		event.name = name;
+		event.start = start;
+		event.end = end;
+		event.frame = _frame.load(std::memory_order_relaxed);
+
+		if(detail)
+		{
+			// Keep the end of long details, that's where file names are
+			size_t length = strlen(detail);
+			if(length >= kRNProfilerDetailLength)
+			{
+				detail += length - (kRNProfilerDetailLength - 1);
+				length = kRNProfilerDetailLength - 1;
+			}
+
+			memcpy(event.detail, detail, length);
+			event.detail[length] = '\0';
+		}
+		else
+		{
+			event.detail[0] = '\0';
+		}
+
+		buffer->head.store(head + 1, std::memory_order_release);
+	}
+
+	void Profiler::Clear()
+	{
+		LockGuard<Lockable> lock(_lock);
+
+		for(ThreadBuffer *buffer : _buffers)
+			buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+	}
+
+	static void WriteJSONString(FILE *file, const char *string)
+	{
+		fputc('"', file);
+
+		for(const char *c = string; *c; c ++)
+		{
+			switch(*c)
+			{
+				case '"':
+					fputs("\\\"", file);
+					break;
+				case '\\':
+					fputs("\\\\", file);
+					break;
+				case '\n':
+					fputs("\\n", file);
+					break;
+				case '\t':
+					fputs("\\t", file);
+					break;
+				default:
+					if(static_cast<unsigned char>(*c) < 0x20)
+						fprintf(file, "\\u%04x", *c);
+					else
+						fputc(*c, file);
+					break;
+			}
+		}
+
+		fputc('"', file);
+	}
+
+	bool Profiler::WriteChromeTrace(const String *path)
+	{
+		FILE *file = fopen(path->GetUTF8String(), "wb");
+		if(!file)
+			return false;
+
+		LockGuard<Lockable> lock(_lock);
+
+		std::vector<Event> events;
+		bool first = true;
+
+		fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+
+		for(ThreadBuffer *buffer : _buffers)
+		{
+			if(buffer->name[0] != '\0')
+			{
+				fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", buffer->id);
+				WriteJSONString(file, buffer->name);
+				fputs("}}", file);
+
+				first = false;
+			}
+
+			uint64 head = buffer->head.load(std::memory_order_acquire);
+			uint64 tail = std::max(buffer->tail.load(std::memory_order_relaxed), (head > kRNProfilerEventsPerThread) ? head - kRNProfilerEventsPerThread : 0);
+
+			events.clear();
+			events.reserve(static_cast<size_t>(head - tail));
+
+			for(uint64 i = tail; i < head; i ++)
+				events.push_back(buffer->events[i % kRNProfilerEventsPerThread]);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			// Drop everything the owning thread may have overwritten while copying, including the slot it might be writing right now
+			const uint64 end = buffer->head.load(std::memory_order_relaxed) + 1;
+			const size_t skip = (end - tail > kRNProfilerEventsPerThread) ? static_cast<size_t>(std::min(end - tail - kRNProfilerEventsPerThread, head - tail)) : 0;
+
+			for(size_t i = skip; i < events.size(); i ++)
+			{
+				const Event &event = events[i];
+
+				fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+				WriteJSONString(file, event.name);
+				fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u", buffer->id, event.start / 1000.0, (event.end - event.start) / 1000.0, event.frame);
+
+				if(event.detail[0] != '\0')
+				{
+					fputs(",\"detail\":", file);
+					WriteJSONString(file, event.detail);
+				}
+
+				fputs("}}", file);
+				first = false;
+			}
+		}
+
+		fputs("\n]}\n", file);
+
+		const bool result = (ferror(file) == 0);
+		fclose(file);
+
+		return result;
+	}
+}
@@ -0,0 +1,107 @@
+//
+//  RNProfiler.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_PROFILER_H__
+#define __RAYNE_PROFILER_H__
+
+#include "../Base/RNBase.h"
+
+#define kRNProfilerEventsPerThread 65536
+#define kRNProfilerDetailLength 48
+
+namespace RN
+{
+	class String;
+	class ProfilerZone;
+
+	// Records named, nested CPU zones into per thread ring buffers. Recording is lock free, only the first zone of every thread
+	// takes a lock to register its buffer. Once a buffer is full the oldest events are overwritten.
+	// The recorded events can be written as a Chrome trace, which can be opened in chrome://tracing or Perfetto.
+	class Profiler
+	{
+	public:
+		friend class ProfilerZone;
+
+		RNAPI static Profiler *GetSharedInstance();
+		RNAPI static uint64 GetTimestamp(); // Nanoseconds
+
+		RNAPI void SetEnabled(bool enabled);
+		bool IsEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+		RNAPI void BeginFrame();
+		uint32 GetFrame() const { return _frame.load(std::memory_order_relaxed); }
+
+		// Names the calling thread in the trace, RN::Thread names are picked up automatically
+		RNAPI void SetThreadName(const char *name);
+
+		RNAPI void Clear();
+		RNAPI bool WriteChromeTrace(const String *path);
+
+	private:
+		struct Event;
+		struct ThreadBuffer;
+
+		Profiler();
+
+		ThreadBuffer *GetThreadBuffer(bool create);
+		RNAPI void RecordEvent(const char *name, const char *detail, uint64 start, uint64 end);
+
+		std::atomic<bool> _enabled;
+		std::atomic<uint32> _frame;
+
+		Lockable _lock;
+		std::vector<ThreadBuffer *> _buffers;
+	};
+
+	class ProfilerZone
+	{
+	public:
+		ProfilerZone(const char *name, const char *detail = nullptr) :
+			_name(name),
+			_detail(detail),
+			_start(0)
+		{
+			if(RN_EXPECT_FALSE(Profiler::GetSharedInstance()->IsEnabled()))
+				_start = Profiler::GetTimestamp();
+		}
+
+		~ProfilerZone()
+		{
+			if(RN_EXPECT_FALSE(_start != 0))
+				Profiler::GetSharedInstance()->RecordEvent(_name, _detail, _start, Profiler::GetTimestamp());
+		}
+
+		bool IsRecording() const { return (_start != 0); }
+		void SetDetail(const char *detail) { _detail = detail; }
+
+	private:
+		const char *_name;
+		const char *_detail;
+		uint64 _start;
+	};
+}
+
+#define __RN_PROFILE_CONCAT_(a, b) a##b
+#define __RN_PROFILE_CONCAT(a, b) __RN_PROFILE_CONCAT_(a, b)
+
+#if RN_ENABLE_PROFILER
+	// The name must outlive the profiler. The detail is only evaluated while recording and copied when the zone ends
+	#define RN_PROFILE_ZONE(name) RN::ProfilerZone __RN_PROFILE_CONCAT(__profilerZone, __LINE__)(name)
+	#define RN_PROFILE_ZONE_DETAIL(name, detail) \
+		RN_PROFILE_ZONE(name); \
+		if(__RN_PROFILE_CONCAT(__profilerZone, __LINE__).IsRecording()) __RN_PROFILE_CONCAT(__profilerZone, __LINE__).SetDetail(detail)
+	#define RN_PROFILE_FRAME() \
+		RN::Profiler::GetSharedInstance()->BeginFrame(); \
+		RN_PROFILE_ZONE("Frame")
+#else
+	#define RN_PROFILE_ZONE(name) (void)(0)
+	#define RN_PROFILE_ZONE_DETAIL(name, detail) (void)(0)
+	#define RN_PROFILE_FRAME() (void)(0)
+#endif
+
+#endif /* __RAYNE_PROFILER_H__ */
@@ -83,6 +83,64 @@ namespace RN
 
 		return value - (value % multiplier);
 	}
+
+	// Stable LSD radix sort of 64 bit keys with a value attached to every key, one byte per pass.
+	// Passes where all keys share the same byte are skipped. The scratch buffers need room for count elements.
+	template<class T>
+	void RadixSort(uint64 *keys, T *values, size_t count, uint64 *scratchKeys, T *scratchValues)
+	{
+		if(count < 2)
+			return;
+
+		std::vector<size_t> histograms(8 * 256, 0);
+
+		for(size_t i = 0; i < count; i ++)
+		{
+			const uint64 key = keys[i];
+
+			for(size_t pass = 0; pass < 8; pass ++)
+				histograms[pass * 256 + ((key >> (pass * 8)) & 0xff)] ++;
+		}
+
+		uint64 *sourceKeys = keys;
+		uint64 *destinationKeys = scratchKeys;
+		T *sourceValues = values;
+		T *destinationValues = scratchValues;
+
+		for(size_t pass = 0; pass < 8; pass ++)
+		{
+			size_t *histogram = histograms.data() + pass * 256;
+			const size_t shift = pass * 8;
+
+			if(histogram[(sourceKeys[0] >> shift) & 0xff] == count)
+				continue;
+
+			size_t offset = 0;
+			for(size_t i = 0; i < 256; i ++)
+			{
+				const size_t temp = histogram[i];
+				histogram[i] = offset;
+				offset += temp;
+			}
+
+			for(size_t i = 0; i < count; i ++)
+			{
+				const size_t index = histogram[(sourceKeys[i] >> shift) & 0xff] ++;
+
+				destinationKeys[index] = sourceKeys[i];
+				destinationValues[index] = sourceValues[i];
+			}
+
+			std::swap(sourceKeys, destinationKeys);
+			std::swap(sourceValues, destinationValues);
+		}
+
+		if(sourceKeys != keys)
+		{
+			std::copy(sourceKeys, sourceKeys + count, keys);
+			std::copy(sourceValues, sourceValues + count, values);
+		}
+	}
 }
 
 #endif /* __RAYNE_ALGORITHM_H__ */
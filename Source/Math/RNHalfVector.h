@@ -35,7 +35,7 @@ namespace RN
 		
 		HalfVector2(const HalfVector2 &other) = default;
 		
-		Vector2 GetVector2()
+		Vector2 GetVector2() const
 		{
 			Vector2 result;
 			result.x = Math::ConvertHalfToFloat(x);
@@ -75,7 +75,7 @@ namespace RN
 		
 		HalfVector3(const HalfVector3 &other) = default;
 		
-		Vector3 GetVector3()
+		Vector3 GetVector3() const
 		{
 			Vector3 result;
 			result.x = Math::ConvertHalfToFloat(x);
@@ -120,7 +120,7 @@ namespace RN
 		
 		HalfVector4(const HalfVector4 &other) = default;
 		
-		Vector4 GetVector4()
+		Vector4 GetVector4() const
 		{
 			Vector4 result;
 			result.x = Math::ConvertHalfToFloat(x);
@@ -0,0 +1,113 @@
+//
+//  RNSIMD.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_SIMD_H__
+#define __RAYNE_SIMD_H__
+
+#include "../Base/RNBase.h"
+
+#if RN_PLATFORM_INTEL
+	#include <emmintrin.h>
+#elif RN_PLATFORM_ARM
+	#include <arm_neon.h>
+#endif
+
+namespace RN
+{
+	// Thin wrapper around 4 wide float vectors, SSE2 on Intel and NEON on ARM.
+	// Comparisons return masks with all bits of a lane set, which can be fed into And, Or, Select and MoveMask.
+	namespace SIMD
+	{
+#if RN_PLATFORM_INTEL
+		typedef __m128 VecFloat;
+
+		RN_INLINE VecFloat Zero() { return _mm_setzero_ps(); }
+		RN_INLINE VecFloat Splat(float value) { return _mm_set1_ps(value); }
+		RN_INLINE VecFloat Set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+
+		RN_INLINE VecFloat Load(const float *data) { return _mm_loadu_ps(data); }
+		RN_INLINE void Store(float *data, VecFloat value) { _mm_storeu_ps(data, value); }
+
+		RN_INLINE VecFloat Add(VecFloat a, VecFloat b) { return _mm_add_ps(a, b); }
+		RN_INLINE VecFloat Sub(VecFloat a, VecFloat b) { return _mm_sub_ps(a, b); }
+		RN_INLINE VecFloat Mul(VecFloat a, VecFloat b) { return _mm_mul_ps(a, b); }
+		RN_INLINE VecFloat Div(VecFloat a, VecFloat b) { return _mm_div_ps(a, b); }
+		RN_INLINE VecFloat Min(VecFloat a, VecFloat b) { return _mm_min_ps(a, b); }
+		RN_INLINE VecFloat Max(VecFloat a, VecFloat b) { return _mm_max_ps(a, b); }
+		RN_INLINE VecFloat Sqrt(VecFloat a) { return _mm_sqrt_ps(a); }
+
+		RN_INLINE VecFloat CompareGreater(VecFloat a, VecFloat b) { return _mm_cmpgt_ps(a, b); }
+		RN_INLINE VecFloat CompareGreaterEqual(VecFloat a, VecFloat b) { return _mm_cmpge_ps(a, b); }
+		RN_INLINE VecFloat CompareLess(VecFloat a, VecFloat b) { return _mm_cmplt_ps(a, b); }
+		RN_INLINE VecFloat CompareLessEqual(VecFloat a, VecFloat b) { return _mm_cmple_ps(a, b); }
+
+		RN_INLINE VecFloat And(VecFloat a, VecFloat b) { return _mm_and_ps(a, b); }
+		RN_INLINE VecFloat Or(VecFloat a, VecFloat b) { return _mm_or_ps(a, b); }
+		RN_INLINE VecFloat Select(VecFloat mask, VecFloat a, VecFloat b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+		// One bit per lane, taken from the sign bit
+		RN_INLINE int MoveMask(VecFloat mask) { return _mm_movemask_ps(mask); }
+
+		RN_INLINE float HorizontalMin(VecFloat a)
+		{
+			a = _mm_min_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+			a = _mm_min_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+			return _mm_cvtss_f32(a);
+		}
+		RN_INLINE float HorizontalMax(VecFloat a)
+		{
+			a = _mm_max_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)));
+			a = _mm_max_ps(a, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 3, 2)));
+			return _mm_cvtss_f32(a);
+		}
+#elif RN_PLATFORM_ARM
+		typedef float32x4_t VecFloat;
+
+		RN_INLINE VecFloat Zero() { return vdupq_n_f32(0.0f); }
+		RN_INLINE VecFloat Splat(float value) { return vdupq_n_f32(value); }
+		RN_INLINE VecFloat Set(float x, float y, float z, float w)
+		{
+			const float data[4] = { x, y, z, w };
+			return vld1q_f32(data);
+		}
+
+		RN_INLINE VecFloat Load(const float *data) { return vld1q_f32(data); }
+		RN_INLINE void Store(float *data, VecFloat value) { vst1q_f32(data, value); }
+
+		RN_INLINE VecFloat Add(VecFloat a, VecFloat b) { return vaddq_f32(a, b); }
+		RN_INLINE VecFloat Sub(VecFloat a, VecFloat b) { return vsubq_f32(a, b); }
+		RN_INLINE VecFloat Mul(VecFloat a, VecFloat b) { return vmulq_f32(a, b); }
+		RN_INLINE VecFloat Div(VecFloat a, VecFloat b) { return vdivq_f32(a, b); }
+		RN_INLINE VecFloat Min(VecFloat a, VecFloat b) { return vminq_f32(a, b); }
+		RN_INLINE VecFloat Max(VecFloat a, VecFloat b) { return vmaxq_f32(a, b); }
+		RN_INLINE VecFloat Sqrt(VecFloat a) { return vsqrtq_f32(a); }
+
+		RN_INLINE VecFloat CompareGreater(VecFloat a, VecFloat b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+		RN_INLINE VecFloat CompareGreaterEqual(VecFloat a, VecFloat b) { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+		RN_INLINE VecFloat CompareLess(VecFloat a, VecFloat b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+		RN_INLINE VecFloat CompareLessEqual(VecFloat a, VecFloat b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+
+		RN_INLINE VecFloat And(VecFloat a, VecFloat b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+		RN_INLINE VecFloat Or(VecFloat a, VecFloat b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+		RN_INLINE VecFloat Select(VecFloat mask, VecFloat a, VecFloat b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+
+		RN_INLINE int MoveMask(VecFloat mask)
+		{
+			static const int32 shifts[4] = { 0, 1, 2, 3 };
+
+			uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_f32(mask), 31);
+			return static_cast<int>(vaddvq_u32(vshlq_u32(bits, vld1q_s32(shifts))));
+		}
+
+		RN_INLINE float HorizontalMin(VecFloat a) { return vminvq_f32(a); }
+		RN_INLINE float HorizontalMax(VecFloat a) { return vmaxvq_f32(a); }
+#endif
+	}
+}
+
+#endif /* __RAYNE_SIMD_H__ */
@@ -7,22 +7,87 @@
 //
 
 #include "RNAutoreleasePool.h"
-#include "../Threads/RNThreadLocalStorage.h"
-
-#define kRNAutoreleasePoolInitialGrowth 128
-#define kRNAutoreleasePoolGrowthFactor 1.4
 
 namespace RN
 {
-	static ThreadLocalStorage<AutoreleasePool *> _localPools;
+	struct __AutoreleasePoolPage
+	{
+		static constexpr size_t kCapacity = (kRNAutoreleasePoolPageSize - sizeof(void *)) / sizeof(const Object *);
+
+		const Object **GetBegin() { return objects; }
+		const Object **GetEnd() { return objects + kCapacity; }
+
+		__AutoreleasePoolPage *next;
+		const Object *objects[kCapacity];
+	};
+
+	static_assert(sizeof(__AutoreleasePoolPage) <= kRNAutoreleasePoolPageSize, "Autorelease pool pages must fit into kRNAutoreleasePoolPageSize");
+
+	struct __AutoreleasePoolThreadState
+	{
+		~__AutoreleasePoolThreadState()
+		{
+			while(pages)
+			{
+				__AutoreleasePoolPage *next = pages->next;
+				delete pages;
+
+				pages = next;
+			}
+		}
+
+		__AutoreleasePoolPage *AcquirePage()
+		{
+			if(!pages)
+				return new __AutoreleasePoolPage();
+
+			__AutoreleasePoolPage *page = pages;
+
+			pages = page->next;
+			pageCount --;
+
+			return page;
+		}
+
+		// Takes a linked list of pages
+		void RecyclePages(__AutoreleasePoolPage *page)
+		{
+			while(page)
+			{
+				__AutoreleasePoolPage *next = page->next;
+
+				if(pageCount < kRNAutoreleasePoolMaxCachedPages)
+				{
+					page->next = pages;
+					pages = page;
+					pageCount ++;
+				}
+				else
+				{
+					delete page;
+				}
+
+				page = next;
+			}
+		}
+
+		AutoreleasePool *pool = nullptr;
+		__AutoreleasePoolPage *pages = nullptr;
+		size_t pageCount = 0;
+	};
+
+	static thread_local __AutoreleasePoolThreadState __autoreleasePoolThreadState;
 
 	
 	AutoreleasePool::AutoreleasePool() :
-		_parent(AutoreleasePool::GetCurrentPool()),
-		_owner(std::this_thread::get_id())
+		_parent(__autoreleasePoolThreadState.pool),
+		_owner(std::this_thread::get_id()),
+		_cursor(_objects),
+		_end(_objects + kRNAutoreleasePoolInlineObjects),
+		_firstPage(nullptr),
+		_currentPage(nullptr)
 	{
-		_objects.reserve(kRNAutoreleasePoolInitialGrowth);
-		_localPools.SetValue(this);
+		__autoreleasePoolThreadState.pool = this;
 	}
 	
 	AutoreleasePool::~AutoreleasePool()
@@ -30,7 +95,7 @@ namespace RN
 		RN_ASSERT(this == GetCurrentPool(), "Popping pool other than the topmost pool is forbidden!");
 		
 		Drain();
-		_localPools.SetValue(_parent);
+		__autoreleasePoolThreadState.pool = _parent;
 	}
 
 	void AutoreleasePool::PerformBlock(Function &&function)
@@ -45,32 +110,93 @@ namespace RN
 		RN_ASSERT(object, "Object mustn't be NULL");
 
 #if RN_BUILD_DEBUG
-		RN_ASSERT(object->_autoreleaseCounter.fetch_add(1) < object->_refCount, "Object will be overreleased by autorelease pool!");
+		RN_ASSERT(object->_autoreleaseCounter.fetch_add(1) < object->GetReferenceCount(), "Object will be overreleased by autorelease pool!");
 #endif
 
-		_objects.push_back(object);
-		
-		if(_objects.size() == _objects.capacity())
-			_objects.reserve(static_cast<size_t>(_objects.size() + (_objects.size() * kRNAutoreleasePoolGrowthFactor)));
+		if(RN_EXPECT_FALSE(_cursor == _end))
+			AddPage();
+
+		*_cursor ++ = object;
 	}
-	
-	void AutoreleasePool::Drain()
+
+	void AutoreleasePool::AddPage()
 	{
-		for(size_t i = 0; i < _objects.size(); i++)
+		RN_ASSERT(std::this_thread::get_id() == _owner, "Autorelease pools can only be used by the thread that created them");
+
+		__AutoreleasePoolPage *page = __autoreleasePoolThreadState.AcquirePage();
+		page->next = nullptr;
+
+		if(_currentPage)
+			_currentPage->next = page;
+		else
+			_firstPage = page;
+
+		_currentPage = page;
+
+		_cursor = page->GetBegin();
+		_end = page->GetEnd();
+	}
+
+	void AutoreleasePool::ReleaseObjects(const Object **objects, size_t count)
+	{
+		size_t i = 0;
+
+		while(i < count)
 		{
-			const Object *object = _objects[i];
+			const Object *object = objects[i];
+			size_t run = 1;
+
+			// Objects autoreleased several times in a row only have their reference count touched once
+			while(i + run < count && objects[i + run] == object)
+				run ++;
+
 #if RN_BUILD_DEBUG
-			object->_autoreleaseCounter.fetch_sub(1);
+			object->_autoreleaseCounter.fetch_sub(run);
 #endif
-			object->Release();
+			object->ReleaseBatch(run);
+			i += run;
 		}
+	}
+	
+	void AutoreleasePool::Drain()
+	{
+		// Releasing objects can autorelease new ones into this pool, so the end of the current segment is looked up again
+		// after every batch, and the drain only ends once the segment objects are added to has been read completely
+		__AutoreleasePoolPage *page = nullptr;
+		const Object **read = _objects;
+
+		while(true)
+		{
+			const bool isCurrent = (page == _currentPage);
+			const Object **end = isCurrent ? _cursor : page ? page->GetEnd() : _objects + kRNAutoreleasePoolInlineObjects;
+
+			if(read < end)
+			{
+				const Object **begin = read;
+				read = end;
+
+				ReleaseObjects(begin, static_cast<size_t>(end - begin));
+				continue;
+			}
+
+			if(isCurrent)
+				break;
+
+			page = page ? page->next : _firstPage;
+			read = page->GetBegin();
+		}
+
+		__autoreleasePoolThreadState.RecyclePages(_firstPage);
+
+		_firstPage = nullptr;
+		_currentPage = nullptr;
 
-		_objects = std::vector<const Object *>();
-		_objects.reserve(kRNAutoreleasePoolInitialGrowth);
+		_cursor = _objects;
+		_end = _objects + kRNAutoreleasePoolInlineObjects;
 	}
 	
 	AutoreleasePool *AutoreleasePool::GetCurrentPool()
 	{
-		return _localPools.GetValue();
+		return __autoreleasePoolThreadState.pool;
 	}
 }
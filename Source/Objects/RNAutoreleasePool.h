@@ -12,8 +12,17 @@
 #include "../Base/RNBase.h"
 #include "RNObject.h"
 
+#define kRNAutoreleasePoolInlineObjects 32 // Objects stored in the pool itself before it needs a page
+#define kRNAutoreleasePoolPageSize 4096
+#define kRNAutoreleasePoolMaxCachedPages 64 // Pages each thread keeps around for its pools
+
 namespace RN
 {
+	struct __AutoreleasePoolPage;
+
+	// Objects are stored in the pool until it runs out of inline space and then in pages, which come from a cache of the
+	// thread owning the pool. Draining hands the pages back to that cache, so pools that are created and drained over
+	// and over again don't allocate once the cache is warm.
 	class AutoreleasePool
 	{
 	public:
@@ -26,13 +35,21 @@ namespace RN
 		RNAPI void Drain();
 		
 		RNAPI static AutoreleasePool *GetCurrentPool();
-
-		std::vector<const Object *> _objects;
 		
 	private:
+		void AddPage();
+		void ReleaseObjects(const Object **objects, size_t count);
+
 		AutoreleasePool *_parent;
 		std::thread::id _owner;
-		
+
+		const Object **_cursor;
+		const Object **_end;
+
+		__AutoreleasePoolPage *_firstPage;
+		__AutoreleasePoolPage *_currentPage;
+
+		const Object *_objects[kRNAutoreleasePoolInlineObjects];
 	};
 }
 
@@ -27,6 +27,11 @@ namespace RN
 	static size_t __pendingClassesCount;
 	static bool __immediatelyHandlePendingClasses = false;
 
+	// Class ranges are only assigned once the pending classes are registered, afterwards on every change.
+	// The generation is odd while they are invalid, readers check it before and after comparing the ranges
+	static bool __deferClassRanges = true;
+	static std::atomic<uint32> __classRangeGeneration(1);
+
 	void __RegisterMetaClass(__ClassInitializer initializer)
 	{
 		if(RN_EXPECT_TRUE(__immediatelyHandlePendingClasses))
@@ -48,7 +53,9 @@ namespace RN
 	MetaClass::MetaClass(MetaClass *parent, const std::string &name, const char *namespaceBlob) :
 		_module(nullptr),
 		_superClass(parent),
-		_name(name)
+		_name(name),
+		_classIndex(0),
+		_lastSubclassIndex(0)
 	{
 		Catalogue::ParsePrettyFunction(namespaceBlob, _namespace);
 		
@@ -56,6 +63,14 @@ namespace RN
 		
 		if(!parent)
 			_namespace.pop_back();
+
+		for(auto i=_namespace.begin(); i!=_namespace.end(); i++)
+		{
+			_fullname += *i;
+			_fullname += "::";
+		}
+
+		_fullname += _name;
 		
 		Catalogue::GetSharedInstance()->AddMetaClass(this);
 	}
@@ -69,32 +84,39 @@ namespace RN
 	{
 		if(this == other)
 			return true;
-		
-		if(!_superClass)
-			return false;
-		
-		return _superClass->InheritsFromClass(other);
+
+		const uint32 generation = __classRangeGeneration.load(std::memory_order_acquire);
+		if(RN_EXPECT_TRUE((generation & 1) == 0))
+		{
+			const uint32 index = _classIndex.load(std::memory_order_relaxed);
+			const bool result = (index >= other->_classIndex.load(std::memory_order_relaxed) && index <= other->_lastSubclassIndex.load(std::memory_order_relaxed));
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if(RN_EXPECT_TRUE(__classRangeGeneration.load(std::memory_order_relaxed) == generation))
+				return result;
+		}
+
+		return InheritsFromClassSlow(other);
 	}
-	
-	std::string MetaClass::GetFullname() const
+
+	bool MetaClass::InheritsFromClassSlow(const MetaClass *other) const
 	{
-		std::string name;
+		if(this == other)
+			return true;
 		
-		for(auto i=_namespace.begin(); i!=_namespace.end(); i++)
-		{
-			name += *i;
-			name += "::";
-		}
+		if(!_superClass)
+			return false;
 		
-		name += _name;
-		return name;
+		return _superClass->InheritsFromClassSlow(other);
 	}
 	
 	
 	
 	static Catalogue *__sharedInstance = nullptr;
 
-	Catalogue::Catalogue()
+	Catalogue::Catalogue() :
+		_classCount(0)
 	{}
 	Catalogue::~Catalogue()
 	{
@@ -112,20 +134,33 @@ namespace RN
 	
 	MetaClass *Catalogue::GetClassWithName(const std::string &name) const
 	{
-		auto iterator = _metaClasses.find(name);
-		if(iterator != _metaClasses.end())
-			return iterator->second;
+		if(_classTable.empty())
+			return nullptr;
+
+		const size_t hash = std::hash<std::string>()(name);
+		const size_t mask = _classTable.size() - 1;
+
+		for(size_t index = hash & mask; _classTable[index].meta; index = (index + 1) & mask)
+		{
+			const Entry &entry = _classTable[index];
+
+			if(entry.hash == hash && entry.meta->_fullname == name)
+				return entry.meta;
+		}
 		
-		return 0;
+		return nullptr;
 	}
 	
 	void Catalogue::EnumerateClasses(const std::function<void (MetaClass *meta, bool &stop)>& enumerator)
 	{
 		bool stop = false;
 		
-		for(auto i=_metaClasses.begin(); i!=_metaClasses.end(); i++)
+		for(const Entry &entry : _classTable)
 		{
-			enumerator(i->second, stop);
+			if(!entry.meta)
+				continue;
+
+			enumerator(entry.meta, stop);
 			if(stop)
 				break;
 		}
@@ -150,6 +185,9 @@ namespace RN
 			__pendingClasses[i].getter = reinterpret_cast<__ClassGetMetaClass>(__pendingClasses[i].init());
 			__pendingClasses[i].meta = __pendingClasses[i].getter();
 		}
+
+		__deferClassRanges = false;
+		UpdateClassRanges();
 	}
 
 	void Catalogue::DoClassesPreFlight()
@@ -170,19 +208,132 @@ namespace RN
 	
 	void Catalogue::AddMetaClass(MetaClass *meta)
 	{
-		auto iterator = _metaClasses.find(meta->GetFullname());
-		if(iterator != _metaClasses.end())
+		if(GetClassWithName(meta->_fullname))
 			throw InvalidArgumentException(RNSTR("A MetaClass of the same name '" << meta->GetFullname() << "' already exists!"));
 
 		if(!_modules.empty())
 			meta->_module = _modules.back();
 
-		_metaClasses.insert(std::unordered_map<std::string, MetaClass *>::value_type(meta->GetFullname(), meta));
+		if((_classCount + 1) * 2 > _classTable.size())
+			GrowClassTable();
+
+		InsertClass(std::hash<std::string>()(meta->_fullname), meta);
+
+		if(!__deferClassRanges)
+			UpdateClassRanges();
 	}
 	
 	void Catalogue::RemoveMetaClass(MetaClass *meta)
 	{
-		_metaClasses.erase(meta->GetFullname());
+		if(_classTable.empty())
+			return;
+
+		const size_t mask = _classTable.size() - 1;
+		size_t index = std::hash<std::string>()(meta->_fullname) & mask;
+
+		while(_classTable[index].meta != meta)
+		{
+			if(!_classTable[index].meta)
+				return;
+
+			index = (index + 1) & mask;
+		}
+
+		// Shift the following entries of the probe sequence back into the hole, so lookups don't need tombstones
+		size_t hole = index;
+		for(size_t next = (hole + 1) & mask; _classTable[next].meta; next = (next + 1) & mask)
+		{
+			const size_t home = _classTable[next].hash & mask;
+
+			if(((next - home) & mask) >= ((next - hole) & mask))
+			{
+				_classTable[hole] = _classTable[next];
+				hole = next;
+			}
+		}
+
+		_classTable[hole].meta = nullptr;
+		_classCount --;
+
+		if(!__deferClassRanges)
+			UpdateClassRanges();
+	}
+
+	void Catalogue::InsertClass(size_t hash, MetaClass *meta)
+	{
+		const size_t mask = _classTable.size() - 1;
+		size_t index = hash & mask;
+
+		while(_classTable[index].meta)
+			index = (index + 1) & mask;
+
+		_classTable[index].hash = hash;
+		_classTable[index].meta = meta;
+		_classCount ++;
+	}
+
+	void Catalogue::GrowClassTable()
+	{
+		std::vector<Entry> table(std::max(_classTable.size() * 2, static_cast<size_t>(kPendingMetaClassSize)), Entry{ 0, nullptr });
+		std::swap(table, _classTable);
+
+		_classCount = 0;
+
+		for(const Entry &entry : table)
+		{
+			if(entry.meta)
+				InsertClass(entry.hash, entry.meta);
+		}
+	}
+
+	void Catalogue::UpdateClassRanges()
+	{
+		std::unordered_map<const MetaClass *, std::vector<MetaClass *>> subclasses;
+		std::vector<MetaClass *> stack;
+
+		for(const Entry &entry : _classTable)
+		{
+			if(!entry.meta)
+				continue;
+
+			if(entry.meta->_superClass)
+				subclasses[entry.meta->_superClass].push_back(entry.meta);
+			else
+				stack.push_back(entry.meta);
+		}
+
+		const uint32 generation = __classRangeGeneration.load(std::memory_order_relaxed) | 1;
+
+		__classRangeGeneration.store(generation, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		// Pre-order walk, a class is assigned its last subclass index once its whole subtree is numbered
+		std::vector<MetaClass *> open;
+		uint32 index = 0;
+
+		while(!stack.empty())
+		{
+			MetaClass *meta = stack.back();
+			stack.pop_back();
+
+			if(!meta)
+			{
+				open.back()->_lastSubclassIndex.store(index - 1, std::memory_order_relaxed);
+				open.pop_back();
+				continue;
+			}
+
+			meta->_classIndex.store(index ++, std::memory_order_relaxed);
+
+			open.push_back(meta);
+			stack.push_back(nullptr);
+
+			auto iterator = subclasses.find(meta);
+			if(iterator != subclasses.end())
+				stack.insert(stack.end(), iterator->second.begin(), iterator->second.end());
+		}
+
+		__classRangeGeneration.store(generation + 1, std::memory_order_release);
 	}
 	
 	void Catalogue::ParsePrettyFunction(const char *string, std::vector<std::string>& namespaces)
@@ -26,7 +26,7 @@ namespace RN
 		Module *GetModule() const { return _module; }
 		MetaClass *GetSuperClass() const { return _superClass; }
 		std::string GetName() const { return _name; }
-		RNAPI std::string GetFullname() const;
+		const std::string &GetFullname() const { return _fullname; }
 		
 		virtual Object *Construct() { throw InconsistencyException("Construct() called but not provided"); }
 		virtual Object *ConstructWithDeserializer(Deserializer *deserializer) { throw InconsistencyException("ConstructWithDeserializer() called but not provided"); }
@@ -36,6 +36,7 @@ namespace RN
 		virtual bool SupportsSerialization() const { return false; }
 		virtual bool SupportsCopying() const { return false; }
 		
+		// Compares the class ranges assigned by the Catalogue, falls back to walking the super classes while they are rebuilt
 		RNAPI bool InheritsFromClass(const MetaClass *other) const;
 	
 	protected:
@@ -44,10 +45,17 @@ namespace RN
 		RNAPI ~MetaClass();
 		
 	private:
+		bool InheritsFromClassSlow(const MetaClass *other) const;
+
 		Module *_module;
 		MetaClass *_superClass;
 		std::string _name;
+		std::string _fullname;
 		std::vector<std::string> _namespace;
+
+		// Pre-order index of the class and the highest index of all of its subclasses
+		std::atomic<uint32> _classIndex;
+		std::atomic<uint32> _lastSubclassIndex;
 	};
 	
 	template<class T>
@@ -125,12 +133,23 @@ namespace RN
 		void AddMetaClass(MetaClass *meta);
 		void RemoveMetaClass(MetaClass *meta);
 
+		void InsertClass(size_t hash, MetaClass *meta);
+		void GrowClassTable();
+		void UpdateClassRanges();
+
 		void PushModule(Module *module);
 		void PopModule();
 		
 		static void ParsePrettyFunction(const char *string, std::vector<std::string>& namespaces);
 
-		std::unordered_map<std::string, MetaClass *> _metaClasses;
+		struct Entry
+		{
+			size_t hash;
+			MetaClass *meta;
+		};
+
+		std::vector<Entry> _classTable; // Open addressed by the hash of the full name, the size is a power of two
+		size_t _classCount;
 		std::vector<Module *> _modules;
 	};
 
@@ -19,48 +19,32 @@ namespace RN
 	class CountedSetInternal
 	{
 	public:
-		struct Bucket
+		struct Entry
 		{
-			Bucket()
-			{
-				object = nullptr;
-				next   = nullptr;
-				count  = 0;
-			}
-			
-			Bucket(const Bucket *other)
+			bool WrapsLookup(const Object *lookup) const
 			{
-				object = SafeRetain(other->object);
-				next   = nullptr;
-				count  = other->count;
+				return (object == lookup || object->IsEqual(lookup));
 			}
-			
-			~Bucket()
+
+			// The object is retained once per time it was added
+			void Retain()
 			{
 				for(size_t i = 0; i < count; i ++)
-				{
-					SafeRelease(object);
-				}
+					object->Retain();
 			}
-			
-			
-			size_t GetHash() const
-			{
-				return object->GetHash();
-			}
-			
-			bool WrapsLookup(const Object *lookup) const
+
+			void Release()
 			{
-				return (object && object->IsEqual(lookup));
+				for(size_t i = 0; i < count; i ++)
+					object->Release();
 			}
 			
-			
+			size_t hash;
 			Object *object;
-			Bucket *next;
 			size_t count;
 		};
 		
-		HashTableCore<Bucket> hashTable;
+		HashTableCore<Entry> hashTable;
 	};
 	
 	
@@ -122,7 +106,7 @@ namespace RN
 
 	const String *CountedSet::GetDescription() const
 	{
-		if(_internals->hashTable._count == 0)
+		if(_internals->hashTable.GetCount() == 0)
 			return RNCSTR("[]");
 
 		String *result = String::WithString("[\n", false);
@@ -142,17 +126,9 @@ namespace RN
 	{
 		Array *array = new Array(GetCount());
 		
-		for(size_t i = 0; i < _internals->hashTable._capacity; i++)
-		{
-			CountedSetInternal::Bucket *bucket = _internals->hashTable._buckets[i];
-			while(bucket)
-			{
-				if(bucket->object)
-					array->AddObject(bucket->object);
-				
-				bucket = bucket->next;
-			}
-		}
+		_internals->hashTable.Enumerate([&](const CountedSetInternal::Entry &entry, bool &stop) {
+			array->AddObject(entry.object);
+		});
 		
 		return array->Autorelease();
 	}
@@ -167,28 +143,23 @@ namespace RN
 		if(GetCount() != otherSet->GetCount())
 			return false;
 
-		for(size_t i = 0; i < _internals->hashTable._capacity; i ++)
-		{
-			CountedSetInternal::Bucket *bucket = _internals->hashTable._buckets[i];
-			while(bucket)
-			{
-				if(bucket->object)
-				{
-					size_t count = otherSet->GetCountForObject(bucket->object);
+		bool result = true;
 
-					if(count != bucket->count)
-						return false;
-				}
+		_internals->hashTable.Enumerate([&](const CountedSetInternal::Entry &entry, bool &stop) {
 
-				bucket = bucket->next;
+			if(otherSet->GetCountForObject(entry.object) != entry.count)
+			{
+				result = false;
+				stop = true;
 			}
-		}
 
-		return true;
+		});
+
+		return result;
 	}
 	size_t CountedSet::GetHash() const
 	{
-		return std::hash<size_t>{}(_internals->hashTable._count);
+		return std::hash<size_t>{}(_internals->hashTable.GetCount());
 	}
 
 
@@ -196,50 +167,47 @@ namespace RN
 	void CountedSet::AddObject(Object *object)
 	{
 		bool created;
-		CountedSetInternal::Bucket *bucket = _internals->hashTable.FindBucket(object, created);
-		
-		if(bucket)
-		{
-			bucket->count ++;
-			bucket->object = object->Retain();
-			
-			if(created)
-				_internals->hashTable.GrowIfPossible();
-		}
+		CountedSetInternal::Entry *entry = _internals->hashTable.FindEntry(object, created);
+
+		if(created)
+			entry->object = object;
+
+		entry->object->Retain();
+		entry->count ++;
 	}
 	
 	void CountedSet::RemoveObject(const Object *key)
 	{
-		CountedSetInternal::Bucket *bucket = _internals->hashTable.FindBucket(key);
-		if(bucket)
+		CountedSetInternal::Entry *entry = _internals->hashTable.FindEntry(key);
+		if(entry)
 		{
-			bucket->object->Release();
-			
-			if((-- bucket->count) == 0)
+			if(entry->count == 1)
 			{
-				bucket->object = nullptr;
-				
-				_internals->hashTable.ResignBucket(bucket);
+				_internals->hashTable.RemoveEntry(entry);
 				_internals->hashTable.CollapseIfPossible();
+
+				return;
 			}
+
+			entry->object->Release();
+			entry->count --;
 		}
 	}
 	
 	void CountedSet::RemoveAllObjects()
 	{
-		_internals->hashTable.RemoveAllBuckets();
+		_internals->hashTable.RemoveAllEntries();
 	}
 	
 	bool CountedSet::ContainsObject(const Object *object) const
 	{
-		CountedSetInternal::Bucket *bucket = _internals->hashTable.FindBucket(object);
-		return (bucket != nullptr);
+		return _internals->hashTable.ContainsObject(object);
 	}
 	
 	size_t CountedSet::GetCountForObject(const Object *object) const
 	{
-		CountedSetInternal::Bucket *bucket = _internals->hashTable.FindBucket(object);
-		return bucket ? bucket->count : 0;
+		CountedSetInternal::Entry *entry = _internals->hashTable.FindEntry(object);
+		return entry ? entry->count : 0;
 	}
 	
 	size_t CountedSet::GetCount() const
@@ -250,24 +218,9 @@ namespace RN
 	
 	void CountedSet::Enumerate(const std::function<void (Object *, size_t count, bool &)>& callback) const
 	{
-		bool stop = false;
-		
-		for(size_t i = 0; i < _internals->hashTable._capacity; i ++)
-		{
-			CountedSetInternal::Bucket *bucket = _internals->hashTable._buckets[i];
-			while(bucket)
-			{
-				if(bucket->object)
-				{
-					callback(bucket->object, bucket->count, stop);
-					
-					if(stop)
-						return;
-				}
-				
-				bucket = bucket->next;
-			}
-		}
+		_internals->hashTable.Enumerate([&](const CountedSetInternal::Entry &entry, bool &stop) {
+			callback(entry.object, entry.count, stop);
+		});
 	}
 }
 
@@ -36,6 +36,7 @@ namespace RN
 		_bytes = (uint8 *)malloc(_allocated);
 		
 		_ownsData = _freeData = true;
+		_owner = nullptr;
 	}
 
 	Data::Data(size_t length) :
@@ -48,7 +49,8 @@ namespace RN
 	{
 	}
 	
-	Data::Data(const void *bytes, size_t length, bool noCopy, bool deleteWhenDone)
+	Data::Data(const void *bytes, size_t length, bool noCopy, bool deleteWhenDone) :
+		_owner(nullptr)
 	{
 		if(noCopy)
 		{
@@ -66,7 +68,17 @@ namespace RN
 	}
 
 	
-	Data::Data(const Data *other)
+	Data::Data(const void *bytes, size_t length, Object *owner) :
+		_bytes(const_cast<uint8 *>(static_cast<const uint8 *>(bytes))),
+		_length(length),
+		_allocated(0),
+		_freeData(false),
+		_ownsData(false),
+		_owner(SafeRetain(owner))
+	{}
+
+	Data::Data(const Data *other) :
+		_owner(nullptr)
 	{
 		Initialize(other->_bytes, other->_length);
 	}
@@ -75,11 +87,14 @@ namespace RN
 	{
 		if(_freeData)
 			free(_bytes);
+
+		SafeRelease(_owner);
 	}
 	
 	
 	
-	Data::Data(Deserializer *deserializer)
+	Data::Data(Deserializer *deserializer) :
+		_owner(nullptr)
 	{
 		uint8 *data = static_cast<uint8 *>(deserializer->DecodeBytes(&_length));
 		
@@ -171,6 +186,9 @@ namespace RN
 	{
 		if(range.origin + range.length > _length)
 			throw RangeException("range is not within the datas bounds!");
+
+		if(_owner)
+			throw InconsistencyException("The Data object is a read only view and can't be modified!");
 		
 		const uint8 *data = static_cast<const uint8 *>(bytes);
 		std::copy(data, data + range.length, _bytes + range.origin);
@@ -22,6 +22,7 @@ namespace RN
 		RNAPI Data(size_t length);
 		RNAPI Data(const void *bytes, size_t length);
 		RNAPI Data(const void *bytes, size_t length, bool noCopy, bool deleteWhenDone);
+		RNAPI Data(const void *bytes, size_t length, Object *owner); // Read only view into memory kept alive by owner
 		RNAPI Data(const Data *other);
 		RNAPI Data(Deserializer *deserializer);
 		RNAPI ~Data() override;
@@ -58,6 +59,8 @@ namespace RN
 		
 		bool _freeData;
 		bool _ownsData;
+
+		Object *_owner;
 		
 		__RNDeclareMetaInternal(Data)
 	};
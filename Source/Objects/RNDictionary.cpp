@@ -19,46 +19,31 @@ namespace RN
 	class DictionaryInternal
 	{
 	public:
-		struct Bucket
+		struct Entry
 		{
-			Bucket()
-			{
-				key    = nullptr;
-				object = nullptr;
-				next   = nullptr;
-			}
-			
-			Bucket(const Bucket *other)
-			{
-				key    = SafeRetain(other->key);
-				object = SafeRetain(other->object);
-				
-				next = nullptr;
-			}
-			
-			~Bucket()
+			bool WrapsLookup(const Object *lookup) const
 			{
-				SafeRelease(key);
-				SafeRelease(object);
+				return (key == lookup || key->IsEqual(lookup));
 			}
-			
-			bool WrapsLookup(const Object *lookup) const
+
+			void Retain()
 			{
-				return (key && key->IsEqual(lookup));
+				key->Retain();
+				object->Retain();
 			}
-			
-			size_t GetHash() const
+
+			void Release()
 			{
-				return key->GetHash();
+				key->Release();
+				object->Release();
 			}
 			
+			size_t hash;
 			const Object *key;
 			Object *object;
-			
-			Bucket *next;
 		};
 		
-		HashTableCore<Bucket> hashTable;
+		HashTableCore<Entry> hashTable;
 	};
 
 	
@@ -110,7 +95,7 @@ namespace RN
 
 	const String *Dictionary::GetDescription() const
 	{
-		if(_internals->hashTable._count == 0)
+		if(_internals->hashTable.GetCount() == 0)
 			return RNCSTR("[]");
 
 		String *result = String::WithString("[\n", false);
@@ -142,64 +127,43 @@ namespace RN
 		if(GetCount() != other->GetCount())
 			return false;
 		
-		for(size_t i = 0; i < _internals->hashTable._capacity; i ++)
-		{
-			DictionaryInternal::Bucket *bucket = _internals->hashTable._buckets[i];
-			while(bucket)
+		bool result = true;
+
+		_internals->hashTable.Enumerate([&](const DictionaryInternal::Entry &entry, bool &stop) {
+
+			DictionaryInternal::Entry *otherEntry = other->_internals->hashTable.FindEntry(entry.key);
+
+			if(!otherEntry || !entry.object->IsEqual(otherEntry->object))
 			{
-				if(bucket->key)
-				{
-					DictionaryInternal::Bucket *otherBucket = other->_internals->hashTable.FindBucket(bucket->key);
-					if(!otherBucket)
-						return false;
-					
-					if(!bucket->object->IsEqual(otherBucket->object))
-						return false;
-				}
-				
-				bucket = bucket->next;
+				result = false;
+				stop = true;
 			}
-		}
+
+		});
 		
-		return true;
+		return result;
 	}
 
 
 	
 	Array *Dictionary::GetAllObjects() const
 	{
-		Array *array = new Array(_internals->hashTable._count);
+		Array *array = new Array(_internals->hashTable.GetCount());
 		
-		for(size_t i=0; i<_internals->hashTable._capacity; i++)
-		{
-			DictionaryInternal::Bucket *bucket = _internals->hashTable._buckets[i];
-			while(bucket)
-			{
-				if(bucket->object)
-					array->AddObject(bucket->object);
-				
-				bucket = bucket->next;
-			}
-		}
+		_internals->hashTable.Enumerate([&](const DictionaryInternal::Entry &entry, bool &stop) {
+			array->AddObject(entry.object);
+		});
 		
 		return array->Autorelease();
 	}
 	
 	Array *Dictionary::GetAllKeys() const
 	{
-		Array *array = new Array(_internals->hashTable._count);
+		Array *array = new Array(_internals->hashTable.GetCount());
 		
-		for(size_t i = 0; i < _internals->hashTable._capacity; i++)
-		{
-			DictionaryInternal::Bucket *bucket = _internals->hashTable._buckets[i];
-			while(bucket)
-			{
-				if(bucket->key)
-					array->AddObject(const_cast<Object *>(bucket->key));
-				
-				bucket = bucket->next;
-			}
-		}
+		_internals->hashTable.Enumerate([&](const DictionaryInternal::Entry &entry, bool &stop) {
+			array->AddObject(const_cast<Object *>(entry.key));
+		});
 		
 		return array->Autorelease();
 	}
@@ -212,82 +176,54 @@ namespace RN
 	
 	Object *Dictionary::GetPrimitiveObjectForKey(const Object *key) const
 	{
-		DictionaryInternal::Bucket *bucket = _internals->hashTable.FindBucket(key);
-		return bucket ? bucket->object : nullptr;
+		DictionaryInternal::Entry *entry = _internals->hashTable.FindEntry(key);
+		return entry ? entry->object : nullptr;
 	}
 	
 	void Dictionary::AddEntriesFromDictionary(const Dictionary *other)
 	{
-		for(size_t i = 0; i < other->_internals->hashTable._capacity; i ++)
-		{
-			DictionaryInternal::Bucket *bucket = other->_internals->hashTable._buckets[i];
-			while(bucket)
-			{
-				if(bucket->object)
-					SetObjectForKey(bucket->object, bucket->key);
-				
-				bucket = bucket->next;
-			}
-		}
+		other->_internals->hashTable.Enumerate([&](const DictionaryInternal::Entry &entry, bool &stop) {
+			SetObjectForKey(entry.object, entry.key);
+		});
 	}
 	
 	void Dictionary::SetObjectForKey(Object *object, const Object *key)
 	{
 		bool created;
-		DictionaryInternal::Bucket *bucket = _internals->hashTable.FindBucket(key, created);
+		DictionaryInternal::Entry *entry = _internals->hashTable.FindEntry(key, created);
+
+		// Retain first, the entry might already hold the very same objects
+		key->Retain();
+		object->Retain();
 		
-		if(bucket)
-		{
-			SafeRelease(bucket->object);
-			SafeRelease(bucket->key);
-			
-			bucket->key = key->Retain();
-			bucket->object = object->Retain();
-			
-			if(created)
-				_internals->hashTable.GrowIfPossible();
-		}
+		if(!created)
+			entry->Release();
+
+		entry->key = key;
+		entry->object = object;
 	}
 	
 	void Dictionary::RemoveObjectForKey(const Object *key)
 	{
-		DictionaryInternal::Bucket *bucket = _internals->hashTable.FindBucket(key);
+		DictionaryInternal::Entry *entry = _internals->hashTable.FindEntry(key);
 		
-		if(bucket)
+		if(entry)
 		{
-			SafeRelease(bucket->key);
-			SafeRelease(bucket->object);
-			
-			_internals->hashTable.ResignBucket(bucket);
+			_internals->hashTable.RemoveEntry(entry);
 			_internals->hashTable.CollapseIfPossible();
 		}
 	}
 	
 	void Dictionary::RemoveAllObjects()
 	{
-		_internals->hashTable.RemoveAllBuckets();
+		_internals->hashTable.RemoveAllEntries();
 	}
 	
 	void Dictionary::Enumerate(const std::function<void (Object *, const Object *, bool &)>& callback) const
 	{
-		bool stop = false;
-
-		for(size_t i = 0; i < _internals->hashTable._capacity; i ++)
-		{
-			DictionaryInternal::Bucket *bucket = _internals->hashTable._buckets[i];
-			while(bucket)
-			{
-				if(bucket->key)
-				{
-					callback(bucket->object, bucket->key, stop);
-					
-					if(stop)
-						return;
-				}
-				
-				bucket = bucket->next;
-			}
-		}
+		_internals->hashTable.Enumerate([&](const DictionaryInternal::Entry &entry, bool &stop) {
+			callback(entry.object, entry.key, stop);
+		});
 	}
 	
 	
@@ -10,276 +10,440 @@
 #define __RAYNE_HASHTABLEINTERNAL_H__
 
 #include "../Base/RNBase.h"
+#include "../Base/RNMemory.h"
+#include <algorithm>
+#include <cstring>
+
+#if RN_PLATFORM_INTEL
+	#include <emmintrin.h>
+#elif RN_PLATFORM_ARM
+	#include <arm_neon.h>
+#endif
+
+#if RN_COMPILER_MSVC
+	#include <intrin.h>
+#endif
+
+#define kRNHashTableGroupSize 16
 
 namespace RN
 {
-	static const size_t kHashTableCapacity[] =
+	/**
+	 * Open addressing table in the style of Swiss tables. Every slot has a control byte, which is either empty,
+	 * deleted, or holds 7 bits of the hash of the entry in it. Slots are probed a group of 16 at a time by comparing
+	 * all control bytes of the group at once, so IsEqual() is only called for entries whose hash matched, and a lookup
+	 * ends at the first group that still has an empty slot. Groups are probed in triangular order, which visits every
+	 * group since their count is a power of two.
+	 *
+	 * Entries are plain structs stored inline and moved around with memcpy. They have to provide a `hash` member,
+	 * which caches the mixed hash of the object so growing the table never calls GetHash() again, as well as
+	 * WrapsLookup(), Retain() and Release(). The table retains and releases them when copying and removing entries,
+	 * filling in a created entry is up to the caller.
+	 **/
+
+	static constexpr int8 kHashTableControlEmpty = -128;
+	static constexpr int8 kHashTableControlDeleted = -2;
+
+	alignas(kRNHashTableGroupSize) static const int8 kHashTableEmptyGroup[kRNHashTableGroupSize] =
 	{
-		3, 7, 13, 23, 41, 71, 127, 191, 251, 383, 631, 1087, 1723,
-		2803, 4523, 7351, 11959, 19447, 31231, 50683, 81919, 132607,
-		214519, 346607, 561109, 907759, 1468927, 2376191, 3845119,
-		6221311, 10066421, 16287743, 26354171, 42641881, 68996069,
-		111638519, 180634607, 292272623, 472907251,
-		765180413UL, 1238087663UL, 2003267557UL, 3241355263UL, 5244622819UL,
+		kHashTableControlEmpty, kHashTableControlEmpty, kHashTableControlEmpty, kHashTableControlEmpty,
+		kHashTableControlEmpty, kHashTableControlEmpty, kHashTableControlEmpty, kHashTableControlEmpty,
+		kHashTableControlEmpty, kHashTableControlEmpty, kHashTableControlEmpty, kHashTableControlEmpty,
+		kHashTableControlEmpty, kHashTableControlEmpty, kHashTableControlEmpty, kHashTableControlEmpty
 	};
-	
-	static const size_t kHashTableMaxCount[] =
+
+	RN_INLINE uint32 __HashTableLowestBit(uint64 mask)
 	{
-		3, 6, 11, 19, 32, 52, 85, 118, 155, 237, 390, 672, 1065,
-		1732, 2795, 4543, 7391, 12019, 19302, 31324, 50629, 81956,
-		132580, 214215, 346784, 561026, 907847, 1468567, 2376414,
-		3844982, 6221390, 10066379, 16287773, 26354132, 42641916,
-		68996399, 111638327, 180634415, 292272755,
-		472907503UL, 765180257UL, 1238087439UL, 2003267722UL, 3241355160UL,
+#if RN_COMPILER_MSVC
+		unsigned long index;
+		_BitScanForward64(&index, mask);
+		return static_cast<uint32>(index);
+#else
+		return static_cast<uint32>(__builtin_ctzll(mask));
+#endif
+	}
+
+	// Bit masks over the slots of a group. NEON has no movemask, so there every slot gets 4 bits instead of one
+	struct __HashTableGroup
+	{
+#if RN_PLATFORM_INTEL
+		static constexpr uint32 kSlotShift = 0;
+
+		__HashTableGroup(const int8 *control) :
+			control(_mm_load_si128(reinterpret_cast<const __m128i *>(control)))
+		{}
+
+		uint64 Match(int8 hash) const { return static_cast<uint64>(_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(hash)))); }
+		uint64 MatchEmpty() const { return static_cast<uint64>(_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(kHashTableControlEmpty)))); }
+		uint64 MatchEmptyOrDeleted() const { return static_cast<uint64>(_mm_movemask_epi8(_mm_cmplt_epi8(control, _mm_set1_epi8(-1)))); }
+
+		__m128i control;
+#elif RN_PLATFORM_ARM
+		static constexpr uint32 kSlotShift = 2;
+
+		__HashTableGroup(const int8 *control) :
+			control(vld1q_s8(control))
+		{}
+
+		uint64 Match(int8 hash) const { return ToMask(vceqq_s8(control, vdupq_n_s8(hash))); }
+		uint64 MatchEmpty() const { return ToMask(vceqq_s8(control, vdupq_n_s8(kHashTableControlEmpty))); }
+		uint64 MatchEmptyOrDeleted() const { return ToMask(vcltq_s8(control, vdupq_n_s8(-1))); }
+
+		static uint64 ToMask(uint8x16_t matches)
+		{
+			const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+			return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ULL;
+		}
+
+		int8x16_t control;
+#else
+		static constexpr uint32 kSlotShift = 0;
+
+		__HashTableGroup(const int8 *tcontrol) :
+			control(tcontrol)
+		{}
+
+		uint64 Match(int8 hash) const
+		{
+			uint64 mask = 0;
+			for(uint32 i = 0; i < kRNHashTableGroupSize; i ++)
+				mask |= static_cast<uint64>(control[i] == hash) << i;
+
+			return mask;
+		}
+		uint64 MatchEmpty() const { return Match(kHashTableControlEmpty); }
+		uint64 MatchEmptyOrDeleted() const
+		{
+			uint64 mask = 0;
+			for(uint32 i = 0; i < kRNHashTableGroupSize; i ++)
+				mask |= static_cast<uint64>(control[i] < -1) << i;
+
+			return mask;
+		}
+
+		const int8 *control;
+#endif
+
+		static uint32 GetSlot(uint64 mask) { return __HashTableLowestBit(mask) >> kSlotShift; }
 	};
 
-	#define kRNHashTablePrimitiveCount (sizeof(kHashTableCapacity) / sizeof(size_t))
 
-	
-	template<class Bucket>
+	template<class Entry>
 	class HashTableCore
 	{
 	public:
-		HashTableCore()
-		{}
-		
+		HashTableCore() :
+			_control(const_cast<int8 *>(kHashTableEmptyGroup)),
+			_entries(nullptr),
+			_groupMask(0),
+			_capacity(0),
+			_count(0),
+			_deleted(0)
+		{
+			static_assert(std::is_trivially_copyable<Entry>::value, "Hash table entries are moved with memcpy");
+		}
+
 		~HashTableCore()
 		{
-			for(size_t i = 0; i < _capacity; i ++)
-			{
-				Bucket *bucket = _buckets[i];
-				while(bucket)
-				{
-					Bucket *next = bucket->next;
-					delete bucket;
-					
-					bucket = next;
-				}
-			}
-			
-			delete [] _buckets;
+			Clear();
 		}
-		
+
 		void Initialize(size_t capacity)
 		{
-			size_t primitive = 0;
-			
-			for(size_t i = 0; i < kRNHashTablePrimitiveCount; i ++)
-			{
-				if(kHashTableCapacity[i] > capacity || i == kRNHashTablePrimitiveCount - 1)
-				{
-					primitive = i;
-					break;
-				}
-			}
-			
-			_primitive = primitive;
-			_capacity  = kHashTableCapacity[_primitive];
-			_count     = 0;
-			
-			_buckets = new Bucket *[_capacity];
-			std::fill(_buckets, _buckets + _capacity, nullptr);
+			Clear();
+
+			if(capacity > 0)
+				Rehash(GetGroupCountForCapacity(capacity));
 		}
-		
+
 		void Initialize(const HashTableCore &other)
 		{
-			_primitive = other._primitive;
-			_capacity  = other._capacity;
-			_count     = other._count;
-			
-			_buckets = new Bucket *[_capacity];
-			
-			for(size_t i = 0; i < _capacity; i ++)
-			{
-				Bucket *temp = nullptr;
-				Bucket *bucket = other._buckets[i];
-				
-				while(bucket)
-				{
-					if(bucket->object)
-					{
-						Bucket *copy = new Bucket(bucket);
-
-						copy->next = temp;
-						temp = copy;
-					}
-					
-					bucket = bucket->next;
-				}
-				
-				_buckets[i] = temp;
-			}
+			Clear();
+
+			if(other._capacity == 0)
+				return;
+
+			Allocate(other._groupMask + 1);
+
+			std::copy(other._control, other._control + _capacity, _control);
+			std::memcpy(static_cast<void *>(_entries), other._entries, _capacity * sizeof(Entry));
+
+			_count = other._count;
+			_deleted = other._deleted;
+
+			Enumerate([](Entry &entry, bool &stop) {
+				entry.Retain();
+			});
 		}
-		
-		
-		
-		
-		Bucket *FindBucket(const Object *object) const
+
+
+		Entry *FindEntry(const Object *object) const
 		{
-			size_t hash = object->GetHash();
-			size_t index = hash % _capacity;
-			
-			Bucket *bucket = _buckets[index];
-			while(bucket)
+			const size_t hash = MixHash(object->GetHash());
+			const int8 tag = GetTag(hash);
+
+			size_t group = GetGroup(hash);
+
+			for(size_t probe = 1;; probe ++)
 			{
-				if(bucket->WrapsLookup(object))
-					return bucket;
-				
-				bucket = bucket->next;
+				const __HashTableGroup control(_control + group * kRNHashTableGroupSize);
+
+				for(uint64 mask = control.Match(tag); mask; mask &= mask - 1)
+				{
+					Entry *entry = _entries + group * kRNHashTableGroupSize + __HashTableGroup::GetSlot(mask);
+
+					if(entry->hash == hash && entry->WrapsLookup(object))
+						return entry;
+				}
+
+				if(RN_EXPECT_TRUE(control.MatchEmpty() != 0))
+					return nullptr;
+
+				group = (group + probe) & _groupMask;
 			}
-			
-			return bucket;
 		}
-		
-		Bucket *FindBucket(const Object *object, bool &created)
+
+		// Returns the existing entry for the object, or a zeroed entry with only its hash filled in
+		Entry *FindEntry(const Object *object, bool &created)
 		{
-			size_t hash = object->GetHash();
-			size_t index = hash % _capacity;
-			
-			Bucket *bucket = _buckets[index];
-			Bucket *empty  = nullptr;
-			
+			const size_t hash = MixHash(object->GetHash());
+			const int8 tag = GetTag(hash);
+
+			size_t group = GetGroup(hash);
+			size_t insert = kNotFound;
+
 			created = false;
-			
-			while(bucket)
+
+			for(size_t probe = 1;; probe ++)
 			{
-				if(bucket->WrapsLookup(object))
-					return bucket;
-				
-				if(!bucket->object)
-					empty = bucket;
-				
-				bucket = bucket->next;
+				const __HashTableGroup control(_control + group * kRNHashTableGroupSize);
+
+				for(uint64 mask = control.Match(tag); mask; mask &= mask - 1)
+				{
+					Entry *entry = _entries + group * kRNHashTableGroupSize + __HashTableGroup::GetSlot(mask);
+
+					if(entry->hash == hash && entry->WrapsLookup(object))
+						return entry;
+				}
+
+				// Deleted slots along the way can be reused, but the object might still be further down the sequence
+				if(insert == kNotFound)
+				{
+					const uint64 free = control.MatchEmptyOrDeleted();
+					if(free)
+						insert = group * kRNHashTableGroupSize + __HashTableGroup::GetSlot(free);
+				}
+
+				if(RN_EXPECT_TRUE(control.MatchEmpty() != 0))
+					break;
+
+				group = (group + probe) & _groupMask;
 			}
-			
+
 			created = true;
-			
-			if(empty)
+
+			// Reusing a deleted slot doesn't make the probe sequences any longer, only taking an empty one has to respect the load factor
+			if(insert == kNotFound || (_control[insert] == kHashTableControlEmpty && _count + _deleted >= GetMaxCount()))
 			{
-				_count ++;
-				return empty;
+				if(_capacity == 0)
+					Rehash(1);
+				else if(_count >= GetMaxCount() / 2)
+					Rehash((_groupMask + 1) * 2);
+				else
+					Rehash(_groupMask + 1); // Plenty of tombstones, cleaning them out is enough
+
+				insert = FindInsertSlot(hash);
 			}
-			
-			bucket = new Bucket();
-			bucket->next = _buckets[index];
-			
-			_buckets[index] = bucket;
+
+			if(_control[insert] == kHashTableControlDeleted)
+				_deleted --;
+
+			_control[insert] = tag;
 			_count ++;
-			
-			return bucket;
-		}
-		
-		bool ContainsObject(const Object *object)
-		{
-			Bucket *bucket = FindBucket(object);
-			return (bucket != nullptr);
+
+			Entry *entry = _entries + insert;
+			std::memset(static_cast<void *>(entry), 0, sizeof(Entry));
+			entry->hash = hash;
+
+			return entry;
 		}
-		
-		
-		void ResignBucket(Bucket *bucket)
+
+		bool ContainsObject(const Object *object) const
 		{
-			bucket->object = nullptr;
-			_count --;
+			return (FindEntry(object) != nullptr);
 		}
-		
-		void Rehash(size_t primitive)
+
+
+		void RemoveEntry(Entry *entry)
 		{
-			size_t cCapacity = _capacity;
-			Bucket **buckets = _buckets;
-			
-			_capacity = kHashTableCapacity[primitive];
-			_buckets  = new Bucket *[_capacity];
-			
-			if(!_buckets)
+			entry->Release();
+
+			const size_t index = static_cast<size_t>(entry - _entries);
+			const size_t group = index & ~static_cast<size_t>(kRNHashTableGroupSize - 1);
+
+			// A group that still has an empty slot was never full, so no probe sequence ever went past it
+			if(__HashTableGroup(_control + group).MatchEmpty())
 			{
-				_buckets  = buckets;
-				_capacity = cCapacity;
-				
-				return;
+				_control[index] = kHashTableControlEmpty;
 			}
-			
-			_primitive = primitive;
-			std::fill(_buckets, _buckets + _capacity, nullptr);
-			
-			for(size_t i = 0; i < cCapacity; i ++)
+			else
 			{
-				Bucket *bucket = buckets[i];
-				while(bucket)
-				{
-					Bucket *next = bucket->next;
-					
-					if(bucket->object)
-					{
-						size_t hash = bucket->GetHash();
-						size_t index = hash % _capacity;
-						
-						bucket->next = _buckets[index];
-						_buckets[index] = bucket;
-					}
-					else
-					{
-						delete bucket;
-					}
-					
-					bucket = next;
-				}
+				_control[index] = kHashTableControlDeleted;
+				_deleted ++;
 			}
-			
-			delete [] buckets;
+
+			_count --;
+		}
+
+		void RemoveAllEntries()
+		{
+			Clear();
+		}
+
+		void CollapseIfPossible()
+		{
+			const size_t groups = _groupMask + 1;
+
+			if(groups > 1 && _count <= _capacity / 4)
+				Rehash(groups / 2);
 		}
-	
-		void RemoveAllBuckets()
+
+		template<class F>
+		void Enumerate(F &&callback) const
 		{
+			bool stop = false;
+
 			for(size_t i = 0; i < _capacity; i ++)
 			{
-				Bucket *bucket = _buckets[i];
-				while(bucket)
+				if(_control[i] >= 0)
 				{
-					Bucket *next = bucket->next;
-					delete bucket;
-					
-					bucket = next;
+					callback(_entries[i], stop);
+
+					if(stop)
+						return;
 				}
 			}
-			
-			delete [] _buckets;
-			
-			_count     = 0;
-			_primitive = 1;
-			_capacity  = kHashTableCapacity[_primitive];
-			
-			_buckets = new Bucket *[_capacity];
-			std::fill(_buckets, _buckets + _capacity, nullptr);
 		}
-		
-		void GrowIfPossible()
+
+		size_t GetCount() const
+		{
+			return _count;
+		}
+
+		size_t GetCapacity() const
+		{
+			return _capacity;
+		}
+
+	private:
+		static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+		static size_t MixHash(size_t hash)
+		{
+			// Object hashes are often pointers or small integers, spread them over all bits first
+			uint64 result = static_cast<uint64>(hash);
+			result ^= result >> 33;
+			result *= 0xff51afd7ed558ccdULL;
+			result ^= result >> 33;
+			result *= 0xc4ceb9fe1a85ec53ULL;
+			result ^= result >> 33;
+
+			return static_cast<size_t>(result);
+		}
+
+		static int8 GetTag(size_t hash) { return static_cast<int8>(hash & 0x7f); }
+		size_t GetGroup(size_t hash) const { return (hash >> 7) & _groupMask; }
+		size_t GetMaxCount() const { return _capacity - _capacity / 8; }
+
+		static size_t GetGroupCountForCapacity(size_t capacity)
+		{
+			size_t groups = 1;
+
+			while((groups * kRNHashTableGroupSize) - (groups * kRNHashTableGroupSize) / 8 < capacity)
+				groups *= 2;
+
+			return groups;
+		}
+
+		size_t FindInsertSlot(size_t hash) const
 		{
-			if(_count >= kHashTableMaxCount[_primitive] && _primitive < kRNHashTablePrimitiveCount)
+			size_t group = GetGroup(hash);
+
+			for(size_t probe = 1;; probe ++)
 			{
-				Rehash(_primitive + 1);
+				const uint64 free = __HashTableGroup(_control + group * kRNHashTableGroupSize).MatchEmptyOrDeleted();
+				if(free)
+					return group * kRNHashTableGroupSize + __HashTableGroup::GetSlot(free);
+
+				group = (group + probe) & _groupMask;
 			}
 		}
-		
-		void CollapseIfPossible()
+
+		void Allocate(size_t groups)
+		{
+			const size_t capacity = groups * kRNHashTableGroupSize;
+			uint8 *memory = static_cast<uint8 *>(Memory::AllocateAligned(capacity + capacity * sizeof(Entry), kRNHashTableGroupSize));
+
+			if(!memory)
+				throw std::bad_alloc();
+
+			_control = reinterpret_cast<int8 *>(memory);
+			_entries = reinterpret_cast<Entry *>(memory + capacity);
+			_groupMask = groups - 1;
+			_capacity = capacity;
+
+			std::fill(_control, _control + capacity, kHashTableControlEmpty);
+		}
+
+		void Rehash(size_t groups)
 		{
-			if(_primitive > 0 && _count <= kHashTableMaxCount[_primitive - 1])
+			int8 *control = _control;
+			Entry *entries = _entries;
+			size_t capacity = _capacity;
+
+			Allocate(groups);
+			_deleted = 0;
+
+			for(size_t i = 0; i < capacity; i ++)
 			{
-				Rehash(_primitive - 1);
+				if(control[i] >= 0)
+				{
+					const size_t slot = FindInsertSlot(entries[i].hash);
+
+					_control[slot] = control[i];
+					std::memcpy(static_cast<void *>(_entries + slot), entries + i, sizeof(Entry));
+				}
 			}
+
+			if(capacity > 0)
+				Memory::FreeAligned(control);
 		}
-		
-		size_t GetCount() const
+
+		void Clear()
 		{
-			return _count;
+			if(_capacity == 0)
+				return;
+
+			Enumerate([](Entry &entry, bool &stop) {
+				entry.Release();
+			});
+
+			Memory::FreeAligned(_control);
+
+			_control = const_cast<int8 *>(kHashTableEmptyGroup);
+			_entries = nullptr;
+			_groupMask = 0;
+			_capacity = 0;
+			_count = 0;
+			_deleted = 0;
 		}
-		
-		
-		Bucket **_buckets;
-		size_t _count;
+
+		int8 *_control;
+		Entry *_entries;
+		size_t _groupMask;
 		size_t _capacity;
-		
-	private:
-		size_t _primitive;
+		size_t _count;
+		size_t _deleted;
 	};
 }
 
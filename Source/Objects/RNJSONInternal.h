@@ -0,0 +1,74 @@
+//
+//  RNJSONInternal.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_JSONINTERNAL_H__
+#define __RAYNE_JSONINTERNAL_H__
+
+#include "../Base/RNBase.h"
+
+#if RN_PLATFORM_INTEL
+	#include <emmintrin.h>
+#endif
+
+#if RN_COMPILER_MSVC
+	#include <intrin.h>
+#endif
+
+namespace RN
+{
+	RN_INLINE uint32 __JSONLowestBit(uint64 mask)
+	{
+#if RN_COMPILER_MSVC
+		unsigned long index;
+		_BitScanForward64(&index, mask);
+		return static_cast<uint32>(index);
+#else
+		return static_cast<uint32>(__builtin_ctzll(mask));
+#endif
+	}
+
+	RN_INLINE bool __JSONIsDigit(char character)
+	{
+		return (static_cast<uint8>(character - '0') < 10);
+	}
+
+	// Finds the next '"', '\' or control character in a string
+	RN_INLINE const char *__JSONScanString(const char *cursor, const char *end)
+	{
+#if RN_PLATFORM_INTEL
+		const __m128i quote = _mm_set1_epi8('"');
+		const __m128i backslash = _mm_set1_epi8('\\');
+		const __m128i control = _mm_set1_epi8(0x1f);
+
+		while(end - cursor >= 16)
+		{
+			__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cursor));
+			__m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+			special = _mm_or_si128(special, _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+
+			uint32 mask = static_cast<uint32>(_mm_movemask_epi8(special));
+			if(mask)
+				return cursor + __JSONLowestBit(mask);
+
+			cursor += 16;
+		}
+#endif
+
+		for(; cursor < end; cursor ++)
+		{
+			uint8 character = static_cast<uint8>(*cursor);
+
+			if(character == '"' || character == '\\' || character < 0x20)
+				return cursor;
+		}
+
+		return end;
+	}
+}
+
+#endif /* __RAYNE_JSONINTERNAL_H__ */
@@ -0,0 +1,845 @@
+//
+//  RNJSONReader.cpp
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "RNJSONReader.h"
+#include "RNJSONInternal.h"
+#include "RNString.h"
+
+namespace RN
+{
+	static constexpr uint8 kJSONContainerObject = 0;
+	static constexpr uint8 kJSONContainerArray = 1;
+
+	static const char *__JSONTokenNames[] = { "'{'", "'}'", "'['", "']'", "key", "string", "number", "true", "false", "null", "end of input" };
+
+	static const double __JSONPowersOfTen[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	/**
+	 * Skipping a container only has to find the matching closing bracket. Large inputs are scanned 64 bytes at a time:
+	 * The quotes, backslashes and brackets of a block are turned into bit masks, escaped quotes are removed and a prefix xor
+	 * over the remaining quotes yields the bytes that are inside of strings. Only the brackets outside of strings are then
+	 * looked at one by one. The state carries over into the next block and into the scalar loop for the tail.
+	 **/
+
+	struct __JSONScanState
+	{
+		size_t depth;
+		bool inString;
+		bool escaped; // The next byte inside of a string is escaped
+	};
+
+	static const char *__JSONScanContainerScalar(const char *cursor, const char *end, __JSONScanState &state)
+	{
+		for(; cursor < end; cursor ++)
+		{
+			const char character = *cursor;
+
+			if(state.inString)
+			{
+				if(state.escaped)
+					state.escaped = false;
+				else if(character == '\\')
+					state.escaped = true;
+				else if(character == '"')
+					state.inString = false;
+
+				continue;
+			}
+
+			switch(character)
+			{
+				case '"':
+					state.inString = true;
+					break;
+				case '{':
+				case '[':
+					state.depth ++;
+					break;
+				case '}':
+				case ']':
+					if((-- state.depth) == 0)
+						return cursor + 1;
+					break;
+			}
+		}
+
+		return nullptr;
+	}
+
+#if RN_PLATFORM_INTEL
+	RN_INLINE uint64 __JSONPrefixXor(uint64 mask)
+	{
+		mask ^= mask << 1;
+		mask ^= mask << 2;
+		mask ^= mask << 4;
+		mask ^= mask << 8;
+		mask ^= mask << 16;
+		mask ^= mask << 32;
+
+		return mask;
+	}
+
+	RN_INLINE uint64 __JSONBlockMask(const __m128i (&chunks)[4], const __m128i &value)
+	{
+		uint64 mask = 0;
+
+		for(size_t i = 0; i < 4; i ++)
+			mask |= static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[i], value)))) << (i * 16);
+
+		return mask;
+	}
+#endif
+
+	static const char *__JSONScanContainer(const char *cursor, const char *end, __JSONScanState &state)
+	{
+#if RN_PLATFORM_INTEL
+		const __m128i quote = _mm_set1_epi8('"');
+		const __m128i backslash = _mm_set1_epi8('\\');
+		const __m128i openBrace = _mm_set1_epi8('{');
+		const __m128i openBracket = _mm_set1_epi8('[');
+		const __m128i closeBrace = _mm_set1_epi8('}');
+		const __m128i closeBracket = _mm_set1_epi8(']');
+
+		uint64 inStringCarry = state.inString ? ~static_cast<uint64>(0) : 0;
+		bool escapeNext = state.escaped;
+
+		while(end - cursor >= 64)
+		{
+			__m128i chunks[4];
+
+			for(size_t i = 0; i < 4; i ++)
+				chunks[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cursor + i * 16));
+
+			uint64 quotes = __JSONBlockMask(chunks, quote);
+			uint64 backslashes = __JSONBlockMask(chunks, backslash);
+			uint64 opens = __JSONBlockMask(chunks, openBrace) | __JSONBlockMask(chunks, openBracket);
+			uint64 closes = __JSONBlockMask(chunks, closeBrace) | __JSONBlockMask(chunks, closeBracket);
+
+			if(backslashes || escapeNext)
+			{
+				uint64 escaped = escapeNext ? 1 : 0;
+				uint64 candidates = backslashes & ~escaped;
+
+				escapeNext = false;
+
+				// Backslashes are rare enough to walk them one by one, a backslash that is escaped itself doesn't escape anything
+				while(candidates)
+				{
+					uint64 bit = candidates & (~candidates + 1);
+
+					if(bit == (static_cast<uint64>(1) << 63))
+					{
+						escapeNext = true;
+						break;
+					}
+
+					escaped |= bit << 1;
+					candidates &= ~(bit | (bit << 1));
+				}
+
+				quotes &= ~escaped;
+			}
+
+			uint64 inString = __JSONPrefixXor(quotes) ^ inStringCarry;
+			inStringCarry = static_cast<uint64>(static_cast<int64>(inString) >> 63);
+
+			uint64 structural = (opens | closes) & ~inString;
+
+			while(structural)
+			{
+				uint32 index = __JSONLowestBit(structural);
+
+				if(opens & (static_cast<uint64>(1) << index))
+					state.depth ++;
+				else if((-- state.depth) == 0)
+					return cursor + index + 1;
+
+				structural &= structural - 1;
+			}
+
+			cursor += 64;
+		}
+
+		state.inString = (inStringCarry != 0);
+		state.escaped = (escapeNext && state.inString);
+#endif
+
+		return __JSONScanContainerScalar(cursor, end, state);
+	}
+
+	static void __JSONAppendUTF8(std::vector<char> &buffer, uint32 codepoint)
+	{
+		if(codepoint < 0x80)
+		{
+			buffer.push_back(static_cast<char>(codepoint));
+		}
+		else if(codepoint < 0x800)
+		{
+			buffer.push_back(static_cast<char>(0xc0 | (codepoint >> 6)));
+			buffer.push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+		}
+		else if(codepoint < 0x10000)
+		{
+			buffer.push_back(static_cast<char>(0xe0 | (codepoint >> 12)));
+			buffer.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f)));
+			buffer.push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+		}
+		else
+		{
+			buffer.push_back(static_cast<char>(0xf0 | (codepoint >> 18)));
+			buffer.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3f)));
+			buffer.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f)));
+			buffer.push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+		}
+	}
+
+
+
+	JSONReader::JSONReader(const char *bytes, size_t length) :
+		_data(nullptr),
+		_begin(bytes),
+		_cursor(bytes),
+		_end(bytes + length),
+		_state(State::Value),
+		_peeked(false),
+		_peekedToken(Token::End),
+		_string({ nullptr, 0 }),
+		_isInteger(false),
+		_isUnsigned(false),
+		_integer(0),
+		_double(0.0)
+	{
+		// Skip the byte order mark some editors like to put in front
+		if(length >= 3 && memcmp(bytes, "\xef\xbb\xbf", 3) == 0)
+			_cursor += 3;
+	}
+
+	JSONReader::JSONReader(const Data *data) :
+		JSONReader(data->GetBytes<char>(), data->GetLength())
+	{
+		_data = data->Retain();
+	}
+
+	JSONReader::~JSONReader()
+	{
+		if(_data)
+			_data->Release();
+	}
+
+
+	void JSONReader::ThrowError(const char *message) const
+	{
+		size_t line = 1;
+		size_t column = 1;
+
+		for(const char *cursor = _begin; cursor < _cursor; cursor ++)
+		{
+			if(*cursor == '\n')
+			{
+				line ++;
+				column = 1;
+			}
+			else
+			{
+				column ++;
+			}
+		}
+
+		throw InconsistencyException(RNSTR(message << "\nLine: " << line << ", column: " << column));
+	}
+
+	void JSONReader::ExpectToken(Token expected)
+	{
+		Token token = Next();
+
+		if(RN_EXPECT_FALSE(token != expected))
+			ThrowError(RNSTR("Expected " << __JSONTokenNames[static_cast<size_t>(expected)] << " but got " << __JSONTokenNames[static_cast<size_t>(token)])->GetUTF8String());
+	}
+
+
+	JSONReader::Token JSONReader::Next()
+	{
+		if(_peeked)
+		{
+			_peeked = false;
+			return _peekedToken;
+		}
+
+		return ReadToken();
+	}
+
+	JSONReader::Token JSONReader::Peek()
+	{
+		if(!_peeked)
+		{
+			_peekedToken = ReadToken();
+			_peeked = true;
+		}
+
+		return _peekedToken;
+	}
+
+	JSONReader::Token JSONReader::ReadToken()
+	{
+		SkipWhitespace();
+
+		switch(_state)
+		{
+			case State::Value:
+				return ReadValue();
+
+			case State::FirstValue:
+				if(_cursor < _end && *_cursor == ']')
+				{
+					_cursor ++;
+					_stack.pop_back();
+					_state = State::AfterValue;
+
+					return Token::EndArray;
+				}
+
+				return ReadValue();
+
+			case State::FirstKey:
+				if(_cursor < _end && *_cursor == '}')
+				{
+					_cursor ++;
+					_stack.pop_back();
+					_state = State::AfterValue;
+
+					return Token::EndObject;
+				}
+
+				return ReadKey();
+
+			case State::Key:
+				return ReadKey();
+
+			case State::AfterValue:
+			{
+				if(_stack.empty())
+				{
+					_state = State::Done;
+					return Token::End;
+				}
+
+				if(_cursor >= _end)
+					ThrowError("Unexpected end of input");
+
+				const bool object = (_stack.back() == kJSONContainerObject);
+				const char character = *_cursor;
+
+				if(character == ',')
+				{
+					_cursor ++;
+					SkipWhitespace();
+
+					return object ? ReadKey() : ReadValue();
+				}
+
+				if(character == (object ? '}' : ']'))
+				{
+					_cursor ++;
+					_stack.pop_back();
+
+					return object ? Token::EndObject : Token::EndArray;
+				}
+
+				ThrowError(object ? "Expected ',' or '}'" : "Expected ',' or ']'");
+			}
+
+			case State::Done:
+				break;
+		}
+
+		return Token::End;
+	}
+
+	JSONReader::Token JSONReader::ReadKey()
+	{
+		if(_cursor >= _end || *_cursor != '"')
+			ThrowError("Expected a key");
+
+		ReadStringLiteral();
+		SkipWhitespace();
+
+		if(_cursor >= _end || *_cursor != ':')
+			ThrowError("Expected ':'");
+
+		_cursor ++;
+		_state = State::Value;
+
+		return Token::Key;
+	}
+
+	JSONReader::Token JSONReader::ReadValue()
+	{
+		if(_cursor >= _end)
+			ThrowError("Unexpected end of input");
+
+		_state = State::AfterValue;
+
+		switch(*_cursor)
+		{
+			case '{':
+				_cursor ++;
+				Push(kJSONContainerObject);
+				_state = State::FirstKey;
+
+				return Token::BeginObject;
+
+			case '[':
+				_cursor ++;
+				Push(kJSONContainerArray);
+				_state = State::FirstValue;
+
+				return Token::BeginArray;
+
+			case '"':
+				ReadStringLiteral();
+				return Token::String;
+
+			case 't':
+				ReadLiteral("true", 4);
+				return Token::True;
+			case 'f':
+				ReadLiteral("false", 5);
+				return Token::False;
+			case 'n':
+				ReadLiteral("null", 4);
+				return Token::Null;
+
+			case '-':
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+				ReadNumber();
+				return Token::Number;
+
+			default:
+				ThrowError("Unexpected character");
+		}
+	}
+
+	void JSONReader::Push(uint8 container)
+	{
+		if(_stack.size() >= kRNJSONReaderMaxDepth)
+			ThrowError("Nesting too deep");
+
+		_stack.push_back(container);
+	}
+
+	void JSONReader::SkipWhitespace()
+	{
+		while(_cursor < _end)
+		{
+			const char character = *_cursor;
+
+			if(character != ' ' && character != '\n' && character != '\r' && character != '\t')
+				return;
+
+			_cursor ++;
+
+#if RN_PLATFORM_INTEL
+			// Indentation in pretty printed files comes in long runs
+			if(_cursor < _end && *_cursor <= ' ')
+			{
+				const __m128i space = _mm_set1_epi8(' ');
+				const __m128i newline = _mm_set1_epi8('\n');
+				const __m128i carriageReturn = _mm_set1_epi8('\r');
+				const __m128i tab = _mm_set1_epi8('\t');
+
+				while(_end - _cursor >= 16)
+				{
+					__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_cursor));
+					__m128i whitespace = _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, newline));
+					whitespace = _mm_or_si128(whitespace, _mm_or_si128(_mm_cmpeq_epi8(chunk, carriageReturn), _mm_cmpeq_epi8(chunk, tab)));
+
+					uint32 mask = ~static_cast<uint32>(_mm_movemask_epi8(whitespace)) & 0xffff;
+					if(mask)
+					{
+						_cursor += __JSONLowestBit(mask);
+						return;
+					}
+
+					_cursor += 16;
+				}
+			}
+#endif
+		}
+	}
+
+	void JSONReader::ReadLiteral(const char *literal, size_t length)
+	{
+		if(static_cast<size_t>(_end - _cursor) < length || memcmp(_cursor, literal, length) != 0)
+			ThrowError("Unexpected character");
+
+		_cursor += length;
+	}
+
+	void JSONReader::ReadStringLiteral()
+	{
+		const char *begin = ++ _cursor;
+		const char *special = __JSONScanString(begin, _end);
+
+		if(special >= _end)
+			ThrowError("Unterminated string");
+
+		_cursor = special;
+
+		if(RN_EXPECT_TRUE(*special == '"'))
+		{
+			_string.data = begin;
+			_string.length = static_cast<size_t>(special - begin);
+
+			_cursor ++;
+			return;
+		}
+
+		ReadStringEscaped(begin);
+	}
+
+	void JSONReader::ReadStringEscaped(const char *begin)
+	{
+		_scratch.assign(begin, _cursor);
+
+		while(true)
+		{
+			const char character = *_cursor;
+
+			if(character == '"')
+			{
+				_cursor ++;
+				break;
+			}
+
+			if(character != '\\')
+				ThrowError("Control character in string");
+
+			if(_end - _cursor < 2)
+				ThrowError("Unterminated string");
+
+			const char escape = _cursor[1];
+			_cursor += 2;
+
+			switch(escape)
+			{
+				case '"':
+				case '\\':
+				case '/':
+					_scratch.push_back(escape);
+					break;
+				case 'b':
+					_scratch.push_back('\b');
+					break;
+				case 'f':
+					_scratch.push_back('\f');
+					break;
+				case 'n':
+					_scratch.push_back('\n');
+					break;
+				case 'r':
+					_scratch.push_back('\r');
+					break;
+				case 't':
+					_scratch.push_back('\t');
+					break;
+
+				case 'u':
+				{
+					auto readHex = [&]() -> uint32 {
+						if(_end - _cursor < 4)
+							ThrowError("Invalid unicode escape");
+
+						uint32 value = 0;
+
+						for(size_t i = 0; i < 4; i ++)
+						{
+							const char digit = *_cursor ++;
+							value <<= 4;
+
+							if(digit >= '0' && digit <= '9')
+								value |= static_cast<uint32>(digit - '0');
+							else if(digit >= 'a' && digit <= 'f')
+								value |= static_cast<uint32>(digit - 'a' + 10);
+							else if(digit >= 'A' && digit <= 'F')
+								value |= static_cast<uint32>(digit - 'A' + 10);
+							else
+								ThrowError("Invalid unicode escape");
+						}
+
+						return value;
+					};
+
+					uint32 codepoint = readHex();
+
+					if(codepoint >= 0xd800 && codepoint < 0xdc00)
+					{
+						if(_end - _cursor < 2 || _cursor[0] != '\\' || _cursor[1] != 'u')
+							ThrowError("Invalid surrogate pair");
+
+						_cursor += 2;
+
+						uint32 low = readHex();
+						if(low < 0xdc00 || low >= 0xe000)
+							ThrowError("Invalid surrogate pair");
+
+						codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+					}
+					else if(codepoint >= 0xdc00 && codepoint < 0xe000)
+					{
+						ThrowError("Invalid surrogate pair");
+					}
+
+					__JSONAppendUTF8(_scratch, codepoint);
+					break;
+				}
+
+				default:
+					ThrowError("Invalid escape sequence");
+			}
+
+			const char *special = __JSONScanString(_cursor, _end);
+
+			if(special >= _end)
+				ThrowError("Unterminated string");
+
+			_scratch.insert(_scratch.end(), _cursor, special);
+			_cursor = special;
+		}
+
+		_string.data = _scratch.data();
+		_string.length = _scratch.size();
+	}
+
+	void JSONReader::ReadNumber()
+	{
+		const char *begin = _cursor;
+		const bool negative = (*_cursor == '-');
+
+		if(negative)
+			_cursor ++;
+
+		if(_cursor >= _end || !__JSONIsDigit(*_cursor))
+			ThrowError("Invalid number");
+
+		uint64 mantissa = 0;
+		size_t digits = 0;
+		int32 exponent = 0;
+		bool truncated = false;
+		bool integer = true;
+
+		if(*_cursor == '0')
+		{
+			_cursor ++;
+		}
+		else
+		{
+			// Integers may use the whole uint64 range, everything beyond that goes through strtod()
+			const uint64 limit = std::numeric_limits<uint64>::max() / 10;
+
+			for(; _cursor < _end && __JSONIsDigit(*_cursor); _cursor ++)
+			{
+				const uint64 digit = static_cast<uint64>(*_cursor - '0');
+
+				if(!truncated && (mantissa < limit || (mantissa == limit && digit <= std::numeric_limits<uint64>::max() % 10)))
+				{
+					mantissa = mantissa * 10 + digit;
+					digits ++;
+				}
+				else
+				{
+					exponent ++;
+					truncated = true;
+				}
+			}
+		}
+
+		if(_cursor < _end && *_cursor == '.')
+		{
+			_cursor ++;
+			integer = false;
+
+			if(_cursor >= _end || !__JSONIsDigit(*_cursor))
+				ThrowError("Invalid number");
+
+			for(; _cursor < _end && __JSONIsDigit(*_cursor); _cursor ++)
+			{
+				const uint64 digit = static_cast<uint64>(*_cursor - '0');
+
+				if(mantissa == 0 && digit == 0)
+				{
+					exponent --;
+				}
+				else if(digits < 19)
+				{
+					mantissa = mantissa * 10 + digit;
+					digits ++;
+					exponent --;
+				}
+				else
+				{
+					truncated = true;
+				}
+			}
+		}
+
+		if(_cursor < _end && (*_cursor == 'e' || *_cursor == 'E'))
+		{
+			_cursor ++;
+			integer = false;
+
+			bool negativeExponent = false;
+
+			if(_cursor < _end && (*_cursor == '+' || *_cursor == '-'))
+				negativeExponent = (*_cursor ++ == '-');
+
+			if(_cursor >= _end || !__JSONIsDigit(*_cursor))
+				ThrowError("Invalid number");
+
+			int32 value = 0;
+
+			for(; _cursor < _end && __JSONIsDigit(*_cursor); _cursor ++)
+			{
+				if(value < 100000)
+					value = value * 10 + (*_cursor - '0');
+			}
+
+			exponent += negativeExponent ? -value : value;
+		}
+
+		_isUnsigned = false;
+
+		if(integer && !truncated)
+		{
+			if(!negative)
+			{
+				_isInteger = true;
+				_isUnsigned = (mantissa > static_cast<uint64>(std::numeric_limits<int64>::max()));
+				_integer = static_cast<int64>(mantissa);
+
+				return;
+			}
+
+			if(mantissa <= static_cast<uint64>(std::numeric_limits<int64>::max()) + 1)
+			{
+				_isInteger = true;
+				_integer = static_cast<int64>(0 - mantissa);
+
+				return;
+			}
+		}
+
+		_isInteger = false;
+
+		// Exact as long as both the mantissa and the power of ten fit into a double without rounding
+		if(!truncated && mantissa < (static_cast<uint64>(1) << 53) && exponent >= -22 && exponent <= 22)
+		{
+			double value = static_cast<double>(mantissa);
+			value = (exponent < 0) ? value / __JSONPowersOfTen[-exponent] : value * __JSONPowersOfTen[exponent];
+
+			_double = negative ? -value : value;
+			return;
+		}
+
+		const std::string copy(begin, _cursor);
+		_double = strtod(copy.c_str(), nullptr);
+	}
+
+
+	void JSONReader::Skip()
+	{
+		switch(Next())
+		{
+			case Token::BeginObject:
+			case Token::BeginArray:
+			{
+				__JSONScanState state = { 1, false, false };
+				const char *end = __JSONScanContainer(_cursor, _end, state);
+
+				if(!end)
+				{
+					_cursor = _end;
+					ThrowError("Unexpected end of input");
+				}
+
+				_cursor = end;
+				_stack.pop_back();
+				_state = State::AfterValue;
+
+				break;
+			}
+
+			case Token::EndObject:
+			case Token::EndArray:
+			case Token::Key:
+			case Token::End:
+				ThrowError("Expected a value");
+
+			default:
+				break;
+		}
+	}
+
+	bool JSONReader::ReadBool()
+	{
+		switch(Next())
+		{
+			case Token::True:
+				return true;
+			case Token::False:
+				return false;
+
+			default:
+				ThrowError("Expected a boolean");
+		}
+	}
+
+	int64 JSONReader::ReadInt64()
+	{
+		ExpectToken(Token::Number);
+		return GetInt64();
+	}
+
+	uint64 JSONReader::ReadUint64()
+	{
+		ExpectToken(Token::Number);
+		return GetUint64();
+	}
+
+	double JSONReader::ReadDouble()
+	{
+		ExpectToken(Token::Number);
+		return GetDouble();
+	}
+
+	JSONReader::StringRef JSONReader::ReadStringRef()
+	{
+		ExpectToken(Token::String);
+		return _string;
+	}
+
+	bool JSONReader::ReadNull()
+	{
+		if(Peek() != Token::Null)
+			return false;
+
+		Next();
+		return true;
+	}
+}
@@ -0,0 +1,159 @@
+//
+//  RNJSONReader.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_JSONREADER_H__
+#define __RAYNE_JSONREADER_H__
+
+#include "../Base/RNBase.h"
+#include "RNObject.h"
+#include "RNData.h"
+
+#define kRNJSONReaderMaxDepth 1024
+
+namespace RN
+{
+	// Pull parser that walks over JSON one token at a time without building any objects. Strings without escape
+	// sequences point straight into the input, everything else lives in a scratch buffer that is reused for every token.
+	// Values can be decoded right into structs with ReadObject() and ReadArray(), and values nobody is interested
+	// in are skipped with a SIMD scan over the input. The input has to stay alive as long as the reader is used.
+	class JSONReader
+	{
+	public:
+		enum class Token : uint8
+		{
+			BeginObject,
+			EndObject,
+			BeginArray,
+			EndArray,
+			Key,
+			String,
+			Number,
+			True,
+			False,
+			Null,
+			End
+		};
+
+		struct StringRef
+		{
+			bool operator ==(const char *string) const { return strlen(string) == length && memcmp(string, data, length) == 0; }
+			bool operator !=(const char *string) const { return !(*this == string); }
+
+			std::string ToString() const { return std::string(data, length); }
+
+			const char *data;
+			size_t length;
+		};
+
+		RNAPI JSONReader(const char *bytes, size_t length);
+		RNAPI JSONReader(const Data *data);
+		RNAPI ~JSONReader();
+
+		RNAPI Token Next();
+		RNAPI Token Peek();
+
+		// Consumes the next value. Containers are only checked for balanced brackets and properly terminated strings
+		RNAPI void Skip();
+
+		// Values of the token that was returned last. The string is valid until the next token is read
+		const StringRef &GetString() const { return _string; }
+		bool IsInteger() const { return _isInteger; }
+		bool IsUnsigned() const { return _isUnsigned; } // Integers that only fit into an uint64
+		int64 GetInt64() const { return _isInteger ? _integer : static_cast<int64>(_double); }
+		uint64 GetUint64() const { return _isInteger ? static_cast<uint64>(_integer) : static_cast<uint64>(_double); }
+		double GetDouble() const { return _isInteger ? (_isUnsigned ? static_cast<double>(static_cast<uint64>(_integer)) : static_cast<double>(_integer)) : _double; }
+
+		// Reads the next value and throws if it has a different type. Numbers convert into each other
+		RNAPI bool ReadBool();
+		RNAPI int64 ReadInt64();
+		RNAPI uint64 ReadUint64();
+		RNAPI double ReadDouble();
+		float ReadFloat() { return static_cast<float>(ReadDouble()); }
+		RNAPI StringRef ReadStringRef();
+		std::string ReadString() { return ReadStringRef().ToString(); }
+
+		// Consumes the next value if it's null
+		RNAPI bool ReadNull();
+
+		// Calls member with every key of the next object, the callback has to consume the value with a Read function or Skip()
+		template<class F>
+		void ReadObject(F &&member)
+		{
+			ExpectToken(Token::BeginObject);
+
+			for(Token token = Next(); token != Token::EndObject; token = Next())
+			{
+				if(token != Token::Key)
+					ThrowError("Expected a key");
+
+				member(_string);
+			}
+		}
+
+		// Calls element with the index of every element of the next array, the callback has to consume the element
+		template<class F>
+		void ReadArray(F &&element)
+		{
+			ExpectToken(Token::BeginArray);
+
+			for(size_t index = 0; Peek() != Token::EndArray; index ++)
+				element(index);
+
+			Next();
+		}
+
+		size_t GetOffset() const { return static_cast<size_t>(_cursor - _begin); }
+		size_t GetDepth() const { return _stack.size(); }
+
+		RNAPI RN_NORETURN void ThrowError(const char *message) const;
+
+	private:
+		enum class State : uint8
+		{
+			Value,
+			FirstValue,
+			FirstKey,
+			Key,
+			AfterValue,
+			Done
+		};
+
+		Token ReadToken();
+		Token ReadValue();
+		Token ReadKey();
+		void ExpectToken(Token expected);
+
+		void ReadStringLiteral();
+		void ReadStringEscaped(const char *begin);
+		void ReadNumber();
+		void ReadLiteral(const char *literal, size_t length);
+		void SkipWhitespace();
+		void Push(uint8 container);
+
+		const Data *_data;
+		const char *_begin;
+		const char *_cursor;
+		const char *_end;
+
+		State _state;
+		std::vector<uint8> _stack;
+
+		bool _peeked;
+		Token _peekedToken;
+
+		StringRef _string;
+		std::vector<char> _scratch;
+
+		bool _isInteger;
+		bool _isUnsigned;
+		int64 _integer;
+		double _double;
+	};
+}
+
+#endif /* __RAYNE_JSONREADER_H__ */
@@ -6,8 +6,9 @@
 //  Unauthorized use is punishable by torture, mutilation, and vivisection.
 //
 
-#include <jansson.h>
 #include "RNJSONSerialization.h"
+#include "RNJSONReader.h"
+#include "RNJSONWriter.h"
 #include "RNAutoreleasePool.h"
 #include "RNArray.h"
 #include "RNDictionary.h"
@@ -56,10 +57,8 @@ namespace RN
 		return false;
 	}
 
-	void *JSONSerialization::SerializeObject(const Object *object)
+	void JSONSerialization::SerializeObject(JSONWriter &writer, const Object *object)
 	{
-		json_t *json = nullptr;
-
 		if(object->IsKindOfClass(__JSONNumberClass))
 		{
 			const Number *number = static_cast<const Number *>(object);
@@ -67,228 +66,215 @@ namespace RN
 			{
 				case Number::Type::Float32:
 				case Number::Type::Float64:
-					json = json_real(number->GetDoubleValue());
+					writer.WriteDouble(number->GetDoubleValue());
 					break;
 
 				case Number::Type::Uint8:
 				case Number::Type::Uint16:
 				case Number::Type::Uint32:
-					json = json_integer(number->GetUint32Value());
+					writer.WriteUint64(number->GetUint32Value());
 					break;
 
 				case Number::Type::Int8:
 				case Number::Type::Int16:
 				case Number::Type::Int32:
-					json = json_integer(number->GetInt32Value());
+					writer.WriteInt64(number->GetInt32Value());
 					break;
 
 				case Number::Type::Uint64:
-					json = json_integer(number->GetUint64Value());
+					writer.WriteUint64(number->GetUint64Value());
 					break;
 
 				case Number::Type::Int64:
-					json = json_integer(number->GetInt64Value());
+					writer.WriteInt64(number->GetInt64Value());
 					break;
 
 				case Number::Type::Boolean:
-					json = json_boolean(number->GetBoolValue());
+					writer.WriteBool(number->GetBoolValue());
 					break;
 			}
+
+			return;
 		}
 
 		if(object->IsKindOfClass(__JSONStringClass))
 		{
 			const String *string = static_cast<const String *>(object);
-			const char *utf8 = string->GetUTF8String();
+			writer.WriteString(string->GetUTF8String());
 
-			json = json_string_nocheck(utf8);
+			return;
 		}
 
 		if(object->IsKindOfClass(__JSONArrayClass))
 		{
 			const Array *array = static_cast<const Array *>(object);
-			json = json_array();
+			writer.BeginArray();
 
 			array->Enumerate([&](Object *object, size_t index, bool &stop) {
-				json_t *data = static_cast<json_t *>(SerializeObject(object));
-				json_array_append_new(json, data);
+				SerializeObject(writer, object);
 			});
+
+			writer.EndArray();
+			return;
 		}
 
 		if(object->IsKindOfClass(__JSONDictionaryClass))
 		{
 			const Dictionary *dictionary = static_cast<const Dictionary *>(object);
-			json = json_object();
+			writer.BeginObject();
 
 			dictionary->Enumerate([&](Object *object, const Object *key, bool &stop) {
 
 				if(key->IsKindOfClass(__JSONStringClass))
 				{
 					const String *string = static_cast<const String *>(key);
-					const char *utf8 = string->GetUTF8String();
 
-					json_t *data = static_cast<json_t *>(SerializeObject(object));
-					json_object_set_new_nocheck(json, utf8, data);
+					writer.WriteKey(string->GetUTF8String());
+					SerializeObject(writer, object);
 
 					return;
 				}
 
 				throw InconsistencyException("Can't JSON serialize dictionaries with non String keys!");
 			});
+
+			writer.EndObject();
+			return;
 		}
 
 		if(object->IsKindOfClass(__JSONNullClass))
 		{
-			json = json_null();
+			writer.WriteNull();
+			return;
 		}
 
-		if(!json)
-			throw InconsistencyException(RNSTR("Can't JSON serialize object " << object << " of type " << object->GetClass()));
-
-		return json;
+		throw InconsistencyException(RNSTR("Can't JSON serialize object " << object << " of type " << object->GetClass()));
 	}
 
-	Object *JSONSerialization::DeserializeObject(void *temp)
+	Object *JSONSerialization::DeserializeObject(JSONReader &reader)
 	{
+		// Everything is autoreleased right away, so nothing leaks when malformed input throws further down
 		Object *data = nullptr;
-		json_t *json = static_cast<json_t *>(temp);
 
-		switch(json_typeof(json))
+		switch(reader.Next())
 		{
-			case JSON_OBJECT:
+			case JSONReader::Token::BeginObject:
 			{
-				Dictionary *dict = new Dictionary();
+				Dictionary *dict = (new Dictionary())->Autorelease();
 
-				void *iterator = json_object_iter(json);
-				while(iterator)
+				for(JSONReader::Token token = reader.Next(); token != JSONReader::Token::EndObject; token = reader.Next())
 				{
-					const char *key = json_object_iter_key(iterator);
-					json_t *value = json_object_iter_value(iterator);
-
-					Object *object = DeserializeObject(value);
-					dict->SetObjectForKey(object, RNUTF8STR(key));
+					const JSONReader::StringRef &name = reader.GetString();
+					String *key = (new String(name.data, name.length, Encoding::UTF8))->Autorelease();
 
-					iterator = json_object_iter_next(json, iterator);
+					Object *object = DeserializeObject(reader);
+					dict->SetObjectForKey(object, key);
 				}
 
 				data = dict;
 				break;
 			}
 
-			case JSON_ARRAY:
+			case JSONReader::Token::BeginArray:
 			{
-				size_t size = json_array_size(json);
-				Array *array = new Array(size);
+				Array *array = (new Array())->Autorelease();
 
-				for(size_t i = 0; i < size; i ++)
+				while(reader.Peek() != JSONReader::Token::EndArray)
 				{
-					json_t *value = json_array_get(json, i);
-					Object *object = DeserializeObject(value);
-
+					Object *object = DeserializeObject(reader);
 					array->AddObject(object);
 				}
 
+				reader.Next();
+
 				data = array;
 				break;
 			}
 
-			case JSON_TRUE:
-				data = new Number(true);
+			case JSONReader::Token::True:
+				data = (new Number(true))->Autorelease();
 				break;
 
-			case JSON_FALSE:
-				data = new Number(false);
+			case JSONReader::Token::False:
+				data = (new Number(false))->Autorelease();
 				break;
 
-			case JSON_INTEGER:
-				data = new Number(static_cast<int64>(json_integer_value(json)));
+			case JSONReader::Token::Number:
+				if(!reader.IsInteger())
+					data = (new Number(reader.GetDouble()))->Autorelease();
+				else if(reader.IsUnsigned())
+					data = (new Number(reader.GetUint64()))->Autorelease();
+				else
+					data = (new Number(reader.GetInt64()))->Autorelease();
 				break;
 
-			case JSON_REAL:
-				data = new Number(json_real_value(json));
+			case JSONReader::Token::String:
+			{
+				const JSONReader::StringRef &string = reader.GetString();
+				data = (new String(string.data, string.length, Encoding::UTF8))->Autorelease();
 				break;
+			}
 
-			case JSON_STRING:
-				data = new String(json_string_value(json), Encoding::UTF8);
+			case JSONReader::Token::Null:
+				data = Null::GetNull();
 				break;
 
-			case JSON_NULL:
-				data = Null::GetNull()->Retain();
-				break;
+			default:
+				reader.ThrowError("Expected a value");
 		}
 
-		return data ? data->Autorelease() : data;
+		return data;
 	}
 
 
 
-	void *JSONSerialization::SerializeObject(const Object *root, Options options)
+	void JSONSerialization::SerializeObject(JSONWriter &writer, const Object *root, Options options)
 	{
 		JSONReadClasses();
 
-		size_t flags = 0;
+		if(!(options & Options::AllowFragments) && !root->IsKindOfClass(__JSONArrayClass) && !root->IsKindOfClass(__JSONDictionaryClass))
+			throw InconsistencyException("Root object must be an Array or Dictionary, unless AllowFragments is set");
 
-		if(options & Options::PrettyPrint)
-			flags |= JSON_INDENT(4);
-
-		if(options & Options::AllowFragments)
-			flags |= JSON_DECODE_ANY;
-
-
-		json_t *json = static_cast<json_t *>(SerializeObject(root));
-		char *data = json_dumps(json, flags);
-		if(!data)
-			throw InconsistencyException("Failed to serialize object to JSON");
-
-		json_decref(json);
-		return data;
+		SerializeObject(writer, root);
 	}
 
 	Data *JSONSerialization::JSONDataFromObject(const Object *root, Options options)
 	{
-		char *data = reinterpret_cast<char *>(SerializeObject(root, options));
-
-		Data *temp = new Data(data, strlen(data));
-		free(data);
+		JSONWriter writer(options & Options::PrettyPrint);
+		SerializeObject(writer, root, options);
 
-		return temp->Autorelease();
+		return writer.GetData();
 	}
 
 	String *JSONSerialization::JSONStringFromObject(const Object *root, Options options)
 	{
-		void *data = SerializeObject(root, options);
+		JSONWriter writer(options & Options::PrettyPrint);
+		SerializeObject(writer, root, options);
 
-		String *temp = new String(data, Encoding::UTF8);
-		free(data);
-
-		return temp->Autorelease();
+		return writer.GetString();
 	}
 
 
 
-	Object *JSONSerialization::DeserializeFromUTF8String(const char *string, Options options)
+	Object *JSONSerialization::DeserializeFromUTF8String(const char *string, size_t length, Options options)
 	{
 		JSONReadClasses();
 
-		json_error_t error;
-		size_t flags = JSON_DISABLE_EOF_CHECK;
-
-		if(options & Options::AllowFragments)
-			flags |= JSON_ENCODE_ANY;
-
-		json_t *root = json_loads(string, flags, &error);
+		JSONReader reader(string, length);
 
-		if(!root)
-			throw InconsistencyException(RNSTR(error.text << "\nLine: " << error.line << ", column: " << error.column));
+		if(!(options & Options::AllowFragments))
+		{
+			const JSONReader::Token token = reader.Peek();
 
+			if(token != JSONReader::Token::BeginObject && token != JSONReader::Token::BeginArray)
+				reader.ThrowError("Root value must be an object or array, unless AllowFragments is set");
+		}
 
 		Object *object;
 
 		{
 			AutoreleasePool pool;
-
-			object = DeserializeObject(root)->Retain();
-			json_decref(root);
+			object = DeserializeObject(reader)->Retain();
 		}
 
 		return object->Autorelease();
@@ -296,11 +282,12 @@ namespace RN
 
 	Object *JSONSerialization::__ObjectFromString(const String *string, Options options)
 	{
-		return DeserializeFromUTF8String(string->GetUTF8String(), options);
+		const char *utf8 = string->GetUTF8String();
+		return DeserializeFromUTF8String(utf8, strlen(utf8), options);
 	}
 
 	Object *JSONSerialization::__ObjectFromData(const Data *data, Options options)
 	{
-		return DeserializeFromUTF8String(data->GetBytes<char>(), options);
+		return DeserializeFromUTF8String(data->GetBytes<char>(), data->GetLength(), options);
 	}
 }
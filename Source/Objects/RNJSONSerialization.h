@@ -16,12 +16,15 @@
 
 namespace RN
 {
+	class JSONReader;
+	class JSONWriter;
+
 	class JSONSerialization
 	{
 	public:
 		RN_OPTIONS(Options, uint32,
 					PrettyPrint = (1 <<1),
-					AllowFragments = (1 << 1));
+					AllowFragments = (1 << 2));
 
 
 		RNAPI static String *JSONStringFromObject(const Object *root, Options options = 0);
@@ -42,11 +45,11 @@ namespace RN
 		RNAPI static bool IsValidJSONObject(const Object *object);
 
 	private:
-		static Object *DeserializeObject(void *);
-		static Object *DeserializeFromUTF8String(const char *string, Options options);
+		static Object *DeserializeObject(JSONReader &reader);
+		static Object *DeserializeFromUTF8String(const char *string, size_t length, Options options);
 
-		static void *SerializeObject(const Object *object);
-		static void *SerializeObject(const Object *root, Options options);
+		static void SerializeObject(JSONWriter &writer, const Object *object);
+		static void SerializeObject(JSONWriter &writer, const Object *root, Options options);
 
 		RNAPI static Object *__ObjectFromString(const String *string, Options options);
 		RNAPI static Object *__ObjectFromData(const Data *data, Options options);
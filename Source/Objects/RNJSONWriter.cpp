@@ -0,0 +1,300 @@
+//
+//  RNJSONWriter.cpp
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "RNJSONWriter.h"
+#include "RNJSONInternal.h"
+#include "../System/RNFile.h"
+
+namespace RN
+{
+	static constexpr uint8 kJSONContainerObject = 0;
+	static constexpr uint8 kJSONContainerArray = 1;
+
+	// Writes the digits backwards from end and returns where they begin
+	static char *__JSONFormatUnsigned(char *end, uint64 value)
+	{
+		do {
+			*(-- end) = static_cast<char>('0' + (value % 10));
+			value /= 10;
+		} while(value);
+
+		return end;
+	}
+
+	JSONWriter::JSONWriter(bool prettyPrint) :
+		_file(nullptr),
+		_prettyPrint(prettyPrint),
+		_first(true),
+		_afterKey(false)
+	{}
+
+	JSONWriter::JSONWriter(File *file, bool prettyPrint) :
+		_file(file->Retain()),
+		_prettyPrint(prettyPrint),
+		_first(true),
+		_afterKey(false)
+	{
+		_buffer.reserve(kRNJSONWriterFlushSize);
+	}
+
+	JSONWriter::~JSONWriter()
+	{
+		if(_file)
+		{
+			Flush();
+			_file->Release();
+		}
+	}
+
+
+	void JSONWriter::Flush()
+	{
+		if(_file && !_buffer.empty())
+		{
+			_file->Write(_buffer.data(), _buffer.size());
+			_buffer.clear();
+		}
+	}
+
+	Data *JSONWriter::GetData() const
+	{
+		RN_ASSERT(!_file, "GetData() called on a JSONWriter that writes into a file");
+		return Data::WithBytes(reinterpret_cast<const uint8 *>(_buffer.data()), _buffer.size());
+	}
+
+	String *JSONWriter::GetString() const
+	{
+		RN_ASSERT(!_file, "GetString() called on a JSONWriter that writes into a file");
+		return String::WithBytes(_buffer.data(), _buffer.size(), Encoding::UTF8);
+	}
+
+
+	void JSONWriter::WriteNewline()
+	{
+		if(!_prettyPrint)
+			return;
+
+		Append('\n');
+		_buffer.insert(_buffer.end(), _stack.size() * 4, ' ');
+	}
+
+	void JSONWriter::BeginValue()
+	{
+		if(_afterKey)
+		{
+			_afterKey = false;
+			return;
+		}
+
+		if(_stack.empty())
+			return;
+
+		RN_ASSERT(_stack.back() == kJSONContainerArray, "Values inside of an object need a key");
+
+		if(!_first)
+			Append(',');
+
+		WriteNewline();
+		_first = false;
+	}
+
+	void JSONWriter::BeginObject()
+	{
+		BeginValue();
+		Append('{');
+
+		_stack.push_back(kJSONContainerObject);
+		_first = true;
+	}
+
+	void JSONWriter::EndObject()
+	{
+		RN_ASSERT(!_stack.empty() && _stack.back() == kJSONContainerObject && !_afterKey, "EndObject() without matching BeginObject() or with a dangling key");
+
+		_stack.pop_back();
+
+		if(!_first)
+			WriteNewline();
+
+		Append('}');
+		_first = false;
+	}
+
+	void JSONWriter::BeginArray()
+	{
+		BeginValue();
+		Append('[');
+
+		_stack.push_back(kJSONContainerArray);
+		_first = true;
+	}
+
+	void JSONWriter::EndArray()
+	{
+		RN_ASSERT(!_stack.empty() && _stack.back() == kJSONContainerArray, "EndArray() without matching BeginArray()");
+
+		_stack.pop_back();
+
+		if(!_first)
+			WriteNewline();
+
+		Append(']');
+		_first = false;
+	}
+
+	void JSONWriter::WriteKey(const char *key, size_t length)
+	{
+		RN_ASSERT(!_stack.empty() && _stack.back() == kJSONContainerObject && !_afterKey, "Keys can only be written inside of objects");
+
+		if(!_first)
+			Append(',');
+
+		WriteNewline();
+		WriteQuotedString(key, length);
+
+		if(_prettyPrint)
+			Append(": ", 2);
+		else
+			Append(':');
+
+		_first = false;
+		_afterKey = true;
+	}
+
+
+	void JSONWriter::WriteQuotedString(const char *string, size_t length)
+	{
+		static const char *hex = "0123456789abcdef";
+
+		const char *end = string + length;
+		Append('"');
+
+		while(true)
+		{
+			const char *special = __JSONScanString(string, end);
+			Append(string, static_cast<size_t>(special - string));
+
+			if(special == end)
+				break;
+
+			const uint8 character = static_cast<uint8>(*special);
+
+			switch(character)
+			{
+				case '"':
+					Append("\\\"", 2);
+					break;
+				case '\\':
+					Append("\\\\", 2);
+					break;
+				case '\b':
+					Append("\\b", 2);
+					break;
+				case '\f':
+					Append("\\f", 2);
+					break;
+				case '\n':
+					Append("\\n", 2);
+					break;
+				case '\r':
+					Append("\\r", 2);
+					break;
+				case '\t':
+					Append("\\t", 2);
+					break;
+
+				default:
+				{
+					const char escape[6] = { '\\', 'u', '0', '0', hex[character >> 4], hex[character & 0xf] };
+					Append(escape, 6);
+					break;
+				}
+			}
+
+			string = special + 1;
+		}
+
+		Append('"');
+	}
+
+	void JSONWriter::WriteString(const char *string, size_t length)
+	{
+		BeginValue();
+		WriteQuotedString(string, length);
+	}
+
+	void JSONWriter::WriteInt64(int64 value)
+	{
+		char buffer[21];
+		char *end = buffer + sizeof(buffer);
+		char *cursor = __JSONFormatUnsigned(end, (value < 0) ? 0 - static_cast<uint64>(value) : static_cast<uint64>(value));
+
+		if(value < 0)
+			*(-- cursor) = '-';
+
+		BeginValue();
+		Append(cursor, static_cast<size_t>(end - cursor));
+	}
+
+	void JSONWriter::WriteUint64(uint64 value)
+	{
+		char buffer[20];
+		char *end = buffer + sizeof(buffer);
+		char *cursor = __JSONFormatUnsigned(end, value);
+
+		BeginValue();
+		Append(cursor, static_cast<size_t>(end - cursor));
+	}
+
+	void JSONWriter::WriteDouble(double value)
+	{
+		if(!std::isfinite(value))
+			throw InconsistencyException("JSON can't represent infinity or NaN");
+
+		// Use the shorter representation as long as it reads back as the same value
+		char buffer[32];
+		int length = snprintf(buffer, sizeof(buffer), "%.15g", value);
+
+		if(strtod(buffer, nullptr) != value)
+			length = snprintf(buffer, sizeof(buffer), "%.17g", value);
+
+		bool fraction = false;
+
+		for(int i = 0; i < length; i ++)
+		{
+			if(buffer[i] == ',')
+				buffer[i] = '.'; // Locales with a decimal comma
+
+			if(buffer[i] == '.' || buffer[i] == 'e')
+				fraction = true;
+		}
+
+		BeginValue();
+		Append(buffer, static_cast<size_t>(length));
+
+		// Keep it a real number when reading it back in
+		if(!fraction)
+			Append(".0", 2);
+	}
+
+	void JSONWriter::WriteBool(bool value)
+	{
+		BeginValue();
+
+		if(value)
+			Append("true", 4);
+		else
+			Append("false", 5);
+	}
+
+	void JSONWriter::WriteNull()
+	{
+		BeginValue();
+		Append("null", 4);
+	}
+}
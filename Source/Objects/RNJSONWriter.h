@@ -0,0 +1,88 @@
+//
+//  RNJSONWriter.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_JSONWRITER_H__
+#define __RAYNE_JSONWRITER_H__
+
+#include "../Base/RNBase.h"
+#include "RNObject.h"
+#include "RNData.h"
+#include "RNString.h"
+
+#define kRNJSONWriterFlushSize (64 * 1024)
+
+namespace RN
+{
+	class File;
+
+	// Writes JSON value by value, either into memory or streamed into a file in kRNJSONWriterFlushSize chunks.
+	// Pretty printing indents by four spaces.
+	class JSONWriter
+	{
+	public:
+		RNAPI JSONWriter(bool prettyPrint = false);
+		RNAPI JSONWriter(File *file, bool prettyPrint = false);
+		RNAPI ~JSONWriter();
+
+		RNAPI void BeginObject();
+		RNAPI void EndObject();
+		RNAPI void BeginArray();
+		RNAPI void EndArray();
+
+		// Every value inside of an object needs a key in front of it
+		RNAPI void WriteKey(const char *key, size_t length);
+		void WriteKey(const char *key) { WriteKey(key, strlen(key)); }
+		void WriteKey(const std::string &key) { WriteKey(key.data(), key.length()); }
+
+		RNAPI void WriteString(const char *string, size_t length);
+		void WriteString(const char *string) { WriteString(string, strlen(string)); }
+		void WriteString(const std::string &string) { WriteString(string.data(), string.length()); }
+
+		RNAPI void WriteInt64(int64 value);
+		RNAPI void WriteUint64(uint64 value);
+		RNAPI void WriteDouble(double value);
+		RNAPI void WriteBool(bool value);
+		RNAPI void WriteNull();
+
+		RNAPI void Flush();
+
+		// Everything written so far, only available when not writing into a file
+		RNAPI Data *GetData() const;
+		RNAPI String *GetString() const;
+
+		size_t GetDepth() const { return _stack.size(); }
+
+	private:
+		void BeginValue();
+		void WriteNewline();
+		void WriteQuotedString(const char *string, size_t length);
+
+		void Append(const char *bytes, size_t length)
+		{
+			_buffer.insert(_buffer.end(), bytes, bytes + length);
+
+			if(_file && _buffer.size() >= kRNJSONWriterFlushSize)
+				Flush();
+		}
+		void Append(char character)
+		{
+			_buffer.push_back(character);
+		}
+
+		File *_file;
+		bool _prettyPrint;
+
+		std::vector<char> _buffer;
+		std::vector<uint8> _stack;
+
+		bool _first;
+		bool _afterKey;
+	};
+}
+
+#endif /* __RAYNE_JSONWRITER_H__ */
@@ -11,9 +11,19 @@
 #include "RNDictionary.h"
 #include "RNString.h"
 #include "RNNull.h"
+#include "../Threads/RNLockable.h"
 
 namespace RN
 {
+	// Properties with a coalesced change waiting for the next flush. A flush takes the queue as its batch and leaves
+	// a spare vector in its place, which it gets back afterwards, so queueing changes doesn't allocate once they have grown.
+	// Batches that are being emitted are registered, so properties destroyed by an observer can take themselves out.
+	static Lockable __coalescedChangeLock;
+	static std::vector<ObservableProperty *> __coalescedChanges;
+	static std::vector<ObservableProperty *> __coalescedChangesSpare;
+	static std::vector<std::vector<ObservableProperty *> *> __coalescedChangeBatches;
+	static std::atomic<size_t> __coalescedChangeFlushes(0);
+
 	// ---------------------
 	// MARK: -
 	// MARK: ObservableBase
@@ -24,6 +34,7 @@ namespace RN
 		_type(type),
 		_flags(1 << __kRNObservableFlagWritable),
 		_signal(nullptr),
+		_changeSignal(nullptr),
 		_changeSet(nullptr)
 	{
 		RN_ASSERT(type != '?', "ObservableProperty with invalid type!");
@@ -35,7 +46,21 @@ namespace RN
 	ObservableProperty::~ObservableProperty()
 	{
 		RN_ASSERT(!_changeSet, "ChangeSet must be null upon destructor call. Smells like WillChange/DidChange imbalance");
+
+		if(__coalescedChangeFlushes.load(std::memory_order_acquire) > 0 || (_flags & (1 << __kRNObservableFlagPending)))
+		{
+			LockGuard<Lockable> lock(__coalescedChangeLock);
+
+			auto iterator = std::find(__coalescedChanges.begin(), __coalescedChanges.end(), this);
+			if(iterator != __coalescedChanges.end())
+				__coalescedChanges.erase(iterator);
+
+			for(std::vector<ObservableProperty *> *batch : __coalescedChangeBatches)
+				std::replace(batch->begin(), batch->end(), this, static_cast<ObservableProperty *>(nullptr));
+		}
+
 		delete _signal;
+		delete _changeSignal;
 	}
 	
 	void ObservableProperty::AssertSignal()
@@ -43,12 +68,95 @@ namespace RN
 		if(!_signal)
 			_signal = new Signal<void (Object *, const char *, const Dictionary *)>();
 	}
+
+	void ObservableProperty::AssertChangeSignal()
+	{
+		if(!_changeSignal)
+			_changeSignal = new Signal<void (Object *, const ObservableChange &)>();
+	}
 	
 	
 	void ObservableProperty::SetWritable(bool writable)
 	{
 		writable ? (_flags |= (1 << __kRNObservableFlagWritable)) : (_flags &= ~(1 << __kRNObservableFlagWritable));
 	}
+
+	void ObservableProperty::SetCoalescesChanges(bool coalesce)
+	{
+		coalesce ? (_flags |= (1 << __kRNObservableFlagCoalesce)) : (_flags &= ~(1 << __kRNObservableFlagCoalesce));
+	}
+
+	void ObservableProperty::EmitChange(const void *oldValue, const void *newValue)
+	{
+		if(!_changeSignal)
+			return;
+
+		ObservableChange change;
+		change.property = this;
+		change.type = _type;
+		change.oldValue = oldValue;
+		change.newValue = newValue;
+
+		_changeSignal->Emit(std::move(_owner), change);
+	}
+
+	void ObservableProperty::FlushCoalescedChanges()
+	{
+		std::vector<ObservableProperty *> batch;
+
+		{
+			LockGuard<Lockable> lock(__coalescedChangeLock);
+
+			if(__coalescedChanges.empty())
+				return;
+
+			batch.swap(__coalescedChanges);
+			__coalescedChanges.swap(__coalescedChangesSpare);
+
+			// Observers may change coalescing properties again, which queues them up for the next flush
+			for(ObservableProperty *property : batch)
+				property->_flags &= ~((1 << __kRNObservableFlagPending) | (1 << __kRNObservableFlagCaptured));
+
+			__coalescedChangeBatches.push_back(&batch);
+			__coalescedChangeFlushes.fetch_add(1, std::memory_order_release);
+		}
+
+		auto finishBatch = [&batch]() {
+			LockGuard<Lockable> lock(__coalescedChangeLock);
+
+			__coalescedChangeBatches.erase(std::find(__coalescedChangeBatches.begin(), __coalescedChangeBatches.end(), &batch));
+			__coalescedChangeFlushes.fetch_sub(1, std::memory_order_release);
+
+			batch.clear();
+
+			if(batch.capacity() > __coalescedChangesSpare.capacity())
+				__coalescedChangesSpare.swap(batch);
+		};
+
+		try
+		{
+			// Observers can destroy properties that are still to come, or flush again, so every entry is read under the lock
+			for(size_t i = 0; i < batch.size(); i ++)
+			{
+				ObservableProperty *property;
+
+				{
+					LockGuard<Lockable> lock(__coalescedChangeLock);
+					property = batch[i];
+				}
+
+				if(property)
+					property->EmitTypedChange();
+			}
+		}
+		catch(...)
+		{
+			finishBatch();
+			throw;
+		}
+
+		finishBatch();
+	}
 	
 	void ObservableProperty::WillChangeValue()
 	{
@@ -56,15 +164,22 @@ namespace RN
 
 		uint8 recursion = (_flags & 0xf);
 
-		if((recursion ++) == 0 && _signal)
+		if((recursion ++) == 0)
 		{
-			if(_signal->GetCount() > 0)
+			if(_signal && _signal->GetCount() > 0)
 			{
 				Object *value = GetValue();
 				
 				_changeSet = new Dictionary();
 				_changeSet->SetObjectForKey(value ? value : Null::GetNull(), kRNObservableOldValueKey);
 			}
+
+			// A pending coalesced change already holds the value from before the first change
+			if(_changeSignal && _changeSignal->GetCount() > 0 && !(_flags & (1 << __kRNObservableFlagCaptured)))
+			{
+				StoreOldValue();
+				_flags |= (1 << __kRNObservableFlagCaptured);
+			}
 		}
 
 		_flags &= ~0xf;
@@ -75,29 +190,44 @@ namespace RN
 	{
 		RN_ASSERT(_owner, "Observable<> must be added to an Object before they can be used!");
 
-		uint8 recursion = (_flags & 0xf);
+		uint8 recursion = (_flags & 0xf) - 1;
 		
-		if((-- recursion) == 0)
+		// Write the recursion counter back immediately, observers may change the property again
+		_flags &= ~0xf;
+		_flags |= recursion;
+
+		if(recursion == 0)
 		{
 			if(_changeSet)
 			{
-				// Write the recursion counter back immediately
-				_flags &= ~0xf;
-				_flags |= recursion;
+				Dictionary *changeSet = _changeSet;
+				_changeSet = nullptr;
 
 				Object *value = GetValue();
-				_changeSet->SetObjectForKey(value ? value : Null::GetNull(), kRNObservableNewValueKey);
+				changeSet->SetObjectForKey(value ? value : Null::GetNull(), kRNObservableNewValueKey);
 				
-				_signal->Emit(std::move(_owner), _name, std::move(_changeSet));
-				
-				_changeSet->Release();
-				_changeSet = nullptr;
+				_signal->Emit(std::move(_owner), _name, std::move(changeSet));
+				changeSet->Release();
+			}
 
-				return;
+			if(_flags & (1 << __kRNObservableFlagCaptured))
+			{
+				if(_flags & (1 << __kRNObservableFlagCoalesce))
+				{
+					LockGuard<Lockable> lock(__coalescedChangeLock);
+
+					if(!(_flags & (1 << __kRNObservableFlagPending)))
+					{
+						_flags |= (1 << __kRNObservableFlagPending);
+						__coalescedChanges.push_back(this);
+					}
+				}
+				else
+				{
+					_flags &= ~(1 << __kRNObservableFlagCaptured);
+					EmitTypedChange();
+				}
 			}
 		}
-
-		_flags &= ~0xf;
-		_flags |= recursion;
 	}
 }
@@ -20,12 +20,40 @@
 #define kRNObservableOldValueKey RNCSTR("kRNObservableOldValueKey")
 
 #define __kRNObservableFlagWritable 4 // Internal, do not use!
+#define __kRNObservableFlagCoalesce 5 // Internal, do not use!
+#define __kRNObservableFlagPending 6 // Internal, do not use!
+#define __kRNObservableFlagCaptured 7 // Internal, do not use!
 
 namespace RN
 {
 	class Object;
 	class Dictionary;
 	class MetaClass;
+	class ObservableProperty;
+
+	// Passed to change observers on the stack of the thread that changed the property, observers have to copy
+	// values they want to keep. Object properties pass their values as Object *
+	struct ObservableChange
+	{
+		template<class T>
+		const T &GetOldValue() const
+		{
+			RN_ASSERT(TypeTranslator<T>::value == type, "GetOldValue() called with the wrong type");
+			return *static_cast<const T *>(oldValue);
+		}
+
+		template<class T>
+		const T &GetNewValue() const
+		{
+			RN_ASSERT(TypeTranslator<T>::value == type, "GetNewValue() called with the wrong type");
+			return *static_cast<const T *>(newValue);
+		}
+
+		const ObservableProperty *property;
+		char type;
+		const void *oldValue;
+		const void *newValue;
+	};
 	
 	class ObservableProperty
 	{
@@ -48,20 +76,34 @@ namespace RN
 		
 		RNAPI void WillChangeValue();
 		RNAPI void DidChangeValue();
+
+		// Coalescing properties notify their change observers only once per frame, with the value from before the
+		// first change and the current one. Observers using the Dictionary API are still notified on every change
+		RNAPI void SetCoalescesChanges(bool coalesce);
+		bool CoalescesChanges() const { return (_flags & (1 << __kRNObservableFlagCoalesce)); }
+
+		// Called by the Kernel once the scene update is done
+		RNAPI static void FlushCoalescedChanges();
 		
 	protected:
 		RNAPI ObservableProperty(const char *name, char type);
+
+		virtual void StoreOldValue() {}
+		virtual void EmitTypedChange() {}
+		RNAPI void EmitChange(const void *oldValue, const void *newValue);
 		
 		Object *_owner;
 		
 	private:
 		RNAPI void AssertSignal();
+		RNAPI void AssertChangeSignal();
 		
 		char _type;
 		char _name[33];
-		uint8 _flags; // Lower 3 bits used as recursion Will/DidChange counter
+		uint8 _flags; // Lower 4 bits used as recursion Will/DidChange counter
 		
 		Signal<void (Object *, const char *, const Dictionary *)> *_signal;
+		Signal<void (Object *, const ObservableChange &)> *_changeSignal;
 		Dictionary *_changeSet;
 		void *_opaque;
 	};
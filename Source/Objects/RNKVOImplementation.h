@@ -157,10 +157,21 @@ namespace RN
 			\
 			return result; \
 		} \
+	protected: \
+		void StoreOldValue() override \
+		{ \
+			_oldStorage = _getter ? (static_cast<Target *>(_owner)->*_getter)() : _storage; \
+		} \
+		void EmitTypedChange() override \
+		{ \
+			const type value = _getter ? (static_cast<Target *>(_owner)->*_getter)() : _storage; \
+			EmitChange(&_oldStorage, &value); \
+		} \
 	private: \
 		Setter _setter; \
 		Getter _getter; \
 		type _storage; \
+		type _oldStorage; \
 	};
 
 	
@@ -218,10 +229,21 @@ namespace RN
 			\
 			return _storage; \
 		} \
+	protected: \
+		void StoreOldValue() override \
+		{ \
+			_oldStorage = _getter ? (static_cast<Target *>(_owner)->*_getter)() : _storage; \
+		} \
+		void EmitTypedChange() override \
+		{ \
+			const type &value = _getter ? (static_cast<Target *>(_owner)->*_getter)() : _storage; \
+			EmitChange(&_oldStorage, &value); \
+		} \
 	private: \
 		Setter _setter; \
 		Getter _getter; \
 		type _storage; \
+		type _oldStorage; \
 	public:
 	
 
@@ -324,8 +346,13 @@ namespace RN
 			_getter(getter),
 			_policy(policy),
 			_storage(nullptr),
+			_oldStorage(nullptr),
 			_meta(T::GetMetaClass())
 		{}
+		~ObservableObject()
+		{
+			SafeRelease(_oldStorage);
+		}
 		
 		void SetValue(Object *object) override
 		{
@@ -411,11 +438,30 @@ namespace RN
 			return _storage;
 		}
 
+	protected:
+		void StoreOldValue() override
+		{
+			SafeRelease(_oldStorage);
+			_oldStorage = SafeRetain(GetValue());
+		}
+		void EmitTypedChange() override
+		{
+			// Observers see the object as Object *, matching the type of the change
+			Object *oldValue = _oldStorage;
+			Object *value = GetValue();
+
+			_oldStorage = nullptr;
+
+			EmitChange(&oldValue, &value);
+			SafeRelease(oldValue);
+		}
+
 	private:
 		Setter _setter;
 		Getter _getter;
 		Object::MemoryPolicy _policy;
 		T *_storage;
+		Object *_oldStorage;
 		MetaClass *_meta;
 	};
 
@@ -486,10 +532,22 @@ namespace RN
 		{
 			return _storage;
 		}
+	protected:
+		void StoreOldValue() override
+		{
+			_oldStorage = _getter ? (static_cast<Target *>(_owner)->*_getter)() : _storage;
+		}
+		void EmitTypedChange() override
+		{
+			const bool value = _getter ? (static_cast<Target *>(_owner)->*_getter)() : _storage;
+			EmitChange(&_oldStorage, &value);
+		}
+
 	private:
 		Setter _setter;
 		Getter _getter;
 		bool _storage;
+		bool _oldStorage;
 	};
 
 	__ObservableScalar(int8, Int8)
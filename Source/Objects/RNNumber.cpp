@@ -68,7 +68,6 @@ namespace RN
 		bytes ++;
 		size = SizeForType(_type);
 		
-		_buffer = new uint8[size];
 		std::copy(bytes, bytes + size, _buffer);
 	}
 	
@@ -125,9 +124,7 @@ namespace RN
 	}
 	
 	Number::~Number()
-	{
-		delete [] _buffer;
-	}
+	{}
 	
 	
 	Number *Number::WithBool(bool value)
@@ -222,7 +219,6 @@ namespace RN
 	{
 		const uint8 *source = static_cast<const uint8 *>(data);
 		
-		_buffer = new uint8[size];
 		_type = type;
 		
 		std::copy(source, source + size, _buffer);
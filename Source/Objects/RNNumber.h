@@ -89,9 +89,10 @@ namespace RN
 		static size_t SizeForType(Type type);
 		void CopyData(const void *data, size_t size, Type type);
 		
-		uint8 *_buffer;
+		alignas(8) uint8 _buffer[8];
 		Type _type;
 		
+		RNDeclarePooledAllocation()
 		__RNDeclareMetaInternal(Number);
 	};
 	
@@ -31,6 +31,30 @@
 namespace RN
 {
 	void *__kRNObjectMetaClass = nullptr;
+
+	// Objects bound to a thread keep the token of that thread in the upper bits of their reference count
+#if RN_PLATFORM_64BIT
+	static constexpr size_t kObjectOwnerShift = 48;
+#else
+	static constexpr size_t kObjectOwnerShift = 24;
+#endif
+	static constexpr size_t kObjectReferenceCountMask = (static_cast<size_t>(1) << kObjectOwnerShift) - 1;
+	static constexpr size_t kObjectMaxOwnerToken = (~static_cast<size_t>(0)) >> kObjectOwnerShift;
+
+	static std::atomic<size_t> __objectNextOwnerToken(1);
+	static thread_local size_t __objectOwnerToken = 0;
+
+	static size_t GetObjectOwnerToken()
+	{
+		if(RN_EXPECT_FALSE(__objectOwnerToken == 0))
+		{
+			// Threads that come after all tokens are handed out get one that can never match, so nothing is bound to them
+			const size_t token = __objectNextOwnerToken.fetch_add(1, std::memory_order_relaxed);
+			__objectOwnerToken = (token <= kObjectMaxOwnerToken) ? token : kObjectMaxOwnerToken + 1;
+		}
+
+		return __objectOwnerToken;
+	}
 	
 	Object::Object() :
 #if RN_ZOMBIE_ALLOCATION
@@ -45,7 +69,7 @@ namespace RN
 	Object::~Object()
 	{
 		if(!std::uncaught_exception())
-			RN_ASSERT(_refCount.load(std::memory_order_relaxed) <= 1, "refCount must be <= 1 upon destructor call. Use object->Unlock(); instead of delete object;");
+			RN_ASSERT(GetReferenceCount() <= 1, "refCount must be <= 1 upon destructor call. Use object->Unlock(); instead of delete object;");
 	
 		for(auto &pair : _associatedObjects)
 		{
@@ -99,6 +123,14 @@ namespace RN
 	{
 		AssertZombieInteraction();
 
+		const size_t value = _refCount.load(std::memory_order_relaxed);
+
+		if(RN_EXPECT_FALSE((value >> kObjectOwnerShift) != 0))
+		{
+			RetainBound(value);
+			return this;
+		}
+
 		_refCount.fetch_add(1, std::memory_order_relaxed); // RMW pairs with relaxed memory ordering
 		return this;
 	}
@@ -106,12 +138,33 @@ namespace RN
 	{
 		AssertZombieInteraction();
 
+		const size_t value = _refCount.load(std::memory_order_relaxed);
+
+		if(RN_EXPECT_FALSE((value >> kObjectOwnerShift) != 0))
+		{
+			RetainBound(value);
+			return this;
+		}
+
 		_refCount.fetch_add(1, std::memory_order_relaxed); // RMW pairs with relaxed memory ordering
 		return this;
 	}
+
+	void Object::RetainBound(size_t value) const
+	{
+		RN_ASSERT((value >> kObjectOwnerShift) == GetObjectOwnerToken(), "Object retained by a thread it isn't bound to, call Share() before handing it to other threads");
+
+		// Only the owning thread touches the reference count, so a plain load and store is enough
+		_refCount.store(value + 1, std::memory_order_relaxed);
+	}
 	
 
 	void Object::Release() const
+	{
+		ReleaseBatch(1);
+	}
+
+	void Object::ReleaseBatch(size_t count) const
 	{
 #if RN_ZOMBIE_ALLOCATION
 		if(_isZombie)
@@ -124,27 +177,82 @@ namespace RN
 #endif
 		
 #if RN_BUILD_DEBUG
-		RN_ASSERT(_refCount > _autoreleaseCounter, "Object is in too many autorelease pools and will be over released!");
+		RN_ASSERT(GetReferenceCount() >= _autoreleaseCounter + count, "Object is in too many autorelease pools and will be over released!");
 #endif
 
-		// If this is the last reference this thread has, which it very well might be,
-		// we need to flush all accesses done so far. Thus the release barrier
-		if(_refCount.fetch_sub(1, std::memory_order_release) == 1)
+		const size_t value = _refCount.load(std::memory_order_relaxed);
+
+		if(RN_EXPECT_FALSE((value >> kObjectOwnerShift) != 0))
+		{
+			RN_ASSERT((value >> kObjectOwnerShift) == GetObjectOwnerToken(), "Object released by a thread it isn't bound to, call Share() before handing it to other threads");
+
+			if((value & kObjectReferenceCountMask) != count)
+			{
+				_refCount.store(value - count, std::memory_order_relaxed);
+				return;
+			}
+
+			_refCount.store(0, std::memory_order_relaxed);
+		}
+		else
 		{
+			// If this is the last reference this thread has, which it very well might be,
+			// we need to flush all accesses done so far. Thus the release barrier
+			if(_refCount.fetch_sub(count, std::memory_order_release) != count)
+				return;
+
 			// Catch up with all changes from all other threads that had access to the object
 			std::atomic_thread_fence(std::memory_order_acquire);
+		}
 
 #if RN_ZOMBIE_ALLOCATION
-			_isZombie = true;
+		_isZombie = true;
 #else
-			// Since this function is marked const, we need to do this
-			Object *nonConstThis = const_cast<Object *>(this);
+		// Since this function is marked const, we need to do this
+		Object *nonConstThis = const_cast<Object *>(this);
 
-			nonConstThis->Dealloc();
-			delete nonConstThis;
+		nonConstThis->Dealloc();
+		delete nonConstThis;
 #endif
+	}
+
+
+	Object *Object::BindToCurrentThread()
+	{
+		AssertZombieInteraction();
+
+		const size_t token = GetObjectOwnerToken();
+		RN_ASSERT((_refCount.load(std::memory_order_relaxed) >> kObjectOwnerShift) == 0, "Object is already bound to a thread");
+
+		if(token <= kObjectMaxOwnerToken)
+			_refCount.fetch_or(token << kObjectOwnerShift, std::memory_order_relaxed);
+
+		return this;
+	}
+
+	void Object::Share() const
+	{
+		const size_t value = _refCount.load(std::memory_order_relaxed);
+
+		if((value >> kObjectOwnerShift) != 0)
+		{
+			RN_ASSERT((value >> kObjectOwnerShift) == GetObjectOwnerToken(), "Only the thread an object is bound to can share it");
+
+			// Publishes the reference count so other threads can pick up from here with atomic operations
+			_refCount.store(value & kObjectReferenceCountMask, std::memory_order_release);
 		}
 	}
+
+	bool Object::IsBoundToCurrentThread() const
+	{
+		const size_t owner = _refCount.load(std::memory_order_relaxed) >> kObjectOwnerShift;
+		return (owner != 0 && owner == GetObjectOwnerToken());
+	}
+
+	size_t Object::GetReferenceCount() const
+	{
+		return _refCount.load(std::memory_order_relaxed) & kObjectReferenceCountMask;
+	}
 	
 	Object *Object::Autorelease()
 	{
@@ -380,6 +488,12 @@ namespace RN
 					delete property->_signal;
 					property->_signal = nullptr;
 				}
+
+				if(property->_changeSignal && property->_changeSignal->GetCount() == 0)
+				{
+					delete property->_changeSignal;
+					property->_changeSignal = nullptr;
+				}
 				
 				iterator = _cookies.erase(iterator);
 				continue;
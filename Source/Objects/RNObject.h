@@ -33,6 +33,12 @@ namespace RN
 		RNAPI Object *Autorelease();
 		RNAPI const Object *Autorelease() const;
 
+		// Binds the reference count to the calling thread, which then retains and releases the object without atomic
+		// operations. No other thread may retain or release it until the owner has called Share()
+		RNAPI Object *BindToCurrentThread();
+		RNAPI void Share() const;
+		RNAPI bool IsBoundToCurrentThread() const;
+
 		RNAPI virtual const String *GetDescription() const;
 		
 		RNAPI Object *Copy() const;
@@ -109,6 +115,23 @@ namespace RN
 			Connection *connection = property->_signal->Connect(std::move(function));
 			MapCookie(cookie, property, connection);
 		}
+
+		// Change observers get the old and new value through an ObservableChange instead of a Dictionary of boxed values,
+		// so notifying them doesn't allocate. They are removed through RemoveObserver() as well
+		template<class F>
+		void AddChangeObserver(const char *key, F &&function, void *cookie) const
+		{
+			ObservableProperty *property = GetPropertyForKey(key);
+			
+			if(!property)
+				throw InvalidArgumentException("No property for key ");
+
+			LockGuard<RecursiveLockable> lock(const_cast<RecursiveLockable &>(_lock));
+			property->AssertChangeSignal();
+			
+			Connection *connection = property->_changeSignal->Connect(std::move(function));
+			MapCookie(cookie, property, connection);
+		}
 		
 		void RemoveObserver(const char *key, void *cookie) const
 		{
@@ -167,6 +190,10 @@ namespace RN
 
 		RNAPI ObservableProperty *GetPropertyForKey(const char *key) const;
 		
+		void RetainBound(size_t value) const;
+		void ReleaseBatch(size_t count) const;
+		size_t GetReferenceCount() const;
+
 		RNAPI void MapCookie(void *cookie, ObservableProperty *property, Connection *connection) const;
 		RNAPI void UnmapCookie(void *cookie, ObservableProperty *property) const;
 		
@@ -22,6 +22,77 @@ namespace RN
 	Deserializer::~Deserializer()
 	{}
 	
+	
+	template<class T>
+	static void __EncodeArray(Serializer *serializer, void (Serializer::*encode)(const T &), const T *values, size_t count)
+	{
+		serializer->EncodeInt64(static_cast<int64>(count));
+		
+		for(size_t i = 0; i < count; i ++)
+			(serializer->*encode)(values[i]);
+	}
+	
+	template<class T>
+	static std::vector<T> __DecodeArray(Deserializer *deserializer, T (Deserializer::*decode)())
+	{
+		size_t count = static_cast<size_t>(deserializer->DecodeInt64());
+		
+		std::vector<T> result;
+		result.reserve(count);
+		
+		for(size_t i = 0; i < count; i ++)
+			result.push_back((deserializer->*decode)());
+		
+		return result;
+	}
+	
+	void Serializer::EncodeVector2Array(const Vector2 *values, size_t count)
+	{
+		__EncodeArray(this, &Serializer::EncodeVector2, values, count);
+	}
+	void Serializer::EncodeVector3Array(const Vector3 *values, size_t count)
+	{
+		__EncodeArray(this, &Serializer::EncodeVector3, values, count);
+	}
+	void Serializer::EncodeVector4Array(const Vector4 *values, size_t count)
+	{
+		__EncodeArray(this, &Serializer::EncodeVector4, values, count);
+	}
+	void Serializer::EncodeMatrixArray(const Matrix *values, size_t count)
+	{
+		__EncodeArray(this, &Serializer::EncodeMatrix, values, count);
+	}
+	void Serializer::EncodeQuaternionArray(const Quaternion *values, size_t count)
+	{
+		__EncodeArray(this, &Serializer::EncodeQuarternion, values, count);
+	}
+	
+	std::vector<Vector2> Deserializer::DecodeVector2Array()
+	{
+		return __DecodeArray(this, &Deserializer::DecodeVector2);
+	}
+	std::vector<Vector3> Deserializer::DecodeVector3Array()
+	{
+		return __DecodeArray(this, &Deserializer::DecodeVector3);
+	}
+	std::vector<Vector4> Deserializer::DecodeVector4Array()
+	{
+		return __DecodeArray(this, &Deserializer::DecodeVector4);
+	}
+	std::vector<Matrix> Deserializer::DecodeMatrixArray()
+	{
+		return __DecodeArray(this, &Deserializer::DecodeMatrix);
+	}
+	std::vector<Quaternion> Deserializer::DecodeQuaternionArray()
+	{
+		return __DecodeArray(this, &Deserializer::DecodeQuaternion);
+	}
+	
+	uint32 Deserializer::GetSchemaVersion() const
+	{
+		return 0;
+	}
+	
 	// ---------------------
 	// MARK: -
 	// MARK: FlatSerializer
@@ -700,4 +771,742 @@ namespace RN
 		_data->GetBytesInRange(buffer, Range(_index, size));
 		_index += size;
 	}
+	
+	
+	// ---------------------
+	// MARK: -
+	// MARK: BinarySerializer
+	// ---------------------
+	
+	/**
+	 * Layout, all values are little endian:
+	 *   Header: See __BinarySerializationHeader
+	 *   Values: A type tag followed by the value, fixed size types are stored without a size
+	 *     'b', 'i', 'l', 'f', 'd', '2', '3', '4', 'c', 'm', 'q': The raw value
+	 *     's', '+': uint64 length, bytes
+	 *     'A': Element type tag, uint64 count, padding up to the next 16 byte boundary, the elements
+	 *     '@': uint32 class index, uint32 object ID, uint64 size, the values the object encoded
+	 *     'R': uint32 object ID of an object that is defined somewhere else in the stream
+	 *     'N': nullptr
+	 *   Tables at tableOffset: uint32 length and the name for every class, followed by a uint64 stream offset for every
+	 *   object ID. Conditional objects that were never encoded for real have an offset of 0 and decode as nullptr.
+	 *
+	 * Because the size of every object is known, objects that were already decoded through a forward reference can be
+	 * skipped, and objects written by a newer schema version can be read by constructors that read less values.
+	 **/
+	
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "BinarySerializer stores values as they are in memory and needs byte swapping on big endian platforms"
+#endif
+	
+	static_assert(std::is_trivially_copyable<Vector3>::value && std::is_trivially_copyable<Matrix>::value && std::is_trivially_copyable<Quaternion>::value, "Math types must be trivially copyable");
+	
+	struct __BinarySerializationHeader
+	{
+		uint32 magic;
+		uint16 version;
+		uint16 flags;
+		uint32 schemaVersion;
+		uint32 classCount;
+		uint32 objectCount;
+		uint32 reserved;
+		uint64 tableOffset;
+	};
+	
+	static_assert(sizeof(__BinarySerializationHeader) == 32, "The header must be packed");
+	
+	static constexpr uint32 kBinarySerializationMagic = 0x53424e52; // 'RNBS'
+	static constexpr uint16 kBinarySerializationVersion = 1;
+	static constexpr size_t kBinarySerializationArrayAlignment = 16;
+	
+	struct __BinarySerializerBuffer
+	{
+		__BinarySerializerBuffer() :
+			bytes(nullptr),
+			length(0),
+			capacity(0)
+		{}
+		~__BinarySerializerBuffer()
+		{
+			free(bytes);
+		}
+		
+		uint8 *Extend(size_t size)
+		{
+			if(RN_EXPECT_FALSE(length + size > capacity))
+				Grow(length + size);
+			
+			uint8 *result = bytes + length;
+			length += size;
+			
+			return result;
+		}
+		
+		template<class T>
+		void Write(const T &value)
+		{
+			std::copy(reinterpret_cast<const uint8 *>(&value), reinterpret_cast<const uint8 *>(&value) + sizeof(T), Extend(sizeof(T)));
+		}
+		
+		void Grow(size_t required)
+		{
+			size_t tcapacity = std::max(std::max(required, capacity * 2), static_cast<size_t>(4096));
+			uint8 *tbytes = static_cast<uint8 *>(realloc(bytes, tcapacity));
+			
+			if(!tbytes)
+				throw std::bad_alloc();
+			
+			bytes = tbytes;
+			capacity = tcapacity;
+		}
+		
+		uint8 *bytes;
+		size_t length;
+		size_t capacity;
+	};
+	
+	
+	BinarySerializer::BinarySerializer(uint32 schemaVersion) :
+		_schemaVersion(schemaVersion),
+		_buffer(new __BinarySerializerBuffer()),
+		_result(nullptr)
+	{
+		Reset();
+	}
+	
+	BinarySerializer::~BinarySerializer()
+	{
+		SafeRelease(_result);
+		delete _buffer;
+	}
+	
+	void BinarySerializer::Reset()
+	{
+		SafeRelease(_result);
+		
+		_buffer->length = 0; // The header is written once the tables are appended
+		_buffer->Extend(sizeof(__BinarySerializationHeader));
+		
+		_objectIdentifiers.clear();
+		_objectOffsets.clear();
+		_classIdentifiers.clear();
+		_classes.clear();
+	}
+	
+	
+	void BinarySerializer::EncodeObject(const Object *object)
+	{
+		if(!object)
+		{
+			_buffer->Write('N');
+			return;
+		}
+		
+		if(!object->GetClass()->SupportsSerialization())
+			throw InvalidArgumentException(RNSTR("EncodeObject() only works with objects that support serialization (tried serializing '" << object->GetClass()->GetFullname() << "')!"));
+		
+		auto result = _objectIdentifiers.emplace(object, static_cast<uint32>(_objectOffsets.size()));
+		uint32 identifier = result.first->second;
+		
+		if(result.second)
+		{
+			_objectOffsets.push_back(0);
+		}
+		else if(_objectOffsets[identifier] != 0)
+		{
+			_buffer->Write('R');
+			_buffer->Write(identifier);
+			
+			return;
+		}
+		
+		EncodeDefinition(object, identifier);
+	}
+	
+	void BinarySerializer::EncodeDefinition(const Object *object, uint32 identifier)
+	{
+		const size_t offset = _buffer->length;
+		_objectOffsets[identifier] = offset; // Before serializing, so the object can't be defined twice
+		
+		_buffer->Write('@');
+		_buffer->Write(EncodeClass(object->GetClass()));
+		_buffer->Write(identifier);
+		_buffer->Write(static_cast<uint64>(0));
+		
+		const size_t begin = _buffer->length;
+		object->Serialize(this);
+		
+		uint64 size = _buffer->length - begin;
+		std::copy(reinterpret_cast<uint8 *>(&size), reinterpret_cast<uint8 *>(&size) + sizeof(uint64), _buffer->bytes + begin - sizeof(uint64));
+	}
+	
+	uint32 BinarySerializer::EncodeClass(const MetaClass *meta)
+	{
+		auto result = _classIdentifiers.emplace(meta, static_cast<uint32>(_classes.size()));
+		if(result.second)
+			_classes.push_back(meta);
+		
+		return result.first->second;
+	}
+	
+	void BinarySerializer::EncodeRootObject(const Object *object)
+	{
+		Reset();
+		EncodeObject(object);
+		AppendTables(_buffer);
+		
+		// Hand the buffer over instead of copying it
+		_result = new Data(_buffer->bytes, _buffer->length, true, true);
+		
+		_buffer->bytes = nullptr;
+		_buffer->length = 0;
+		_buffer->capacity = 0;
+	}
+	
+	void BinarySerializer::EncodeConditionalObject(const Object *object)
+	{
+		if(!object)
+		{
+			_buffer->Write('N');
+			return;
+		}
+		
+		// Gets an ID that's only backed by a definition if the object is encoded unconditionally somewhere else
+		auto result = _objectIdentifiers.emplace(object, static_cast<uint32>(_objectOffsets.size()));
+		if(result.second)
+			_objectOffsets.push_back(0);
+		
+		_buffer->Write('R');
+		_buffer->Write(result.first->second);
+	}
+	
+	Data *BinarySerializer::GetSerializedData() const
+	{
+		if(_result)
+			return _result->Retain()->Autorelease();
+		
+		__BinarySerializerBuffer buffer;
+		buffer.Grow(_buffer->length);
+		
+		std::copy(_buffer->bytes, _buffer->bytes + _buffer->length, buffer.Extend(_buffer->length));
+		AppendTables(&buffer);
+		
+		Data *data = new Data(buffer.bytes, buffer.length, true, true);
+		buffer.bytes = nullptr;
+		
+		return data->Autorelease();
+	}
+	
+	void BinarySerializer::AppendTables(__BinarySerializerBuffer *buffer) const
+	{
+		__BinarySerializationHeader header;
+		header.magic = kBinarySerializationMagic;
+		header.version = kBinarySerializationVersion;
+		header.flags = 0;
+		header.schemaVersion = _schemaVersion;
+		header.classCount = static_cast<uint32>(_classes.size());
+		header.objectCount = static_cast<uint32>(_objectOffsets.size());
+		header.reserved = 0;
+		header.tableOffset = buffer->length;
+		
+		for(const MetaClass *meta : _classes)
+		{
+			const std::string &name = meta->GetFullname();
+			
+			buffer->Write(static_cast<uint32>(name.length()));
+			std::copy(name.begin(), name.end(), buffer->Extend(name.length()));
+		}
+		
+		if(!_objectOffsets.empty())
+			std::copy(_objectOffsets.begin(), _objectOffsets.end(), reinterpret_cast<uint64 *>(buffer->Extend(_objectOffsets.size() * sizeof(uint64))));
+		
+		std::copy(reinterpret_cast<uint8 *>(&header), reinterpret_cast<uint8 *>(&header) + sizeof(header), buffer->bytes);
+	}
+	
+	void BinarySerializer::EncodeBytes(void *data, size_t size)
+	{
+		_buffer->Write('+');
+		_buffer->Write(static_cast<uint64>(size));
+		
+		if(size > 0)
+			std::copy(static_cast<uint8 *>(data), static_cast<uint8 *>(data) + size, _buffer->Extend(size));
+	}
+	
+	void BinarySerializer::EncodeString(const std::string &string)
+	{
+		_buffer->Write('s');
+		_buffer->Write(static_cast<uint64>(string.length()));
+		
+		std::copy(string.begin(), string.end(), _buffer->Extend(string.length()));
+	}
+	
+	void BinarySerializer::EncodeBool(bool value)
+	{
+		_buffer->Write('b');
+		_buffer->Write(static_cast<uint8>(value));
+	}
+	
+	void BinarySerializer::EncodeDouble(double value)
+	{
+		_buffer->Write('d');
+		_buffer->Write(value);
+	}
+	
+	void BinarySerializer::EncodeFloat(float value)
+	{
+		_buffer->Write('f');
+		_buffer->Write(value);
+	}
+	
+	void BinarySerializer::EncodeInt32(int32 value)
+	{
+		_buffer->Write('i');
+		_buffer->Write(value);
+	}
+	
+	void BinarySerializer::EncodeInt64(int64 value)
+	{
+		_buffer->Write('l');
+		_buffer->Write(value);
+	}
+	
+	void BinarySerializer::EncodeVector2(const Vector2 &value)
+	{
+		_buffer->Write('2');
+		_buffer->Write(value);
+	}
+	void BinarySerializer::EncodeVector3(const Vector3 &value)
+	{
+		_buffer->Write('3');
+		_buffer->Write(value);
+	}
+	void BinarySerializer::EncodeVector4(const Vector4 &value)
+	{
+		_buffer->Write('4');
+		_buffer->Write(value);
+	}
+	void BinarySerializer::EncodeColor(const Color &value)
+	{
+		_buffer->Write('c');
+		_buffer->Write(value);
+	}
+	
+	void BinarySerializer::EncodeMatrix(const Matrix &value)
+	{
+		_buffer->Write('m');
+		_buffer->Write(value);
+	}
+	void BinarySerializer::EncodeQuarternion(const Quaternion &value)
+	{
+		_buffer->Write('q');
+		_buffer->Write(value);
+	}
+	
+	void BinarySerializer::EncodeVector2Array(const Vector2 *values, size_t count)
+	{
+		EncodeArray('2', values, sizeof(Vector2), count);
+	}
+	void BinarySerializer::EncodeVector3Array(const Vector3 *values, size_t count)
+	{
+		EncodeArray('3', values, sizeof(Vector3), count);
+	}
+	void BinarySerializer::EncodeVector4Array(const Vector4 *values, size_t count)
+	{
+		EncodeArray('4', values, sizeof(Vector4), count);
+	}
+	void BinarySerializer::EncodeMatrixArray(const Matrix *values, size_t count)
+	{
+		EncodeArray('m', values, sizeof(Matrix), count);
+	}
+	void BinarySerializer::EncodeQuaternionArray(const Quaternion *values, size_t count)
+	{
+		EncodeArray('q', values, sizeof(Quaternion), count);
+	}
+	
+	void BinarySerializer::EncodeArray(char type, const void *values, size_t size, size_t count)
+	{
+		_buffer->Write('A');
+		_buffer->Write(type);
+		_buffer->Write(static_cast<uint64>(count));
+		
+		const size_t padding = (kBinarySerializationArrayAlignment - (_buffer->length % kBinarySerializationArrayAlignment)) % kBinarySerializationArrayAlignment;
+		uint8 *bytes = _buffer->Extend(padding + size * count);
+		
+		std::fill(bytes, bytes + padding, 0);
+		
+		if(count > 0)
+			std::copy(static_cast<const uint8 *>(values), static_cast<const uint8 *>(values) + size * count, bytes + padding);
+	}
+	
+	
+	// ---------------------
+	// MARK: -
+	// MARK: BinaryDeserializer
+	// ---------------------
+	
+	BinaryDeserializer::BinaryDeserializer(Data *data)
+	{
+		// Arrays can only be handed out without copying if the data is aligned like the stream was, which mappings and heap memory are
+		if(reinterpret_cast<uintptr_t>(data->GetBytes()) % kBinarySerializationArrayAlignment)
+			_data = data->Copy();
+		else
+			_data = data->Retain();
+		
+		_begin  = _data->GetBytes<uint8>();
+		_cursor = _begin;
+		_end    = _begin + _data->GetLength();
+		
+		__BinarySerializationHeader header = Read<__BinarySerializationHeader>();
+		
+		if(header.magic != kBinarySerializationMagic)
+			throw InconsistencyException("Data wasn't written by a BinarySerializer");
+		if(header.version > kBinarySerializationVersion)
+			throw InconsistencyException(RNSTR("Data was written with a newer BinarySerializer version (" << header.version << ")"));
+		if(header.tableOffset < sizeof(header) || header.tableOffset > _data->GetLength())
+			throw InconsistencyException("Corrupted BinarySerializer header");
+		
+		_schemaVersion = header.schemaVersion;
+		
+		// Resolve the classes once up front
+		const uint8 *stream = _cursor;
+		_cursor = _begin + header.tableOffset;
+		
+		Catalogue *catalogue = Catalogue::GetSharedInstance();
+		_classes.reserve(header.classCount);
+		
+		for(uint32 i = 0; i < header.classCount; i ++)
+		{
+			uint32 length = Read<uint32>();
+			const char *name = reinterpret_cast<const char *>(Advance(length));
+			
+			_classes.push_back(catalogue->GetClassWithName(std::string(name, length)));
+		}
+		
+		const uint8 *offsets = Advance(header.objectCount * sizeof(uint64));
+		
+		_objectOffsets.resize(header.objectCount);
+		std::copy(offsets, _cursor, reinterpret_cast<uint8 *>(_objectOffsets.data()));
+		
+		_objects.resize(header.objectCount, nullptr);
+		_decoding.resize(header.objectCount, false);
+		
+		_cursor = stream;
+		_end    = _begin + header.tableOffset;
+	}
+	
+	BinaryDeserializer::~BinaryDeserializer()
+	{
+		for(Object *object : _objects)
+		{
+			if(object)
+				object->Autorelease();
+		}
+		
+		_data->Release();
+	}
+	
+	uint32 BinaryDeserializer::GetSchemaVersion() const
+	{
+		return _schemaVersion;
+	}
+	
+	
+	const uint8 *BinaryDeserializer::Advance(size_t size)
+	{
+		if(RN_EXPECT_FALSE(static_cast<size_t>(_end - _cursor) < size))
+			throw InconsistencyException("Unexpected end of data");
+		
+		const uint8 *result = _cursor;
+		_cursor += size;
+		
+		return result;
+	}
+	
+	template<class T>
+	T BinaryDeserializer::Read()
+	{
+		T result;
+		
+		const uint8 *bytes = Advance(sizeof(T));
+		std::copy(bytes, bytes + sizeof(T), reinterpret_cast<uint8 *>(&result));
+		
+		return result;
+	}
+	
+	char BinaryDeserializer::DecodeType()
+	{
+		return Read<char>();
+	}
+	
+	void BinaryDeserializer::AssertType(char expected)
+	{
+		char type = DecodeType();
+		
+		if(RN_EXPECT_FALSE(type != expected))
+			throw InconsistencyException(RNSTRF("Expected type %c but got %c!", expected, type));
+	}
+	
+	
+	Object *BinaryDeserializer::DecodeObject()
+	{
+		char type = DecodeType();
+		
+		switch(type)
+		{
+			case 'N':
+				return nullptr;
+			case 'R':
+				return DecodeReference(Read<uint32>());
+			case '@':
+				return DecodeDefinition();
+				
+			default:
+				throw InconsistencyException(RNSTRF("Expected an object but got %c!", type));
+		}
+	}
+	
+	Object *BinaryDeserializer::DecodeDefinition()
+	{
+		uint32 index = Read<uint32>();
+		uint32 identifier = Read<uint32>();
+		uint64 size = Read<uint64>();
+		
+		if(index >= _classes.size() || identifier >= _objects.size() || size > static_cast<uint64>(_end - _cursor))
+			throw InconsistencyException("Corrupted object definition");
+		
+		const uint8 *end = _cursor + size;
+		
+		// Already decoded through a forward reference
+		if(_objects[identifier])
+		{
+			_cursor = end;
+			return _objects[identifier];
+		}
+		
+		MetaClass *meta = _classes[index];
+		if(!meta || !meta->SupportsSerialization())
+			throw InconsistencyException("Can't decode object of unknown or unserializable class");
+		
+		_decoding[identifier] = true;
+		
+		Object *object = meta->ConstructWithDeserializer(this);
+		
+		_decoding[identifier] = false;
+		_objects[identifier] = object;
+		
+		if(_cursor > end)
+			throw InconsistencyException(RNSTR("Object of class " << meta->GetFullname() << " read past its end"));
+		
+		_cursor = end; // Skip whatever values a newer schema version added
+		return object;
+	}
+	
+	Object *BinaryDeserializer::DecodeReference(uint32 identifier)
+	{
+		if(identifier >= _objects.size())
+			throw InconsistencyException("Corrupted object reference");
+		
+		if(_objects[identifier])
+			return _objects[identifier];
+		
+		uint64 offset = _objectOffsets[identifier];
+		if(offset == 0)
+			return nullptr; // Conditional object that was never encoded
+		
+		if(_decoding[identifier])
+			throw InconsistencyException("Can't decode an object graph with a cycle");
+		
+		if(offset >= static_cast<uint64>(_end - _begin))
+			throw InconsistencyException("Corrupted object reference");
+		
+		// Forward reference, decode the definition out of order and skip it once it's reached
+		const uint8 *cursor = _cursor;
+		_cursor = _begin + offset;
+		
+		AssertType('@');
+		Object *object = DecodeDefinition();
+		
+		_cursor = cursor;
+		return object;
+	}
+	
+	void *BinaryDeserializer::DecodeBytes(size_t *length)
+	{
+		AssertType('+');
+		
+		size_t size = static_cast<size_t>(Read<uint64>());
+		const uint8 *bytes = Advance(size);
+		
+		if(length)
+			*length = size;
+		
+		return const_cast<uint8 *>(bytes);
+	}
+	
+	std::string BinaryDeserializer::DecodeString()
+	{
+		AssertType('s');
+		
+		size_t size = static_cast<size_t>(Read<uint64>());
+		const char *bytes = reinterpret_cast<const char *>(Advance(size));
+		
+		return std::string(bytes, size);
+	}
+	
+	bool BinaryDeserializer::DecodeBool()
+	{
+		AssertType('b');
+		return (Read<uint8>() != 0);
+	}
+	
+	double BinaryDeserializer::DecodeDouble()
+	{
+		char type = DecodeType();
+		
+		switch(type)
+		{
+			case 'd':
+				return Read<double>();
+			case 'f':
+				return Read<float>();
+				
+			default:
+				throw InconsistencyException(RNSTRF("Expected type d but got %c!", type));
+		}
+	}
+	
+	float BinaryDeserializer::DecodeFloat()
+	{
+		char type = DecodeType();
+		
+		switch(type)
+		{
+			case 'f':
+				return Read<float>();
+			case 'd':
+				return static_cast<float>(Read<double>());
+				
+			default:
+				throw InconsistencyException(RNSTRF("Expected type f but got %c!", type));
+		}
+	}
+	
+	int32 BinaryDeserializer::DecodeInt32()
+	{
+		char type = DecodeType();
+		
+		switch(type)
+		{
+			case 'i':
+				return Read<int32>();
+			case 'l':
+				return static_cast<int32>(Read<int64>());
+				
+			default:
+				throw InconsistencyException(RNSTRF("Expected type i but got %c!", type));
+		}
+	}
+	
+	int64 BinaryDeserializer::DecodeInt64()
+	{
+		char type = DecodeType();
+		
+		switch(type)
+		{
+			case 'l':
+				return Read<int64>();
+			case 'i':
+				return Read<int32>();
+				
+			default:
+				throw InconsistencyException(RNSTRF("Expected type l but got %c!", type));
+		}
+	}
+	
+	Vector2 BinaryDeserializer::DecodeVector2()
+	{
+		AssertType('2');
+		return Read<Vector2>();
+	}
+	Vector3 BinaryDeserializer::DecodeVector3()
+	{
+		AssertType('3');
+		return Read<Vector3>();
+	}
+	Vector4 BinaryDeserializer::DecodeVector4()
+	{
+		AssertType('4');
+		return Read<Vector4>();
+	}
+	Color BinaryDeserializer::DecodeColor()
+	{
+		AssertType('c');
+		return Read<Color>();
+	}
+	
+	Matrix BinaryDeserializer::DecodeMatrix()
+	{
+		AssertType('m');
+		return Read<Matrix>();
+	}
+	Quaternion BinaryDeserializer::DecodeQuaternion()
+	{
+		AssertType('q');
+		return Read<Quaternion>();
+	}
+	
+	const void *BinaryDeserializer::DecodeArray(char type, size_t size, size_t *count)
+	{
+		AssertType('A');
+		
+		char element = DecodeType();
+		if(element != type)
+			throw InconsistencyException(RNSTRF("Expected array of type %c but got %c!", type, element));
+		
+		uint64 tcount = Read<uint64>();
+		
+		Advance((kBinarySerializationArrayAlignment - ((_cursor - _begin) % kBinarySerializationArrayAlignment)) % kBinarySerializationArrayAlignment);
+		
+		if(tcount > static_cast<uint64>(_end - _cursor) / size)
+			throw InconsistencyException("Unexpected end of data");
+		
+		*count = static_cast<size_t>(tcount);
+		return Advance(static_cast<size_t>(tcount) * size);
+	}
+	
+	std::vector<Vector2> BinaryDeserializer::DecodeVector2Array()
+	{
+		size_t count;
+		const Vector2 *values = DecodeVector2ArrayNoCopy(&count);
+		
+		return std::vector<Vector2>(values, values + count);
+	}
+	std::vector<Vector3> BinaryDeserializer::DecodeVector3Array()
+	{
+		size_t count;
+		const Vector3 *values = DecodeVector3ArrayNoCopy(&count);
+		
+		return std::vector<Vector3>(values, values + count);
+	}
+	std::vector<Vector4> BinaryDeserializer::DecodeVector4Array()
+	{
+		size_t count;
+		const Vector4 *values = DecodeVector4ArrayNoCopy(&count);
+		
+		return std::vector<Vector4>(values, values + count);
+	}
+	std::vector<Matrix> BinaryDeserializer::DecodeMatrixArray()
+	{
+		size_t count;
+		const Matrix *values = DecodeMatrixArrayNoCopy(&count);
+		
+		return std::vector<Matrix>(values, values + count);
+	}
+	std::vector<Quaternion> BinaryDeserializer::DecodeQuaternionArray()
+	{
+		size_t count;
+		const Quaternion *values = DecodeQuaternionArrayNoCopy(&count);
+		
+		return std::vector<Quaternion>(values, values + count);
+	}
 }
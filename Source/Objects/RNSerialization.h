@@ -44,6 +44,13 @@ namespace RN
 		RNAPI virtual void EncodeMatrix(const Matrix &value) = 0;
 		RNAPI virtual void EncodeQuarternion(const Quaternion &value) = 0;
 		
+		// Serializers that can, store the arrays as one block. The default implementations encode the count followed by every element
+		RNAPI virtual void EncodeVector2Array(const Vector2 *values, size_t count);
+		RNAPI virtual void EncodeVector3Array(const Vector3 *values, size_t count);
+		RNAPI virtual void EncodeVector4Array(const Vector4 *values, size_t count);
+		RNAPI virtual void EncodeMatrixArray(const Matrix *values, size_t count);
+		RNAPI virtual void EncodeQuaternionArray(const Quaternion *values, size_t count);
+		
 		RNAPI virtual Data *GetSerializedData() const = 0;
 		
 	protected:
@@ -73,6 +80,15 @@ namespace RN
 		RNAPI virtual Matrix DecodeMatrix() = 0;
 		RNAPI virtual Quaternion DecodeQuaternion() = 0;
 		
+		RNAPI virtual std::vector<Vector2> DecodeVector2Array();
+		RNAPI virtual std::vector<Vector3> DecodeVector3Array();
+		RNAPI virtual std::vector<Vector4> DecodeVector4Array();
+		RNAPI virtual std::vector<Matrix> DecodeMatrixArray();
+		RNAPI virtual std::vector<Quaternion> DecodeQuaternionArray();
+		
+		// The schema version the data was written with, so constructors can keep reading older data
+		RNAPI virtual uint32 GetSchemaVersion() const;
+		
 	protected:
 		RNAPI virtual ~Deserializer();
 		
@@ -158,10 +174,137 @@ namespace RN
 		std::unordered_map<uint64, Object *> _objectTable;
 	};
 	
+	
+	
+	struct __BinarySerializerBuffer;
+	
+	// Tagged little endian format meant for big snapshots, like scenes that are streamed in or server checkpoints.
+	// Every object in the graph is written once and referred to by its ID afterwards, class names are only stored
+	// once in a table at the end. Arrays of math types are stored as one 16 byte aligned block.
+	class BinarySerializer : public Serializer
+	{
+	public:
+		RNAPI BinarySerializer(uint32 schemaVersion = 0);
+		RNAPI ~BinarySerializer() override;
+		
+		RNAPI void EncodeBytes(void *data, size_t size) override;
+		RNAPI void EncodeObject(const Object *object) override;
+		RNAPI void EncodeRootObject(const Object *object) override;
+		RNAPI void EncodeConditionalObject(const Object *object) override;
+		RNAPI void EncodeString(const std::string &string) override;
+		
+		RNAPI void EncodeBool(bool value) override;
+		RNAPI void EncodeDouble(double value) override;
+		RNAPI void EncodeFloat(float value) override;
+		RNAPI void EncodeInt32(int32 value) override;
+		RNAPI void EncodeInt64(int64 value) override;
+		
+		RNAPI void EncodeVector2(const Vector2 &value) override;
+		RNAPI void EncodeVector3(const Vector3 &value) override;
+		RNAPI void EncodeVector4(const Vector4 &value) override;
+		RNAPI void EncodeColor(const Color &color) override;
+		
+		RNAPI void EncodeMatrix(const Matrix &value) override;
+		RNAPI void EncodeQuarternion(const Quaternion &value) override;
+		
+		RNAPI void EncodeVector2Array(const Vector2 *values, size_t count) override;
+		RNAPI void EncodeVector3Array(const Vector3 *values, size_t count) override;
+		RNAPI void EncodeVector4Array(const Vector4 *values, size_t count) override;
+		RNAPI void EncodeMatrixArray(const Matrix *values, size_t count) override;
+		RNAPI void EncodeQuaternionArray(const Quaternion *values, size_t count) override;
+		
+		// After EncodeRootObject() this hands out the encoded buffer itself, otherwise the tables are appended to a copy
+		RNAPI Data *GetSerializedData() const override;
+		
+	private:
+		void Reset();
+		void AppendTables(__BinarySerializerBuffer *buffer) const;
+		void EncodeArray(char type, const void *values, size_t size, size_t count);
+		void EncodeDefinition(const Object *object, uint32 identifier);
+		uint32 EncodeClass(const MetaClass *meta);
+		
+		uint32 _schemaVersion;
+		__BinarySerializerBuffer *_buffer;
+		Data *_result;
+		
+		std::unordered_map<const Object *, uint32> _objectIdentifiers;
+		std::vector<uint64> _objectOffsets; // 0 for objects that were only encoded conditionally so far
+		std::unordered_map<const MetaClass *, uint32> _classIdentifiers;
+		std::vector<const MetaClass *> _classes;
+	};
+	
+	// Decodes straight out of the passed data without copying it, so the data of a memory mapped File (see File::ReadData())
+	// is only paged in as it's read. DecodeBytes() and the NoCopy array variants return pointers into the data.
+	// Decoded objects are autoreleased when the deserializer goes away.
+	class BinaryDeserializer : public Deserializer
+	{
+	public:
+		RNAPI BinaryDeserializer(Data *data);
+		RNAPI ~BinaryDeserializer() override;
+		
+		RNAPI void *DecodeBytes(size_t *length) override;
+		RNAPI Object *DecodeObject() override;
+		RNAPI std::string DecodeString() override;
+		
+		RNAPI bool DecodeBool() override;
+		RNAPI double DecodeDouble() override;
+		RNAPI float DecodeFloat() override;
+		RNAPI int32 DecodeInt32() override;
+		RNAPI int64 DecodeInt64() override;
+		
+		RNAPI Vector2 DecodeVector2() override;
+		RNAPI Vector3 DecodeVector3() override;
+		RNAPI Vector4 DecodeVector4() override;
+		RNAPI Color DecodeColor() override;
+		
+		RNAPI Matrix DecodeMatrix() override;
+		RNAPI Quaternion DecodeQuaternion() override;
+		
+		RNAPI std::vector<Vector2> DecodeVector2Array() override;
+		RNAPI std::vector<Vector3> DecodeVector3Array() override;
+		RNAPI std::vector<Vector4> DecodeVector4Array() override;
+		RNAPI std::vector<Matrix> DecodeMatrixArray() override;
+		RNAPI std::vector<Quaternion> DecodeQuaternionArray() override;
+		
+		const Vector2 *DecodeVector2ArrayNoCopy(size_t *count) { return static_cast<const Vector2 *>(DecodeArray('2', sizeof(Vector2), count)); }
+		const Vector3 *DecodeVector3ArrayNoCopy(size_t *count) { return static_cast<const Vector3 *>(DecodeArray('3', sizeof(Vector3), count)); }
+		const Vector4 *DecodeVector4ArrayNoCopy(size_t *count) { return static_cast<const Vector4 *>(DecodeArray('4', sizeof(Vector4), count)); }
+		const Matrix *DecodeMatrixArrayNoCopy(size_t *count) { return static_cast<const Matrix *>(DecodeArray('m', sizeof(Matrix), count)); }
+		const Quaternion *DecodeQuaternionArrayNoCopy(size_t *count) { return static_cast<const Quaternion *>(DecodeArray('q', sizeof(Quaternion), count)); }
+		
+		RNAPI uint32 GetSchemaVersion() const override;
+		
+	private:
+		template<class T>
+		T Read();
+		const uint8 *Advance(size_t size);
+		char DecodeType();
+		void AssertType(char expected);
+		
+		RNAPI const void *DecodeArray(char type, size_t size, size_t *count);
+		
+		Object *DecodeDefinition();
+		Object *DecodeReference(uint32 identifier);
+		
+		Data *_data;
+		const uint8 *_begin;
+		const uint8 *_cursor;
+		const uint8 *_end;
+		
+		uint32 _schemaVersion;
+		
+		std::vector<MetaClass *> _classes;
+		std::vector<uint64> _objectOffsets;
+		std::vector<Object *> _objects;
+		std::vector<bool> _decoding;
+	};
+	
 	RNObjectClass(Serializer)
 	RNObjectClass(Deserializer)
 	RNObjectClass(FlatSerializer)
 	RNObjectClass(FlatDeserializer)
+	RNObjectClass(BinarySerializer)
+	RNObjectClass(BinaryDeserializer)
 }
 
 #endif /* __RAYNE_SERIALIZATION_H__ */
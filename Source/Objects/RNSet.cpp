@@ -19,41 +19,28 @@ namespace RN
 	class SetInternal
 	{
 	public:
-		struct Bucket
+		struct Entry
 		{
-			Bucket()
-			{
-				object = nullptr;
-				next   = nullptr;
-			}
-			
-			Bucket(const Bucket *other)
-			{
-				object = SafeRetain(other->object);
-				next   = nullptr;
-			}
-			
-			~Bucket()
+			bool WrapsLookup(const Object *lookup) const
 			{
-				SafeRelease(object);
+				return (object == lookup || lookup->IsEqual(object));
 			}
-			
-			
-			bool WrapsLookup(const Object *lookup) const
+
+			void Retain()
 			{
-				return (object && lookup->IsEqual(object));
+				object->Retain();
 			}
-			
-			size_t GetHash() const
+
+			void Release()
 			{
-				return object->GetHash();
+				object->Release();
 			}
 			
+			size_t hash;
 			Object *object;
-			Bucket *next;
 		};
 		
-		HashTableCore<Bucket> hashTable;
+		HashTableCore<Entry> hashTable;
 	};
 	
 	Set::Set()
@@ -128,7 +115,7 @@ namespace RN
 
 	const String *Set::GetDescription() const
 	{
-		if(_internals->hashTable._count == 0)
+		if(_internals->hashTable.GetCount() == 0)
 			return RNCSTR("[]");
 
 		String *result = String::WithString("[\n", false);
@@ -148,17 +135,9 @@ namespace RN
 	{
 		Array *array = new Array(_internals->hashTable.GetCount());
 		
-		for(size_t i = 0; i < _internals->hashTable._capacity; i++)
-		{
-			SetInternal::Bucket *bucket = _internals->hashTable._buckets[i];
-			while(bucket)
-			{
-				if(bucket->object)
-					array->AddObject(bucket->object);
-				
-				bucket = bucket->next;
-			}
-		}
+		_internals->hashTable.Enumerate([&](const SetInternal::Entry &entry, bool &stop) {
+			array->AddObject(entry.object);
+		});
 		
 		return array->Autorelease();
 	}
@@ -178,87 +157,66 @@ namespace RN
 		if(GetCount() != otherSet->GetCount())
 			return false;
 
-		for(size_t i = 0; i < _internals->hashTable._capacity; i ++)
-		{
-			SetInternal::Bucket *bucket = _internals->hashTable._buckets[i];
-			while(bucket)
-			{
-				if(bucket->object && !otherSet->ContainsObject(bucket->object))
-					return false;
+		bool result = true;
+
+		_internals->hashTable.Enumerate([&](const SetInternal::Entry &entry, bool &stop) {
 
-				bucket = bucket->next;
+			if(!otherSet->ContainsObject(entry.object))
+			{
+				result = false;
+				stop = true;
 			}
-		}
 
-		return true;
+		});
+
+		return result;
 	}
 	size_t Set::GetHash() const
 	{
-		return std::hash<size_t>{}(_internals->hashTable._count);
+		return std::hash<size_t>{}(_internals->hashTable.GetCount());
 	}
 
 	void Set::AddObject(Object *object)
 	{
-		bool create;
-		SetInternal::Bucket *bucket = _internals->hashTable.FindBucket(object, create);
+		bool created;
+		SetInternal::Entry *entry = _internals->hashTable.FindEntry(object, created);
 		
-		if(bucket && create)
-		{
-			bucket->object = object->Retain();
-			_internals->hashTable.GrowIfPossible();
-		}
+		if(created)
+			entry->object = object->Retain();
 	}
 	
 	void Set::RemoveObject(const Object *key)
 	{
-		SetInternal::Bucket *bucket = _internals->hashTable.FindBucket(key);
-		if(bucket)
+		SetInternal::Entry *entry = _internals->hashTable.FindEntry(key);
+		if(entry)
 		{
-			SafeRelease(bucket->object);
-			
-			_internals->hashTable.ResignBucket(bucket);
+			_internals->hashTable.RemoveEntry(entry);
 			_internals->hashTable.CollapseIfPossible();
 		}
 	}
 	
 	void Set::RemoveAllObjects()
 	{
-		_internals->hashTable.RemoveAllBuckets();
+		_internals->hashTable.RemoveAllEntries();
 	}
 	
 	bool Set::ContainsObject(const Object *object) const
 	{
-		SetInternal::Bucket *bucket = _internals->hashTable.FindBucket(object);
-		return (bucket != nullptr);
+		return _internals->hashTable.ContainsObject(object);
 	}
 
 	Object *Set::__GetObject(const Object *object) const
 	{
-		SetInternal::Bucket *bucket = _internals->hashTable.FindBucket(object);
-		return bucket->object;
+		SetInternal::Entry *entry = _internals->hashTable.FindEntry(object);
+		return entry->object;
 	}
 	
 	
 	
 	void Set::Enumerate(const std::function<void (Object *, bool &)>& callback) const
 	{
-		bool stop = false;
-		
-		for(size_t i = 0; i < _internals->hashTable._capacity; i ++)
-		{
-			SetInternal::Bucket *bucket = _internals->hashTable._buckets[i];
-			while(bucket)
-			{
-				if(bucket->object)
-				{
-					callback(bucket->object, stop);
-					
-					if(stop)
-						return;
-				}
-				
-				bucket = bucket->next;
-			}
-		}
+		_internals->hashTable.Enumerate([&](const SetInternal::Entry &entry, bool &stop) {
+			callback(entry.object, stop);
+		});
 	}
 }
@@ -204,8 +204,12 @@ namespace RN
 		if(!string)
 			return false;
 
-		if(string->GetLength() != GetLength())
+		if(string->GetLength() != GetLength() || string->GetHash() != GetHash())
 			return false;
+
+		// Interned constant strings with the same content share their storage
+		if(_string->HasSameStorage(string->_string))
+			return true;
 		
 		return (Compare(string) == ComparisonResult::EqualTo);
 	}
@@ -7,6 +7,7 @@
 //
 
 #include <utf8.h>
+#include <cstring>
 #include "../Math/RNAlgorithm.h"
 #include "RNStringInternal.h"
 #include "RNString.h"
@@ -14,25 +15,153 @@
 
 namespace RN
 {
-	static std::unordered_map<const void *, UTF8String *> _stringTable;
+	/**
+	 * Constant strings are interned by the address of their literal in an open addressed table that only ever grows.
+	 * Lookups probe it without taking a lock: writers insert under the lock and publish the value before the key,
+	 * and growing publishes a complete copy of the table. Replaced tables stay alive, readers might still be probing them.
+	 * Literals with the same content share one canonical string, so their storage can be compared by pointer.
+	 **/
+
+	struct __StringPoolSlot
+	{
+		std::atomic<const void *> key;
+		std::atomic<UTF8String *> value;
+	};
+
+	struct __StringPoolTable
+	{
+		size_t mask;
+		size_t count;
+		__StringPoolSlot *slots;
+	};
+
+	static constexpr size_t kStringPoolInitialCapacity = 1024;
+
+	static std::atomic<__StringPoolTable *> _stringTable(nullptr);
+	static std::vector<__StringPoolTable *> _retiredStringTables;
+	static std::unordered_multimap<size_t, UTF8String *> _canonicalStrings;
 	static Lockable _stringTableLock;
 
-	UTF8String *StringPool::CreateUTF8String(const void *string)
+	static inline size_t StringPoolSlotForKey(const void *key, size_t mask)
+	{
+		uint64 hash = static_cast<uint64>(reinterpret_cast<uintptr_t>(key)) * 0x9e3779b97f4a7c15ULL;
+		return static_cast<size_t>(hash >> 32) & mask;
+	}
+
+	static __StringPoolTable *StringPoolCreateTable(size_t capacity)
+	{
+		__StringPoolTable *table = new __StringPoolTable();
+		table->mask = capacity - 1;
+		table->count = 0;
+		table->slots = new __StringPoolSlot[capacity];
+
+		for(size_t i = 0; i < capacity; i ++)
+		{
+			table->slots[i].key.store(nullptr, std::memory_order_relaxed);
+			table->slots[i].value.store(nullptr, std::memory_order_relaxed);
+		}
+
+		return table;
+	}
+
+	static void StringPoolInsert(__StringPoolTable *table, const void *key, UTF8String *value)
+	{
+		size_t index = StringPoolSlotForKey(key, table->mask);
+
+		while(table->slots[index].key.load(std::memory_order_relaxed))
+			index = (index + 1) & table->mask;
+
+		table->slots[index].value.store(value, std::memory_order_relaxed);
+		table->slots[index].key.store(key, std::memory_order_release);
+		table->count ++;
+	}
+
+	static UTF8String *StringPoolLookup(const __StringPoolTable *table, const void *key)
 	{
-		UTF8String *source;
+		if(!table)
+			return nullptr;
+
+		size_t index = StringPoolSlotForKey(key, table->mask);
 
+		while(1)
 		{
-			LockGuard<Lockable> lock(_stringTableLock);
-			source = _stringTable[string];
+			const void *slotKey = table->slots[index].key.load(std::memory_order_acquire);
 
-			if(!source)
+			if(slotKey == key)
+				return table->slots[index].value.load(std::memory_order_relaxed);
+			if(!slotKey)
+				return nullptr;
+
+			index = (index + 1) & table->mask;
+		}
+	}
+
+	static UTF8String *StringPoolInternSlow(const void *string)
+	{
+		LockGuard<Lockable> lock(_stringTableLock);
+
+		__StringPoolTable *table = _stringTable.load(std::memory_order_relaxed);
+
+		UTF8String *source = StringPoolLookup(table, string);
+		if(source)
+			return source;
+
+		source = new UTF8String(reinterpret_cast<const uint8 *>(string), kRNNotFound, false);
+
+		const size_t hash = source->GetHash();
+		const size_t bytesCount = source->GetBytesCount();
+
+		bool isCanonical = true;
+
+		auto range = _canonicalStrings.equal_range(hash);
+		for(auto iterator = range.first; iterator != range.second; iterator ++)
+		{
+			UTF8String *canonical = iterator->second;
+
+			if(canonical->GetBytesCount() == bytesCount && std::memcmp(canonical->GetBytes(), source->GetBytes(), bytesCount) == 0)
 			{
-				source = new UTF8String(reinterpret_cast<const uint8 *>(string), kRNNotFound, false);
-				_stringTable[string] = source;
+				source->Release();
+				source = canonical;
+				isCanonical = false;
+				break;
 			}
+		}
+
+		if(isCanonical)
+			_canonicalStrings.emplace(hash, source);
 
+		if(!table || (table->count + 1) * 2 > (table->mask + 1))
+		{
+			__StringPoolTable *grown = StringPoolCreateTable(table ? (table->mask + 1) * 2 : kStringPoolInitialCapacity);
+
+			if(table)
+			{
+				for(size_t i = 0; i <= table->mask; i ++)
+				{
+					const void *key = table->slots[i].key.load(std::memory_order_relaxed);
+					if(key)
+						StringPoolInsert(grown, key, table->slots[i].value.load(std::memory_order_relaxed));
+				}
+
+				_retiredStringTables.push_back(table);
+			}
+
+			StringPoolInsert(grown, string, source);
+			_stringTable.store(grown, std::memory_order_release);
+
+			return source;
 		}
 
+		StringPoolInsert(table, string, source);
+		return source;
+	}
+
+	UTF8String *StringPool::CreateUTF8String(const void *string)
+	{
+		UTF8String *source = StringPoolLookup(_stringTable.load(std::memory_order_acquire), string);
+		if(RN_EXPECT_FALSE(!source))
+			source = StringPoolInternSlow(string);
+
 		UTF8String *temp = new UTF8String(source->_constStorage, source->_length, source->_hash, source->_flags);
 		return temp;
 	}
@@ -41,7 +41,8 @@ namespace RN
 		
 		UTF8String *MutableCopy() const;
 		
-		size_t GetHash() const override { const_cast<UTF8String *>(this)->RecalcuateHash(); return _hash; }
+		size_t GetHash() const override { return _hash; } // Kept up to date by every mutation
+		bool HasSameStorage(const UTF8String *other) const { return (GetBytes() == other->GetBytes() && GetBytesCount() == other->GetBytesCount()); }
 		size_t GetLength() const { return _length; }
 		bool IsMutable() const { return !(_flags & Flags::ConstStorage); }
 		
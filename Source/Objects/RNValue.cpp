@@ -19,23 +19,41 @@ namespace RN
 		_size(other->_size),
 		_alignment(other->_alignment)
 	{
-		_storage = reinterpret_cast<uint8 *>(Memory::AllocateAligned(_size, _alignment));
+		_storage = AllocateStorage(_size, _alignment);
 		std::copy(other->_storage, other->_storage + _size, _storage);
 	}
 	
-	Value::Value(Deserializer *deserializer)
+	Value::Value(Deserializer *deserializer) :
+		_alignment(16)
 	{
 		_type = static_cast<char>(deserializer->DecodeInt32());
 		
 		uint8 *source = static_cast<uint8 *>(deserializer->DecodeBytes(&_size));
 		
-		_storage = reinterpret_cast<uint8 *>(Memory::AllocateAligned(_size, _alignment));
+		_storage = AllocateStorage(_size, _alignment);
 		std::copy(source, source + _size, _storage);
 	}
 	
 	Value::~Value()
 	{
-		Memory::FreeAligned(_storage);
+		FreeStorage(_storage, _alignment);
+	}
+	
+	// MemoryPool blocks are 16 byte aligned, which covers everything but over aligned user types
+	uint8 *Value::AllocateStorage(size_t size, size_t alignment)
+	{
+		if(alignment > 16)
+			return reinterpret_cast<uint8 *>(Memory::AllocateAligned(size, alignment));
+		
+		return reinterpret_cast<uint8 *>(MemoryPool::GetSharedPool()->Allocate(size));
+	}
+	
+	void Value::FreeStorage(uint8 *storage, size_t alignment)
+	{
+		if(alignment > 16)
+			Memory::FreeAligned(storage);
+		else
+			MemoryPool::GetSharedPool()->Free(storage);
 	}
 	
 	
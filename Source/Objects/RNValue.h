@@ -30,7 +30,7 @@ namespace RN
 		{
 			const uint8 *source = reinterpret_cast<const uint8 *>(&value);
 			
-			_storage = reinterpret_cast<uint8 *>(Memory::AllocateAligned(_size, _alignment));
+			_storage = AllocateStorage(_size, _alignment);
 			std::copy(source, source + _size, _storage);
 		}
 		RNAPI Value(const Value *other);
@@ -82,11 +82,15 @@ namespace RN
 		}
 		
 	private:
+		RNAPI static uint8 *AllocateStorage(size_t size, size_t alignment);
+		RNAPI static void FreeStorage(uint8 *storage, size_t alignment);
+
 		char _type;
 		size_t _size;
 		size_t _alignment;
 		uint8 *_storage;
 		
+		RNDeclarePooledAllocation()
 		__RNDeclareMetaInternal(Value)
 	};
 	
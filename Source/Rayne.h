@@ -16,6 +16,7 @@
 #include "Base/RNSettings.h"
 #include "Base/RNUnicode.h"
 #include "Base/RNMemoryPool.h"
+#include "Base/RNFrameAllocator.h"
 #include "Base/RNNotification.h"
 #include "Base/RNNotificationManager.h"
 
@@ -30,10 +31,14 @@
 #include "Data/RNAny.h"
 #include "Data/RNIntrusiveList.h"
 #include "Data/RNAtomicRingBuffer.h"
+#include "Data/RNWorkStealingDeque.h"
+#include "Data/RNSpatialHashGrid.h"
+#include "Data/RNLooseOctree.h"
 
 #include "Debug/RNLogFormatter.h"
 #include "Debug/RNLogger.h"
 #include "Debug/RNLoggingEngine.h"
+#include "Debug/RNProfiler.h"
 
 #include "Input/RNHIDDevice.h"
 #include "Input/RNInputControl.h"
@@ -49,6 +54,7 @@
 #include "Math/RNMatrix.h"
 #include "Math/RNRandom.h"
 #include "Math/RNQuaternion.h"
+#include "Math/RNSIMD.h"
 #include "Math/RNSphere.h"
 #include "Math/RNVector.h"
 #include "Math/RNHalfVector.h"
@@ -68,6 +74,8 @@
 #include "Objects/RNCountedSet.h"
 #include "Objects/RNDictionary.h"
 #include "Objects/RNJSONSerialization.h"
+#include "Objects/RNJSONReader.h"
+#include "Objects/RNJSONWriter.h"
 #include "Objects/RNNull.h"
 #include "Objects/RNNumber.h"
 #include "Objects/RNValue.h"
@@ -101,22 +109,31 @@
 #include "Scene/RNSceneManager.h"
 #include "Scene/RNSceneNode.h"
 #include "Scene/RNSceneNodeAttachment.h"
+#include "Scene/RNOcclusionBuffer.h"
+#include "Scene/RNTransformHierarchy.h"
+#include "Scene/RNBoundingVolumeHierarchy.h"
 #include "Scene/RNLight.h"
 #include "Scene/RNParticle.h"
 #include "Scene/RNParticleEmitter.h"
+#include "Scene/RNParticlePool.h"
+#include "Scene/RNPooledParticleEmitter.h"
+#include "Scene/RNVoxelStorage.h"
 #include "Scene/RNVoxelEntity.h"
 
 #include "System/RNFile.h"
 #include "System/RNFileManager.h"
+#include "System/RNPackFile.h"
 #include "System/RNScreen.h"
 
 #include "Threads/RNCondition.h"
 #include "Threads/RNLockable.h"
 #include "Threads/RNLockTools.h"
 #include "Threads/RNLockWrapper.h"
+#include "Threads/RNParallelFor.h"
 #include "Threads/RNRecursiveLockable.h"
 #include "Threads/RNRunLoop.h"
 #include "Threads/RNSemaphore.h"
+#include "Threads/RNTaskGraph.h"
 #include "Threads/RNThread.h"
 #include "Threads/RNThreadLocalStorage.h"
 #include "Threads/RNWorkGroup.h"
@@ -10,11 +10,17 @@
 #include "RNMesh.h"
 #include "RNRenderer.h"
 #include "../Math/RNHalfVector.h"
+#include "../Base/RNFrameAllocator.h"
 
 namespace RN
 {
 	RNDefineMeta(Mesh, Asset)
 
+	static std::atomic<size_t> __MeshVertexUploads(0);
+	static std::atomic<size_t> __MeshVertexUploadBytes(0);
+	static std::atomic<size_t> __MeshIndexUploads(0);
+	static std::atomic<size_t> __MeshIndexUploadBytes(0);
+
 	struct PrimitiveTypeEntry
 	{
 		size_t size;
@@ -47,7 +53,8 @@ namespace RN
 		{sizeof(Vector3) * 3,     alignof(Vector3)}, //float3x3
 		{sizeof(Matrix),     alignof(Matrix)}, //float4x4
 		{sizeof(Quaternion), alignof(Quaternion)},
-		{sizeof(Color),      alignof(Color)}
+		{sizeof(Color),      alignof(Color)},
+		{sizeof(uint8) * 4,  alignof(uint32)} //Color8
 
 	};
 
@@ -56,6 +63,13 @@ namespace RN
 	{}
 
 	Mesh::Mesh(const std::vector<VertexAttribute> &attributes, size_t verticesCount, size_t indicesCount) :
+		changedVertices(false),
+		changedIndices(false),
+		_buffers(),
+		_bufferCount(1),
+		_activeBuffer(0),
+		_activeBufferFrame(0),
+		_statistics(),
 		_vertexBuffer(nullptr),
 		_indicesBuffer(nullptr),
 		_vertexBufferCPU(nullptr),
@@ -64,6 +78,8 @@ namespace RN
 		_vertexPositionsSeparatedStride(0),
 		_verticesCount(verticesCount),
 		_indicesCount(indicesCount),
+		_verticesSize(0),
+		_indicesSize(0),
 		_drawMode(DrawMode::Triangle),
 		_vertexAttributes(attributes),
 		_descriptor(attributes),
@@ -77,8 +93,11 @@ namespace RN
 
 	Mesh::~Mesh()
 	{
-		SafeRelease(_vertexBuffer);
-		SafeRelease(_indicesBuffer);
+		for(size_t i = 0; i < _bufferCount; i ++)
+		{
+			SafeRelease(_buffers[i].vertices);
+			SafeRelease(_buffers[i].indices);
+		}
 		
 		if(_vertexBufferCPU)
 			free(_vertexBufferCPU);
@@ -193,6 +212,9 @@ namespace RN
 				_indicesBuffer = renderer->CreateBufferWithLength(_indicesSize, GPUResource::UsageOptions::Index, GPUResource::AccessOptions::ReadWrite);
 			}
 		}
+
+		_buffers[0].vertices = _vertexBuffer;
+		_buffers[0].indices = _indicesBuffer;
 	}
 
 	void Mesh::BeginChanges()
@@ -208,11 +230,77 @@ namespace RN
 	{
 		if((-- _changeCounter) == 0)
 		{
-			if(changedIndices)
-				SubmitIndices(Range(0, _indicesSize));
+			if(changedIndices && _indicesSize > 0)
+				_dirtyIndices.Add(0, _indicesSize);
 
 			if(changedVertices)
-				SubmitVertices(Range(0, _verticesSize));
+				_dirtyVertices.Add(0, _verticesSize);
+
+			SubmitChanges();
+		}
+	}
+
+	void Mesh::MarkVerticesChanged(const Range &range)
+	{
+		RN_ASSERT(range.GetEnd() <= _verticesSize, "Range exceeds the vertex buffer");
+		_dirtyVertices.Add(range.origin, range.length);
+
+		if(_changeCounter == 0)
+			SubmitChanges();
+	}
+
+	void Mesh::MarkIndicesChanged(const Range &range)
+	{
+		RN_ASSERT(range.GetEnd() <= _indicesSize, "Range exceeds the index buffer");
+		_dirtyIndices.Add(range.origin, range.length);
+
+		if(_changeCounter == 0)
+			SubmitChanges();
+	}
+
+	void Mesh::SetStreaming(bool streaming)
+	{
+		if(streaming == IsStreaming())
+			return;
+
+		if(streaming)
+		{
+			for(size_t i = 1; i < kRNMeshStreamingBuffers; i ++)
+			{
+				Buffers &buffers = _buffers[i];
+
+				if(_vertexBuffer)
+				{
+					Renderer *renderer = Renderer::GetActiveRenderer();
+					buffers.vertices = renderer->CreateBufferWithLength(_verticesSize, GPUResource::UsageOptions::Vertex, GPUResource::AccessOptions::ReadWrite);
+					if(_indicesBuffer)
+						buffers.indices = renderer->CreateBufferWithLength(_indicesSize, GPUResource::UsageOptions::Index, GPUResource::AccessOptions::ReadWrite);
+				}
+
+				//The new copies are empty, so their first use has to upload everything
+				buffers.dirtyVertices.Clear();
+				buffers.dirtyVertices.Add(0, _verticesSize);
+				buffers.dirtyIndices.Clear();
+				if(_indicesSize > 0)
+					buffers.dirtyIndices.Add(0, _indicesSize);
+			}
+
+			_bufferCount = kRNMeshStreamingBuffers;
+			_activeBufferFrame = FrameAllocator::GetSharedInstance()->GetFrame();
+		}
+		else
+		{
+			//Keep the copy that is up to date
+			std::swap(_buffers[0], _buffers[_activeBuffer]);
+
+			for(size_t i = 1; i < _bufferCount; i ++)
+			{
+				SafeRelease(_buffers[i].vertices);
+				SafeRelease(_buffers[i].indices);
+			}
+
+			_bufferCount = 1;
+			_activeBuffer = 0;
 		}
 	}
 
@@ -229,11 +317,7 @@ namespace RN
 			uint8 *destination = static_cast<uint8 *>(_indicesBufferCPU);
 
 			std::copy(data, data + _indicesSize, destination);
-
-			if(_changeCounter)
-				changedIndices = true;
-			else
-				SubmitIndices(Range(0, _indicesSize));
+			MarkIndicesChanged(Range(0, _indicesSize));
 		}
 		else
 		{
@@ -241,75 +325,63 @@ namespace RN
 			{
 				if(attribute._feature == feature)
 				{
-					uint8 *vertices = static_cast<uint8 *>(_vertexBufferCPU);
-					const uint8 *data = static_cast<const uint8 *>(tdata);
-					
-					uint8 *buffer = vertices + attribute._offset;
-					if(feature != VertexAttribute::Feature::Vertices) buffer += _vertexPositionsSeparatedSize;
-					
-					for(size_t i = 0; i < _verticesCount; i ++)
-					{
-						std::copy(data, data + attribute._typeSize, buffer);
-
-						if(feature == VertexAttribute::Feature::Vertices && _vertexPositionsSeparatedSize > 0)
-						{
-							//Use stride specific to vertex positions, if separated
-							buffer += _vertexPositionsSeparatedStride;
-						}
-						else
-						{
-							buffer += _stride;
-						}
-						data += attribute._typeSize;
-					}
-
-					if(_changeCounter)
-						changedVertices = true;
-					else
-						SubmitVertices(Range(0, _verticesSize));
-
+					CopyElementData(attribute, static_cast<const uint8 *>(tdata), attribute._typeSize);
 					break;
 				}
 			}
 		}
 	}
 
+	void Mesh::SetElementData(VertexAttribute::Feature feature, const void *tdata, size_t stride)
+	{
+		RN_ASSERT(feature != VertexAttribute::Feature::Indices, "Indices can't have a stride");
+
+		for(auto &attribute : _vertexAttributes)
+		{
+			if(attribute._feature == feature)
+			{
+				CopyElementData(attribute, static_cast<const uint8 *>(tdata), stride);
+				break;
+			}
+		}
+	}
+
 	void Mesh::SetElementData(const String *name, const void *tdata)
 	{
 		for(auto &attribute : _vertexAttributes)
 		{
 			if(attribute._name && attribute._name->IsEqual(name))
 			{
-				uint8 *vertices = static_cast<uint8 *>(_vertexBufferCPU);
-				const uint8 *data = static_cast<const uint8 *>(tdata);
+				CopyElementData(attribute, static_cast<const uint8 *>(tdata), attribute._typeSize);
+				break;
+			}
+		}
+	}
 
-				uint8 *buffer = vertices + attribute._offset;
-				if(attribute._feature != VertexAttribute::Feature::Vertices) buffer += _vertexPositionsSeparatedSize;
+	void Mesh::CopyElementData(const VertexAttribute &attribute, const uint8 *data, size_t stride)
+	{
+		uint8 *vertices = static_cast<uint8 *>(_vertexBufferCPU);
 
-				for(size_t i = 0; i < _verticesCount; i ++)
-				{
-					std::copy(data, data + attribute._typeSize, buffer);
+		uint8 *buffer = vertices + attribute._offset;
+		if(attribute._feature != VertexAttribute::Feature::Vertices) buffer += _vertexPositionsSeparatedSize;
 
-					if(attribute._feature == VertexAttribute::Feature::Vertices && _vertexPositionsSeparatedSize > 0)
-					{
-						//Use stride specific to vertex positions, if separated
-						buffer += _vertexPositionsSeparatedStride;
-					}
-					else
-					{
-						buffer += _stride;
-					}
-					data += attribute._typeSize;
-				}
+		//Use stride specific to vertex positions, if separated
+		const bool separated = (attribute._feature == VertexAttribute::Feature::Vertices && _vertexPositionsSeparatedSize > 0);
+		const size_t destinationStride = separated ? _vertexPositionsSeparatedStride : _stride;
 
-				if(_changeCounter)
-					changedVertices = true;
-				else
-					SubmitVertices(Range(0, _verticesSize));
+		for(size_t i = 0; i < _verticesCount; i ++)
+		{
+			std::copy(data, data + attribute._typeSize, buffer);
 
-				break;
-			}
+			buffer += destinationStride;
+			data += stride;
 		}
+
+		//Only the block the attribute lives in changed
+		if(separated)
+			MarkVerticesChanged(Range(0, _vertexPositionsSeparatedSize));
+		else
+			MarkVerticesChanged(Range(_vertexPositionsSeparatedSize, _verticesSize - _vertexPositionsSeparatedSize));
 	}
 
 	const Mesh::VertexAttribute *Mesh::GetAttribute(VertexAttribute::Feature feature) const
@@ -398,7 +470,7 @@ namespace RN
 
 				for(size_t i = 0; i < _verticesCount; i ++)
 				{
-					const Vector3 vertex = (*(iterator++)).GetVector3();
+					const Vector3 vertex = (iterator++)->GetVector3();
 
 					min.x = std::min(vertex.x, min.x);
 					min.y = std::min(vertex.y, min.y);
@@ -423,6 +495,12 @@ namespace RN
 		_boundingSphere = Sphere(_boundingBox);
 	}
 
+	void Mesh::SetBoundingVolumes(const AABB &boundingBox, const Sphere &boundingSphere)
+	{
+		_boundingBox = boundingBox;
+		_boundingSphere = boundingSphere;
+	}
+
 	// ---------------------
 	// MARK: -
 	// MARK: Chunk
@@ -933,27 +1011,151 @@ namespace RN
 		return mesh->Autorelease();
 	}
 
-	void Mesh::SubmitVertices(const Range &range)
+	void Mesh::SubmitChanges()
 	{
-		if(!_vertexBufferCPU || !_vertexBuffer)
+		if(_dirtyVertices.IsEmpty() && _dirtyIndices.IsEmpty())
 			return;
 
-		//TODO: Don't copy full range if not needed.
-		void *target = _vertexBuffer->GetBuffer();
-		memcpy(target, _vertexBufferCPU, _verticesSize);
-		_vertexBuffer->FlushRange(range);
-		_vertexBuffer->UnmapBuffer();
+		if(_bufferCount > 1)
+		{
+			//Move on to the next copy once per frame, the previous ones may still be in use by the GPU
+			const uint64 frame = FrameAllocator::GetSharedInstance()->GetFrame();
+			if(frame != _activeBufferFrame)
+			{
+				_activeBuffer = (_activeBuffer + 1) % _bufferCount;
+				_activeBufferFrame = frame;
+
+				_vertexBuffer = _buffers[_activeBuffer].vertices;
+				_indicesBuffer = _buffers[_activeBuffer].indices;
+			}
+		}
+
+		for(size_t i = 0; i < _bufferCount; i ++)
+		{
+			_buffers[i].dirtyVertices.Add(_dirtyVertices);
+			_buffers[i].dirtyIndices.Add(_dirtyIndices);
+		}
+
+		_dirtyVertices.Clear();
+		_dirtyIndices.Clear();
+
+		Buffers &buffers = _buffers[_activeBuffer];
+
+		const size_t vertexUploads = buffers.dirtyVertices.GetCount();
+		const size_t vertexBytes = SubmitRanges(buffers.vertices, _vertexBufferCPU, buffers.dirtyVertices);
+		const size_t indexUploads = buffers.dirtyIndices.GetCount();
+		const size_t indexBytes = SubmitRanges(buffers.indices, _indicesBufferCPU, buffers.dirtyIndices);
+
+		_statistics.vertexUploads += vertexUploads;
+		_statistics.vertexUploadBytes += vertexBytes;
+		_statistics.indexUploads += indexUploads;
+		_statistics.indexUploadBytes += indexBytes;
+
+		__MeshVertexUploads.fetch_add(vertexUploads, std::memory_order_relaxed);
+		__MeshVertexUploadBytes.fetch_add(vertexBytes, std::memory_order_relaxed);
+		__MeshIndexUploads.fetch_add(indexUploads, std::memory_order_relaxed);
+		__MeshIndexUploadBytes.fetch_add(indexBytes, std::memory_order_relaxed);
 	}
 
-	void Mesh::SubmitIndices(const Range &range)
+	size_t Mesh::SubmitRanges(GPUBuffer *buffer, const void *source, DirtyRanges &ranges)
 	{
-		if(!_indicesBufferCPU || !_indicesBuffer)
-			return;
+		size_t bytes = 0;
+		for(size_t i = 0; i < ranges.GetCount(); i ++)
+			bytes += ranges.GetRange(i).length;
+
+		if(buffer && bytes > 0)
+		{
+			//Copy everything before flushing, some backends finish the upload in the first flush
+			uint8 *target = static_cast<uint8 *>(buffer->GetBuffer());
+
+			for(size_t i = 0; i < ranges.GetCount(); i ++)
+			{
+				const Range &range = ranges.GetRange(i);
+				memcpy(target + range.origin, static_cast<const uint8 *>(source) + range.origin, range.length);
+			}
+
+			for(size_t i = 0; i < ranges.GetCount(); i ++)
+				buffer->FlushRange(ranges.GetRange(i));
+
+			buffer->UnmapBuffer();
+		}
+
+		ranges.Clear();
+		return bytes;
+	}
+
+	Mesh::Statistics Mesh::GetGlobalStatistics()
+	{
+		Statistics statistics;
+		statistics.vertexUploads = __MeshVertexUploads.load(std::memory_order_relaxed);
+		statistics.vertexUploadBytes = __MeshVertexUploadBytes.load(std::memory_order_relaxed);
+		statistics.indexUploads = __MeshIndexUploads.load(std::memory_order_relaxed);
+		statistics.indexUploadBytes = __MeshIndexUploadBytes.load(std::memory_order_relaxed);
+
+		return statistics;
+	}
+
+	// ---------------------
+	// MARK: -
+	// MARK: DirtyRanges
+	// ---------------------
+
+	void Mesh::DirtyRanges::Add(const DirtyRanges &other)
+	{
+		for(size_t i = 0; i < other._count; i ++)
+			Add(other._ranges[i].origin, other._ranges[i].length);
+	}
+
+	void Mesh::DirtyRanges::AddSlow(size_t origin, size_t length)
+	{
+		size_t end = origin + length;
+
+		//Find the first range that isn't entirely in front of the new one
+		size_t index = 0;
+		while(index < _count && _ranges[index].GetEnd() + kRNMeshDirtyRangeGap < origin)
+			index ++;
+
+		if(index < _count && _ranges[index].origin <= end + kRNMeshDirtyRangeGap)
+		{
+			origin = std::min(origin, _ranges[index].origin);
+			end = std::max(end, _ranges[index].GetEnd());
+		}
+		else
+		{
+			std::move_backward(_ranges + index, _ranges + _count, _ranges + _count + 1);
+			_count ++;
+		}
+
+		//Swallow the following ranges that are now close enough
+		size_t swallow = index + 1;
+		while(swallow < _count && end + kRNMeshDirtyRangeGap >= _ranges[swallow].origin)
+		{
+			end = std::max(end, _ranges[swallow].GetEnd());
+			swallow ++;
+		}
+
+		_ranges[index] = Range(origin, end - origin);
+		std::move(_ranges + swallow, _ranges + _count, _ranges + index + 1);
+		_count -= swallow - (index + 1);
+
+		if(_count > kRNMeshDirtyRangeCount)
+		{
+			//Too many ranges, merge the two with the smallest gap between them
+			size_t merge = 0;
+			for(size_t i = 1; i < _count - 1; i ++)
+			{
+				if(_ranges[i + 1].origin - _ranges[i].GetEnd() < _ranges[merge + 1].origin - _ranges[merge].GetEnd())
+					merge = i;
+			}
+
+			_ranges[merge].length = _ranges[merge + 1].GetEnd() - _ranges[merge].origin;
+			std::move(_ranges + merge + 2, _ranges + _count, _ranges + merge + 1);
+			_count --;
+
+			if(index > merge)
+				index --;
+		}
 
-		//TODO: Don't copy full range if not needed.
-		void *target = _indicesBuffer->GetBuffer();
-		memcpy(target, _indicesBufferCPU, _indicesSize);
-		_indicesBuffer->FlushRange(range);
-		_indicesBuffer->UnmapBuffer();
+		_last = index;
 	}
 }
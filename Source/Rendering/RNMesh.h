@@ -20,12 +20,66 @@
 #include "RNRendererTypes.h"
 #include "RNGPUBuffer.h"
 
+#define kRNMeshDirtyRangeCount 8 // Changed ranges uploaded separately per buffer, more get merged into their closest neighbour
+#define kRNMeshDirtyRangeGap 256 // Ranges closer than this many bytes are uploaded as one
+#define kRNMeshStreamingBuffers 3 // GPU buffer copies used by streaming meshes, a copy is written at most once every that many frames
+
 namespace RN
 {
 	class Mesh : public Asset
 	{
 	public:
-		
+		struct Statistics
+		{
+			size_t vertexUploads; // Separate ranges uploaded into vertex buffers
+			size_t vertexUploadBytes;
+			size_t indexUploads;
+			size_t indexUploadBytes;
+		};
+
+		// Sorted set of changed byte ranges of a buffer. Overlapping and close ranges are merged, so the set stays small
+		// and sequential writes only ever grow the range they are in.
+		class DirtyRanges
+		{
+		public:
+			DirtyRanges() :
+				_count(0),
+				_last(0)
+			{}
+
+			void Add(size_t origin, size_t length)
+			{
+				if(_count > 0)
+				{
+					Range &range = _ranges[_last];
+					const size_t end = std::max(range.GetEnd(), origin + length);
+
+					if(origin >= range.origin && origin <= range.GetEnd() + kRNMeshDirtyRangeGap && (_last + 1 == _count || end + kRNMeshDirtyRangeGap < _ranges[_last + 1].origin))
+					{
+						range.length = end - range.origin;
+						return;
+					}
+				}
+
+				AddSlow(origin, length);
+			}
+
+			RNAPI void Add(const DirtyRanges &other);
+			void Clear() { _count = 0; _last = 0; }
+
+			bool IsEmpty() const { return (_count == 0); }
+			size_t GetCount() const { return _count; }
+			const Range &GetRange(size_t index) const { return _ranges[index]; }
+
+		private:
+			RNAPI void AddSlow(size_t origin, size_t length);
+
+			Range _ranges[kRNMeshDirtyRangeCount + 1];
+			size_t _count;
+			size_t _last;
+		};
+
+
 		struct VertexAttribute
 		{
 		public:
@@ -204,10 +258,51 @@ namespace RN
 				return _chunk->TranslateIndex(index);
 			}
 
+			void MarkChanged(const void *ptr, size_t size)
+			{
+				_chunk->MarkChanged(_feature, ptr, size);
+			}
+
 			VertexAttribute::Feature _feature;
 			Chunk *_chunk;
 		};
 
+		template<class T>
+		class ElementIterator;
+
+		//Returned when dereferencing a non const iterator, only assignments mark the element as changed, reads don't
+		template<class T>
+		class ElementReference : public __ChunkFriend
+		{
+		public:
+			template<class U>
+			friend class ElementIterator;
+
+			ElementReference &operator =(const T &value)
+			{
+				*_ptr = value;
+				__ChunkFriend::MarkChanged(_ptr, sizeof(T));
+				return *this;
+			}
+			ElementReference &operator =(const ElementReference &other)
+			{
+				return operator =(*other._ptr);
+			}
+
+			operator const T &() const
+			{
+				return *_ptr;
+			}
+
+		private:
+			ElementReference(const __ChunkFriend &iterator, T *ptr) :
+				__ChunkFriend(iterator),
+				_ptr(ptr)
+			{}
+
+			T *_ptr;
+		};
+
 		template<class T>
 		class ElementIterator : public __ChunkFriend
 		{
@@ -224,19 +319,14 @@ namespace RN
 			}
 
 
-			T *operator ->()
-			{
-				return _ptr;
-			}
-
 			const T *operator ->() const
 			{
 				return _ptr;
 			}
 
-			T &operator *()
+			ElementReference<T> operator *()
 			{
-				return *_ptr;
+				return ElementReference<T>(*this, _ptr);
 			}
 
 			const T &operator *() const
@@ -358,14 +448,11 @@ namespace RN
 				if(feature == VertexAttribute::Feature::Indices) _indicesDescriptor = _mesh->GetAttribute(VertexAttribute::Feature::Indices);
 				else if(feature != VertexAttribute::Feature::Vertices) offset += _mesh->_vertexPositionsSeparatedSize;
 				uint8 *ptr = reinterpret_cast<uint8 *>(feature == VertexAttribute::Feature::Indices ? GetIndexData() : GetVertexData()) + offset;
-				
-				size_t stride = 0;
-				if(feature == VertexAttribute::Feature::Indices) stride = _indicesDescriptor->GetSize();
-				else if(feature == VertexAttribute::Feature::Vertices && _mesh->GetVertexPositionsSeparatedSize() > 0) stride = _mesh->GetVertexPositionsSeparatedStride();
-				else stride = _mesh->GetStride();
-				ptr += stride * index;
 
-				ElementIterator<T> result(feature, this, reinterpret_cast<T *>(ptr), index);
+				//The iterator offsets from its base, so it needs to start at the first element to advance correctly
+				ElementIterator<T> result(feature, this, reinterpret_cast<T *>(ptr), 0);
+				result.Advance(index);
+
 				return result;
 			}
 
@@ -391,6 +478,18 @@ namespace RN
 				}
 			}
 
+			void MarkChanged(VertexAttribute::Feature feature, const void *ptr, size_t size)
+			{
+				//Only writes between BeginChanges() and EndChanges() are tracked, so reading through an iterator doesn't cause uploads
+				if(_mesh->_changeCounter == 0)
+					return;
+
+				if(feature == VertexAttribute::Feature::Indices)
+					_mesh->_dirtyIndices.Add(static_cast<const uint8 *>(ptr) - static_cast<const uint8 *>(_mesh->_indicesBufferCPU), size);
+				else
+					_mesh->_dirtyVertices.Add(static_cast<const uint8 *>(ptr) - static_cast<const uint8 *>(_mesh->_vertexBufferCPU), size);
+			}
+
 			void *GetVertexData()
 			{
 				if(!_vertexData)
@@ -429,17 +528,31 @@ namespace RN
 
 		RNAPI static Mesh *WithSphereMesh(float radius, size_t slices, size_t segments, Color color);
 
+		// Writes through chunk iterators and SetElementData() between these are tracked, and EndChanges() only uploads the changed ranges.
+		// Setting changedVertices or changedIndices uploads the whole buffer instead.
 		RNAPI void BeginChanges();
 		RNAPI void EndChanges();
 
+		// For writes straight into the CPU buffers, ranges are in bytes
+		RNAPI void MarkVerticesChanged(const Range &range);
+		RNAPI void MarkIndicesChanged(const Range &range);
+
+		// Streaming meshes keep kRNMeshStreamingBuffers GPU buffers and write changes into the next one once per frame,
+		// instead of into the buffer the GPU might still be reading from. Meant for meshes that change every frame.
+		RNAPI void SetStreaming(bool streaming);
+		bool IsStreaming() const { return (_bufferCount > 1); }
+
 		RNAPI void SetDrawMode(DrawMode mode);
 		RNAPI void SetElementData(VertexAttribute::Feature feature, const void *data);
 		RNAPI void SetElementData(const String *name, const void *data);
+		// Same as above, but for source data with a stride other than the attributes type size, ie. interleaved data
+		RNAPI void SetElementData(VertexAttribute::Feature feature, const void *data, size_t stride);
 
 		RNAPI const VertexAttribute *GetAttribute(VertexAttribute::Feature feature) const;
 		RNAPI const VertexAttribute *GetAttribute(const String *name) const;
 
 		RNAPI void CalculateBoundingVolumes();
+		RNAPI void SetBoundingVolumes(const AABB &boundingBox, const Sphere &boundingSphere);
 
 		//TODO: Having the two types is a bit confusing since they result in different iterator behaviour
 		Chunk GetChunk() { return Chunk(this, false); }
@@ -465,15 +578,40 @@ namespace RN
 		void *GetCPUVertexBuffer() const { return _vertexBufferCPU; }
 		void *GetCPUIndicesBuffer() const { return _indicesBufferCPU; }
 		
+		// Uploads since the mesh was created. In headless mode nothing is uploaded, but the ranges that would have been still count
+		const Statistics &GetStatistics() const { return _statistics; }
+		// Uploads of all meshes since launch
+		RNAPI static Statistics GetGlobalStatistics();
+
 		bool changedVertices;
 		bool changedIndices;
 
 	private:
+		struct Buffers
+		{
+			GPUBuffer *vertices;
+			GPUBuffer *indices;
+
+			// Changes this copy hasn't received yet
+			DirtyRanges dirtyVertices;
+			DirtyRanges dirtyIndices;
+		};
+
 		void ParseAttributes();
-		void SubmitIndices(const Range &range);
-		void SubmitVertices(const Range &range);
+		void CopyElementData(const VertexAttribute &attribute, const uint8 *data, size_t stride);
+		void SubmitChanges();
+		size_t SubmitRanges(GPUBuffer *buffer, const void *source, DirtyRanges &ranges);
 
 		//TODO: Find a nice way to combine cpu and gpu buffers with consistent interface, optional storage and transfer between them
+		Buffers _buffers[kRNMeshStreamingBuffers];
+		size_t _bufferCount;
+		size_t _activeBuffer;
+		uint64 _activeBufferFrame;
+
+		DirtyRanges _dirtyVertices;
+		DirtyRanges _dirtyIndices;
+		Statistics _statistics;
+
 		GPUBuffer *_vertexBuffer;
 		GPUBuffer *_indicesBuffer;
 		void *_vertexBufferCPU;
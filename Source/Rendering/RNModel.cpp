@@ -285,7 +285,7 @@ namespace RN
 		return _shadowVolume;
 	}
 
-	void Model::CalculateBoundingVolumes()
+	void Model::CalculateBoundingVolumes(bool updateMeshes)
 	{
 		_boundingBox = AABB(Vector3(0.0), Vector3(0.0));
 
@@ -295,7 +295,9 @@ namespace RN
 		{
 			Mesh *mesh = group._mesh;
 
-			mesh->CalculateBoundingVolumes();
+			if(updateMeshes)
+				mesh->CalculateBoundingVolumes();
+
 			_boundingBox += mesh->GetBoundingBox();
 		}
 
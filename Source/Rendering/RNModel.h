@@ -145,7 +145,8 @@ namespace RN
 		RNAPI void SetShadowVolume(ShadowVolume *shadowVolume);
 		RNAPI ShadowVolume *GetShadowVolume() const;
 
-		RNAPI void CalculateBoundingVolumes();
+		// Pass false to combine the bounds the meshes already have, ie. precomputed ones from the asset
+		RNAPI void CalculateBoundingVolumes(bool updateMeshes = true);
 
 		const AABB &GetBoundingBox() const { return _boundingBox; }
 		const Sphere &GetBoundingSphere() const { return _boundingSphere; }
@@ -50,7 +50,8 @@ namespace RN
 		Matrix4x4,
 		
 		Quaternion,
-		Color
+		Color,
+		Color8 // 8 bit per channel, normalized to 0-1 when read as vertex attribute
 	};
 }
 
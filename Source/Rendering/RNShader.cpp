@@ -530,6 +530,8 @@ namespace RN
 			return 16 * _elementCount;
 		case PrimitiveType::Color:
 			return 16 * _elementCount;
+		case PrimitiveType::Color8:
+			return 4 * _elementCount;
 		case PrimitiveType::Invalid:
 			return 0;
 		}
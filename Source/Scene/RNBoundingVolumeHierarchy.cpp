@@ -0,0 +1,590 @@
+//
+//  RNBoundingVolumeHierarchy.cpp
+//  Rayne
+//
+//  Copyright 2019 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "RNBoundingVolumeHierarchy.h"
+#include "RNSceneNode.h"
+
+namespace RN
+{
+	static RN_INLINE Vector3 ComponentMin(const Vector3 &a, const Vector3 &b)
+	{
+		return Vector3(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z));
+	}
+
+	static RN_INLINE Vector3 ComponentMax(const Vector3 &a, const Vector3 &b)
+	{
+		return Vector3(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z));
+	}
+
+	BoundingVolumeHierarchy::BoundingVolumeHierarchy() :
+		_root(kNull),
+		_freeList(kNull),
+		_count(0)
+	{}
+
+	BoundingVolumeHierarchy::~BoundingVolumeHierarchy()
+	{
+		for(TreeNode &treeNode : _nodes)
+		{
+			if(treeNode.height >= 0 && treeNode.node)
+			{
+				treeNode.node->_boundingVolumeHierarchy = nullptr;
+				treeNode.node->_boundingVolumeProxy = kNull;
+				treeNode.node->_boundingVolumeMoved.store(false, std::memory_order_relaxed);
+			}
+		}
+
+		for(SceneNode *node : _pendingNodes)
+		{
+			node->_boundingVolumeHierarchy = nullptr;
+			node->_boundingVolumeMoved.store(false, std::memory_order_relaxed);
+		}
+	}
+
+	// -------------------
+	// MARK: -
+	// MARK: Nodes
+	// -------------------
+
+	void BoundingVolumeHierarchy::AddNode(SceneNode *node)
+	{
+		LockGuard<Lockable> lock(_lock);
+
+		RN_ASSERT(node->_boundingVolumeHierarchy == nullptr, "AddNode() must be called on a node that isn't part of a bounding volume hierarchy");
+
+		node->_boundingVolumeHierarchy = this;
+		node->_boundingVolumeProxy = kNull;
+
+		_pendingNodes.push_back(node);
+	}
+
+	void BoundingVolumeHierarchy::RemoveNode(SceneNode *node)
+	{
+		LockGuard<Lockable> lock(_lock);
+
+		RN_ASSERT(node->_boundingVolumeHierarchy == this, "RemoveNode() must be called on a node that is part of the bounding volume hierarchy");
+
+		if(node->_boundingVolumeMoved.exchange(false, std::memory_order_acq_rel))
+		{
+			auto iterator = std::find(_movedNodes.begin(), _movedNodes.end(), node);
+			if(iterator != _movedNodes.end())
+				_movedNodes.erase(iterator);
+		}
+
+		if(node->_boundingVolumeProxy != kNull)
+		{
+			// Queries skip leaves without node, the leaf itself goes away with the next update
+			_nodes[node->_boundingVolumeProxy].node = nullptr;
+			_removedProxies.push_back(node->_boundingVolumeProxy);
+		}
+		else
+		{
+			_pendingNodes.erase(std::find(_pendingNodes.begin(), _pendingNodes.end(), node));
+		}
+
+		node->_boundingVolumeHierarchy = nullptr;
+		node->_boundingVolumeProxy = kNull;
+	}
+
+	bool BoundingVolumeHierarchy::ContainsNode(const SceneNode *node) const
+	{
+		return (node->_boundingVolumeHierarchy == this);
+	}
+
+	void BoundingVolumeHierarchy::MarkMoved(SceneNode *node)
+	{
+		if(node->_boundingVolumeMoved.exchange(true, std::memory_order_acq_rel))
+			return;
+
+		LockGuard<Lockable> lock(_lock);
+
+		// The node may have been removed in the meantime
+		if(node->_boundingVolumeHierarchy == this && node->_boundingVolumeMoved.load(std::memory_order_acquire))
+			_movedNodes.push_back(node);
+	}
+
+	void BoundingVolumeHierarchy::Update()
+	{
+		LockGuard<Lockable> lock(_lock);
+
+		for(int32 proxy : _removedProxies)
+			DestroyProxy(proxy);
+
+		for(SceneNode *node : _pendingNodes)
+			InsertNode(node);
+
+		for(SceneNode *node : _movedNodes)
+		{
+			node->_boundingVolumeMoved.store(false, std::memory_order_release);
+			RefitNode(node);
+		}
+
+		_removedProxies.clear();
+		_pendingNodes.clear();
+		_movedNodes.clear();
+	}
+
+	void BoundingVolumeHierarchy::ComputeBounds(SceneNode *node, Vector3 &min, Vector3 &max) const
+	{
+		// The rotated box isn't always conservative, the bounding sphere covers the rest
+		const AABB box = node->GetBoundingBox();
+		const Sphere sphere = node->GetBoundingSphere();
+		const Vector3 center = sphere.position + sphere.offset;
+
+		min = ComponentMin(box.position + box.minExtend, center - Vector3(sphere.radius));
+		max = ComponentMax(box.position + box.maxExtend, center + Vector3(sphere.radius));
+
+		// Also brings the cached world transform up to date, so culling and rendering only read it
+		node->GetWorldTransform();
+	}
+
+	void BoundingVolumeHierarchy::InsertNode(SceneNode *node)
+	{
+		const int32 proxy = AllocateNode();
+
+		Vector3 min, max;
+		ComputeBounds(node, min, max);
+
+		TreeNode &leaf = _nodes[proxy];
+		leaf.node = node;
+		leaf.tightMin = min;
+		leaf.tightMax = max;
+		leaf.height = 0;
+		leaf.unbounded = !node->UsesFrustumCulling();
+
+		node->_boundingVolumeProxy = proxy;
+		_count ++;
+
+		if(leaf.unbounded)
+		{
+			leaf.min = min;
+			leaf.max = max;
+
+			_unboundedProxies.push_back(proxy);
+			return;
+		}
+
+		leaf.min = min - Vector3(kRNBoundingVolumeHierarchyMargin);
+		leaf.max = max + Vector3(kRNBoundingVolumeHierarchyMargin);
+
+		InsertLeaf(proxy);
+	}
+
+	void BoundingVolumeHierarchy::RefitNode(SceneNode *node)
+	{
+		const int32 proxy = node->_boundingVolumeProxy;
+		if(proxy == kNull)
+			return;
+
+		Vector3 min, max;
+		ComputeBounds(node, min, max);
+
+		TreeNode &leaf = _nodes[proxy];
+		const Vector3 displacement = (min + max - leaf.tightMin - leaf.tightMax) * 0.5f;
+		const bool unbounded = !node->UsesFrustumCulling();
+
+		leaf.tightMin = min;
+		leaf.tightMax = max;
+
+		if(unbounded != leaf.unbounded)
+		{
+			if(leaf.unbounded)
+				_unboundedProxies.erase(std::find(_unboundedProxies.begin(), _unboundedProxies.end(), proxy));
+			else
+				RemoveLeaf(proxy);
+
+			_nodes[proxy].unbounded = unbounded;
+
+			if(unbounded)
+			{
+				_nodes[proxy].min = min;
+				_nodes[proxy].max = max;
+				_unboundedProxies.push_back(proxy);
+			}
+			else
+			{
+				_nodes[proxy].min = min - Vector3(kRNBoundingVolumeHierarchyMargin);
+				_nodes[proxy].max = max + Vector3(kRNBoundingVolumeHierarchyMargin);
+				InsertLeaf(proxy);
+			}
+
+			return;
+		}
+
+		if(unbounded)
+		{
+			leaf.min = min;
+			leaf.max = max;
+			return;
+		}
+
+		if(Contains(leaf.min, leaf.max, min, max))
+			return;
+
+		RemoveLeaf(proxy);
+
+		// Enlarge the box in the direction of the movement, so steadily moving nodes don't need to be reinserted every frame
+		Vector3 fatMin = min - Vector3(kRNBoundingVolumeHierarchyMargin);
+		Vector3 fatMax = max + Vector3(kRNBoundingVolumeHierarchyMargin);
+		const Vector3 prediction = displacement * kRNBoundingVolumeHierarchyDisplacementFactor;
+
+		fatMin += ComponentMin(prediction, Vector3(0.0f));
+		fatMax += ComponentMax(prediction, Vector3(0.0f));
+
+		_nodes[proxy].min = fatMin;
+		_nodes[proxy].max = fatMax;
+
+		InsertLeaf(proxy);
+	}
+
+	void BoundingVolumeHierarchy::DestroyProxy(int32 proxy)
+	{
+		if(_nodes[proxy].unbounded)
+			_unboundedProxies.erase(std::find(_unboundedProxies.begin(), _unboundedProxies.end(), proxy));
+		else
+			RemoveLeaf(proxy);
+
+		FreeNode(proxy);
+		_count --;
+	}
+
+	// -------------------
+	// MARK: -
+	// MARK: Tree
+	// -------------------
+
+	int32 BoundingVolumeHierarchy::AllocateNode()
+	{
+		int32 index = _freeList;
+
+		if(index == kNull)
+		{
+			index = static_cast<int32>(_nodes.size());
+			_nodes.emplace_back();
+		}
+		else
+		{
+			_freeList = _nodes[index].parent;
+		}
+
+		TreeNode &treeNode = _nodes[index];
+		treeNode.parent = kNull;
+		treeNode.child1 = kNull;
+		treeNode.child2 = kNull;
+		treeNode.height = 0;
+		treeNode.node = nullptr;
+		treeNode.unbounded = false;
+
+		return index;
+	}
+
+	void BoundingVolumeHierarchy::FreeNode(int32 index)
+	{
+		TreeNode &treeNode = _nodes[index];
+		treeNode.parent = _freeList;
+		treeNode.height = -1;
+		treeNode.node = nullptr;
+
+		_freeList = index;
+	}
+
+	void BoundingVolumeHierarchy::InsertLeaf(int32 leaf)
+	{
+		if(_root == kNull)
+		{
+			_root = leaf;
+			_nodes[leaf].parent = kNull;
+			return;
+		}
+
+		const Vector3 leafMin = _nodes[leaf].min;
+		const Vector3 leafMax = _nodes[leaf].max;
+
+		// Walk down to the sibling with the lowest surface area cost
+		int32 index = _root;
+		while(!_nodes[index].IsLeaf())
+		{
+			const TreeNode &treeNode = _nodes[index];
+
+			const float area = GetSurfaceArea(treeNode.min, treeNode.max);
+			const float combinedArea = GetSurfaceArea(ComponentMin(treeNode.min, leafMin), ComponentMax(treeNode.max, leafMax));
+
+			// Cost of creating a new parent for this node and the leaf, and the minimum cost of pushing the leaf further down
+			const float cost = 2.0f * combinedArea;
+			const float inheritanceCost = 2.0f * (combinedArea - area);
+
+			float childCosts[2];
+			const int32 children[2] = { treeNode.child1, treeNode.child2 };
+
+			for(size_t i = 0; i < 2; i ++)
+			{
+				const TreeNode &child = _nodes[children[i]];
+				const float childArea = GetSurfaceArea(ComponentMin(child.min, leafMin), ComponentMax(child.max, leafMax));
+
+				childCosts[i] = child.IsLeaf() ? (childArea + inheritanceCost) : (childArea - GetSurfaceArea(child.min, child.max) + inheritanceCost);
+			}
+
+			if(cost < childCosts[0] && cost < childCosts[1])
+				break;
+
+			index = (childCosts[0] < childCosts[1]) ? children[0] : children[1];
+		}
+
+		const int32 sibling = index;
+		const int32 oldParent = _nodes[sibling].parent;
+		const int32 newParent = AllocateNode();
+
+		TreeNode &parent = _nodes[newParent];
+		parent.parent = oldParent;
+		parent.min = ComponentMin(leafMin, _nodes[sibling].min);
+		parent.max = ComponentMax(leafMax, _nodes[sibling].max);
+		parent.height = _nodes[sibling].height + 1;
+		parent.child1 = sibling;
+		parent.child2 = leaf;
+
+		if(oldParent != kNull)
+		{
+			if(_nodes[oldParent].child1 == sibling)
+				_nodes[oldParent].child1 = newParent;
+			else
+				_nodes[oldParent].child2 = newParent;
+		}
+		else
+		{
+			_root = newParent;
+		}
+
+		_nodes[sibling].parent = newParent;
+		_nodes[leaf].parent = newParent;
+
+		// Refit and balance the ancestors
+		index = _nodes[leaf].parent;
+		while(index != kNull)
+		{
+			index = Balance(index);
+
+			TreeNode &treeNode = _nodes[index];
+			const TreeNode &child1 = _nodes[treeNode.child1];
+			const TreeNode &child2 = _nodes[treeNode.child2];
+
+			treeNode.height = 1 + std::max(child1.height, child2.height);
+			treeNode.min = ComponentMin(child1.min, child2.min);
+			treeNode.max = ComponentMax(child1.max, child2.max);
+
+			index = treeNode.parent;
+		}
+	}
+
+	void BoundingVolumeHierarchy::RemoveLeaf(int32 leaf)
+	{
+		if(leaf == _root)
+		{
+			_root = kNull;
+			return;
+		}
+
+		const int32 parent = _nodes[leaf].parent;
+		const int32 grandParent = _nodes[parent].parent;
+		const int32 sibling = (_nodes[parent].child1 == leaf) ? _nodes[parent].child2 : _nodes[parent].child1;
+
+		_nodes[leaf].parent = kNull;
+
+		if(grandParent == kNull)
+		{
+			_root = sibling;
+			_nodes[sibling].parent = kNull;
+
+			FreeNode(parent);
+			return;
+		}
+
+		if(_nodes[grandParent].child1 == parent)
+			_nodes[grandParent].child1 = sibling;
+		else
+			_nodes[grandParent].child2 = sibling;
+
+		_nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		int32 index = grandParent;
+		while(index != kNull)
+		{
+			index = Balance(index);
+
+			TreeNode &treeNode = _nodes[index];
+			const TreeNode &child1 = _nodes[treeNode.child1];
+			const TreeNode &child2 = _nodes[treeNode.child2];
+
+			treeNode.height = 1 + std::max(child1.height, child2.height);
+			treeNode.min = ComponentMin(child1.min, child2.min);
+			treeNode.max = ComponentMax(child1.max, child2.max);
+
+			index = treeNode.parent;
+		}
+	}
+
+	// Rotates the higher grand child of A up if the subtrees of A are imbalanced and returns the new root of the subtree
+	int32 BoundingVolumeHierarchy::Balance(int32 iA)
+	{
+		TreeNode &A = _nodes[iA];
+		if(A.IsLeaf() || A.height < 2)
+			return iA;
+
+		const int32 iB = A.child1;
+		const int32 iC = A.child2;
+		TreeNode &B = _nodes[iB];
+		TreeNode &C = _nodes[iC];
+
+		const int32 balance = C.height - B.height;
+
+		// Rotate C up
+		if(balance > 1)
+		{
+			const int32 iF = C.child1;
+			const int32 iG = C.child2;
+			TreeNode &F = _nodes[iF];
+			TreeNode &G = _nodes[iG];
+
+			C.child1 = iA;
+			C.parent = A.parent;
+			A.parent = iC;
+
+			if(C.parent != kNull)
+			{
+				if(_nodes[C.parent].child1 == iA)
+					_nodes[C.parent].child1 = iC;
+				else
+					_nodes[C.parent].child2 = iC;
+			}
+			else
+			{
+				_root = iC;
+			}
+
+			if(F.height > G.height)
+			{
+				C.child2 = iF;
+				A.child2 = iG;
+				G.parent = iA;
+
+				A.min = ComponentMin(B.min, G.min);
+				A.max = ComponentMax(B.max, G.max);
+				C.min = ComponentMin(A.min, F.min);
+				C.max = ComponentMax(A.max, F.max);
+
+				A.height = 1 + std::max(B.height, G.height);
+				C.height = 1 + std::max(A.height, F.height);
+			}
+			else
+			{
+				C.child2 = iG;
+				A.child2 = iF;
+				F.parent = iA;
+
+				A.min = ComponentMin(B.min, F.min);
+				A.max = ComponentMax(B.max, F.max);
+				C.min = ComponentMin(A.min, G.min);
+				C.max = ComponentMax(A.max, G.max);
+
+				A.height = 1 + std::max(B.height, F.height);
+				C.height = 1 + std::max(A.height, G.height);
+			}
+
+			return iC;
+		}
+
+		// Rotate B up
+		if(balance < -1)
+		{
+			const int32 iD = B.child1;
+			const int32 iE = B.child2;
+			TreeNode &D = _nodes[iD];
+			TreeNode &E = _nodes[iE];
+
+			B.child1 = iA;
+			B.parent = A.parent;
+			A.parent = iB;
+
+			if(B.parent != kNull)
+			{
+				if(_nodes[B.parent].child1 == iA)
+					_nodes[B.parent].child1 = iB;
+				else
+					_nodes[B.parent].child2 = iB;
+			}
+			else
+			{
+				_root = iB;
+			}
+
+			if(D.height > E.height)
+			{
+				B.child2 = iD;
+				A.child1 = iE;
+				E.parent = iA;
+
+				A.min = ComponentMin(C.min, E.min);
+				A.max = ComponentMax(C.max, E.max);
+				B.min = ComponentMin(A.min, D.min);
+				B.max = ComponentMax(A.max, D.max);
+
+				A.height = 1 + std::max(C.height, E.height);
+				B.height = 1 + std::max(A.height, D.height);
+			}
+			else
+			{
+				B.child2 = iE;
+				A.child1 = iD;
+				D.parent = iA;
+
+				A.min = ComponentMin(C.min, D.min);
+				A.max = ComponentMax(C.max, D.max);
+				B.min = ComponentMin(A.min, E.min);
+				B.max = ComponentMax(A.max, E.max);
+
+				A.height = 1 + std::max(C.height, D.height);
+				B.height = 1 + std::max(A.height, E.height);
+			}
+
+			return iB;
+		}
+
+		return iA;
+	}
+
+	// -------------------
+	// MARK: -
+	// MARK: Queries
+	// -------------------
+
+	SceneNode *BoundingVolumeHierarchy::RaycastClosest(const Vector3 &origin, const Vector3 &direction, float maxDistance, float *distance) const
+	{
+		SceneNode *result = nullptr;
+		float closest = maxDistance;
+
+		Raycast(origin, direction, maxDistance, [&](SceneNode *node, float hitDistance) -> float {
+			if(hitDistance <= closest)
+			{
+				result = node;
+				closest = hitDistance;
+			}
+
+			return closest;
+		});
+
+		if(distance)
+			*distance = closest;
+
+		return result;
+	}
+
+	size_t BoundingVolumeHierarchy::GetHeight() const
+	{
+		return (_root == kNull) ? 0 : static_cast<size_t>(_nodes[_root].height);
+	}
+}
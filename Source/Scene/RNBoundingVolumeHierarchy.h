@@ -0,0 +1,383 @@
+//
+//  RNBoundingVolumeHierarchy.h
+//  Rayne
+//
+//  Copyright 2019 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_BOUNDINGVOLUMEHIERARCHY_H__
+#define __RAYNE_BOUNDINGVOLUMEHIERARCHY_H__
+
+#include "../Base/RNBase.h"
+#include "../Math/RNVector.h"
+#include "../Math/RNAABB.h"
+#include "../Math/RNSphere.h"
+#include "../Math/RNPlane.h"
+
+#define kRNBoundingVolumeHierarchyMargin 0.1f
+#define kRNBoundingVolumeHierarchyDisplacementFactor 2.0f
+#define kRNBoundingVolumeHierarchyStackSize 64
+
+namespace RN
+{
+	class SceneNode;
+
+	// Dynamic AABB tree over the world bounds of scene nodes. Leaves store slightly enlarged boxes, so nodes that move
+	// a little only need their leaf updated, while nodes that leave their box are reinserted. Rotations keep the tree balanced.
+	// Nodes that opt out of frustum culling are kept outside of the tree and reported by every frustum query.
+	class BoundingVolumeHierarchy
+	{
+	public:
+		RNAPI BoundingVolumeHierarchy();
+		RNAPI ~BoundingVolumeHierarchy();
+
+		// Thread safe, the tree is changed with the next Update()
+		RNAPI void AddNode(SceneNode *node);
+		RNAPI void RemoveNode(SceneNode *node);
+		RNAPI bool ContainsNode(const SceneNode *node) const;
+
+		// Inserts new nodes and refits the moved ones. Must not run concurrently with queries.
+		RNAPI void Update();
+
+		// Queries are thread safe as long as Update() doesn't run at the same time. Callbacks take a SceneNode *
+		template<class F>
+		void QueryAABB(const AABB &aabb, F &&callback) const;
+		template<class F>
+		void QuerySphere(const Sphere &sphere, F &&callback) const;
+		// Planes point out of the volume, a box is rejected when it is fully in front of one of them
+		template<class F>
+		void QueryFrustum(const Plane *planes, size_t planeCount, F &&callback) const;
+		// The callback gets the node and the distance at which the ray enters its box and returns the new maximum distance
+		template<class F>
+		void Raycast(const Vector3 &origin, const Vector3 &direction, float maxDistance, F &&callback) const;
+
+		// Closest node whose box is hit by the ray, nullptr if there is none
+		RNAPI SceneNode *RaycastClosest(const Vector3 &origin, const Vector3 &direction, float maxDistance, float *distance = nullptr) const;
+
+		size_t GetCount() const { return _count; }
+		RNAPI size_t GetHeight() const;
+
+	private:
+		friend class SceneNode;
+
+		static constexpr int32 kNull = -1;
+
+		struct TreeNode
+		{
+			bool IsLeaf() const { return child1 == kNull; }
+
+			// Enlarged bounds for leaves, union of the children otherwise
+			Vector3 min;
+			Vector3 max;
+
+			// Exact world bounds of the scene node, leaves only
+			Vector3 tightMin;
+			Vector3 tightMax;
+
+			int32 parent; // Next free node while on the free list
+			int32 child1;
+			int32 child2;
+			int32 height; // -1 while on the free list
+
+			SceneNode *node;
+			bool unbounded;
+		};
+
+		// Depth first traversal with the first entries on the stack, deeper trees spill into the heap
+		template<class T>
+		class TraversalStack
+		{
+		public:
+			TraversalStack() : _count(0) {}
+
+			void Push(const T &value)
+			{
+				if(RN_EXPECT_TRUE(_count < kRNBoundingVolumeHierarchyStackSize))
+					_stack[_count] = value;
+				else
+					_overflow.push_back(value);
+
+				_count ++;
+			}
+			T Pop()
+			{
+				_count --;
+
+				if(RN_EXPECT_FALSE(_count >= kRNBoundingVolumeHierarchyStackSize))
+				{
+					T value = _overflow.back();
+					_overflow.pop_back();
+					return value;
+				}
+
+				return _stack[_count];
+			}
+			bool IsEmpty() const { return _count == 0; }
+
+		private:
+			T _stack[kRNBoundingVolumeHierarchyStackSize];
+			std::vector<T> _overflow;
+			size_t _count;
+		};
+
+		void MarkMoved(SceneNode *node);
+
+		int32 AllocateNode();
+		void FreeNode(int32 index);
+
+		void InsertLeaf(int32 leaf);
+		void RemoveLeaf(int32 leaf);
+		int32 Balance(int32 index);
+
+		void InsertNode(SceneNode *node);
+		void RefitNode(SceneNode *node);
+		void DestroyProxy(int32 proxy);
+		void ComputeBounds(SceneNode *node, Vector3 &min, Vector3 &max) const;
+
+		static bool Overlaps(const Vector3 &min0, const Vector3 &max0, const Vector3 &min1, const Vector3 &max1)
+		{
+			return (min0.x <= max1.x && max0.x >= min1.x && min0.y <= max1.y && max0.y >= min1.y && min0.z <= max1.z && max0.z >= min1.z);
+		}
+		static bool Contains(const Vector3 &outerMin, const Vector3 &outerMax, const Vector3 &min, const Vector3 &max)
+		{
+			return (outerMin.x <= min.x && outerMin.y <= min.y && outerMin.z <= min.z && outerMax.x >= max.x && outerMax.y >= max.y && outerMax.z >= max.z);
+		}
+		static float GetSurfaceArea(const Vector3 &min, const Vector3 &max)
+		{
+			const Vector3 size = max - min;
+			return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+		static float GetSquaredDistance(const Vector3 &min, const Vector3 &max, const Vector3 &point)
+		{
+			const float x = std::max(std::max(min.x - point.x, point.x - max.x), 0.0f);
+			const float y = std::max(std::max(min.y - point.y, point.y - max.y), 0.0f);
+			const float z = std::max(std::max(min.z - point.z, point.z - max.z), 0.0f);
+			return x * x + y * y + z * z;
+		}
+		// Returns the distance at which the ray enters the box, or a negative value if it misses it
+		static float IntersectRay(const Vector3 &min, const Vector3 &max, const Vector3 &origin, const Vector3 &inverseDirection, float maxDistance)
+		{
+			const float x0 = (min.x - origin.x) * inverseDirection.x;
+			const float x1 = (max.x - origin.x) * inverseDirection.x;
+			const float y0 = (min.y - origin.y) * inverseDirection.y;
+			const float y1 = (max.y - origin.y) * inverseDirection.y;
+			const float z0 = (min.z - origin.z) * inverseDirection.z;
+			const float z1 = (max.z - origin.z) * inverseDirection.z;
+
+			const float entry = std::max(std::max(std::min(x0, x1), std::min(y0, y1)), std::max(std::min(z0, z1), 0.0f));
+			const float exit = std::min(std::min(std::max(x0, x1), std::max(y0, y1)), std::min(std::max(z0, z1), maxDistance));
+
+			return (entry <= exit) ? entry : -1.0f;
+		}
+
+		std::vector<TreeNode> _nodes;
+		int32 _root;
+		int32 _freeList;
+		size_t _count;
+
+		std::vector<int32> _unboundedProxies;
+
+		Lockable _lock;
+		std::vector<SceneNode *> _pendingNodes;
+		std::vector<SceneNode *> _movedNodes;
+		std::vector<int32> _removedProxies;
+	};
+
+	template<class F>
+	void BoundingVolumeHierarchy::QueryAABB(const AABB &aabb, F &&callback) const
+	{
+		const Vector3 min = aabb.position + aabb.minExtend;
+		const Vector3 max = aabb.position + aabb.maxExtend;
+
+		for(int32 proxy : _unboundedProxies)
+		{
+			const TreeNode &leaf = _nodes[proxy];
+			if(leaf.node && Overlaps(leaf.tightMin, leaf.tightMax, min, max))
+				callback(leaf.node);
+		}
+
+		if(_root == kNull)
+			return;
+
+		TraversalStack<int32> stack;
+		stack.Push(_root);
+
+		while(!stack.IsEmpty())
+		{
+			const TreeNode &treeNode = _nodes[stack.Pop()];
+
+			if(!Overlaps(treeNode.min, treeNode.max, min, max))
+				continue;
+
+			if(treeNode.IsLeaf())
+			{
+				if(treeNode.node && Overlaps(treeNode.tightMin, treeNode.tightMax, min, max))
+					callback(treeNode.node);
+
+				continue;
+			}
+
+			stack.Push(treeNode.child1);
+			stack.Push(treeNode.child2);
+		}
+	}
+
+	template<class F>
+	void BoundingVolumeHierarchy::QuerySphere(const Sphere &sphere, F &&callback) const
+	{
+		const Vector3 center = sphere.position + sphere.offset;
+		const float radius = sphere.radius * sphere.radius;
+
+		for(int32 proxy : _unboundedProxies)
+		{
+			const TreeNode &leaf = _nodes[proxy];
+			if(leaf.node && GetSquaredDistance(leaf.tightMin, leaf.tightMax, center) <= radius)
+				callback(leaf.node);
+		}
+
+		if(_root == kNull)
+			return;
+
+		TraversalStack<int32> stack;
+		stack.Push(_root);
+
+		while(!stack.IsEmpty())
+		{
+			const TreeNode &treeNode = _nodes[stack.Pop()];
+
+			if(GetSquaredDistance(treeNode.min, treeNode.max, center) > radius)
+				continue;
+
+			if(treeNode.IsLeaf())
+			{
+				if(treeNode.node && GetSquaredDistance(treeNode.tightMin, treeNode.tightMax, center) <= radius)
+					callback(treeNode.node);
+
+				continue;
+			}
+
+			stack.Push(treeNode.child1);
+			stack.Push(treeNode.child2);
+		}
+	}
+
+	template<class F>
+	void BoundingVolumeHierarchy::QueryFrustum(const Plane *planes, size_t planeCount, F &&callback) const
+	{
+		RN_ASSERT(planeCount <= 32, "QueryFrustum() supports up to 32 planes");
+
+		for(int32 proxy : _unboundedProxies)
+		{
+			if(_nodes[proxy].node)
+				callback(_nodes[proxy].node);
+		}
+
+		if(_root == kNull)
+			return;
+
+		// Every entry carries the planes its box still has to be tested against, children of a box that is
+		// fully inside of a plane skip it. Once no plane is left the whole subtree is visible.
+		const uint32 allPlanes = (planeCount == 32) ? 0xffffffff : ((1u << planeCount) - 1);
+
+		TraversalStack<std::pair<int32, uint32>> stack;
+		stack.Push(std::make_pair(_root, allPlanes));
+
+		while(!stack.IsEmpty())
+		{
+			const std::pair<int32, uint32> entry = stack.Pop();
+			const TreeNode &treeNode = _nodes[entry.first];
+
+			const bool isLeaf = treeNode.IsLeaf();
+			const Vector3 &min = isLeaf ? treeNode.tightMin : treeNode.min;
+			const Vector3 &max = isLeaf ? treeNode.tightMax : treeNode.max;
+
+			const Vector3 center = (min + max) * 0.5f;
+			const Vector3 extents = (max - min) * 0.5f;
+
+			uint32 mask = entry.second;
+			bool outside = false;
+
+			for(size_t i = 0; i < planeCount; i ++)
+			{
+				if(!(mask & (1u << i)))
+					continue;
+
+				const Vector3 normal = planes[i].GetNormal();
+				const float distance = planes[i].GetDistance(center);
+				const float radius = extents.x * std::abs(normal.x) + extents.y * std::abs(normal.y) + extents.z * std::abs(normal.z);
+
+				if(distance > radius)
+				{
+					outside = true;
+					break;
+				}
+
+				if(distance < -radius)
+					mask &= ~(1u << i);
+			}
+
+			if(outside)
+				continue;
+
+			if(isLeaf)
+			{
+				if(treeNode.node)
+					callback(treeNode.node);
+
+				continue;
+			}
+
+			stack.Push(std::make_pair(treeNode.child1, mask));
+			stack.Push(std::make_pair(treeNode.child2, mask));
+		}
+	}
+
+	template<class F>
+	void BoundingVolumeHierarchy::Raycast(const Vector3 &origin, const Vector3 &direction, float maxDistance, F &&callback) const
+	{
+		const Vector3 inverseDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+		for(int32 proxy : _unboundedProxies)
+		{
+			const TreeNode &leaf = _nodes[proxy];
+			if(!leaf.node)
+				continue;
+
+			const float distance = IntersectRay(leaf.tightMin, leaf.tightMax, origin, inverseDirection, maxDistance);
+			if(distance >= 0.0f)
+				maxDistance = callback(leaf.node, distance);
+		}
+
+		if(_root == kNull)
+			return;
+
+		TraversalStack<int32> stack;
+		stack.Push(_root);
+
+		while(!stack.IsEmpty())
+		{
+			const TreeNode &treeNode = _nodes[stack.Pop()];
+
+			if(IntersectRay(treeNode.min, treeNode.max, origin, inverseDirection, maxDistance) < 0.0f)
+				continue;
+
+			if(treeNode.IsLeaf())
+			{
+				if(!treeNode.node)
+					continue;
+
+				const float distance = IntersectRay(treeNode.tightMin, treeNode.tightMax, origin, inverseDirection, maxDistance);
+				if(distance >= 0.0f)
+					maxDistance = callback(treeNode.node, distance);
+
+				continue;
+			}
+
+			stack.Push(treeNode.child1);
+			stack.Push(treeNode.child2);
+		}
+	}
+}
+
+#endif /* __RAYNE_BOUNDINGVOLUMEHIERARCHY_H__ */
@@ -10,6 +10,7 @@
 #include "RNLight.h"
 #include "../Rendering/RNRenderer.h"
 #include "../Rendering/RNWindow.h"
+#include "../Math/RNSIMD.h"
 
 namespace RN
 {
@@ -437,6 +438,23 @@ namespace RN
 		return _frustumRadius;
 	}
 
+	size_t Camera::GetFrustumPlanes(Plane *planes)
+	{
+		UpdateFrustum();
+
+		if(_flags & Flags::UseSimpleCulling)
+			return 0;
+
+		planes[0] = frustums._frustumLeft;
+		planes[1] = frustums._frustumRight;
+		planes[2] = frustums._frustumTop;
+		planes[3] = frustums._frustumBottom;
+		planes[4] = frustums._frustumNear;
+		planes[5] = frustums._frustumFar;
+
+		return 6;
+	}
+
 	bool Camera::InFrustum(const Vector3 &position, float radius)
 	{
 		if(_frustumCenter.GetDistance(position) > _frustumRadius + radius)
@@ -472,6 +490,80 @@ namespace RN
 		return InFrustum(sphere.position+sphere.offset, sphere.radius);
 	}
 
+	void Camera::InFrustum(const float *positionX, const float *positionY, const float *positionZ, const float *radius, size_t count, uint8 *result) const
+	{
+		const Plane *planes[6] = { &frustums._frustumLeft, &frustums._frustumRight, &frustums._frustumTop, &frustums._frustumBottom, &frustums._frustumNear, &frustums._frustumFar };
+		const size_t planeCount = (_flags & Flags::UseSimpleCulling) ? 0 : 6;
+
+		SIMD::VecFloat normalX[6], normalY[6], normalZ[6], planeD[6];
+
+		for(size_t i = 0; i < planeCount; i ++)
+		{
+			const Vector3 normal = planes[i]->GetNormal();
+
+			normalX[i] = SIMD::Splat(normal.x);
+			normalY[i] = SIMD::Splat(normal.y);
+			normalZ[i] = SIMD::Splat(normal.z);
+			planeD[i] = SIMD::Splat(planes[i]->GetD());
+		}
+
+		const SIMD::VecFloat centerX = SIMD::Splat(_frustumCenter.x);
+		const SIMD::VecFloat centerY = SIMD::Splat(_frustumCenter.y);
+		const SIMD::VecFloat centerZ = SIMD::Splat(_frustumCenter.z);
+		const SIMD::VecFloat frustumRadius = SIMD::Splat(_frustumRadius);
+
+		for(size_t offset = 0; offset < count; offset += 4)
+		{
+			SIMD::VecFloat x, y, z, r;
+
+			if(RN_EXPECT_TRUE(offset + 4 <= count))
+			{
+				x = SIMD::Load(positionX + offset);
+				y = SIMD::Load(positionY + offset);
+				z = SIMD::Load(positionZ + offset);
+				r = SIMD::Load(radius + offset);
+			}
+			else
+			{
+				float temp[4][4] = {};
+
+				for(size_t i = 0; offset + i < count; i ++)
+				{
+					temp[0][i] = positionX[offset + i];
+					temp[1][i] = positionY[offset + i];
+					temp[2][i] = positionZ[offset + i];
+					temp[3][i] = radius[offset + i];
+				}
+
+				x = SIMD::Load(temp[0]);
+				y = SIMD::Load(temp[1]);
+				z = SIMD::Load(temp[2]);
+				r = SIMD::Load(temp[3]);
+			}
+
+			// Same tests as InFrustum(position, radius), the bounding sphere of the frustum compares squared distances
+			const SIMD::VecFloat deltaX = SIMD::Sub(x, centerX);
+			const SIMD::VecFloat deltaY = SIMD::Sub(y, centerY);
+			const SIMD::VecFloat deltaZ = SIMD::Sub(z, centerZ);
+			const SIMD::VecFloat distance = SIMD::Add(SIMD::Add(SIMD::Mul(deltaX, deltaX), SIMD::Mul(deltaY, deltaY)), SIMD::Mul(deltaZ, deltaZ));
+			const SIMD::VecFloat limit = SIMD::Add(frustumRadius, r);
+
+			SIMD::VecFloat outside = SIMD::CompareGreater(distance, SIMD::Mul(limit, limit));
+
+			for(size_t i = 0; i < planeCount; i ++)
+			{
+				const SIMD::VecFloat planeDistance = SIMD::Sub(SIMD::Add(SIMD::Add(SIMD::Mul(x, normalX[i]), SIMD::Mul(y, normalY[i])), SIMD::Mul(z, normalZ[i])), planeD[i]);
+				outside = SIMD::Or(outside, SIMD::CompareGreater(planeDistance, r));
+			}
+
+			const int mask = SIMD::MoveMask(outside);
+			const size_t end = std::min(count - offset, static_cast<size_t>(4));
+
+			for(size_t i = 0; i < end; i ++)
+				result[offset + i] = ((mask >> i) & 1) ? 0 : 1;
+		}
+	}
+
 	bool Camera::InFrustum(const AABB &aabb)
 	{
 		UpdateFrustum();
@@ -90,8 +90,14 @@ namespace RN
 		RNAPI virtual bool InFrustum(const Sphere &sphere);
 		RNAPI virtual bool InFrustum(const AABB &aabb);
 
+		// Tests count spheres given as separate position and radius arrays, result[i] is 0 for spheres outside of the frustum.
+		// Thread safe as long as the frustum is up to date, which GetFrustumCenter() ensures.
+		RNAPI void InFrustum(const float *positionX, const float *positionY, const float *positionZ, const float *radius, size_t count, uint8 *result) const;
+
 		RNAPI const Vector3 &GetFrustumCenter();
 		RNAPI float GetFrustumRadius();
+		// Copies the left, right, top, bottom, near and far planes and returns their count, which is 0 with simple culling
+		RNAPI size_t GetFrustumPlanes(Plane *planes);
 
 		RenderPass *GetRenderPass() const { return _renderPass; }
 		Material *GetMaterial() const { return _material; }
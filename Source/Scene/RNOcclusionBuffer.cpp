@@ -0,0 +1,531 @@
+//
+//  RNOcclusionBuffer.cpp
+//  Rayne
+//
+//  Copyright 2019 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "RNOcclusionBuffer.h"
+#include "../Math/RNSIMD.h"
+#include "../Rendering/RNMesh.h"
+#include "../Threads/RNParallelFor.h"
+
+#define kRNOcclusionBufferTilePixels (kRNOcclusionBufferTileWidth * kRNOcclusionBufferTileHeight)
+#define kRNOcclusionBufferDepthBias 0.000001f //Add a bit of an offset to prevent precision issues
+
+namespace RN
+{
+	static_assert(kRNOcclusionBufferTileWidth == 8, "The rasterizer processes a tile row as two 4 wide vectors");
+
+	RN_INLINE float EdgeFunction(const Vector2 &a, const Vector2 &b, const Vector2 &c)
+	{
+		return (c.x - a.x) * (b.y - a.y) - (c.y - a.y) * (b.x - a.x);
+	}
+
+	OcclusionBuffer::OcclusionBuffer(uint32 width, uint32 height) :
+		_depth(nullptr)
+	{
+		Resize(width, height);
+	}
+
+	OcclusionBuffer::~OcclusionBuffer()
+	{
+		delete[] _depth;
+	}
+
+	void OcclusionBuffer::Resize(uint32 width, uint32 height)
+	{
+		RN_ASSERT(width > 0 && height > 0, "Occlusion buffer size must not be 0");
+
+		_tilesX = (width + kRNOcclusionBufferTileWidth - 1) / kRNOcclusionBufferTileWidth;
+		_tilesY = (height + kRNOcclusionBufferTileHeight - 1) / kRNOcclusionBufferTileHeight;
+
+		_width = _tilesX * kRNOcclusionBufferTileWidth;
+		_height = _tilesY * kRNOcclusionBufferTileHeight;
+
+		delete[] _depth;
+		_depth = new float[_width * _height];
+
+		_tiles.clear();
+		_tiles.resize(_tilesX * _tilesY);
+
+		Clear();
+	}
+
+	void OcclusionBuffer::Clear()
+	{
+		std::fill(_depth, _depth + _width * _height, 0.0f);
+
+		for(Tile &tile : _tiles)
+		{
+			tile.triangles.clear();
+			tile.minDepth = 0.0f;
+			tile.maxDepth = 0.0f;
+		}
+	}
+
+	float OcclusionBuffer::GetDepth(uint32 x, uint32 y) const
+	{
+		const float *depth = GetTileDepth(x / kRNOcclusionBufferTileWidth, y / kRNOcclusionBufferTileHeight);
+		return depth[(y % kRNOcclusionBufferTileHeight) * kRNOcclusionBufferTileWidth + (x % kRNOcclusionBufferTileWidth)];
+	}
+
+	void OcclusionBuffer::AddOccluder(const Matrix &modelViewProjection, Mesh *mesh)
+	{
+		_occluders.push_back({ modelViewProjection, mesh });
+	}
+
+	void OcclusionBuffer::Rasterize(WorkQueue *queue)
+	{
+		const size_t occluderCount = _occluders.size();
+
+		if(_occluderTriangles.size() < occluderCount)
+			_occluderTriangles.resize(occluderCount);
+
+		// Transform, clip and set up the triangles of every occluder
+		ParallelFor(Range(0, occluderCount), 1, [&](size_t index) {
+
+			_occluderTriangles[index].clear();
+			SetupOccluder(_occluders[index], _occluderTriangles[index]);
+
+		}, queue);
+
+		// Bin the triangles into the tiles they touch, keeping the occluder order intact
+		_triangles.clear();
+
+		for(size_t i = 0; i < occluderCount; i ++)
+		{
+			for(const Triangle &triangle : _occluderTriangles[i])
+			{
+				const uint32 index = static_cast<uint32>(_triangles.size());
+				_triangles.push_back(triangle);
+
+				const uint32 minTileX = triangle.minX / kRNOcclusionBufferTileWidth;
+				const uint32 maxTileX = triangle.maxX / kRNOcclusionBufferTileWidth;
+				const uint32 minTileY = triangle.minY / kRNOcclusionBufferTileHeight;
+				const uint32 maxTileY = triangle.maxY / kRNOcclusionBufferTileHeight;
+
+				for(uint32 y = minTileY; y <= maxTileY; y ++)
+				{
+					for(uint32 x = minTileX; x <= maxTileX; x ++)
+						_tiles[y * _tilesX + x].triangles.push_back(index);
+				}
+			}
+		}
+
+		_occluders.clear();
+
+		// Tiles don't share any pixels, so every tile can be rasterized on its own
+		ParallelFor(Range(0, _tiles.size()), 0, [&](size_t index) {
+			RasterizeTile(index);
+		}, queue);
+	}
+
+	void OcclusionBuffer::SetupOccluder(const Occluder &occluder, std::vector<Triangle> &triangles) const
+	{
+		const Matrix &matModelViewProj = occluder.modelViewProjection;
+		Mesh *mesh = occluder.mesh;
+
+		Mesh::Chunk chunk = mesh->GetTrianglesChunk();
+		Mesh::ElementIterator<Vector3> iterator = chunk.GetIterator<Vector3>(Mesh::VertexAttribute::Feature::Vertices);
+		size_t triangleCount = mesh->GetIndicesCount() / 3;
+
+		triangles.reserve(triangleCount);
+
+		for(size_t i = 0; i < triangleCount; i++)
+		{
+			const Vector3 &posA = *iterator++;
+			const Vector3 &posB = *iterator++;
+			const Vector3 &posC = *iterator;
+			if(i < triangleCount-1)
+			{
+				iterator++;
+			}
+
+			Vector4 A = matModelViewProj * Vector4(posB, 1.0f);
+			Vector4 B = matModelViewProj * Vector4(posA, 1.0f);
+			Vector4 C = matModelViewProj * Vector4(posC, 1.0f);
+
+			//Skip triangle if all vertices are on the same side of the near or far clip planes
+			if(A.z < -A.w && B.z < -B.w && C.z < -C.w) continue;
+			if(A.z > A.w && B.z > B.w && C.z > C.w) continue;
+
+			//Handle clipping of triangles that intersect the near plane, otherwise dividing by w will cause all kind of issues
+			if(A.z > A.w && B.z > B.w)
+			{
+				//Both A and B are clipped, move them both onto the clipping plane towards C
+				float dA = (A.z - (A.w));
+				float dB = (B.z - (B.w));
+				float dC = (C.z - (C.w));
+				float tA = dA/(dA-dC);
+				float tB = dB/(dB-dC);
+
+				A = A + (C-A) * tA;
+				B = B + (C-B) * tB;
+			}
+			else if(A.z > A.w && C.z > C.w)
+			{
+				//Both A and C are clipped, move them both onto the clipping plane towards B
+				float dA = (A.z - (A.w));
+				float dB = (B.z - (B.w));
+				float dC = (C.z - (C.w));
+				float tA = dA/(dA-dB);
+				float tC = dC/(dC-dB);
+
+				A = A + (B-A) * tA;
+				C = C + (B-C) * tC;
+			}
+			else if(B.z > B.w && C.z > C.w)
+			{
+				//Both B and C are clipped, move them both onto the clipping plane towards A
+				float dA = (A.z - (A.w));
+				float dB = (B.z - (B.w));
+				float dC = (C.z - (C.w));
+				float tB = dB/(dB-dA);
+				float tC = dC/(dC-dA);
+
+				B = B + (A-B) * tB;
+				C = C + (A-C) * tC;
+			}
+			else if(A.z > A.w)
+			{
+				//Only A is clipped, needs to create two new points on the clipplane to replace it with
+				float dA = (A.z - (A.w));
+				float dB = (B.z - (B.w));
+				float dC = (C.z - (C.w));
+				float tB = dA/(dA-dB);
+				float tC = dA/(dA-dC);
+
+				Vector4 AB = A + (B-A) * tB;
+				Vector4 AC = A + (C-A) * tC;
+				A = AB;
+
+				SetupClipSpaceTriangle(C, AC, AB, triangles);
+			}
+			else if(B.z > B.w)
+			{
+				//Only B is clipped, needs to create two new points on the clipplane to replace it with
+				float dA = (A.z - (A.w));
+				float dB = (B.z - (B.w));
+				float dC = (C.z - (C.w));
+				float tA = dB/(dB-dA);
+				float tC = dB/(dB-dC);
+
+				Vector4 BA = B + (A-B) * tA;
+				Vector4 BC = B + (C-B) * tC;
+				B = BA;
+
+				SetupClipSpaceTriangle(C, BA, BC, triangles);
+			}
+			else if(C.z > C.w)
+			{
+				//Only C is clipped, needs to create two new points on the clipplane to replace it with
+				float dA = (A.z - (A.w));
+				float dB = (B.z - (B.w));
+				float dC = (C.z - (C.w));
+				float tA = dC/(dC-dA);
+				float tB = dC/(dC-dB);
+
+				Vector4 CA = C + (A-C) * tA;
+				Vector4 CB = C + (B-C) * tB;
+				C = CA;
+
+				SetupClipSpaceTriangle(B, CB, CA, triangles);
+			}
+
+			SetupClipSpaceTriangle(A, B, C, triangles);
+		}
+	}
+
+	void OcclusionBuffer::SetupClipSpaceTriangle(Vector4 A, Vector4 B, Vector4 C, std::vector<Triangle> &triangles) const
+	{
+		const float width = static_cast<float>(_width);
+		const float height = static_cast<float>(_height);
+
+		A /= A.w;
+		A.x = (A.x * 0.5f + 0.5f) * width;
+		A.y = (A.y * 0.5f + 0.5f) * height;
+
+		B /= B.w;
+		B.x = (B.x * 0.5f + 0.5f) * width;
+		B.y = (B.y * 0.5f + 0.5f) * height;
+
+		C /= C.w;
+		C.x = (C.x * 0.5f + 0.5f) * width;
+		C.y = (C.y * 0.5f + 0.5f) * height;
+
+		float area = EdgeFunction(Vector2(A), Vector2(B), Vector2(C));
+		if(area <= 0.0f) return; //Triangle is facing away, can just skip completely at this point
+
+		const float minX = std::min(A.x, std::min(B.x, C.x));
+		const float minY = std::min(A.y, std::min(B.y, C.y));
+		const float maxX = std::max(A.x, std::max(B.x, C.x));
+		const float maxY = std::max(A.y, std::max(B.y, C.y));
+
+		if(maxX < 0.0f || maxY < 0.0f || minX > width - 1.0f || minY > height - 1.0f)
+			return;
+
+		Triangle triangle;
+
+		triangle.minX = static_cast<uint16>(std::max(minX, 0.0f));
+		triangle.minY = static_cast<uint16>(std::max(minY, 0.0f));
+		triangle.maxX = static_cast<uint16>(std::min(maxX, width - 1.0f));
+		triangle.maxY = static_cast<uint16>(std::min(maxY, height - 1.0f));
+
+		// EdgeFunction(a, b, p) rewritten as a plane equation in p
+		const Vector4 *vertices[3] = { &B, &C, &A };
+		const Vector4 *nextVertices[3] = { &C, &A, &B };
+
+		for(size_t i = 0; i < 3; i ++)
+		{
+			const Vector4 &a = *vertices[i];
+			const Vector4 &b = *nextVertices[i];
+
+			triangle.edgeX[i] = (b.y - a.y);
+			triangle.edgeY[i] = -(b.x - a.x);
+			triangle.edgeOffset[i] = a.y * (b.x - a.x) - a.x * (b.y - a.y);
+		}
+
+		// Barycentric interpolation of the depth, also as a plane equation
+		const float inverseArea = 1.0f / area;
+
+		triangle.depthX = (triangle.edgeX[0] * A.z + triangle.edgeX[1] * B.z + triangle.edgeX[2] * C.z) * inverseArea;
+		triangle.depthY = (triangle.edgeY[0] * A.z + triangle.edgeY[1] * B.z + triangle.edgeY[2] * C.z) * inverseArea;
+		triangle.depthOffset = (triangle.edgeOffset[0] * A.z + triangle.edgeOffset[1] * B.z + triangle.edgeOffset[2] * C.z) * inverseArea - kRNOcclusionBufferDepthBias;
+		triangle.maxDepth = std::max(A.z, std::max(B.z, C.z));
+
+		triangles.push_back(triangle);
+	}
+
+	void OcclusionBuffer::RasterizeTile(size_t index)
+	{
+		Tile &tile = _tiles[index];
+
+		if(tile.triangles.empty())
+			return;
+
+		const uint32 tileX = static_cast<uint32>(index % _tilesX);
+		const uint32 tileY = static_cast<uint32>(index / _tilesX);
+
+		const uint32 originX = tileX * kRNOcclusionBufferTileWidth;
+		const uint32 originY = tileY * kRNOcclusionBufferTileHeight;
+
+		float *depth = GetTileDepth(tileX, tileY);
+
+		const SIMD::VecFloat columns[2] = {
+			SIMD::Set(originX + 0.0f, originX + 1.0f, originX + 2.0f, originX + 3.0f),
+			SIMD::Set(originX + 4.0f, originX + 5.0f, originX + 6.0f, originX + 7.0f)
+		};
+
+		const SIMD::VecFloat zero = SIMD::Zero();
+		const SIMD::VecFloat one = SIMD::Splat(1.0f);
+
+		float minDepth = tile.minDepth;
+		size_t rasterized = 0;
+
+		for(uint32 triangleIndex : tile.triangles)
+		{
+			const Triangle &triangle = _triangles[triangleIndex];
+
+			// The whole triangle is behind what is already in the tile
+			if(triangle.maxDepth <= minDepth)
+				continue;
+
+			const uint32 minY = std::max(originY, static_cast<uint32>(triangle.minY));
+			const uint32 maxY = std::min(originY + kRNOcclusionBufferTileHeight - 1, static_cast<uint32>(triangle.maxY));
+
+			const SIMD::VecFloat edgeX0 = SIMD::Splat(triangle.edgeX[0]);
+			const SIMD::VecFloat edgeX1 = SIMD::Splat(triangle.edgeX[1]);
+			const SIMD::VecFloat edgeX2 = SIMD::Splat(triangle.edgeX[2]);
+			const SIMD::VecFloat depthX = SIMD::Splat(triangle.depthX);
+
+			for(uint32 y = minY; y <= maxY; y ++)
+			{
+				const float row = static_cast<float>(y);
+
+				const SIMD::VecFloat edgeRow0 = SIMD::Splat(row * triangle.edgeY[0] + triangle.edgeOffset[0]);
+				const SIMD::VecFloat edgeRow1 = SIMD::Splat(row * triangle.edgeY[1] + triangle.edgeOffset[1]);
+				const SIMD::VecFloat edgeRow2 = SIMD::Splat(row * triangle.edgeY[2] + triangle.edgeOffset[2]);
+				const SIMD::VecFloat depthRow = SIMD::Splat(row * triangle.depthY + triangle.depthOffset);
+
+				float *pixels = depth + (y - originY) * kRNOcclusionBufferTileWidth;
+
+				for(size_t i = 0; i < 2; i ++)
+				{
+					const SIMD::VecFloat x = columns[i];
+
+					SIMD::VecFloat mask = SIMD::CompareGreaterEqual(SIMD::Add(SIMD::Mul(x, edgeX0), edgeRow0), zero);
+					mask = SIMD::And(mask, SIMD::CompareGreaterEqual(SIMD::Add(SIMD::Mul(x, edgeX1), edgeRow1), zero));
+					mask = SIMD::And(mask, SIMD::CompareGreaterEqual(SIMD::Add(SIMD::Mul(x, edgeX2), edgeRow2), zero));
+
+					if(SIMD::MoveMask(mask) == 0)
+						continue;
+
+					const SIMD::VecFloat value = SIMD::Add(SIMD::Mul(x, depthX), depthRow);
+					mask = SIMD::And(mask, SIMD::CompareLessEqual(value, one));
+
+					const SIMD::VecFloat current = SIMD::Load(pixels + i * 4);
+					SIMD::Store(pixels + i * 4, SIMD::Select(mask, SIMD::Max(current, value), current));
+				}
+			}
+
+			// Refresh the tile minimum every now and then, so the early out above gets a chance to kick in
+			if(((++ rasterized) & 7) == 0)
+			{
+				SIMD::VecFloat result = SIMD::Load(depth);
+
+				for(size_t i = 4; i < kRNOcclusionBufferTilePixels; i += 4)
+					result = SIMD::Min(result, SIMD::Load(depth + i));
+
+				minDepth = SIMD::HorizontalMin(result);
+			}
+		}
+
+		SIMD::VecFloat minResult = SIMD::Load(depth);
+		SIMD::VecFloat maxResult = minResult;
+
+		for(size_t i = 4; i < kRNOcclusionBufferTilePixels; i += 4)
+		{
+			const SIMD::VecFloat value = SIMD::Load(depth + i);
+
+			minResult = SIMD::Min(minResult, value);
+			maxResult = SIMD::Max(maxResult, value);
+		}
+
+		tile.minDepth = SIMD::HorizontalMin(minResult);
+		tile.maxDepth = SIMD::HorizontalMax(maxResult);
+		tile.triangles.clear();
+	}
+
+	bool OcclusionBuffer::TestBoundingBox(const Matrix &viewProjection, const AABB &aabb, const Vector2 &screenPixelSize) const
+	{
+		const Vector3 maxCorner = aabb.position + aabb.maxExtend;
+		const Vector3 minCorner = aabb.position + aabb.minExtend;
+
+		// The 8 box corners as two groups of 4, only x differs between the groups
+		const SIMD::VecFloat cornerX[2] = { SIMD::Splat(maxCorner.x), SIMD::Splat(minCorner.x) };
+		const SIMD::VecFloat cornerY = SIMD::Set(maxCorner.y, maxCorner.y, minCorner.y, minCorner.y);
+		const SIMD::VecFloat cornerZ = SIMD::Set(maxCorner.z, minCorner.z, minCorner.z, maxCorner.z);
+
+		const float *m = viewProjection.m;
+
+		// Everything but the x contribution is shared by both groups
+		const SIMD::VecFloat sharedX = SIMD::Add(SIMD::Add(SIMD::Mul(SIMD::Splat(m[4]), cornerY), SIMD::Mul(SIMD::Splat(m[8]), cornerZ)), SIMD::Splat(m[12]));
+		const SIMD::VecFloat sharedY = SIMD::Add(SIMD::Add(SIMD::Mul(SIMD::Splat(m[5]), cornerY), SIMD::Mul(SIMD::Splat(m[9]), cornerZ)), SIMD::Splat(m[13]));
+		const SIMD::VecFloat sharedZ = SIMD::Add(SIMD::Add(SIMD::Mul(SIMD::Splat(m[6]), cornerY), SIMD::Mul(SIMD::Splat(m[10]), cornerZ)), SIMD::Splat(m[14]));
+		const SIMD::VecFloat sharedW = SIMD::Add(SIMD::Add(SIMD::Mul(SIMD::Splat(m[7]), cornerY), SIMD::Mul(SIMD::Splat(m[11]), cornerZ)), SIMD::Splat(m[15]));
+
+		SIMD::VecFloat minX, maxX, minY, maxY, maxZ;
+
+		const SIMD::VecFloat half = SIMD::Splat(0.5f);
+
+		for(size_t i = 0; i < 2; i ++)
+		{
+			const SIMD::VecFloat x = SIMD::Add(sharedX, SIMD::Mul(SIMD::Splat(m[0]), cornerX[i]));
+			const SIMD::VecFloat y = SIMD::Add(sharedY, SIMD::Mul(SIMD::Splat(m[1]), cornerX[i]));
+			const SIMD::VecFloat z = SIMD::Add(sharedZ, SIMD::Mul(SIMD::Splat(m[2]), cornerX[i]));
+			const SIMD::VecFloat w = SIMD::Add(sharedW, SIMD::Mul(SIMD::Splat(m[3]), cornerX[i]));
+
+			//Bounding box intersects near clipping plane, assume as visible
+			if(SIMD::MoveMask(SIMD::CompareGreater(z, w)) != 0)
+				return true;
+
+			const SIMD::VecFloat screenX = SIMD::Add(SIMD::Mul(SIMD::Div(x, w), half), half);
+			const SIMD::VecFloat screenY = SIMD::Add(SIMD::Mul(SIMD::Div(y, w), half), half);
+			const SIMD::VecFloat depth = SIMD::Div(z, w);
+
+			if(i == 0)
+			{
+				minX = maxX = screenX;
+				minY = maxY = screenY;
+				maxZ = depth;
+			}
+			else
+			{
+				minX = SIMD::Min(minX, screenX);
+				maxX = SIMD::Max(maxX, screenX);
+				minY = SIMD::Min(minY, screenY);
+				maxY = SIMD::Max(maxY, screenY);
+				maxZ = SIMD::Max(maxZ, depth);
+			}
+		}
+
+		Vector3 minCorners(SIMD::HorizontalMin(minX), SIMD::HorizontalMin(minY), 0.0f);
+		Vector3 maxCorners(SIMD::HorizontalMax(maxX), SIMD::HorizontalMax(maxY), SIMD::HorizontalMax(maxZ));
+
+		//Fail depth test for objects that are smaller than a single pixel
+		if((maxCorners.x - minCorners.x) < screenPixelSize.x && (maxCorners.y - minCorners.y) < screenPixelSize.y)
+		{
+			//TODO: Above should use "or" but somehow tends to cull things that aren't really that small...
+			return false;
+		}
+
+		const float width = static_cast<float>(_width);
+		const float height = static_cast<float>(_height);
+
+		const uint32 minPixelX = std::max(std::min(std::floor(minCorners.x * width) - 1.0f, width - 1.0f), 0.0f);
+		const uint32 maxPixelX = std::max(std::min(std::ceil(maxCorners.x * width) + 1.0f, width - 1.0f), 0.0f);
+		const uint32 minPixelY = std::max(std::min(std::floor(minCorners.y * height) - 1.0f, height - 1.0f), 0.0f);
+		const uint32 maxPixelY = std::max(std::min(std::ceil(maxCorners.y * height) + 1.0f, height - 1.0f), 0.0f);
+
+		const float closestDepth = maxCorners.z;
+		const SIMD::VecFloat closest = SIMD::Splat(closestDepth);
+
+		const uint32 minTileX = minPixelX / kRNOcclusionBufferTileWidth;
+		const uint32 maxTileX = maxPixelX / kRNOcclusionBufferTileWidth;
+		const uint32 minTileY = minPixelY / kRNOcclusionBufferTileHeight;
+		const uint32 maxTileY = maxPixelY / kRNOcclusionBufferTileHeight;
+
+		for(uint32 tileY = minTileY; tileY <= maxTileY; tileY ++)
+		{
+			for(uint32 tileX = minTileX; tileX <= maxTileX; tileX ++)
+			{
+				const Tile &tile = _tiles[tileY * _tilesX + tileX];
+
+				// Everything in the tile is closer than the box
+				if(closestDepth <= tile.minDepth)
+					continue;
+
+				// The box is closer than everything in the tile, and covers at least one of its pixels
+				if(closestDepth > tile.maxDepth)
+					return true;
+
+				const uint32 originX = tileX * kRNOcclusionBufferTileWidth;
+				const uint32 originY = tileY * kRNOcclusionBufferTileHeight;
+
+				const uint32 firstY = std::max(originY, minPixelY);
+				const uint32 lastY = std::min(originY + kRNOcclusionBufferTileHeight - 1, maxPixelY);
+
+				// Mask out the columns of the tile that are outside of the box
+				const float firstX = static_cast<float>(std::max(originX, minPixelX));
+				const float lastX = static_cast<float>(std::min(originX + kRNOcclusionBufferTileWidth - 1, maxPixelX));
+
+				SIMD::VecFloat columnMask[2];
+
+				for(size_t i = 0; i < 2; i ++)
+				{
+					const float column = static_cast<float>(originX + i * 4);
+					const SIMD::VecFloat columns = SIMD::Set(column, column + 1.0f, column + 2.0f, column + 3.0f);
+
+					columnMask[i] = SIMD::And(SIMD::CompareGreaterEqual(columns, SIMD::Splat(firstX)), SIMD::CompareLessEqual(columns, SIMD::Splat(lastX)));
+				}
+
+				const float *depth = GetTileDepth(tileX, tileY);
+
+				for(uint32 y = firstY; y <= lastY; y ++)
+				{
+					const float *pixels = depth + (y - originY) * kRNOcclusionBufferTileWidth;
+
+					const SIMD::VecFloat visible0 = SIMD::And(SIMD::CompareGreater(closest, SIMD::Load(pixels)), columnMask[0]);
+					const SIMD::VecFloat visible1 = SIMD::And(SIMD::CompareGreater(closest, SIMD::Load(pixels + 4)), columnMask[1]);
+
+					if(SIMD::MoveMask(SIMD::Or(visible0, visible1)) != 0)
+						return true;
+				}
+			}
+		}
+
+		return false;
+	}
+}
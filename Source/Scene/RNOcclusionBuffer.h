@@ -0,0 +1,104 @@
+//
+//  RNOcclusionBuffer.h
+//  Rayne
+//
+//  Copyright 2019 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_OCCLUSIONBUFFER_H__
+#define __RAYNE_OCCLUSIONBUFFER_H__
+
+#include "../Base/RNBase.h"
+#include "../Math/RNMatrix.h"
+#include "../Math/RNVector.h"
+#include "../Math/RNAABB.h"
+
+#define kRNOcclusionBufferTileWidth 8
+#define kRNOcclusionBufferTileHeight 8
+
+namespace RN
+{
+	class Mesh;
+	class WorkQueue;
+
+	// Software depth buffer for occlusion culling. Depth is 1 closest to the camera and goes down to 0 the further away it is.
+	// Occluder triangles are binned into 8x8 pixel tiles and rasterized with SIMD, one tile per job. Every tile keeps its
+	// min and max depth, so occludee tests can accept or reject whole tiles before looking at single pixels.
+	class OcclusionBuffer
+	{
+	public:
+		RNAPI OcclusionBuffer(uint32 width, uint32 height);
+		RNAPI ~OcclusionBuffer();
+
+		// The size is rounded up to full tiles
+		RNAPI void Resize(uint32 width, uint32 height);
+		RNAPI void Clear();
+
+		// Only records the occluder, the work happens in Rasterize()
+		RNAPI void AddOccluder(const Matrix &modelViewProjection, Mesh *mesh);
+		RNAPI void Rasterize(WorkQueue *queue = nullptr);
+
+		// Thread safe once Rasterize() returned
+		RNAPI bool TestBoundingBox(const Matrix &viewProjection, const AABB &aabb, const Vector2 &screenPixelSize) const;
+
+		uint32 GetWidth() const { return _width; }
+		uint32 GetHeight() const { return _height; }
+
+		// y goes up, starting at the bottom row
+		RNAPI float GetDepth(uint32 x, uint32 y) const;
+
+	private:
+		struct Occluder
+		{
+			Matrix modelViewProjection;
+			Mesh *mesh;
+		};
+
+		struct Triangle
+		{
+			// Edge functions as e = x * edgeX + y * edgeY + edgeOffset, a pixel is covered when all three are >= 0
+			float edgeX[3];
+			float edgeY[3];
+			float edgeOffset[3];
+
+			// Depth plane as z = x * depthX + y * depthY + depthOffset
+			float depthX;
+			float depthY;
+			float depthOffset;
+			float maxDepth;
+
+			uint16 minX;
+			uint16 minY;
+			uint16 maxX;
+			uint16 maxY;
+		};
+
+		struct Tile
+		{
+			std::vector<uint32> triangles;
+			float minDepth;
+			float maxDepth;
+		};
+
+		void SetupOccluder(const Occluder &occluder, std::vector<Triangle> &triangles) const;
+		void SetupClipSpaceTriangle(Vector4 A, Vector4 B, Vector4 C, std::vector<Triangle> &triangles) const;
+		void RasterizeTile(size_t index);
+
+		float *GetTileDepth(size_t tileX, size_t tileY) const { return _depth + (tileY * _tilesX + tileX) * (kRNOcclusionBufferTileWidth * kRNOcclusionBufferTileHeight); }
+
+		uint32 _width;
+		uint32 _height;
+		uint32 _tilesX;
+		uint32 _tilesY;
+
+		float *_depth;
+		std::vector<Tile> _tiles;
+
+		std::vector<Occluder> _occluders;
+		std::vector<std::vector<Triangle>> _occluderTriangles;
+		std::vector<Triangle> _triangles;
+	};
+}
+
+#endif /* __RAYNE_OCCLUSIONBUFFER_H__ */
@@ -28,7 +28,8 @@ namespace RN
 	_maxParticles(100),
 	_maxParticlesSoft(100),
 	_spawnRate(0.05f),
-	_time(0.0f)
+	_time(0.0f),
+	_meshIndexedParticles(kRNNotFound)
 	{
 		_rng = new RandomNumberGenerator(RandomNumberGenerator::Type::MersenneTwister);
 		
@@ -61,7 +62,8 @@ namespace RN
 	_isSorted(emitter->_isSorted),
 	_isRenderedInversed(emitter->_isRenderedInversed),
 	_maxParticles(emitter->_maxParticles),
-	_spawnRate(emitter->_spawnRate)
+	_spawnRate(emitter->_spawnRate),
+	_meshIndexedParticles(kRNNotFound)
 	{
 		_rng = emitter->GetGenerator();
 		
@@ -121,6 +123,8 @@ namespace RN
 			Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::UVCoords0, PrimitiveType::Vector2),
 			Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::UVCoords1, PrimitiveType::Vector2),
 			Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::Indices, PrimitiveType::Uint16) }, maxParticles*4, maxParticles*6);
+		_mesh->SetStreaming(true);
+		_meshIndexedParticles = kRNNotFound;
 	}
 
 	void ParticleEmitter::SetMaxParticlesSoft(uint32 maxParticles)
@@ -178,22 +182,24 @@ namespace RN
 	
 	void ParticleEmitter::UpdateParticles(float delta)
 	{
-		for(auto i=_particles.begin(); i!=_particles.end();)
+		//Survivors are moved down in place, erasing every dead particle on its own made this quadratic
+		size_t alive = 0;
+		for(size_t i = 0; i < _particles.size(); i++)
 		{
-			Particle *particle = *i;
+			Particle *particle = _particles[i];
 			particle->Update(delta);
 			
 			if(particle->lifespan <= 0.0f)
 			{
 				delete particle;
-				
-				i = _particles.erase(i);
 				continue;
 			}
 			
-			i ++;
+			_particles[alive++] = particle;
 		}
 		
+		_particles.resize(alive);
+		
 		if(_spawnRate < k::EpsilonFloat)
 			return;
 		
@@ -218,7 +224,6 @@ namespace RN
 		Mesh::ElementIterator<Color> colorIterator = chunk.GetIterator<Color>(Mesh::VertexAttribute::Feature::Color0);
 		Mesh::ElementIterator<Vector2> texcoordsIterator = chunk.GetIterator<Vector2>(Mesh::VertexAttribute::Feature::UVCoords0);
 		Mesh::ElementIterator<Vector2> sizeIterator = chunk.GetIterator<Vector2>(Mesh::VertexAttribute::Feature::UVCoords1);
-		Mesh::ElementIterator<RN::uint16> indexIterator = chunk.GetIterator<RN::uint16>(Mesh::VertexAttribute::Feature::Indices);
 		
 		int to = std::min(static_cast<int>(_particles.size()), static_cast<int>(_maxParticles));
 		if(!_isRenderedInversed)
@@ -255,17 +260,37 @@ namespace RN
 				*sizeIterator++ = halfDirectionBottom;
 				*sizeIterator++ = -halfDirectionBottom;
 				*sizeIterator++ = halfDirectionTop;
+			}
+			
+			//The indices only depend on the number of particles, so only those of particles that appeared or disappeared are written
+			size_t from = 0;
+			size_t until = _maxParticles;
+			if(_meshIndexedParticles != kRNNotFound)
+			{
+				from = std::min(_meshIndexedParticles, static_cast<size_t>(to));
+				until = std::max(_meshIndexedParticles, static_cast<size_t>(to));
+			}
+			
+			Mesh::ElementIterator<RN::uint16> indexIterator = chunk.GetIteratorAtIndex<RN::uint16>(Mesh::VertexAttribute::Feature::Indices, from * 6);
+			for(size_t i = from; i < until; i++)
+			{
+				const RN::uint16 base = i * 4;
+				const bool visible = (i < static_cast<size_t>(to));
 				
-				*indexIterator++ = i * 4 + 0;
-				*indexIterator++ = i * 4 + 1;
-				*indexIterator++ = i * 4 + 2;
-				*indexIterator++ = i * 4 + 2;
-				*indexIterator++ = i * 4 + 1;
-				*indexIterator++ = i * 4 + 3;
+				*indexIterator++ = base + 0;
+				*indexIterator++ = base + (visible? 1 : 0);
+				*indexIterator++ = base + (visible? 2 : 0);
+				*indexIterator++ = base + (visible? 2 : 0);
+				*indexIterator++ = base + (visible? 1 : 0);
+				*indexIterator++ = base + (visible? 3 : 0);
 			}
+			
+			_meshIndexedParticles = to;
 		}
 		else
 		{
+			Mesh::ElementIterator<RN::uint16> indexIterator = chunk.GetIterator<RN::uint16>(Mesh::VertexAttribute::Feature::Indices);
+			
 			for(int i = to-1; i >= 0; i--)
 			{
 				Particle *particle = _particles[i];
@@ -305,21 +330,21 @@ namespace RN
 				*indexIterator++ = i * 4 + 1;
 				*indexIterator++ = i * 4 + 3;
 			}
+			
+			for(uint32 i = to; i < _maxParticles; i++)
+			{
+				*indexIterator++ = i * 4 + 0;
+				*indexIterator++ = i * 4 + 0;
+				*indexIterator++ = i * 4 + 0;
+				*indexIterator++ = i * 4 + 0;
+				*indexIterator++ = i * 4 + 0;
+				*indexIterator++ = i * 4 + 0;
+			}
+			
+			_meshIndexedParticles = kRNNotFound;
 		}
 		
-		for(uint32 i = to; i < _maxParticles; i++)
-		{
-			*indexIterator++ = i * 4 + 0;
-			*indexIterator++ = i * 4 + 0;
-			*indexIterator++ = i * 4 + 0;
-			*indexIterator++ = i * 4 + 0;
-			*indexIterator++ = i * 4 + 0;
-			*indexIterator++ = i * 4 + 0;
-		}
-		
-		//TODO:Make this less ugly... these variables should get set when changing things with the iterator or something
-		_mesh->changedVertices = true;
-		_mesh->changedIndices = true;
+		//Only the ranges written through the iterators are uploaded
 		_mesh->EndChanges();
 	}
 	
@@ -339,6 +364,11 @@ namespace RN
 		//TODO: Add occlusion culling or something
 		return true;
 	}
+
+	bool ParticleEmitter::UsesFrustumCulling() const
+	{
+		return false;
+	}
 	
 	void ParticleEmitter::Render(Renderer *renderer, Camera *camera) const
 	{
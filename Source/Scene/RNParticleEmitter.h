@@ -56,6 +56,7 @@ namespace RN
 		
 		RNAPI void Update(float delta) override;
 		RNAPI bool CanRender(Renderer *renderer, Camera *camera) const override;
+		RNAPI bool UsesFrustumCulling() const override;
 		RNAPI void Render(Renderer *renderer, Camera *camera) const override;
 		
 	protected:
@@ -80,6 +81,7 @@ namespace RN
 		float _spawnRate;
 		
 		float _time;
+		mutable size_t _meshIndexedParticles; // Particles the index buffer is set up for, kRNNotFound if it has to be rewritten
 		
 		__RNDeclareMetaInternal(ParticleEmitter)
 	};
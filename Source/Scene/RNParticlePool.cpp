@@ -0,0 +1,280 @@
+//
+//  RNParticlePool.cpp
+//  Rayne
+//
+//  Copyright 2014 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "RNParticlePool.h"
+#include "../Base/RNMemory.h"
+#include "../Math/RNSIMD.h"
+#include "../Threads/RNParallelFor.h"
+
+namespace RN
+{
+	static constexpr size_t __ParticleStreamCount = static_cast<size_t>(ParticlePool::Stream::Count);
+
+	ParticlePool::ParticlePool(size_t capacity) :
+		_stride((capacity + 3) & ~static_cast<size_t>(3)),
+		_capacity(capacity),
+		_count(0)
+	{
+		RN_ASSERT(capacity > 0, "Particle pools need a capacity");
+
+		// Zeroed so the padding lanes the update processes never contain garbage that could end up as denormals
+		_data = static_cast<float *>(Memory::AllocateAligned(_stride * __ParticleStreamCount * sizeof(float), 16));
+		std::fill(_data, _data + _stride * __ParticleStreamCount, 0.0f);
+
+		// Keys and indices are sorted back and forth between two halves
+		_sortKeys = static_cast<uint32 *>(Memory::AllocateAligned(_stride * 4 * sizeof(uint32), 16));
+		_sortIndices = _sortKeys + _stride * 2;
+	}
+
+	ParticlePool::~ParticlePool()
+	{
+		Memory::FreeAligned(_data);
+		Memory::FreeAligned(_sortKeys);
+	}
+
+	size_t ParticlePool::Spawn(size_t count)
+	{
+		count = std::min(count, _capacity - _count);
+		_count += count;
+
+		return count;
+	}
+
+	void ParticlePool::Kill(size_t index)
+	{
+		RN_ASSERT(index < _count, "Particle index out of range");
+
+		_count --;
+
+		if(index != _count)
+			Move(_count, index);
+	}
+
+	void ParticlePool::Clear()
+	{
+		_count = 0;
+	}
+
+	void ParticlePool::Move(size_t from, size_t to)
+	{
+		for(size_t i = 0; i < __ParticleStreamCount; i ++)
+		{
+			float *stream = _data + i * _stride;
+			stream[to] = stream[from];
+		}
+	}
+
+	void ParticlePool::Update(float delta, const Color &startColor, const Color &endColor)
+	{
+		if(_count == 0)
+			return;
+
+		// Whole blocks of 4 are updated, the lanes past the last particle are padding
+		const size_t blocks = (_count + 3) / 4;
+
+		if(_count < kRNParticlePoolParallelThreshold)
+		{
+			UpdateRange(Range(0, blocks * 4), delta, startColor, endColor);
+		}
+		else
+		{
+			ParallelForChunks(Range(0, blocks), kRNParticlePoolGrain / 4, [&](const Range &chunk) {
+				UpdateRange(Range(chunk.origin * 4, chunk.length * 4), delta, startColor, endColor);
+			});
+		}
+
+		// Swap remove the dead particles, testing four at once to skip over living ones quickly
+		const float *lifespan = GetStream(Stream::Lifespan);
+		const SIMD::VecFloat zero = SIMD::Zero();
+
+		size_t index = 0;
+		while(index < _count)
+		{
+			if((index & 3) == 0 && index + 4 <= _count && SIMD::MoveMask(SIMD::CompareLessEqual(SIMD::Load(lifespan + index), zero)) == 0)
+			{
+				index += 4;
+				continue;
+			}
+
+			if(lifespan[index] <= 0.0f)
+			{
+				// The moved particle is tested again
+				Kill(index);
+				continue;
+			}
+
+			index ++;
+		}
+	}
+
+	void ParticlePool::UpdateRange(const Range &range, float delta, const Color &startColor, const Color &endColor)
+	{
+		float *positionX = GetStream(Stream::PositionX);
+		float *positionY = GetStream(Stream::PositionY);
+		float *positionZ = GetStream(Stream::PositionZ);
+		float *velocityX = GetStream(Stream::VelocityX);
+		float *velocityY = GetStream(Stream::VelocityY);
+		float *velocityZ = GetStream(Stream::VelocityZ);
+		const float *gravityX = GetStream(Stream::GravityX);
+		const float *gravityY = GetStream(Stream::GravityY);
+		const float *gravityZ = GetStream(Stream::GravityZ);
+
+		float *time = GetStream(Stream::Time);
+		float *lifespan = GetStream(Stream::Lifespan);
+		const float *inverseDuration = GetStream(Stream::InverseDuration);
+
+		const float *sizeStart = GetStream(Stream::SizeStart);
+		const float *sizeDelta = GetStream(Stream::SizeDelta);
+		const float *rotationStart = GetStream(Stream::RotationStart);
+		const float *rotationDelta = GetStream(Stream::RotationDelta);
+
+		float *size = GetStream(Stream::Size);
+		float *rotation = GetStream(Stream::Rotation);
+		float *colorR = GetStream(Stream::ColorR);
+		float *colorG = GetStream(Stream::ColorG);
+		float *colorB = GetStream(Stream::ColorB);
+		float *colorA = GetStream(Stream::ColorA);
+
+		const SIMD::VecFloat dt = SIMD::Splat(delta);
+		const SIMD::VecFloat zero = SIMD::Zero();
+		const SIMD::VecFloat one = SIMD::Splat(1.0f);
+
+		const SIMD::VecFloat startR = SIMD::Splat(startColor.r);
+		const SIMD::VecFloat startG = SIMD::Splat(startColor.g);
+		const SIMD::VecFloat startB = SIMD::Splat(startColor.b);
+		const SIMD::VecFloat startA = SIMD::Splat(startColor.a);
+		const SIMD::VecFloat deltaR = SIMD::Splat(endColor.r - startColor.r);
+		const SIMD::VecFloat deltaG = SIMD::Splat(endColor.g - startColor.g);
+		const SIMD::VecFloat deltaB = SIMD::Splat(endColor.b - startColor.b);
+		const SIMD::VecFloat deltaA = SIMD::Splat(endColor.a - startColor.a);
+
+		const size_t end = range.GetEnd();
+
+		for(size_t i = range.origin; i < end; i += 4)
+		{
+			const SIMD::VecFloat particleTime = SIMD::Add(SIMD::Load(time + i), dt);
+			SIMD::Store(time + i, particleTime);
+			SIMD::Store(lifespan + i, SIMD::Sub(SIMD::Load(lifespan + i), dt));
+
+			// Same order as GenericParticle, the velocity is updated before it moves the particle
+			const SIMD::VecFloat vx = SIMD::Add(SIMD::Load(velocityX + i), SIMD::Mul(SIMD::Load(gravityX + i), dt));
+			const SIMD::VecFloat vy = SIMD::Add(SIMD::Load(velocityY + i), SIMD::Mul(SIMD::Load(gravityY + i), dt));
+			const SIMD::VecFloat vz = SIMD::Add(SIMD::Load(velocityZ + i), SIMD::Mul(SIMD::Load(gravityZ + i), dt));
+
+			SIMD::Store(velocityX + i, vx);
+			SIMD::Store(velocityY + i, vy);
+			SIMD::Store(velocityZ + i, vz);
+
+			SIMD::Store(positionX + i, SIMD::Add(SIMD::Load(positionX + i), SIMD::Mul(vx, dt)));
+			SIMD::Store(positionY + i, SIMD::Add(SIMD::Load(positionY + i), SIMD::Mul(vy, dt)));
+			SIMD::Store(positionZ + i, SIMD::Add(SIMD::Load(positionZ + i), SIMD::Mul(vz, dt)));
+
+			const SIMD::VecFloat t = SIMD::Max(SIMD::Min(SIMD::Mul(particleTime, SIMD::Load(inverseDuration + i)), one), zero);
+
+			SIMD::Store(size + i, SIMD::Add(SIMD::Load(sizeStart + i), SIMD::Mul(SIMD::Load(sizeDelta + i), t)));
+			SIMD::Store(rotation + i, SIMD::Add(SIMD::Load(rotationStart + i), SIMD::Mul(SIMD::Load(rotationDelta + i), t)));
+
+			SIMD::Store(colorR + i, SIMD::Add(startR, SIMD::Mul(deltaR, t)));
+			SIMD::Store(colorG + i, SIMD::Add(startG, SIMD::Mul(deltaG, t)));
+			SIMD::Store(colorB + i, SIMD::Add(startB, SIMD::Mul(deltaB, t)));
+			SIMD::Store(colorA + i, SIMD::Add(startA, SIMD::Mul(deltaA, t)));
+		}
+	}
+
+	const uint32 *ParticlePool::SortByDepth(const Vector3 &origin, const Vector3 &direction, const Matrix *transform, bool reversed)
+	{
+		if(_count == 0)
+			return _sortIndices;
+
+		const float *positionX = GetStream(Stream::PositionX);
+		const float *positionY = GetStream(Stream::PositionY);
+		const float *positionZ = GetStream(Stream::PositionZ);
+
+		// Folding the transform and the origin into the direction leaves a single dot product per particle
+		Vector3 axis = direction;
+		float offset = -direction.GetDotProduct(origin);
+
+		if(transform)
+		{
+			const Matrix &m = *transform;
+
+			axis = Vector3(m.m[0] * direction.x + m.m[1] * direction.y + m.m[2] * direction.z,
+						   m.m[4] * direction.x + m.m[5] * direction.y + m.m[6] * direction.z,
+						   m.m[8] * direction.x + m.m[9] * direction.y + m.m[10] * direction.z);
+			offset += m.m[12] * direction.x + m.m[13] * direction.y + m.m[14] * direction.z;
+		}
+
+		// Farthest first means descending depth, so the keys get flipped unless reversed
+		const uint32 flip = reversed? 0 : 0xffffffff;
+
+		uint32 *keys = _sortKeys;
+		uint32 *indices = _sortIndices;
+
+		const SIMD::VecFloat axisX = SIMD::Splat(axis.x);
+		const SIMD::VecFloat axisY = SIMD::Splat(axis.y);
+		const SIMD::VecFloat axisZ = SIMD::Splat(axis.z);
+		const SIMD::VecFloat depthOffset = SIMD::Splat(offset);
+
+		const size_t blocks = (_count + 3) / 4;
+		for(size_t i = 0; i < blocks * 4; i += 4)
+		{
+			SIMD::VecFloat depth = SIMD::Add(SIMD::Mul(SIMD::Load(positionX + i), axisX), depthOffset);
+			depth = SIMD::Add(depth, SIMD::Mul(SIMD::Load(positionY + i), axisY));
+			depth = SIMD::Add(depth, SIMD::Mul(SIMD::Load(positionZ + i), axisZ));
+
+			float values[4];
+			SIMD::Store(values, depth);
+
+			for(size_t j = 0; j < 4; j ++)
+			{
+				// Maps the float to an integer that sorts the same way
+				uint32 bits;
+				memcpy(&bits, &values[j], sizeof(uint32));
+
+				keys[i + j] = ((bits & 0x80000000)? ~bits : (bits | 0x80000000)) ^ flip;
+				indices[i + j] = static_cast<uint32>(i + j);
+			}
+		}
+
+		// Least significant digit first radix sort with 8 bit digits, digits all keys share are skipped
+		uint32 *keysTemp = keys + _stride;
+		uint32 *indicesTemp = indices + _stride;
+
+		for(uint32 shift = 0; shift < 32; shift += 8)
+		{
+			size_t histogram[256] = { 0 };
+
+			for(size_t i = 0; i < _count; i ++)
+				histogram[(keys[i] >> shift) & 0xff] ++;
+
+			if(histogram[(keys[0] >> shift) & 0xff] == _count)
+				continue;
+
+			size_t sum = 0;
+			for(size_t i = 0; i < 256; i ++)
+			{
+				const size_t count = histogram[i];
+				histogram[i] = sum;
+				sum += count;
+			}
+
+			for(size_t i = 0; i < _count; i ++)
+			{
+				const size_t target = histogram[(keys[i] >> shift) & 0xff] ++;
+
+				keysTemp[target] = keys[i];
+				indicesTemp[target] = indices[i];
+			}
+
+			std::swap(keys, keysTemp);
+			std::swap(indices, indicesTemp);
+		}
+
+		return indices;
+	}
+}
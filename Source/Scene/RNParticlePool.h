@@ -0,0 +1,95 @@
+//
+//  RNParticlePool.h
+//  Rayne
+//
+//  Copyright 2014 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_PARTICLEPOOL_H__
+#define __RAYNE_PARTICLEPOOL_H__
+
+#include "../Base/RNBase.h"
+#include "../Math/RNVector.h"
+#include "../Math/RNColor.h"
+#include "../Math/RNMatrix.h"
+
+#define kRNParticlePoolParallelThreshold 8192 // Pools with fewer particles are updated on the calling thread
+#define kRNParticlePoolGrain 4096
+
+namespace RN
+{
+	// Fixed capacity storage for particles, with every attribute in its own array so the update can process four
+	// particles at once. Dead particles are removed by moving the last particle into their slot, which changes the
+	// order of particles. Indices are only valid until the next Update() or Kill().
+	class ParticlePool
+	{
+	public:
+		enum class Stream
+		{
+			PositionX,
+			PositionY,
+			PositionZ,
+			VelocityX,
+			VelocityY,
+			VelocityZ,
+			GravityX,
+			GravityY,
+			GravityZ,
+
+			Time,
+			Lifespan, // Remaining time, the particle dies once it reaches 0
+			InverseDuration, // 1 / the initial lifespan, the ramps are evaluated at Time * InverseDuration
+
+			SizeStart,
+			SizeDelta,
+			RotationStart,
+			RotationDelta,
+
+			// Written by Update()
+			Size,
+			Rotation,
+			ColorR,
+			ColorG,
+			ColorB,
+			ColorA,
+
+			Count
+		};
+
+		RNAPI ParticlePool(size_t capacity);
+		RNAPI ~ParticlePool();
+
+		// Appends up to count particles and returns how many fit, their attributes have to be set by the caller
+		RNAPI size_t Spawn(size_t count);
+		RNAPI void Kill(size_t index);
+		RNAPI void Clear();
+
+		// Integrates the particles, evaluates their size, rotation and color ramps and removes the ones that died
+		RNAPI void Update(float delta, const Color &startColor, const Color &endColor);
+
+		// Returns the particle indices ordered by their depth along direction, farthest first unless reversed.
+		// The transform is applied to the positions first if given, ie. for particles in local space.
+		RNAPI const uint32 *SortByDepth(const Vector3 &origin, const Vector3 &direction, const Matrix *transform, bool reversed);
+
+		float *GetStream(Stream stream) { return _data + static_cast<size_t>(stream) * _stride; }
+		const float *GetStream(Stream stream) const { return _data + static_cast<size_t>(stream) * _stride; }
+
+		size_t GetCount() const { return _count; }
+		size_t GetCapacity() const { return _capacity; }
+
+	private:
+		void UpdateRange(const Range &range, float delta, const Color &startColor, const Color &endColor);
+		void Move(size_t from, size_t to);
+
+		float *_data;
+		size_t _stride; // Capacity rounded up to a multiple of 4
+		size_t _capacity;
+		size_t _count;
+
+		uint32 *_sortKeys;
+		uint32 *_sortIndices;
+	};
+}
+
+#endif /* __RAYNE_PARTICLEPOOL_H__ */
@@ -0,0 +1,455 @@
+//
+//  RNPooledParticleEmitter.cpp
+//  Rayne
+//
+//  Copyright 2014 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "RNPooledParticleEmitter.h"
+#include "RNCamera.h"
+#include "../Threads/RNParallelFor.h"
+
+namespace RN
+{
+	RNDefineMeta(PooledParticleEmitter, SceneNode)
+
+	PooledParticleEmitter::PooledParticleEmitter() :
+	_pool(nullptr),
+	_material(nullptr),
+	_mesh(nullptr),
+	_isLocal(true),
+	_isSorted(false),
+	_isRenderedInversed(false),
+	_maxParticles(100),
+	_spawnRate(0.05f),
+	_time(0.0f),
+	_meshParticles(0),
+	_lifeSpan(Vector2(2.0f, 4.0f)),
+	_startColor(Color()),
+	_endColor(Color(1.0f, 1.0f, 1.0f, 0.0f)),
+	_startSize(Vector2(0.5f, 1.5f)),
+	_endSize(Vector2(1.5f, 2.5f)),
+	_startRotation(Vector2(0.0f, 0.0f)),
+	_endRotation(Vector2(0.0f, 0.0f)),
+	_gravity(Vector3(0.0f, -0.1f, 0.0f)),
+	_velocity(Vector3(0.0f, 0.5f, 0.0f)),
+	_velocityRandomizeMin(Vector3(-0.5f, -0.5f, -0.5f)),
+	_velocityRandomizeMax(Vector3(0.5f, 0.5f, 0.5f)),
+	_positionRandomizeMin(Vector3(-0.5f, -0.5f, -0.5f)),
+	_positionRandomizeMax(Vector3(0.5f, 0.5f, 0.5f))
+	{
+		_rng = new RandomNumberGenerator(RandomNumberGenerator::Type::MersenneTwister);
+
+		SetRenderPriority(RenderPriority::RenderTransparent);
+
+		Shader::Options *shaderOptions = Shader::Options::WithNone();
+		shaderOptions->AddDefine("RN_PARTICLES", "1");
+		_material = Material::WithShaders(Renderer::GetActiveRenderer()->GetDefaultShader(Shader::Type::Vertex, shaderOptions, Shader::UsageHint::Default), Renderer::GetActiveRenderer()->GetDefaultShader(Shader::Type::Fragment, shaderOptions, Shader::UsageHint::Default))->Retain();
+
+		shaderOptions->EnableMultiview();
+		_material->SetVertexShader(Renderer::GetActiveRenderer()->GetDefaultShader(Shader::Type::Vertex, shaderOptions, Shader::UsageHint::Multiview), Shader::UsageHint::Multiview);
+		_material->SetFragmentShader(Renderer::GetActiveRenderer()->GetDefaultShader(Shader::Type::Fragment, shaderOptions, Shader::UsageHint::Multiview), Shader::UsageHint::Multiview);
+
+		_material->SetDepthWriteEnabled(false);
+		_material->SetBlendOperation(BlendOperation::Add, BlendOperation::Add);
+		_material->SetBlendFactorSource(BlendFactor::One, BlendFactor::One);
+		_material->SetBlendFactorDestination(BlendFactor::OneMinusSourceAlpha, BlendFactor::OneMinusSourceAlpha);
+
+		Initialize();
+	}
+
+	PooledParticleEmitter::PooledParticleEmitter(const PooledParticleEmitter *emitter) :
+	SceneNode(emitter),
+	_pool(nullptr),
+	_material(SafeRetain(emitter->_material)),
+	_mesh(nullptr),
+	_rng(SafeRetain(emitter->_rng)),
+	_isLocal(emitter->_isLocal),
+	_isSorted(emitter->_isSorted),
+	_isRenderedInversed(emitter->_isRenderedInversed),
+	_maxParticles(emitter->_maxParticles),
+	_spawnRate(emitter->_spawnRate),
+	_time(0.0f),
+	_meshParticles(0),
+	_lifeSpan(emitter->_lifeSpan),
+	_startColor(emitter->_startColor),
+	_endColor(emitter->_endColor),
+	_startSize(emitter->_startSize),
+	_endSize(emitter->_endSize),
+	_startRotation(emitter->_startRotation),
+	_endRotation(emitter->_endRotation),
+	_gravity(emitter->_gravity),
+	_velocity(emitter->_velocity),
+	_velocityRandomizeMin(emitter->_velocityRandomizeMin),
+	_velocityRandomizeMax(emitter->_velocityRandomizeMax),
+	_positionRandomizeMin(emitter->_positionRandomizeMin),
+	_positionRandomizeMax(emitter->_positionRandomizeMax)
+	{
+		Initialize();
+	}
+
+	PooledParticleEmitter::~PooledParticleEmitter()
+	{
+		delete _pool;
+
+		Renderer::GetActiveRenderer()->DeleteDrawable(_drawable);
+
+		SafeRelease(_material);
+		SafeRelease(_mesh);
+		SafeRelease(_rng);
+	}
+
+	void PooledParticleEmitter::Initialize()
+	{
+		SetMaxParticles(_maxParticles);
+
+		Renderer *renderer = Renderer::GetActiveRenderer();
+		_drawable = renderer->CreateDrawable();
+	}
+
+	void PooledParticleEmitter::Cook(float time, int steps)
+	{
+		float delta = time / steps;
+
+		for(int i=0; i<steps; i++)
+		{
+			UpdateParticles(delta);
+		}
+
+		UpdateMesh(nullptr);
+	}
+
+	void PooledParticleEmitter::SetSpawnRate(float spawnRate)
+	{
+		_spawnRate = spawnRate;
+	}
+
+	void PooledParticleEmitter::SetParticlesPerSecond(size_t particles)
+	{
+		if(particles == 0)
+		{
+			_spawnRate = -1.0f;
+			return;
+		}
+		_spawnRate = 1.0f / particles;
+	}
+
+	void PooledParticleEmitter::SetMaxParticles(uint32 maxParticles)
+	{
+		RN_ASSERT(maxParticles > 0 && maxParticles <= 0x3fffffff, "Maximum number of particles needs to be between 1 and 2^30!");
+
+		_maxParticles = maxParticles;
+
+		delete _pool;
+		_pool = new ParticlePool(maxParticles);
+
+		SafeRelease(_mesh);
+
+		// Quads never move between slots, so the indices are written once and particles that died just collapse their quad
+		const bool wideIndices = (maxParticles * 4 > 0xffff);
+
+		_mesh = new Mesh({ Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::Vertices, PrimitiveType::Vector3),
+			Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::Color0, PrimitiveType::Color),
+			Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::UVCoords0, PrimitiveType::Vector2),
+			Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::UVCoords1, PrimitiveType::Vector2),
+			Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::Indices, wideIndices? PrimitiveType::Uint32 : PrimitiveType::Uint16) }, maxParticles*4, maxParticles*6);
+		_mesh->SetStreaming(true);
+
+		_mesh->BeginChanges();
+
+		if(wideIndices)
+		{
+			uint32 *indices = static_cast<uint32 *>(_mesh->GetCPUIndicesBuffer());
+			for(uint32 i = 0; i < maxParticles; i++)
+			{
+				*indices++ = i * 4 + 0;
+				*indices++ = i * 4 + 1;
+				*indices++ = i * 4 + 2;
+				*indices++ = i * 4 + 2;
+				*indices++ = i * 4 + 1;
+				*indices++ = i * 4 + 3;
+			}
+		}
+		else
+		{
+			uint16 *indices = static_cast<uint16 *>(_mesh->GetCPUIndicesBuffer());
+			for(uint32 i = 0; i < maxParticles; i++)
+			{
+				const uint16 base = i * 4;
+
+				*indices++ = base + 0;
+				*indices++ = base + 1;
+				*indices++ = base + 2;
+				*indices++ = base + 2;
+				*indices++ = base + 1;
+				*indices++ = base + 3;
+			}
+		}
+
+		_mesh->changedIndices = true;
+		_mesh->EndChanges();
+
+		// Nothing is known about the vertex buffer contents yet, so every quad gets collapsed on the first update
+		_meshParticles = maxParticles;
+	}
+
+	void PooledParticleEmitter::SetMaterial(Material *material)
+	{
+		SafeRelease(_material);
+		_material = SafeRetain(material);
+	}
+
+	void PooledParticleEmitter::SetGenerator(RandomNumberGenerator *generator)
+	{
+		SafeRelease(_rng);
+		_rng = SafeRetain(generator);
+	}
+
+	void PooledParticleEmitter::SpawnParticles(size_t particles)
+	{
+		RN_ASSERT(_material, "PooledParticleEmitter need a material to spawn particles");
+
+		const size_t first = _pool->GetCount();
+		particles = _pool->Spawn(particles);
+
+		if(particles == 0)
+			return;
+
+		float *positionX = _pool->GetStream(ParticlePool::Stream::PositionX);
+		float *positionY = _pool->GetStream(ParticlePool::Stream::PositionY);
+		float *positionZ = _pool->GetStream(ParticlePool::Stream::PositionZ);
+		float *velocityX = _pool->GetStream(ParticlePool::Stream::VelocityX);
+		float *velocityY = _pool->GetStream(ParticlePool::Stream::VelocityY);
+		float *velocityZ = _pool->GetStream(ParticlePool::Stream::VelocityZ);
+		float *gravityX = _pool->GetStream(ParticlePool::Stream::GravityX);
+		float *gravityY = _pool->GetStream(ParticlePool::Stream::GravityY);
+		float *gravityZ = _pool->GetStream(ParticlePool::Stream::GravityZ);
+		float *time = _pool->GetStream(ParticlePool::Stream::Time);
+		float *lifespan = _pool->GetStream(ParticlePool::Stream::Lifespan);
+		float *inverseDuration = _pool->GetStream(ParticlePool::Stream::InverseDuration);
+		float *sizeStart = _pool->GetStream(ParticlePool::Stream::SizeStart);
+		float *sizeDelta = _pool->GetStream(ParticlePool::Stream::SizeDelta);
+		float *rotationStart = _pool->GetStream(ParticlePool::Stream::RotationStart);
+		float *rotationDelta = _pool->GetStream(ParticlePool::Stream::RotationDelta);
+		float *size = _pool->GetStream(ParticlePool::Stream::Size);
+		float *rotation = _pool->GetStream(ParticlePool::Stream::Rotation);
+		float *colorR = _pool->GetStream(ParticlePool::Stream::ColorR);
+		float *colorG = _pool->GetStream(ParticlePool::Stream::ColorG);
+		float *colorB = _pool->GetStream(ParticlePool::Stream::ColorB);
+		float *colorA = _pool->GetStream(ParticlePool::Stream::ColorA);
+
+		float sizeScale = 1.0f;
+		Vector3 scale(1.0f);
+		Vector3 offset;
+
+		if(!_isLocal)
+		{
+			scale = GetWorldScale();
+			sizeScale = std::max(std::max(scale.x, scale.y), scale.z);
+			offset = GetWorldPosition();
+		}
+
+		// Same distributions as GenericParticleEmitter
+		for(size_t i = first; i < first + particles; i++)
+		{
+			const Vector3 position = _rng->GetRandomVector3Range(_positionRandomizeMin, _positionRandomizeMax) * scale + offset;
+			const float duration = _rng->GetRandomFloatRange(_lifeSpan.x, _lifeSpan.y);
+			const Vector3 gravity = _gravity * scale;
+			const Vector3 velocity = (_velocity + _rng->GetRandomVector3Range(_velocityRandomizeMin, _velocityRandomizeMax)) * scale;
+
+			positionX[i] = position.x;
+			positionY[i] = position.y;
+			positionZ[i] = position.z;
+			velocityX[i] = velocity.x;
+			velocityY[i] = velocity.y;
+			velocityZ[i] = velocity.z;
+			gravityX[i] = gravity.x;
+			gravityY[i] = gravity.y;
+			gravityZ[i] = gravity.z;
+
+			time[i] = 0.0f;
+			lifespan[i] = duration;
+			inverseDuration[i] = (duration > k::EpsilonFloat)? 1.0f / duration : 0.0f;
+
+			const float startSize = _rng->GetRandomFloatRange(_startSize.x, _startSize.y) * sizeScale;
+			const float endSize = _rng->GetRandomFloatRange(_endSize.x, _endSize.y) * sizeScale;
+			const float startRotation = Math::DegreesToRadians(_rng->GetRandomFloatRange(_startRotation.x, _startRotation.y));
+			const float endRotation = Math::DegreesToRadians(_rng->GetRandomFloatRange(_endRotation.x, _endRotation.y));
+
+			sizeStart[i] = startSize;
+			sizeDelta[i] = endSize - startSize;
+			rotationStart[i] = startRotation;
+			rotationDelta[i] = endRotation - startRotation;
+
+			size[i] = startSize;
+			rotation[i] = startRotation;
+			colorR[i] = _startColor.r;
+			colorG[i] = _startColor.g;
+			colorB[i] = _startColor.b;
+			colorA[i] = _startColor.a;
+		}
+	}
+
+	void PooledParticleEmitter::UpdateParticles(float delta)
+	{
+		_pool->Update(delta, _startColor, _endColor);
+
+		if(_spawnRate < k::EpsilonFloat)
+			return;
+
+		uint32 spawn = floorf((_time + delta) / _spawnRate);
+		_time = fmodf((_time + delta), _spawnRate);
+
+		if(spawn > 0)
+			SpawnParticles(spawn);
+	}
+
+	void PooledParticleEmitter::UpdateMesh(const uint32 *order) const
+	{
+		const size_t count = _pool->GetCount();
+		const size_t previous = _meshParticles;
+
+		const size_t stride = _mesh->GetStride();
+		const size_t separatedSize = _mesh->GetVertexPositionsSeparatedSize();
+		const size_t positionStride = (separatedSize > 0)? _mesh->GetVertexPositionsSeparatedStride() : stride;
+
+		uint8 *vertices = static_cast<uint8 *>(_mesh->GetCPUVertexBuffer());
+		uint8 *positions = vertices + _mesh->GetAttribute(Mesh::VertexAttribute::Feature::Vertices)->GetOffset();
+		uint8 *colors = vertices + separatedSize + _mesh->GetAttribute(Mesh::VertexAttribute::Feature::Color0)->GetOffset();
+		uint8 *texcoords = vertices + separatedSize + _mesh->GetAttribute(Mesh::VertexAttribute::Feature::UVCoords0)->GetOffset();
+		uint8 *corners = vertices + separatedSize + _mesh->GetAttribute(Mesh::VertexAttribute::Feature::UVCoords1)->GetOffset();
+
+		const float *positionX = _pool->GetStream(ParticlePool::Stream::PositionX);
+		const float *positionY = _pool->GetStream(ParticlePool::Stream::PositionY);
+		const float *positionZ = _pool->GetStream(ParticlePool::Stream::PositionZ);
+		const float *size = _pool->GetStream(ParticlePool::Stream::Size);
+		const float *rotation = _pool->GetStream(ParticlePool::Stream::Rotation);
+		const float *colorR = _pool->GetStream(ParticlePool::Stream::ColorR);
+		const float *colorG = _pool->GetStream(ParticlePool::Stream::ColorG);
+		const float *colorB = _pool->GetStream(ParticlePool::Stream::ColorB);
+		const float *colorA = _pool->GetStream(ParticlePool::Stream::ColorA);
+
+		const bool inversed = _isRenderedInversed;
+		const bool rotated = (_startRotation != Vector2() || _endRotation != Vector2());
+
+		// Every chunk writes its own quads, the mesh iterators aren't used since their change tracking isn't thread safe
+		ParallelForChunks(Range(0, count), kRNPooledParticleEmitterGrain, [&](const Range &chunk) {
+			const size_t end = chunk.GetEnd();
+
+			for(size_t slot = chunk.origin; slot < end; slot++)
+			{
+				size_t particle = slot;
+				if(order)
+					particle = order[slot];
+				else if(inversed)
+					particle = count - 1 - slot;
+
+				const Vector3 position(positionX[particle], positionY[particle], positionZ[particle]);
+				const Color color(colorR[particle], colorG[particle], colorB[particle], colorA[particle]);
+
+				const float halfSize = size[particle] * 0.5f;
+				float cos = halfSize;
+				float sin = 0.0f;
+
+				if(rotated)
+				{
+					cos = Math::Cos(rotation[particle]) * halfSize;
+					sin = Math::Sin(rotation[particle]) * halfSize;
+				}
+
+				// The same corners the ParticleEmitter generates for either winding
+				Vector2 offsets[4];
+				if(!inversed)
+				{
+					const Vector2 top(cos - sin, sin + cos);
+					const Vector2 bottom(cos + sin, sin - cos);
+
+					offsets[0] = -top;
+					offsets[1] = bottom;
+					offsets[2] = -bottom;
+					offsets[3] = top;
+				}
+				else
+				{
+					offsets[0] = Vector2(sin - cos, -cos - sin);
+					offsets[1] = Vector2(cos - sin, -cos - sin);
+					offsets[2] = Vector2(sin - cos, cos + sin);
+					offsets[3] = Vector2(cos - sin, cos + sin);
+				}
+
+				for(size_t corner = 0; corner < 4; corner++)
+				{
+					const size_t vertex = slot * 4 + corner;
+
+					*reinterpret_cast<Vector3 *>(positions + vertex * positionStride) = position;
+					*reinterpret_cast<Color *>(colors + vertex * stride) = color;
+					*reinterpret_cast<Vector2 *>(texcoords + vertex * stride) = Vector2(static_cast<float>(corner & 1), static_cast<float>(corner >> 1));
+					*reinterpret_cast<Vector2 *>(corners + vertex * stride) = offsets[corner];
+				}
+			}
+		});
+
+		for(size_t vertex = count * 4; vertex < previous * 4; vertex++)
+			*reinterpret_cast<Vector2 *>(corners + vertex * stride) = Vector2();
+
+		const size_t written = std::max(count, previous) * 4;
+		_meshParticles = count;
+
+		if(written == 0)
+			return;
+
+		_mesh->BeginChanges();
+
+		if(separatedSize > 0)
+		{
+			_mesh->MarkVerticesChanged(Range(0, count * 4 * positionStride));
+			_mesh->MarkVerticesChanged(Range(separatedSize, written * stride));
+		}
+		else
+		{
+			_mesh->MarkVerticesChanged(Range(0, written * stride));
+		}
+
+		_mesh->EndChanges();
+	}
+
+	void PooledParticleEmitter::Update(float delta)
+	{
+		SceneNode::Update(delta);
+
+		UpdateParticles(delta);
+
+		if(!_isSorted)
+			UpdateMesh(nullptr);
+	}
+
+	bool PooledParticleEmitter::CanRender(Renderer *renderer, Camera *camera) const
+	{
+		return true;
+	}
+
+	bool PooledParticleEmitter::UsesFrustumCulling() const
+	{
+		return false;
+	}
+
+	void PooledParticleEmitter::Render(Renderer *renderer, Camera *camera) const
+	{
+		SceneNode::Render(renderer, camera);
+
+		if(!_material || _pool->GetCount() == 0)
+			return;
+
+		if(_isSorted)
+		{
+			const Matrix transform = GetWorldTransform();
+			const uint32 *order = _pool->SortByDepth(camera->GetWorldPosition(), camera->GetForward(), _isLocal? &transform : nullptr, _isRenderedInversed);
+
+			UpdateMesh(order);
+		}
+
+		_drawable->Update(_mesh, _material, nullptr, _isLocal?this:nullptr);
+		renderer->SubmitDrawable(_drawable);
+	}
+}
@@ -0,0 +1,131 @@
+//
+//  RNPooledParticleEmitter.h
+//  Rayne
+//
+//  Copyright 2014 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_POOLEDPARTICLEEMITTER_H__
+#define __RAYNE_POOLEDPARTICLEEMITTER_H__
+
+#include "../Base/RNBase.h"
+#include "RNSceneNode.h"
+#include "RNParticlePool.h"
+#include "../Rendering/RNRenderer.h"
+#include "../Rendering/RNMaterial.h"
+#include "../Rendering/RNMesh.h"
+#include "../Math/RNRandom.h"
+
+#define kRNPooledParticleEmitterGrain 1024 // Particles per work queue job when writing the vertices
+
+namespace RN
+{
+	// Emits the same particles as GenericParticleEmitter, but keeps them in a ParticlePool instead of allocating an object
+	// per particle. The particles are updated with SIMD, their vertices are written in parallel and sorted emitters radix
+	// sort the particles by view depth. Custom particle classes aren't supported, use ParticleEmitter for those.
+	class PooledParticleEmitter : public SceneNode
+	{
+	public:
+		RNAPI PooledParticleEmitter();
+		RNAPI PooledParticleEmitter(const PooledParticleEmitter *emitter);
+		RNAPI ~PooledParticleEmitter() override;
+
+		RNAPI void Cook(float time, int steps);
+		RNAPI void SetMaterial(Material *material);
+		Material *GetMaterial() const { return _material; }
+		RNAPI void SetGenerator(RandomNumberGenerator *generator);
+		RandomNumberGenerator *GetGenerator() const { return _rng; }
+
+		RNAPI void SetSpawnRate(float spawnRate);
+		RNAPI void SetParticlesPerSecond(size_t particles);
+		RNAPI void SetMaxParticles(uint32 maxParticles);
+
+		float GetSpawnRate() const { return _spawnRate; }
+		uint32 GetMaxParticles() const { return _maxParticles; }
+		size_t GetParticleCount() const { return _pool->GetCount(); }
+
+		bool GetIsLocal() const { return _isLocal; }
+		void SetIsLocal(bool local) { _isLocal = local; }
+
+		// Sorted emitters draw their particles back to front, or front to back if also rendered inversed
+		bool GetIsSorted() const { return _isSorted; }
+		void SetIsSorted(bool sorted) { _isSorted = sorted; }
+
+		bool GetIsRenderedInversed() const { return _isRenderedInversed; }
+		void SetIsRenderedInversed(bool renderedInversed) { _isRenderedInversed = renderedInversed; }
+
+		Vector2 GetLifeSpan() const { return _lifeSpan; }
+		void SetLifeSpan(const Vector2 &lifeSpan) { _lifeSpan = lifeSpan; }
+		Color GetStartColor() const { return _startColor; }
+		void SetStartColor(const Color &startColor) { _startColor = startColor; }
+		Color GetEndColor() const { return _endColor; }
+		void SetEndColor(const Color &endColor) { _endColor = endColor; }
+		Vector2 GetStartSize() const { return _startSize; }
+		void SetStartSize(const Vector2 &startSize) { _startSize = startSize; }
+		Vector2 GetEndSize() const { return _endSize; }
+		void SetEndSize(const Vector2 &endSize) { _endSize = endSize; }
+		Vector2 GetStartRotation() const { return _startRotation; }
+		void SetStartRotation(const Vector2 &startRotation) { _startRotation = startRotation; }
+		Vector2 GetEndRotation() const { return _endRotation; }
+		void SetEndRotation(const Vector2 &endRotation) { _endRotation = endRotation; }
+		Vector3 GetGravity() const { return _gravity; }
+		void SetGravity(const Vector3 &gravity) { _gravity = gravity; }
+		Vector3 GetVelocity() const { return _velocity; }
+		void SetVelocity(const Vector3 &velocity) { _velocity = velocity; }
+		Vector3 GetVelocityRandomizeMin() const { return _velocityRandomizeMin; }
+		void SetVelocityRandomizeMin(const Vector3 &velocityRandomizeMin) { _velocityRandomizeMin = velocityRandomizeMin; }
+		Vector3 GetVelocityRandomizeMax() const { return _velocityRandomizeMax; }
+		void SetVelocityRandomizeMax(const Vector3 &velocityRandomizeMax) { _velocityRandomizeMax = velocityRandomizeMax; }
+		Vector3 GetPositionRandomizeMin() const { return _positionRandomizeMin; }
+		void SetPositionRandomizeMin(const Vector3 &positionRandomizeMin) { _positionRandomizeMin = positionRandomizeMin; }
+		Vector3 GetPositionRandomizeMax() const { return _positionRandomizeMax; }
+		void SetPositionRandomizeMax(const Vector3 &positionRandomizeMax) { _positionRandomizeMax = positionRandomizeMax; }
+
+		RNAPI void SpawnParticles(size_t particles);
+
+		RNAPI void Update(float delta) override;
+		RNAPI bool CanRender(Renderer *renderer, Camera *camera) const override;
+		RNAPI bool UsesFrustumCulling() const override;
+		RNAPI void Render(Renderer *renderer, Camera *camera) const override;
+
+	private:
+		void Initialize();
+		void UpdateParticles(float delta);
+		void UpdateMesh(const uint32 *order) const;
+
+		ParticlePool *_pool;
+
+		Drawable *_drawable;
+		Material *_material;
+		Mesh *_mesh;
+		RandomNumberGenerator *_rng;
+
+		bool _isLocal;
+		bool _isSorted;
+		bool _isRenderedInversed;
+		uint32 _maxParticles;
+		float _spawnRate;
+
+		float _time;
+		mutable size_t _meshParticles; // Quads in the mesh that may still be visible
+
+		Vector2 _lifeSpan;
+		Color _startColor;
+		Color _endColor;
+		Vector2 _startSize;
+		Vector2 _endSize;
+		Vector2 _startRotation;
+		Vector2 _endRotation;
+		Vector3 _gravity;
+		Vector3 _velocity;
+		Vector3 _velocityRandomizeMin;
+		Vector3 _velocityRandomizeMax;
+		Vector3 _positionRandomizeMin;
+		Vector3 _positionRandomizeMax;
+
+		__RNDeclareMetaInternal(PooledParticleEmitter)
+	};
+}
+
+#endif /* __RAYNE_POOLEDPARTICLEEMITTER_H__ */
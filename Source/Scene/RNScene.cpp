@@ -7,13 +7,14 @@
 //
 
 #include "RNScene.h"
+#include "../Threads/RNWorkQueue.h"
 
 namespace RN
 {
 	RNDefineMeta(Scene, Object)
 	RNDefineMeta(SceneInfo, Object)
 
-	Scene::Scene() : _attachments(nullptr)
+	Scene::Scene() : _attachments(nullptr), _transformHierarchy(nullptr), _boundingVolumeHierarchy(nullptr)
 	{
 		
 	}
@@ -22,10 +23,28 @@ namespace RN
 	{
 		if(_attachments)
 			_attachments->Release();
+
+		delete _transformHierarchy;
+		delete _boundingVolumeHierarchy;
+	}
+
+	void Scene::EnableTransformHierarchy()
+	{
+		if(!_transformHierarchy)
+			_transformHierarchy = new TransformHierarchy();
+	}
+
+	void Scene::EnableBoundingVolumeHierarchy()
+	{
+		if(!_boundingVolumeHierarchy)
+			_boundingVolumeHierarchy = new BoundingVolumeHierarchy();
 	}
 
 	void Scene::Update(float delta)
 	{
+		if(_transformHierarchy)
+			_transformHierarchy->Update(WorkQueue::GetGlobalQueue(WorkQueue::Priority::Default));
+
 		//Update scene attachments
 		if(_attachments)
 		{
@@ -33,6 +52,10 @@ namespace RN
 				attachment->Update(delta);
 			});
 		}
+
+		//Last, so the tree includes everything that moved during the update
+		if(_boundingVolumeHierarchy)
+			_boundingVolumeHierarchy->Update();
 	}
 	
 	void Scene::UpdateNode(SceneNode *node, float delta)
@@ -33,6 +33,14 @@ namespace RN
 		RNAPI void AddAttachment(SceneAttachment *attachment);
 		RNAPI void RemoveAttachment(SceneAttachment *attachment);
 
+		// Opt-in, nodes added afterwards get their world transforms computed in one batch per frame
+		RNAPI void EnableTransformHierarchy();
+		TransformHierarchy *GetTransformHierarchy() const { return _transformHierarchy; }
+
+		// Opt-in, render nodes added afterwards are kept in a dynamic AABB tree for culling and spatial queries
+		RNAPI void EnableBoundingVolumeHierarchy();
+		BoundingVolumeHierarchy *GetBoundingVolumeHierarchy() const { return _boundingVolumeHierarchy; }
+
 	protected:
 		RNAPI Scene();
 
@@ -55,6 +63,8 @@ namespace RN
 		
 	private:
 		Array *_attachments;
+		TransformHierarchy *_transformHierarchy;
+		BoundingVolumeHierarchy *_boundingVolumeHierarchy;
 
 		__RNDeclareMetaInternal(Scene)
 	};
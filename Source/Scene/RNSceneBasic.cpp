@@ -10,39 +10,62 @@
 #include "../Debug/RNLogger.h"
 #include "../Threads/RNWorkQueue.h"
 #include "../Threads/RNWorkGroup.h"
+#include "../Threads/RNParallelFor.h"
 #include "../Objects/RNAutoreleasePool.h"
+#include "../Base/RNFrameAllocator.h"
 #include "../Scene/RNEntity.h"
 #include "../Rendering/RNModel.h"
 #include "../Rendering/RNMesh.h"
 #include "../Math/RNRandom.h"
+#include "../Math/RNAlgorithm.h"
 
 #define kRNSceneUpdateBatchSize 8192 //1024
 #define kRNSceneRenderBatchSize 32
+#define kRNSceneOcclusionBufferWidth 128
+#define kRNSceneOcclusionBufferHeight 72
+#define kRNSceneOccluderBudget 30
+#define kRNSceneCullingBatchSize 1024
+#define kRNSceneVisible 1
+#define kRNSceneVisibleOccluder 2
 
 namespace RN
 {
 	RNDefineMeta(SceneBasic, Scene)
 	RNDefineMeta(SceneBasicInfo, SceneInfo)
 
-	RN_INLINE float edgeFunction(const Vector2 a, const Vector2 b, const Vector2 c)
-	{
-		return (c.x - a.x) * (b.y - a.y) - (c.y - a.y) * (b.x - a.x);
-	}
-
-	SceneBasicInfo::SceneBasicInfo(Scene *scene) : SceneInfo(scene), occludedFrameCounter(0)
+	SceneBasicInfo::SceneBasicInfo(Scene *scene) : SceneInfo(scene), occludedFrameCounter(0), renderOrder(0)
 	{
 		
 	}
 
-	SceneBasic::SceneBasic() : _nodesToRemove(new Array()), _occlusionDepthBufferWidth(40), _occlusionDepthBufferHeight(40), _currentFrameCount(0)
+	SceneBasic::SceneBasic() : _occlusionBufferWidth(kRNSceneOcclusionBufferWidth), _occlusionBufferHeight(kRNSceneOcclusionBufferHeight), _occluderBudget(kRNSceneOccluderBudget), _nodesToRemove(new Array()), _renderOrder(0), _hasPopulatedBoundingVolumeHierarchy(false), _currentFrameCount(0)
 	{
-		_occlusionDepthBuffer = new float[_occlusionDepthBufferWidth * _occlusionDepthBufferHeight];
+		
 	}
 	
 	SceneBasic::~SceneBasic()
 	{
 		_nodesToRemove->Release();
-		delete _occlusionDepthBuffer;
+
+		for(CameraVisibility *visibility : _cameraVisibility)
+		{
+			delete visibility->occlusionBuffer;
+			delete visibility;
+		}
+	}
+
+	void SceneBasic::SetOcclusionBufferSize(uint32 width, uint32 height)
+	{
+		_occlusionBufferWidth = width;
+		_occlusionBufferHeight = height;
+
+		for(CameraVisibility *visibility : _cameraVisibility)
+			visibility->occlusionBuffer->Resize(width, height);
+	}
+
+	void SceneBasic::SetOccluderBudget(size_t budget)
+	{
+		_occluderBudget = budget;
 	}
 
 	void SceneBasic::Update(float delta)
@@ -53,62 +76,37 @@ namespace RN
 
 		for(size_t i = 0; i < 4; i ++)
 		{
-            WorkGroup *group = nullptr;
-			IntrusiveList<SceneNode>::Member *member = _updateNodes[i].GetHead();
-			IntrusiveList<SceneNode>::Member *first = member;
+			// Split the list into batches, the calling thread joins the work queue on them
+			_updateBatches.clear();
 
 			size_t count = 0;
+			IntrusiveList<SceneNode>::Member *member = _updateNodes[i].GetHead();
 
 			while(member)
 			{
-				if(count == kRNSceneUpdateBatchSize)
-				{
-				    if(!group) group = new WorkGroup();
-					group->Perform(queue, [&, member, first] {
-
-						AutoreleasePool pool;
-						auto iterator = first;
-
-						while(iterator != member)
-						{
-							SceneNode *node = iterator->Get();
-							UpdateNode(node, delta);
-							iterator = iterator->GetNext();
-						}
-
-					});
-
-					first = member;
-					count = 0;
-				}
+				if((count ++ % kRNSceneUpdateBatchSize) == 0)
+					_updateBatches.push_back(member);
 
 				member = member->GetNext();
-				count ++;
 			}
 
-			//Update remaining less than kRNSceneUpdateBatchSize number of nodes
-			if(first != member)
-			{
-//				group->Perform(queue, [&, member, first] {
+			const size_t batchCount = _updateBatches.size();
 
-					AutoreleasePool pool;
-					auto iterator = first;
+			ParallelFor(Range(0, batchCount), 1, [&](size_t index) {
 
-					while(iterator != member)
-					{
-						SceneNode *node = iterator->Get();
-						UpdateNode(node, delta);
-						iterator = iterator->GetNext();
-					}
+				AutoreleasePool pool;
 
-//				});
-			}
+				IntrusiveList<SceneNode>::Member *iterator = _updateBatches[index];
+				IntrusiveList<SceneNode>::Member *end = (index + 1 < batchCount) ? _updateBatches[index + 1] : nullptr;
 
-			if(group)
-            {
-			    group->Wait();
-                group->Release();
-            }
+				while(iterator != end)
+				{
+					SceneNode *node = iterator->Get();
+					UpdateNode(node, delta);
+					iterator = iterator->GetNext();
+				}
+
+			}, queue);
 		}
 
 		Scene::Update(delta);
@@ -149,264 +147,11 @@ namespace RN
 		_nodesToRemove->RemoveAllObjects();
 	}
 
-	void SceneBasic::RasterizeClipSpaceTriangle(Vector4 A, Vector4 B, Vector4 C)
-	{
-		A /= A.w;
-		A.x = A.x * 0.5f + 0.5f;
-		A.x *= _occlusionDepthBufferWidth;
-		A.y = A.y * 0.5f + 0.5f;
-		A.y *= _occlusionDepthBufferHeight;
-		
-		B /= B.w;
-		B.x = B.x * 0.5f + 0.5f;
-		B.x *= _occlusionDepthBufferWidth;
-		B.y = B.y * 0.5f + 0.5f;
-		B.y *= _occlusionDepthBufferHeight;
-		
-		C /= C.w;
-		C.x = C.x * 0.5f + 0.5f;
-		C.x *= _occlusionDepthBufferWidth;
-		C.y = C.y * 0.5f + 0.5f;
-		C.y *= _occlusionDepthBufferHeight;
-		
-		float area = edgeFunction(Vector2(A), Vector2(B), Vector2(C));
-		if(area < 0) return; //Triangle is facing away, can just skip completely at this point
-		
-		uint16 minX = std::min(std::max(std::min(A.x, std::min(B.x, C.x)), 0.0f), static_cast<float>(_occlusionDepthBufferWidth-1));
-		uint16 minY = std::min(std::max(std::min(A.y, std::min(B.y, C.y)), 0.0f), static_cast<float>(_occlusionDepthBufferHeight-1));
-		
-		uint16 maxX = std::min(std::max(std::max(A.x, std::max(B.x, C.x)), 0.0f), static_cast<float>(_occlusionDepthBufferWidth-1));
-		uint16 maxY = std::min(std::max(std::max(A.y, std::max(B.y, C.y)), 0.0f), static_cast<float>(_occlusionDepthBufferHeight-1));
-		
-		for(uint16 y = minY; y <= maxY; y++)
-		{
-			for(uint16 x = minX; x <= maxX; x++)
-			{
-				Vector2 point(x, y);
-				
-				float w0 = edgeFunction(Vector2(B), Vector2(C), point);
-				float w1 = edgeFunction(Vector2(C), Vector2(A), point);
-				float w2 = edgeFunction(Vector2(A), Vector2(B), point);
-				if(w0 >= 0 && w1 >= 0 && w2 >= 0)
-				{
-					w0 /= area;
-					w1 /= area;
-					w2 /= area;
-					float depth = w0 * A.z + w1 * B.z + w2 * C.z - 0.000001f; //Add a bit of an offset to prevent precision issues
-					
-					if(depth <= 1.0f)
-					{
-						//depth *= 10000.0f;
-						if(depth > _occlusionDepthBuffer[_occlusionDepthBufferWidth * (_occlusionDepthBufferHeight - y - 1) + x])
-						{
-							_occlusionDepthBuffer[_occlusionDepthBufferWidth * (_occlusionDepthBufferHeight - y - 1) + x] = depth;
-						}
-					}
-				}
-			}
-		}
-	}
-
-	void SceneBasic::RasterizeMesh(const Matrix &matModelViewProj, Mesh *mesh)
-	{
-		RN::Mesh::Chunk chunk = mesh->GetTrianglesChunk();
-		Mesh::ElementIterator<Vector3> iterator = chunk.GetIterator<Vector3>(Mesh::VertexAttribute::Feature::Vertices);
-		size_t triangleCount = mesh->GetIndicesCount() / 3;
-		for(size_t i = 0; i < triangleCount; i++)
-		{
-			const Vector3 &posA = *iterator++;
-			const Vector3 &posB = *iterator++;
-			const Vector3 &posC = *iterator;
-			if(i < triangleCount-1)
-			{
-				iterator++;
-			}
-			
-			Vector4 A = matModelViewProj * Vector4(posB, 1.0f);
-			Vector4 B = matModelViewProj * Vector4(posA, 1.0f);
-			Vector4 C = matModelViewProj * Vector4(posC, 1.0f);
-			
-			//Skip triangle if all vertices are on the same side of the near or far clip planes
-			if(A.z < -A.w && B.z < -B.w && C.z < -C.w) continue;
-			if(A.z > A.w && B.z > B.w && C.z > C.w) continue;
-			
-			//Handle clipping of triangles that intersect the near plane, otherwise dividing by w will cause all kind of issues
-			if(A.z > A.w && B.z > B.w)
-			{
-				//Both A and B are clipped, move them both onto the clipping plane towards C
-				float dA = (A.z - (A.w));
-				float dB = (B.z - (B.w));
-				float dC = (C.z - (C.w));
-				float tA = dA/(dA-dC);
-				float tB = dB/(dB-dC);
-				
-				A = A + (C-A) * tA;
-				B = B + (C-B) * tB;
-			}
-			else if(A.z > A.w && C.z > C.w)
-			{
-				//Both A and C are clipped, move them both onto the clipping plane towards B
-				float dA = (A.z - (A.w));
-				float dB = (B.z - (B.w));
-				float dC = (C.z - (C.w));
-				float tA = dA/(dA-dB);
-				float tC = dC/(dC-dB);
-				
-				A = A + (B-A) * tA;
-				C = C + (B-C) * tC;
-			}
-			else if(B.z > B.w && C.z > C.w)
-			{
-				//Both B and C are clipped, move them both onto the clipping plane towards A
-				float dA = (A.z - (A.w));
-				float dB = (B.z - (B.w));
-				float dC = (C.z - (C.w));
-				float tB = dB/(dB-dA);
-				float tC = dC/(dC-dA);
-				
-				B = B + (A-B) * tB;
-				C = C + (A-C) * tC;
-			}
-			else if(A.z > A.w)
-			{
-				//Only A is clipped, needs to create two new points on the clipplane to replace it with
-				float dA = (A.z - (A.w));
-				float dB = (B.z - (B.w));
-				float dC = (C.z - (C.w));
-				float tB = dA/(dA-dB);
-				float tC = dA/(dA-dC);
-				
-				Vector4 AB = A + (B-A) * tB;
-				Vector4 AC = A + (C-A) * tC;
-				A = AB;
-				
-				RasterizeClipSpaceTriangle(C, AC, AB);
-			}
-			else if(B.z > B.w)
-			{
-				//Only B is clipped, needs to create two new points on the clipplane to replace it with
-				float dA = (A.z - (A.w));
-				float dB = (B.z - (B.w));
-				float dC = (C.z - (C.w));
-				float tA = dB/(dB-dA);
-				float tC = dB/(dB-dC);
-				
-				Vector4 BA = B + (A-B) * tA;
-				Vector4 BC = B + (C-B) * tC;
-				B = BA;
-				
-				RasterizeClipSpaceTriangle(C, BA, BC);
-			}
-			else if(C.z > C.w)
-			{
-				//Only B is clipped, needs to create two new points on the clipplane to replace it with
-				float dA = (A.z - (A.w));
-				float dB = (B.z - (B.w));
-				float dC = (C.z - (C.w));
-				float tA = dC/(dC-dA);
-				float tB = dC/(dC-dB);
-				
-				Vector4 CA = C + (A-C) * tA;
-				Vector4 CB = C + (B-C) * tB;
-				C = CA;
-				
-				RasterizeClipSpaceTriangle(B, CB, CA);
-			}
-			
-			RasterizeClipSpaceTriangle(A, B, C);
-		}
-	}
-
-	bool SceneBasic::TestBoundingBox(const Matrix &matViewProj, const AABB &aabb, const Vector2 &screenPixelSize)
-	{
-		//Get bounding box corners
-		Vector4 boxCorners[8];
-
-		const Vector4 position(aabb.position, 1.0f);
-		boxCorners[0] = position + Vector4(aabb.maxExtend.x, aabb.maxExtend.y, aabb.maxExtend.z, 0.0f);
-		boxCorners[1] = position + Vector4(aabb.maxExtend.x, aabb.maxExtend.y, aabb.minExtend.z, 0.0f);
-		boxCorners[2] = position + Vector4(aabb.maxExtend.x, aabb.minExtend.y, aabb.minExtend.z, 0.0f);
-		boxCorners[3] = position + Vector4(aabb.maxExtend.x, aabb.minExtend.y, aabb.maxExtend.z, 0.0f);
-		boxCorners[4] = position + Vector4(aabb.minExtend.x, aabb.maxExtend.y, aabb.maxExtend.z, 0.0f);
-		boxCorners[5] = position + Vector4(aabb.minExtend.x, aabb.maxExtend.y, aabb.minExtend.z, 0.0f);
-		boxCorners[6] = position + Vector4(aabb.minExtend.x, aabb.minExtend.y, aabb.minExtend.z, 0.0f);
-		boxCorners[7] = position + Vector4(aabb.minExtend.x, aabb.minExtend.y, aabb.maxExtend.z, 0.0f);
-		
-		Vector3 maxCorners;
-		Vector3 minCorners;
-		
-		//Project corners to camera 2D plane
-		for(int i = 0; i < 8; i++)
-		{
-			boxCorners[i] = matViewProj * boxCorners[i];
-			
-			if(boxCorners[i].z > boxCorners[i].w)
-			{
-				//Bounding box intersects near clipping plane, assume as visible
-				return true;
-			}
-			
-			boxCorners[i] /= boxCorners[i].w;
-			boxCorners[i].x = boxCorners[i].x * 0.5f + 0.5f;
-			boxCorners[i].y = boxCorners[i].y * 0.5f + 0.5f;
-			
-			if(i == 0)
-			{
-				maxCorners = minCorners = Vector3(boxCorners[i]);
-			}
-			else
-			{
-				maxCorners.x = std::max(maxCorners.x, boxCorners[i].x);
-				maxCorners.y = std::max(maxCorners.y, boxCorners[i].y);
-				maxCorners.z = std::max(maxCorners.z, boxCorners[i].z);
-				
-				minCorners.x = std::min(minCorners.x, boxCorners[i].x);
-				minCorners.y = std::min(minCorners.y, boxCorners[i].y);
-				//minCorners.z = std::min(minCorners.z, boxCorners[i].z); //unused
-			}
-			
-			//depth is 1 closest to the camera and goes down to 0 the further away it is
-		}
-		
-		//Fail depth test for objects that are smaller than a single pixel
-		if((maxCorners.x - minCorners.x) < screenPixelSize.x && (maxCorners.y - minCorners.y) < screenPixelSize.y)
-		{
-			//TODO: Above should use "or" but somehow tends to cull things that aren't really that small...
-			//RNDebug("failed size test: " << (maxCorners.x - minCorners.x) << " < " << screenPixelSize.x << ", " << (maxCorners.y - minCorners.y) << " < " << screenPixelSize.y);
-			return false;
-		}
-		
-		minCorners.x *= _occlusionDepthBufferWidth;
-		minCorners.y *= _occlusionDepthBufferHeight;
-		
-		maxCorners.x *= _occlusionDepthBufferWidth;
-		maxCorners.y *= _occlusionDepthBufferHeight;
-		
-		uint16 minX = std::max(std::min(std::floor(minCorners.x) - 1.0f, static_cast<float>(_occlusionDepthBufferWidth - 1)), 0.0f);
-		uint16 maxX = std::max(std::min(std::ceil(maxCorners.x) + 1.0f, static_cast<float>(_occlusionDepthBufferWidth - 1)), 0.0f);
-		
-		uint16 minY = std::max(std::min(std::floor(minCorners.y) - 1.0f, static_cast<float>(_occlusionDepthBufferHeight - 1)), 0.0f);
-		uint16 maxY = std::max(std::min(std::ceil(maxCorners.y) + 1.0f, static_cast<float>(_occlusionDepthBufferHeight - 1)), 0.0f);
-
-		//maxCorners.z *= 10000.0f;
-
-		for(uint16 y = minY; y <= maxY; y++)
-		{
-			for(uint16 x = minX; x <= maxX; x++)
-			{
-				if(maxCorners.z > _occlusionDepthBuffer[_occlusionDepthBufferWidth * (_occlusionDepthBufferHeight - y - 1) + x])
-				{
-					return true;
-				}
-			}
-		}
-		
-		return false;
-	}
-
 	void SceneBasic::Render(Renderer *renderer)
 	{
 		WillRender(renderer);
+
+		WorkQueue *queue = WorkQueue::GetGlobalQueue(WorkQueue::Priority::Default);
 		
 		//Run camera PostUpdate once for each camera
 		IntrusiveList<Camera>::Member *cameraMember = _cameras.GetHead();
@@ -417,6 +162,10 @@ namespace RN
 			cameraMember = cameraMember->GetNext();
 		}
 
+		//Collect the cameras in the order they are rendered in
+		FrameVector<Camera *> cameras;
+		cameras.reserve(_cameras.GetCount());
+
 		for(int cameraPriority = 0; cameraPriority < 3; cameraPriority++)
 		{
 			cameraMember = _cameras.GetHead();
@@ -438,193 +187,389 @@ namespace RN
 					continue;
 				}
 
-				std::vector<SceneNode *> occluders;
-				std::vector<SceneNode *> sceneNodesToRender;
-				
-				//Collect all occluders
+				cameras.push_back(camera);
+				cameraMember = cameraMember->GetNext();
+			}
+		}
+
+		//Everything that is lazily computed on the nodes is brought up to date here, the culling below only reads it
+		BoundingVolumeHierarchy *boundingVolumeHierarchy = GetBoundingVolumeHierarchy();
+		if(boundingVolumeHierarchy)
+		{
+			//Render nodes added before the hierarchy was enabled aren't part of it yet
+			if(!_hasPopulatedBoundingVolumeHierarchy)
+			{
 				IntrusiveList<SceneNode>::Member *nodeMember = _renderNodes.GetHead();
 				while(nodeMember)
 				{
 					SceneNode *node = nodeMember->Get();
-					if(node->HasFlags(SceneNode::Flags::Occluder) && node->CanRender(renderer, camera))
-					{
-						occluders.push_back(node);
-					}
+					if(!boundingVolumeHierarchy->ContainsNode(node))
+						boundingVolumeHierarchy->AddNode(node);
 
 					nodeMember = nodeMember->GetNext();
 				}
+
+				_hasPopulatedBoundingVolumeHierarchy = true;
+			}
+
+			//Picks up nodes that moved after the scene update
+			boundingVolumeHierarchy->Update();
+		}
+		else
+		{
+			GatherCullingData();
+		}
+
+		const size_t cameraCount = cameras.size();
+		while(_cameraVisibility.size() < cameraCount)
+		{
+			CameraVisibility *visibility = new CameraVisibility();
+			visibility->occlusionBuffer = new OcclusionBuffer(_occlusionBufferWidth, _occlusionBufferHeight);
+			_cameraVisibility.push_back(visibility);
+		}
+
+		for(size_t i = 0; i < cameraCount; i ++)
+		{
+			Camera *camera = cameras[i];
+			CameraVisibility *visibility = _cameraVisibility[i];
+
+			//Also updates the frustum, so the tests are read only
+			visibility->frustumPlaneCount = camera->GetFrustumPlanes(visibility->frustumPlanes);
+			visibility->frustumSphere = Sphere(camera->GetFrustumCenter(), camera->GetFrustumRadius());
+
+			visibility->camera = camera;
+			visibility->cameraPosition = camera->GetWorldPosition();
+			visibility->screenPixelSize = Vector2(1.0f/camera->GetRenderPass()->GetFrame().width, 1.0f/camera->GetRenderPass()->GetFrame().height);
+
+			Vector3 randomCameraOffset = RandomNumberGenerator::GetSharedGenerator()->GetRandomVector3Range(RN::Vector3(-0.15f, -0.15f, 0.0f), RN::Vector3(0.15f, 0.15f, 0.0f));
+			visibility->occlusionViewProjection = camera->GetProjectionMatrix() * Matrix::WithTranslation(randomCameraOffset) * camera->GetViewMatrix();
+			if(camera->GetIsMultiviewCamera())
+			{
+				size_t multiviewIndex = _currentFrameCount % camera->GetMultiviewCameras()->GetCount();
+				RN::Camera *multiviewCamera = camera->GetMultiviewCameras()->GetObjectAtIndex<RN::Camera>(multiviewIndex);
+				visibility->occlusionViewProjection = multiviewCamera->GetProjectionMatrix() * multiviewCamera->GetViewMatrix();
+			}
+		}
+
+		//Cull all cameras in parallel, each one splits its nodes into batches again
+		ParallelFor(Range(0, cameraCount), 1, [&](size_t index) {
+			CullCamera(renderer, _cameraVisibility[index], queue);
+		}, queue);
+
+		//Submission has to happen in camera order
+		for(size_t i = 0; i < cameraCount; i ++)
+		{
+			Camera *camera = cameras[i];
+			const std::vector<SceneNode *> &sceneNodesToRender = _cameraVisibility[i]->nodes;
+
+			//RNInfo("Number of objects: " << sceneNodesToRender.size());
+
+			renderer->SubmitCamera(camera, [&] {
+				
+				//TODO: Add back some multithreading while not breaking the priorities.
 				
-				//Do occlusion culling if there are 1 or more occluders!
-				nodeMember = _renderNodes.GetHead();
-				if(occluders.size() > 0)
+				//Submit lights first
+				IntrusiveList<Light>::Member *lightMember = _lights.GetHead();
+				while(lightMember)
 				{
-					std::vector<SceneNode *> visibleOccluders;
-					
-					//Sort occluders by approximated size on the screen
-					const RN::Vector3 cameraWorldPosition = camera->GetWorldPosition();
-					std::sort(occluders.begin(), occluders.end(), [cameraWorldPosition](
-							SceneNode *a, SceneNode *b) {
-						float distanceA = std::max(a->GetWorldPosition().GetDistance(cameraWorldPosition), 1.0f);
-						float distanceB = std::max(b->GetWorldPosition().GetDistance(cameraWorldPosition), 1.0f);
-						
-						return a->GetBoundingSphere().radius / distanceA > b->GetBoundingSphere().radius / distanceB;
-					});
-					
-					occluders.resize(std::min(static_cast<size_t>(30), occluders.size())); //Only keep the biggest 30 occluders in the list
-					
-					//Sort remaining occluders front to back
-					std::sort(occluders.begin(), occluders.end(), [cameraWorldPosition](
-							SceneNode *a, SceneNode *b) {
-						return a->GetWorldPosition().GetSquaredDistance(cameraWorldPosition) < b->GetWorldPosition().GetSquaredDistance(cameraWorldPosition);
-					});
-					
-					//Clear occlusion depth map
-					std::fill(_occlusionDepthBuffer, _occlusionDepthBuffer + _occlusionDepthBufferWidth * _occlusionDepthBufferHeight, 0.0f);
-					
-					Vector2 screenPixelSize = Vector2(1.0f/camera->GetRenderPass()->GetFrame().width, 1.0f/camera->GetRenderPass()->GetFrame().height);
-					
-					Vector3 randomCameraOffset = RandomNumberGenerator::GetSharedGenerator()->GetRandomVector3Range(RN::Vector3(-0.15f, -0.15f, 0.0f), RN::Vector3(0.15f, 0.15f, 0.0f));
-					Matrix matViewProj = camera->GetProjectionMatrix() * Matrix::WithTranslation(randomCameraOffset) * camera->GetViewMatrix();
-					if(camera->GetIsMultiviewCamera())
-					{
-						size_t multiviewIndex = _currentFrameCount % camera->GetMultiviewCameras()->GetCount();
-						RN::Camera *multiviewCamera = camera->GetMultiviewCameras()->GetObjectAtIndex<RN::Camera>(multiviewIndex);
-						matViewProj = multiviewCamera->GetProjectionMatrix() * multiviewCamera->GetViewMatrix();
-					}
+					Light *light = lightMember->Get();
+					if(light->CanRender(renderer, camera))
+						light->Render(renderer, camera);
 					
-					//Render occluders to depth buffer first (first test if the bounding box is visible at all)
-					for(SceneNode *node : occluders)
-					{
-						bool testResult = TestBoundingBox(matViewProj, node->GetBoundingBox(), screenPixelSize);
-						SceneBasicInfo *sceneInfo = static_cast<SceneBasicInfo*>(node->GetSceneInfo());
-						if(!testResult && sceneInfo->occludedFrameCounter < 1000)
-						{
-							sceneInfo->occludedFrameCounter += 1;
-						}
-						if(testResult || sceneInfo->occludedFrameCounter < 50)
-						{
-							if(testResult)
-							{
-								sceneInfo->occludedFrameCounter = 0;
-							}
-							
-							visibleOccluders.push_back(node);
-						}
-						
-						if(testResult)
-						{
-							//TODO: Deal with models that have multiple meshes, also what lod stage should be used if there are multiple?
-							RN::Entity *entity = node->Downcast<Entity>();
-							if(entity)
-							{
-								Model *model = entity->GetModel();
-								RN::Mesh *mesh = model->GetLODStage(0)->GetMeshAtIndex(0);
-								Matrix matModelViewProj = matViewProj * node->GetWorldTransform();
-								RasterizeMesh(matModelViewProj, mesh);
-							}
-						}
-					}
-					
-					//Test all visible objects against depth buffer
-					while(nodeMember)
-					{
-						SceneNode *node = nodeMember->Get();
-						nodeMember = nodeMember->GetNext();
-						if(!node->CanRender(renderer, camera)) continue;
-						if(node->GetRenderPriority() >= SceneNode::RenderSky)
-						{
-							sceneNodesToRender.push_back(node);
-							continue;
-						}
-						
-						//TODO: Find a better way to check if an occluder is visible and should be added to the render queue
-						if(node->GetFlags() & SceneNode::Flags::Occluder && std::find(visibleOccluders.begin(), visibleOccluders.end(), node) != visibleOccluders.end())
-						{
-							sceneNodesToRender.push_back(node);
-							continue;
-						}
-						
-						bool testResult = TestBoundingBox(matViewProj, node->GetBoundingBox(), screenPixelSize);
-						SceneBasicInfo *sceneInfo = static_cast<SceneBasicInfo*>(node->GetSceneInfo());
-						if(!testResult && sceneInfo->occludedFrameCounter < 1000)
-						{
-							sceneInfo->occludedFrameCounter += 1;
-						}
-						if(testResult || sceneInfo->occludedFrameCounter < 50)
-						{
-							if(testResult)
-							{
-								sceneInfo->occludedFrameCounter = 0;
-							}
-							
-							sceneNodesToRender.push_back(node);
-						}
-					}
+					lightMember = lightMember->GetNext();
 				}
-				else
+				
+				//Submit all drawables for rendering
+				for(SceneNode *node : sceneNodesToRender)
 				{
-					while(nodeMember)
-					{
-						SceneNode *node = nodeMember->Get();
-						if(node->CanRender(renderer, camera))
-						{
-							sceneNodesToRender.push_back(node);
-						}
-
-						nodeMember = nodeMember->GetNext();
-					}
+					node->Render(renderer, camera);
 				}
+			});
+		}
+		
+		_currentFrameCount += 1;
+		_currentFrameCount %= 10000;
 
-				if(camera->GetFlags() & Camera::Flags::SortFrontToBack)
+		DidRender(renderer);
+	}
+
+	void SceneBasic::GatherCullingData()
+	{
+		_cullingNodes.clear();
+		_cullingPositionX.clear();
+		_cullingPositionY.clear();
+		_cullingPositionZ.clear();
+		_cullingRadius.clear();
+
+		IntrusiveList<SceneNode>::Member *nodeMember = _renderNodes.GetHead();
+		while(nodeMember)
+		{
+			SceneNode *node = nodeMember->Get();
+			nodeMember = nodeMember->GetNext();
+
+			const Sphere sphere = node->GetBoundingSphere();
+			const Vector3 position = sphere.position + sphere.offset;
+
+			//Occluders also need their transform for the occlusion buffer
+			if(node->HasFlags(SceneNode::Flags::Occluder))
+				node->GetWorldTransform();
+
+			_cullingNodes.push_back(node);
+			_cullingPositionX.push_back(position.x);
+			_cullingPositionY.push_back(position.y);
+			_cullingPositionZ.push_back(position.z);
+			_cullingRadius.push_back(node->UsesFrustumCulling() ? sphere.radius : std::numeric_limits<float>::infinity());
+		}
+	}
+
+	void SceneBasic::CullCamera(Renderer *renderer, CameraVisibility *visibility, WorkQueue *queue)
+	{
+		visibility->nodes.clear();
+		visibility->occluders.clear();
+
+		if(GetBoundingVolumeHierarchy())
+			CollectHierarchyNodes(renderer, visibility, queue);
+		else
+			CollectNodes(renderer, visibility, queue);
+
+		//Do occlusion culling if there are 1 or more occluders!
+		if(visibility->occluders.size() > 0)
+			OcclusionCullCamera(visibility, queue);
+
+		if(visibility->camera->GetFlags() & Camera::Flags::SortFrontToBack)
+			SortCameraNodes(visibility);
+	}
+
+	void SceneBasic::CollectNodes(Renderer *renderer, CameraVisibility *visibility, WorkQueue *queue)
+	{
+		Camera *camera = visibility->camera;
+		const size_t count = _cullingNodes.size();
+
+		visibility->results.resize(count);
+		uint8 *results = visibility->results.data();
+
+		//Frustum test all spheres in one go first, CanRender() only runs for the nodes that pass it
+		ParallelForChunks(Range(0, count), kRNSceneCullingBatchSize, [&](const Range &range) {
+
+			camera->InFrustum(&_cullingPositionX[range.origin], &_cullingPositionY[range.origin], &_cullingPositionZ[range.origin], &_cullingRadius[range.origin], range.length, results + range.origin);
+
+			const size_t end = range.GetEnd();
+			for(size_t i = range.origin; i < end; i ++)
+			{
+				if(!results[i])
+					continue;
+
+				SceneNode *node = _cullingNodes[i];
+				if(!node->CanRender(renderer, camera))
 				{
-					const RN::Vector3 cameraWorldPosition = camera->GetWorldPosition();
-					std::sort(sceneNodesToRender.begin(), sceneNodesToRender.end(), [cameraWorldPosition](
-							SceneNode *a, SceneNode *b) {
-						if(a->GetRenderPriority() == b->GetRenderPriority() && b->GetRenderPriority() < SceneNode::RenderSky)
-						{
-							return a->GetWorldPosition().GetSquaredDistance(cameraWorldPosition) < b->GetWorldPosition().GetSquaredDistance(cameraWorldPosition);
-						}
-						return a->GetRenderPriority() < b->GetRenderPriority();
-					});
+					results[i] = 0;
+					continue;
 				}
 
-				//RNInfo("Number of objects: " << sceneNodesToRender.size());
+				if(node->HasFlags(SceneNode::Flags::Occluder))
+					results[i] = kRNSceneVisibleOccluder;
+			}
 
-				renderer->SubmitCamera(camera, [&] {
-					
-					//TODO: Add back some multithreading while not breaking the priorities.
-					
-					//Submit lights first
-					IntrusiveList<Light>::Member *lightMember = _lights.GetHead();
-					while(lightMember)
-					{
-						Light *light = lightMember->Get();
-						if(light->CanRender(renderer, camera))
-							light->Render(renderer, camera);
-						
-						lightMember = lightMember->GetNext();
-					}
-					
-					//Submit all drawables for rendering
-					for(SceneNode *node : sceneNodesToRender)
-					{
-						node->Render(renderer, camera);
-					}
-				});
+		}, queue);
 
-				cameraMember = cameraMember->GetNext();
+		for(size_t i = 0; i < count; i ++)
+		{
+			if(!results[i])
+				continue;
+
+			visibility->nodes.push_back(_cullingNodes[i]);
+
+			if(results[i] == kRNSceneVisibleOccluder)
+				visibility->occluders.push_back(_cullingNodes[i]);
+		}
+	}
+
+	void SceneBasic::CollectHierarchyNodes(Renderer *renderer, CameraVisibility *visibility, WorkQueue *queue)
+	{
+		Camera *camera = visibility->camera;
+		std::vector<SceneNode *> &candidates = visibility->candidates;
+
+		//Only walks the parts of the tree that intersect the frustum, CanRender() still does the exact test
+		candidates.clear();
+
+		auto collect = [&](SceneNode *node) {
+			candidates.push_back(node);
+		};
+
+		if(visibility->frustumPlaneCount > 0)
+			GetBoundingVolumeHierarchy()->QueryFrustum(visibility->frustumPlanes, visibility->frustumPlaneCount, collect);
+		else
+			GetBoundingVolumeHierarchy()->QuerySphere(visibility->frustumSphere, collect);
+
+		const size_t count = candidates.size();
+
+		visibility->results.resize(count);
+		uint8 *results = visibility->results.data();
+
+		ParallelForChunks(Range(0, count), kRNSceneCullingBatchSize, [&](const Range &range) {
+
+			const size_t end = range.GetEnd();
+			for(size_t i = range.origin; i < end; i ++)
+			{
+				SceneNode *node = candidates[i];
+
+				if(!node->CanRender(renderer, camera))
+					results[i] = 0;
+				else
+					results[i] = node->HasFlags(SceneNode::Flags::Occluder) ? kRNSceneVisibleOccluder : kRNSceneVisible;
 			}
+
+		}, queue);
+
+		//The tree returns nodes in no particular order, restore the order of the render node list
+		visibility->sortKeys.clear();
+
+		for(size_t i = 0; i < count; i ++)
+		{
+			if(!results[i])
+				continue;
+
+			SceneNode *node = candidates[i];
+			const uint32 renderOrder = static_cast<SceneBasicInfo *>(node->GetSceneInfo())->renderOrder;
+
+			visibility->nodes.push_back(node);
+			visibility->sortKeys.push_back((static_cast<uint64>(static_cast<uint32>(node->GetRenderPriority()) ^ 0x80000000u) << 32) | renderOrder);
+
+			if(results[i] == kRNSceneVisibleOccluder)
+				visibility->occluders.push_back(node);
 		}
+
+		const size_t visibleCount = visibility->nodes.size();
+		visibility->scratchKeys.resize(visibleCount);
+		visibility->scratchNodes.resize(visibleCount);
+
+		RadixSort(visibility->sortKeys.data(), visibility->nodes.data(), visibleCount, visibility->scratchKeys.data(), visibility->scratchNodes.data());
+	}
+
+	void SceneBasic::OcclusionCullCamera(CameraVisibility *visibility, WorkQueue *queue)
+	{
+		std::vector<SceneNode *> &occluders = visibility->occluders;
+		OcclusionBuffer *occlusionBuffer = visibility->occlusionBuffer;
+
+		//Sort occluders by approximated size on the screen
+		const RN::Vector3 cameraWorldPosition = visibility->cameraPosition;
+		std::sort(occluders.begin(), occluders.end(), [cameraWorldPosition](
+				SceneNode *a, SceneNode *b) {
+			float distanceA = std::max(a->GetWorldPosition().GetDistance(cameraWorldPosition), 1.0f);
+			float distanceB = std::max(b->GetWorldPosition().GetDistance(cameraWorldPosition), 1.0f);
+			
+			return a->GetBoundingSphere().radius / distanceA > b->GetBoundingSphere().radius / distanceB;
+		});
 		
-		_currentFrameCount += 1;
-		_currentFrameCount %= 10000;
+		occluders.resize(std::min(_occluderBudget, occluders.size())); //Only keep the biggest occluders in the list
+		
+		//Sort remaining occluders front to back
+		std::sort(occluders.begin(), occluders.end(), [cameraWorldPosition](
+				SceneNode *a, SceneNode *b) {
+			return a->GetWorldPosition().GetSquaredDistance(cameraWorldPosition) < b->GetWorldPosition().GetSquaredDistance(cameraWorldPosition);
+		});
+		
+		//Clear occlusion depth map
+		occlusionBuffer->Clear();
+		
+		const Matrix &matViewProj = visibility->occlusionViewProjection;
+		
+		//Render all occluders to the depth buffer in one go, occluders hidden behind others just don't change it
+		for(SceneNode *node : occluders)
+		{
+			//TODO: Deal with models that have multiple meshes, also what lod stage should be used if there are multiple?
+			RN::Entity *entity = node->Downcast<Entity>();
+			if(entity && entity->GetModel())
+			{
+				Model *model = entity->GetModel();
+				RN::Mesh *mesh = model->GetLODStage(0)->GetMeshAtIndex(0);
+				Matrix matModelViewProj = matViewProj * node->GetWorldTransform();
+				occlusionBuffer->AddOccluder(matModelViewProj, mesh);
+			}
+		}
+		
+		occlusionBuffer->Rasterize(queue);
+		
+		//Test everything in front of the sky against the depth buffer, occluders included. The depth buffer is read only from here on
+		std::vector<SceneNode *> &nodes = visibility->nodes;
+		std::vector<uint8> &results = visibility->results;
+		results.resize(nodes.size());
+		
+		ParallelFor(Range(0, nodes.size()), 0, [&](size_t index) {
+			
+			SceneNode *node = nodes[index];
+			if(node->GetRenderPriority() >= SceneNode::RenderSky)
+			{
+				results[index] = kRNSceneVisible;
+				return;
+			}
+			
+			bool testResult = occlusionBuffer->TestBoundingBox(matViewProj, node->GetBoundingBox(), visibility->screenPixelSize);
+			SceneBasicInfo *sceneInfo = static_cast<SceneBasicInfo*>(node->GetSceneInfo());
+			
+			//Nodes can be visible to multiple cameras, so the counter may be touched by several of them at once
+			size_t occludedFrames = 0;
+			if(testResult)
+			{
+				sceneInfo->occludedFrameCounter.store(0, std::memory_order_relaxed);
+			}
+			else
+			{
+				occludedFrames = sceneInfo->occludedFrameCounter.load(std::memory_order_relaxed);
+				if(occludedFrames < 1000)
+					sceneInfo->occludedFrameCounter.store(++ occludedFrames, std::memory_order_relaxed);
+			}
+			
+			results[index] = (testResult || occludedFrames < 50);
+			
+		}, queue);
+		
+		size_t visibleCount = 0;
+		for(size_t i = 0; i < nodes.size(); i ++)
+		{
+			if(results[i])
+				nodes[visibleCount ++] = nodes[i];
+		}
+		
+		nodes.resize(visibleCount);
+	}
 
-		DidRender(renderer);
+	void SceneBasic::SortCameraNodes(CameraVisibility *visibility)
+	{
+		//Render priority in the high bits, the squared distance to the camera in the low ones. Positive floats sort like their bit pattern
+		std::vector<SceneNode *> &nodes = visibility->nodes;
+		const size_t count = nodes.size();
+		
+		visibility->sortKeys.resize(count);
+		visibility->scratchKeys.resize(count);
+		visibility->scratchNodes.resize(count);
+		
+		for(size_t i = 0; i < count; i ++)
+		{
+			SceneNode *node = nodes[i];
+			const int32 renderPriority = node->GetRenderPriority();
+			
+			uint32 distanceBits = 0;
+			if(renderPriority < SceneNode::RenderSky)
+			{
+				const float distance = node->GetWorldPosition().GetSquaredDistance(visibility->cameraPosition);
+				memcpy(&distanceBits, &distance, sizeof(float));
+			}
+			
+			visibility->sortKeys[i] = (static_cast<uint64>(static_cast<uint32>(renderPriority) ^ 0x80000000u) << 32) | distanceBits;
+		}
+		
+		RadixSort(visibility->sortKeys.data(), nodes.data(), count, visibility->scratchKeys.data(), visibility->scratchNodes.data());
 	}
 
 	void SceneBasic::AddRenderNode(SceneNode *node)
 	{
 		Lock();
+		static_cast<SceneBasicInfo *>(node->GetSceneInfo())->renderOrder = _renderOrder ++;
+
+		if(GetBoundingVolumeHierarchy())
+			GetBoundingVolumeHierarchy()->AddNode(node);
+
 		int32 renderPriority = node->GetRenderPriority();
 		if(!_renderNodes.GetHead() || _renderNodes.GetHead()->Get()->GetRenderPriority() >= renderPriority)
 		{
@@ -651,6 +596,9 @@ namespace RN
 	void SceneBasic::RemoveRenderNode(SceneNode *node)
 	{
 		_renderNodes.Erase(node->_sceneRenderEntry);
+
+		if(GetBoundingVolumeHierarchy() && GetBoundingVolumeHierarchy()->ContainsNode(node))
+			GetBoundingVolumeHierarchy()->RemoveNode(node);
 	}
 
 	void SceneBasic::AddNode(SceneNode *node)
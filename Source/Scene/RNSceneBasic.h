@@ -10,6 +10,7 @@
 #define __RAYNE_SCENEBASIC_H__
 
 #include "RNScene.h"
+#include "RNOcclusionBuffer.h"
 
 namespace RN
 {
@@ -21,6 +22,11 @@ namespace RN
 		RNAPI void AddNode(SceneNode *node) override;
 		RNAPI void RemoveNode(SceneNode *node) override;
 
+		RNAPI void SetOcclusionBufferSize(uint32 width, uint32 height);
+		RNAPI void SetOccluderBudget(size_t budget);
+
+		size_t GetOccluderBudget() const { return _occluderBudget; }
+
 	protected:
 		RNAPI SceneBasic();
 
@@ -35,22 +41,57 @@ namespace RN
 		
 		RNAPI void MakeDrawablesDirty();
 
-		//Should probably be private, but this makes it easy to visualize
-		RN::uint16 _occlusionDepthBufferWidth;
-		RN::uint16 _occlusionDepthBufferHeight;
-		float *_occlusionDepthBuffer;
+		//Culling state for each rendered camera, the occlusion buffer is public to make it easy to visualize
+		struct CameraVisibility
+		{
+			Camera *camera;
+			Vector3 cameraPosition;
+			Matrix occlusionViewProjection;
+			Plane frustumPlanes[6];
+			size_t frustumPlaneCount;
+			Sphere frustumSphere;
+			Vector2 screenPixelSize;
+			OcclusionBuffer *occlusionBuffer;
+
+			std::vector<SceneNode *> candidates;
+			std::vector<uint8> results;
+			std::vector<SceneNode *> occluders;
+			std::vector<SceneNode *> nodes;
+			std::vector<uint64> sortKeys;
+			std::vector<uint64> scratchKeys;
+			std::vector<SceneNode *> scratchNodes;
+		};
+
+		std::vector<CameraVisibility *> _cameraVisibility;
+		uint32 _occlusionBufferWidth;
+		uint32 _occlusionBufferHeight;
+		size_t _occluderBudget;
 
 	private:
-		void RasterizeClipSpaceTriangle(Vector4 A, Vector4 B, Vector4 C);
-		void RasterizeMesh(const Matrix &matModelViewProj, Mesh *mesh);
-		bool TestBoundingBox(const Matrix &matViewProj, const AABB &aabb, const Vector2 &screenPixelSize);
-		
+		void GatherCullingData();
+		void CullCamera(Renderer *renderer, CameraVisibility *visibility, WorkQueue *queue);
+		void CollectNodes(Renderer *renderer, CameraVisibility *visibility, WorkQueue *queue);
+		void CollectHierarchyNodes(Renderer *renderer, CameraVisibility *visibility, WorkQueue *queue);
+		void OcclusionCullCamera(CameraVisibility *visibility, WorkQueue *queue);
+		void SortCameraNodes(CameraVisibility *visibility);
+
 		IntrusiveList<SceneNode> _updateNodes[4];
+		std::vector<IntrusiveList<SceneNode>::Member *> _updateBatches;
 		IntrusiveList<SceneNode> _renderNodes;
 		IntrusiveList<Light> _lights;
 		IntrusiveList<Camera> _cameras;
 		Array *_nodesToRemove;
         Array *_nodesToAdd;
+
+		//Bounding spheres of all render nodes, packed once per frame for all cameras
+		std::vector<SceneNode *> _cullingNodes;
+		std::vector<float> _cullingPositionX;
+		std::vector<float> _cullingPositionY;
+		std::vector<float> _cullingPositionZ;
+		std::vector<float> _cullingRadius;
+
+		uint32 _renderOrder;
+		bool _hasPopulatedBoundingVolumeHierarchy;
 		
 		size_t _currentFrameCount;
 
@@ -62,7 +103,8 @@ namespace RN
 	public:
 		SceneBasicInfo(Scene *scene);
 		
-		size_t occludedFrameCounter;
+		std::atomic<size_t> occludedFrameCounter;
+		uint32 renderOrder; //Position in the render node list among nodes with the same priority
 		
 		__RNDeclareMetaInternal(SceneBasicInfo)
 	};
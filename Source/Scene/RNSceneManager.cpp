@@ -7,6 +7,7 @@
 //
 
 #include "RNSceneManager.h"
+#include "../Debug/RNProfiler.h"
 
 namespace RN
 {
@@ -44,13 +45,19 @@ namespace RN
 
 	void SceneManager::Update(float delta)
 	{
+		RN_PROFILE_ZONE("SceneManager::Update");
+
 		_scenes->Enumerate<Scene>([&](Scene *scene, size_t index, bool &stop) {
+			RN_PROFILE_ZONE("Scene update");
 			scene->Update(delta);
 		});
 	}
 	void SceneManager::Render(Renderer *renderer)
 	{
+		RN_PROFILE_ZONE("SceneManager::Render");
+
 		_scenes->Enumerate<Scene>([&](Scene *scene, size_t index, bool &stop) {
+			RN_PROFILE_ZONE("Scene render");
 			scene->Render(renderer);
 		});
 	}
@@ -115,7 +115,7 @@ namespace RN
 			SceneNode *child = static_cast<SceneNode *>(deserializer->DecodeObject());
 
 			if(child)
-				AddChild(child->Autorelease());
+				AddChild(child); // Decoded objects are autoreleased already
 		}
 	}
 
@@ -161,6 +161,13 @@ namespace RN
 		_updatedBounds = true;
 		_flags = 0;
 
+		_transformHierarchy = nullptr;
+		_transformIndex = kRNNotFound;
+
+		_boundingVolumeHierarchy = nullptr;
+		_boundingVolumeProxy = -1;
+		_boundingVolumeMoved = false;
+
 		_updatePriority = UpdatePriority::UpdateNormal;
 		_renderPriority = RenderPriority::RenderNormal;
 		_renderGroup = 1;
@@ -247,14 +254,18 @@ namespace RN
 	SceneNode::Flags SceneNode::RemoveFlags(Flags flags)
 	{
 		WillUpdate(ChangeSet::Flags);
-		return _flags.fetch_and(~flags, std::memory_order_acq_rel) & ~flags;
+		Flags result = _flags.fetch_and(~flags, std::memory_order_acq_rel) & ~flags;
 		DidUpdate(ChangeSet::Flags);
+		
+		return result;
 	}
 	SceneNode::Flags SceneNode::AddFlags(Flags flags)
 	{
 		WillUpdate(ChangeSet::Flags);
-		return _flags.fetch_or(flags, std::memory_order_acq_rel) | flags;
+		Flags result = _flags.fetch_or(flags, std::memory_order_acq_rel) | flags;
 		DidUpdate(ChangeSet::Flags);
+		
+		return result;
 	}
 
 	// -------------------
@@ -274,10 +285,16 @@ namespace RN
 			});
 		}
 
+		if(_transformHierarchy)
+			_transformHierarchy->RemoveNode(this);
+
 		SafeRelease(_sceneInfo);
 		_sceneInfo = sceneInfo;
 		SafeRetain(_sceneInfo);
 
+		if(_sceneInfo && _sceneInfo->GetScene()->GetTransformHierarchy())
+			_sceneInfo->GetScene()->GetTransformHierarchy()->AddNode(this);
+
 		if(_sceneInfo)
 		{
 			_children->Enumerate<SceneNode>([&](SceneNode *node, size_t index, bool &stop) {
@@ -416,6 +433,11 @@ namespace RN
 		return false;
 	}
 
+	bool SceneNode::UsesFrustumCulling() const
+	{
+		return !(_flags.load(std::memory_order_acquire) & Flags::NoCulling);
+	}
+
 	void SceneNode::Render(Renderer *renderer, Camera *camera) const
 	{}
 
@@ -455,6 +477,12 @@ namespace RN
 			_updatedTransform = true;
 			_updatedInverseTransform = true;
 			_updatedBounds = true;
+
+			if(_transformHierarchy)
+				_transformHierarchy->MarkDirty(this);
+
+			if(_boundingVolumeHierarchy)
+				_boundingVolumeHierarchy->MarkMoved(this);
 			
 			//Updated flag Needs to be passed on to all children and their children
 			_children->Enumerate<SceneNode>([](SceneNode *child, size_t index, bool &stop) {
@@ -475,6 +503,15 @@ namespace RN
 			_updatedTransform = true;
 			_updatedInverseTransform = true;
 			_updatedBounds = true;
+
+			if(_transformHierarchy)
+			{
+				_transformHierarchy->SetNeedsLayout();
+				_transformHierarchy->MarkDirty(this);
+			}
+
+			if(_boundingVolumeHierarchy)
+				_boundingVolumeHierarchy->MarkMoved(this);
 			
 			//Updated flag Needs to be passed on to all children and their children
 			_children->Enumerate<SceneNode>([](SceneNode *child, size_t index, bool &stop) {
@@ -482,6 +519,13 @@ namespace RN
 			});
 		}
 
+		if(changeSet & ChangeSet::Flags)
+		{
+			// NoCulling decides whether the node is kept as an unbounded leaf
+			if(_boundingVolumeHierarchy)
+				_boundingVolumeHierarchy->MarkMoved(this);
+		}
+
 		if(_parent)
 			_parent->ChildDidUpdate(this, changeSet);
 
@@ -21,6 +21,8 @@
 #include "../Base/RNSignal.h"
 #include "../Objects/RNArray.h"
 #include "../Objects/RNKVOImplementation.h"
+#include "RNTransformHierarchy.h"
+#include "RNBoundingVolumeHierarchy.h"
 
 namespace RN
 {
@@ -34,6 +36,8 @@ namespace RN
 	{
 	public:
 		friend class Scene;
+		friend class TransformHierarchy;
+		friend class BoundingVolumeHierarchy;
 
 		enum class UpdatePriority
 		{
@@ -169,6 +173,9 @@ namespace RN
 		RNAPI virtual bool CanRender(Renderer *renderer, Camera *camera) const;
 		RNAPI virtual void Render(Renderer *renderer, Camera *camera) const;
 
+		//Return false if CanRender() can pass for nodes outside of the camera frustum, scenes use this to cull in batches before calling CanRender()
+		RNAPI virtual bool UsesFrustumCulling() const;
+
 		RNAPI virtual void Update(float delta);
 		
 		IntrusiveList<SceneNode>::Member _sceneUpdateEntry; //TODO: Make private but keep accessible to user made scene implementations
@@ -245,6 +252,13 @@ namespace RN
 		mutable AABB _transformedBoundingBox;
 		mutable Sphere _transformedBoundingSphere;
 
+		TransformHierarchy *_transformHierarchy;
+		size_t _transformIndex;
+
+		BoundingVolumeHierarchy *_boundingVolumeHierarchy;
+		int32 _boundingVolumeProxy;
+		std::atomic<bool> _boundingVolumeMoved;
+
 		__RNDeclareMetaInternal(SceneNode)
 	};
 
@@ -394,27 +408,42 @@ namespace RN
 
 	RN_INLINE Vector3 SceneNode::GetWorldPosition() const
 	{
+		if(_transformHierarchy && _transformHierarchy->IsValid(_transformIndex))
+			return _transformHierarchy->GetWorldPosition(_transformIndex);
+
 		UpdateInternalData();
 		return Vector3(_worldPosition);
 	}
 	RN_INLINE Vector3 SceneNode::GetWorldScale() const
 	{
+		if(_transformHierarchy && _transformHierarchy->IsValid(_transformIndex))
+			return _transformHierarchy->GetWorldScale(_transformIndex);
+
 		UpdateInternalData();
 		return Vector3(_worldScale);
 	}
 	RN_INLINE Vector3 SceneNode::GetWorldEulerAngle() const
 	{
+		if(_transformHierarchy && _transformHierarchy->IsValid(_transformIndex))
+			return _transformHierarchy->GetWorldEulerAngle(_transformIndex);
+
 		UpdateInternalData();
 		return Vector3(_worldEuler);
 	}
 	RN_INLINE Quaternion SceneNode::GetWorldRotation() const
 	{
+		if(_transformHierarchy && _transformHierarchy->IsValid(_transformIndex))
+			return _transformHierarchy->GetWorldRotation(_transformIndex);
+
 		UpdateInternalData();
 		return Quaternion(_worldRotation);
 	}
 
 	RN_INLINE Matrix SceneNode::GetTransform() const
 	{
+		if(_transformHierarchy && _transformHierarchy->IsValid(_transformIndex))
+			return _transformHierarchy->GetTransform(_transformIndex);
+
 		UpdateInternalTransformData();
 		return Matrix(_localTransform);
 	}
@@ -427,6 +456,9 @@ namespace RN
 
 	RN_INLINE Matrix SceneNode::GetWorldTransform() const
 	{
+		if(_transformHierarchy && _transformHierarchy->IsValid(_transformIndex))
+			return _transformHierarchy->GetWorldTransform(_transformIndex);
+
 		UpdateInternalTransformData();
 		return Matrix(_worldTransform);
 	}
@@ -439,12 +471,18 @@ namespace RN
 
 	RN_INLINE AABB SceneNode::GetBoundingBox() const
 	{
+		if(_transformHierarchy && _transformHierarchy->IsValid(_transformIndex))
+			return _transformHierarchy->GetBoundingBox(_transformIndex);
+
 		UpdateInternalBoundsData();
 		return AABB(_transformedBoundingBox);
 	}
 
 	RN_INLINE Sphere SceneNode::GetBoundingSphere() const
 	{
+		if(_transformHierarchy && _transformHierarchy->IsValid(_transformIndex))
+			return _transformHierarchy->GetBoundingSphere(_transformIndex);
+
 		UpdateInternalBoundsData();
 		return Sphere(_transformedBoundingSphere);
 	}
@@ -10,6 +10,7 @@
 #include "../Debug/RNLogger.h"
 #include "../Threads/RNWorkQueue.h"
 #include "../Threads/RNWorkGroup.h"
+#include "../Threads/RNParallelFor.h"
 #include "../Objects/RNAutoreleasePool.h"
 
 #define kRNSceneUpdateBatchSize 64
@@ -55,61 +56,39 @@ namespace RN
 		
 		for(size_t i = 0; i < 4; i ++)
 		{
-			WorkGroup *group = new WorkGroup();
-			
-			IntrusiveList<SceneNode>::Member *member = _updateNodes[i].GetHead();
-			IntrusiveList<SceneNode>::Member *first = member;
-			
+			// Split the list into batches, the calling thread joins the work queue on them
+			_updateBatches.clear();
+
 			size_t count = 0;
-			
+			IntrusiveList<SceneNode>::Member *member = _updateNodes[i].GetHead();
+
 			while(member)
 			{
-				if(count == kRNSceneUpdateBatchSize)
-				{
-					group->Perform(queue, [&, member, first] {
-						
-						AutoreleasePool pool;
-						auto iterator = first;
-						
-						while(iterator != member)
-						{
-							SceneNode *node = iterator->Get();
-							UpdateNode(node, delta);
-							iterator = iterator->GetNext();
-						}
-						
-					});
-					
-					first = member;
-					count = 0;
-				}
-				
+				if((count ++ % kRNSceneUpdateBatchSize) == 0)
+					_updateBatches.push_back(member);
+
 				member = member->GetNext();
-				count ++;
-			}
-			
-			//Update remaining less than kRNSceneUpdateBatchSize number of nodes
-			if(first != member)
-			{
-				group->Perform(queue, [&, member, first] {
-					
-					AutoreleasePool pool;
-					auto iterator = first;
-					
-					while(iterator != member)
-					{
-						SceneNode *node = iterator->Get();
-						UpdateNode(node, delta);
-						iterator = iterator->GetNext();
-					}
-					
-				});
 			}
-			
-			group->Wait();
-			group->Release();
+
+			const size_t batchCount = _updateBatches.size();
+
+			ParallelFor(Range(0, batchCount), 1, [&](size_t index) {
+
+				AutoreleasePool pool;
+
+				IntrusiveList<SceneNode>::Member *iterator = _updateBatches[index];
+				IntrusiveList<SceneNode>::Member *end = (index + 1 < batchCount) ? _updateBatches[index + 1] : nullptr;
+
+				while(iterator != end)
+				{
+					SceneNode *node = iterator->Get();
+					UpdateNode(node, delta);
+					iterator = iterator->GetNext();
+				}
+
+			}, queue);
 		}
-		
+
 		Scene::Update(delta);
 		
 		DidUpdate(delta);
@@ -228,6 +207,9 @@ namespace RN
 		SceneWithVisibilityListsInfo *sceneInfo = new SceneWithVisibilityListsInfo(this);
 		node->UpdateSceneInfo(sceneInfo->Autorelease());
 		
+		if(GetBoundingVolumeHierarchy() && !node->IsKindOfClass(Camera::GetMetaClass()) && !node->IsKindOfClass(Light::GetMetaClass()))
+			GetBoundingVolumeHierarchy()->AddNode(node);
+		
 		if(!_isAddingVolume)
 		{
 			_defaultVolume->nodes.push_back(node);
@@ -262,6 +244,9 @@ namespace RN
 			}
 		}
 		
+		if(GetBoundingVolumeHierarchy() && GetBoundingVolumeHierarchy()->ContainsNode(node))
+			GetBoundingVolumeHierarchy()->RemoveNode(node);
+		
 		node->UpdateSceneInfo(nullptr);
 		node->Autorelease();
 	}
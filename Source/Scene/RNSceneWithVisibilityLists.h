@@ -55,6 +55,7 @@ namespace RN
 		RNAPI void RemoveRenderNode(SceneNode *node);
 
 		IntrusiveList<SceneNode> _updateNodes[4];
+		std::vector<IntrusiveList<SceneNode>::Member *> _updateBatches;
 		IntrusiveList<Camera> _cameras;
 		IntrusiveList<Light> _lights;
 		
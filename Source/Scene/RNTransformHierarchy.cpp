@@ -0,0 +1,314 @@
+//
+//  RNTransformHierarchy.cpp
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "RNTransformHierarchy.h"
+#include "RNSceneNode.h"
+#include "../Threads/RNParallelFor.h"
+
+#define kRNTransformHierarchyBatchSize 1024
+
+namespace RN
+{
+	// Same as Matrix::WithTranslation(position) * Matrix::WithRotation(rotation) * Matrix::WithScaling(scale), without the two multiplications
+	static RN_INLINE void ComposeTransform(Matrix &result, const Vector3 &position, const Quaternion &rotation, const Vector3 &scale)
+	{
+		result = rotation.GetRotationMatrix();
+
+		result.m[0] *= scale.x;
+		result.m[1] *= scale.x;
+		result.m[2] *= scale.x;
+
+		result.m[4] *= scale.y;
+		result.m[5] *= scale.y;
+		result.m[6] *= scale.y;
+
+		result.m[8] *= scale.z;
+		result.m[9] *= scale.z;
+		result.m[10] *= scale.z;
+
+		result.m[12] = position.x;
+		result.m[13] = position.y;
+		result.m[14] = position.z;
+	}
+
+	TransformHierarchy::TransformHierarchy() :
+		_hasExternalParents(false),
+		_needsLayout(false)
+	{}
+
+	TransformHierarchy::~TransformHierarchy()
+	{
+		for(SceneNode *node : _nodes)
+		{
+			if(node)
+			{
+				node->_transformHierarchy = nullptr;
+				node->_transformIndex = kRNNotFound;
+			}
+		}
+
+		for(SceneNode *node : _pendingNodes)
+			node->_transformHierarchy = nullptr;
+	}
+
+	void TransformHierarchy::AddNode(SceneNode *node)
+	{
+		LockGuard<Lockable> lock(_lock);
+
+		RN_ASSERT(node->_transformHierarchy == nullptr, "AddNode() must be called on a node that isn't part of a transform hierarchy");
+
+		node->_transformHierarchy = this;
+		node->_transformIndex = kRNNotFound;
+
+		_pendingNodes.push_back(node);
+		SetNeedsLayout();
+	}
+
+	void TransformHierarchy::RemoveNode(SceneNode *node)
+	{
+		LockGuard<Lockable> lock(_lock);
+
+		RN_ASSERT(node->_transformHierarchy == this, "RemoveNode() must be called on a node that is part of the transform hierarchy");
+
+		if(node->_transformIndex != kRNNotFound)
+		{
+			_nodes[node->_transformIndex] = nullptr;
+			_dirty[node->_transformIndex] = 1;
+		}
+		else
+		{
+			_pendingNodes.erase(std::find(_pendingNodes.begin(), _pendingNodes.end(), node));
+		}
+
+		node->_transformHierarchy = nullptr;
+		node->_transformIndex = kRNNotFound;
+
+		SetNeedsLayout();
+	}
+
+	void TransformHierarchy::MarkDirty(const SceneNode *node)
+	{
+		const size_t index = node->_transformIndex;
+
+		if(index == kRNNotFound)
+			return;
+
+		CopyLocalData(index, node);
+		_dirty[index] = 1;
+	}
+
+	void TransformHierarchy::CopyLocalData(size_t index, const SceneNode *node)
+	{
+		_localPositions[index] = node->_position;
+		_localRotations[index] = node->_rotation;
+		_localScales[index] = node->_scale;
+		_localEulers[index] = node->_euler;
+		_localBoundingBoxes[index] = node->_boundingBox;
+		_localBoundingSpheres[index] = node->_boundingSphere;
+	}
+
+	void TransformHierarchy::Layout()
+	{
+		std::vector<SceneNode *> nodes;
+
+		{
+			LockGuard<Lockable> lock(_lock);
+
+			nodes.reserve(_nodes.size() + _pendingNodes.size());
+
+			for(SceneNode *node : _nodes)
+			{
+				if(node)
+					nodes.push_back(node);
+			}
+
+			nodes.insert(nodes.end(), _pendingNodes.begin(), _pendingNodes.end());
+			_pendingNodes.clear();
+
+			_needsLayout.store(false, std::memory_order_release);
+		}
+
+		// Counting sort by depth, so every parent ends up in a lower level than its children
+		const size_t count = nodes.size();
+
+		std::vector<uint32> depths(count);
+		std::vector<size_t> offsets;
+
+		_hasExternalParents = false;
+
+		for(size_t i = 0; i < count; i ++)
+		{
+			uint32 depth = 0;
+			SceneNode *parent = nodes[i]->_parent;
+
+			while(parent && parent->_transformHierarchy == this)
+			{
+				depth ++;
+				parent = parent->_parent;
+			}
+
+			if(depth == 0 && nodes[i]->_parent)
+				_hasExternalParents = true;
+
+			if(depth >= offsets.size())
+				offsets.resize(depth + 1, 0);
+
+			depths[i] = depth;
+			offsets[depth] ++;
+		}
+
+		_levels.resize(offsets.size());
+
+		size_t origin = 0;
+		for(size_t i = 0; i < offsets.size(); i ++)
+		{
+			_levels[i] = Range(origin, offsets[i]);
+
+			offsets[i] = origin;
+			origin += _levels[i].length;
+		}
+
+		_nodes.resize(count);
+		_parents.resize(count);
+		_dirty.assign(count, 1);
+
+		for(size_t i = 0; i < count; i ++)
+		{
+			const size_t index = offsets[depths[i]] ++;
+
+			_nodes[index] = nodes[i];
+			nodes[i]->_transformIndex = index;
+		}
+
+		_localPositions.resize(count);
+		_localRotations.resize(count);
+		_localScales.resize(count);
+		_localEulers.resize(count);
+		_localBoundingBoxes.resize(count);
+		_localBoundingSpheres.resize(count);
+
+		_localTransforms.resize(count);
+		_worldTransforms.resize(count);
+		_worldPositions.resize(count);
+		_worldRotations.resize(count);
+		_worldScales.resize(count);
+		_worldEulers.resize(count);
+		_boundingBoxes.resize(count);
+		_boundingSpheres.resize(count);
+
+		for(size_t i = 0; i < count; i ++)
+		{
+			SceneNode *node = _nodes[i];
+			SceneNode *parent = node->_parent;
+
+			_parents[i] = (parent && parent->_transformHierarchy == this) ? static_cast<uint32>(parent->_transformIndex) : kNoParent;
+
+			CopyLocalData(i, node);
+		}
+	}
+
+	void TransformHierarchy::Update(WorkQueue *queue)
+	{
+		if(_needsLayout.load(std::memory_order_acquire))
+			Layout();
+
+		const size_t levelCount = _levels.size();
+
+		for(size_t i = 0; i < levelCount; i ++)
+		{
+			const Range &level = _levels[i];
+
+			// Roots with a parent outside of the hierarchy read it through the lazy node path, which isn't thread safe
+			if(i == 0 && _hasExternalParents)
+			{
+				UpdateLevel(level);
+				continue;
+			}
+
+			ParallelForChunks(level, kRNTransformHierarchyBatchSize, [&](const Range &range) {
+				UpdateLevel(range);
+			}, queue);
+		}
+
+		std::fill(_dirty.begin(), _dirty.end(), 0);
+	}
+
+	void TransformHierarchy::UpdateLevel(const Range &range)
+	{
+		const size_t end = range.GetEnd();
+
+		for(size_t i = range.origin; i < end; i ++)
+		{
+			const uint32 parent = _parents[i];
+
+			// The dirty flags are only cleared once all levels are done, so a dirty parent marks its children as well
+			if(!_dirty[i])
+			{
+				if(parent == kNoParent || !_dirty[parent])
+					continue;
+
+				_dirty[i] = 1;
+			}
+
+			SceneNode *node = _nodes[i];
+			if(RN_EXPECT_FALSE(!node))
+				continue;
+
+			ComposeTransform(_localTransforms[i], _localPositions[i], _localRotations[i], _localScales[i]);
+
+			if(parent != kNoParent)
+			{
+				const Quaternion &parentRotation = _worldRotations[parent];
+
+				_worldTransforms[i] = _worldTransforms[parent] * _localTransforms[i];
+				_worldPositions[i] = _worldPositions[parent] + _worldScales[parent] * parentRotation.GetRotatedVector(_localPositions[i]);
+				_worldRotations[i] = parentRotation * _localRotations[i];
+				_worldScales[i] = _worldScales[parent] * _localScales[i];
+				_worldEulers[i] = _worldEulers[parent] + _localEulers[i];
+			}
+			else if(RN_EXPECT_FALSE(node->_parent != nullptr))
+			{
+				UpdateExternalRoot(i);
+			}
+			else
+			{
+				_worldTransforms[i] = _localTransforms[i];
+				_worldPositions[i] = _localPositions[i];
+				_worldRotations[i] = _localRotations[i];
+				_worldScales[i] = _localScales[i];
+				_worldEulers[i] = _localEulers[i];
+			}
+
+			AABB &boundingBox = _boundingBoxes[i];
+			boundingBox = _localBoundingBoxes[i];
+			boundingBox.position = _worldPositions[i];
+			boundingBox *= _worldScales[i];
+			boundingBox.SetRotation(_worldRotations[i]);
+
+			Sphere &boundingSphere = _boundingSpheres[i];
+			boundingSphere = _localBoundingSpheres[i];
+			boundingSphere.position = _worldPositions[i];
+			boundingSphere *= _worldScales[i];
+			boundingSphere.SetRotation(_worldRotations[i]);
+		}
+	}
+
+	void TransformHierarchy::UpdateExternalRoot(size_t index)
+	{
+		const SceneNode *parent = _nodes[index]->_parent;
+
+		const Quaternion parentRotation = parent->GetWorldRotation();
+		const Vector3 parentScale = parent->GetWorldScale();
+
+		_worldTransforms[index] = parent->GetWorldTransform() * _localTransforms[index];
+		_worldPositions[index] = parent->GetWorldPosition() + parentScale * parentRotation.GetRotatedVector(_localPositions[index]);
+		_worldRotations[index] = parentRotation * _localRotations[index];
+		_worldScales[index] = parentScale * _localScales[index];
+		_worldEulers[index] = parent->GetWorldEulerAngle() + _localEulers[index];
+	}
+}
@@ -0,0 +1,99 @@
+//
+//  RNTransformHierarchy.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_TRANSFORMHIERARCHY_H__
+#define __RAYNE_TRANSFORMHIERARCHY_H__
+
+#include "../Base/RNBase.h"
+#include "../Math/RNMatrix.h"
+#include "../Math/RNQuaternion.h"
+#include "../Math/RNVector.h"
+#include "../Math/RNAABB.h"
+#include "../Math/RNSphere.h"
+
+namespace RN
+{
+	class SceneNode;
+	class WorkQueue;
+
+	// Stores the local and world transforms of the nodes of a scene in flat arrays sorted by hierarchy depth,
+	// so the world data of all nodes can be computed in one batch pass per frame, level by level, without chasing parents.
+	// Nodes that aren't part of the hierarchy or are dirty since the last pass fall back to their lazy per node path.
+	class TransformHierarchy
+	{
+	public:
+		RNAPI TransformHierarchy();
+		RNAPI ~TransformHierarchy();
+
+		// Thread safe, the node gets a slot with the next layout pass
+		RNAPI void AddNode(SceneNode *node);
+		RNAPI void RemoveNode(SceneNode *node);
+
+		// Recomputes the world data of all dirty nodes. Must not run concurrently with changes to the nodes.
+		RNAPI void Update(WorkQueue *queue = nullptr);
+
+		size_t GetCount() const { return _nodes.size(); }
+		size_t GetLevelCount() const { return _levels.size(); }
+
+		bool IsValid(size_t index) const { return (index != kRNNotFound && _dirty[index] == 0); }
+
+		const Vector3 &GetWorldPosition(size_t index) const { return _worldPositions[index]; }
+		const Quaternion &GetWorldRotation(size_t index) const { return _worldRotations[index]; }
+		const Vector3 &GetWorldScale(size_t index) const { return _worldScales[index]; }
+		const Vector3 &GetWorldEulerAngle(size_t index) const { return _worldEulers[index]; }
+
+		const Matrix &GetTransform(size_t index) const { return _localTransforms[index]; }
+		const Matrix &GetWorldTransform(size_t index) const { return _worldTransforms[index]; }
+
+		const AABB &GetBoundingBox(size_t index) const { return _boundingBoxes[index]; }
+		const Sphere &GetBoundingSphere(size_t index) const { return _boundingSpheres[index]; }
+
+	private:
+		friend class SceneNode;
+
+		static constexpr uint32 kNoParent = static_cast<uint32>(-1);
+
+		void MarkDirty(const SceneNode *node);
+		void SetNeedsLayout() { _needsLayout.store(true, std::memory_order_release); }
+
+		void Layout();
+		void CopyLocalData(size_t index, const SceneNode *node);
+		void UpdateLevel(const Range &range);
+		void UpdateExternalRoot(size_t index);
+
+		std::vector<SceneNode *> _nodes;
+		std::vector<uint32> _parents;
+		std::vector<uint8> _dirty;
+		std::vector<Range> _levels;
+		bool _hasExternalParents;
+
+		// Local data
+		std::vector<Vector3> _localPositions;
+		std::vector<Quaternion> _localRotations;
+		std::vector<Vector3> _localScales;
+		std::vector<Vector3> _localEulers;
+		std::vector<AABB> _localBoundingBoxes;
+		std::vector<Sphere> _localBoundingSpheres;
+
+		// World data
+		std::vector<Matrix> _localTransforms;
+		std::vector<Matrix> _worldTransforms;
+		std::vector<Vector3> _worldPositions;
+		std::vector<Quaternion> _worldRotations;
+		std::vector<Vector3> _worldScales;
+		std::vector<Vector3> _worldEulers;
+		std::vector<AABB> _boundingBoxes;
+		std::vector<Sphere> _boundingSpheres;
+
+		Lockable _lock;
+		std::vector<SceneNode *> _pendingNodes;
+		std::atomic<bool> _needsLayout;
+	};
+}
+
+#endif /* __RAYNE_TRANSFORMHIERARCHY_H__ */
@@ -7,33 +7,408 @@
 //
 
 #include "RNVoxelEntity.h"
+#include "RNCamera.h"
+#include "../Threads/RNParallelFor.h"
 
 namespace RN
 {
 	RNDefineMeta(VoxelEntity, SceneNode)
 
+	static constexpr int __VoxelEdgeTable[256] = {
+		0x0  , 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
+		0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
+		0x190, 0x99 , 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
+		0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90,
+		0x230, 0x339, 0x33 , 0x13a, 0x636, 0x73f, 0x435, 0x53c,
+		0xa3c, 0xb35, 0x83f, 0x936, 0xe3a, 0xf33, 0xc39, 0xd30,
+		0x3a0, 0x2a9, 0x1a3, 0xaa , 0x7a6, 0x6af, 0x5a5, 0x4ac,
+		0xbac, 0xaa5, 0x9af, 0x8a6, 0xfaa, 0xea3, 0xda9, 0xca0,
+		0x460, 0x569, 0x663, 0x76a, 0x66 , 0x16f, 0x265, 0x36c,
+		0xc6c, 0xd65, 0xe6f, 0xf66, 0x86a, 0x963, 0xa69, 0xb60,
+		0x5f0, 0x4f9, 0x7f3, 0x6fa, 0x1f6, 0xff , 0x3f5, 0x2fc,
+		0xdfc, 0xcf5, 0xfff, 0xef6, 0x9fa, 0x8f3, 0xbf9, 0xaf0,
+		0x650, 0x759, 0x453, 0x55a, 0x256, 0x35f, 0x55 , 0x15c,
+		0xe5c, 0xf55, 0xc5f, 0xd56, 0xa5a, 0xb53, 0x859, 0x950,
+		0x7c0, 0x6c9, 0x5c3, 0x4ca, 0x3c6, 0x2cf, 0x1c5, 0xcc ,
+		0xfcc, 0xec5, 0xdcf, 0xcc6, 0xbca, 0xac3, 0x9c9, 0x8c0,
+		0x8c0, 0x9c9, 0xac3, 0xbca, 0xcc6, 0xdcf, 0xec5, 0xfcc,
+		0xcc , 0x1c5, 0x2cf, 0x3c6, 0x4ca, 0x5c3, 0x6c9, 0x7c0,
+		0x950, 0x859, 0xb53, 0xa5a, 0xd56, 0xc5f, 0xf55, 0xe5c,
+		0x15c, 0x55 , 0x35f, 0x256, 0x55a, 0x453, 0x759, 0x650,
+		0xaf0, 0xbf9, 0x8f3, 0x9fa, 0xef6, 0xfff, 0xcf5, 0xdfc,
+		0x2fc, 0x3f5, 0xff , 0x1f6, 0x6fa, 0x7f3, 0x4f9, 0x5f0,
+		0xb60, 0xa69, 0x963, 0x86a, 0xf66, 0xe6f, 0xd65, 0xc6c,
+		0x36c, 0x265, 0x16f, 0x66 , 0x76a, 0x663, 0x569, 0x460,
+		0xca0, 0xda9, 0xea3, 0xfaa, 0x8a6, 0x9af, 0xaa5, 0xbac,
+		0x4ac, 0x5a5, 0x6af, 0x7a6, 0xaa , 0x1a3, 0x2a9, 0x3a0,
+		0xd30, 0xc39, 0xf33, 0xe3a, 0x936, 0x83f, 0xb35, 0xa3c,
+		0x53c, 0x435, 0x73f, 0x636, 0x13a, 0x33 , 0x339, 0x230,
+		0xe90, 0xf99, 0xc93, 0xd9a, 0xa96, 0xb9f, 0x895, 0x99c,
+		0x69c, 0x795, 0x49f, 0x596, 0x29a, 0x393, 0x99 , 0x190,
+		0xf00, 0xe09, 0xd03, 0xc0a, 0xb06, 0xa0f, 0x905, 0x80c,
+		0x70c, 0x605, 0x50f, 0x406, 0x30a, 0x203, 0x109, 0x0};
+
+	static constexpr int8 __VoxelTriangleTable[256][16] = {
+		{-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 8, 3, 9, 8, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 8, 3, 1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{9, 2, 10, 0, 2, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{2, 8, 3, 2, 10, 8, 10, 9, 8, -1, -1, -1, -1, -1, -1, -1},
+		{3, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 11, 2, 8, 11, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 9, 0, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 11, 2, 1, 9, 11, 9, 8, 11, -1, -1, -1, -1, -1, -1, -1},
+		{3, 10, 1, 11, 10, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 10, 1, 0, 8, 10, 8, 11, 10, -1, -1, -1, -1, -1, -1, -1},
+		{3, 9, 0, 3, 11, 9, 11, 10, 9, -1, -1, -1, -1, -1, -1, -1},
+		{9, 8, 10, 10, 8, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{4, 3, 0, 7, 3, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 1, 9, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{4, 1, 9, 4, 7, 1, 7, 3, 1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 2, 10, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{3, 4, 7, 3, 0, 4, 1, 2, 10, -1, -1, -1, -1, -1, -1, -1},
+		{9, 2, 10, 9, 0, 2, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1},
+		{2, 10, 9, 2, 9, 7, 2, 7, 3, 7, 9, 4, -1, -1, -1, -1},
+		{8, 4, 7, 3, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{11, 4, 7, 11, 2, 4, 2, 0, 4, -1, -1, -1, -1, -1, -1, -1},
+		{9, 0, 1, 8, 4, 7, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1},
+		{4, 7, 11, 9, 4, 11, 9, 11, 2, 9, 2, 1, -1, -1, -1, -1},
+		{3, 10, 1, 3, 11, 10, 7, 8, 4, -1, -1, -1, -1, -1, -1, -1},
+		{1, 11, 10, 1, 4, 11, 1, 0, 4, 7, 11, 4, -1, -1, -1, -1},
+		{4, 7, 8, 9, 0, 11, 9, 11, 10, 11, 0, 3, -1, -1, -1, -1},
+		{4, 7, 11, 4, 11, 9, 9, 11, 10, -1, -1, -1, -1, -1, -1, -1},
+		{9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{9, 5, 4, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 5, 4, 1, 5, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{8, 5, 4, 8, 3, 5, 3, 1, 5, -1, -1, -1, -1, -1, -1, -1},
+		{1, 2, 10, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{3, 0, 8, 1, 2, 10, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1},
+		{5, 2, 10, 5, 4, 2, 4, 0, 2, -1, -1, -1, -1, -1, -1, -1},
+		{2, 10, 5, 3, 2, 5, 3, 5, 4, 3, 4, 8, -1, -1, -1, -1},
+		{9, 5, 4, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 11, 2, 0, 8, 11, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1},
+		{0, 5, 4, 0, 1, 5, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1},
+		{2, 1, 5, 2, 5, 8, 2, 8, 11, 4, 8, 5, -1, -1, -1, -1},
+		{10, 3, 11, 10, 1, 3, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1},
+		{4, 9, 5, 0, 8, 1, 8, 10, 1, 8, 11, 10, -1, -1, -1, -1},
+		{5, 4, 0, 5, 0, 11, 5, 11, 10, 11, 0, 3, -1, -1, -1, -1},
+		{5, 4, 8, 5, 8, 10, 10, 8, 11, -1, -1, -1, -1, -1, -1, -1},
+		{9, 7, 8, 5, 7, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{9, 3, 0, 9, 5, 3, 5, 7, 3, -1, -1, -1, -1, -1, -1, -1},
+		{0, 7, 8, 0, 1, 7, 1, 5, 7, -1, -1, -1, -1, -1, -1, -1},
+		{1, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{9, 7, 8, 9, 5, 7, 10, 1, 2, -1, -1, -1, -1, -1, -1, -1},
+		{10, 1, 2, 9, 5, 0, 5, 3, 0, 5, 7, 3, -1, -1, -1, -1},
+		{8, 0, 2, 8, 2, 5, 8, 5, 7, 10, 5, 2, -1, -1, -1, -1},
+		{2, 10, 5, 2, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1},
+		{7, 9, 5, 7, 8, 9, 3, 11, 2, -1, -1, -1, -1, -1, -1, -1},
+		{9, 5, 7, 9, 7, 2, 9, 2, 0, 2, 7, 11, -1, -1, -1, -1},
+		{2, 3, 11, 0, 1, 8, 1, 7, 8, 1, 5, 7, -1, -1, -1, -1},
+		{11, 2, 1, 11, 1, 7, 7, 1, 5, -1, -1, -1, -1, -1, -1, -1},
+		{9, 5, 8, 8, 5, 7, 10, 1, 3, 10, 3, 11, -1, -1, -1, -1},
+		{5, 7, 0, 5, 0, 9, 7, 11, 0, 1, 0, 10, 11, 10, 0, -1},
+		{11, 10, 0, 11, 0, 3, 10, 5, 0, 8, 0, 7, 5, 7, 0, -1},
+		{11, 10, 5, 7, 11, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{10, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 8, 3, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{9, 0, 1, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 8, 3, 1, 9, 8, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1},
+		{1, 6, 5, 2, 6, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 6, 5, 1, 2, 6, 3, 0, 8, -1, -1, -1, -1, -1, -1, -1},
+		{9, 6, 5, 9, 0, 6, 0, 2, 6, -1, -1, -1, -1, -1, -1, -1},
+		{5, 9, 8, 5, 8, 2, 5, 2, 6, 3, 2, 8, -1, -1, -1, -1},
+		{2, 3, 11, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{11, 0, 8, 11, 2, 0, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1},
+		{0, 1, 9, 2, 3, 11, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1},
+		{5, 10, 6, 1, 9, 2, 9, 11, 2, 9, 8, 11, -1, -1, -1, -1},
+		{6, 3, 11, 6, 5, 3, 5, 1, 3, -1, -1, -1, -1, -1, -1, -1},
+		{0, 8, 11, 0, 11, 5, 0, 5, 1, 5, 11, 6, -1, -1, -1, -1},
+		{3, 11, 6, 0, 3, 6, 0, 6, 5, 0, 5, 9, -1, -1, -1, -1},
+		{6, 5, 9, 6, 9, 11, 11, 9, 8, -1, -1, -1, -1, -1, -1, -1},
+		{5, 10, 6, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{4, 3, 0, 4, 7, 3, 6, 5, 10, -1, -1, -1, -1, -1, -1, -1},
+		{1, 9, 0, 5, 10, 6, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1},
+		{10, 6, 5, 1, 9, 7, 1, 7, 3, 7, 9, 4, -1, -1, -1, -1},
+		{6, 1, 2, 6, 5, 1, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1},
+		{1, 2, 5, 5, 2, 6, 3, 0, 4, 3, 4, 7, -1, -1, -1, -1},
+		{8, 4, 7, 9, 0, 5, 0, 6, 5, 0, 2, 6, -1, -1, -1, -1},
+		{7, 3, 9, 7, 9, 4, 3, 2, 9, 5, 9, 6, 2, 6, 9, -1},
+		{3, 11, 2, 7, 8, 4, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1},
+		{5, 10, 6, 4, 7, 2, 4, 2, 0, 2, 7, 11, -1, -1, -1, -1},
+		{0, 1, 9, 4, 7, 8, 2, 3, 11, 5, 10, 6, -1, -1, -1, -1},
+		{9, 2, 1, 9, 11, 2, 9, 4, 11, 7, 11, 4, 5, 10, 6, -1},
+		{8, 4, 7, 3, 11, 5, 3, 5, 1, 5, 11, 6, -1, -1, -1, -1},
+		{5, 1, 11, 5, 11, 6, 1, 0, 11, 7, 11, 4, 0, 4, 11, -1},
+		{0, 5, 9, 0, 6, 5, 0, 3, 6, 11, 6, 3, 8, 4, 7, -1},
+		{6, 5, 9, 6, 9, 11, 4, 7, 9, 7, 11, 9, -1, -1, -1, -1},
+		{10, 4, 9, 6, 4, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{4, 10, 6, 4, 9, 10, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1},
+		{10, 0, 1, 10, 6, 0, 6, 4, 0, -1, -1, -1, -1, -1, -1, -1},
+		{8, 3, 1, 8, 1, 6, 8, 6, 4, 6, 1, 10, -1, -1, -1, -1},
+		{1, 4, 9, 1, 2, 4, 2, 6, 4, -1, -1, -1, -1, -1, -1, -1},
+		{3, 0, 8, 1, 2, 9, 2, 4, 9, 2, 6, 4, -1, -1, -1, -1},
+		{0, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{8, 3, 2, 8, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1},
+		{10, 4, 9, 10, 6, 4, 11, 2, 3, -1, -1, -1, -1, -1, -1, -1},
+		{0, 8, 2, 2, 8, 11, 4, 9, 10, 4, 10, 6, -1, -1, -1, -1},
+		{3, 11, 2, 0, 1, 6, 0, 6, 4, 6, 1, 10, -1, -1, -1, -1},
+		{6, 4, 1, 6, 1, 10, 4, 8, 1, 2, 1, 11, 8, 11, 1, -1},
+		{9, 6, 4, 9, 3, 6, 9, 1, 3, 11, 6, 3, -1, -1, -1, -1},
+		{8, 11, 1, 8, 1, 0, 11, 6, 1, 9, 1, 4, 6, 4, 1, -1},
+		{3, 11, 6, 3, 6, 0, 0, 6, 4, -1, -1, -1, -1, -1, -1, -1},
+		{6, 4, 8, 11, 6, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{7, 10, 6, 7, 8, 10, 8, 9, 10, -1, -1, -1, -1, -1, -1, -1},
+		{0, 7, 3, 0, 10, 7, 0, 9, 10, 6, 7, 10, -1, -1, -1, -1},
+		{10, 6, 7, 1, 10, 7, 1, 7, 8, 1, 8, 0, -1, -1, -1, -1},
+		{10, 6, 7, 10, 7, 1, 1, 7, 3, -1, -1, -1, -1, -1, -1, -1},
+		{1, 2, 6, 1, 6, 8, 1, 8, 9, 8, 6, 7, -1, -1, -1, -1},
+		{2, 6, 9, 2, 9, 1, 6, 7, 9, 0, 9, 3, 7, 3, 9, -1},
+		{7, 8, 0, 7, 0, 6, 6, 0, 2, -1, -1, -1, -1, -1, -1, -1},
+		{7, 3, 2, 6, 7, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{2, 3, 11, 10, 6, 8, 10, 8, 9, 8, 6, 7, -1, -1, -1, -1},
+		{2, 0, 7, 2, 7, 11, 0, 9, 7, 6, 7, 10, 9, 10, 7, -1},
+		{1, 8, 0, 1, 7, 8, 1, 10, 7, 6, 7, 10, 2, 3, 11, -1},
+		{11, 2, 1, 11, 1, 7, 10, 6, 1, 6, 7, 1, -1, -1, -1, -1},
+		{8, 9, 6, 8, 6, 7, 9, 1, 6, 11, 6, 3, 1, 3, 6, -1},
+		{0, 9, 1, 11, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{7, 8, 0, 7, 0, 6, 3, 11, 0, 11, 6, 0, -1, -1, -1, -1},
+		{7, 11, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{7, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{3, 0, 8, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 1, 9, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{8, 1, 9, 8, 3, 1, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1},
+		{10, 1, 2, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 2, 10, 3, 0, 8, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1},
+		{2, 9, 0, 2, 10, 9, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1},
+		{6, 11, 7, 2, 10, 3, 10, 8, 3, 10, 9, 8, -1, -1, -1, -1},
+		{7, 2, 3, 6, 2, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{7, 0, 8, 7, 6, 0, 6, 2, 0, -1, -1, -1, -1, -1, -1, -1},
+		{2, 7, 6, 2, 3, 7, 0, 1, 9, -1, -1, -1, -1, -1, -1, -1},
+		{1, 6, 2, 1, 8, 6, 1, 9, 8, 8, 7, 6, -1, -1, -1, -1},
+		{10, 7, 6, 10, 1, 7, 1, 3, 7, -1, -1, -1, -1, -1, -1, -1},
+		{10, 7, 6, 1, 7, 10, 1, 8, 7, 1, 0, 8, -1, -1, -1, -1},
+		{0, 3, 7, 0, 7, 10, 0, 10, 9, 6, 10, 7, -1, -1, -1, -1},
+		{7, 6, 10, 7, 10, 8, 8, 10, 9, -1, -1, -1, -1, -1, -1, -1},
+		{6, 8, 4, 11, 8, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{3, 6, 11, 3, 0, 6, 0, 4, 6, -1, -1, -1, -1, -1, -1, -1},
+		{8, 6, 11, 8, 4, 6, 9, 0, 1, -1, -1, -1, -1, -1, -1, -1},
+		{9, 4, 6, 9, 6, 3, 9, 3, 1, 11, 3, 6, -1, -1, -1, -1},
+		{6, 8, 4, 6, 11, 8, 2, 10, 1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 2, 10, 3, 0, 11, 0, 6, 11, 0, 4, 6, -1, -1, -1, -1},
+		{4, 11, 8, 4, 6, 11, 0, 2, 9, 2, 10, 9, -1, -1, -1, -1},
+		{10, 9, 3, 10, 3, 2, 9, 4, 3, 11, 3, 6, 4, 6, 3, -1},
+		{8, 2, 3, 8, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1},
+		{0, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 9, 0, 2, 3, 4, 2, 4, 6, 4, 3, 8, -1, -1, -1, -1},
+		{1, 9, 4, 1, 4, 2, 2, 4, 6, -1, -1, -1, -1, -1, -1, -1},
+		{8, 1, 3, 8, 6, 1, 8, 4, 6, 6, 10, 1, -1, -1, -1, -1},
+		{10, 1, 0, 10, 0, 6, 6, 0, 4, -1, -1, -1, -1, -1, -1, -1},
+		{4, 6, 3, 4, 3, 8, 6, 10, 3, 0, 3, 9, 10, 9, 3, -1},
+		{10, 9, 4, 6, 10, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{4, 9, 5, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 8, 3, 4, 9, 5, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1},
+		{5, 0, 1, 5, 4, 0, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1},
+		{11, 7, 6, 8, 3, 4, 3, 5, 4, 3, 1, 5, -1, -1, -1, -1},
+		{9, 5, 4, 10, 1, 2, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1},
+		{6, 11, 7, 1, 2, 10, 0, 8, 3, 4, 9, 5, -1, -1, -1, -1},
+		{7, 6, 11, 5, 4, 10, 4, 2, 10, 4, 0, 2, -1, -1, -1, -1},
+		{3, 4, 8, 3, 5, 4, 3, 2, 5, 10, 5, 2, 11, 7, 6, -1},
+		{7, 2, 3, 7, 6, 2, 5, 4, 9, -1, -1, -1, -1, -1, -1, -1},
+		{9, 5, 4, 0, 8, 6, 0, 6, 2, 6, 8, 7, -1, -1, -1, -1},
+		{3, 6, 2, 3, 7, 6, 1, 5, 0, 5, 4, 0, -1, -1, -1, -1},
+		{6, 2, 8, 6, 8, 7, 2, 1, 8, 4, 8, 5, 1, 5, 8, -1},
+		{9, 5, 4, 10, 1, 6, 1, 7, 6, 1, 3, 7, -1, -1, -1, -1},
+		{1, 6, 10, 1, 7, 6, 1, 0, 7, 8, 7, 0, 9, 5, 4, -1},
+		{4, 0, 10, 4, 10, 5, 0, 3, 10, 6, 10, 7, 3, 7, 10, -1},
+		{7, 6, 10, 7, 10, 8, 5, 4, 10, 4, 8, 10, -1, -1, -1, -1},
+		{6, 9, 5, 6, 11, 9, 11, 8, 9, -1, -1, -1, -1, -1, -1, -1},
+		{3, 6, 11, 0, 6, 3, 0, 5, 6, 0, 9, 5, -1, -1, -1, -1},
+		{0, 11, 8, 0, 5, 11, 0, 1, 5, 5, 6, 11, -1, -1, -1, -1},
+		{6, 11, 3, 6, 3, 5, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 2, 10, 9, 5, 11, 9, 11, 8, 11, 5, 6, -1, -1, -1, -1},
+		{0, 11, 3, 0, 6, 11, 0, 9, 6, 5, 6, 9, 1, 2, 10, -1},
+		{11, 8, 5, 11, 5, 6, 8, 0, 5, 10, 5, 2, 0, 2, 5, -1},
+		{6, 11, 3, 6, 3, 5, 2, 10, 3, 10, 5, 3, -1, -1, -1, -1},
+		{5, 8, 9, 5, 2, 8, 5, 6, 2, 3, 8, 2, -1, -1, -1, -1},
+		{9, 5, 6, 9, 6, 0, 0, 6, 2, -1, -1, -1, -1, -1, -1, -1},
+		{1, 5, 8, 1, 8, 0, 5, 6, 8, 3, 8, 2, 6, 2, 8, -1},
+		{1, 5, 6, 2, 1, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 3, 6, 1, 6, 10, 3, 8, 6, 5, 6, 9, 8, 9, 6, -1},
+		{10, 1, 0, 10, 0, 6, 9, 5, 0, 5, 6, 0, -1, -1, -1, -1},
+		{0, 3, 8, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{10, 5, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{11, 5, 10, 7, 5, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{11, 5, 10, 11, 7, 5, 8, 3, 0, -1, -1, -1, -1, -1, -1, -1},
+		{5, 11, 7, 5, 10, 11, 1, 9, 0, -1, -1, -1, -1, -1, -1, -1},
+		{10, 7, 5, 10, 11, 7, 9, 8, 1, 8, 3, 1, -1, -1, -1, -1},
+		{11, 1, 2, 11, 7, 1, 7, 5, 1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 8, 3, 1, 2, 7, 1, 7, 5, 7, 2, 11, -1, -1, -1, -1},
+		{9, 7, 5, 9, 2, 7, 9, 0, 2, 2, 11, 7, -1, -1, -1, -1},
+		{7, 5, 2, 7, 2, 11, 5, 9, 2, 3, 2, 8, 9, 8, 2, -1},
+		{2, 5, 10, 2, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1},
+		{8, 2, 0, 8, 5, 2, 8, 7, 5, 10, 2, 5, -1, -1, -1, -1},
+		{9, 0, 1, 5, 10, 3, 5, 3, 7, 3, 10, 2, -1, -1, -1, -1},
+		{9, 8, 2, 9, 2, 1, 8, 7, 2, 10, 2, 5, 7, 5, 2, -1},
+		{1, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 8, 7, 0, 7, 1, 1, 7, 5, -1, -1, -1, -1, -1, -1, -1},
+		{9, 0, 3, 9, 3, 5, 5, 3, 7, -1, -1, -1, -1, -1, -1, -1},
+		{9, 8, 7, 5, 9, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{5, 8, 4, 5, 10, 8, 10, 11, 8, -1, -1, -1, -1, -1, -1, -1},
+		{5, 0, 4, 5, 11, 0, 5, 10, 11, 11, 3, 0, -1, -1, -1, -1},
+		{0, 1, 9, 8, 4, 10, 8, 10, 11, 10, 4, 5, -1, -1, -1, -1},
+		{10, 11, 4, 10, 4, 5, 11, 3, 4, 9, 4, 1, 3, 1, 4, -1},
+		{2, 5, 1, 2, 8, 5, 2, 11, 8, 4, 5, 8, -1, -1, -1, -1},
+		{0, 4, 11, 0, 11, 3, 4, 5, 11, 2, 11, 1, 5, 1, 11, -1},
+		{0, 2, 5, 0, 5, 9, 2, 11, 5, 4, 5, 8, 11, 8, 5, -1},
+		{9, 4, 5, 2, 11, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{2, 5, 10, 3, 5, 2, 3, 4, 5, 3, 8, 4, -1, -1, -1, -1},
+		{5, 10, 2, 5, 2, 4, 4, 2, 0, -1, -1, -1, -1, -1, -1, -1},
+		{3, 10, 2, 3, 5, 10, 3, 8, 5, 4, 5, 8, 0, 1, 9, -1},
+		{5, 10, 2, 5, 2, 4, 1, 9, 2, 9, 4, 2, -1, -1, -1, -1},
+		{8, 4, 5, 8, 5, 3, 3, 5, 1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 4, 5, 1, 0, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{8, 4, 5, 8, 5, 3, 9, 0, 5, 0, 3, 5, -1, -1, -1, -1},
+		{9, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{4, 11, 7, 4, 9, 11, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1},
+		{0, 8, 3, 4, 9, 7, 9, 11, 7, 9, 10, 11, -1, -1, -1, -1},
+		{1, 10, 11, 1, 11, 4, 1, 4, 0, 7, 4, 11, -1, -1, -1, -1},
+		{3, 1, 4, 3, 4, 8, 1, 10, 4, 7, 4, 11, 10, 11, 4, -1},
+		{4, 11, 7, 9, 11, 4, 9, 2, 11, 9, 1, 2, -1, -1, -1, -1},
+		{9, 7, 4, 9, 11, 7, 9, 1, 11, 2, 11, 1, 0, 8, 3, -1},
+		{11, 7, 4, 11, 4, 2, 2, 4, 0, -1, -1, -1, -1, -1, -1, -1},
+		{11, 7, 4, 11, 4, 2, 8, 3, 4, 3, 2, 4, -1, -1, -1, -1},
+		{2, 9, 10, 2, 7, 9, 2, 3, 7, 7, 4, 9, -1, -1, -1, -1},
+		{9, 10, 7, 9, 7, 4, 10, 2, 7, 8, 7, 0, 2, 0, 7, -1},
+		{3, 7, 10, 3, 10, 2, 7, 4, 10, 1, 10, 0, 4, 0, 10, -1},
+		{1, 10, 2, 8, 7, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{4, 9, 1, 4, 1, 7, 7, 1, 3, -1, -1, -1, -1, -1, -1, -1},
+		{4, 9, 1, 4, 1, 7, 0, 8, 1, 8, 7, 1, -1, -1, -1, -1},
+		{4, 0, 3, 7, 4, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{4, 8, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{9, 10, 8, 10, 11, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{3, 0, 9, 3, 9, 11, 11, 9, 10, -1, -1, -1, -1, -1, -1, -1},
+		{0, 1, 10, 0, 10, 8, 8, 10, 11, -1, -1, -1, -1, -1, -1, -1},
+		{3, 1, 10, 11, 3, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 2, 11, 1, 11, 9, 9, 11, 8, -1, -1, -1, -1, -1, -1, -1},
+		{3, 0, 9, 3, 9, 11, 1, 2, 9, 2, 11, 9, -1, -1, -1, -1},
+		{0, 2, 11, 8, 0, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{3, 2, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{2, 3, 8, 2, 8, 10, 10, 8, 9, -1, -1, -1, -1, -1, -1, -1},
+		{9, 10, 2, 0, 9, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{2, 3, 8, 2, 8, 10, 0, 1, 8, 1, 10, 8, -1, -1, -1, -1},
+		{1, 10, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{1, 3, 8, 9, 1, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 9, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+		{-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}};
+
+	// Corners of a cell relative to its lowest corner, in the order of the tables
+	static constexpr int32 __VoxelCornerOffsets[8][3] = {
+		{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1},
+		{0, 1, 0}, {1, 1, 0}, {1, 1, 1}, {0, 1, 1}};
+
+	static constexpr uint8 __VoxelEdgeCorners[12][2] = {
+		{0, 1}, {1, 2}, {2, 3}, {3, 0},
+		{4, 5}, {5, 6}, {6, 7}, {7, 4},
+		{0, 4}, {1, 5}, {2, 6}, {3, 7}};
+
+	// Lower corner and axis of every edge, which identifies it between the cells sharing it
+	static constexpr uint8 __VoxelEdgeKeys[12][4] = {
+		{0, 0, 0, 0}, {1, 0, 0, 2}, {0, 0, 1, 0}, {0, 0, 0, 2},
+		{0, 1, 0, 0}, {1, 1, 0, 2}, {0, 1, 1, 0}, {0, 1, 0, 2},
+		{0, 0, 0, 1}, {1, 0, 0, 1}, {1, 0, 1, 1}, {0, 0, 1, 1}};
+
 	VoxelEntity::VoxelEntity(uint32 resolutionX, uint32 resolutionY, uint32 resolutionZ) :
 		_resolutionX(resolutionX),
 		_resolutionY(resolutionY),
 		_resolutionZ(resolutionZ),
 		_surface(127),
-		_mesh(nullptr),
 		_material(nullptr)
 	{
-		_voxels = new Point[_resolutionX * _resolutionY * _resolutionZ];
+		_density = new VoxelStorage(_resolutionX, _resolutionY, _resolutionZ);
+		_smooth = new VoxelStorage(_resolutionX, _resolutionY, _resolutionZ);
 		
-		Renderer *renderer = Renderer::GetActiveRenderer();
-		_drawable = renderer->CreateDrawable();
+		InitializeChunks();
+	}
+	
+	VoxelEntity::VoxelEntity(Deserializer *deserializer) :
+		SceneNode(deserializer),
+		_material(nullptr)
+	{
+		_surface = static_cast<uint8>(deserializer->DecodeInt32());
+		_density = new VoxelStorage(deserializer);
+
+		try
+		{
+			_smooth = new VoxelStorage(deserializer);
+		}
+		catch(...)
+		{
+			delete _density;
+			throw;
+		}
+		
+		_resolutionX = _density->GetResolutionX();
+		_resolutionY = _density->GetResolutionY();
+		_resolutionZ = _density->GetResolutionZ();
+		
+		if(_smooth->GetResolutionX() != _resolutionX || _smooth->GetResolutionY() != _resolutionY || _smooth->GetResolutionZ() != _resolutionZ)
+		{
+			delete _density;
+			delete _smooth;
+			
+			throw InconsistencyException("Voxel densities and smoothed densities differ in size");
+		}
+		
+		InitializeChunks();
 	}
 	
 	VoxelEntity::~VoxelEntity()
 	{
-		delete[] _voxels;
+		delete _density;
+		delete _smooth;
 		SafeRelease(_material);
-		SafeRelease(_mesh);
 		
 		Renderer *renderer = Renderer::GetActiveRenderer();
-		renderer->DeleteDrawable(_drawable);
+		
+		for(Chunk &chunk : _chunks)
+		{
+			SafeRelease(chunk.mesh);
+			renderer->DeleteDrawable(chunk.drawable);
+		}
+	}
+	
+	void VoxelEntity::InitializeChunks()
+	{
+		static_assert(kRNVoxelEntityChunkSize % kRNVoxelStorageBrickSize == 0, "Chunks have to consist of whole bricks, so they can be updated in parallel");
+		
+		_chunksX = _resolutionX / kRNVoxelEntityChunkSize + 1;
+		_chunksY = _resolutionY / kRNVoxelEntityChunkSize + 1;
+		_chunksZ = _resolutionZ / kRNVoxelEntityChunkSize + 1;
+		
+		Renderer *renderer = Renderer::GetActiveRenderer();
+		
+		_chunks.resize(_chunksX * _chunksY * _chunksZ);
+		for(Chunk &chunk : _chunks)
+		{
+			chunk.mesh = nullptr;
+			chunk.drawable = renderer->CreateDrawable();
+			chunk.radius = 0.0f;
+			chunk.dirty = true;
+		}
+	}
+	
+	void VoxelEntity::Serialize(Serializer *serializer) const
+	{
+		SceneNode::Serialize(serializer);
+		
+		serializer->EncodeInt32(_surface);
+		_density->Serialize(serializer);
+		_smooth->Serialize(serializer);
 	}
 
 	void VoxelEntity::SetMaterial(Material *material)
@@ -47,7 +422,9 @@ namespace RN
 		if(x >= _resolutionX || y >= _resolutionY || z >= _resolutionZ)
 			return;
 		
-		_voxels[x * _resolutionY * _resolutionZ + y * _resolutionZ + z] = voxel;
+		_density->Set(x, y, z, voxel.density);
+		_smooth->Set(x, y, z, voxel.smoothDensity);
+		MarkDirty(x, y, z, x, y, z);
 	}
 	
 	uint8 VoxelEntity::GetVoxel(uint32 x, uint32 y, uint32 z) const
@@ -55,7 +432,7 @@ namespace RN
 		if(x >= _resolutionX || y >= _resolutionY || z >= _resolutionZ)
 			return 0;
 		
-		return _voxels[x * _resolutionY * _resolutionZ + y * _resolutionZ + z].density;
+		return _density->Get(x, y, z);
 	}
 	
 	uint8 VoxelEntity::GetVoxel(const Vector3 &position) const
@@ -63,7 +440,31 @@ namespace RN
 		if(position.x < 0 || position.y < 0 || position.z < 0 || position.x >= _resolutionX || position.y >= _resolutionY || position.z >= _resolutionZ)
 			return 0;
 		
-		return _voxels[static_cast<uint32>(position.x) * _resolutionY * _resolutionZ + static_cast<uint32>(position.y) * _resolutionZ + static_cast<uint32>(position.z)].density;
+		return _density->Get(static_cast<uint32>(position.x), static_cast<uint32>(position.y), static_cast<uint32>(position.z));
+	}
+	
+	void VoxelEntity::MarkDirty(int32 fromX, int32 fromY, int32 fromZ, int32 toX, int32 toY, int32 toZ)
+	{
+		fromX = std::max(fromX, 0);
+		fromY = std::max(fromY, 0);
+		fromZ = std::max(fromZ, 0);
+		toX = std::min(toX, static_cast<int32>(_resolutionX) - 1);
+		toY = std::min(toY, static_cast<int32>(_resolutionY) - 1);
+		toZ = std::min(toZ, static_cast<int32>(_resolutionZ) - 1);
+		
+		if(fromX > toX || fromY > toY || fromZ > toZ)
+			return;
+		
+		for(int32 x = fromX / kRNVoxelEntityChunkSize; x <= toX / kRNVoxelEntityChunkSize; x++)
+		{
+			for(int32 y = fromY / kRNVoxelEntityChunkSize; y <= toY / kRNVoxelEntityChunkSize; y++)
+			{
+				for(int32 z = fromZ / kRNVoxelEntityChunkSize; z <= toZ / kRNVoxelEntityChunkSize; z++)
+				{
+					_chunks[(x * _chunksY + y) * _chunksZ + z].dirty = true;
+				}
+			}
+		}
 	}
 	
 	void VoxelEntity::ApplyBlur(Vector3 from, Vector3 to, uint8 radius)
@@ -74,77 +475,94 @@ namespace RN
 		if(to.GetMax() < 0.0f)
 			to = Vector3(0.0f);
 		
-		if(from.x >= _resolutionX)
-			from.x = _resolutionX;
-		if(from.y >= _resolutionY)
-			from.y = _resolutionY;
-		if(from.z >= _resolutionZ)
-			from.z = _resolutionZ;
-		
-		if(to.x >= _resolutionX)
-			to.x = _resolutionX;
-		if(to.y >= _resolutionY)
-			to.y = _resolutionY;
-		if(to.z >= _resolutionZ)
-			to.z = _resolutionZ;
-		
 		if(from == Vector3(0.0f) && to == Vector3(0.0f))
 			to = Vector3(_resolutionX - 1.0f, _resolutionY - 1.0f, _resolutionZ - 1.0f);
 		
-		uint8 diameter = radius * 2 + 1;
-		for(int x = from.x; x <= to.x; x++)
+		const int32 fromX = std::min(static_cast<int32>(from.x), static_cast<int32>(_resolutionX) - 1);
+		const int32 fromY = std::min(static_cast<int32>(from.y), static_cast<int32>(_resolutionY) - 1);
+		const int32 fromZ = std::min(static_cast<int32>(from.z), static_cast<int32>(_resolutionZ) - 1);
+		const int32 toX = std::min(static_cast<int32>(to.x), static_cast<int32>(_resolutionX) - 1);
+		const int32 toY = std::min(static_cast<int32>(to.y), static_cast<int32>(_resolutionY) - 1);
+		const int32 toZ = std::min(static_cast<int32>(to.z), static_cast<int32>(_resolutionZ) - 1);
+		
+		Blur(fromX, fromY, fromZ, toX, toY, toZ, radius);
+	}
+	
+	void VoxelEntity::Blur(int32 fromX, int32 fromY, int32 fromZ, int32 toX, int32 toY, int32 toZ, uint8 radius)
+	{
+		if(fromX > toX || fromY > toY || fromZ > toZ)
+			return;
+		
+		const int32 resolutionX = _resolutionX;
+		const int32 resolutionY = _resolutionY;
+		const int32 resolutionZ = _resolutionZ;
+		const uint32 diameter = radius * 2 + 1;
+		
+		// Separable box blur. Every pass reads the previous one from a scratch buffer instead of blurring in place, so any
+		// part of the volume can be blurred on its own with the same result, as long as the passes still to come get a band
+		// of the radius around it.
+		const int32 minY = std::max(fromY - radius, 0);
+		const int32 maxY = std::min(toY + radius, resolutionY - 1);
+		const int32 minZ = std::max(fromZ - radius, 0);
+		const int32 maxZ = std::min(toZ + radius, resolutionZ - 1);
+		
+		const int32 sizeX = toX - fromX + 1;
+		const int32 sizeY = toY - fromY + 1;
+		const int32 bandY = maxY - minY + 1;
+		const int32 bandZ = maxZ - minZ + 1;
+		
+		std::vector<uint8> passX(sizeX * bandY * bandZ);
+		std::vector<uint8> passY(sizeX * sizeY * bandZ);
+		
+		for(int32 x = fromX; x <= toX; x++)
 		{
-			for(int y = from.y; y <= to.y; y++)
+			for(int32 y = minY; y <= maxY; y++)
 			{
-				for(int z = from.z; z <= to.z; z++)
+				for(int32 z = minZ; z <= maxZ; z++)
 				{
 					uint32 density = 0;
 					
-					for(int k = -radius; k <= radius; k++)
-					{
-						if((x + k) >= 0 && (x + k) < _resolutionX)
-							density += _voxels[(x + k) * _resolutionY * _resolutionZ + y * _resolutionZ + z].density;
-					}
-					_voxels[x * _resolutionY * _resolutionZ + y * _resolutionZ + z].smoothDensity = density / diameter;
+					for(int32 k = std::max(x - radius, 0); k <= std::min(x + radius, resolutionX - 1); k++)
+						density += _density->Get(k, y, z);
+					
+					passX[((x - fromX) * bandY + (y - minY)) * bandZ + (z - minZ)] = density / diameter;
 				}
 			}
 		}
 		
-		for(int x = from.x; x <= to.x; x++)
+		for(int32 x = fromX; x <= toX; x++)
 		{
-			for(int y = from.y; y <= to.y; y++)
+			for(int32 y = fromY; y <= toY; y++)
 			{
-				for(int z = from.z; z <= to.z; z++)
+				for(int32 z = minZ; z <= maxZ; z++)
 				{
 					uint32 density = 0;
 					
-					for(int k = -radius; k <= radius; k++)
-					{
-						if((y + k) >= 0 && (y + k) < _resolutionY)
-							density += _voxels[x * _resolutionY * _resolutionZ + (y + k) * _resolutionZ + z].smoothDensity;
-					}
-					_voxels[x * _resolutionY * _resolutionZ + y * _resolutionZ + z].smoothDensity = density / diameter;
+					for(int32 k = std::max(y - radius, 0); k <= std::min(y + radius, resolutionY - 1); k++)
+						density += passX[((x - fromX) * bandY + (k - minY)) * bandZ + (z - minZ)];
+					
+					passY[((x - fromX) * sizeY + (y - fromY)) * bandZ + (z - minZ)] = density / diameter;
 				}
 			}
 		}
 		
-		for(int x = from.x; x <= to.x; x++)
+		for(int32 x = fromX; x <= toX; x++)
 		{
-			for(int y = from.y; y <= to.y; y++)
+			for(int32 y = fromY; y <= toY; y++)
 			{
-				for(int z = from.z; z <= to.z; z++)
+				for(int32 z = fromZ; z <= toZ; z++)
 				{
 					uint32 density = 0;
 					
-					for(int k = -radius; k <= radius; k++)
-					{
-						if((z + k) >= 0 && (z + k) < _resolutionZ)
-							density += _voxels[x * _resolutionY * _resolutionZ + y * _resolutionZ + z + k].smoothDensity;
-					}
-					_voxels[x * _resolutionY * _resolutionZ + y * _resolutionZ + z].smoothDensity = density / diameter;
+					for(int32 k = std::max(z - radius, 0); k <= std::min(z + radius, resolutionZ - 1); k++)
+						density += passY[((x - fromX) * sizeY + (y - fromY)) * bandZ + (k - minZ)];
+					
+					_smooth->Set(x, y, z, density / diameter);
 				}
 			}
 		}
+		
+		_smooth->Compact(fromX, fromY, fromZ, toX, toY, toZ);
 	}
 	
 	uint8 VoxelEntity::GetSmooth(const Vector3 &position) const
@@ -152,58 +570,91 @@ namespace RN
 		if(position.x < 0 || position.y < 0 || position.z < 0 || position.x >= _resolutionX || position.y >= _resolutionY || position.z >= _resolutionZ)
 			return 0;
 		
-		return _voxels[static_cast<uint32>(position.x) * _resolutionY * _resolutionZ + static_cast<uint32>(position.y) * _resolutionZ + static_cast<uint32>(position.z)].smoothDensity;
+		return _smooth->Get(static_cast<uint32>(position.x), static_cast<uint32>(position.y), static_cast<uint32>(position.z));
 	}
 
 	void VoxelEntity::MakePlane(uint32 height)
 	{
-		for(uint32 x = 0; x < _resolutionX; x++)
+		const uint32 solid = std::min(height, _resolutionY - 1);
+		
+		_density->Fill(0, 0, 0, _resolutionX - 1, solid, _resolutionZ - 1, 255);
+		_smooth->Fill(0, 0, 0, _resolutionX - 1, solid, _resolutionZ - 1, 255);
+		
+		if(solid + 1 < _resolutionY)
 		{
-			for(uint32 y = 0; y < _resolutionY; y++)
-			{
-				for(uint32 z = 0; z < _resolutionZ; z++)
-				{
-					_voxels[x * _resolutionY * _resolutionZ + y * _resolutionZ + z] = Point((y <= height)? 255:0);
-				}
-			}
+			_density->Fill(0, solid + 1, 0, _resolutionX - 1, _resolutionY - 1, _resolutionZ - 1, 0);
+			_smooth->Fill(0, solid + 1, 0, _resolutionX - 1, _resolutionY - 1, _resolutionZ - 1, 0);
 		}
+		
+		MarkDirty(0, 0, 0, _resolutionX - 1, _resolutionY - 1, _resolutionZ - 1);
 	}
 	
 	void VoxelEntity::SetCubeLocal(Vector3 position, Vector3 size, uint32 density)
 	{
-		for(uint32 x = 0; x < _resolutionX; x++)
+		// Only the voxels around the cube are tested, one more on every side to be safe with rounding
+		const int32 fromX = std::max(static_cast<int32>(std::floor(position.x - size.x)) - 1, 0);
+		const int32 fromY = std::max(static_cast<int32>(std::floor(position.y - size.y)) - 1, 0);
+		const int32 fromZ = std::max(static_cast<int32>(std::floor(position.z - size.z)) - 1, 0);
+		const int32 toX = std::min(static_cast<int32>(std::ceil(position.x + size.x)) + 1, static_cast<int32>(_resolutionX) - 1);
+		const int32 toY = std::min(static_cast<int32>(std::ceil(position.y + size.y)) + 1, static_cast<int32>(_resolutionY) - 1);
+		const int32 toZ = std::min(static_cast<int32>(std::ceil(position.z + size.z)) + 1, static_cast<int32>(_resolutionZ) - 1);
+		
+		for(int32 x = fromX; x <= toX; x++)
 		{
-			for(uint32 y = 0; y < _resolutionY; y++)
+			for(int32 y = fromY; y <= toY; y++)
 			{
-				for(uint32 z = 0; z < _resolutionZ; z++)
+				for(int32 z = fromZ; z <= toZ; z++)
 				{
-					if(abs(x - position.x) <= size.x && abs(y - position.y) <= size.y && abs(z - position.z) <= size.z)
+					if(std::abs(x - position.x) <= size.x && std::abs(y - position.y) <= size.y && std::abs(z - position.z) <= size.z)
 					{
-						_voxels[x * _resolutionY * _resolutionZ + y * _resolutionZ + z] = Point(density);
+						_density->Set(x, y, z, static_cast<uint8>(density));
+						_smooth->Set(x, y, z, static_cast<uint8>(density));
 					}
 				}
 			}
 		}
+		
+		if(fromX > toX || fromY > toY || fromZ > toZ)
+			return;
+		
+		_density->Compact(fromX, fromY, fromZ, toX, toY, toZ);
+		_smooth->Compact(fromX, fromY, fromZ, toX, toY, toZ);
+		MarkDirty(fromX, fromY, fromZ, toX, toY, toZ);
 	}
 	
 	void VoxelEntity::SetSphereLocal(Vector3 position, float radius, uint32 density)
 	{
-		for(uint32 x = 0; x < _resolutionX; x++)
+		const int32 fromX = std::max(static_cast<int32>(std::floor(position.x - radius)) - 1, 0);
+		const int32 fromY = std::max(static_cast<int32>(std::floor(position.y - radius)) - 1, 0);
+		const int32 fromZ = std::max(static_cast<int32>(std::floor(position.z - radius)) - 1, 0);
+		const int32 toX = std::min(static_cast<int32>(std::ceil(position.x + radius)) + 1, static_cast<int32>(_resolutionX) - 1);
+		const int32 toY = std::min(static_cast<int32>(std::ceil(position.y + radius)) + 1, static_cast<int32>(_resolutionY) - 1);
+		const int32 toZ = std::min(static_cast<int32>(std::ceil(position.z + radius)) + 1, static_cast<int32>(_resolutionZ) - 1);
+		
+		for(int32 x = fromX; x <= toX; x++)
 		{
-			for(uint32 y = 0; y < _resolutionY; y++)
+			for(int32 y = fromY; y <= toY; y++)
 			{
-				for(uint32 z = 0; z < _resolutionZ; z++)
+				for(int32 z = fromZ; z <= toZ; z++)
 				{
 					float dist = Vector3(x, y, z).GetDistance(position);
 					if(dist <= radius)
 					{
 						//float factor = (radius - dist) / radius;
 						//density = _surface * (1.0f - factor) + density * factor;
-						_voxels[x * _resolutionY * _resolutionZ + y * _resolutionZ + z] = Point(density);
+						_density->Set(x, y, z, static_cast<uint8>(density));
+						_smooth->Set(x, y, z, static_cast<uint8>(density));
 					}
 				}
 			}
 		}
+		
+		if(fromX > toX || fromY > toY || fromZ > toZ)
+			return;
+		
+		_density->Compact(fromX, fromY, fromZ, toX, toY, toZ);
+		_smooth->Compact(fromX, fromY, fromZ, toX, toY, toZ);
+		MarkDirty(fromX, fromY, fromZ, toX, toY, toZ);
 	}
 	
 	void VoxelEntity::SetSphere(Vector3 position, float radius)
@@ -256,473 +707,233 @@ namespace RN
 		return p;
 	}
 
-	uint32 VoxelEntity::GetID(const Vector3 &position) const
+	void VoxelEntity::PolygonizeChunk(size_t index, ChunkGeometry &geometry) const
 	{
-		uint32 x = (position.x+1.2f);
-		uint32 y = (position.y+1.2f);
-		uint32 z = (position.z+1.2f);
+		const int32 chunkSize = kRNVoxelEntityChunkSize;
+		const int32 chunkX = static_cast<int32>(index / (_chunksY * _chunksZ));
+		const int32 chunkY = static_cast<int32>((index / _chunksZ) % _chunksY);
+		const int32 chunkZ = static_cast<int32>(index % _chunksZ);
 		
-		return x*(_resolutionY+1.0f)*(_resolutionZ+1)+y*(_resolutionZ+1)+z;
-	}
-	
-	void VoxelEntity::UpdateMesh()
-	{
-		const int edgeTable[256] = {
-			0x0  , 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
-			0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
-			0x190, 0x99 , 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
-			0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90,
-			0x230, 0x339, 0x33 , 0x13a, 0x636, 0x73f, 0x435, 0x53c,
-			0xa3c, 0xb35, 0x83f, 0x936, 0xe3a, 0xf33, 0xc39, 0xd30,
-			0x3a0, 0x2a9, 0x1a3, 0xaa , 0x7a6, 0x6af, 0x5a5, 0x4ac,
-			0xbac, 0xaa5, 0x9af, 0x8a6, 0xfaa, 0xea3, 0xda9, 0xca0,
-			0x460, 0x569, 0x663, 0x76a, 0x66 , 0x16f, 0x265, 0x36c,
-			0xc6c, 0xd65, 0xe6f, 0xf66, 0x86a, 0x963, 0xa69, 0xb60,
-			0x5f0, 0x4f9, 0x7f3, 0x6fa, 0x1f6, 0xff , 0x3f5, 0x2fc,
-			0xdfc, 0xcf5, 0xfff, 0xef6, 0x9fa, 0x8f3, 0xbf9, 0xaf0,
-			0x650, 0x759, 0x453, 0x55a, 0x256, 0x35f, 0x55 , 0x15c,
-			0xe5c, 0xf55, 0xc5f, 0xd56, 0xa5a, 0xb53, 0x859, 0x950,
-			0x7c0, 0x6c9, 0x5c3, 0x4ca, 0x3c6, 0x2cf, 0x1c5, 0xcc ,
-			0xfcc, 0xec5, 0xdcf, 0xcc6, 0xbca, 0xac3, 0x9c9, 0x8c0,
-			0x8c0, 0x9c9, 0xac3, 0xbca, 0xcc6, 0xdcf, 0xec5, 0xfcc,
-			0xcc , 0x1c5, 0x2cf, 0x3c6, 0x4ca, 0x5c3, 0x6c9, 0x7c0,
-			0x950, 0x859, 0xb53, 0xa5a, 0xd56, 0xc5f, 0xf55, 0xe5c,
-			0x15c, 0x55 , 0x35f, 0x256, 0x55a, 0x453, 0x759, 0x650,
-			0xaf0, 0xbf9, 0x8f3, 0x9fa, 0xef6, 0xfff, 0xcf5, 0xdfc,
-			0x2fc, 0x3f5, 0xff , 0x1f6, 0x6fa, 0x7f3, 0x4f9, 0x5f0,
-			0xb60, 0xa69, 0x963, 0x86a, 0xf66, 0xe6f, 0xd65, 0xc6c,
-			0x36c, 0x265, 0x16f, 0x66 , 0x76a, 0x663, 0x569, 0x460,
-			0xca0, 0xda9, 0xea3, 0xfaa, 0x8a6, 0x9af, 0xaa5, 0xbac,
-			0x4ac, 0x5a5, 0x6af, 0x7a6, 0xaa , 0x1a3, 0x2a9, 0x3a0,
-			0xd30, 0xc39, 0xf33, 0xe3a, 0x936, 0x83f, 0xb35, 0xa3c,
-			0x53c, 0x435, 0x73f, 0x636, 0x13a, 0x33 , 0x339, 0x230,
-			0xe90, 0xf99, 0xc93, 0xd9a, 0xa96, 0xb9f, 0x895, 0x99c,
-			0x69c, 0x795, 0x49f, 0x596, 0x29a, 0x393, 0x99 , 0x190,
-			0xf00, 0xe09, 0xd03, 0xc0a, 0xb06, 0xa0f, 0x905, 0x80c,
-			0x70c, 0x605, 0x50f, 0x406, 0x30a, 0x203, 0x109, 0x0};
-		
-		const int triTable[256][16] = {
-			{-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 8, 3, 9, 8, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 8, 3, 1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{9, 2, 10, 0, 2, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{2, 8, 3, 2, 10, 8, 10, 9, 8, -1, -1, -1, -1, -1, -1, -1},
-			{3, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 11, 2, 8, 11, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 9, 0, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 11, 2, 1, 9, 11, 9, 8, 11, -1, -1, -1, -1, -1, -1, -1},
-			{3, 10, 1, 11, 10, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 10, 1, 0, 8, 10, 8, 11, 10, -1, -1, -1, -1, -1, -1, -1},
-			{3, 9, 0, 3, 11, 9, 11, 10, 9, -1, -1, -1, -1, -1, -1, -1},
-			{9, 8, 10, 10, 8, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{4, 3, 0, 7, 3, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 1, 9, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{4, 1, 9, 4, 7, 1, 7, 3, 1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 2, 10, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{3, 4, 7, 3, 0, 4, 1, 2, 10, -1, -1, -1, -1, -1, -1, -1},
-			{9, 2, 10, 9, 0, 2, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1},
-			{2, 10, 9, 2, 9, 7, 2, 7, 3, 7, 9, 4, -1, -1, -1, -1},
-			{8, 4, 7, 3, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{11, 4, 7, 11, 2, 4, 2, 0, 4, -1, -1, -1, -1, -1, -1, -1},
-			{9, 0, 1, 8, 4, 7, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1},
-			{4, 7, 11, 9, 4, 11, 9, 11, 2, 9, 2, 1, -1, -1, -1, -1},
-			{3, 10, 1, 3, 11, 10, 7, 8, 4, -1, -1, -1, -1, -1, -1, -1},
-			{1, 11, 10, 1, 4, 11, 1, 0, 4, 7, 11, 4, -1, -1, -1, -1},
-			{4, 7, 8, 9, 0, 11, 9, 11, 10, 11, 0, 3, -1, -1, -1, -1},
-			{4, 7, 11, 4, 11, 9, 9, 11, 10, -1, -1, -1, -1, -1, -1, -1},
-			{9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{9, 5, 4, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 5, 4, 1, 5, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{8, 5, 4, 8, 3, 5, 3, 1, 5, -1, -1, -1, -1, -1, -1, -1},
-			{1, 2, 10, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{3, 0, 8, 1, 2, 10, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1},
-			{5, 2, 10, 5, 4, 2, 4, 0, 2, -1, -1, -1, -1, -1, -1, -1},
-			{2, 10, 5, 3, 2, 5, 3, 5, 4, 3, 4, 8, -1, -1, -1, -1},
-			{9, 5, 4, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 11, 2, 0, 8, 11, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1},
-			{0, 5, 4, 0, 1, 5, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1},
-			{2, 1, 5, 2, 5, 8, 2, 8, 11, 4, 8, 5, -1, -1, -1, -1},
-			{10, 3, 11, 10, 1, 3, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1},
-			{4, 9, 5, 0, 8, 1, 8, 10, 1, 8, 11, 10, -1, -1, -1, -1},
-			{5, 4, 0, 5, 0, 11, 5, 11, 10, 11, 0, 3, -1, -1, -1, -1},
-			{5, 4, 8, 5, 8, 10, 10, 8, 11, -1, -1, -1, -1, -1, -1, -1},
-			{9, 7, 8, 5, 7, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{9, 3, 0, 9, 5, 3, 5, 7, 3, -1, -1, -1, -1, -1, -1, -1},
-			{0, 7, 8, 0, 1, 7, 1, 5, 7, -1, -1, -1, -1, -1, -1, -1},
-			{1, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{9, 7, 8, 9, 5, 7, 10, 1, 2, -1, -1, -1, -1, -1, -1, -1},
-			{10, 1, 2, 9, 5, 0, 5, 3, 0, 5, 7, 3, -1, -1, -1, -1},
-			{8, 0, 2, 8, 2, 5, 8, 5, 7, 10, 5, 2, -1, -1, -1, -1},
-			{2, 10, 5, 2, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1},
-			{7, 9, 5, 7, 8, 9, 3, 11, 2, -1, -1, -1, -1, -1, -1, -1},
-			{9, 5, 7, 9, 7, 2, 9, 2, 0, 2, 7, 11, -1, -1, -1, -1},
-			{2, 3, 11, 0, 1, 8, 1, 7, 8, 1, 5, 7, -1, -1, -1, -1},
-			{11, 2, 1, 11, 1, 7, 7, 1, 5, -1, -1, -1, -1, -1, -1, -1},
-			{9, 5, 8, 8, 5, 7, 10, 1, 3, 10, 3, 11, -1, -1, -1, -1},
-			{5, 7, 0, 5, 0, 9, 7, 11, 0, 1, 0, 10, 11, 10, 0, -1},
-			{11, 10, 0, 11, 0, 3, 10, 5, 0, 8, 0, 7, 5, 7, 0, -1},
-			{11, 10, 5, 7, 11, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{10, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 8, 3, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{9, 0, 1, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 8, 3, 1, 9, 8, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1},
-			{1, 6, 5, 2, 6, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 6, 5, 1, 2, 6, 3, 0, 8, -1, -1, -1, -1, -1, -1, -1},
-			{9, 6, 5, 9, 0, 6, 0, 2, 6, -1, -1, -1, -1, -1, -1, -1},
-			{5, 9, 8, 5, 8, 2, 5, 2, 6, 3, 2, 8, -1, -1, -1, -1},
-			{2, 3, 11, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{11, 0, 8, 11, 2, 0, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1},
-			{0, 1, 9, 2, 3, 11, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1},
-			{5, 10, 6, 1, 9, 2, 9, 11, 2, 9, 8, 11, -1, -1, -1, -1},
-			{6, 3, 11, 6, 5, 3, 5, 1, 3, -1, -1, -1, -1, -1, -1, -1},
-			{0, 8, 11, 0, 11, 5, 0, 5, 1, 5, 11, 6, -1, -1, -1, -1},
-			{3, 11, 6, 0, 3, 6, 0, 6, 5, 0, 5, 9, -1, -1, -1, -1},
-			{6, 5, 9, 6, 9, 11, 11, 9, 8, -1, -1, -1, -1, -1, -1, -1},
-			{5, 10, 6, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{4, 3, 0, 4, 7, 3, 6, 5, 10, -1, -1, -1, -1, -1, -1, -1},
-			{1, 9, 0, 5, 10, 6, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1},
-			{10, 6, 5, 1, 9, 7, 1, 7, 3, 7, 9, 4, -1, -1, -1, -1},
-			{6, 1, 2, 6, 5, 1, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1},
-			{1, 2, 5, 5, 2, 6, 3, 0, 4, 3, 4, 7, -1, -1, -1, -1},
-			{8, 4, 7, 9, 0, 5, 0, 6, 5, 0, 2, 6, -1, -1, -1, -1},
-			{7, 3, 9, 7, 9, 4, 3, 2, 9, 5, 9, 6, 2, 6, 9, -1},
-			{3, 11, 2, 7, 8, 4, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1},
-			{5, 10, 6, 4, 7, 2, 4, 2, 0, 2, 7, 11, -1, -1, -1, -1},
-			{0, 1, 9, 4, 7, 8, 2, 3, 11, 5, 10, 6, -1, -1, -1, -1},
-			{9, 2, 1, 9, 11, 2, 9, 4, 11, 7, 11, 4, 5, 10, 6, -1},
-			{8, 4, 7, 3, 11, 5, 3, 5, 1, 5, 11, 6, -1, -1, -1, -1},
-			{5, 1, 11, 5, 11, 6, 1, 0, 11, 7, 11, 4, 0, 4, 11, -1},
-			{0, 5, 9, 0, 6, 5, 0, 3, 6, 11, 6, 3, 8, 4, 7, -1},
-			{6, 5, 9, 6, 9, 11, 4, 7, 9, 7, 11, 9, -1, -1, -1, -1},
-			{10, 4, 9, 6, 4, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{4, 10, 6, 4, 9, 10, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1},
-			{10, 0, 1, 10, 6, 0, 6, 4, 0, -1, -1, -1, -1, -1, -1, -1},
-			{8, 3, 1, 8, 1, 6, 8, 6, 4, 6, 1, 10, -1, -1, -1, -1},
-			{1, 4, 9, 1, 2, 4, 2, 6, 4, -1, -1, -1, -1, -1, -1, -1},
-			{3, 0, 8, 1, 2, 9, 2, 4, 9, 2, 6, 4, -1, -1, -1, -1},
-			{0, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{8, 3, 2, 8, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1},
-			{10, 4, 9, 10, 6, 4, 11, 2, 3, -1, -1, -1, -1, -1, -1, -1},
-			{0, 8, 2, 2, 8, 11, 4, 9, 10, 4, 10, 6, -1, -1, -1, -1},
-			{3, 11, 2, 0, 1, 6, 0, 6, 4, 6, 1, 10, -1, -1, -1, -1},
-			{6, 4, 1, 6, 1, 10, 4, 8, 1, 2, 1, 11, 8, 11, 1, -1},
-			{9, 6, 4, 9, 3, 6, 9, 1, 3, 11, 6, 3, -1, -1, -1, -1},
-			{8, 11, 1, 8, 1, 0, 11, 6, 1, 9, 1, 4, 6, 4, 1, -1},
-			{3, 11, 6, 3, 6, 0, 0, 6, 4, -1, -1, -1, -1, -1, -1, -1},
-			{6, 4, 8, 11, 6, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{7, 10, 6, 7, 8, 10, 8, 9, 10, -1, -1, -1, -1, -1, -1, -1},
-			{0, 7, 3, 0, 10, 7, 0, 9, 10, 6, 7, 10, -1, -1, -1, -1},
-			{10, 6, 7, 1, 10, 7, 1, 7, 8, 1, 8, 0, -1, -1, -1, -1},
-			{10, 6, 7, 10, 7, 1, 1, 7, 3, -1, -1, -1, -1, -1, -1, -1},
-			{1, 2, 6, 1, 6, 8, 1, 8, 9, 8, 6, 7, -1, -1, -1, -1},
-			{2, 6, 9, 2, 9, 1, 6, 7, 9, 0, 9, 3, 7, 3, 9, -1},
-			{7, 8, 0, 7, 0, 6, 6, 0, 2, -1, -1, -1, -1, -1, -1, -1},
-			{7, 3, 2, 6, 7, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{2, 3, 11, 10, 6, 8, 10, 8, 9, 8, 6, 7, -1, -1, -1, -1},
-			{2, 0, 7, 2, 7, 11, 0, 9, 7, 6, 7, 10, 9, 10, 7, -1},
-			{1, 8, 0, 1, 7, 8, 1, 10, 7, 6, 7, 10, 2, 3, 11, -1},
-			{11, 2, 1, 11, 1, 7, 10, 6, 1, 6, 7, 1, -1, -1, -1, -1},
-			{8, 9, 6, 8, 6, 7, 9, 1, 6, 11, 6, 3, 1, 3, 6, -1},
-			{0, 9, 1, 11, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{7, 8, 0, 7, 0, 6, 3, 11, 0, 11, 6, 0, -1, -1, -1, -1},
-			{7, 11, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{7, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{3, 0, 8, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 1, 9, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{8, 1, 9, 8, 3, 1, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1},
-			{10, 1, 2, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 2, 10, 3, 0, 8, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1},
-			{2, 9, 0, 2, 10, 9, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1},
-			{6, 11, 7, 2, 10, 3, 10, 8, 3, 10, 9, 8, -1, -1, -1, -1},
-			{7, 2, 3, 6, 2, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{7, 0, 8, 7, 6, 0, 6, 2, 0, -1, -1, -1, -1, -1, -1, -1},
-			{2, 7, 6, 2, 3, 7, 0, 1, 9, -1, -1, -1, -1, -1, -1, -1},
-			{1, 6, 2, 1, 8, 6, 1, 9, 8, 8, 7, 6, -1, -1, -1, -1},
-			{10, 7, 6, 10, 1, 7, 1, 3, 7, -1, -1, -1, -1, -1, -1, -1},
-			{10, 7, 6, 1, 7, 10, 1, 8, 7, 1, 0, 8, -1, -1, -1, -1},
-			{0, 3, 7, 0, 7, 10, 0, 10, 9, 6, 10, 7, -1, -1, -1, -1},
-			{7, 6, 10, 7, 10, 8, 8, 10, 9, -1, -1, -1, -1, -1, -1, -1},
-			{6, 8, 4, 11, 8, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{3, 6, 11, 3, 0, 6, 0, 4, 6, -1, -1, -1, -1, -1, -1, -1},
-			{8, 6, 11, 8, 4, 6, 9, 0, 1, -1, -1, -1, -1, -1, -1, -1},
-			{9, 4, 6, 9, 6, 3, 9, 3, 1, 11, 3, 6, -1, -1, -1, -1},
-			{6, 8, 4, 6, 11, 8, 2, 10, 1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 2, 10, 3, 0, 11, 0, 6, 11, 0, 4, 6, -1, -1, -1, -1},
-			{4, 11, 8, 4, 6, 11, 0, 2, 9, 2, 10, 9, -1, -1, -1, -1},
-			{10, 9, 3, 10, 3, 2, 9, 4, 3, 11, 3, 6, 4, 6, 3, -1},
-			{8, 2, 3, 8, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1},
-			{0, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 9, 0, 2, 3, 4, 2, 4, 6, 4, 3, 8, -1, -1, -1, -1},
-			{1, 9, 4, 1, 4, 2, 2, 4, 6, -1, -1, -1, -1, -1, -1, -1},
-			{8, 1, 3, 8, 6, 1, 8, 4, 6, 6, 10, 1, -1, -1, -1, -1},
-			{10, 1, 0, 10, 0, 6, 6, 0, 4, -1, -1, -1, -1, -1, -1, -1},
-			{4, 6, 3, 4, 3, 8, 6, 10, 3, 0, 3, 9, 10, 9, 3, -1},
-			{10, 9, 4, 6, 10, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{4, 9, 5, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 8, 3, 4, 9, 5, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1},
-			{5, 0, 1, 5, 4, 0, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1},
-			{11, 7, 6, 8, 3, 4, 3, 5, 4, 3, 1, 5, -1, -1, -1, -1},
-			{9, 5, 4, 10, 1, 2, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1},
-			{6, 11, 7, 1, 2, 10, 0, 8, 3, 4, 9, 5, -1, -1, -1, -1},
-			{7, 6, 11, 5, 4, 10, 4, 2, 10, 4, 0, 2, -1, -1, -1, -1},
-			{3, 4, 8, 3, 5, 4, 3, 2, 5, 10, 5, 2, 11, 7, 6, -1},
-			{7, 2, 3, 7, 6, 2, 5, 4, 9, -1, -1, -1, -1, -1, -1, -1},
-			{9, 5, 4, 0, 8, 6, 0, 6, 2, 6, 8, 7, -1, -1, -1, -1},
-			{3, 6, 2, 3, 7, 6, 1, 5, 0, 5, 4, 0, -1, -1, -1, -1},
-			{6, 2, 8, 6, 8, 7, 2, 1, 8, 4, 8, 5, 1, 5, 8, -1},
-			{9, 5, 4, 10, 1, 6, 1, 7, 6, 1, 3, 7, -1, -1, -1, -1},
-			{1, 6, 10, 1, 7, 6, 1, 0, 7, 8, 7, 0, 9, 5, 4, -1},
-			{4, 0, 10, 4, 10, 5, 0, 3, 10, 6, 10, 7, 3, 7, 10, -1},
-			{7, 6, 10, 7, 10, 8, 5, 4, 10, 4, 8, 10, -1, -1, -1, -1},
-			{6, 9, 5, 6, 11, 9, 11, 8, 9, -1, -1, -1, -1, -1, -1, -1},
-			{3, 6, 11, 0, 6, 3, 0, 5, 6, 0, 9, 5, -1, -1, -1, -1},
-			{0, 11, 8, 0, 5, 11, 0, 1, 5, 5, 6, 11, -1, -1, -1, -1},
-			{6, 11, 3, 6, 3, 5, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 2, 10, 9, 5, 11, 9, 11, 8, 11, 5, 6, -1, -1, -1, -1},
-			{0, 11, 3, 0, 6, 11, 0, 9, 6, 5, 6, 9, 1, 2, 10, -1},
-			{11, 8, 5, 11, 5, 6, 8, 0, 5, 10, 5, 2, 0, 2, 5, -1},
-			{6, 11, 3, 6, 3, 5, 2, 10, 3, 10, 5, 3, -1, -1, -1, -1},
-			{5, 8, 9, 5, 2, 8, 5, 6, 2, 3, 8, 2, -1, -1, -1, -1},
-			{9, 5, 6, 9, 6, 0, 0, 6, 2, -1, -1, -1, -1, -1, -1, -1},
-			{1, 5, 8, 1, 8, 0, 5, 6, 8, 3, 8, 2, 6, 2, 8, -1},
-			{1, 5, 6, 2, 1, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 3, 6, 1, 6, 10, 3, 8, 6, 5, 6, 9, 8, 9, 6, -1},
-			{10, 1, 0, 10, 0, 6, 9, 5, 0, 5, 6, 0, -1, -1, -1, -1},
-			{0, 3, 8, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{10, 5, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{11, 5, 10, 7, 5, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{11, 5, 10, 11, 7, 5, 8, 3, 0, -1, -1, -1, -1, -1, -1, -1},
-			{5, 11, 7, 5, 10, 11, 1, 9, 0, -1, -1, -1, -1, -1, -1, -1},
-			{10, 7, 5, 10, 11, 7, 9, 8, 1, 8, 3, 1, -1, -1, -1, -1},
-			{11, 1, 2, 11, 7, 1, 7, 5, 1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 8, 3, 1, 2, 7, 1, 7, 5, 7, 2, 11, -1, -1, -1, -1},
-			{9, 7, 5, 9, 2, 7, 9, 0, 2, 2, 11, 7, -1, -1, -1, -1},
-			{7, 5, 2, 7, 2, 11, 5, 9, 2, 3, 2, 8, 9, 8, 2, -1},
-			{2, 5, 10, 2, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1},
-			{8, 2, 0, 8, 5, 2, 8, 7, 5, 10, 2, 5, -1, -1, -1, -1},
-			{9, 0, 1, 5, 10, 3, 5, 3, 7, 3, 10, 2, -1, -1, -1, -1},
-			{9, 8, 2, 9, 2, 1, 8, 7, 2, 10, 2, 5, 7, 5, 2, -1},
-			{1, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 8, 7, 0, 7, 1, 1, 7, 5, -1, -1, -1, -1, -1, -1, -1},
-			{9, 0, 3, 9, 3, 5, 5, 3, 7, -1, -1, -1, -1, -1, -1, -1},
-			{9, 8, 7, 5, 9, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{5, 8, 4, 5, 10, 8, 10, 11, 8, -1, -1, -1, -1, -1, -1, -1},
-			{5, 0, 4, 5, 11, 0, 5, 10, 11, 11, 3, 0, -1, -1, -1, -1},
-			{0, 1, 9, 8, 4, 10, 8, 10, 11, 10, 4, 5, -1, -1, -1, -1},
-			{10, 11, 4, 10, 4, 5, 11, 3, 4, 9, 4, 1, 3, 1, 4, -1},
-			{2, 5, 1, 2, 8, 5, 2, 11, 8, 4, 5, 8, -1, -1, -1, -1},
-			{0, 4, 11, 0, 11, 3, 4, 5, 11, 2, 11, 1, 5, 1, 11, -1},
-			{0, 2, 5, 0, 5, 9, 2, 11, 5, 4, 5, 8, 11, 8, 5, -1},
-			{9, 4, 5, 2, 11, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{2, 5, 10, 3, 5, 2, 3, 4, 5, 3, 8, 4, -1, -1, -1, -1},
-			{5, 10, 2, 5, 2, 4, 4, 2, 0, -1, -1, -1, -1, -1, -1, -1},
-			{3, 10, 2, 3, 5, 10, 3, 8, 5, 4, 5, 8, 0, 1, 9, -1},
-			{5, 10, 2, 5, 2, 4, 1, 9, 2, 9, 4, 2, -1, -1, -1, -1},
-			{8, 4, 5, 8, 5, 3, 3, 5, 1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 4, 5, 1, 0, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{8, 4, 5, 8, 5, 3, 9, 0, 5, 0, 3, 5, -1, -1, -1, -1},
-			{9, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{4, 11, 7, 4, 9, 11, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1},
-			{0, 8, 3, 4, 9, 7, 9, 11, 7, 9, 10, 11, -1, -1, -1, -1},
-			{1, 10, 11, 1, 11, 4, 1, 4, 0, 7, 4, 11, -1, -1, -1, -1},
-			{3, 1, 4, 3, 4, 8, 1, 10, 4, 7, 4, 11, 10, 11, 4, -1},
-			{4, 11, 7, 9, 11, 4, 9, 2, 11, 9, 1, 2, -1, -1, -1, -1},
-			{9, 7, 4, 9, 11, 7, 9, 1, 11, 2, 11, 1, 0, 8, 3, -1},
-			{11, 7, 4, 11, 4, 2, 2, 4, 0, -1, -1, -1, -1, -1, -1, -1},
-			{11, 7, 4, 11, 4, 2, 8, 3, 4, 3, 2, 4, -1, -1, -1, -1},
-			{2, 9, 10, 2, 7, 9, 2, 3, 7, 7, 4, 9, -1, -1, -1, -1},
-			{9, 10, 7, 9, 7, 4, 10, 2, 7, 8, 7, 0, 2, 0, 7, -1},
-			{3, 7, 10, 3, 10, 2, 7, 4, 10, 1, 10, 0, 4, 0, 10, -1},
-			{1, 10, 2, 8, 7, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{4, 9, 1, 4, 1, 7, 7, 1, 3, -1, -1, -1, -1, -1, -1, -1},
-			{4, 9, 1, 4, 1, 7, 0, 8, 1, 8, 7, 1, -1, -1, -1, -1},
-			{4, 0, 3, 7, 4, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{4, 8, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{9, 10, 8, 10, 11, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{3, 0, 9, 3, 9, 11, 11, 9, 10, -1, -1, -1, -1, -1, -1, -1},
-			{0, 1, 10, 0, 10, 8, 8, 10, 11, -1, -1, -1, -1, -1, -1, -1},
-			{3, 1, 10, 11, 3, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 2, 11, 1, 11, 9, 9, 11, 8, -1, -1, -1, -1, -1, -1, -1},
-			{3, 0, 9, 3, 9, 11, 1, 2, 9, 2, 11, 9, -1, -1, -1, -1},
-			{0, 2, 11, 8, 0, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{3, 2, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{2, 3, 8, 2, 8, 10, 10, 8, 9, -1, -1, -1, -1, -1, -1, -1},
-			{9, 10, 2, 0, 9, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{2, 3, 8, 2, 8, 10, 0, 1, 8, 1, 10, 8, -1, -1, -1, -1},
-			{1, 10, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{1, 3, 8, 9, 1, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 9, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-			{-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}};
-		
-		std::vector<Vector3> vertices;
-		std::unordered_map<std::pair<uint32, uint32>, uint32, __LookupHashMarchingCubes, __LookupCompareMarchingCubes> indexLookup;
-		std::vector<uint32> indices;
-		
-		Vector3 halfResolution(_resolutionX * 0.5f, _resolutionY * 0.5f, _resolutionZ * 0.5f);
-		
-		ApplyBlur(Vector3(0.0f), Vector3(0.0f), 2);
-		
-		for(uint32 x = 0; x <= _resolutionX; x++)
+		// The cell at x spans the voxels x-1 and x. The cells of the chunk are followed by a ring of their neighbours,
+		// whose triangles aren't kept but make the normals at the chunk border match the ones of the next chunk.
+		const int32 cellX = chunkX * chunkSize;
+		const int32 cellY = chunkY * chunkSize;
+		const int32 cellZ = chunkZ * chunkSize;
+		const int32 cellEndX = std::min(cellX + chunkSize, static_cast<int32>(_resolutionX) + 1);
+		const int32 cellEndY = std::min(cellY + chunkSize, static_cast<int32>(_resolutionY) + 1);
+		const int32 cellEndZ = std::min(cellZ + chunkSize, static_cast<int32>(_resolutionZ) + 1);
+		
+		// Smoothed densities of all corners, including the ring, with everything outside the volume being empty
+		const int32 originX = cellX - 2;
+		const int32 originY = cellY - 2;
+		const int32 originZ = cellZ - 2;
+		const int32 samples = chunkSize + 3;
+		
+		std::vector<uint8> densities(samples * samples * samples);
+		
+		for(int32 x = 0; x < samples; x++)
 		{
-			for(uint32 y = 0; y <= _resolutionY; y++)
+			for(int32 y = 0; y < samples; y++)
 			{
-				for(uint32 z = 0; z <= _resolutionZ; z++)
+				for(int32 z = 0; z < samples; z++)
 				{
-					Vector3 pos00 = RN::Vector3(x-1, y-1, z-1);
-					Vector3 pos01 = RN::Vector3(x, y-1, z-1);
-					Vector3 pos02 = RN::Vector3(x, y-1, z);
-					Vector3 pos03 = RN::Vector3(x-1, y-1, z);
+					const int32 voxelX = originX + x;
+					const int32 voxelY = originY + y;
+					const int32 voxelZ = originZ + z;
+					
+					uint8 density = 0;
+					if(voxelX >= 0 && voxelY >= 0 && voxelZ >= 0 && voxelX < static_cast<int32>(_resolutionX) && voxelY < static_cast<int32>(_resolutionY) && voxelZ < static_cast<int32>(_resolutionZ))
+						density = _smooth->Get(voxelX, voxelY, voxelZ);
 					
-					Vector3 pos10 = RN::Vector3(x-1, y, z-1);
-					Vector3 pos11 = RN::Vector3(x, y, z-1);
-					Vector3 pos12 = RN::Vector3(x, y, z);
-					Vector3 pos13 = RN::Vector3(x-1, y, z);
+					densities[(x * samples + y) * samples + z] = density;
+				}
+			}
+		}
+		
+		// Vertex index per edge, edges are stored at their lower corner with one slot per axis
+		std::vector<uint32> edgeCache(samples * samples * samples * 3, static_cast<uint32>(-1));
+		
+		const Vector3 halfResolution(_resolutionX * 0.5f, _resolutionY * 0.5f, _resolutionZ * 0.5f);
+		
+		auto polygonize = [&](int32 x, int32 y, int32 z, bool inner) {
+			const int32 localX = x - 1 - originX;
+			const int32 localY = y - 1 - originY;
+			const int32 localZ = z - 1 - originZ;
+			
+			uint8 values[8];
+			int cubeindex = 0;
+			
+			for(int32 i = 0; i < 8; i++)
+			{
+				values[i] = densities[((localX + __VoxelCornerOffsets[i][0]) * samples + localY + __VoxelCornerOffsets[i][1]) * samples + localZ + __VoxelCornerOffsets[i][2]];
+				if(values[i] > _surface) cubeindex |= (1 << i);
+			}
+			
+			/* Cube is entirely in/out of the surface */
+			if(__VoxelEdgeTable[cubeindex] == 0)
+				return;
+			
+			uint32 triangle[3];
+			
+			for(int32 i = 0; __VoxelTriangleTable[cubeindex][i] != -1; i++)
+			{
+				const int32 edge = __VoxelTriangleTable[cubeindex][i];
+				const uint8 *key = __VoxelEdgeKeys[edge];
+				
+				uint32 &vertex = edgeCache[(((localX + key[0]) * samples + localY + key[1]) * samples + localZ + key[2]) * 3 + key[3]];
+				
+				if(vertex == static_cast<uint32>(-1))
+				{
+					const int32 *corner1 = __VoxelCornerOffsets[__VoxelEdgeCorners[edge][0]];
+					const int32 *corner2 = __VoxelCornerOffsets[__VoxelEdgeCorners[edge][1]];
 					
-					uint8 v00 = GetSmooth(pos00);
-					uint8 v01 = GetSmooth(pos01);
-					uint8 v02 = GetSmooth(pos02);
-					uint8 v03 = GetSmooth(pos03);
+					const Vector3 position1(x - 1 + corner1[0], y - 1 + corner1[1], z - 1 + corner1[2]);
+					const Vector3 position2(x - 1 + corner2[0], y - 1 + corner2[1], z - 1 + corner2[2]);
 					
-					uint8 v10 = GetSmooth(pos10);
-					uint8 v11 = GetSmooth(pos11);
-					uint8 v12 = GetSmooth(pos12);
-					uint8 v13 = GetSmooth(pos13);
+					vertex = static_cast<uint32>(geometry.vertices.size());
+					geometry.vertices.push_back(LerpSurface(position1, position2, values[__VoxelEdgeCorners[edge][0]], values[__VoxelEdgeCorners[edge][1]]) - halfResolution);
+					geometry.normals.push_back(Vector3(0.0f));
+				}
+				
+				triangle[i % 3] = vertex;
+				
+				if(i % 3 == 2)
+				{
+					const Vector3 &vertex0 = geometry.vertices[triangle[0]];
+					const Vector3 &vertex1 = geometry.vertices[triangle[1]];
+					const Vector3 &vertex2 = geometry.vertices[triangle[2]];
 					
-					int cubeindex = 0;
-					if(v00 > _surface) cubeindex |= 1;
-					if(v01 > _surface) cubeindex |= 2;
-					if(v02 > _surface) cubeindex |= 4;
-					if(v03 > _surface) cubeindex |= 8;
-					if(v10 > _surface) cubeindex |= 16;
-					if(v11 > _surface) cubeindex |= 32;
-					if(v12 > _surface) cubeindex |= 64;
-					if(v13 > _surface) cubeindex |= 128;
+					Vector3 normal = (vertex0 - vertex2).GetCrossProduct(vertex1 - vertex2).GetNormalized();
+					geometry.normals[triangle[0]] += normal;
+					geometry.normals[triangle[1]] += normal;
+					geometry.normals[triangle[2]] += normal;
 					
-					/* Cube is entirely in/out of the surface */
-					if(edgeTable[cubeindex] == 0)
+					if(inner)
+						geometry.indices.insert(geometry.indices.end(), triangle, triangle + 3);
+				}
+			}
+		};
+		
+		for(int32 x = cellX; x < cellEndX; x++)
+		{
+			for(int32 y = cellY; y < cellEndY; y++)
+			{
+				for(int32 z = cellZ; z < cellEndZ; z++)
+					polygonize(x, y, z, true);
+			}
+		}
+		
+		// Vertices the ring adds only belong to the neighbours
+		const size_t chunkVertices = geometry.vertices.size();
+		
+		for(int32 x = cellX - 1; x <= cellEndX; x++)
+		{
+			for(int32 y = cellY - 1; y <= cellEndY; y++)
+			{
+				for(int32 z = cellZ - 1; z <= cellEndZ; z++)
+				{
+					if(x >= cellX && x < cellEndX && y >= cellY && y < cellEndY && z >= cellZ && z < cellEndZ)
 						continue;
 					
-					Vector3 vertlist[12];
-					std::pair<uint32, uint32> vertLookup[12];
-					
-					/* Find the vertices where the surface intersects the cube */
-					if(edgeTable[cubeindex] & 1)
-					{
-						vertlist[0] = LerpSurface(pos00, pos01, v00, v01);
-						vertLookup[0] = std::make_pair(GetID(pos00), GetID(pos01));
-					}
-					if(edgeTable[cubeindex] & 2)
-					{
-						vertlist[1] = LerpSurface(pos01, pos02, v01, v02);
-						vertLookup[1] = std::make_pair(GetID(pos01), GetID(pos02));
-					}
-					if(edgeTable[cubeindex] & 4)
-					{
-						vertlist[2] = LerpSurface(pos02, pos03, v02, v03);
-						vertLookup[2] = std::make_pair(GetID(pos02), GetID(pos03));
-					}
-					if(edgeTable[cubeindex] & 8)
-					{
-						vertlist[3] = LerpSurface(pos03, pos00, v03, v00);
-						vertLookup[3] = std::make_pair(GetID(pos03), GetID(pos00));
-					}
-					if(edgeTable[cubeindex] & 16)
-					{
-						vertlist[4] = LerpSurface(pos10, pos11, v10, v11);
-						vertLookup[4] = std::make_pair(GetID(pos10), GetID(pos11));
-					}
-					if(edgeTable[cubeindex] & 32)
-					{
-						vertlist[5] = LerpSurface(pos11, pos12, v11, v12);
-						vertLookup[5] = std::make_pair(GetID(pos11), GetID(pos12));
-					}
-					if(edgeTable[cubeindex] & 64)
-					{
-						vertlist[6] = LerpSurface(pos12, pos13, v12, v13);
-						vertLookup[6] = std::make_pair(GetID(pos12), GetID(pos13));
-					}
-					if(edgeTable[cubeindex] & 128)
-					{
-						vertlist[7] = LerpSurface(pos13, pos10, v13, v10);
-						vertLookup[7] = std::make_pair(GetID(pos13), GetID(pos10));
-					}
-					if(edgeTable[cubeindex] & 256)
-					{
-						vertlist[8] = LerpSurface(pos00, pos10, v00, v10);
-						vertLookup[8] = std::make_pair(GetID(pos00), GetID(pos10));
-					}
-					if(edgeTable[cubeindex] & 512)
-					{
-						vertlist[9] = LerpSurface(pos01, pos11, v01, v11);
-						vertLookup[9] = std::make_pair(GetID(pos01), GetID(pos11));
-					}
-					if(edgeTable[cubeindex] & 1024)
-					{
-						vertlist[10] = LerpSurface(pos02, pos12, v02, v12);
-						vertLookup[10] = std::make_pair(GetID(pos02), GetID(pos12));
-					}
-					if(edgeTable[cubeindex] & 2048)
-					{
-						vertlist[11] = LerpSurface(pos03, pos13, v03, v13);
-						vertLookup[11] = std::make_pair(GetID(pos03), GetID(pos13));
-					}
+					polygonize(x, y, z, false);
+				}
+			}
+		}
+		
+		geometry.vertices.resize(chunkVertices);
+		geometry.normals.resize(chunkVertices);
+	}
+	
+	void VoxelEntity::UpdateChunkMesh(Chunk &chunk, const ChunkGeometry &geometry)
+	{
+		SafeRelease(chunk.mesh);
+		
+		if(geometry.indices.empty())
+			return;
+		
+		Vector3 min = geometry.vertices[0];
+		Vector3 max = geometry.vertices[0];
+		
+		for(const Vector3 &vertex : geometry.vertices)
+		{
+			min = Vector3(std::min(min.x, vertex.x), std::min(min.y, vertex.y), std::min(min.z, vertex.z));
+			max = Vector3(std::max(max.x, vertex.x), std::max(max.y, vertex.y), std::max(max.z, vertex.z));
+		}
+		
+		chunk.center = (min + max) * 0.5f;
+		chunk.radius = (max - min).GetLength() * 0.5f;
+		
+		chunk.mesh = new Mesh({ Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::Vertices, PrimitiveType::Vector3),
+			Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::Normals, PrimitiveType::Vector3),
+			Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::Indices, PrimitiveType::Uint32) }, geometry.vertices.size(), geometry.indices.size());
+		
+		chunk.mesh->BeginChanges();
+		chunk.mesh->SetElementData(Mesh::VertexAttribute::Feature::Vertices, geometry.vertices.data());
+		chunk.mesh->SetElementData(Mesh::VertexAttribute::Feature::Normals, geometry.normals.data());
+		chunk.mesh->SetElementData(Mesh::VertexAttribute::Feature::Indices, geometry.indices.data());
+		chunk.mesh->EndChanges();
+	}
+	
+	void VoxelEntity::UpdateMesh()
+	{
+		// An edit changes the smoothed densities up to the blur radius away and the cells touching those, plus the normals
+		// of the cells next to them. That never reaches further than the neighbouring chunks.
+		std::vector<size_t> dirty;
+		
+		for(uint32 x = 0; x < _chunksX; x++)
+		{
+			for(uint32 y = 0; y < _chunksY; y++)
+			{
+				for(uint32 z = 0; z < _chunksZ; z++)
+				{
+					bool needsUpdate = false;
 					
-					for(int i = 0; triTable[cubeindex][i] != -1; i++)
+					for(uint32 nx = std::max(x, 1u) - 1; nx <= std::min(x + 1, _chunksX - 1) && !needsUpdate; nx++)
 					{
-						auto index0 = indexLookup.find(vertLookup[triTable[cubeindex][i]]);
-						if(index0 != indexLookup.end())
+						for(uint32 ny = std::max(y, 1u) - 1; ny <= std::min(y + 1, _chunksY - 1) && !needsUpdate; ny++)
 						{
-							indices.push_back(index0->second);
-						}
-						else
-						{
-							indexLookup[vertLookup[triTable[cubeindex][i]]] = static_cast<uint32>(vertices.size());
-							indices.push_back(static_cast<uint32>(vertices.size()));
-							vertices.push_back(vertlist[triTable[cubeindex][i]] - halfResolution);
+							for(uint32 nz = std::max(z, 1u) - 1; nz <= std::min(z + 1, _chunksZ - 1) && !needsUpdate; nz++)
+								needsUpdate = _chunks[(nx * _chunksY + ny) * _chunksZ + nz].dirty;
 						}
 					}
+					
+					if(needsUpdate)
+						dirty.push_back((x * _chunksY + y) * _chunksZ + z);
 				}
 			}
 		}
 		
-		SafeRelease(_mesh);
-		_mesh = new Mesh({ Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::Vertices, PrimitiveType::Vector3),
-			Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::Normals, PrimitiveType::Vector3),
-			Mesh::VertexAttribute(Mesh::VertexAttribute::Feature::Indices, PrimitiveType::Uint32) }, vertices.size(), indices.size());
+		if(dirty.empty())
+			return;
 		
-		_mesh->BeginChanges();
-		Mesh::Chunk chunk = _mesh->GetChunk();
+		// Every chunk blurs its own voxels, which are whole storage bricks, so the jobs never write the same ones
+		ParallelFor(Range(0, dirty.size()), 1, [&](size_t i) {
+			const int32 chunkX = static_cast<int32>(dirty[i] / (_chunksY * _chunksZ));
+			const int32 chunkY = static_cast<int32>((dirty[i] / _chunksZ) % _chunksY);
+			const int32 chunkZ = static_cast<int32>(dirty[i] % _chunksZ);
+			
+			const int32 fromX = chunkX * kRNVoxelEntityChunkSize;
+			const int32 fromY = chunkY * kRNVoxelEntityChunkSize;
+			const int32 fromZ = chunkZ * kRNVoxelEntityChunkSize;
+			
+			Blur(fromX, fromY, fromZ,
+				 std::min(fromX + kRNVoxelEntityChunkSize, static_cast<int32>(_resolutionX)) - 1,
+				 std::min(fromY + kRNVoxelEntityChunkSize, static_cast<int32>(_resolutionY)) - 1,
+				 std::min(fromZ + kRNVoxelEntityChunkSize, static_cast<int32>(_resolutionZ)) - 1, kRNVoxelEntityBlurRadius);
+		});
 		
-		Mesh::ElementIterator<Vector3> vertexIterator = chunk.GetIterator<Vector3>(Mesh::VertexAttribute::Feature::Vertices);
-		Mesh::ElementIterator<Vector3> normalsIterator = chunk.GetIterator<Vector3>(Mesh::VertexAttribute::Feature::Normals);
-		Mesh::ElementIterator<uint32> indexIterator = chunk.GetIterator<uint32>(Mesh::VertexAttribute::Feature::Indices);
+		std::vector<ChunkGeometry> geometry(dirty.size());
 		
-		for(int i = 0; i < vertices.size(); i++)
-		{
-			*vertexIterator++ = vertices[i];
-			*normalsIterator++ = Vector3(0.0f);
-		}
+		ParallelFor(Range(0, dirty.size()), 1, [&](size_t i) {
+			PolygonizeChunk(dirty[i], geometry[i]);
+		});
 		
-		for(int i = 0; i < indices.size(); i += 3)
-		{
-			Vector3 normal = (vertices[indices[i]]-vertices[indices[i+2]]).GetCrossProduct(vertices[indices[i+1]]-vertices[indices[i+2]]).GetNormalized();
-			*normalsIterator.Seek(indices[i]) += normal;
-			*normalsIterator.Seek(indices[i+1]) += normal;
-			*normalsIterator.Seek(indices[i+2]) += normal;
-			
-			*indexIterator++ = indices[i];
-			*indexIterator++ = indices[i+1];
-			*indexIterator++ = indices[i+2];
-		}
+		// Meshes are only created on the calling thread
+		for(size_t i = 0; i < dirty.size(); i++)
+			UpdateChunkMesh(_chunks[dirty[i]], geometry[i]);
 		
-		_mesh->changedVertices = true;
-		_mesh->changedIndices = true;
-		_mesh->EndChanges();
+		for(Chunk &chunk : _chunks)
+			chunk.dirty = false;
 	}
 
 	bool VoxelEntity::CanRender(Renderer *renderer, Camera *camera) const
@@ -731,14 +942,29 @@ namespace RN
 		return true;
 	}
 
+	bool VoxelEntity::UsesFrustumCulling() const
+	{
+		return false;
+	}
+
 	void VoxelEntity::Render(Renderer *renderer, Camera *camera) const
 	{
 		SceneNode::Render(renderer, camera);
 		
 		if(!_material)
 			return;
-
-		_drawable->Update(_mesh, _material, nullptr, this);
-		renderer->SubmitDrawable(_drawable);
+		
+		// The node itself isn't culled, its chunks are
+		const Matrix transform = GetWorldTransform();
+		const float scale = GetWorldScale().GetMax();
+		
+		for(const Chunk &chunk : _chunks)
+		{
+			if(!chunk.mesh || !camera->InFrustum(transform * chunk.center, chunk.radius * scale))
+				continue;
+			
+			chunk.drawable->Update(chunk.mesh, _material, nullptr, this);
+			renderer->SubmitDrawable(chunk.drawable);
+		}
 	}
 }
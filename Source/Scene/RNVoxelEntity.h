@@ -10,11 +10,15 @@
 #define __Rayne__VOXEL_ENTITY__
 
 #include "RNSceneNode.h"
+#include "RNVoxelStorage.h"
 #include "../Math/RNAlgorithm.h"
 #include "../Rendering/RNRenderer.h"
 #include "../Rendering/RNMaterial.h"
 #include "../Rendering/RNMesh.h"
 
+#define kRNVoxelEntityChunkSize 16 // Marching cubes cells per chunk along each axis, chunks are remeshed and culled individually
+#define kRNVoxelEntityBlurRadius 2 // Radius of the box blur UpdateMesh() applies to the densities
+
 namespace RN
 {
 	class VoxelEntity : public SceneNode
@@ -29,8 +33,12 @@ namespace RN
 		};
 		
 		RNAPI VoxelEntity(uint32 resolutionX = 64, uint32 resolutionY = 32, uint32 resolutionZ = 64);
+		RNAPI VoxelEntity(Deserializer *deserializer);
 		RNAPI ~VoxelEntity();
 		
+		// Stores the transform and the volume, but not the material
+		RNAPI void Serialize(Serializer *serializer) const override;
+		
 		RNAPI void SetVoxel(uint32 x, uint32 y, uint32 z, const Point &voxel);
 		RNAPI uint8 GetVoxel(uint32 x, uint32 y, uint32 z) const;
 		RNAPI uint8 GetVoxel(const Vector3 &position) const;
@@ -42,6 +50,9 @@ namespace RN
 		RNAPI uint32 GetResolutionY() const { return _resolutionY; }
 		RNAPI uint32 GetResolutionZ() const { return _resolutionZ; }
 		
+		// Bytes used by the densities and smoothed densities
+		RNAPI size_t GetVolumeMemoryUsage() const { return _density->GetMemoryUsage() + _smooth->GetMemoryUsage(); }
+		
 		RNAPI void MakePlane(uint32 height);
 		RNAPI void SetCubeLocal(Vector3 position, Vector3 size, uint32 density=255);
 		RNAPI void SetSphereLocal(Vector3 position, float radius, uint32 density=255);
@@ -52,16 +63,41 @@ namespace RN
 		RNAPI void RemoveCube(Vector3 position, Vector3 size);
 		
 		RNAPI void SetMaterial(Material *material);
+		// Remeshes the chunks changed since the last call, in parallel
 		RNAPI void UpdateMesh();
 		
 		RNAPI bool CanRender(Renderer *renderer, Camera *camera) const override;
+		RNAPI bool UsesFrustumCulling() const override;
 		RNAPI void Render(Renderer *renderer, Camera *camera) const override;
 		
 	private:
+		struct Chunk
+		{
+			Mesh *mesh;
+			Drawable *drawable;
+			Vector3 center; // Bounding sphere in local space
+			float radius;
+			bool dirty;
+		};
+
+		struct ChunkGeometry
+		{
+			std::vector<Vector3> vertices;
+			std::vector<Vector3> normals;
+			std::vector<uint32> indices;
+		};
+
 		Vector3 LerpSurface(const Vector3 &p1, const Vector3 &p2, uint8 d1, uint8 d2) const;
-		uint32 GetID(const Vector3 &position) const;
+
+		void MarkDirty(int32 fromX, int32 fromY, int32 fromZ, int32 toX, int32 toY, int32 toZ);
+		void Blur(int32 fromX, int32 fromY, int32 fromZ, int32 toX, int32 toY, int32 toZ, uint8 radius);
+		void PolygonizeChunk(size_t index, ChunkGeometry &geometry) const;
+		void UpdateChunkMesh(Chunk &chunk, const ChunkGeometry &geometry);
+		void InitializeChunks();
 		
-		Point *_voxels;
+		// Most of a volume is usually empty or solid, which the sparse storage keeps as single values per brick
+		VoxelStorage *_density;
+		VoxelStorage *_smooth;
 		
 		uint32 _resolutionX;
 		uint32 _resolutionY;
@@ -69,27 +105,13 @@ namespace RN
 
 		uint8 _surface;
 
-		struct __LookupHashMarchingCubes
-		{
-			size_t operator()(const std::pair<uint32, uint32>& lookup) const
-			{
-				size_t hash = std::hash<uint32>{}(std::min(lookup.first, lookup.second));
-				HashCombine(hash, std::max(lookup.first, lookup.second));
-				return hash;
-			}
-		};
-		
-		struct __LookupCompareMarchingCubes
-		{
-			bool operator()(const std::pair<uint32, uint32>& lookup1, const std::pair<uint32, uint32>& lookup2) const
-			{
-				return ((lookup1.first == lookup2.first && lookup1.second == lookup2.second) || (lookup1.first == lookup2.second && lookup1.second == lookup2.first));
-			}
-		};
-		
-		Mesh *_mesh;
+		// Cells run from 0 to the resolution inclusive, the outermost ones close the surface at the volume border
+		uint32 _chunksX;
+		uint32 _chunksY;
+		uint32 _chunksZ;
+		std::vector<Chunk> _chunks;
+
 		Material *_material;
-		Drawable *_drawable;
 
 		RNDeclareMeta(VoxelEntity)
 	};
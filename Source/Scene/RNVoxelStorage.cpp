@@ -0,0 +1,456 @@
+//
+//  RNVoxelStorage.cpp
+//  Rayne
+//
+//  Copyright 2020 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and corona.
+//
+
+#include "RNVoxelStorage.h"
+
+namespace RN
+{
+	VoxelStorage::VoxelStorage(uint32 resolutionX, uint32 resolutionY, uint32 resolutionZ, uint8 value) :
+		_resolutionX(resolutionX),
+		_resolutionY(resolutionY),
+		_resolutionZ(resolutionZ)
+	{
+		Initialize(value);
+	}
+
+	VoxelStorage::VoxelStorage(Deserializer *deserializer)
+	{
+		_resolutionX = static_cast<uint32>(deserializer->DecodeInt32());
+		_resolutionY = static_cast<uint32>(deserializer->DecodeInt32());
+		_resolutionZ = static_cast<uint32>(deserializer->DecodeInt32());
+
+		Initialize(0);
+
+		// One header byte per brick with its bits, followed by the value, or the palette size, palette and indices, or the raw values
+		size_t length;
+		const uint8 *bytes = static_cast<const uint8 *>(deserializer->DecodeBytes(&length));
+		const uint8 *end = bytes + length;
+
+		auto read = [&](size_t size) -> const uint8 * {
+			if(static_cast<size_t>(end - bytes) < size)
+				throw InconsistencyException("Truncated voxel data");
+
+			const uint8 *result = bytes;
+			bytes += size;
+
+			return result;
+		};
+
+		// The destructor doesn't run if this throws, so the bricks converted so far are freed here
+		try
+		{
+			for(Brick &brick : _bricks)
+			{
+				const uint8 bits = *read(1);
+
+				switch(bits)
+				{
+					case 0:
+						brick.value = *read(1);
+						break;
+
+					case 1:
+					case 2:
+					case 4:
+					{
+						Convert(brick, bits);
+
+						brick.paletteCount = *read(1);
+						if(brick.paletteCount == 0 || brick.paletteCount > (1 << bits))
+							throw InconsistencyException("Invalid voxel palette");
+
+						std::copy_n(read(brick.paletteCount), brick.paletteCount, brick.data);
+
+						const size_t size = kRNVoxelStorageBrickVoxels * bits / 8;
+						std::copy_n(read(size), size, brick.data + kRNVoxelStoragePaletteSize);
+
+						const uint8 mask = (1 << bits) - 1;
+						const uint8 *packed = brick.data + kRNVoxelStoragePaletteSize;
+
+						for(size_t i = 0; i < kRNVoxelStorageBrickVoxels; i ++)
+						{
+							const size_t index = i * bits;
+							if(((packed[index / 8] >> (index % 8)) & mask) >= brick.paletteCount)
+								throw InconsistencyException("Invalid voxel palette index");
+						}
+
+						break;
+					}
+
+					case 8:
+						Convert(brick, 8);
+						std::copy_n(read(kRNVoxelStorageBrickVoxels), kRNVoxelStorageBrickVoxels, brick.data);
+						break;
+
+					default:
+						throw InconsistencyException("Invalid voxel brick");
+				}
+			}
+		}
+		catch(...)
+		{
+			for(Brick &brick : _bricks)
+				delete[] brick.data;
+
+			throw;
+		}
+	}
+
+	VoxelStorage::~VoxelStorage()
+	{
+		for(Brick &brick : _bricks)
+			delete[] brick.data;
+	}
+
+	void VoxelStorage::Initialize(uint8 value)
+	{
+		_bricksX = (_resolutionX + kRNVoxelStorageBrickSize - 1) / kRNVoxelStorageBrickSize;
+		_bricksY = (_resolutionY + kRNVoxelStorageBrickSize - 1) / kRNVoxelStorageBrickSize;
+		_bricksZ = (_resolutionZ + kRNVoxelStorageBrickSize - 1) / kRNVoxelStorageBrickSize;
+
+		Brick brick;
+		brick.data = nullptr;
+		brick.bits = 0;
+		brick.value = value;
+		brick.paletteCount = 0;
+
+		_bricks.resize(_bricksX * _bricksY * _bricksZ, brick);
+	}
+
+	void VoxelStorage::Serialize(Serializer *serializer) const
+	{
+		serializer->EncodeInt32(static_cast<int32>(_resolutionX));
+		serializer->EncodeInt32(static_cast<int32>(_resolutionY));
+		serializer->EncodeInt32(static_cast<int32>(_resolutionZ));
+
+		std::vector<uint8> bytes;
+
+		for(const Brick &brick : _bricks)
+		{
+			bytes.push_back(brick.bits);
+
+			switch(brick.bits)
+			{
+				case 0:
+					bytes.push_back(brick.value);
+					break;
+
+				case 8:
+					bytes.insert(bytes.end(), brick.data, brick.data + kRNVoxelStorageBrickVoxels);
+					break;
+
+				default:
+					bytes.push_back(brick.paletteCount);
+					bytes.insert(bytes.end(), brick.data, brick.data + brick.paletteCount);
+					bytes.insert(bytes.end(), brick.data + kRNVoxelStoragePaletteSize, brick.data + GetDataSize(brick.bits));
+					break;
+			}
+		}
+
+		serializer->EncodeBytes(bytes.data(), bytes.size());
+	}
+
+	void VoxelStorage::Decode(const Brick &brick, uint8 *values)
+	{
+		switch(brick.bits)
+		{
+			case 0:
+				std::fill_n(values, kRNVoxelStorageBrickVoxels, brick.value);
+				break;
+
+			case 8:
+				std::copy_n(brick.data, kRNVoxelStorageBrickVoxels, values);
+				break;
+
+			default:
+			{
+				const uint8 mask = (1 << brick.bits) - 1;
+				const uint8 *packed = brick.data + kRNVoxelStoragePaletteSize;
+
+				for(size_t i = 0; i < kRNVoxelStorageBrickVoxels; i ++)
+				{
+					const size_t index = i * brick.bits;
+					values[i] = brick.data[(packed[index / 8] >> (index % 8)) & mask];
+				}
+
+				break;
+			}
+		}
+	}
+
+	void VoxelStorage::Encode(Brick &brick, const uint8 *values)
+	{
+		// Counts the distinct values to pick the smallest representation
+		bool used[256] = { false };
+		uint8 palette[kRNVoxelStoragePaletteSize];
+		size_t count = 0;
+
+		for(size_t i = 0; i < kRNVoxelStorageBrickVoxels; i ++)
+		{
+			if(used[values[i]])
+				continue;
+
+			used[values[i]] = true;
+
+			if(count < kRNVoxelStoragePaletteSize)
+				palette[count] = values[i];
+
+			count ++;
+		}
+
+		if(count == 1)
+		{
+			SetUniform(brick, values[0]);
+			return;
+		}
+
+		uint8 bits = 8;
+		if(count <= 2)
+			bits = 1;
+		else if(count <= 4)
+			bits = 2;
+		else if(count <= kRNVoxelStoragePaletteSize)
+			bits = 4;
+
+		if(brick.bits != bits)
+		{
+			delete[] brick.data;
+			brick.data = new uint8[GetDataSize(bits)];
+			brick.bits = bits;
+		}
+
+		if(bits == 8)
+		{
+			std::copy_n(values, kRNVoxelStorageBrickVoxels, brick.data);
+			brick.paletteCount = 0;
+
+			return;
+		}
+
+		uint8 lookup[256];
+		for(size_t i = 0; i < count; i ++)
+		{
+			brick.data[i] = palette[i];
+			lookup[palette[i]] = static_cast<uint8>(i);
+		}
+
+		brick.paletteCount = static_cast<uint8>(count);
+
+		uint8 *packed = brick.data + kRNVoxelStoragePaletteSize;
+		std::fill_n(packed, kRNVoxelStorageBrickVoxels * bits / 8, 0);
+
+		for(size_t i = 0; i < kRNVoxelStorageBrickVoxels; i ++)
+		{
+			const size_t index = i * bits;
+			packed[index / 8] |= lookup[values[i]] << (index % 8);
+		}
+	}
+
+	void VoxelStorage::SetUniform(Brick &brick, uint8 value)
+	{
+		delete[] brick.data;
+
+		brick.data = nullptr;
+		brick.bits = 0;
+		brick.value = value;
+		brick.paletteCount = 0;
+	}
+
+	void VoxelStorage::Convert(Brick &brick, uint8 bits)
+	{
+		uint8 values[kRNVoxelStorageBrickVoxels];
+		Decode(brick, values);
+
+		uint8 *data = new uint8[GetDataSize(bits)];
+
+		if(bits == 8)
+		{
+			std::copy_n(values, kRNVoxelStorageBrickVoxels, data);
+			brick.paletteCount = 0;
+		}
+		else
+		{
+			// Widening keeps the palette and only spreads the indices
+			if(brick.bits == 0)
+			{
+				data[0] = brick.value;
+				brick.paletteCount = 1;
+			}
+			else
+			{
+				std::copy_n(brick.data, brick.paletteCount, data);
+			}
+
+			uint8 *packed = data + kRNVoxelStoragePaletteSize;
+			std::fill_n(packed, kRNVoxelStorageBrickVoxels * bits / 8, 0);
+
+			if(brick.bits != 0)
+			{
+				const uint8 mask = (1 << brick.bits) - 1;
+				const uint8 *source = brick.data + kRNVoxelStoragePaletteSize;
+
+				for(size_t i = 0; i < kRNVoxelStorageBrickVoxels; i ++)
+				{
+					const size_t from = i * brick.bits;
+					const size_t to = i * bits;
+
+					packed[to / 8] |= ((source[from / 8] >> (from % 8)) & mask) << (to % 8);
+				}
+			}
+		}
+
+		delete[] brick.data;
+
+		brick.data = data;
+		brick.bits = bits;
+	}
+
+	void VoxelStorage::Set(uint32 x, uint32 y, uint32 z, uint8 value)
+	{
+		Brick &brick = GetBrick(x, y, z);
+		const size_t local = GetLocalIndex(x, y, z);
+
+		if(brick.bits == 0)
+		{
+			if(brick.value == value)
+				return;
+
+			Convert(brick, 1);
+		}
+
+		if(brick.bits == 8)
+		{
+			brick.data[local] = value;
+			return;
+		}
+
+		size_t index = 0;
+		while(index < brick.paletteCount && brick.data[index] != value)
+			index ++;
+
+		if(index == brick.paletteCount)
+		{
+			if(brick.paletteCount == (1 << brick.bits))
+			{
+				Convert(brick, (brick.bits == 4)? 8 : brick.bits * 2);
+
+				if(brick.bits == 8)
+				{
+					brick.data[local] = value;
+					return;
+				}
+			}
+
+			brick.data[brick.paletteCount ++] = value;
+		}
+
+		uint8 *packed = brick.data + kRNVoxelStoragePaletteSize;
+		const size_t bit = local * brick.bits;
+		const uint8 mask = ((1 << brick.bits) - 1) << (bit % 8);
+
+		packed[bit / 8] = (packed[bit / 8] & ~mask) | (index << (bit % 8));
+	}
+
+	void VoxelStorage::Fill(uint32 fromX, uint32 fromY, uint32 fromZ, uint32 toX, uint32 toY, uint32 toZ, uint8 value)
+	{
+		for(uint32 brickX = fromX / kRNVoxelStorageBrickSize; brickX <= toX / kRNVoxelStorageBrickSize; brickX ++)
+		{
+			for(uint32 brickY = fromY / kRNVoxelStorageBrickSize; brickY <= toY / kRNVoxelStorageBrickSize; brickY ++)
+			{
+				for(uint32 brickZ = fromZ / kRNVoxelStorageBrickSize; brickZ <= toZ / kRNVoxelStorageBrickSize; brickZ ++)
+				{
+					const uint32 minX = std::max(fromX, brickX * kRNVoxelStorageBrickSize);
+					const uint32 minY = std::max(fromY, brickY * kRNVoxelStorageBrickSize);
+					const uint32 minZ = std::max(fromZ, brickZ * kRNVoxelStorageBrickSize);
+					const uint32 maxX = std::min(toX, brickX * kRNVoxelStorageBrickSize + kRNVoxelStorageBrickSize - 1);
+					const uint32 maxY = std::min(toY, brickY * kRNVoxelStorageBrickSize + kRNVoxelStorageBrickSize - 1);
+					const uint32 maxZ = std::min(toZ, brickZ * kRNVoxelStorageBrickSize + kRNVoxelStorageBrickSize - 1);
+
+					Brick &brick = _bricks[(brickX * _bricksY + brickY) * _bricksZ + brickZ];
+
+					// Voxels past the end of the volume in the last bricks don't matter
+					const bool coversX = (minX == brickX * kRNVoxelStorageBrickSize && (maxX == minX + kRNVoxelStorageBrickSize - 1 || maxX == _resolutionX - 1));
+					const bool coversY = (minY == brickY * kRNVoxelStorageBrickSize && (maxY == minY + kRNVoxelStorageBrickSize - 1 || maxY == _resolutionY - 1));
+					const bool coversZ = (minZ == brickZ * kRNVoxelStorageBrickSize && (maxZ == minZ + kRNVoxelStorageBrickSize - 1 || maxZ == _resolutionZ - 1));
+
+					if(coversX && coversY && coversZ)
+					{
+						SetUniform(brick, value);
+						continue;
+					}
+
+					uint8 values[kRNVoxelStorageBrickVoxels];
+					Decode(brick, values);
+
+					for(uint32 x = minX; x <= maxX; x ++)
+					{
+						for(uint32 y = minY; y <= maxY; y ++)
+						{
+							for(uint32 z = minZ; z <= maxZ; z ++)
+								values[GetLocalIndex(x, y, z)] = value;
+						}
+					}
+
+					Encode(brick, values);
+				}
+			}
+		}
+	}
+
+	void VoxelStorage::Compact(uint32 fromX, uint32 fromY, uint32 fromZ, uint32 toX, uint32 toY, uint32 toZ)
+	{
+		for(uint32 brickX = fromX / kRNVoxelStorageBrickSize; brickX <= toX / kRNVoxelStorageBrickSize; brickX ++)
+		{
+			for(uint32 brickY = fromY / kRNVoxelStorageBrickSize; brickY <= toY / kRNVoxelStorageBrickSize; brickY ++)
+			{
+				for(uint32 brickZ = fromZ / kRNVoxelStorageBrickSize; brickZ <= toZ / kRNVoxelStorageBrickSize; brickZ ++)
+				{
+					Brick &brick = _bricks[(brickX * _bricksY + brickY) * _bricksZ + brickZ];
+					if(brick.bits == 0)
+						continue;
+
+					uint8 values[kRNVoxelStorageBrickVoxels];
+					Decode(brick, values);
+
+					// Voxels outside of the volume keep whatever they had and would prevent bricks from becoming uniform
+					const uint32 endX = std::min(brickX * kRNVoxelStorageBrickSize + kRNVoxelStorageBrickSize, _resolutionX);
+					const uint32 endY = std::min(brickY * kRNVoxelStorageBrickSize + kRNVoxelStorageBrickSize, _resolutionY);
+					const uint32 endZ = std::min(brickZ * kRNVoxelStorageBrickSize + kRNVoxelStorageBrickSize, _resolutionZ);
+
+					const uint8 first = values[0];
+					for(uint32 x = brickX * kRNVoxelStorageBrickSize; x < brickX * kRNVoxelStorageBrickSize + kRNVoxelStorageBrickSize; x ++)
+					{
+						for(uint32 y = brickY * kRNVoxelStorageBrickSize; y < brickY * kRNVoxelStorageBrickSize + kRNVoxelStorageBrickSize; y ++)
+						{
+							for(uint32 z = brickZ * kRNVoxelStorageBrickSize; z < brickZ * kRNVoxelStorageBrickSize + kRNVoxelStorageBrickSize; z ++)
+							{
+								if(x >= endX || y >= endY || z >= endZ)
+									values[GetLocalIndex(x, y, z)] = first;
+							}
+						}
+					}
+
+					Encode(brick, values);
+				}
+			}
+		}
+	}
+
+	size_t VoxelStorage::GetMemoryUsage() const
+	{
+		size_t usage = sizeof(VoxelStorage) + _bricks.size() * sizeof(Brick);
+
+		for(const Brick &brick : _bricks)
+		{
+			if(brick.bits != 0)
+				usage += GetDataSize(brick.bits);
+		}
+
+		return usage;
+	}
+}
@@ -0,0 +1,102 @@
+//
+//  RNVoxelStorage.h
+//  Rayne
+//
+//  Copyright 2020 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and corona.
+//
+
+#ifndef __RAYNE_VOXELSTORAGE_H__
+#define __RAYNE_VOXELSTORAGE_H__
+
+#include "../Base/RNBase.h"
+#include "../Objects/RNSerialization.h"
+
+#define kRNVoxelStorageBrickSize 8 // Voxels per brick along each axis
+#define kRNVoxelStorageBrickVoxels (kRNVoxelStorageBrickSize * kRNVoxelStorageBrickSize * kRNVoxelStorageBrickSize)
+#define kRNVoxelStoragePaletteSize 16
+
+namespace RN
+{
+	// Sparse grid of 8 bit values, split into bricks of 8^3 voxels. Bricks with a single value store just that value,
+	// bricks with up to 16 different values store a palette and 1, 2 or 4 bit indices into it, the others store raw
+	// values. Writes convert bricks as needed, Compact() turns them back into the smallest representation.
+	// Separate bricks can be written from separate threads.
+	class VoxelStorage
+	{
+	public:
+		RNAPI VoxelStorage(uint32 resolutionX, uint32 resolutionY, uint32 resolutionZ, uint8 value = 0);
+		RNAPI VoxelStorage(Deserializer *deserializer);
+		RNAPI ~VoxelStorage();
+
+		RNAPI void Serialize(Serializer *serializer) const;
+
+		// Neither checks the coordinates, they have to be inside the volume
+		RN_INLINE uint8 Get(uint32 x, uint32 y, uint32 z) const;
+		RNAPI void Set(uint32 x, uint32 y, uint32 z, uint8 value);
+
+		// Sets everything between from and to, inclusive. Bricks that are covered completely become uniform right away.
+		RNAPI void Fill(uint32 fromX, uint32 fromY, uint32 fromZ, uint32 toX, uint32 toY, uint32 toZ, uint8 value);
+		// Compacts the bricks touching the voxels between from and to, inclusive
+		RNAPI void Compact(uint32 fromX, uint32 fromY, uint32 fromZ, uint32 toX, uint32 toY, uint32 toZ);
+
+		uint32 GetResolutionX() const { return _resolutionX; }
+		uint32 GetResolutionY() const { return _resolutionY; }
+		uint32 GetResolutionZ() const { return _resolutionZ; }
+
+		// Bytes used by the bricks and their data
+		RNAPI size_t GetMemoryUsage() const;
+
+	private:
+		struct Brick
+		{
+			uint8 *data; // Palette followed by the packed indices, or the raw values. nullptr for uniform bricks
+			uint8 bits; // 0 for uniform bricks, 1, 2 or 4 for palette indices, 8 for raw values
+			uint8 value; // The value of uniform bricks
+			uint8 paletteCount;
+		};
+
+		void Initialize(uint8 value);
+		Brick &GetBrick(uint32 x, uint32 y, uint32 z) { return _bricks[((x / kRNVoxelStorageBrickSize) * _bricksY + (y / kRNVoxelStorageBrickSize)) * _bricksZ + (z / kRNVoxelStorageBrickSize)]; }
+		const Brick &GetBrick(uint32 x, uint32 y, uint32 z) const { return _bricks[((x / kRNVoxelStorageBrickSize) * _bricksY + (y / kRNVoxelStorageBrickSize)) * _bricksZ + (z / kRNVoxelStorageBrickSize)]; }
+
+		static size_t GetLocalIndex(uint32 x, uint32 y, uint32 z) { return ((x % kRNVoxelStorageBrickSize) * kRNVoxelStorageBrickSize + (y % kRNVoxelStorageBrickSize)) * kRNVoxelStorageBrickSize + (z % kRNVoxelStorageBrickSize); }
+		static size_t GetDataSize(uint8 bits) { return (bits == 8)? kRNVoxelStorageBrickVoxels : kRNVoxelStoragePaletteSize + kRNVoxelStorageBrickVoxels * bits / 8; }
+
+		static void Decode(const Brick &brick, uint8 *values);
+		static void Encode(Brick &brick, const uint8 *values);
+		static void SetUniform(Brick &brick, uint8 value);
+		static void Convert(Brick &brick, uint8 bits);
+
+		uint32 _resolutionX;
+		uint32 _resolutionY;
+		uint32 _resolutionZ;
+
+		uint32 _bricksX;
+		uint32 _bricksY;
+		uint32 _bricksZ;
+		std::vector<Brick> _bricks;
+	};
+
+	RN_INLINE uint8 VoxelStorage::Get(uint32 x, uint32 y, uint32 z) const
+	{
+		const Brick &brick = GetBrick(x, y, z);
+
+		switch(brick.bits)
+		{
+			case 0:
+				return brick.value;
+			case 8:
+				return brick.data[GetLocalIndex(x, y, z)];
+			default:
+			{
+				const size_t index = GetLocalIndex(x, y, z) * brick.bits;
+				const uint8 packed = brick.data[kRNVoxelStoragePaletteSize + index / 8];
+
+				return brick.data[(packed >> (index % 8)) & ((1 << brick.bits) - 1)];
+			}
+		}
+	}
+}
+
+#endif /* __RAYNE_VOXELSTORAGE_H__ */
@@ -14,6 +14,7 @@
 #elif RN_PLATFORM_POSIX
 	#include <unistd.h>
 	#include <fcntl.h>
+	#include <sys/mman.h>
 #define O_BINARY 0x0
 #endif
 
@@ -39,6 +40,24 @@ namespace RN
 	{
 		_size = static_cast<size_t>(lseek(fd, 0, SEEK_END));
 		lseek(fd, 0, SEEK_SET);
+
+		InitializeAccess();
+	}
+
+	File::File(Data *data, const String *path) :
+#if RN_PLATFORM_ANDROID
+		_asset(nullptr),
+#endif
+		_fd(-1),
+		_size(data->GetLength()),
+		_mode(Mode::Read),
+		_path(path->Copy())
+	{
+		InitializeAccess();
+
+		_access = Access::Mapped;
+		_mapping = data->GetBytes<uint8>();
+		_data = data->Retain();
 	}
 
 #if RN_PLATFORM_ANDROID
@@ -49,11 +68,18 @@ namespace RN
     		_path(path->Copy())
     {
     	_size = static_cast<size_t>(AAsset_getLength(_asset));
+
+    	InitializeAccess();
     }
 #endif
 
 	File::~File()
 	{
+		UnmapFile();
+		delete[] _buffer;
+
+		SafeRelease(_data);
+
 #if RN_PLATFORM_ANDROID
 		if(_asset)
 		{
@@ -61,6 +87,7 @@ namespace RN
 		}
 		else
 #endif
+		if(_fd != -1)
 		{
 			close(_fd);
 		}
@@ -68,9 +95,102 @@ namespace RN
 		SafeRelease(_path);
 	}
 
+	void File::InitializeAccess()
+	{
+		_access = Access::Direct;
+		_position = 0;
+		_descriptorOffset = 0;
+
+		_buffer = nullptr;
+		_bufferStart = 0;
+		_bufferLength = 0;
+
+		_mapping = nullptr;
+		_data = nullptr;
+#if RN_PLATFORM_WINDOWS
+		_mappingHandle = nullptr;
+#endif
+
+		if(_fd == -1
+#if RN_PLATFORM_ANDROID
+		   && !_asset
+#endif
+		   )
+			return;
+
+		if((_mode & (Mode::Write | Mode::NoBuffering)) || !(_mode & Mode::Read) || _size == 0)
+			return;
+
+		// Assets are read through the buffer, AAsset_getBuffer() may have to decompress the whole asset
+		bool canMap = true;
+#if RN_PLATFORM_ANDROID
+		canMap = (_asset == nullptr);
+#endif
+
+		if(canMap && _size >= kRNFileMappingThreshold && MapFile())
+		{
+			_access = Access::Mapped;
+			return;
+		}
+
+		_access = Access::Buffered;
+		_buffer = new uint8[std::min(_size, static_cast<size_t>(kRNFileBufferSize))];
+	}
+
+	bool File::MapFile()
+	{
+#if RN_PLATFORM_POSIX
+		void *mapping = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+		if(mapping == MAP_FAILED)
+			return false;
+
+		_mapping = static_cast<uint8 *>(mapping);
+		return true;
+#elif RN_PLATFORM_WINDOWS
+		HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(_fd));
+		if(file == INVALID_HANDLE_VALUE)
+			return false;
+
+		_mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(!_mappingHandle)
+			return false;
+
+		_mapping = static_cast<uint8 *>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, _size));
+		if(!_mapping)
+		{
+			CloseHandle(_mappingHandle);
+			_mappingHandle = nullptr;
+
+			return false;
+		}
+
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void File::UnmapFile()
+	{
+		if(!_mapping || _data)
+			return;
+
+#if RN_PLATFORM_POSIX
+		munmap(_mapping, _size);
+#elif RN_PLATFORM_WINDOWS
+		UnmapViewOfFile(_mapping);
+		CloseHandle(_mappingHandle);
+#endif
+
+		_mapping = nullptr;
+	}
+
 
 	size_t File::GetOffset() const
 	{
+		if(_access != Access::Direct)
+			return _position;
+
 #if RN_PLATFORM_ANDROID
 		if(_asset)
 		{
@@ -81,6 +201,13 @@ namespace RN
 	}
 	void File::Seek(size_t offset, bool fromStart)
 	{
+		if(_access != Access::Direct)
+		{
+			// The buffer is checked against the position on the next read
+			_position = fromStart ? offset : _position + offset;
+			return;
+		}
+
 #if RN_PLATFORM_ANDROID
 		if(_asset)
 		{
@@ -93,11 +220,100 @@ namespace RN
 		}
 	}
 
+	void File::SeekDirect(size_t offset) const
+	{
+		if(offset == _descriptorOffset)
+			return;
+
+#if RN_PLATFORM_ANDROID
+		if(_asset)
+		{
+			AAsset_seek(_asset, static_cast<off_t>(offset), SEEK_SET);
+		}
+		else
+#endif
+		{
+			lseek(_fd, static_cast<off_t>(offset), SEEK_SET);
+		}
+
+		_descriptorOffset = offset;
+	}
+
 
 	size_t File::Read(void *buffer, size_t size)
 	{
 		RN_ASSERT(_mode & Mode::Read, "Trying to read from a file not opened for reading");
 
+		switch(_access)
+		{
+			case Access::Direct:
+				return ReadDirect(buffer, size);
+
+			case Access::Mapped:
+			{
+				if(_position >= _size)
+					return 0;
+
+				size = std::min(size, _size - _position);
+				memcpy(buffer, _mapping + _position, size);
+
+				_position += size;
+				return size;
+			}
+
+			case Access::Buffered:
+			{
+				uint8 *bytes = static_cast<uint8 *>(buffer);
+				size_t totalRead = 0;
+
+				while(size > 0)
+				{
+					if(_position >= _bufferStart && _position < _bufferStart + _bufferLength)
+					{
+						const size_t offset = _position - _bufferStart;
+						const size_t length = std::min(size, _bufferLength - offset);
+
+						memcpy(bytes + totalRead, _buffer + offset, length);
+
+						_position += length;
+						totalRead += length;
+						size -= length;
+
+						continue;
+					}
+
+					if(_position >= _size)
+						break;
+
+					SeekDirect(_position);
+
+					// Large reads bypass the buffer
+					if(size >= kRNFileBufferSize)
+					{
+						const size_t length = ReadDirect(bytes + totalRead, size);
+
+						_position += length;
+						totalRead += length;
+
+						break;
+					}
+
+					_bufferStart = _position;
+					_bufferLength = ReadDirect(_buffer, std::min(_size - _position, static_cast<size_t>(kRNFileBufferSize)));
+
+					if(_bufferLength == 0)
+						break;
+				}
+
+				return totalRead;
+			}
+		}
+
+		return 0;
+	}
+
+	size_t File::ReadDirect(void *buffer, size_t size)
+	{
 		size_t totalRead = 0;
 		size_t left = size;
 		uint8 *bytes = static_cast<uint8 *>(buffer);
@@ -149,11 +365,21 @@ namespace RN
 
 		} while(left > 0);
 
+		_descriptorOffset += totalRead;
 		return totalRead;
 	}
 
 	Data *File::ReadData(size_t maxLength)
 	{
+		if(_access == Access::Mapped)
+		{
+			const size_t length = (_position < _size) ? std::min(maxLength, _size - _position) : 0;
+			Data *data = new Data(_mapping + _position, length, this);
+
+			_position += length;
+			return data->Autorelease();
+		}
+
 		uint8 *buffer = (uint8 *)malloc(maxLength);
 		size_t read = Read(buffer, maxLength);
 
@@ -218,11 +444,43 @@ namespace RN
 
 	int File::CreateFileDescriptor() const
 	{
+		if(_data)
+		{
+			FILE *file = CreateFilePtr();
+			if(!file)
+				return -1;
+
+			int fd = dup(fileno(file));
+			fclose(file);
+
+			return fd;
+		}
+
+		if(_access != Access::Direct)
+			SeekDirect(_position);
+
 		return dup(_fd);
 	}
 
 	FILE *File::CreateFilePtr() const
 	{
+		if(_data)
+		{
+			// There is no descriptor for packed files, so they are copied to a temporary file
+			FILE *file = tmpfile();
+			if(!file)
+				return nullptr;
+
+			if(fwrite(_mapping, 1, _size, file) != _size)
+			{
+				fclose(file);
+				return nullptr;
+			}
+
+			fseek(file, static_cast<long>(std::min(_position, _size)), SEEK_SET);
+			return file;
+		}
+
 #if RN_PLATFORM_ANDROID
 		if(_asset)
 		{
@@ -261,6 +519,9 @@ namespace RN
 					mode = "wb";
 			}
 
+			if(_access != Access::Direct)
+				SeekDirect(_position);
+
 			return fdopen(dup(_fd), mode);
 		}
 	}
@@ -303,6 +564,17 @@ namespace RN
 	{
 		FileManager *coordinator = FileManager::GetSharedInstance();
 
+		// Mounted packs take precedence and skip path resolution
+		if(!(mode & Mode::Write))
+		{
+			Data *data = coordinator->GetPackedData(name);
+			if(data)
+			{
+				File *file = new File(data, name);
+				return file->Autorelease();
+			}
+		}
+
 		if(mode & Mode::Write)
 		{
 			bool isDirectory;
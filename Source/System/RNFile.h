@@ -13,6 +13,9 @@
 #include "../Objects/RNObject.h"
 #include "../Objects/RNData.h"
 
+#define kRNFileBufferSize (64 * 1024)
+#define kRNFileMappingThreshold (256 * 1024)
+
 namespace RN
 {
 	class File : public Object
@@ -22,20 +25,32 @@ namespace RN
 				   Read = (1 << 0),
 				   Write = (1 << 1),
 				   Append = (1 << 2),
-				   NoCreate = (1 << 3));
+				   NoCreate = (1 << 3),
+				   NoBuffering = (1 << 4));
+
+		// Read only files are memory mapped if they are larger than kRNFileMappingThreshold and read through
+		// a kRNFileBufferSize buffer otherwise. Files opened for writing or with NoBuffering access the file directly.
+		// Files read from a mounted PackFile are backed by memory and use mapped access.
+		enum class Access
+		{
+			Direct,
+			Buffered,
+			Mapped
+		};
 
 		RNAPI static File *WithName(const String *name, Mode mode = Mode::Read);
 
 		RNAPI ~File();
 
 		size_t GetSize() const { return _size; }
+		Access GetAccess() const { return _access; }
 		RNAPI size_t GetOffset() const;
 
 		RNAPI void Seek(size_t offset, bool fromStart = true);
 
 		// Reading
 		RNAPI size_t Read(void *buffer, size_t size);
-		RNAPI Data *ReadData(size_t maxLength);
+		RNAPI Data *ReadData(size_t maxLength); // For mapped files this returns a view into the mapping that keeps the file alive
 
 		RNAPI uint8 ReadUint8();
 		RNAPI uint16 ReadUint16();
@@ -63,6 +78,14 @@ namespace RN
 	private:
 		static int __FileWithPath(const String *name, Mode mode);
 		File(int fd, const String *path, Mode mode);
+		File(Data *data, const String *path);
+
+		void InitializeAccess();
+		bool MapFile();
+		void UnmapFile();
+
+		size_t ReadDirect(void *buffer, size_t size);
+		void SeekDirect(size_t offset) const;
 
 #if RN_PLATFORM_ANDROID
 		File(AAsset *asset, const String *path, Mode mode);
@@ -74,6 +97,20 @@ namespace RN
 		Mode _mode;
 		String *_path;
 
+		Access _access;
+		size_t _position; // Offset of the next read for buffered and mapped access
+		mutable size_t _descriptorOffset;
+
+		uint8 *_buffer;
+		size_t _bufferStart;
+		size_t _bufferLength;
+
+		uint8 *_mapping;
+		Data *_data; // Backing store of files read from a PackFile
+#if RN_PLATFORM_WINDOWS
+		HANDLE _mappingHandle;
+#endif
+
 		__RNDeclareMetaInternal(File)
 	};
 
@@ -11,6 +11,7 @@
 #include "../Base/RNApplication.h"
 #include "../Modules/RNModule.h"
 #include "RNFileManager.h"
+#include "RNPackFile.h"
 
 #include "zip.h"
 
@@ -408,6 +409,12 @@ namespace RN
 	}
 	FileManager::~FileManager()
 	{
+		for(PackMount &mount : _packMounts)
+		{
+			mount.pack->Release();
+			SafeRelease(mount.mountPoint);
+		}
+
 		SafeRelease(_nodes);
 		SafeRelease(_modulePaths);
 		SafeRelease(_applicationDirectory);
@@ -446,6 +453,110 @@ namespace RN
 				AddSearchPath(path);
 			});
 		}
+
+		// Either names of pack files or dictionaries with a file and a mount key
+		Array *packs = Kernel::GetSharedInstance()->GetManifestEntryForKey<Array>(kRNManifestPackFilesKey);
+		if(packs)
+		{
+			packs->Enumerate([&](Object *object, size_t index, bool &stop) {
+
+				String *name = object->Downcast<String>();
+				String *mountPoint = nullptr;
+
+				if(!name)
+				{
+					Dictionary *dictionary = object->Downcast<Dictionary>();
+					if(dictionary)
+					{
+						name = dictionary->GetObjectForKey<String>(RNCSTR("file"));
+						mountPoint = dictionary->GetObjectForKey<String>(RNCSTR("mount"));
+					}
+				}
+
+				if(!name)
+					throw InconsistencyException("Malformed manifest.json, RNPackFiles entries must be strings or dictionaries with a file key");
+
+				MountPackFile(PackFile::WithName(name), mountPoint);
+			});
+		}
+	}
+
+	void FileManager::MountPackFile(PackFile *pack, const String *mountPoint)
+	{
+		LockGuard<Lockable> lock(_lock);
+
+		PackMount mount;
+		mount.pack = pack->Retain();
+		mount.mountPoint = mountPoint ? mountPoint->Copy() : nullptr;
+
+		_packMounts.push_back(mount);
+	}
+
+	void FileManager::UnmountPackFile(PackFile *pack)
+	{
+		LockGuard<Lockable> lock(_lock);
+
+		for(auto iterator = _packMounts.begin(); iterator != _packMounts.end(); iterator ++)
+		{
+			if(iterator->pack == pack)
+			{
+				iterator->pack->Release();
+				SafeRelease(iterator->mountPoint);
+
+				_packMounts.erase(iterator);
+				return;
+			}
+		}
+	}
+
+	Data *FileManager::GetPackedData(const String *path)
+	{
+		PackFile *pack = nullptr;
+		const PackFile::Entry *entry = nullptr;
+
+		{
+			LockGuard<Lockable> lock(_lock);
+
+			if(_packMounts.empty())
+				return nullptr;
+
+			const char *name = path->GetUTF8String();
+			const size_t length = strlen(name);
+
+			for(auto iterator = _packMounts.rbegin(); iterator != _packMounts.rend(); iterator ++)
+			{
+				const char *relative = name;
+				size_t relativeLength = length;
+
+				if(iterator->mountPoint)
+				{
+					const char *mountPoint = iterator->mountPoint->GetUTF8String();
+					const size_t mountPointLength = strlen(mountPoint);
+
+					if(length <= mountPointLength + 1 || strncmp(name, mountPoint, mountPointLength) != 0 || name[mountPointLength] != '/')
+						continue;
+
+					relative += mountPointLength + 1;
+					relativeLength -= mountPointLength + 1;
+				}
+
+				entry = iterator->pack->GetEntry(relative, relativeLength);
+				if(entry)
+				{
+					pack = iterator->pack->Retain();
+					break;
+				}
+			}
+		}
+
+		if(!pack)
+			return nullptr;
+
+		// Reading and decompressing happens outside of the lock, the pack serializes its own reads
+		Data *data = pack->GetDataForEntry(entry);
+		pack->Release();
+
+		return data;
 	}
 
 	String *FileManager::__ExpandPath(const String *tpath)
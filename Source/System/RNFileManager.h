@@ -17,6 +17,7 @@
 namespace RN
 {
 	class Kernel;
+	class PackFile;
 	class FileManager
 	{
 	public:
@@ -121,6 +122,12 @@ namespace RN
 		RNAPI void AddSearchPath(const String *path);
 		RNAPI void RemoveSearchPath(const String *path);
 
+		// File::WithName() reads files from mounted packs before resolving paths, packs mounted last are searched first.
+		// Without a mount point the pack is looked up with the path as is, otherwise the path has to start with the mount point, ie. :RayneMedia:
+		RNAPI void MountPackFile(PackFile *pack, const String *mountPoint = nullptr);
+		RNAPI void UnmountPackFile(PackFile *pack);
+		RNAPI Data *GetPackedData(const String *path);
+
 		RNAPI static bool PathExists(const String *path);
 		RNAPI static bool PathExists(const String *path, bool &isDirectory);
 
@@ -137,9 +144,16 @@ namespace RN
 		Array *__GetNodeContainerForPath(const String *path, Array *&outPath);
 		Array *GetFilePathsFromZipFile(const String *path) const;
 
+		struct PackMount
+		{
+			PackFile *pack;
+			String *mountPoint;
+		};
+
 		Lockable _lock;
 		Array *_nodes;
 		Dictionary *_modulePaths;
+		std::vector<PackMount> _packMounts;
 
 		const String *_applicationDirectory;
 
@@ -0,0 +1,238 @@
+//
+//  RNPackFile.cpp
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "RNPackFile.h"
+#include "../Objects/RNString.h"
+
+namespace RN
+{
+	RNDefineMeta(PackFile, Object)
+
+	RNExceptionImp(InvalidPackFile)
+
+	static_assert(sizeof(PackFile::Header) == 64, "PackFile::Header must match the file layout");
+	static_assert(sizeof(PackFile::Entry) == 48, "PackFile::Entry must match the file layout");
+
+	// Decodes a raw LZ4 block, returns false if the input is malformed or doesn't decode to exactly outputSize bytes
+	static bool DecompressLZ4(const uint8 *input, size_t inputSize, uint8 *output, size_t outputSize)
+	{
+		const uint8 *ip = input;
+		const uint8 *iend = input + inputSize;
+		uint8 *op = output;
+		uint8 *oend = output + outputSize;
+
+		while(ip < iend)
+		{
+			const uint8 token = *ip ++;
+
+			size_t literals = token >> 4;
+			if(literals == 15)
+			{
+				uint8 byte;
+				do {
+					if(ip >= iend)
+						return false;
+
+					byte = *ip ++;
+					literals += byte;
+				} while(byte == 255);
+			}
+
+			if(literals > static_cast<size_t>(iend - ip) || literals > static_cast<size_t>(oend - op))
+				return false;
+
+			memcpy(op, ip, literals);
+			ip += literals;
+			op += literals;
+
+			// The last sequence only has literals
+			if(ip >= iend)
+				break;
+
+			if(iend - ip < 2)
+				return false;
+
+			const size_t offset = ip[0] | (ip[1] << 8);
+			ip += 2;
+
+			if(offset == 0 || offset > static_cast<size_t>(op - output))
+				return false;
+
+			size_t length = token & 15;
+			if(length == 15)
+			{
+				uint8 byte;
+				do {
+					if(ip >= iend)
+						return false;
+
+					byte = *ip ++;
+					length += byte;
+				} while(byte == 255);
+			}
+
+			length += 4;
+
+			if(length > static_cast<size_t>(oend - op))
+				return false;
+
+			const uint8 *match = op - offset;
+
+			if(offset >= length)
+			{
+				memcpy(op, match, length);
+				op += length;
+			}
+			else
+			{
+				// Overlapping matches repeat the last offset bytes
+				while(length --)
+					*op ++ = *match ++;
+			}
+		}
+
+		return (op == oend);
+	}
+
+
+	PackFile::PackFile(File *file) :
+		_file(file->Retain()),
+		_toc(nullptr),
+		_names(nullptr)
+	{
+		try
+		{
+			_file->Seek(0);
+
+			if(_file->Read(&_header, sizeof(Header)) != sizeof(Header) || _header.magic != kRNPackFileMagic)
+				throw InvalidPackFileException(RNSTR(file->GetPath() << " is not a pack file"));
+
+			if(_header.version != kRNPackFileVersion)
+				throw InvalidPackFileException(RNSTR(file->GetPath() << " has unsupported version " << _header.version));
+
+			const size_t tocSize = _header.entryCount * sizeof(Entry);
+
+			if((_header.tocOffset % 8) != 0 || _header.tocOffset + tocSize > _file->GetSize() || _header.namesOffset + _header.namesSize > _file->GetSize())
+				throw InvalidPackFileException(RNSTR(file->GetPath() << " is truncated or corrupted"));
+
+			_file->Seek(static_cast<size_t>(_header.tocOffset));
+			_toc = _file->ReadData(tocSize)->Retain();
+
+			_file->Seek(static_cast<size_t>(_header.namesOffset));
+			_names = _file->ReadData(static_cast<size_t>(_header.namesSize))->Retain();
+
+			_entries = _toc->GetBytes<Entry>();
+
+			for(size_t i = 0; i < _header.entryCount; i ++)
+			{
+				const Entry &entry = _entries[i];
+
+				if(entry.offset + entry.size > _file->GetSize() || static_cast<uint64>(entry.nameOffset) + entry.nameLength > _header.namesSize)
+					throw InvalidPackFileException(RNSTR(file->GetPath() << " has an invalid entry at index " << i));
+
+				if(i > 0 && _entries[i - 1].hash > entry.hash)
+					throw InvalidPackFileException(RNSTR(file->GetPath() << " has an unsorted table of contents"));
+			}
+		}
+		catch(...)
+		{
+			SafeRelease(_toc);
+			SafeRelease(_names);
+			_file->Release();
+
+			throw;
+		}
+	}
+
+	PackFile::~PackFile()
+	{
+		_toc->Release();
+		_names->Release();
+		_file->Release();
+	}
+
+	PackFile *PackFile::WithName(const String *name)
+	{
+		File *file = File::WithName(name, File::Mode::Read);
+		PackFile *pack = new PackFile(file);
+
+		return pack->Autorelease();
+	}
+
+
+	const PackFile::Entry *PackFile::GetEntry(const String *name) const
+	{
+		const char *string = name->GetUTF8String();
+		return GetEntry(string, strlen(string));
+	}
+
+	const PackFile::Entry *PackFile::GetEntry(const char *name, size_t length) const
+	{
+		const uint64 hash = HashName(name, length);
+
+		const Entry *end = _entries + _header.entryCount;
+		const Entry *entry = std::lower_bound(_entries, end, hash, [](const Entry &entry, uint64 hash) {
+			return entry.hash < hash;
+		});
+
+		const char *names = _names->GetBytes<char>();
+
+		for(; entry != end && entry->hash == hash; entry ++)
+		{
+			if(entry->nameLength == length && memcmp(names + entry->nameOffset, name, length) == 0)
+				return entry;
+		}
+
+		return nullptr;
+	}
+
+	String *PackFile::GetNameForEntry(const Entry *entry) const
+	{
+		const char *names = _names->GetBytes<char>();
+		return String::WithBytes(names + entry->nameOffset, entry->nameLength, Encoding::UTF8);
+	}
+
+	Data *PackFile::GetDataForEntry(const Entry *entry)
+	{
+		Data *stored;
+
+		{
+			LockGuard<Lockable> lock(_lock);
+
+			_file->Seek(static_cast<size_t>(entry->offset));
+			stored = _file->ReadData(static_cast<size_t>(entry->size));
+		}
+
+		if(stored->GetLength() != entry->size)
+			throw InvalidPackFileException(RNSTR(GetPath() << " is truncated"));
+
+		switch(entry->compression)
+		{
+			case Compression::None:
+				return stored;
+
+			case Compression::LZ4:
+			{
+				const size_t size = static_cast<size_t>(entry->uncompressedSize);
+				uint8 *bytes = static_cast<uint8 *>(malloc(std::max(size, static_cast<size_t>(1))));
+
+				if(!DecompressLZ4(stored->GetBytes<uint8>(), stored->GetLength(), bytes, size))
+				{
+					free(bytes);
+					throw InvalidPackFileException(RNSTR(GetPath() << " has a corrupted entry " << GetNameForEntry(entry)));
+				}
+
+				Data *data = new Data(bytes, size, true, true);
+				return data->Autorelease();
+			}
+
+			default:
+				throw InvalidPackFileException(RNSTR(GetPath() << " uses an unsupported compression for " << GetNameForEntry(entry)));
+		}
+	}
+}
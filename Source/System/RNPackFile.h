@@ -0,0 +1,108 @@
+//
+//  RNPackFile.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_PACKFILE_H_
+#define __RAYNE_PACKFILE_H_
+
+#include "../Base/RNBase.h"
+#include "../Objects/RNObject.h"
+#include "../Objects/RNData.h"
+#include "RNFile.h"
+
+#define kRNPackFileMagic 0x4B504E52 // RNPK
+#define kRNPackFileVersion 1
+
+namespace RN
+{
+	// Archive of files written by Tools/ResourcePacker/packfile.py. The entry data comes first, each entry aligned to the
+	// alignment in the header, followed by the entry names and a table of contents sorted by the hash of the entry names.
+	// All values are little endian.
+	class PackFile : public Object
+	{
+	public:
+		enum class Compression : uint32
+		{
+			None,
+			LZ4, // LZ4 block format
+			Zstd // Reserved, not supported at runtime
+		};
+
+		struct Header
+		{
+			uint32 magic;
+			uint16 version;
+			uint16 reserved0;
+			uint32 entryCount;
+			uint32 alignment;
+			uint64 tocOffset;
+			uint64 namesOffset;
+			uint64 namesSize;
+			uint8 reserved1[24];
+		};
+
+		struct Entry
+		{
+			uint64 hash;
+			uint64 offset;
+			uint64 size; // Stored size
+			uint64 uncompressedSize;
+			uint32 nameOffset;
+			uint32 nameLength;
+			Compression compression;
+			uint32 reserved;
+		};
+
+		RNAPI PackFile(File *file);
+		RNAPI ~PackFile() override;
+
+		RNAPI static PackFile *WithName(const String *name);
+
+		// Names are relative to the root of the pack, using / as separator
+		RNAPI const Entry *GetEntry(const String *name) const;
+		RNAPI const Entry *GetEntry(const char *name, size_t length) const;
+
+		// Returns a view into the pack for uncompressed entries if the pack is memory mapped
+		RNAPI Data *GetDataForEntry(const Entry *entry);
+		RNAPI String *GetNameForEntry(const Entry *entry) const;
+
+		size_t GetCount() const { return _header.entryCount; }
+		const Entry *GetEntryAtIndex(size_t index) const { return _entries + index; }
+
+		const String *GetPath() const { return _file->GetPath(); }
+
+		// FNV-1a
+		static uint64 HashName(const char *name, size_t length)
+		{
+			uint64 hash = 0xcbf29ce484222325ULL;
+
+			for(size_t i = 0; i < length; i ++)
+			{
+				hash ^= static_cast<uint8>(name[i]);
+				hash *= 0x100000001b3ULL;
+			}
+
+			return hash;
+		}
+
+	private:
+		Lockable _lock;
+		File *_file;
+
+		Header _header;
+		Data *_toc;
+		Data *_names;
+		const Entry *_entries;
+
+		__RNDeclareMetaInternal(PackFile)
+	};
+
+	RNExceptionType(InvalidPackFile)
+}
+
+
+#endif /* __RAYNE_PACKFILE_H_ */
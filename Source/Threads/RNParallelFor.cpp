@@ -0,0 +1,138 @@
+//
+//  RNParallelFor.cpp
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "RNParallelFor.h"
+
+#define kRNParallelForProbeIterations 64
+#define kRNParallelForProbeDuration std::chrono::microseconds(20)
+#define kRNParallelForTargetChunkDuration 50000.0 // Nanoseconds
+#define kRNParallelForChunksPerThread 4
+
+namespace RN
+{
+	namespace __Private
+	{
+		ParallelForContext::ParallelForContext(const Range &range, size_t grain) :
+			_length(range.length),
+			_end(range.GetEnd()),
+			_grain(grain),
+			_next(range.origin),
+			_completed(0),
+			_refCount(1)
+		{}
+
+		void ParallelForContext::Retain()
+		{
+			_refCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		void ParallelForContext::Release()
+		{
+			if(_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				delete this;
+		}
+
+		bool ParallelForContext::ExecuteChunk()
+		{
+			size_t begin = _next.fetch_add(_grain, std::memory_order_relaxed);
+			if(begin >= _end)
+				return false;
+
+			size_t end = std::min(begin + _grain, _end);
+			Execute(Range(begin, end - begin));
+
+			size_t count = end - begin;
+			if(_completed.fetch_add(count, std::memory_order_acq_rel) + count == _length)
+			{
+				LockGuard<Lockable> lock(_lock);
+				_signal.NotifyAll();
+			}
+
+			return true;
+		}
+
+		size_t ParallelForContext::ProbeGrain(size_t concurrency)
+		{
+			// Nobody else is working on the range yet, so run the first iterations
+			// one by one on the calling thread and time them
+			const Clock::time_point start = Clock::now();
+			Clock::duration elapsed(0);
+
+			size_t probed = 0;
+
+			while(probed < kRNParallelForProbeIterations)
+			{
+				size_t index = _next.load(std::memory_order_relaxed);
+				if(index >= _end)
+					break;
+
+				_next.store(index + 1, std::memory_order_relaxed);
+				Execute(Range(index, 1));
+
+				probed ++;
+				elapsed = Clock::now() - start;
+
+				if(elapsed >= kRNParallelForProbeDuration)
+					break;
+			}
+
+			_completed.fetch_add(probed, std::memory_order_relaxed);
+
+			size_t remaining = _end - std::min(_end, _next.load(std::memory_order_relaxed));
+			if(remaining == 0)
+				return 1;
+
+			double cost = std::max(1.0, std::chrono::duration<double, std::nano>(elapsed).count() / probed);
+
+			size_t grain = static_cast<size_t>(kRNParallelForTargetChunkDuration / cost);
+			size_t maxGrain = remaining / (concurrency * kRNParallelForChunksPerThread);
+
+			return std::max(static_cast<size_t>(1), std::min(grain, maxGrain));
+		}
+
+		void ParallelForContext::Run(WorkQueue *queue)
+		{
+			if(!queue)
+				queue = WorkQueue::GetGlobalQueue(WorkQueue::Priority::Default);
+
+			const size_t concurrency = queue->GetConcurrency();
+
+			if(_grain == 0)
+				_grain = ProbeGrain(concurrency);
+
+			size_t remaining = _end - std::min(_end, _next.load(std::memory_order_relaxed));
+			size_t chunks = (remaining + _grain - 1) / _grain;
+			size_t helpers = std::min((chunks > 0) ? chunks - 1 : 0, concurrency);
+
+			for(size_t i = 0; i < helpers; i ++)
+			{
+				Retain();
+				queue->Perform([this] {
+
+					while(ExecuteChunk())
+					{}
+
+					Release();
+
+				});
+			}
+
+			// Join instead of waiting
+			while(ExecuteChunk())
+			{}
+
+			if(_completed.load(std::memory_order_acquire) != _length)
+			{
+				// Only chunks that are already being worked on are left
+				UniqueLock<Lockable> lock(_lock);
+				_signal.Wait(lock, [&]() -> bool { return (_completed.load(std::memory_order_acquire) == _length); });
+			}
+
+			Release();
+		}
+	}
+}
@@ -0,0 +1,119 @@
+//
+//  RNParallelFor.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_PARALLELFOR_H__
+#define __RAYNE_PARALLELFOR_H__
+
+#include "../Base/RNBase.h"
+#include "RNWorkQueue.h"
+
+namespace RN
+{
+	namespace __Private
+	{
+		class ParallelForContext
+		{
+		public:
+			RNAPI ParallelForContext(const Range &range, size_t grain);
+
+			// Runs the loop on the queue and joins it on the calling thread, returns once every chunk completed.
+			// Consumes the callers reference.
+			RNAPI void Run(WorkQueue *queue);
+
+		protected:
+			virtual ~ParallelForContext() = default;
+			virtual void Execute(const Range &chunk) = 0;
+
+		private:
+			bool ExecuteChunk();
+			size_t ProbeGrain(size_t concurrency);
+
+			void Retain();
+			void Release();
+
+			size_t _length;
+			size_t _end;
+			size_t _grain;
+
+			std::atomic<size_t> _next;
+			std::atomic<size_t> _completed;
+			std::atomic<size_t> _refCount;
+
+			Lockable _lock;
+			Condition _signal;
+		};
+
+		template<class F>
+		class ParallelForChunkContext : public ParallelForContext
+		{
+		public:
+			ParallelForChunkContext(const Range &range, size_t grain, F &function) :
+				ParallelForContext(range, grain),
+				_function(function)
+			{}
+
+		protected:
+			void Execute(const Range &chunk) final
+			{
+				_function(chunk);
+			}
+
+		private:
+			F &_function;
+		};
+
+		template<class F>
+		class ParallelForIndexContext : public ParallelForContext
+		{
+		public:
+			ParallelForIndexContext(const Range &range, size_t grain, F &function) :
+				ParallelForContext(range, grain),
+				_function(function)
+			{}
+
+		protected:
+			void Execute(const Range &chunk) final
+			{
+				const size_t end = chunk.GetEnd();
+
+				for(size_t i = chunk.origin; i < end; i ++)
+					_function(i);
+			}
+
+		private:
+			F &_function;
+		};
+	}
+
+	// Calls function(index) for every index in range. The work is split into chunks of grain indices, a grain of 0
+	// measures the cost of the first iterations and picks one automatically. The calling thread works on chunks
+	// too instead of blocking, so it's safe to call this from within work queue threads.
+	// Passing no queue uses the default priority global queue.
+	template<class F>
+	void ParallelFor(const Range &range, size_t grain, F &&function, WorkQueue *queue = nullptr)
+	{
+		if(range.length == 0)
+			return;
+
+		auto context = new __Private::ParallelForIndexContext<typename std::remove_reference<F>::type>(range, grain, function);
+		context->Run(queue);
+	}
+
+	// Like ParallelFor, but calls function(const Range &chunk) once per chunk
+	template<class F>
+	void ParallelForChunks(const Range &range, size_t grain, F &&function, WorkQueue *queue = nullptr)
+	{
+		if(range.length == 0)
+			return;
+
+		auto context = new __Private::ParallelForChunkContext<typename std::remove_reference<F>::type>(range, grain, function);
+		context->Run(queue);
+	}
+}
+
+#endif /* __RAYNE_PARALLELFOR_H__ */
@@ -0,0 +1,219 @@
+//
+//  RNTaskGraph.cpp
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "RNTaskGraph.h"
+#include <concurrentqueue.h>
+
+namespace RN
+{
+	RNDefineMeta(TaskGraph, Object)
+
+	class TaskGraph::Task
+	{
+	public:
+		Task(Function &&tfunction) :
+			function(std::move(tfunction)),
+			dependencies(0),
+			pending(0)
+		{}
+
+		Function function;
+		std::vector<Task *> successors;
+
+		size_t dependencies;
+		std::atomic<size_t> pending;
+	};
+
+	struct TaskGraphInternals
+	{
+		moodycamel::ConcurrentQueue<TaskGraph::Task *> ready;
+	};
+
+	TaskGraph::TaskGraph() :
+		_queue(nullptr),
+		_remaining(0),
+		_joiners(0),
+		_running(false)
+	{}
+
+	TaskGraph::~TaskGraph()
+	{
+		for(Task *task : _tasks)
+			delete task;
+
+		for(auto &pair : _waiters)
+		{
+			WorkQueue *queue = std::get<0>(pair);
+			queue->Release();
+		}
+	}
+
+	TaskGraph::Task *TaskGraph::AddTask(Function &&function)
+	{
+		RN_ASSERT(!_running, "Tasks can't be added to a running TaskGraph");
+
+		Task *task = new Task(std::move(function));
+		_tasks.push_back(task);
+
+		return task;
+	}
+
+	void TaskGraph::AddDependency(Task *task, Task *dependency)
+	{
+		RN_ASSERT(!_running, "Dependencies can't be added to a running TaskGraph");
+
+		dependency->successors.push_back(task);
+		task->dependencies ++;
+	}
+
+	void TaskGraph::Run(WorkQueue *queue)
+	{
+		{
+			LockGuard<Lockable> lock(_lock);
+
+			RN_ASSERT(!_running, "TaskGraph is already running");
+			_running = true;
+		}
+
+		_queue = queue ? queue : WorkQueue::GetGlobalQueue(WorkQueue::Priority::Default);
+		_remaining.store(_tasks.size(), std::memory_order_relaxed);
+
+		for(Task *task : _tasks)
+			task->pending.store(task->dependencies, std::memory_order_relaxed);
+
+		Retain(); // Balanced in Complete()
+
+		if(_tasks.empty())
+		{
+			Complete();
+			return;
+		}
+
+		bool hasRoots = false;
+
+		for(Task *task : _tasks)
+		{
+			if(task->dependencies == 0)
+			{
+				Schedule(task);
+				hasRoots = true;
+			}
+		}
+
+		RN_ASSERT(hasRoots, "TaskGraph has no task without dependencies");
+	}
+
+	void TaskGraph::Schedule(Task *task)
+	{
+		_internals->ready.enqueue(task);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		// Whoever comes first executes the task, either the queue or a joining thread
+		Retain();
+		_queue->Perform([this] {
+
+			ExecuteReadyTask();
+			Release();
+
+		});
+
+		if(_joiners.load(std::memory_order_relaxed) > 0)
+		{
+			LockGuard<Lockable> lock(_lock);
+			_signal.NotifyAll();
+		}
+	}
+
+	bool TaskGraph::ExecuteReadyTask()
+	{
+		Task *task;
+		if(!_internals->ready.try_dequeue(task))
+			return false;
+
+		Execute(task);
+		return true;
+	}
+
+	void TaskGraph::Execute(Task *task)
+	{
+		task->function();
+
+		for(Task *successor : task->successors)
+		{
+			if(successor->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				Schedule(successor);
+		}
+
+		if(_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			Complete();
+	}
+
+	void TaskGraph::Complete()
+	{
+		{
+			LockGuard<Lockable> lock(_lock);
+
+			_running = false;
+			_signal.NotifyAll();
+
+			for(auto &pair : _waiters)
+			{
+				WorkQueue *queue = std::get<0>(pair);
+				queue->Perform(std::move(std::get<1>(pair)));
+				queue->Release();
+			}
+
+			_waiters.clear();
+		}
+
+		Release();
+	}
+
+	void TaskGraph::Wait()
+	{
+		while(_remaining.load(std::memory_order_acquire) > 0)
+		{
+			if(ExecuteReadyTask())
+				continue;
+
+			_joiners.fetch_add(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			{
+				UniqueLock<Lockable> lock(_lock);
+				_signal.Wait(lock, [&]() -> bool {
+					return (!_running || _internals->ready.size_approx() > 0);
+				});
+			}
+
+			_joiners.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		// Complete() might still be finishing up
+		UniqueLock<Lockable> lock(_lock);
+		_signal.Wait(lock, [&]() -> bool { return !_running; });
+	}
+
+	bool TaskGraph::IsComplete() const
+	{
+		return (_remaining.load(std::memory_order_acquire) == 0);
+	}
+
+	void TaskGraph::Notify(WorkQueue *queue, Function &&function)
+	{
+		LockGuard<Lockable> lock(_lock);
+
+		if(!_running)
+		{
+			queue->Perform(std::move(function));
+			return;
+		}
+
+		_waiters.push_back(std::make_pair(queue->Retain(), std::move(function)));
+	}
+}
@@ -0,0 +1,68 @@
+//
+//  RNTaskGraph.h
+//  Rayne
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#ifndef __RAYNE_TASKGRAPH_H__
+#define __RAYNE_TASKGRAPH_H__
+
+#include "../Base/RNBase.h"
+#include "../Objects/RNObject.h"
+#include "RNWorkQueue.h"
+
+namespace RN
+{
+	struct TaskGraphInternals;
+
+	// A set of tasks with dependencies between them. Tasks become ready once all of their
+	// dependencies completed and are then executed on the work queue. A graph can be run again
+	// once it completed, but tasks and dependencies can only be added while it's not running.
+	class TaskGraph : public Object
+	{
+	public:
+		class Task;
+
+		RNAPI TaskGraph();
+		RNAPI ~TaskGraph();
+
+		RNAPI Task *AddTask(Function &&function);
+		RNAPI void AddDependency(Task *task, Task *dependency);
+
+		RNAPI void Run(WorkQueue *queue = nullptr);
+
+		// Executes ready tasks on the calling thread until the graph completed
+		RNAPI void Wait();
+		RNAPI bool IsComplete() const;
+
+		// Performs the function on the queue once the current run completed
+		RNAPI void Notify(WorkQueue *queue, Function &&function);
+
+	private:
+		void Schedule(Task *task);
+		bool ExecuteReadyTask();
+		void Execute(Task *task);
+		void Complete();
+
+		std::vector<Task *> _tasks;
+		WorkQueue *_queue;
+
+		std::atomic<size_t> _remaining;
+		std::atomic<size_t> _joiners;
+		bool _running;
+
+		Lockable _lock;
+		Condition _signal;
+		std::vector<std::pair<WorkQueue *, Function>> _waiters;
+
+		PIMPL<TaskGraphInternals> _internals;
+
+		__RNDeclareMetaInternal(TaskGraph)
+	};
+
+	RNObjectClass(TaskGraph)
+}
+
+#endif /* __RAYNE_TASKGRAPH_H__ */
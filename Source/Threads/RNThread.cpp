@@ -10,6 +10,7 @@
 #include "RNThreadLocalStorage.h"
 #include "../Base/RNBaseInternal.h"
 #include "../Objects/RNAutoreleasePool.h"
+#include "../Debug/RNProfiler.h"
 
 #if RN_PLATFORM_WINDOWS
 const DWORD MS_VC_EXCEPTION = 0x406D1388;
@@ -53,6 +54,8 @@ void RNSetThreadName(char *threadName)
 #if RN_ENABLE_VTUNE
 		__itt_thread_set_nameA(threadName);
 #endif
+
+	RN::Profiler::GetSharedInstance()->SetThreadName(threadName);
 }
 
 namespace RN
@@ -9,6 +9,7 @@
 #include "RNWorkQueue.h"
 #include "RNThreadLocalStorage.h"
 #include "../Objects/RNAutoreleasePool.h"
+#include "../Data/RNWorkStealingDeque.h"
 #include <concurrentqueue.h>
 
 #if RN_PLATFORM_INTEL
@@ -40,20 +41,103 @@
 #define ConditionalSpin(e, result) RNConditionalSpin(e, 10535U, result)
 #define ConditionalSpinLow(e, result) RNConditionalSpin(e, 512U, result)
 
+#define kRNWorkQueueMinSpin 64
+#define kRNWorkQueueMaxSpin 8192
+#define kRNWorkQueueMaxPause 64
+#define kRNWorkQueueYieldRounds 4
+#define kRNWorkQueueDequeSize 1024
+#define kRNWorkQueueBatchSize 8
+
 namespace RN
 {
 	RNDefineMeta(WorkQueue, Object)
 
+	// Bounded exponential backoff used by work stealing queues instead of the fixed spin counts.
+	// The pause budget grows when spinning paid off and shrinks when it didn't.
+	class WorkQueueBackoff
+	{
+	public:
+		WorkQueueBackoff() :
+			_budget(512)
+		{}
+
+		template<class Predicate>
+		bool SpinUntil(Predicate &&predicate)
+		{
+			size_t spent = 0;
+			size_t pauses = 1;
+
+			while(spent < _budget)
+			{
+				if(predicate())
+				{
+					_budget = std::min(static_cast<size_t>(kRNWorkQueueMaxSpin), std::max(_budget, spent * 2));
+					return true;
+				}
+
+				for(size_t i = 0; i < pauses; i ++)
+					RNHardwarePause();
+
+				spent += pauses;
+				pauses = std::min(pauses * 2, static_cast<size_t>(kRNWorkQueueMaxPause));
+			}
+
+			for(size_t i = 0; i < kRNWorkQueueYieldRounds; i ++)
+			{
+				if(predicate())
+					return true;
+
+				std::this_thread::yield();
+			}
+
+			_budget = std::max(static_cast<size_t>(kRNWorkQueueMinSpin), _budget / 2);
+			return predicate();
+		}
+
+	private:
+		size_t _budget;
+	};
+
+	struct WorkQueueWorker
+	{
+		WorkQueueWorker(WorkQueue *tqueue, size_t tindex) :
+			queue(tqueue),
+			index(tindex),
+			active(false),
+			seed(static_cast<uint32>(tindex * 2654435761U + 1))
+		{}
+
+		WorkQueue *queue;
+		size_t index;
+		std::atomic<bool> active;
+		uint32 seed;
+
+		WorkQueueBackoff backoff;
+		WorkStealingDeque<WorkSource *, kRNWorkQueueDequeSize> deque;
+	};
+
 	struct WorkQueueInternals
 	{
 		WorkQueueInternals() :
-			workQueue(4096)
+			workQueue(4096),
+			unlockedDequeues(0)
 		{}
 
+		~WorkQueueInternals()
+		{
+			for(WorkQueueWorker *worker : workers)
+				delete worker;
+		}
+
 		Condition workSignal;
 		Lockable workLock;
 
 		moodycamel::ConcurrentQueue<WorkSource *> workQueue;
+
+		// Work stealing, empty for queues that don't steal
+		std::vector<WorkQueueWorker *> workers;
+		std::atomic<size_t> unlockedDequeues;
+		Lockable dequeueLock;
 	};
 
 	// Private queue flags
@@ -61,12 +145,13 @@ namespace RN
 
 	static WorkQueue *__WorkQueues[4];
 	static ThreadLocalStorage<WorkQueue *> __LocalWorkQueues;
+	static ThreadLocalStorage<WorkQueueWorker *> __LocalWorkers;
 
 	void WorkQueue::InitializeQueues()
 	{
-		__WorkQueues[0] = new WorkQueue(Priority::High, Flags::Concurrent, RNCSTR("net.uberpixel.rayne.queue.high"));
-		__WorkQueues[1] = new WorkQueue(Priority::Default, Flags::Concurrent, RNCSTR("net.uberpixel.rayne.queue.default"));
-		__WorkQueues[2] = new WorkQueue(Priority::Background, Flags::Concurrent, RNCSTR("net.uberpixel.rayne.queue.background"));
+		__WorkQueues[0] = new WorkQueue(Priority::High, Flags::Concurrent | Flags::WorkStealing, RNCSTR("net.uberpixel.rayne.queue.high"));
+		__WorkQueues[1] = new WorkQueue(Priority::Default, Flags::Concurrent | Flags::WorkStealing, RNCSTR("net.uberpixel.rayne.queue.default"));
+		__WorkQueues[2] = new WorkQueue(Priority::Background, Flags::Concurrent | Flags::WorkStealing, RNCSTR("net.uberpixel.rayne.queue.background"));
 		__WorkQueues[3] = new WorkQueue(Priority::Default, kRNWorkQueueFlagMainThread, RNCSTR("net.uberpixel.rayne.queue.main"));
 	}
 
@@ -91,6 +176,7 @@ namespace RN
 		_running(0),
 		_sleeping(0),
 		_suspended(0),
+		_pendingBarriers(0),
 		_barrier(false)
 	{
 		size_t multiplier = 16;
@@ -115,6 +201,13 @@ namespace RN
 		_concurrency = std::max(static_cast<size_t>(2), _concurrency);
 		_concurrency = std::min(_concurrency, maxThreads);
 		_threshold = _concurrency * multiplier;
+
+		// Work stealing only makes sense with more than one thread
+		if((_flags & Flags::WorkStealing) && (_flags & Flags::Concurrent))
+		{
+			for(size_t i = 0; i < _concurrency; i ++)
+				_internals->workers.push_back(new WorkQueueWorker(this, i));
+		}
 	}
 
 	WorkQueue::~WorkQueue()
@@ -202,10 +295,42 @@ namespace RN
 	{
 		WorkSource *source = WorkSource::DequeueWorkSource(std::move(function), flags);
 
-		_internals->workQueue.enqueue(source);
-		_open.fetch_add(1, std::memory_order_relaxed);
+		if(!_internals->workers.empty())
+		{
+			_open.fetch_add(1, std::memory_order_relaxed);
 
-		if(flags & WorkSource::Flags::Barrier)
+			if(flags & WorkSource::Flags::Barrier)
+			{
+				// Announce the barrier and wait for lock free batch dequeues that didn't see it yet to finish.
+				// Afterwards the shared queue is only consumed under the dequeue lock until the barrier
+				// completed, so nothing enqueued after the barrier can run ahead of it.
+				_pendingBarriers.fetch_add(1, std::memory_order_seq_cst);
+
+				while(_internals->unlockedDequeues.load(std::memory_order_seq_cst) > 0)
+					RNHardwarePause();
+
+				_internals->workQueue.enqueue(source);
+			}
+			else
+			{
+				// Work spawned from one of our own workers goes into its local deque
+				WorkQueueWorker *worker = __LocalWorkers.GetValue();
+				bool pushed = false;
+
+				if(worker && worker->queue == this && !(flags & WorkSource::Flags::Synchronous) && _pendingBarriers.load(std::memory_order_acquire) == 0)
+					pushed = worker->deque.Push(source);
+
+				if(!pushed)
+					_internals->workQueue.enqueue(source);
+			}
+		}
+		else
+		{
+			_internals->workQueue.enqueue(source);
+			_open.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		if((flags & WorkSource::Flags::Barrier) && _internals->workers.empty())
 		{
 			// Push _concurrency BarrierBlock work sources to keep other threads
 			// from running over the barrier. This works because threads encountering a BarrierBlock
@@ -234,6 +359,12 @@ namespace RN
 
 	bool WorkQueue::PerformWork()
 	{
+		if(!_internals->workers.empty())
+		{
+			WorkQueueWorker *worker = __LocalWorkers.GetValue();
+			return PerformStealingWork((worker && worker->queue == this) ? worker : nullptr);
+		}
+
 		bool result;
 		ConditionalSpin(_suspended.load(std::memory_order_acquire) == 0, result);
 
@@ -327,7 +458,12 @@ namespace RN
 			}
 		}
 
+		FinishWorkSource(source);
+		return true;
+	}
 
+	void WorkQueue::FinishWorkSource(WorkSource *source)
+	{
 		if(source->TestFlag(WorkSource::Flags::Synchronous))
 		{
 			// Synchronous work sources aren't immediately relinquished but
@@ -338,13 +474,244 @@ namespace RN
 			source->Complete();
 			_syncSignal.NotifyAll();
 
-			return true;
+			return;
 		}
 
 		source->Relinquish();
+	}
+
+	bool WorkQueue::PerformStealingWork(WorkQueueWorker *worker)
+	{
+		WorkQueueBackoff fallbackBackoff;
+		WorkQueueBackoff &backoff = worker ? worker->backoff : fallbackBackoff;
+
+		if(!backoff.SpinUntil([&]{ return (_suspended.load(std::memory_order_acquire) == 0); }))
+		{
+			UniqueLock<Lockable> lock(_internals->workLock);
+			_internals->workSignal.Wait(lock, [&]() -> bool { return (_suspended.load(std::memory_order_acquire) == 0); });
+		}
+
+		// Local work predates any pending barrier, so only park on the barrier without any
+		if(!worker || worker->deque.WasEmpty())
+		{
+			if(!backoff.SpinUntil([&]{ return (_barrier.load(std::memory_order_acquire) == false); }))
+			{
+				UniqueLock<Lockable> lock(_barrierLock);
+				_barrierSignal.Wait(lock, [&]() -> bool { return (_barrier.load(std::memory_order_acquire) == false); });
+			}
+		}
+
+		// The worker counts as running before it grabs work, otherwise a barrier
+		// could observe empty deques and no running work while a stolen source is in flight
+		WorkSource *source = nullptr;
+		bool result = backoff.SpinUntil([&]() -> bool {
+
+			_running.fetch_add(1, std::memory_order_seq_cst);
+
+			if(DequeueStealingWork(worker, source))
+				return true;
+
+			_running.fetch_sub(1, std::memory_order_release);
+			return false;
+
+		});
+
+		if(!result)
+			return false;
+
+		_open.fetch_sub(1, std::memory_order_relaxed);
+
+		if(source->TestFlag(WorkSource::Flags::Barrier))
+		{
+			PerformStealingBarrier(worker, source);
+			return true;
+		}
+
+		// Call out and perform the work
+		std::atomic_thread_fence(std::memory_order_acquire);
+		source->Callout();
+		std::atomic_thread_fence(std::memory_order_release);
+
+		if(_barrier.load(std::memory_order_acquire))
+		{
+			// A barrier is waiting to execute, signal it to be ready if needed
+			LockGuard<Lockable> lock(_barrierLock);
+			if((--_running) == 1)
+				_barrierSignal.NotifyAll();
+		}
+		else
+		{
+			_running.fetch_sub(1, std::memory_order_release);
+		}
+
+		FinishWorkSource(source);
 		return true;
 	}
 
+	bool WorkQueue::DequeueStealingWork(WorkQueueWorker *worker, WorkSource *&source)
+	{
+		if(worker && worker->deque.Pop(source))
+			return true;
+
+		WorkQueueInternals *internals = _internals;
+
+		if(_pendingBarriers.load(std::memory_order_seq_cst) == 0)
+		{
+			internals->unlockedDequeues.fetch_add(1, std::memory_order_seq_cst);
+
+			if(_pendingBarriers.load(std::memory_order_seq_cst) == 0)
+			{
+				// Grab a batch from the shared queue and make the surplus available to thieves
+				WorkSource *batch[kRNWorkQueueBatchSize];
+
+				size_t capacity = 1;
+				if(worker)
+					capacity = std::min(static_cast<size_t>(kRNWorkQueueBatchSize), 1 + (worker->deque.GetCapacity() - worker->deque.GetSize()));
+
+				size_t count = internals->workQueue.try_dequeue_bulk(batch, capacity);
+				internals->unlockedDequeues.fetch_sub(1, std::memory_order_release);
+
+				if(count > 0)
+				{
+					// Reverse order so the local pops continue with the oldest source of the batch
+					for(size_t i = count - 1; i >= 1; i --)
+						worker->deque.Push(batch[i]);
+
+					source = batch[0];
+					return true;
+				}
+
+				return StealWork(worker, source);
+			}
+
+			internals->unlockedDequeues.fetch_sub(1, std::memory_order_release);
+		}
+
+		{
+			// A barrier is pending, consume the shared queue one by one and stop as soon as the barrier got picked up
+			LockGuard<Lockable> lock(internals->dequeueLock);
+
+			if(!_barrier.load(std::memory_order_acquire) && internals->workQueue.try_dequeue(source))
+			{
+				if(source->TestFlag(WorkSource::Flags::Barrier))
+					_barrier.store(true, std::memory_order_seq_cst);
+
+				return true;
+			}
+		}
+
+		return StealWork(worker, source);
+	}
+
+	bool WorkQueue::StealWork(WorkQueueWorker *worker, WorkSource *&source)
+	{
+		const std::vector<WorkQueueWorker *> &workers = _internals->workers;
+		const size_t count = workers.size();
+
+		size_t start = 0;
+		if(worker)
+		{
+			// xorshift32 to spread the victims
+			worker->seed ^= worker->seed << 13;
+			worker->seed ^= worker->seed >> 17;
+			worker->seed ^= worker->seed << 5;
+
+			start = worker->seed % count;
+		}
+
+		for(size_t i = 0; i < count; i ++)
+		{
+			WorkQueueWorker *victim = workers[(start + i) % count];
+
+			if(victim != worker && victim->deque.Steal(source))
+				return true;
+		}
+
+		return false;
+	}
+
+	void WorkQueue::PerformStealingBarrier(WorkQueueWorker *worker, WorkSource *source)
+	{
+		const std::vector<WorkQueueWorker *> &workers = _internals->workers;
+
+		auto isQuiescent = [&]() -> bool {
+
+			if(_running.load(std::memory_order_seq_cst) != 1)
+				return false;
+
+			for(WorkQueueWorker *candidate : workers)
+			{
+				if(!candidate->deque.WasEmpty())
+					return false;
+			}
+
+			// Re-check, a thief might have grabbed the last source in between
+			return (_running.load(std::memory_order_seq_cst) == 1);
+
+		};
+
+		// Everything left in the deques was submitted before the barrier,
+		// so help draining it instead of just waiting for other workers
+		WorkQueueBackoff backoff;
+
+		while(!isQuiescent())
+		{
+			WorkSource *pending;
+			if((worker && worker->deque.Pop(pending)) || StealWork(worker, pending))
+			{
+				_open.fetch_sub(1, std::memory_order_relaxed);
+
+				std::atomic_thread_fence(std::memory_order_acquire);
+				pending->Callout();
+				std::atomic_thread_fence(std::memory_order_release);
+
+				FinishWorkSource(pending);
+				continue;
+			}
+
+			if(!backoff.SpinUntil([&]{ return (_running.load(std::memory_order_acquire) == 1); }))
+			{
+				UniqueLock<Lockable> lock(_barrierLock);
+				_barrierSignal.WaitFor(lock, std::chrono::milliseconds(1), [&]() -> bool {
+					return (_running.load(std::memory_order_acquire) == 1);
+				});
+			}
+		}
+
+		// Call out and perform the work
+		std::atomic_thread_fence(std::memory_order_acquire);
+		source->Callout();
+		std::atomic_thread_fence(std::memory_order_release);
+
+		{
+			// Signal that the barrier is done
+			LockGuard<Lockable> lock(_barrierLock);
+			_running.fetch_sub(1, std::memory_order_relaxed);
+			_pendingBarriers.fetch_sub(1, std::memory_order_relaxed);
+			_barrier.store(false, std::memory_order_relaxed);
+			_barrierSignal.NotifyAll();
+		}
+
+		FinishWorkSource(source);
+	}
+
+	WorkQueueWorker *WorkQueue::AcquireWorker()
+	{
+		for(WorkQueueWorker *worker : _internals->workers)
+		{
+			bool expected = false;
+			if(worker->active.compare_exchange_strong(expected, true, std::memory_order_acquire))
+				return worker;
+		}
+
+		return nullptr;
+	}
+	void WorkQueue::RelinquishWorker(WorkQueueWorker *worker)
+	{
+		if(worker)
+			worker->active.store(false, std::memory_order_release);
+	}
+
 	bool WorkQueue::PerformWorkWithTimeout(uint32 timeout)
 	{
 		Thread *thread = Thread::GetCurrentThread();
@@ -352,12 +719,20 @@ namespace RN
 
 		__LocalWorkQueues.SetValue(this);
 
+		WorkQueueWorker *worker = __LocalWorkers.GetValue();
+		if(worker && worker->queue != this)
+			worker = nullptr;
+
 		while(!thread->IsCancelled())
 		{
 			if(!PerformWork())
 			{
 				bool result;
-				ConditionalSpin(_open.load(std::memory_order_acquire) > 0, result);
+
+				if(worker)
+					result = worker->backoff.SpinUntil([&]{ return (_open.load(std::memory_order_acquire) > 0); });
+				else
+					ConditionalSpin(_open.load(std::memory_order_acquire) > 0, result);
 
 				if(!result)
 				{
@@ -389,7 +764,16 @@ namespace RN
 
 	void WorkQueue::ThreadEntry()
 	{
-		if(!PerformWorkWithTimeout(500))
+		WorkQueueWorker *worker = AcquireWorker();
+		__LocalWorkers.SetValue(worker);
+
+		bool cancelled = PerformWorkWithTimeout(500);
+
+		// The deque is guaranteed to be empty here, resigning only happens without open work
+		__LocalWorkers.SetValue(nullptr);
+		RelinquishWorker(worker);
+
+		if(!cancelled)
 		{
 			Thread *thread = Thread::GetCurrentThread();
 
@@ -18,6 +18,7 @@ namespace RN
 {
 	class Kernel;
 	struct WorkQueueInternals;
+	struct WorkQueueWorker;
 
 	class WorkQueue : public Object
 	{
@@ -26,7 +27,8 @@ namespace RN
 
 		RN_OPTIONS(Flags, uint32,
 				   Serial = 0,
-				   Concurrent = (1 << 0));
+				   Concurrent = (1 << 0),
+				   WorkStealing = (1 << 1));
 
 		enum class Priority : uint32
 		{
@@ -150,6 +152,7 @@ namespace RN
 		RNAPI void Resume();
 
 		RNAPI bool CanYield() const;
+		size_t GetConcurrency() const { return _concurrency; }
 
 	private:
 		static void InitializeQueues();
@@ -163,6 +166,15 @@ namespace RN
 		bool PerformWorkWithTimeout(uint32 timeout);
 		bool PerformWork();
 
+		bool PerformStealingWork(WorkQueueWorker *worker);
+		bool DequeueStealingWork(WorkQueueWorker *worker, WorkSource *&source);
+		bool StealWork(WorkQueueWorker *worker, WorkSource *&source);
+		void PerformStealingBarrier(WorkQueueWorker *worker, WorkSource *source);
+		void FinishWorkSource(WorkSource *source);
+
+		WorkQueueWorker *AcquireWorker();
+		void RelinquishWorker(WorkQueueWorker *worker);
+
 		void ReCalculateWidth();
 
 		String *_identifier;
@@ -179,6 +191,7 @@ namespace RN
 		std::atomic<size_t> _running;
 		std::atomic<size_t> _sleeping;
 		std::atomic<size_t> _suspended;
+		std::atomic<size_t> _pendingBarriers;
 		std::atomic<bool> _barrier;
 
 		Condition _barrierSignal;
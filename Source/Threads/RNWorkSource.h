@@ -10,14 +10,13 @@
 #define __RANYE_WORKSOURCE_H__
 
 #include "../Base/RNBase.h"
+#include "../Debug/RNProfiler.h"
 
 namespace RN
 {
-	struct WorkSourcePool;
 	struct WorkSource
 	{
 	public:
-		friend struct WorkSourcePool;
 		friend class WorkQueue;
 
 		RN_OPTIONS(Flags, uint32,
@@ -30,19 +29,22 @@ namespace RN
 		bool TestFlag(Flags flags) const { return (_flags & flags); }
 		bool IsComplete() const { return _completed; }
 
-		void Callout() { _function(); }
+		void Callout()
+		{
+			RN_PROFILE_ZONE("WorkQueue job");
+			_function();
+		}
 		void Complete() { _completed = true; }
 		void Relinquish();
 
 	private:
-		WorkSource(Function &&function, Flags flags, WorkSourcePool *pool);
-		void Refurbish(Function &&function, Flags flags);
+		WorkSource(Function &&function, Flags flags);
 
 		Function _function;
 		Flags _flags;
-		WorkSourcePool *_pool;
 		std::atomic<bool> _completed;
-		WorkSource *_next;
+
+		RNDeclarePooledAllocation()
 	};
 }
 
@@ -0,0 +1,283 @@
+//
+//  DictionaryBenchmark.cpp
+//  Rayne Benchmarks
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include <Rayne.h>
+
+// The chaining hash table Dictionary used to be built on, with a heap allocated bucket per entry over a prime sized table
+class LegacyDictionary
+{
+public:
+	LegacyDictionary() :
+		_primitive(0),
+		_count(0)
+	{
+		_buckets.resize(kCapacity[0], nullptr);
+	}
+
+	LegacyDictionary(const LegacyDictionary &other) :
+		_primitive(other._primitive),
+		_count(other._count)
+	{
+		_buckets.resize(other._buckets.size(), nullptr);
+
+		for(size_t i = 0; i < other._buckets.size(); i ++)
+		{
+			for(Bucket *bucket = other._buckets[i]; bucket; bucket = bucket->next)
+				_buckets[i] = new Bucket(bucket->key->Retain(), bucket->object->Retain(), _buckets[i]);
+		}
+	}
+
+	~LegacyDictionary()
+	{
+		Clear();
+	}
+
+	RN::Object *GetObjectForKey(const RN::Object *key) const
+	{
+		for(Bucket *bucket = _buckets[key->GetHash() % _buckets.size()]; bucket; bucket = bucket->next)
+		{
+			if(bucket->key->IsEqual(key))
+				return bucket->object->Downcast<RN::Object>(); // Like Dictionary::GetObjectForKey()
+		}
+
+		return nullptr;
+	}
+
+	void SetObjectForKey(RN::Object *object, const RN::Object *key)
+	{
+		Bucket *&head = _buckets[key->GetHash() % _buckets.size()];
+
+		for(Bucket *bucket = head; bucket; bucket = bucket->next)
+		{
+			if(bucket->key->IsEqual(key))
+			{
+				object->Retain();
+				bucket->object->Release();
+				bucket->object = object;
+
+				return;
+			}
+		}
+
+		head = new Bucket(key->Retain(), object->Retain(), head);
+
+		if((++ _count) >= kMaxCount[_primitive])
+			Rehash(_primitive + 1);
+	}
+
+	void RemoveObjectForKey(const RN::Object *key)
+	{
+		for(Bucket **link = &_buckets[key->GetHash() % _buckets.size()]; *link; link = &(*link)->next)
+		{
+			Bucket *bucket = *link;
+
+			if(bucket->key->IsEqual(key))
+			{
+				*link = bucket->next;
+				delete bucket;
+
+				_count --;
+				return;
+			}
+		}
+	}
+
+private:
+	struct Bucket
+	{
+		Bucket(const RN::Object *tkey, RN::Object *tobject, Bucket *tnext) :
+			key(tkey),
+			object(tobject),
+			next(tnext)
+		{}
+
+		~Bucket()
+		{
+			key->Release();
+			object->Release();
+		}
+
+		const RN::Object *key;
+		RN::Object *object;
+		Bucket *next;
+	};
+
+	static constexpr size_t kCapacity[] = { 3, 7, 13, 23, 41, 71, 127, 191, 251, 383, 631, 1087, 1723, 2803, 4523, 7351, 11959, 19447, 31231, 50683 };
+	static constexpr size_t kMaxCount[] = { 3, 6, 11, 19, 32, 52, 85, 118, 155, 237, 390, 672, 1065, 1732, 2795, 4543, 7391, 12019, 19302, 31324 };
+
+	void Rehash(size_t primitive)
+	{
+		std::vector<Bucket *> buckets(kCapacity[primitive], nullptr);
+
+		for(Bucket *bucket : _buckets)
+		{
+			while(bucket)
+			{
+				Bucket *next = bucket->next;
+				Bucket *&head = buckets[bucket->key->GetHash() % buckets.size()];
+
+				bucket->next = head;
+				head = bucket;
+
+				bucket = next;
+			}
+		}
+
+		_buckets = std::move(buckets);
+		_primitive = primitive;
+	}
+
+	void Clear()
+	{
+		for(Bucket *bucket : _buckets)
+		{
+			while(bucket)
+			{
+				Bucket *next = bucket->next;
+				delete bucket;
+
+				bucket = next;
+			}
+		}
+	}
+
+	std::vector<Bucket *> _buckets;
+	size_t _primitive;
+	size_t _count;
+};
+
+constexpr size_t LegacyDictionary::kCapacity[];
+constexpr size_t LegacyDictionary::kMaxCount[];
+
+struct LegacyBackend
+{
+	typedef LegacyDictionary Type;
+
+	static Type *Create() { return new Type(); }
+	static Type *Copy(const Type *other) { return new Type(*other); }
+	static void Destroy(Type *dictionary) { delete dictionary; }
+};
+
+struct DictionaryBackend
+{
+	typedef RN::Dictionary Type;
+
+	static Type *Create() { return new Type(); }
+	static Type *Copy(const Type *other) { return new Type(other); }
+	static void Destroy(Type *dictionary) { dictionary->Release(); }
+};
+
+static const size_t kIterations = 2000000;
+static std::atomic<size_t> __sink(0);
+
+static std::vector<RN::Object *> __keys;
+static std::vector<RN::Object *> __equalKeys; // Equal to __keys, but different objects
+static std::vector<RN::Object *> __missingKeys;
+
+// Material uniform and asset setting sized dictionaries, filled up and looked up over and over again
+template<class Backend>
+static void Lookup(size_t count, const std::vector<RN::Object *> &keys)
+{
+	typename Backend::Type *dictionary = Backend::Create();
+
+	for(size_t i = 0; i < count; i ++)
+		dictionary->SetObjectForKey(__keys[i], __keys[i]);
+
+	size_t found = 0;
+
+	for(size_t i = 0; i < kIterations; i ++)
+		found += (dictionary->GetObjectForKey(keys[i % count]) != nullptr);
+
+	__sink += found;
+	Backend::Destroy(dictionary);
+}
+
+template<class Backend>
+static void Churn(size_t count)
+{
+	typename Backend::Type *dictionary = Backend::Create();
+
+	for(size_t i = 0; i < kIterations; i ++)
+	{
+		RN::Object *key = __keys[(i * 7) % count];
+
+		if(i & 1)
+			dictionary->RemoveObjectForKey(key);
+		else
+			dictionary->SetObjectForKey(key, key);
+	}
+
+	Backend::Destroy(dictionary);
+}
+
+template<class Backend>
+static void Copy(size_t count)
+{
+	typename Backend::Type *dictionary = Backend::Create();
+
+	for(size_t i = 0; i < count; i ++)
+		dictionary->SetObjectForKey(__keys[i], __keys[i]);
+
+	for(size_t i = 0; i < kIterations / count; i ++)
+		Backend::Destroy(Backend::Copy(dictionary));
+
+	Backend::Destroy(dictionary);
+}
+
+template<class Function>
+static double Time(Function &&function, size_t operations)
+{
+	function();
+
+	const auto start = std::chrono::steady_clock::now();
+	function();
+	const auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / operations;
+}
+
+static void Measure(const char *name, double legacy, double dictionary)
+{
+	printf("%-20s %8.2f ns %8.2f ns %6.2fx\n", name, legacy, dictionary, legacy / dictionary);
+}
+
+int main(int argc, const char *argv[])
+{
+	RN::AutoreleasePool pool;
+
+	for(size_t i = 0; i < 4096; i ++)
+	{
+		__keys.push_back(RN::String::WithFormat("uniform.%d", static_cast<int>(i))->Retain());
+		__equalKeys.push_back(RN::String::WithFormat("uniform.%d", static_cast<int>(i))->Retain());
+		__missingKeys.push_back(RN::String::WithFormat("missing.%d", static_cast<int>(i))->Retain());
+	}
+
+	printf("%-20s %11s %11s %7s\n", "", "Legacy", "Dictionary", "Speedup");
+
+	for(size_t count : { 16, 256, 4096 })
+	{
+		char name[64];
+
+		snprintf(name, sizeof(name), "Hit (%zu)", count);
+		Measure(name, Time([&]{ Lookup<LegacyBackend>(count, __equalKeys); }, kIterations), Time([&]{ Lookup<DictionaryBackend>(count, __equalKeys); }, kIterations));
+
+		snprintf(name, sizeof(name), "Same key hit (%zu)", count);
+		Measure(name, Time([&]{ Lookup<LegacyBackend>(count, __keys); }, kIterations), Time([&]{ Lookup<DictionaryBackend>(count, __keys); }, kIterations));
+
+		snprintf(name, sizeof(name), "Miss (%zu)", count);
+		Measure(name, Time([&]{ Lookup<LegacyBackend>(count, __missingKeys); }, kIterations), Time([&]{ Lookup<DictionaryBackend>(count, __missingKeys); }, kIterations));
+
+		snprintf(name, sizeof(name), "Insert/remove (%zu)", count);
+		Measure(name, Time([&]{ Churn<LegacyBackend>(count); }, kIterations), Time([&]{ Churn<DictionaryBackend>(count); }, kIterations));
+
+		snprintf(name, sizeof(name), "Copy (%zu)", count);
+		Measure(name, Time([&]{ Copy<LegacyBackend>(count); }, kIterations), Time([&]{ Copy<DictionaryBackend>(count); }, kIterations));
+	}
+
+	return (__sink > 0) ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+//
+//  FunctionBenchmark.cpp
+//  Rayne Benchmarks
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include <Rayne.h>
+
+// Function without inline storage, every callable is allocated from the system allocator
+class LegacyFunction
+{
+public:
+	LegacyFunction() = default;
+
+	template<typename F>
+	LegacyFunction(F &&f) :
+		_implementation(new ImplementationType<F>(std::move(f)))
+	{}
+
+	LegacyFunction(LegacyFunction &&other) = default;
+	LegacyFunction &operator=(LegacyFunction &&other) = default;
+
+	void operator() () { _implementation->Call(); }
+
+private:
+	struct Base
+	{
+		virtual void Call() = 0;
+		virtual ~Base() {}
+	};
+
+	template<typename F>
+	struct ImplementationType : Base
+	{
+		ImplementationType(F &&f) :
+			function(std::move(f))
+		{}
+
+		void Call() override
+		{
+			function();
+		}
+
+		F function;
+	};
+
+	std::unique_ptr<Base> _implementation;
+};
+
+static const size_t kIterations = 2000000;
+static size_t __threadCount = 2;
+static std::atomic<size_t> __sink(0);
+
+struct SmallCapture
+{
+	size_t a, b;
+};
+
+struct LargeCapture
+{
+	size_t values[24];
+};
+
+template<class FunctionType, class Capture>
+static void CreateAndCall(size_t iterations)
+{
+	size_t sum = 0;
+
+	for(size_t i = 0; i < iterations; i ++)
+	{
+		Capture capture;
+		memset(&capture, 0, sizeof(Capture));
+		reinterpret_cast<size_t *>(&capture)[0] = i;
+
+		FunctionType function([capture, &sum]{
+			sum += reinterpret_cast<const size_t *>(&capture)[0];
+		});
+
+		function();
+	}
+
+	__sink += sum;
+}
+
+template<class FunctionType, class Capture>
+static void Serial()
+{
+	CreateAndCall<FunctionType, Capture>(kIterations);
+}
+
+// Every thread creates and destroys its own functions, measures contention on the allocator
+template<class FunctionType, class Capture>
+static void Parallel()
+{
+	std::vector<std::thread> threads;
+
+	for(size_t i = 0; i < __threadCount; i ++)
+		threads.emplace_back(&CreateAndCall<FunctionType, Capture>, kIterations / __threadCount);
+
+	for(std::thread &thread : threads)
+		thread.join();
+}
+
+// Functions are created on one thread and called and destroyed on another, like a job handed to a work queue
+template<class FunctionType, class Capture>
+static void Handoff()
+{
+	const size_t batchSize = 1024;
+
+	std::vector<FunctionType> batches[2];
+	std::mutex lock;
+	std::condition_variable condition;
+	size_t produced = 0;
+	size_t consumed = 0;
+
+	std::thread consumer([&]{
+		for(size_t batch = 0; batch < kIterations / batchSize; batch ++)
+		{
+			std::vector<FunctionType> functions;
+
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				condition.wait(guard, [&]{ return produced > consumed; });
+
+				functions = std::move(batches[consumed % 2]);
+				consumed ++;
+			}
+
+			condition.notify_one();
+
+			for(FunctionType &function : functions)
+				function();
+		}
+	});
+
+	for(size_t batch = 0; batch < kIterations / batchSize; batch ++)
+	{
+		std::vector<FunctionType> functions;
+		functions.reserve(batchSize);
+
+		for(size_t i = 0; i < batchSize; i ++)
+		{
+			Capture capture;
+			memset(&capture, 0, sizeof(Capture));
+
+			functions.emplace_back([capture]{
+				__sink += reinterpret_cast<const size_t *>(&capture)[0];
+			});
+		}
+
+		std::unique_lock<std::mutex> guard(lock);
+		condition.wait(guard, [&]{ return produced - consumed < 2; });
+
+		batches[produced % 2] = std::move(functions);
+		produced ++;
+
+		guard.unlock();
+		condition.notify_one();
+	}
+
+	consumer.join();
+}
+
+static void Measure(const char *name, void (*legacy)(), void (*current)())
+{
+	double results[2];
+	void (*benchmarks[2])() = { legacy, current };
+
+	for(size_t i = 0; i < 2; i ++)
+	{
+		benchmarks[i](); // Warm up the allocators
+
+		const auto start = std::chrono::steady_clock::now();
+		benchmarks[i]();
+		const auto end = std::chrono::steady_clock::now();
+
+		results[i] = std::chrono::duration<double, std::nano>(end - start).count() / kIterations;
+	}
+
+	printf("%-32s %8.2f ns %8.2f ns %6.2fx\n", name, results[0], results[1], results[0] / results[1]);
+}
+
+int main(int argc, const char *argv[])
+{
+	__threadCount = std::max(std::thread::hardware_concurrency(), 2u);
+
+	printf("%-32s %11s %11s %7s\n", "", "Legacy", "Function", "Speedup");
+
+	Measure("Create and call, small", &Serial<LegacyFunction, SmallCapture>, &Serial<RN::Function, SmallCapture>);
+	Measure("Create and call, large", &Serial<LegacyFunction, LargeCapture>, &Serial<RN::Function, LargeCapture>);
+	Measure("Parallel, small", &Parallel<LegacyFunction, SmallCapture>, &Parallel<RN::Function, SmallCapture>);
+	Measure("Parallel, large", &Parallel<LegacyFunction, LargeCapture>, &Parallel<RN::Function, LargeCapture>);
+	Measure("Handoff, small", &Handoff<LegacyFunction, SmallCapture>, &Handoff<RN::Function, SmallCapture>);
+	Measure("Handoff, large", &Handoff<LegacyFunction, LargeCapture>, &Handoff<RN::Function, LargeCapture>);
+
+	return (__sink.load() == 42) ? 1 : 0;
+}
@@ -0,0 +1,169 @@
+//
+//  MemoryPoolBenchmark.cpp
+//  Rayne Benchmarks
+//
+//  Copyright 2015 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include <Rayne.h>
+
+static const size_t kIterations = 4000000;
+static const size_t kLiveAllocations = 4096;
+static size_t __threadCount = 2;
+
+struct SystemAllocator
+{
+	static void *Allocate(size_t size) { return malloc(size); }
+	static void Free(void *ptr) { free(ptr); }
+};
+
+struct PoolAllocator
+{
+	static void *Allocate(size_t size) { return RN::MemoryPool::GetSharedPool()->Allocate(size); }
+	static void Free(void *ptr) { RN::MemoryPool::GetSharedPool()->Free(ptr); }
+};
+
+// Sizes of the usual suspects: Number, Value, Function captures and WorkSources
+static size_t GetSize(size_t i)
+{
+	static const size_t sizes[] = { 24, 40, 48, 64, 96, 112, 160, 24, 40, 24 };
+	return sizes[i % 10];
+}
+
+// Keeps a window of live allocations and replaces a random one each iteration, like objects that live for a frame or two
+template<class Allocator>
+static void Churn(size_t iterations)
+{
+	std::vector<void *> live(kLiveAllocations, nullptr);
+	uint32_t state = 0x9e3779b9;
+
+	for(size_t i = 0; i < iterations; i ++)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		void *&slot = live[state % kLiveAllocations];
+		Allocator::Free(slot);
+
+		slot = Allocator::Allocate(GetSize(i));
+		memset(slot, 0, 8);
+	}
+
+	for(void *ptr : live)
+		Allocator::Free(ptr);
+}
+
+template<class Allocator>
+static void Serial()
+{
+	Churn<Allocator>(kIterations);
+}
+
+template<class Allocator>
+static void Parallel()
+{
+	std::vector<std::thread> threads;
+
+	for(size_t i = 0; i < __threadCount; i ++)
+		threads.emplace_back(&Churn<Allocator>, kIterations / __threadCount);
+
+	for(std::thread &thread : threads)
+		thread.join();
+}
+
+// Allocated on one thread, freed on another
+template<class Allocator>
+static void Handoff()
+{
+	const size_t batchSize = 1024;
+
+	std::vector<void *> batches[2];
+	std::mutex lock;
+	std::condition_variable condition;
+	size_t produced = 0;
+	size_t consumed = 0;
+
+	std::thread consumer([&]{
+		for(size_t batch = 0; batch < kIterations / batchSize; batch ++)
+		{
+			std::vector<void *> allocations;
+
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				condition.wait(guard, [&]{ return produced > consumed; });
+
+				allocations = std::move(batches[consumed % 2]);
+				consumed ++;
+			}
+
+			condition.notify_one();
+
+			for(void *ptr : allocations)
+				Allocator::Free(ptr);
+		}
+	});
+
+	for(size_t batch = 0; batch < kIterations / batchSize; batch ++)
+	{
+		std::vector<void *> allocations;
+		allocations.reserve(batchSize);
+
+		for(size_t i = 0; i < batchSize; i ++)
+			allocations.push_back(Allocator::Allocate(GetSize(i)));
+
+		std::unique_lock<std::mutex> guard(lock);
+		condition.wait(guard, [&]{ return produced - consumed < 2; });
+
+		batches[produced % 2] = std::move(allocations);
+		produced ++;
+
+		guard.unlock();
+		condition.notify_one();
+	}
+
+	consumer.join();
+}
+
+static void Measure(const char *name, void (*system)(), void (*pool)())
+{
+	double results[2];
+	void (*benchmarks[2])() = { system, pool };
+
+	for(size_t i = 0; i < 2; i ++)
+	{
+		benchmarks[i]();
+
+		const auto start = std::chrono::steady_clock::now();
+		benchmarks[i]();
+		const auto end = std::chrono::steady_clock::now();
+
+		results[i] = std::chrono::duration<double, std::nano>(end - start).count() / kIterations;
+	}
+
+	printf("%-16s %8.2f ns %8.2f ns %6.2fx\n", name, results[0], results[1], results[0] / results[1]);
+}
+
+int main(int argc, const char *argv[])
+{
+	__threadCount = std::max(std::thread::hardware_concurrency(), 2u);
+
+	printf("%-16s %11s %11s %7s\n", "", "malloc", "MemoryPool", "Speedup");
+
+	Measure("Churn", &Serial<SystemAllocator>, &Serial<PoolAllocator>);
+	Measure("Parallel churn", &Parallel<SystemAllocator>, &Parallel<PoolAllocator>);
+	Measure("Handoff", &Handoff<SystemAllocator>, &Handoff<PoolAllocator>);
+
+	printf("\n%6s %10s %8s %8s %9s\n", "Size", "Live", "Slabs", "Hit rate", "Allocs");
+
+	for(const RN::MemoryPool::Statistics &statistics : RN::MemoryPool::GetSharedPool()->GetStatistics())
+	{
+		if(statistics.hits + statistics.misses == 0)
+			continue;
+
+		printf("%6zu %10zu %8zu %7.2f%% %9zu\n", statistics.size, statistics.liveBytes, statistics.slabCount, statistics.GetHitRate() * 100.0, statistics.hits + statistics.misses);
+	}
+
+	return 0;
+}
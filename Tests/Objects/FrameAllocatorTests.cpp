@@ -0,0 +1,109 @@
+//
+//  FrameAllocatorTests.cpp
+//  Rayne Unit Tests
+//
+//  Copyright 2016 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "../Shared/Bootstrap.h"
+
+class FrameAllocatorTests : public KernelFixture
+{};
+
+// The transient work of a frame: per frame containers, staging buffers and temporary autorelease pools
+static void RunTestFrame(RN::FrameAllocator &allocator, RN::Object *object)
+{
+	allocator.BeginFrame();
+
+	RN::FrameVector<float> values{RN::FrameAllocatorAdapter<float>(&allocator)};
+	for(size_t i = 0; i < 10000; i ++)
+		values.push_back(static_cast<float>(i));
+
+	RN::FrameVector<RN::Object *> objects{RN::FrameAllocatorAdapter<RN::Object *>(&allocator)};
+	objects.reserve(100);
+
+	float *staging = allocator.AllocateArray<float>(100000); // Bigger than a chunk
+	staging[99999] = values.back();
+
+	{
+		RN::AutoreleasePool pool;
+
+		// Enough objects to need pages beyond the inline storage
+		for(size_t i = 0; i < 1000; i ++)
+		{
+			object->Retain()->Autorelease();
+			objects.push_back(object);
+		}
+
+		RN::AutoreleasePool::PerformBlock([object] {
+			object->Retain()->Autorelease();
+		});
+	}
+}
+
+TEST_F(FrameAllocatorTests, SteadyState)
+{
+	RN::FrameAllocator allocator;
+	RN::Object *object = new RN::Number(1);
+
+	// Fills the chunk pool and the autorelease page cache of this thread
+	for(size_t i = 0; i < kRNFrameAllocatorFrames * 2; i ++)
+		RunTestFrame(allocator, object);
+
+	const RN::FrameAllocator::Statistics warm = allocator.GetStatistics();
+	const size_t heapAllocations = RN::Memory::GetAllocationCount();
+
+	ASSERT_GT(warm.chunkAllocations, 0u);
+
+	for(size_t i = 0; i < 50; i ++)
+	{
+		RunTestFrame(allocator, object);
+
+		const RN::FrameAllocator::Statistics statistics = allocator.GetStatistics();
+
+		ASSERT_EQ(warm.chunkAllocations, statistics.chunkAllocations);
+		ASSERT_EQ(warm.chunkCount, statistics.chunkCount);
+#if RN_ENABLE_ALLOCATION_COUNTER
+		ASSERT_EQ(0u, statistics.lastFrameHeapAllocations);
+#endif
+	}
+
+#if RN_ENABLE_ALLOCATION_COUNTER
+	ASSERT_EQ(heapAllocations, RN::Memory::GetAllocationCount());
+#else
+	ASSERT_EQ(0u, heapAllocations);
+#endif
+
+	object->Release();
+}
+
+TEST_F(FrameAllocatorTests, Recycling)
+{
+	RN::FrameAllocator allocator;
+
+	allocator.BeginFrame();
+
+	RN::uint32 *first = allocator.AllocateArray<RN::uint32>(16);
+	for(RN::uint32 i = 0; i < 16; i ++)
+		first[i] = i;
+
+	// Memory stays valid for kRNFrameAllocatorFrames frames and is only reused afterwards
+	for(size_t i = 1; i < kRNFrameAllocatorFrames; i ++)
+	{
+		allocator.BeginFrame();
+
+		RN::uint32 *other = allocator.AllocateArray<RN::uint32>(16);
+		ASSERT_NE(first, other);
+		other[0] = 1234;
+	}
+
+	for(RN::uint32 i = 0; i < 16; i ++)
+		ASSERT_EQ(i, first[i]);
+
+	allocator.BeginFrame();
+	ASSERT_EQ(first, allocator.AllocateArray<RN::uint32>(16));
+
+	void *aligned = allocator.Allocate(3, 256);
+	ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(aligned) % 256);
+}
@@ -0,0 +1,200 @@
+//
+//  JSONTests.cpp
+//  Rayne Unit Tests
+//
+//  Copyright 2016 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "../Shared/Bootstrap.h"
+
+class JSONTests : public KernelFixture
+{};
+
+struct JSONTestVertex
+{
+	float position[3];
+	std::string name;
+	bool visible;
+};
+
+TEST_F(JSONTests, Tokens)
+{
+	const char *json = "{\"a\": [1, -2.5e3, true, false, null], \"b\": \"x\\u00e9\\ud83d\\ude00\\n\"}";
+	RN::JSONReader reader(json, strlen(json));
+
+	ASSERT_EQ(RN::JSONReader::Token::BeginObject, reader.Next());
+	ASSERT_EQ(RN::JSONReader::Token::Key, reader.Next());
+	ASSERT_TRUE(reader.GetString() == "a");
+	ASSERT_EQ(RN::JSONReader::Token::BeginArray, reader.Next());
+	ASSERT_EQ(1, reader.ReadInt64());
+	ASSERT_EQ(-2500.0, reader.ReadDouble());
+	ASSERT_TRUE(reader.ReadBool());
+	ASSERT_FALSE(reader.ReadBool());
+	ASSERT_TRUE(reader.ReadNull());
+	ASSERT_EQ(RN::JSONReader::Token::EndArray, reader.Next());
+	ASSERT_EQ(RN::JSONReader::Token::Key, reader.Next());
+	ASSERT_EQ(std::string("x\xc3\xa9\xf0\x9f\x98\x80\n"), reader.ReadString());
+	ASSERT_EQ(RN::JSONReader::Token::EndObject, reader.Next());
+	ASSERT_EQ(RN::JSONReader::Token::End, reader.Next());
+}
+
+TEST_F(JSONTests, Numbers)
+{
+	const char *json = "[-9223372036854775808, 18446744073709551615, 0.1, 1e300, 123456789012345678901234567890]";
+	RN::JSONReader reader(json, strlen(json));
+
+	reader.ReadArray([&](size_t index) {
+		switch(index)
+		{
+			case 0:
+				ASSERT_EQ(std::numeric_limits<RN::int64>::min(), reader.ReadInt64());
+				break;
+			case 1:
+				ASSERT_EQ(std::numeric_limits<RN::uint64>::max(), reader.ReadUint64());
+				break;
+			case 2:
+				ASSERT_EQ(0.1, reader.ReadDouble());
+				break;
+			case 3:
+				ASSERT_EQ(1e300, reader.ReadDouble());
+				break;
+			case 4:
+				ASSERT_EQ(123456789012345678901234567890.0, reader.ReadDouble());
+				break;
+		}
+	});
+}
+
+TEST_F(JSONTests, ReadIntoStruct)
+{
+	const char *json = "[{\"position\": [1, 2, 3], \"unknown\": {\"x\": [\"]}\\\"\", {}]}, \"name\": \"first\", \"visible\": true},"
+					   " {\"name\": \"second\", \"visible\": false, \"position\": [4.5, 5.5, 6.5]}]";
+
+	std::vector<JSONTestVertex> vertices;
+	RN::JSONReader reader(json, strlen(json));
+
+	reader.ReadArray([&](size_t index) {
+		JSONTestVertex vertex;
+
+		reader.ReadObject([&](const RN::JSONReader::StringRef &key) {
+			if(key == "position")
+				reader.ReadArray([&](size_t i) { vertex.position[i] = reader.ReadFloat(); });
+			else if(key == "name")
+				vertex.name = reader.ReadString();
+			else if(key == "visible")
+				vertex.visible = reader.ReadBool();
+			else
+				reader.Skip();
+		});
+
+		vertices.push_back(vertex);
+	});
+
+	ASSERT_EQ(2u, vertices.size());
+	ASSERT_EQ(3.0f, vertices[0].position[2]);
+	ASSERT_EQ("first", vertices[0].name);
+	ASSERT_TRUE(vertices[0].visible);
+	ASSERT_EQ(5.5f, vertices[1].position[1]);
+	ASSERT_EQ("second", vertices[1].name);
+	ASSERT_FALSE(vertices[1].visible);
+}
+
+TEST_F(JSONTests, SkipLargeContainers)
+{
+	// Long enough to go through the vectorized scan, with strings that cross block boundaries
+	std::string json = "[";
+
+	for(size_t i = 0; i < 500; i ++)
+	{
+		if(i > 0)
+			json += ",";
+
+		json += "{\"k\":\"" + std::string(i % 70, 'a') + "\\\\\\\"]}[{\",\"n\":[" + std::to_string(i) + ",{}]}";
+	}
+
+	json += "]";
+
+	for(size_t padding = 0; padding < 64; padding ++)
+	{
+		std::string input = "[" + std::string(padding, ' ') + json + ", 42]";
+		RN::JSONReader reader(input.data(), input.length());
+
+		ASSERT_EQ(RN::JSONReader::Token::BeginArray, reader.Next());
+		reader.Skip();
+		ASSERT_EQ(42, reader.ReadInt64());
+		ASSERT_EQ(RN::JSONReader::Token::EndArray, reader.Next());
+	}
+
+	std::string truncated = json.substr(0, json.length() - 1);
+	RN::JSONReader reader(truncated.data(), truncated.length());
+
+	ASSERT_THROW(reader.Skip(), RN::InconsistencyException);
+}
+
+TEST_F(JSONTests, Errors)
+{
+	const char *json = "{\n  \"a\": [1,\n  2,, 3]\n}";
+	RN::JSONReader reader(json, strlen(json));
+
+	try
+	{
+		while(reader.Next() != RN::JSONReader::Token::End)
+		{}
+
+		FAIL();
+	}
+	catch(RN::InconsistencyException &e)
+	{
+		ASSERT_NE(std::string::npos, std::string(e.GetReason()).find("Line: 3"));
+	}
+
+	ASSERT_THROW(RN::JSONSerialization::ObjectFromString(RNCSTR("[1, 2")), RN::InconsistencyException);
+	ASSERT_THROW(RN::JSONSerialization::ObjectFromString(RNCSTR("{\"a\": [1, \"two\", {\"b\": [3, 4")), RN::InconsistencyException); // Partially built containers must not leak
+	ASSERT_THROW(RN::JSONSerialization::ObjectFromString(RNCSTR("42")), RN::InconsistencyException);
+	ASSERT_NE(nullptr, RN::JSONSerialization::ObjectFromString(RNCSTR("42"), RN::JSONSerialization::Options::AllowFragments));
+}
+
+TEST_F(JSONTests, Writer)
+{
+	RN::JSONWriter writer(true);
+
+	writer.BeginObject();
+	writer.WriteKey("array");
+	writer.BeginArray();
+	writer.WriteInt64(std::numeric_limits<RN::int64>::min());
+	writer.WriteDouble(2.0);
+	writer.WriteString("\"quoted\"\n");
+	writer.EndArray();
+	writer.WriteKey("empty");
+	writer.BeginObject();
+	writer.EndObject();
+	writer.EndObject();
+
+	const std::string expected = "{\n    \"array\": [\n        -9223372036854775808,\n        2.0,\n        \"\\\"quoted\\\"\\n\"\n    ],\n    \"empty\": {}\n}";
+	ASSERT_EQ(expected, std::string(writer.GetString()->GetUTF8String()));
+}
+
+TEST_F(JSONTests, Serialization)
+{
+	RN::Dictionary *dictionary = new RN::Dictionary();
+	dictionary->SetObjectForKey(RN::Number::WithInt32(-5), RNCSTR("int"));
+	dictionary->SetObjectForKey(RN::Number::WithUint64(std::numeric_limits<RN::uint64>::max()), RNCSTR("uint"));
+	dictionary->SetObjectForKey(RN::Number::WithDouble(0.25), RNCSTR("double"));
+	dictionary->SetObjectForKey(RN::Number::WithBool(true), RNCSTR("bool"));
+	dictionary->SetObjectForKey(RN::Array::WithObjects({ RNCSTR("a"), RN::Null::GetNull() }), RNCSTR("array"));
+
+	RN::Data *data = RN::JSONSerialization::JSONDataFromObject(dictionary->Autorelease(), RN::JSONSerialization::Options::PrettyPrint);
+	RN::Dictionary *result = RN::JSONSerialization::ObjectFromData<RN::Dictionary>(data);
+
+	ASSERT_NE(nullptr, result);
+	ASSERT_EQ(-5, result->GetObjectForKey<RN::Number>(RNCSTR("int"))->GetInt32Value());
+	ASSERT_EQ(std::numeric_limits<RN::uint64>::max(), result->GetObjectForKey<RN::Number>(RNCSTR("uint"))->GetUint64Value());
+	ASSERT_EQ(0.25, result->GetObjectForKey<RN::Number>(RNCSTR("double"))->GetDoubleValue());
+	ASSERT_TRUE(result->GetObjectForKey<RN::Number>(RNCSTR("bool"))->GetBoolValue());
+
+	RN::Array *array = result->GetObjectForKey<RN::Array>(RNCSTR("array"));
+	ASSERT_EQ(2u, array->GetCount());
+	ASSERT_TRUE(array->GetObjectAtIndex(0)->IsEqual(RNCSTR("a")));
+	ASSERT_EQ(RN::Null::GetNull(), array->GetObjectAtIndex(1));
+}
@@ -60,6 +60,11 @@ public:
 		return _testValue;
 	}
 
+	void SetCoalescesTestValue(bool coalesce)
+	{
+		_testValue.SetCoalescesChanges(coalesce);
+	}
+
 
 private:
 	RN::ObservableScalar<float, KVOTestObject> _testFloat;
@@ -213,6 +218,178 @@ TEST_F(KVOTests, Observer)
 	object->Release();
 }
 
+TEST_F(KVOTests, ChangeObserver)
+{
+	KVOTestObjectContainer *container = new KVOTestObjectContainer();
+	KVOTestObject *object = new KVOTestObject();
+
+	char *_token;
+	void *token = &_token;
+
+	float newValues[5];
+	float oldValues[5];
+	uint32 index = 0;
+
+	RN::Object *oldObject = object;
+	RN::Object *newObject = object;
+
+	object->SetTestFloat(0.0f); // Start with a known value
+
+	object->AddChangeObserver("testFloat", [&](RN::Object *value, const RN::ObservableChange &change) {
+
+		oldValues[index] = change.GetOldValue<float>();
+		newValues[index] = change.GetNewValue<float>();
+
+		index ++;
+
+	}, token);
+
+	container->AddChangeObserver("testObject", [&](RN::Object *value, const RN::ObservableChange &change) {
+
+		oldObject = change.GetOldValue<RN::Object *>();
+		newObject = change.GetNewValue<RN::Object *>();
+
+	}, token);
+
+	object->SetTestFloat(128);
+	object->SetValueForKey(RN::Number::WithFloat(16), "testFloat");
+	object->SetTestFloat(1024.0f);
+
+	ASSERT_EQ(3u, index);
+
+	ASSERT_FLOAT_EQ(128, newValues[0]);
+	ASSERT_FLOAT_EQ(16, newValues[1]);
+	ASSERT_FLOAT_EQ(1024, newValues[2]);
+
+	ASSERT_FLOAT_EQ(0, oldValues[0]);
+	ASSERT_FLOAT_EQ(128, oldValues[1]);
+	ASSERT_FLOAT_EQ(16, oldValues[2]);
+
+	container->SetTestObject(object);
+
+	ASSERT_EQ(nullptr, oldObject);
+	ASSERT_EQ(object, newObject);
+
+	object->RemoveObserver("testFloat", token);
+	container->RemoveObserver("testObject", token);
+
+	object->SetTestFloat(32.0f);
+	container->SetTestObject(nullptr);
+
+	ASSERT_EQ(3u, index);
+	ASSERT_EQ(object, newObject);
+
+	object->Release();
+	container->Release();
+}
+
+TEST_F(KVOTests, CoalescedChanges)
+{
+	KVOTestObject *object = new KVOTestObject();
+
+	char *_token;
+	void *token = &_token;
+
+	RN::Vector3 oldValue;
+	RN::Vector3 newValue;
+	uint32 changes = 0;
+	uint32 dictionaryChanges = 0;
+
+	object->SetTestValue(RN::Vector3(1.0f, 2.0f, 3.0f));
+	object->SetCoalescesTestValue(true);
+
+	object->AddChangeObserver("testValue", [&](RN::Object *value, const RN::ObservableChange &change) {
+
+		oldValue = change.GetOldValue<RN::Vector3>();
+		newValue = change.GetNewValue<RN::Vector3>();
+
+		changes ++;
+
+	}, token);
+
+	object->AddObserver("testValue", [&](RN::Object *value, const char *key, const RN::Dictionary *changes) {
+		dictionaryChanges ++;
+	}, token);
+
+	object->SetTestValue(RN::Vector3(4.0f, 5.0f, 6.0f));
+	object->SetTestValue(RN::Vector3(7.0f, 8.0f, 9.0f));
+
+	// Dictionary observers aren't coalesced
+	ASSERT_EQ(0u, changes);
+	ASSERT_EQ(2u, dictionaryChanges);
+
+	RN::ObservableProperty::FlushCoalescedChanges();
+
+	ASSERT_EQ(1u, changes);
+	ASSERT_EQ(RN::Vector3(1.0f, 2.0f, 3.0f), oldValue);
+	ASSERT_EQ(RN::Vector3(7.0f, 8.0f, 9.0f), newValue);
+
+	RN::ObservableProperty::FlushCoalescedChanges();
+
+	ASSERT_EQ(1u, changes);
+
+	object->RemoveObserver("testValue", token);
+	object->Release();
+}
+
+TEST_F(KVOTests, CoalescedChangesDestroyedDuringFlush)
+{
+	KVOTestObject *first = new KVOTestObject();
+	KVOTestObject *second = new KVOTestObject();
+	KVOTestObject *third = new KVOTestObject();
+
+	char *_token;
+	void *token = &_token;
+
+	uint32 firstChanges = 0;
+	uint32 secondChanges = 0;
+	uint32 thirdChanges = 0;
+
+	first->SetCoalescesTestValue(true);
+	second->SetCoalescesTestValue(true);
+	third->SetCoalescesTestValue(true);
+
+	first->AddChangeObserver("testValue", [&](RN::Object *value, const RN::ObservableChange &change) {
+
+		firstChanges ++;
+
+		// Destroys a property that is still waiting in the batch and flushes again from within the flush
+		second->Release();
+		second = nullptr;
+
+		third->SetTestValue(RN::Vector3(2.0f));
+		RN::ObservableProperty::FlushCoalescedChanges();
+
+	}, token);
+
+	second->AddChangeObserver("testValue", [&](RN::Object *value, const RN::ObservableChange &change) {
+		secondChanges ++;
+	}, token);
+
+	third->AddChangeObserver("testValue", [&](RN::Object *value, const RN::ObservableChange &change) {
+		thirdChanges ++;
+	}, token);
+
+	first->SetTestValue(RN::Vector3(1.0f));
+	second->SetTestValue(RN::Vector3(1.0f));
+
+	RN::ObservableProperty::FlushCoalescedChanges();
+
+	ASSERT_EQ(nullptr, second);
+	ASSERT_EQ(1u, firstChanges);
+	ASSERT_EQ(0u, secondChanges);
+	ASSERT_EQ(1u, thirdChanges);
+
+	RN::ObservableProperty::FlushCoalescedChanges();
+	ASSERT_EQ(1u, firstChanges);
+	ASSERT_EQ(1u, thirdChanges);
+
+	first->RemoveObserver("testValue", token);
+	third->RemoveObserver("testValue", token);
+	first->Release();
+	third->Release();
+}
+
 TEST_F(KVOTests, InvalidKeys)
 {
 	KVOTestObjectContainer *container = new KVOTestObjectContainer();
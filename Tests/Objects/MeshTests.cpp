@@ -0,0 +1,177 @@
+//
+//  MeshTests.cpp
+//  Rayne Unit Tests
+//
+//  Copyright 2016 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "../Shared/Bootstrap.h"
+
+class MeshTests : public KernelFixture
+{};
+
+static RN::Mesh *CreateTestMesh(size_t vertices)
+{
+	RN::Mesh *mesh = new RN::Mesh({ RN::Mesh::VertexAttribute(RN::Mesh::VertexAttribute::Feature::Vertices, RN::PrimitiveType::Vector3),
+		RN::Mesh::VertexAttribute(RN::Mesh::VertexAttribute::Feature::Normals, RN::PrimitiveType::Vector3),
+		RN::Mesh::VertexAttribute(RN::Mesh::VertexAttribute::Feature::Indices, RN::PrimitiveType::Uint16) }, vertices, vertices);
+
+	mesh->BeginChanges();
+	RN::Mesh::Chunk chunk = mesh->GetChunk();
+
+	RN::Mesh::ElementIterator<RN::Vector3> positions = chunk.GetIterator<RN::Vector3>(RN::Mesh::VertexAttribute::Feature::Vertices);
+	RN::Mesh::ElementIterator<RN::Vector3> normals = chunk.GetIterator<RN::Vector3>(RN::Mesh::VertexAttribute::Feature::Normals);
+	RN::Mesh::ElementIterator<RN::uint16> indices = chunk.GetIterator<RN::uint16>(RN::Mesh::VertexAttribute::Feature::Indices);
+
+	for(size_t i = 0; i < vertices; i ++)
+	{
+		*positions ++ = RN::Vector3(i, 0.0f, 0.0f);
+		*normals ++ = RN::Vector3(0.0f, 1.0f, 0.0f);
+		*indices ++ = static_cast<RN::uint16>(i);
+	}
+
+	mesh->EndChanges();
+	return mesh->Autorelease();
+}
+
+TEST_F(MeshTests, DirtyRanges)
+{
+	RN::Mesh::DirtyRanges ranges;
+
+	for(size_t i = 0; i < 100; i ++)
+		ranges.Add(i * 32, 12);
+
+	ASSERT_EQ(1u, ranges.GetCount());
+	ASSERT_EQ(RN::Range(0, 99 * 32 + 12), ranges.GetRange(0));
+
+	ranges.Add(100000, 4);
+	ranges.Add(50000, 4);
+	ranges.Add(50002, 8);
+
+	ASSERT_EQ(3u, ranges.GetCount());
+	ASSERT_EQ(RN::Range(50000, 10), ranges.GetRange(1));
+	ASSERT_EQ(RN::Range(100000, 4), ranges.GetRange(2));
+
+	// Close enough to be merged with the following range
+	ranges.Add(49000, 800);
+	ASSERT_EQ(3u, ranges.GetCount());
+	ASSERT_EQ(RN::Range(49000, 1010), ranges.GetRange(1));
+
+	ranges.Clear();
+
+	for(size_t i = 0; i < 20; i ++)
+		ranges.Add(i * 10000 + ((i % 3) * 1000), 16);
+
+	ASSERT_EQ(static_cast<size_t>(kRNMeshDirtyRangeCount), ranges.GetCount());
+
+	for(size_t i = 1; i < ranges.GetCount(); i ++)
+		ASSERT_LT(ranges.GetRange(i - 1).GetEnd() + kRNMeshDirtyRangeGap, ranges.GetRange(i).origin);
+
+	ASSERT_EQ(0u, ranges.GetRange(0).origin);
+	ASSERT_EQ(19u * 10000 + 1000 + 16, ranges.GetRange(ranges.GetCount() - 1).GetEnd());
+}
+
+TEST_F(MeshTests, PartialUpload)
+{
+	RN::Mesh *mesh = CreateTestMesh(1000);
+
+	const RN::Mesh::Statistics initial = mesh->GetStatistics();
+	ASSERT_EQ(1000 * mesh->GetStride(), initial.vertexUploadBytes);
+	ASSERT_EQ(1000 * sizeof(RN::uint16), initial.indexUploadBytes);
+
+	// Reading doesn't upload anything, not even between BeginChanges() and EndChanges()
+	{
+		mesh->BeginChanges();
+
+		RN::Mesh::Chunk chunk = mesh->GetChunk();
+		RN::Mesh::ElementIterator<RN::Vector3> positions = chunk.GetIterator<RN::Vector3>(RN::Mesh::VertexAttribute::Feature::Vertices);
+		RN::Mesh::ElementIterator<RN::Vector3> normals = chunk.GetIterator<RN::Vector3>(RN::Mesh::VertexAttribute::Feature::Normals);
+
+		float sum = 0.0f;
+		for(size_t i = 0; i < 1000; i ++)
+		{
+			const RN::Vector3 &normal = *normals ++;
+
+			sum += (positions ++)->x + normal.x;
+		}
+
+		ASSERT_EQ(499500.0f, sum);
+
+		mesh->CalculateBoundingVolumes();
+		mesh->EndChanges();
+	}
+
+	ASSERT_EQ(initial.vertexUploadBytes, mesh->GetStatistics().vertexUploadBytes);
+
+	// Two separate runs of normals, nothing else
+	{
+		mesh->BeginChanges();
+
+		RN::Mesh::Chunk chunk = mesh->GetChunk();
+		RN::Mesh::ElementIterator<RN::Vector3> normals = chunk.GetIteratorAtIndex<RN::Vector3>(RN::Mesh::VertexAttribute::Feature::Normals, 100);
+
+		for(size_t i = 0; i < 10; i ++)
+			*normals ++ = RN::Vector3(1.0f, 0.0f, 0.0f);
+
+		*normals.Seek(900) = RN::Vector3(2.0f, 0.0f, 0.0f);
+
+		mesh->EndChanges();
+	}
+
+	const RN::Mesh::Statistics partial = mesh->GetStatistics();
+	ASSERT_EQ(initial.vertexUploads + 2, partial.vertexUploads);
+	ASSERT_EQ(initial.vertexUploadBytes + 9 * mesh->GetStride() + 2 * sizeof(RN::Vector3), partial.vertexUploadBytes);
+	ASSERT_EQ(initial.indexUploadBytes, partial.indexUploadBytes);
+
+	const RN::Vector3 &normal = *mesh->GetChunk().GetIteratorAtIndex<RN::Vector3>(RN::Mesh::VertexAttribute::Feature::Normals, 105);
+	ASSERT_EQ(1.0f, normal.x);
+
+	// Flagging still uploads everything
+	mesh->BeginChanges();
+	mesh->changedIndices = true;
+	mesh->EndChanges();
+
+	ASSERT_EQ(partial.indexUploadBytes + 1000 * sizeof(RN::uint16), mesh->GetStatistics().indexUploadBytes);
+	ASSERT_EQ(partial.vertexUploadBytes, mesh->GetStatistics().vertexUploadBytes);
+}
+
+TEST_F(MeshTests, Streaming)
+{
+	RN::FrameAllocator *allocator = RN::FrameAllocator::GetSharedInstance();
+	RN::Mesh *mesh = CreateTestMesh(1000);
+	mesh->SetStreaming(true);
+
+	const size_t vertexBytes = 1000 * mesh->GetStride();
+	const size_t elementBytes = sizeof(RN::Vector3);
+
+	auto writePosition = [&](size_t index) {
+		size_t before = mesh->GetStatistics().vertexUploadBytes;
+
+		mesh->BeginChanges();
+		mesh->GetChunk().GetIteratorAtIndex<RN::Vector3>(RN::Mesh::VertexAttribute::Feature::Vertices, index)->y = 1.0f;
+		mesh->EndChanges();
+
+		return mesh->GetStatistics().vertexUploadBytes - before;
+	};
+
+	// The buffer is reused within a frame
+	ASSERT_EQ(elementBytes, writePosition(0));
+
+	// The two new copies have to be filled completely the first time they are used
+	allocator->BeginFrame();
+	ASSERT_EQ(vertexBytes, writePosition(100));
+	allocator->BeginFrame();
+	ASSERT_EQ(vertexBytes, writePosition(200));
+
+	// The first copy only missed the last two changes, and now the one of this frame
+	allocator->BeginFrame();
+	ASSERT_EQ(3 * elementBytes, writePosition(300));
+	ASSERT_EQ(elementBytes, writePosition(400));
+
+	mesh->SetStreaming(false);
+	ASSERT_FALSE(mesh->IsStreaming());
+
+	allocator->BeginFrame();
+	ASSERT_EQ(elementBytes, writePosition(500));
+}
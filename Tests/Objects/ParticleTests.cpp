@@ -0,0 +1,130 @@
+//
+//  ParticleTests.cpp
+//  Rayne Unit Tests
+//
+//  Copyright 2016 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "../Shared/Bootstrap.h"
+
+class ParticleTests : public KernelFixture
+{};
+
+static void FillTestPool(RN::ParticlePool &pool, size_t count)
+{
+	ASSERT_EQ(count, pool.Spawn(count));
+
+	for(size_t i = 0; i < count; i ++)
+	{
+		pool.GetStream(RN::ParticlePool::Stream::PositionX)[i] = static_cast<float>(i);
+		pool.GetStream(RN::ParticlePool::Stream::PositionY)[i] = 0.0f;
+		pool.GetStream(RN::ParticlePool::Stream::PositionZ)[i] = 0.0f;
+		pool.GetStream(RN::ParticlePool::Stream::VelocityX)[i] = 0.0f;
+		pool.GetStream(RN::ParticlePool::Stream::VelocityY)[i] = 1.0f;
+		pool.GetStream(RN::ParticlePool::Stream::VelocityZ)[i] = 0.0f;
+		pool.GetStream(RN::ParticlePool::Stream::GravityX)[i] = 0.0f;
+		pool.GetStream(RN::ParticlePool::Stream::GravityY)[i] = -2.0f;
+		pool.GetStream(RN::ParticlePool::Stream::GravityZ)[i] = 0.0f;
+
+		// Every other particle lives for 1 second, the rest for 4
+		const float duration = (i & 1)? 1.0f : 4.0f;
+
+		pool.GetStream(RN::ParticlePool::Stream::Time)[i] = 0.0f;
+		pool.GetStream(RN::ParticlePool::Stream::Lifespan)[i] = duration;
+		pool.GetStream(RN::ParticlePool::Stream::InverseDuration)[i] = 1.0f / duration;
+		pool.GetStream(RN::ParticlePool::Stream::SizeStart)[i] = 1.0f;
+		pool.GetStream(RN::ParticlePool::Stream::SizeDelta)[i] = 2.0f;
+		pool.GetStream(RN::ParticlePool::Stream::RotationStart)[i] = 0.0f;
+		pool.GetStream(RN::ParticlePool::Stream::RotationDelta)[i] = 0.0f;
+	}
+}
+
+TEST_F(ParticleTests, Update)
+{
+	// Large enough to be updated in parallel
+	const size_t count = kRNParticlePoolParallelThreshold * 2 + 3;
+
+	RN::ParticlePool pool(count + 10);
+	FillTestPool(pool, count);
+
+	ASSERT_EQ(10u, pool.Spawn(100));
+	pool.Kill(pool.GetCount() - 1);
+	ASSERT_EQ(count + 9, pool.GetCount());
+
+	for(size_t i = 0; i < 9; i ++)
+		pool.Kill(pool.GetCount() - 1);
+
+	const RN::Color startColor(1.0f, 0.0f, 0.0f, 1.0f);
+	const RN::Color endColor(0.0f, 1.0f, 0.0f, 0.0f);
+
+	pool.Update(0.5f, startColor, endColor);
+	ASSERT_EQ(count, pool.GetCount());
+
+	const float *positionX = pool.GetStream(RN::ParticlePool::Stream::PositionX);
+	const float *positionY = pool.GetStream(RN::ParticlePool::Stream::PositionY);
+	const float *size = pool.GetStream(RN::ParticlePool::Stream::Size);
+	const float *colorR = pool.GetStream(RN::ParticlePool::Stream::ColorR);
+	const float *colorG = pool.GetStream(RN::ParticlePool::Stream::ColorG);
+
+	for(size_t i = 0; i < count; i ++)
+	{
+		const float t = (i & 1)? 0.5f : 0.125f;
+
+		ASSERT_EQ(static_cast<float>(i), positionX[i]);
+		ASSERT_FLOAT_EQ(0.0f, positionY[i]); // The velocity is updated first, (1 - 2 * 0.5) * 0.5
+		ASSERT_FLOAT_EQ(1.0f + 2.0f * t, size[i]);
+		ASSERT_FLOAT_EQ(1.0f - t, colorR[i]);
+		ASSERT_FLOAT_EQ(t, colorG[i]);
+	}
+
+	// Half of them die, which swaps the long living ones into their slots
+	pool.Update(0.6f, startColor, endColor);
+	ASSERT_EQ((count + 1) / 2, pool.GetCount());
+
+	std::vector<bool> seen(count, false);
+	for(size_t i = 0; i < pool.GetCount(); i ++)
+	{
+		const size_t index = static_cast<size_t>(positionX[i]);
+
+		ASSERT_EQ(0u, index & 1);
+		ASSERT_FALSE(seen[index]);
+		ASSERT_FLOAT_EQ(1.0f + 2.0f * (1.1f / 4.0f), size[i]);
+
+		seen[index] = true;
+	}
+
+	pool.Clear();
+	ASSERT_EQ(0u, pool.GetCount());
+}
+
+TEST_F(ParticleTests, SortByDepth)
+{
+	const size_t count = 1001;
+
+	RN::ParticlePool pool(count);
+	FillTestPool(pool, count);
+
+	// Scatter the depths, including negative ones
+	float *positionX = pool.GetStream(RN::ParticlePool::Stream::PositionX);
+	for(size_t i = 0; i < count; i ++)
+		positionX[i] = static_cast<float>((i * 7919) % count) - 500.0f;
+
+	const RN::Vector3 origin(10.0f, 0.0f, 0.0f);
+	const RN::Vector3 direction(1.0f, 0.0f, 0.0f);
+
+	const RN::uint32 *order = pool.SortByDepth(origin, direction, nullptr, false);
+	for(size_t i = 1; i < count; i ++)
+		ASSERT_GT(positionX[order[i - 1]], positionX[order[i]]);
+
+	order = pool.SortByDepth(origin, direction, nullptr, true);
+	for(size_t i = 1; i < count; i ++)
+		ASSERT_LT(positionX[order[i - 1]], positionX[order[i]]);
+
+	// Mirroring the particles flips the order
+	RN::Matrix transform = RN::Matrix::WithScaling(RN::Vector3(-1.0f, 1.0f, 1.0f));
+
+	order = pool.SortByDepth(origin, direction, &transform, false);
+	for(size_t i = 1; i < count; i ++)
+		ASSERT_LT(positionX[order[i - 1]], positionX[order[i]]);
+}
@@ -0,0 +1,186 @@
+//
+//  SerializationTests.cpp
+//  Rayne Unit Tests
+//
+//  Copyright 2016 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "../Shared/Bootstrap.h"
+
+class SerializationTestObject : public RN::Object
+{
+public:
+	SerializationTestObject() :
+		_tag(0),
+		_child(nullptr),
+		_conditional(nullptr)
+	{}
+
+	SerializationTestObject(RN::Deserializer *deserializer) :
+		SerializationTestObject()
+	{
+		_position = deserializer->DecodeVector3();
+		_rotation = deserializer->DecodeQuaternion();
+		_tag = deserializer->DecodeInt64();
+		_name = deserializer->DecodeString();
+		_points = deserializer->DecodeVector3Array();
+		_matrices = deserializer->DecodeMatrixArray();
+
+		_child = RN::SafeRetain(static_cast<SerializationTestObject *>(deserializer->DecodeObject()));
+		_conditional = static_cast<SerializationTestObject *>(deserializer->DecodeObject());
+	}
+
+	~SerializationTestObject() override
+	{
+		RN::SafeRelease(_child);
+	}
+
+	void Serialize(RN::Serializer *serializer) const override
+	{
+		serializer->EncodeVector3(_position);
+		serializer->EncodeQuarternion(_rotation);
+		serializer->EncodeInt64(_tag);
+		serializer->EncodeString(_name);
+		serializer->EncodeVector3Array(_points.data(), _points.size());
+		serializer->EncodeMatrixArray(_matrices.data(), _matrices.size());
+
+		serializer->EncodeObject(_child);
+		serializer->EncodeConditionalObject(_conditional);
+
+		if(_tag < 0)
+			serializer->EncodeInt32(42); // Pretend a newer schema added a value
+	}
+
+	RN::Vector3 _position;
+	RN::Quaternion _rotation;
+	RN::int64 _tag;
+	std::string _name;
+	std::vector<RN::Vector3> _points;
+	std::vector<RN::Matrix> _matrices;
+
+	SerializationTestObject *_child;
+	SerializationTestObject *_conditional;
+
+	RNDeclareMeta(SerializationTestObject)
+};
+
+RNDefineMeta(SerializationTestObject, RN::Object)
+
+class SerializationTests : public KernelFixture
+{
+protected:
+	RN::Object *RoundTrip(RN::Object *object, RN::uint32 schemaVersion = 0)
+	{
+		RN::BinarySerializer *serializer = new RN::BinarySerializer(schemaVersion);
+		serializer->EncodeRootObject(object);
+
+		RN::BinaryDeserializer *deserializer = new RN::BinaryDeserializer(serializer->GetSerializedData());
+		RN::Object *result = deserializer->DecodeObject();
+
+		EXPECT_EQ(schemaVersion, deserializer->GetSchemaVersion());
+
+		serializer->Release();
+		deserializer->Release();
+
+		return result;
+	}
+};
+
+TEST_F(SerializationTests, Values)
+{
+	SerializationTestObject *object = new SerializationTestObject();
+	object->_position = RN::Vector3(1.0f, 2.0f, 3.0f);
+	object->_rotation = RN::Quaternion::WithEulerAngle(RN::Vector3(45.0f, 0.0f, 0.0f));
+	object->_tag = 1234567890123;
+	object->_name = "Test";
+	object->_points = { RN::Vector3(1.0f), RN::Vector3(2.0f), RN::Vector3(3.0f) };
+	object->_matrices = { RN::Matrix::WithTranslation(RN::Vector3(5.0f)) };
+
+	SerializationTestObject *result = RoundTrip(object->Autorelease(), 3)->Downcast<SerializationTestObject>();
+
+	ASSERT_NE(nullptr, result);
+	ASSERT_EQ(object->_position, result->_position);
+	ASSERT_EQ(object->_rotation, result->_rotation);
+	ASSERT_EQ(object->_tag, result->_tag);
+	ASSERT_EQ(object->_name, result->_name);
+	ASSERT_EQ(object->_points, result->_points);
+	ASSERT_EQ(1u, result->_matrices.size());
+	ASSERT_EQ(object->_matrices[0], result->_matrices[0]);
+	ASSERT_EQ(nullptr, result->_child);
+}
+
+TEST_F(SerializationTests, SharedObjects)
+{
+	SerializationTestObject *shared = (new SerializationTestObject())->Autorelease();
+	shared->_tag = 5;
+
+	RN::Array *array = new RN::Array();
+
+	for(size_t i = 0; i < 4; i ++)
+	{
+		SerializationTestObject *object = new SerializationTestObject();
+		object->_child = shared->Retain();
+
+		array->AddObject(object->Autorelease());
+	}
+
+	RN::Array *result = RoundTrip(array->Autorelease())->Downcast<RN::Array>();
+
+	ASSERT_EQ(4u, result->GetCount());
+
+	SerializationTestObject *child = result->GetObjectAtIndex<SerializationTestObject>(0)->_child;
+
+	ASSERT_NE(nullptr, child);
+	ASSERT_EQ(5, child->_tag);
+
+	result->Enumerate<SerializationTestObject>([&](SerializationTestObject *object, size_t index, bool &stop) {
+		ASSERT_EQ(child, object->_child);
+	});
+}
+
+TEST_F(SerializationTests, ConditionalObjects)
+{
+	SerializationTestObject *first = (new SerializationTestObject())->Autorelease();
+	SerializationTestObject *second = (new SerializationTestObject())->Autorelease();
+	SerializationTestObject *missing = (new SerializationTestObject())->Autorelease();
+
+	first->_conditional = second; // Encoded for real later on
+	second->_conditional = missing; // Never encoded for real
+
+	RN::Array *result = RoundTrip(RN::Array::WithObjects({ first, second }))->Downcast<RN::Array>();
+
+	ASSERT_EQ(result->GetObjectAtIndex(1), result->GetObjectAtIndex<SerializationTestObject>(0)->_conditional);
+	ASSERT_EQ(nullptr, result->GetObjectAtIndex<SerializationTestObject>(1)->_conditional);
+}
+
+TEST_F(SerializationTests, SkipsUnknownValues)
+{
+	SerializationTestObject *object = new SerializationTestObject();
+	object->_tag = -1;
+	object->_child = new SerializationTestObject();
+	object->_child->_tag = 7;
+
+	SerializationTestObject *result = RoundTrip(object->Autorelease())->Downcast<SerializationTestObject>();
+
+	ASSERT_EQ(-1, result->_tag);
+	ASSERT_EQ(7, result->_child->_tag);
+}
+
+TEST_F(SerializationTests, TruncatedData)
+{
+	RN::BinarySerializer *serializer = new RN::BinarySerializer();
+	serializer->EncodeRootObject(RN::Array::WithObjects({ RNCSTR("Hello"), RN::Number::WithInt32(5) }));
+
+	RN::Data *data = serializer->GetSerializedData();
+	serializer->Release();
+
+	for(size_t i = 0; i < data->GetLength(); i ++)
+	{
+		ASSERT_ANY_THROW({
+			RN::BinaryDeserializer *deserializer = new RN::BinaryDeserializer(data->GetDataInRange(RN::Range(0, i)));
+			deserializer->DecodeObject();
+			deserializer->Release();
+		});
+	}
+}
@@ -0,0 +1,209 @@
+//
+//  VoxelTests.cpp
+//  Rayne Unit Tests
+//
+//  Copyright 2016 by Überpixel. All rights reserved.
+//  Unauthorized use is punishable by torture, mutilation, and vivisection.
+//
+
+#include "../Shared/Bootstrap.h"
+
+class VoxelTests : public KernelFixture
+{};
+
+// Resolutions that aren't multiples of the brick size, so the bricks at the border are only partially used
+static const RN::uint32 kTestResolutionX = 21;
+static const RN::uint32 kTestResolutionY = 13;
+static const RN::uint32 kTestResolutionZ = 30;
+
+static size_t GetTestIndex(RN::uint32 x, RN::uint32 y, RN::uint32 z)
+{
+	return (x * kTestResolutionY + y) * kTestResolutionZ + z;
+}
+
+static void CompareTestStorage(const RN::VoxelStorage &storage, const std::vector<RN::uint8> &reference)
+{
+	for(RN::uint32 x = 0; x < kTestResolutionX; x ++)
+	{
+		for(RN::uint32 y = 0; y < kTestResolutionY; y ++)
+		{
+			for(RN::uint32 z = 0; z < kTestResolutionZ; z ++)
+				ASSERT_EQ(reference[GetTestIndex(x, y, z)], storage.Get(x, y, z));
+		}
+	}
+}
+
+TEST_F(VoxelTests, SetAndGet)
+{
+	RN::VoxelStorage storage(kTestResolutionX, kTestResolutionY, kTestResolutionZ, 7);
+	std::vector<RN::uint8> reference(kTestResolutionX * kTestResolutionY * kTestResolutionZ, 7);
+
+	const size_t uniformSize = storage.GetMemoryUsage();
+
+	// A handful of values keeps the bricks in palettes, every value afterwards makes some of them raw
+	RN::uint32 seed = 12345;
+	for(size_t i = 0; i < 20000; i ++)
+	{
+		seed = seed * 1664525 + 1013904223;
+
+		const RN::uint32 x = (seed >> 8) % kTestResolutionX;
+		const RN::uint32 y = (seed >> 13) % kTestResolutionY;
+		const RN::uint32 z = (seed >> 18) % kTestResolutionZ;
+		const RN::uint8 value = (i < 10000)? static_cast<RN::uint8>((seed >> 24) % 5) : static_cast<RN::uint8>(seed >> 24);
+
+		storage.Set(x, y, z, value);
+		reference[GetTestIndex(x, y, z)] = value;
+
+		if(i == 9999)
+		{
+			CompareTestStorage(storage, reference);
+			ASSERT_LT(storage.GetMemoryUsage(), reference.size());
+		}
+	}
+
+	CompareTestStorage(storage, reference);
+
+	// Clearing everything again turns all bricks uniform
+	for(RN::uint32 x = 0; x < kTestResolutionX; x ++)
+	{
+		for(RN::uint32 y = 0; y < kTestResolutionY; y ++)
+		{
+			for(RN::uint32 z = 0; z < kTestResolutionZ; z ++)
+				storage.Set(x, y, z, 7);
+		}
+	}
+
+	ASSERT_GT(storage.GetMemoryUsage(), uniformSize);
+	storage.Compact(0, 0, 0, kTestResolutionX - 1, kTestResolutionY - 1, kTestResolutionZ - 1);
+	ASSERT_EQ(uniformSize, storage.GetMemoryUsage());
+
+	std::fill(reference.begin(), reference.end(), 7);
+	CompareTestStorage(storage, reference);
+}
+
+TEST_F(VoxelTests, Fill)
+{
+	RN::VoxelStorage storage(kTestResolutionX, kTestResolutionY, kTestResolutionZ);
+	std::vector<RN::uint8> reference(kTestResolutionX * kTestResolutionY * kTestResolutionZ, 0);
+
+	const size_t uniformSize = storage.GetMemoryUsage();
+
+	// Everything below the plane is solid, partially covered bricks are stored as palettes
+	storage.Fill(0, 0, 0, kTestResolutionX - 1, 4, kTestResolutionZ - 1, 255);
+	storage.Fill(3, 2, 5, 17, 11, 29, 100);
+
+	for(RN::uint32 x = 0; x < kTestResolutionX; x ++)
+	{
+		for(RN::uint32 y = 0; y < kTestResolutionY; y ++)
+		{
+			for(RN::uint32 z = 0; z < kTestResolutionZ; z ++)
+			{
+				if(x >= 3 && x <= 17 && y >= 2 && y <= 11 && z >= 5)
+					reference[GetTestIndex(x, y, z)] = 100;
+				else if(y <= 4)
+					reference[GetTestIndex(x, y, z)] = 255;
+			}
+		}
+	}
+
+	CompareTestStorage(storage, reference);
+	ASSERT_LT(storage.GetMemoryUsage(), reference.size());
+
+	storage.Fill(0, 0, 0, kTestResolutionX - 1, kTestResolutionY - 1, kTestResolutionZ - 1, 0);
+	ASSERT_EQ(uniformSize, storage.GetMemoryUsage());
+}
+
+TEST_F(VoxelTests, Serialization)
+{
+	RN::VoxelStorage storage(kTestResolutionX, kTestResolutionY, kTestResolutionZ);
+	storage.Fill(0, 0, 0, kTestResolutionX - 1, 6, kTestResolutionZ - 1, 255);
+
+	std::vector<RN::uint8> reference(kTestResolutionX * kTestResolutionY * kTestResolutionZ, 0);
+
+	for(RN::uint32 x = 0; x < kTestResolutionX; x ++)
+	{
+		for(RN::uint32 y = 0; y < kTestResolutionY; y ++)
+		{
+			for(RN::uint32 z = 0; z < kTestResolutionZ; z ++)
+			{
+				RN::uint8 value = (y <= 6)? 255 : 0;
+
+				// One brick with a few values, one with all of them
+				if(x < 8 && y < 8 && z < 8)
+					value = static_cast<RN::uint8>((x + z) % 3);
+				if(x >= 16 && y >= 8 && z >= 24)
+					value = static_cast<RN::uint8>(x * 31 + y * 17 + z);
+
+				storage.Set(x, y, z, value);
+				reference[GetTestIndex(x, y, z)] = value;
+			}
+		}
+	}
+
+	RN::BinarySerializer *serializer = new RN::BinarySerializer();
+	storage.Serialize(serializer);
+
+	RN::BinaryDeserializer *deserializer = new RN::BinaryDeserializer(serializer->GetSerializedData());
+	RN::VoxelStorage copy(deserializer);
+
+	ASSERT_EQ(kTestResolutionX, copy.GetResolutionX());
+	ASSERT_EQ(kTestResolutionY, copy.GetResolutionY());
+	ASSERT_EQ(kTestResolutionZ, copy.GetResolutionZ());
+	ASSERT_EQ(storage.GetMemoryUsage(), copy.GetMemoryUsage());
+	CompareTestStorage(copy, reference);
+
+	deserializer->Release();
+	serializer->Release();
+}
+
+static void DeserializeTestBricks(RN::uint32 bricks, std::vector<RN::uint8> bytes)
+{
+	RN::BinarySerializer *serializer = new RN::BinarySerializer();
+	serializer->EncodeInt32(static_cast<RN::int32>(bricks * kRNVoxelStorageBrickSize));
+	serializer->EncodeInt32(kRNVoxelStorageBrickSize);
+	serializer->EncodeInt32(kRNVoxelStorageBrickSize);
+	serializer->EncodeBytes(bytes.data(), bytes.size());
+
+	RN::BinaryDeserializer *deserializer = new RN::BinaryDeserializer(serializer->GetSerializedData());
+	serializer->Release();
+
+	try
+	{
+		RN::VoxelStorage storage(deserializer);
+	}
+	catch(...)
+	{
+		deserializer->Release();
+		throw;
+	}
+
+	deserializer->Release();
+}
+
+TEST_F(VoxelTests, MalformedData)
+{
+	// A raw brick, followed by the one that fails
+	std::vector<RN::uint8> bytes(1, 8);
+	bytes.resize(1 + kRNVoxelStorageBrickVoxels, 42);
+
+	std::vector<RN::uint8> truncated = bytes;
+	truncated.push_back(8);
+	truncated.resize(truncated.size() + 10, 0);
+
+	std::vector<RN::uint8> invalid = bytes;
+	invalid.push_back(3);
+
+	// Index 1 into a palette with only one entry
+	std::vector<RN::uint8> index = bytes;
+	index.insert(index.end(), { 1, 1, 7 });
+	index.resize(index.size() + kRNVoxelStorageBrickVoxels / 8, 0);
+	index.back() = 0x80;
+
+	std::vector<RN::uint8> valid = index;
+	valid.back() = 0;
+
+	ASSERT_THROW(DeserializeTestBricks(2, truncated), RN::InconsistencyException);
+	ASSERT_THROW(DeserializeTestBricks(2, invalid), RN::InconsistencyException);
+	ASSERT_THROW(DeserializeTestBricks(2, index), RN::InconsistencyException);
+	ASSERT_NO_THROW(DeserializeTestBricks(2, valid));
+}
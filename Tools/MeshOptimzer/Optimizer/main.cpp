@@ -1,20 +1,345 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <cstring>
 #include <iostream>
 
 #include <fstream>
 #include <iterator>
 #include <vector>
 
+#include <algorithm>
+#include <cmath>
+
 #include "meshoptimizer.h"
 
+struct Options
+{
+	bool packed = false;
+	bool halfPositions = false;
+	bool halfNormals = false;
+	bool halfUVs = false;
+	bool color8 = false;
+};
+
+//Have to match RN::Mesh::VertexAttribute::Feature and RN::PrimitiveType
+enum Feature : unsigned char
+{
+	FeatureVertices = 0,
+	FeatureNormals = 1,
+	FeatureTangents = 2,
+	FeatureColor0 = 3,
+	FeatureUVCoords0 = 5,
+	FeatureUVCoords1 = 6,
+	FeatureBoneWeights = 8,
+	FeatureBoneIndices = 9
+};
+
+enum Type : unsigned char
+{
+	TypeHalfVector2 = 8,
+	TypeHalfVector3 = 9,
+	TypeHalfVector4 = 10,
+	TypeVector2 = 12,
+	TypeVector3 = 13,
+	TypeVector4 = 14,
+	TypeColor = 19,
+	TypeColor8 = 20
+};
+
+struct Attribute
+{
+	Feature feature;
+	Type type;
+	size_t sourceOffset; //In floats into the interleaved input vertex
+	unsigned int offset;
+};
+
+//Size and alignment of the types on the GPU, the same for all renderers
+static size_t GetGPUSize(Type type)
+{
+	switch(type)
+	{
+		case TypeHalfVector2:
+		case TypeColor8:
+			return 4;
+		case TypeVector2:
+		case TypeHalfVector3:
+		case TypeHalfVector4:
+			return 8;
+		default:
+			return 16;
+	}
+}
+
+static size_t GetGPUAlignment(Type type)
+{
+	return GetGPUSize(type);
+}
+
+static size_t GetComponentCount(Type type)
+{
+	switch(type)
+	{
+		case TypeHalfVector2:
+		case TypeVector2:
+			return 2;
+		case TypeHalfVector3:
+		case TypeVector3:
+			return 3;
+		default:
+			return 4;
+	}
+}
+
+template<class T>
+static void WriteValue(std::vector<unsigned char> &buffer, T value)
+{
+	unsigned char bytes[sizeof(T)];
+	std::memcpy(bytes, &value, sizeof(T));
+	buffer.insert(std::end(buffer), bytes, bytes + sizeof(T));
+}
+
+static void AlignBuffer(std::vector<unsigned char> &buffer)
+{
+	//Has to match kRNSGMSectionAlignment
+	while(buffer.size() % 16)
+		buffer.push_back(0);
+}
+
+//Round to nearest even, flushing denormals to zero and clamping to infinity
+static unsigned short ConvertFloatToHalf(float value)
+{
+	unsigned int bits;
+	std::memcpy(&bits, &value, 4);
+
+	unsigned int sign = (bits >> 16) & 0x8000;
+	int exponent = static_cast<int>((bits >> 23) & 0xff) - 127 + 15;
+	unsigned int mantissa = bits & 0x7fffff;
+
+	if(exponent <= 0)
+		return static_cast<unsigned short>(sign);
+	if(exponent >= 31)
+		return static_cast<unsigned short>(sign | 0x7c00 | ((((bits >> 23) & 0xff) == 0xff && mantissa)? 0x200 : 0));
+
+	unsigned int half = sign | (exponent << 10) | (mantissa >> 13);
+	unsigned int rest = mantissa & 0x1fff;
+
+	if(rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+		half++;
+
+	return static_cast<unsigned short>(half);
+}
+
+//Computes the layout RN::Mesh::ParseAttributes() ends up with on the GPU
+static void CalculateLayout(std::vector<Attribute> &attributes, unsigned int vertexCount, unsigned int &stride, unsigned int &positionsSize, unsigned int &positionsStride)
+{
+	size_t offset = 0;
+	size_t initialAlignment = 0;
+	size_t separatedSize = 0;
+	size_t separatedStride = 0;
+
+	for(size_t i = 0; i < attributes.size(); i++)
+	{
+		Attribute &attribute = attributes[i];
+		size_t size = GetGPUSize(attribute.type);
+		size_t alignment = GetGPUAlignment(attribute.type);
+
+		if(i == 0 && attribute.feature == FeatureVertices)
+		{
+			//Positions are kept as one continuous block in front of everything else
+			attribute.offset = 0;
+			separatedStride = size + (size % alignment);
+			separatedSize = separatedStride * vertexCount;
+			continue;
+		}
+
+		if(separatedSize > 0 && i == 1)
+			separatedSize += separatedSize % alignment;
+
+		size_t padding = (separatedSize + offset) % alignment;
+		if(initialAlignment == 0)
+			initialAlignment = alignment;
+
+		attribute.offset = static_cast<unsigned int>(offset + padding);
+		offset += size + padding;
+	}
+
+	stride = static_cast<unsigned int>(initialAlignment? offset + (offset % initialAlignment) : offset);
+	positionsSize = static_cast<unsigned int>(separatedSize);
+	positionsStride = static_cast<unsigned int>(separatedStride);
+}
+
+static void WritePackedMesh(std::vector<unsigned char> &outputBuffer, const Options &options, const std::vector<unsigned char> &vertexData, unsigned int vertexCount, unsigned char texcoordCount, unsigned char colorChannelCount, unsigned char hasTangents, unsigned char hasBones, const std::vector<unsigned int> &indexData, unsigned char indexSize)
+{
+	//Same order as the attributes of the interleaved input
+	std::vector<Attribute> attributes;
+	size_t sourceOffset = 0;
+
+	attributes.push_back({FeatureVertices, options.halfPositions? TypeHalfVector3 : TypeVector3, sourceOffset, 0});
+	sourceOffset += 3;
+	attributes.push_back({FeatureNormals, options.halfNormals? TypeHalfVector3 : TypeVector3, sourceOffset, 0});
+	sourceOffset += 3;
+
+	for(unsigned char i = 0; i < texcoordCount; i++)
+	{
+		if(i < 2) attributes.push_back({(i == 0)? FeatureUVCoords0 : FeatureUVCoords1, options.halfUVs? TypeHalfVector2 : TypeVector2, sourceOffset, 0});
+		sourceOffset += 2;
+	}
+
+	if(colorChannelCount == 4) attributes.push_back({FeatureColor0, options.color8? TypeColor8 : TypeColor, sourceOffset, 0});
+	sourceOffset += colorChannelCount;
+
+	if(hasTangents)
+	{
+		attributes.push_back({FeatureTangents, options.halfNormals? TypeHalfVector4 : TypeVector4, sourceOffset, 0});
+		sourceOffset += 4;
+	}
+
+	if(hasBones)
+	{
+		attributes.push_back({FeatureBoneWeights, TypeVector4, sourceOffset, 0});
+		attributes.push_back({FeatureBoneIndices, TypeVector4, sourceOffset + 4, 0});
+		sourceOffset += 8;
+	}
+
+	unsigned int stride, positionsSize, positionsStride;
+	CalculateLayout(attributes, vertexCount, stride, positionsSize, positionsStride);
+
+	const size_t sourceStride = sourceOffset;
+	std::vector<float> source(vertexData.size() / sizeof(float));
+	std::memcpy(source.data(), vertexData.data(), source.size() * sizeof(float));
+
+	//Put every attribute where the mesh expects it
+	std::vector<unsigned char> packedData(positionsSize + static_cast<size_t>(stride) * vertexCount, 0);
+
+	for(const Attribute &attribute : attributes)
+	{
+		const bool separated = (attribute.feature == FeatureVertices && positionsSize > 0);
+		const size_t destinationStride = separated? positionsStride : stride;
+		unsigned char *destination = packedData.data() + (separated? 0 : positionsSize) + attribute.offset;
+
+		const size_t componentCount = GetComponentCount(attribute.type);
+
+		for(unsigned int vertex = 0; vertex < vertexCount; vertex++)
+		{
+			const float *components = source.data() + vertex * sourceStride + attribute.sourceOffset;
+			unsigned char *element = destination + vertex * destinationStride;
+
+			for(size_t c = 0; c < componentCount; c++)
+			{
+				switch(attribute.type)
+				{
+					case TypeHalfVector2:
+					case TypeHalfVector3:
+					case TypeHalfVector4:
+					{
+						unsigned short half = ConvertFloatToHalf(components[c]);
+						std::memcpy(element + c * 2, &half, 2);
+						break;
+					}
+					case TypeColor8:
+						element[c] = static_cast<unsigned char>(std::min(std::max(components[c], 0.0f), 1.0f) * 255.0f + 0.5f);
+						break;
+					default:
+						std::memcpy(element + c * 4, &components[c], 4);
+						break;
+				}
+			}
+		}
+	}
+
+	//Bounds are computed from the full precision positions
+	float boundsMin[3] = {0.0f, 0.0f, 0.0f};
+	float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+
+	for(unsigned int vertex = 0; vertex < vertexCount; vertex++)
+	{
+		const float *position = source.data() + vertex * sourceStride;
+		for(int c = 0; c < 3; c++)
+		{
+			boundsMin[c] = (vertex == 0)? position[c] : std::min(boundsMin[c], position[c]);
+			boundsMax[c] = (vertex == 0)? position[c] : std::max(boundsMax[c], position[c]);
+		}
+	}
+
+	float center[3] = {(boundsMin[0] + boundsMax[0]) * 0.5f, (boundsMin[1] + boundsMax[1]) * 0.5f, (boundsMin[2] + boundsMax[2]) * 0.5f};
+	float radius = 0.0f;
+
+	for(unsigned int vertex = 0; vertex < vertexCount; vertex++)
+	{
+		const float *position = source.data() + vertex * sourceStride;
+		float x = position[0] - center[0];
+		float y = position[1] - center[1];
+		float z = position[2] - center[2];
+		radius = std::max(radius, std::sqrt(x * x + y * y + z * z));
+	}
+
+	WriteValue(outputBuffer, vertexCount);
+	WriteValue(outputBuffer, static_cast<unsigned int>(indexData.size()));
+	outputBuffer.push_back(indexSize);
+	outputBuffer.push_back(static_cast<unsigned char>(attributes.size()));
+
+	for(const Attribute &attribute : attributes)
+	{
+		outputBuffer.push_back(attribute.feature);
+		outputBuffer.push_back(attribute.type);
+		WriteValue(outputBuffer, attribute.offset);
+	}
+
+	WriteValue(outputBuffer, stride);
+	WriteValue(outputBuffer, positionsSize);
+	WriteValue(outputBuffer, positionsStride);
+	WriteValue(outputBuffer, static_cast<unsigned int>(packedData.size()));
+
+	for(int c = 0; c < 3; c++) WriteValue(outputBuffer, boundsMin[c]);
+	for(int c = 0; c < 3; c++) WriteValue(outputBuffer, boundsMax[c]);
+	for(int c = 0; c < 3; c++) WriteValue(outputBuffer, center[c]);
+	WriteValue(outputBuffer, radius);
+
+	AlignBuffer(outputBuffer);
+	outputBuffer.insert(std::end(outputBuffer), std::begin(packedData), std::end(packedData));
+
+	AlignBuffer(outputBuffer);
+	for(unsigned int index : indexData)
+	{
+		if(indexSize == 2) WriteValue(outputBuffer, static_cast<unsigned short>(index));
+		else WriteValue(outputBuffer, index);
+	}
+
+	std::cout << "Packed vertex size: " << stride + positionsStride << " bytes, input vertex size: " << sourceStride * sizeof(float) << " bytes" << std::endl;
+}
+
+
 int main(int argc, char *argv[])
 {
 	if(argc < 3) abort();
 
 	char *inputFileName = argv[1];
 	char *outputFileName = argv[2];
+
+	Options options;
+	for(int i = 3; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--packed") == 0) options.packed = true;
+		else if(strcmp(argv[i], "--half-positions") == 0) options.halfPositions = true;
+		else if(strcmp(argv[i], "--half-normals") == 0) options.halfNormals = true;
+		else if(strcmp(argv[i], "--half-uvs") == 0) options.halfUVs = true;
+		else if(strcmp(argv[i], "--color8") == 0) options.color8 = true;
+		else if(strcmp(argv[i], "--quantize") == 0) options.halfPositions = options.halfNormals = options.halfUVs = options.color8 = true;
+		else
+		{
+			std::cout << "Error: Unknown option " << argv[i] << std::endl;
+			abort();
+		}
+	}
+
+	if(!options.packed && (options.halfPositions || options.halfNormals || options.halfUVs || options.color8))
+	{
+		std::cout << "Error: Quantized attributes are only supported by the packed format (--packed)" << std::endl;
+		abort();
+	}
+
 	std::cout << "copy and optimize from " << inputFileName << " to " << outputFileName << std::endl;
 
 	//Load file into a buffer
@@ -55,6 +380,25 @@ int main(int argc, char *argv[])
 	#has animation - uint8 0 if not, 1 otherwise
 	#	animfilename length - uint16
 	#	animfilename - char*animfilename length
+	#
+	#Version 4 (written with --packed) has the same materials, but stores every mesh in the layout used on the GPU:
+	#mesh id - uint8
+	#	used materials id - uint8
+	#	number of vertices - uint32
+	#	number of indices - uint32
+	#	index size - uint8, 2 or 4 bytes
+	#	number of attributes - uint8
+	#		feature - uint8, Mesh::VertexAttribute::Feature
+	#		type - uint8, PrimitiveType
+	#		offset - uint32
+	#	stride - uint32
+	#	size of the separated positions - uint32
+	#	stride of the separated positions - uint32
+	#	size of the vertex data - uint32
+	#	bounding box min and max - float32*6
+	#	bounding sphere center and radius - float32*4
+	#	padding to 16 bytes, vertex data
+	#	padding to 16 bytes, indices
 	*/
 
 	std::vector<unsigned char> outputBuffer;
@@ -67,7 +411,8 @@ int main(int argc, char *argv[])
 	outputBuffer.push_back(inputBuffer[currentReadPosition++]);
 
 	//Version
-	outputBuffer.push_back(inputBuffer[currentReadPosition++]);
+	outputBuffer.push_back(options.packed? 4 : inputBuffer[currentReadPosition]);
+	currentReadPosition++;
 
 	//Number of materials
 	unsigned char materialCount = inputBuffer[currentReadPosition++];
@@ -91,7 +436,7 @@ int main(int argc, char *argv[])
 			outputBuffer.push_back(textureCount);
 
 			//Textures
-			for(unsigned char uvSet = 0; uvSet < uvSetCount; uvSet++)
+			for(unsigned char texture = 0; texture < textureCount; texture++)
 			{
 				//Texture type hint
 				outputBuffer.push_back(inputBuffer[currentReadPosition++]);
@@ -162,26 +507,19 @@ int main(int argc, char *argv[])
 		//Number of Vertices
 		unsigned int vertexCount;
 		std::memcpy(&vertexCount, &inputBuffer[currentReadPosition], 4);
-		outputBuffer.push_back(inputBuffer[currentReadPosition++]);
-		outputBuffer.push_back(inputBuffer[currentReadPosition++]);
-		outputBuffer.push_back(inputBuffer[currentReadPosition++]);
-		outputBuffer.push_back(inputBuffer[currentReadPosition++]);
+		currentReadPosition += 4;
 
 		//Number of texcoords
 		unsigned char texcoordCount = inputBuffer[currentReadPosition++];
-		outputBuffer.push_back(texcoordCount);
 
 		//Number of color channels
 		unsigned char colorChannelCount = inputBuffer[currentReadPosition++];
-		outputBuffer.push_back(colorChannelCount);
 
 		//Has tangents
 		unsigned char hasTangents = inputBuffer[currentReadPosition++];
-		outputBuffer.push_back(hasTangents);
 
 		//Has bones
 		unsigned char hasBones = inputBuffer[currentReadPosition++];
-		outputBuffer.push_back(hasBones);
 
 		size_t vertexSize = 3 + 3 + 2 * texcoordCount + colorChannelCount + 4 * hasTangents + 8 * hasBones;
 		vertexSize *= sizeof(float);
@@ -197,11 +535,7 @@ int main(int argc, char *argv[])
 		//Number of Indices
 		unsigned int indexCount;
 		std::memcpy(&indexCount, &inputBuffer[currentReadPosition], 4);
-		unsigned char indexCountArray[4]; //Store the data here to push into the output vector after processing the mesh, to keep everything in order
-		indexCountArray[0] = inputBuffer[currentReadPosition++];
-		indexCountArray[1] = inputBuffer[currentReadPosition++];
-		indexCountArray[2] = inputBuffer[currentReadPosition++];
-		indexCountArray[3] = inputBuffer[currentReadPosition++];
+		currentReadPosition += 4;
 
 		//Index size
 		unsigned char indexSize = inputBuffer[currentReadPosition++];
@@ -255,11 +589,21 @@ int main(int argc, char *argv[])
 		std::cout << "(ACMR, ATVR) before: (" << cacheStatsBefore.acmr << ", " << cacheStatsBefore.atvr << "), after: (" << cacheStatsAfter.acmr << ", " << cacheStatsAfter.atvr << ")" << std::endl;
 		std::cout << "Overfetch before: " << fetchStatsBefore.overfetch << ", after: " << fetchStatsAfter.overfetch << std::endl;
 
+		if(options.packed)
+		{
+			//Indices are at least 16 bit in the packed format
+			WritePackedMesh(outputBuffer, options, vertexData, vertexCount, texcoordCount, colorChannelCount, hasTangents, hasBones, indexData, (indexSize < 4)? 2 : 4);
+			continue;
+		}
+
+		WriteValue(outputBuffer, vertexCount);
+		outputBuffer.push_back(texcoordCount);
+		outputBuffer.push_back(colorChannelCount);
+		outputBuffer.push_back(hasTangents);
+		outputBuffer.push_back(hasBones);
+
 		outputBuffer.insert(std::end(outputBuffer), std::begin(vertexData), std::end(vertexData));
-		outputBuffer.push_back(indexCountArray[0]);
-		outputBuffer.push_back(indexCountArray[1]);
-		outputBuffer.push_back(indexCountArray[2]);
-		outputBuffer.push_back(indexCountArray[3]);
+		WriteValue(outputBuffer, indexCount);
 		outputBuffer.push_back(indexSize);
 
 		for(unsigned int index = 0; index < indexCount; index++)
@@ -271,19 +615,11 @@ int main(int argc, char *argv[])
 			}
 			else if(indexSize == 2) //uint16
 			{
-				unsigned char indexValue[4];
-				std::memcpy(indexValue, &indexData[index], 4);
-				outputBuffer.push_back(indexValue[2]);
-				outputBuffer.push_back(indexValue[3]);
+				WriteValue(outputBuffer, static_cast<unsigned short>(indexData[index]));
 			}
 			else if(indexSize == 4) //uint32
 			{
-				unsigned char indexValue[4];
-				std::memcpy(indexValue, &indexData[index], 4);
-				outputBuffer.push_back(indexValue[0]);
-				outputBuffer.push_back(indexValue[1]);
-				outputBuffer.push_back(indexValue[2]);
-				outputBuffer.push_back(indexValue[3]);
+				WriteValue(outputBuffer, indexData[index]);
 			}
 		}
 	}
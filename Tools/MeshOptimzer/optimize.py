@@ -58,8 +58,12 @@ def needsToUpdateFile(sourceFile, targetFile):
 
 
 def main():
+    #Options like --packed or --quantize are handed to the optimizer
+    options = [argument for argument in sys.argv[1:] if argument.startswith('--')]
+    sys.argv = [argument for argument in sys.argv if not argument.startswith('--')]
+
     if len(sys.argv) < 2:
-        print('python optimize.py input.sgm [output.sgm]')
+        print('python optimize.py input.sgm [output.sgm] [--packed] [--quantize | --half-positions --half-normals --half-uvs --color8]')
         return
 
     supportedFileExtensions = ['.sgm']
@@ -90,7 +94,7 @@ def main():
         sourceFile = inputFileName + inputFileExtension
         targetFile = outputFileName + '.sgm'
         if needsToUpdateFile(sourceFile, targetFile):
-            subprocess.call([optimizerPath, sourceFile, targetFile])
+            subprocess.call([optimizerPath, sourceFile, targetFile] + options)
 
 if __name__ == '__main__':
     prepare()
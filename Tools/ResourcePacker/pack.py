@@ -5,6 +5,7 @@ import subprocess
 import struct
 import shutil
 import json
+import packfile
 
 def needsToUpdateFile(sourceFile, targetFile):
     if os.path.isfile(sourceFile) and os.path.isfile(targetFile):
@@ -126,7 +127,7 @@ def getTexturesForModelFile(file):
 
 def main():
     if len(sys.argv) < 4:
-        print('python pack.py inputFolder outputFolder platform [--resourcespec=filename.json --skip-textures --is-demo]')
+        print('python pack.py inputFolder outputFolder platform [--resourcespec=filename.json --skip-textures --is-demo --packfile=filename.rnpk]')
         return
 
     pythonExecutable = sys.executable
@@ -144,6 +145,7 @@ def main():
     skipTextures = False
     isDemo = False
     resourceSpecFile = None
+    packFile = None
     for i in range(4, len(sys.argv), 1):
         if sys.argv[i] == '--skip-textures':
             skipTextures = True
@@ -151,6 +153,8 @@ def main():
             resourceSpecFile = sys.argv[i][15:]
         if sys.argv[i] == '--is-demo':
             isDemo = True
+        if sys.argv[i].startswith('--packfile='):
+            packFile = sys.argv[i][11:]
 
     resourceSpec = dict()
     if resourceSpecFile:
@@ -274,6 +278,10 @@ def main():
                     if needsToUpdateFile(sourceFilePath, targetFilePath):
                         shutil.copy2(sourceFilePath, targetFilePath)
 
+    #Pack the converted files into a single pack file
+    if packFile:
+        packfile.writePackFile(targetDirectory, packFile, platform)
+
 
 if __name__ == '__main__':
     main()
@@ -0,0 +1,197 @@
+import sys
+import os
+import struct
+
+# Writes the pack file format read by RN::PackFile (Source/System/RNPackFile.h)
+
+PACK_MAGIC = 0x4B504E52 # RNPK
+PACK_VERSION = 1
+
+HEADER_FORMAT = '<IHHIIQQQ24x'
+ENTRY_FORMAT = '<QQQQIIII'
+
+COMPRESSION_NONE = 0
+COMPRESSION_LZ4 = 1
+
+# Already compressed or meant to be uploaded to the GPU straight from the pack
+UNCOMPRESSED_EXTENSIONS = ['.png', '.jpg', '.jpeg', '.ogg', '.dds', '.astc', '.ktx', '.zip']
+
+PLATFORM_MODIFIERS = {
+    'windows': '~windows',
+    'macos': '~macos',
+    'linux': '~linux',
+    'android': '~android',
+    'ios': '~ios',
+    'ios_sim': '~ios',
+    'visionos': '~visionos',
+    'visionos_sim': '~visionos'
+}
+
+def hashName(name):
+    hash = 0xcbf29ce484222325
+    for byte in name:
+        hash ^= byte
+        hash = (hash * 0x100000001b3) & 0xffffffffffffffff
+    return hash
+
+def writeLength(output, length):
+    while length >= 255:
+        output.append(255)
+        length -= 255
+    output.append(length)
+
+def compressLZ4Fallback(data):
+    # Greedy LZ4 block compressor, only used if the lz4 module isn't installed
+    size = len(data)
+    output = bytearray()
+    table = dict()
+    anchor = 0
+    position = 0
+    matchLimit = size - 12 # The last match has to start 12 bytes before the end
+
+    while position < matchLimit:
+        sequence = data[position:position + 4]
+        candidate = table.get(sequence)
+        table[sequence] = position
+
+        if candidate is None or position - candidate > 65535:
+            position += 1
+            continue
+
+        length = 4
+        maxLength = size - 5 - position # The last 5 bytes are always literals
+        while length < maxLength and data[candidate + length] == data[position + length]:
+            length += 1
+
+        literals = position - anchor
+        output.append((min(literals, 15) << 4) | min(length - 4, 15))
+        if literals >= 15:
+            writeLength(output, literals - 15)
+        output += data[anchor:position]
+        output += struct.pack('<H', position - candidate)
+        if length - 4 >= 15:
+            writeLength(output, length - 4 - 15)
+
+        position += length
+        anchor = position
+
+    literals = size - anchor
+    output.append(min(literals, 15) << 4)
+    if literals >= 15:
+        writeLength(output, literals - 15)
+    output += data[anchor:]
+
+    return bytes(output)
+
+def compressLZ4(data):
+    try:
+        import lz4.block
+        return lz4.block.compress(data, store_size=False)
+    except ImportError:
+        return compressLZ4Fallback(data)
+
+def collectFiles(sourceDirectory, platform):
+    # Resolves platform modifiers like the FileManager does, name~linux.png is packed as name.png on linux
+    modifier = PLATFORM_MODIFIERS[platform] if platform in PLATFORM_MODIFIERS else None
+    files = dict()
+
+    for currentDirectory, subdirs, filenames in os.walk(sourceDirectory):
+        subdirs.sort()
+        for filename in sorted(filenames):
+            if filename.startswith('.'):
+                continue
+
+            relativePath = os.path.relpath(os.path.join(currentDirectory, filename), sourceDirectory).replace('\\', '/')
+            name, extension = os.path.splitext(relativePath)
+
+            fileModifier = None
+            modifierIndex = name.rfind('~')
+            if modifierIndex != -1 and name.rfind('/') < modifierIndex:
+                fileModifier = name[modifierIndex:]
+                name = name[:modifierIndex]
+
+            if fileModifier and fileModifier != modifier:
+                continue
+
+            packedName = name + extension
+            if packedName in files and not fileModifier:
+                continue
+
+            files[packedName] = os.path.join(currentDirectory, filename)
+
+    return files
+
+def writePackFile(sourceDirectory, targetFile, platform, compress = True, alignment = 256):
+    files = collectFiles(sourceDirectory, platform)
+    entries = list()
+    names = bytearray()
+
+    with open(targetFile, 'wb') as pack:
+        pack.write(b'\0' * struct.calcsize(HEADER_FORMAT))
+
+        # Entries are streamed out one by one, the table of contents follows at the end
+        for packedName in sorted(files):
+            with open(files[packedName], 'rb') as sourceFile:
+                data = sourceFile.read()
+
+            compression = COMPRESSION_NONE
+            stored = data
+
+            extension = os.path.splitext(packedName)[1].lower()
+            if compress and len(data) > 0 and not extension in UNCOMPRESSED_EXTENSIONS:
+                compressed = compressLZ4(data)
+                if len(compressed) < len(data) * 0.9:
+                    compression = COMPRESSION_LZ4
+                    stored = compressed
+
+            padding = (alignment - pack.tell() % alignment) % alignment
+            pack.write(b'\0' * padding)
+
+            offset = pack.tell()
+            pack.write(stored)
+
+            encodedName = packedName.encode('utf-8')
+            entries.append((hashName(encodedName), offset, len(stored), len(data), len(names), len(encodedName), compression, 0))
+            names += encodedName
+
+        namesOffset = pack.tell()
+        pack.write(names)
+
+        pack.write(b'\0' * ((8 - pack.tell() % 8) % 8))
+        tocOffset = pack.tell()
+
+        entries.sort(key=lambda entry: entry[0])
+        for entry in entries:
+            pack.write(struct.pack(ENTRY_FORMAT, *entry))
+
+        pack.seek(0)
+        pack.write(struct.pack(HEADER_FORMAT, PACK_MAGIC, PACK_VERSION, 0, len(entries), alignment, tocOffset, namesOffset, len(names)))
+
+    return len(entries)
+
+def main():
+    if len(sys.argv) < 4:
+        print('python packfile.py inputFolder outputFile platform [--no-compression --alignment=256]')
+        return
+
+    sourceDirectory = sys.argv[1]
+    targetFile = sys.argv[2]
+    platform = sys.argv[3]
+
+    if not platform in PLATFORM_MODIFIERS:
+        print("No valid platform specified (" + platform + ")!")
+        return
+
+    compress = True
+    alignment = 256
+    for i in range(4, len(sys.argv), 1):
+        if sys.argv[i] == '--no-compression':
+            compress = False
+        if sys.argv[i].startswith('--alignment='):
+            alignment = int(sys.argv[i][12:])
+
+    count = writePackFile(sourceDirectory, targetFile, platform, compress, alignment)
+    print('Packed ' + str(count) + ' files into ' + targetFile)
+
+if __name__ == '__main__':
+    main()